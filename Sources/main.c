@@ -33,6 +33,8 @@
 #include "bootloader_main.h"
 #include "TP.h"
 #include "can_driver.h"
+#include "uart_driver.h"
+#include "eth_driver.h"
 #include "flash.h"
 
 
@@ -47,11 +49,23 @@ static void BSP_Init(void)
 
     InitCAN();
 
+#ifdef EN_UART_TP
+    InitUART();
+#endif
+
+#ifdef EN_ETHERNET_TP
+    InitEth();
+#endif
+
     InitFlash();
 }
 
 void SendMsgMainFun(void)
 {
+#ifdef EN_CAN_TP
+    /* CAN TX is started by CAN TP and refilled in TX complete interrupt, here only restart TX if driver sent failed */
+    StartTxCANMsg();
+#else
     uint8 aucMsgBuf[8u];
     uint32 msgId = 0u;
     uint32 msgLength = 0u;
@@ -61,6 +75,7 @@ void SendMsgMainFun(void)
     {
         TransmitCANMsg(msgId, msgLength, aucMsgBuf, &TP_DoTxMsgSuccesfulCallback, 0u);
     }
+#endif
 }
 
 static void BSP_AbortCANTxMsg(void)
@@ -105,6 +120,14 @@ int main(void)
 
         SendMsgMainFun();
 
+#ifdef EN_UART_TP
+        UARTMsgMainFun();
+#endif
+
+#ifdef EN_ETHERNET_TP
+        EthMsgMainFun();
+#endif
+
     } /* loop forever */
 
   /*** Don't write any code pass this line, or it will be deleted during code generation. ***/
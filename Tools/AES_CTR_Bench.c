@@ -0,0 +1,169 @@
+/*
+ * @ : AES_CTR_Bench.c
+ * @ : Host AES-128-CTR test and per block benchmark
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host test of UDS_PortingFiles/AES_CTR.c with NIST SP 800-38A F.5.1 CTR-AES128,
+**                decrypt split in every len, counter carry, and time per TransferData block
+**
+**  Build (in repo root):
+**      gcc -O2 -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_AES_CTR_DECRYPT \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o AES_CTR_Bench \
+**          Tools/AES_CTR_Bench.c UDS_PortingFiles/AES_CTR.c UDS_ProtocolStack/autolibc.c
+**  Usage: AES_CTR_Bench [MB per block len]
+**
+**  Block len 16 is one AES block, 144 is DOWLOAD_BLOCK_DATA_LEN of uds_app_cfg.c with TP_MAX_MSG_LEN 150,
+**  4096 is one flash sector. The key and IV of F.5.1 are test values of the tool only.
+*******************************************************/
+
+#include "AES_CTR.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_CHECK(x) \
+    do \
+    { \
+        if (!(x)) \
+        { \
+            printf("FAILED line %d: %s\n", __LINE__, #x); \
+            s_errors++; \
+        } \
+    } while (0)
+
+static unsigned long s_errors = 0u;
+
+/* NIST SP 800-38A F.5.1 CTR-AES128.Encrypt */
+static const uint8 gs_aKey[AES_CTR_KEY_LEN] =
+{
+    0x2bu, 0x7eu, 0x15u, 0x16u, 0x28u, 0xaeu, 0xd2u, 0xa6u, 0xabu, 0xf7u, 0x15u, 0x88u, 0x09u, 0xcfu, 0x4fu, 0x3cu
+};
+
+static const uint8 gs_aIV[AES_CTR_BLOCK_LEN] =
+{
+    0xf0u, 0xf1u, 0xf2u, 0xf3u, 0xf4u, 0xf5u, 0xf6u, 0xf7u, 0xf8u, 0xf9u, 0xfau, 0xfbu, 0xfcu, 0xfdu, 0xfeu, 0xffu
+};
+
+static const uint8 gs_aPlainText[64u] =
+{
+    0x6bu, 0xc1u, 0xbeu, 0xe2u, 0x2eu, 0x40u, 0x9fu, 0x96u, 0xe9u, 0x3du, 0x7eu, 0x11u, 0x73u, 0x93u, 0x17u, 0x2au,
+    0xaeu, 0x2du, 0x8au, 0x57u, 0x1eu, 0x03u, 0xacu, 0x9cu, 0x9eu, 0xb7u, 0x6fu, 0xacu, 0x45u, 0xafu, 0x8eu, 0x51u,
+    0x30u, 0xc8u, 0x1cu, 0x46u, 0xa3u, 0x5cu, 0xe4u, 0x11u, 0xe5u, 0xfbu, 0xc1u, 0x19u, 0x1au, 0x0au, 0x52u, 0xefu,
+    0xf6u, 0x9fu, 0x24u, 0x45u, 0xdfu, 0x4fu, 0x9bu, 0x17u, 0xadu, 0x2bu, 0x41u, 0x7bu, 0xe6u, 0x6cu, 0x37u, 0x10u
+};
+
+static const uint8 gs_aCipherText[64u] =
+{
+    0x87u, 0x4du, 0x61u, 0x91u, 0xb6u, 0x20u, 0xe3u, 0x26u, 0x1bu, 0xefu, 0x68u, 0x64u, 0x99u, 0x0du, 0xb6u, 0xceu,
+    0x98u, 0x06u, 0xf6u, 0x6bu, 0x79u, 0x70u, 0xfdu, 0xffu, 0x86u, 0x17u, 0x18u, 0x7bu, 0xb9u, 0xffu, 0xfdu, 0xffu,
+    0x5au, 0xe4u, 0xdfu, 0x3eu, 0xdbu, 0xd5u, 0xd3u, 0x5eu, 0x5bu, 0x4fu, 0x09u, 0x02u, 0x0du, 0xb0u, 0x3eu, 0xabu,
+    0x1eu, 0x03u, 0x1du, 0xdau, 0x2fu, 0xbeu, 0x03u, 0xd1u, 0x79u, 0x21u, 0x70u, 0xa0u, 0xf3u, 0x00u, 0x9cu, 0xeeu
+};
+
+static double GetSeconds(void)
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (double)stTime.tv_sec + (double)stTime.tv_nsec * 1e-9;
+}
+
+/* Counter 0xFF..FF wraps to 0 in all 128 bits: the key stream of a wrapped block is the one of counter 0 */
+static void TestCounterCarry(void)
+{
+    uint8 aIV[AES_CTR_BLOCK_LEN];
+    uint8 aWrapped[2u * AES_CTR_BLOCK_LEN];
+    uint8 aZero[AES_CTR_BLOCK_LEN];
+
+    memset(aIV, 0xFF, sizeof(aIV));
+    memset(aWrapped, 0, sizeof(aWrapped));
+    AES_CTR_Init(gs_aKey, aIV);
+    AES_CTR_Crypt(aWrapped, sizeof(aWrapped));
+
+    memset(aIV, 0, sizeof(aIV));
+    memset(aZero, 0, sizeof(aZero));
+    AES_CTR_Init(gs_aKey, aIV);
+    AES_CTR_Crypt(aZero, sizeof(aZero));
+    TEST_CHECK(0 == memcmp(&aWrapped[AES_CTR_BLOCK_LEN], aZero, AES_CTR_BLOCK_LEN));
+
+    /* Carry from the low byte into the next bytes */
+    memset(aIV, 0, sizeof(aIV));
+    memset(&aIV[10u], 0xFF, AES_CTR_BLOCK_LEN - 10u);
+    memset(aWrapped, 0, sizeof(aWrapped));
+    AES_CTR_Init(gs_aKey, aIV);
+    AES_CTR_Crypt(aWrapped, sizeof(aWrapped));
+
+    memset(&aIV[10u], 0, AES_CTR_BLOCK_LEN - 10u);
+    aIV[9u] = 1u;
+    memset(aZero, 0, sizeof(aZero));
+    AES_CTR_Init(gs_aKey, aIV);
+    AES_CTR_Crypt(aZero, sizeof(aZero));
+    TEST_CHECK(0 == memcmp(&aWrapped[AES_CTR_BLOCK_LEN], aZero, AES_CTR_BLOCK_LEN));
+    AES_CTR_Deinit();
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32 aBlockLen[] = {16u, 144u, 4096u};
+    static uint8 aBuf[4096u];
+    const long mbPerLen = (argc > 1) ? atol(argv[1]) : 16L;
+    uint32 split = 0u;
+    uint32 offset = 0u;
+    uint32 index = 0u;
+    long loop = 0;
+    long loops = 0;
+    double usedTime = 0.0;
+
+    if (0 >= mbPerLen)
+    {
+        printf("Usage: AES_CTR_Bench [MB per block len]\n");
+        return 1;
+    }
+
+    memcpy(aBuf, gs_aPlainText, sizeof(gs_aPlainText));
+    AES_CTR_Init(gs_aKey, gs_aIV);
+    AES_CTR_Crypt(aBuf, sizeof(gs_aPlainText));
+    TEST_CHECK(0 == memcmp(aBuf, gs_aCipherText, sizeof(gs_aCipherText)));
+
+    /* TransferData blocks are not multiple of the AES block, key stream goes on over them */
+    for (split = 1u; split <= sizeof(gs_aCipherText); split++)
+    {
+        memcpy(aBuf, gs_aCipherText, sizeof(gs_aCipherText));
+        AES_CTR_Init(gs_aKey, gs_aIV);
+
+        for (offset = 0u; offset < sizeof(gs_aCipherText); offset += split)
+        {
+            AES_CTR_Crypt(&aBuf[offset], ((sizeof(gs_aCipherText) - offset) < split) ? (sizeof(gs_aCipherText) - offset) : split);
+        }
+
+        TEST_CHECK(0 == memcmp(aBuf, gs_aPlainText, sizeof(gs_aPlainText)));
+    }
+
+    TestCounterCarry();
+    printf("F.5.1 vector, splits 1 ~ %u, counter carry: %lu errors\n", (unsigned int)sizeof(gs_aCipherText), s_errors);
+
+    for (index = 0u; index < (sizeof(aBlockLen) / sizeof(aBlockLen[0u])); index++)
+    {
+        loops = (mbPerLen << 20) / (long)aBlockLen[index];
+        AES_CTR_Init(gs_aKey, gs_aIV);
+        usedTime = GetSeconds();
+
+        for (loop = 0; loop < loops; loop++)
+        {
+            AES_CTR_Crypt(aBuf, aBlockLen[index]);
+        }
+
+        usedTime = GetSeconds() - usedTime;
+        printf("%4u B block: %8.1f ns per block, %6.1f MB/s\n", (unsigned int)aBlockLen[index],
+               usedTime * 1e9 / (double)loops, (double)aBlockLen[index] * (double)loops / usedTime / 1e6);
+    }
+
+    AES_CTR_Deinit();
+    return (0u == s_errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
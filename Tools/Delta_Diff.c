@@ -0,0 +1,491 @@
+/*
+ * @ : Delta_Diff.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host delta patch generator for RequestDownload compressionMethod 2
+**
+**  Build: gcc -O2 -o Delta_Diff Delta_Diff.c
+**  Usage: Delta_Diff [-a download_addr -s sector_len] old.bin new.bin patch.bin
+**         LZSS_Compress [-w window_bits] [-l lookahead_bits] patch.bin patch.lzss
+**  old.bin is the installed image at download address (newest APP with EN_SUPPORT_APP_B), new.bin is the new image.
+**  memorySize of RequestDownload is new.bin len, TransferData blocks carry patch.lzss.
+**  Without EN_SUPPORT_APP_B the image is rebuilt in place, -a and -s are needed:
+**  a sector is erased when it is rebuilt, so patch never reads old data below the rebuilding sector.
+**  Patch is applied again and compared with new.bin before it is written.
+**  Unchanged runs of a diff region are copy bytes, the patch of a small change is about the changed bytes.
+**  Delta_Test.c includes this file with DELTA_DIFF_NO_MAIN for its generated images.
+*******************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DELTA_MIN_MATCH_LEN     (8u)        /* Min exact match len to start a diff region */
+#define DELTA_HASH_BITS         (16u)       /* Hash table of 4 bytes */
+#define DELTA_MAX_CHAIN         (256u)      /* Max match candidates of a position */
+#define DELTA_MAX_NO_GAIN_LEN   (256u)      /* Diff region extension stops if no gain in it */
+#define DELTA_MIN_COPY_LEN      (8u)        /* Min unchanged run in a diff region to start a new record */
+
+typedef struct
+{
+    unsigned char *pBuf;
+    unsigned long len;
+} tPatchWriter;
+
+static unsigned long gs_downloadAddr = 0u;
+static unsigned long gs_sectorLen = 0u;
+
+/* Lowest old position can be read when new position is rebuilt, old data below the rebuilding sector is erased */
+static unsigned long GetOldLowLimit(unsigned long i_newPos)
+{
+    unsigned long sectorAddr = 0u;
+
+    if (0u == gs_sectorLen)
+    {
+        return 0u;
+    }
+
+    sectorAddr = ((gs_downloadAddr + i_newPos) / gs_sectorLen) * gs_sectorLen;
+    return (sectorAddr > gs_downloadAddr) ? (sectorAddr - gs_downloadAddr) : 0u;
+}
+
+static unsigned long Hash4(const unsigned char *i_pData)
+{
+    unsigned long value = ((unsigned long)i_pData[0] << 24u) | ((unsigned long)i_pData[1] << 16u) |
+                          ((unsigned long)i_pData[2] << 8u) | (unsigned long)i_pData[3];
+    return ((value * 2654435761uL) & 0xFFFFFFFFuL) >> (32u - DELTA_HASH_BITS);
+}
+
+/* Exact match len of old and new, limited by old low limit */
+static unsigned long MatchLen(const unsigned char *i_pOld, unsigned long i_oldLen, unsigned long i_oldPos,
+                              const unsigned char *i_pNew, unsigned long i_newLen, unsigned long i_newPos)
+{
+    unsigned long len = 0u;
+
+    while (((i_oldPos + len) < i_oldLen) && ((i_newPos + len) < i_newLen) &&
+            ((i_oldPos + len) >= GetOldLowLimit(i_newPos + len)) &&
+            (i_pOld[i_oldPos + len] == i_pNew[i_newPos + len]))
+    {
+        len++;
+    }
+
+    return len;
+}
+
+static void PutByte(tPatchWriter *m_pstWriter, unsigned char i_data)
+{
+    m_pstWriter->pBuf[m_pstWriter->len++] = i_data;
+}
+
+static void PutVarint(tPatchWriter *m_pstWriter, unsigned long i_value)
+{
+    while (i_value >= 0x80u)
+    {
+        PutByte(m_pstWriter, (unsigned char)((i_value & 0x7Fu) | 0x80u));
+        i_value >>= 7u;
+    }
+
+    PutByte(m_pstWriter, (unsigned char)i_value);
+}
+
+/* Record: copyLen, addLen, extraLen, seek (zigzag), diff bytes, extra bytes */
+static void PutRecord(tPatchWriter *m_pstWriter, unsigned long i_copyLen,
+                      const unsigned char *i_pOld, unsigned long i_oldPos, unsigned long i_addLen,
+                      const unsigned char *i_pNew, unsigned long i_newPos, unsigned long i_extraLen,
+                      long i_seek)
+{
+    unsigned long index = 0u;
+
+    PutVarint(m_pstWriter, i_copyLen);
+    PutVarint(m_pstWriter, i_addLen);
+    PutVarint(m_pstWriter, i_extraLen);
+    PutVarint(m_pstWriter, (i_seek >= 0) ? ((unsigned long)i_seek << 1u) : ((((unsigned long)(-i_seek)) << 1u) - 1u));
+
+    for (index = 0u; index < i_addLen; index++)
+    {
+        PutByte(m_pstWriter, (unsigned char)(i_pNew[i_newPos + index] - i_pOld[i_oldPos + index]));
+    }
+
+    for (index = 0u; index < i_extraLen; index++)
+    {
+        PutByte(m_pstWriter, i_pNew[i_newPos + i_addLen + index]);
+    }
+}
+
+/* Unchanged run len from a position of diff region */
+static unsigned long SameLen(const unsigned char *i_pOld, unsigned long i_oldPos,
+                             const unsigned char *i_pNew, unsigned long i_newPos, unsigned long i_maxLen)
+{
+    unsigned long len = 0u;
+
+    while ((len < i_maxLen) && (i_pOld[i_oldPos + len] == i_pNew[i_newPos + len]))
+    {
+        len++;
+    }
+
+    return len;
+}
+
+/* Diff region and its extra bytes, a record for each unchanged run of DELTA_MIN_COPY_LEN and the diff bytes after it */
+static void PutRegion(tPatchWriter *m_pstWriter,
+                      const unsigned char *i_pOld, unsigned long i_oldPos, unsigned long i_addLen,
+                      const unsigned char *i_pNew, unsigned long i_newPos, unsigned long i_extraLen,
+                      long i_seek)
+{
+    unsigned long pos = 0u;
+    unsigned long copyLen = 0u;
+    unsigned long diffEnd = 0u;
+    unsigned long sameLen = 0u;
+
+    do
+    {
+        copyLen = SameLen(i_pOld, i_oldPos + pos, i_pNew, i_newPos + pos, i_addLen - pos);
+        diffEnd = pos + copyLen;
+
+        /* Diff bytes end at the next unchanged run worth a record */
+        while (diffEnd < i_addLen)
+        {
+            sameLen = SameLen(i_pOld, i_oldPos + diffEnd, i_pNew, i_newPos + diffEnd, i_addLen - diffEnd);
+
+            if (sameLen >= DELTA_MIN_COPY_LEN)
+            {
+                break;
+            }
+
+            diffEnd += (0u != sameLen) ? sameLen : 1u;
+        }
+
+        if (diffEnd < i_addLen)
+        {
+            PutRecord(m_pstWriter, copyLen, i_pOld, i_oldPos + pos + copyLen, diffEnd - pos - copyLen,
+                      i_pNew, i_newPos + pos + copyLen, 0u, 0);
+        }
+        else
+        {
+            PutRecord(m_pstWriter, copyLen, i_pOld, i_oldPos + pos + copyLen, diffEnd - pos - copyLen,
+                      i_pNew, i_newPos + pos + copyLen, i_extraLen, i_seek);
+        }
+
+        pos = diffEnd;
+    } while (pos < i_addLen);
+}
+
+/* Find the longest exact match of new position, the last diff region alignment is preferred */
+static unsigned long FindMatch(const unsigned char *i_pOld, unsigned long i_oldLen,
+                               const unsigned char *i_pNew, unsigned long i_newLen, unsigned long i_newPos,
+                               const long *i_pHead, const long *i_pPrev, long i_lastDiag, unsigned long *o_pOldPos)
+{
+    unsigned long bestLen = 0u;
+    unsigned long len = 0u;
+    unsigned long chain = 0u;
+    long candidate = 0;
+
+    candidate = (long)i_newPos + i_lastDiag;
+
+    if ((candidate >= 0) && ((unsigned long)candidate < i_oldLen))
+    {
+        bestLen = MatchLen(i_pOld, i_oldLen, (unsigned long)candidate, i_pNew, i_newLen, i_newPos);
+        *o_pOldPos = (unsigned long)candidate;
+    }
+
+    if ((i_newPos + 4u) > i_newLen)
+    {
+        return bestLen;
+    }
+
+    for (candidate = i_pHead[Hash4(&i_pNew[i_newPos])]; (candidate >= 0) && (chain < DELTA_MAX_CHAIN);
+            candidate = i_pPrev[candidate], chain++)
+    {
+        len = MatchLen(i_pOld, i_oldLen, (unsigned long)candidate, i_pNew, i_newLen, i_newPos);
+
+        if (len > bestLen)
+        {
+            bestLen = len;
+            *o_pOldPos = (unsigned long)candidate;
+        }
+    }
+
+    return bestLen;
+}
+
+/* Extend diff region from an exact match while matched bytes are more than mismatched bytes */
+static unsigned long ExtendRegion(const unsigned char *i_pOld, unsigned long i_oldLen, unsigned long i_oldPos,
+                                  const unsigned char *i_pNew, unsigned long i_newLen, unsigned long i_newPos)
+{
+    long score = 0;
+    long bestScore = 0;
+    unsigned long len = 0u;
+    unsigned long bestLen = 0u;
+
+    while (((i_oldPos + len) < i_oldLen) && ((i_newPos + len) < i_newLen) &&
+            ((i_oldPos + len) >= GetOldLowLimit(i_newPos + len)) &&
+            ((len - bestLen) < DELTA_MAX_NO_GAIN_LEN))
+    {
+        score += (i_pOld[i_oldPos + len] == i_pNew[i_newPos + len]) ? 1 : -1;
+        len++;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestLen = len;
+        }
+    }
+
+    return bestLen;
+}
+
+static unsigned long Diff(const unsigned char *i_pOld, unsigned long i_oldLen,
+                          const unsigned char *i_pNew, unsigned long i_newLen, unsigned char *o_pOut)
+{
+    tPatchWriter stWriter = {o_pOut, 0u};
+    long *pHead = malloc(sizeof(long) << DELTA_HASH_BITS);
+    long *pPrev = malloc(sizeof(long) * (i_oldLen + 1u));
+    unsigned long index = 0u;
+    unsigned long newPos = 0u;
+    unsigned long addNewPos = 0u;
+    unsigned long addOldPos = 0u;
+    unsigned long addLen = 0u;
+    unsigned long matchOldPos = 0u;
+    unsigned long matchLen = 0u;
+    long lastDiag = 0;
+
+    for (index = 0u; index < (1uL << DELTA_HASH_BITS); index++)
+    {
+        pHead[index] = -1;
+    }
+
+    /* Chain keeps the nearest old position first */
+    for (index = 0u; (index + 4u) <= i_oldLen; index++)
+    {
+        unsigned long hash = Hash4(&i_pOld[index]);
+        pPrev[index] = pHead[hash];
+        pHead[hash] = (long)index;
+    }
+
+    PutByte(&stWriter, 'D');
+    PutByte(&stWriter, 'P');
+    PutByte(&stWriter, 2u);
+
+    while (newPos < i_newLen)
+    {
+        matchLen = FindMatch(i_pOld, i_oldLen, i_pNew, i_newLen, newPos, pHead, pPrev, lastDiag, &matchOldPos);
+
+        if (matchLen < DELTA_MIN_MATCH_LEN)
+        {
+            /* Extra byte of current record */
+            newPos++;
+            continue;
+        }
+
+        /* Current record ends before the match, seek old to the match */
+        if ((0u != addLen) || (newPos != addNewPos))
+        {
+            PutRegion(&stWriter, i_pOld, addOldPos, addLen, i_pNew, addNewPos, newPos - addNewPos - addLen,
+                      (long)matchOldPos - (long)(addOldPos + addLen));
+        }
+
+        addNewPos = newPos;
+        addOldPos = matchOldPos;
+        addLen = ExtendRegion(i_pOld, i_oldLen, matchOldPos, i_pNew, i_newLen, newPos);
+        lastDiag = (long)matchOldPos - (long)newPos;
+        newPos += addLen;
+    }
+
+    if ((0u != addLen) || (newPos != addNewPos))
+    {
+        PutRegion(&stWriter, i_pOld, addOldPos, addLen, i_pNew, addNewPos, newPos - addNewPos - addLen, 0);
+    }
+
+    free(pHead);
+    free(pPrev);
+    return stWriter.len;
+}
+
+static unsigned long GetVarint(const unsigned char *i_pIn, unsigned long *m_pPos)
+{
+    unsigned long value = 0u;
+    unsigned int shift = 0u;
+
+    do
+    {
+        value |= (unsigned long)(i_pIn[*m_pPos] & 0x7Fu) << shift;
+        shift += 7u;
+    } while (0u != (i_pIn[(*m_pPos)++] & 0x80u));
+
+    return value;
+}
+
+/* Apply whole patch with old low limit, return 0 if it is not same as new image */
+static int Verify(const unsigned char *i_pIn, unsigned long i_inLen,
+                  const unsigned char *i_pOld, unsigned long i_oldLen,
+                  const unsigned char *i_pNew, unsigned long i_newLen)
+{
+    unsigned long inPos = 3u;
+    unsigned long newPos = 0u;
+    long oldPos = 0;
+
+    if ((i_inLen < 3u) || ('D' != i_pIn[0]) || ('P' != i_pIn[1]) || (2u != i_pIn[2]))
+    {
+        return 0;
+    }
+
+    while ((inPos < i_inLen) && (newPos < i_newLen))
+    {
+        unsigned long copyLen = GetVarint(i_pIn, &inPos);
+        unsigned long addLen = GetVarint(i_pIn, &inPos);
+        unsigned long extraLen = GetVarint(i_pIn, &inPos);
+        unsigned long seek = GetVarint(i_pIn, &inPos);
+
+        while (0u != copyLen)
+        {
+            if ((oldPos < (long)GetOldLowLimit(newPos)) || ((unsigned long)oldPos >= i_oldLen) ||
+                    (i_pOld[oldPos] != i_pNew[newPos]))
+            {
+                return 0;
+            }
+
+            oldPos++;
+            newPos++;
+            copyLen--;
+        }
+
+        while (0u != addLen)
+        {
+            if ((oldPos < (long)GetOldLowLimit(newPos)) || ((unsigned long)oldPos >= i_oldLen) ||
+                    ((unsigned char)(i_pOld[oldPos] + i_pIn[inPos]) != i_pNew[newPos]))
+            {
+                return 0;
+            }
+
+            oldPos++;
+            inPos++;
+            newPos++;
+            addLen--;
+        }
+
+        while (0u != extraLen)
+        {
+            if (i_pIn[inPos] != i_pNew[newPos])
+            {
+                return 0;
+            }
+
+            inPos++;
+            newPos++;
+            extraLen--;
+        }
+
+        oldPos += (0u != (seek & 1u)) ? -(long)((seek >> 1u) + 1u) : (long)(seek >> 1u);
+    }
+
+    return (inPos == i_inLen) && (newPos == i_newLen);
+}
+
+#ifndef DELTA_DIFF_NO_MAIN
+static unsigned char *ReadFile(const char *i_pName, unsigned long *o_pLen)
+{
+    FILE *pFile = fopen(i_pName, "rb");
+    unsigned char *pBuf = NULL;
+
+    if (NULL == pFile)
+    {
+        return NULL;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    *o_pLen = (unsigned long)ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pBuf = malloc(*o_pLen + 1u);
+
+    if ((NULL != pBuf) && (*o_pLen != fread(pBuf, 1u, *o_pLen, pFile)))
+    {
+        free(pBuf);
+        pBuf = NULL;
+    }
+
+    fclose(pFile);
+    return pBuf;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *pFile = NULL;
+    unsigned char *pOld = NULL;
+    unsigned char *pNew = NULL;
+    unsigned char *pOut = NULL;
+    unsigned long oldLen = 0u;
+    unsigned long newLen = 0u;
+    unsigned long outLen = 0u;
+    int argIndex = 1;
+
+    while ((argIndex + 1 < argc) && ('-' == argv[argIndex][0]))
+    {
+        if (0 == strcmp(argv[argIndex], "-a"))
+        {
+            gs_downloadAddr = strtoul(argv[argIndex + 1], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argIndex], "-s"))
+        {
+            gs_sectorLen = strtoul(argv[argIndex + 1], NULL, 0);
+        }
+
+        argIndex += 2;
+    }
+
+    if (argIndex + 3 != argc)
+    {
+        printf("Usage: %s [-a download_addr -s sector_len] old.bin new.bin patch.bin\n", argv[0]);
+        return 1;
+    }
+
+    pOld = ReadFile(argv[argIndex], &oldLen);
+    pNew = ReadFile(argv[argIndex + 1], &newLen);
+
+    if ((NULL == pOld) || (NULL == pNew))
+    {
+        printf("Read %s or %s failed\n", argv[argIndex], argv[argIndex + 1]);
+        return 1;
+    }
+
+    /* Worst case every byte is an extra byte of a record, records are not more than bytes */
+    pOut = malloc(newLen * 17u + 16u);
+
+    if (NULL == pOut)
+    {
+        printf("Malloc failed\n");
+        return 1;
+    }
+
+    outLen = Diff(pOld, oldLen, pNew, newLen, pOut);
+
+    if (0 == Verify(pOut, outLen, pOld, oldLen, pNew, newLen))
+    {
+        printf("Verify patch failed\n");
+        return 1;
+    }
+
+    pFile = fopen(argv[argIndex + 2], "wb");
+
+    if ((NULL == pFile) || (outLen != fwrite(pOut, 1u, outLen, pFile)))
+    {
+        printf("Write %s failed\n", argv[argIndex + 2]);
+        return 1;
+    }
+
+    fclose(pFile);
+    printf("memorySize 0x%08lX, patch %lu bytes (%.1f%%), compress it with LZSS_Compress\n",
+           newLen, outLen, (newLen != 0u) ? (100.0 * outLen / newLen) : 0.0);
+    free(pOld);
+    free(pNew);
+    free(pOut);
+    return 0;
+}
+
+#endif /* DELTA_DIFF_NO_MAIN */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,454 @@
+/*
+ * @ : Delta_Test.c
+ * @ : Host delta patch end to end test
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host test of UDS_PortingFiles/Delta.c with patches of Tools/Delta_Diff.c: the patch is
+**                TX in TransferData blocks, each block goes through LZSS_Decode and Delta_Decode as
+**                ApplyDeltaDownloadData of uds_app_cfg.c, and the programmed flash is compared with new.bin
+**
+**  Build (in repo root):
+**      gcc -O2 -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER \
+**          -DEN_LZSS_DECOMPRESS -DEN_DELTA_UPDATE $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') \
+**          -o Delta_Test Tools/Delta_Test.c UDS_PortingFiles/Delta.c UDS_PortingFiles/LZSS.c \
+**          UDS_ProtocolStack/autolibc.c
+**  Usage: Delta_Diff old.bin new.bin patch_ab.bin
+**         Delta_Diff -a 0x14200 -s 4096 old.bin new.bin patch_ip.bin
+**         LZSS_Compress patch_ab.bin patch_ab.lzss && LZSS_Compress patch_ip.bin patch_ip.lzss
+**         Delta_Test [-a download_addr] [old.bin new.bin patch_ab.lzss patch_ip.lzss]
+**
+**  Generated images are always tested: patches of Delta_Diff.c (included for its encoder) of an
+**  unchanged image and of a small change must be smaller than TEST_GEN_MAX_PATCH_LEN before LZSS,
+**  they are TX as an LZSS stream of literals.
+**  A/B: old image is in the other bank, rebuilt data is programmed in TEST_BLOCK_DATA_LEN pieces.
+**  In place: old image is at download address, rebuilt data is staged in a sector buffer, the full
+**  sector is erased and programmed over old image, then old low limit is moved to the next sector.
+**  A patch reading overwritten old data is rejected by the low limit or gives a wrong image.
+*******************************************************/
+
+#include "Delta.h"
+#include "LZSS.h"
+#include "uds_app_cfg.h"
+#include "flash_hal_Cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DELTA_DIFF_NO_MAIN
+#include "Delta_Diff.c"
+
+/* As DOWLOAD_BLOCK_DATA_LEN and DELTA_PATCH_BUF_LEN of uds_app_cfg.c */
+#define TEST_BLOCK_DATA_LEN \
+    ((((UDS_MAX_MSG_LEN - 2u) < MAX_FLASH_DATA_LEN) ? (UDS_MAX_MSG_LEN - 2u) : MAX_FLASH_DATA_LEN) & (~7u))
+#define TEST_PATCH_BUF_LEN  (64u)
+
+#define TEST_GEN_IMAGE_LEN      (256u * 1024u)  /* Generated image len */
+#define TEST_GEN_CHANGE_LEN     (2048u)         /* Rewritten bytes of the small change */
+#define TEST_GEN_RELOC_CNT      (16u)           /* Changed 4 bytes words of the small change */
+#define TEST_GEN_MAX_PATCH_LEN  (4096u)         /* A small change is a few KB of patch */
+#define TEST_FLASH_MAX_LEN      (16u * 1024u * 1024u)
+
+/* Download state of a patch, as gs_stDowloadDataInfo and tDeltaDataInfo of uds_app_cfg.c */
+typedef struct
+{
+    boolean isInPlace;                          /* Sector staged update in place, else A/B */
+    uint32 startAddr;                           /* Next download address */
+    uint32 dataLen;                             /* Remain download data len */
+    uint32 sourceAddr;                          /* Old image address of download start address */
+    const uint8 *pInBuf;                        /* Block data */
+    uint32 inLen;                               /* Block data len */
+    uint32 inPos;                               /* Decompressed block data len */
+    uint32 patchLen;                            /* Decompressed patch len */
+    uint32 patchPos;                            /* Applied patch len */
+    uint8 aPatchBuf[TEST_PATCH_BUF_LEN];        /* Decompressed patch */
+    uint32 sectorAddr;                          /* Staged sector address */
+    uint32 stagedLen;                           /* Staged data len */
+    uint8 aStagedBuf[FLASH_SECTOR_LEN];         /* Staged data, a sector in place */
+} tTestDelta;
+
+static uint8 *gs_pFlash = NULL_PTR;     /* Flash of the programmed bank from gs_flashBase */
+static uint32 gs_flashBase = 0u;
+static uint32 gs_flashLen = 0u;
+static uint32 gs_sectorCnt = 0u;        /* Updated sectors */
+static tTestDelta gs_stDelta;
+
+static uint32 gs_randSeed = 0x12345678u;
+
+/* xorshift32 */
+static uint32 GetRand(void)
+{
+    gs_randSeed ^= gs_randSeed << 13u;
+    gs_randSeed ^= gs_randSeed >> 17u;
+    gs_randSeed ^= gs_randSeed << 5u;
+    return gs_randSeed;
+}
+
+static uint8 *ReadFile(const char *i_pName, uint32 *o_pLen)
+{
+    FILE *pFile = fopen(i_pName, "rb");
+    uint8 *pBuf = NULL_PTR;
+    long len = 0;
+
+    if (NULL_PTR == pFile)
+    {
+        return NULL_PTR;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    len = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pBuf = (uint8 *)malloc((size_t)len + 1u);
+
+    if ((NULL_PTR != pBuf) && ((size_t)len != fread(pBuf, 1u, (size_t)len, pFile)))
+    {
+        free(pBuf);
+        pBuf = NULL_PTR;
+    }
+
+    fclose(pFile);
+    *o_pLen = (uint32)len;
+    return pBuf;
+}
+
+/* Program staged data, A/B is programmed at download address, in place the whole sector is erased and programmed */
+static void ProgramStagedData(void)
+{
+    tTestDelta *pstDelta = &gs_stDelta;
+
+    if (TRUE == pstDelta->isInPlace)
+    {
+        memcpy(&gs_pFlash[pstDelta->sectorAddr - gs_flashBase], pstDelta->aStagedBuf, FLASH_SECTOR_LEN);
+        gs_sectorCnt++;
+        /* As DoDeltaSectorUpdatedResponse of uds_app_cfg.c */
+        pstDelta->startAddr += pstDelta->stagedLen;
+        pstDelta->dataLen -= pstDelta->stagedLen;
+        pstDelta->sectorAddr += FLASH_SECTOR_LEN;
+        memset(pstDelta->aStagedBuf, 0xFF, sizeof(pstDelta->aStagedBuf));
+        Delta_SetOldLowLimit(pstDelta->sectorAddr - pstDelta->sourceAddr);
+    }
+    else
+    {
+        memcpy(&gs_pFlash[pstDelta->startAddr - gs_flashBase], pstDelta->aStagedBuf, pstDelta->stagedLen);
+        pstDelta->startAddr += pstDelta->stagedLen;
+        pstDelta->dataLen -= pstDelta->stagedLen;
+    }
+
+    pstDelta->stagedLen = 0u;
+}
+
+/* Apply a block of compressed patch as ApplyDeltaDownloadData of uds_app_cfg.c, return FALSE if it gets NRC */
+static boolean ApplyBlock(const uint8 *i_pInBuf, const uint32 i_inLen)
+{
+    uint32 usedLen = 0u;
+    uint32 outLen = 0u;
+    uint32 sectorOffset = 0u;
+    uint8 *pStagedBuf = NULL_PTR;
+    uint32 stagedBufLen = 0u;
+    tTestDelta *pstDelta = &gs_stDelta;
+
+    pstDelta->pInBuf = i_pInBuf;
+    pstDelta->inLen = i_inLen;
+    pstDelta->inPos = 0u;
+
+    while ((pstDelta->patchPos < pstDelta->patchLen) || (pstDelta->inPos < pstDelta->inLen) ||
+            (TRUE == Delta_IsCopyPending()))
+    {
+        if (0u == pstDelta->dataLen)
+        {
+            return FALSE;
+        }
+
+        if ((pstDelta->patchPos >= pstDelta->patchLen) && (pstDelta->inPos < pstDelta->inLen))
+        {
+            pstDelta->patchLen = LZSS_Decode(&pstDelta->pInBuf[pstDelta->inPos], pstDelta->inLen - pstDelta->inPos,
+                                             &usedLen, pstDelta->aPatchBuf, TEST_PATCH_BUF_LEN);
+            pstDelta->inPos += usedLen;
+            pstDelta->patchPos = 0u;
+            continue;
+        }
+
+        /* Staged buffer moves with the sector in place */
+        sectorOffset = (TRUE == pstDelta->isInPlace) ? (pstDelta->startAddr - pstDelta->sectorAddr) : 0u;
+        pStagedBuf = &pstDelta->aStagedBuf[sectorOffset];
+        stagedBufLen = (TRUE == pstDelta->isInPlace) ? (FLASH_SECTOR_LEN - sectorOffset) : TEST_BLOCK_DATA_LEN;
+        outLen = stagedBufLen - pstDelta->stagedLen;
+
+        if (outLen > (pstDelta->dataLen - pstDelta->stagedLen))
+        {
+            outLen = pstDelta->dataLen - pstDelta->stagedLen;
+        }
+
+        if (TRUE != Delta_Decode(&pstDelta->aPatchBuf[pstDelta->patchPos], pstDelta->patchLen - pstDelta->patchPos,
+                                 &usedLen, &pStagedBuf[pstDelta->stagedLen], outLen, &outLen))
+        {
+            return FALSE;
+        }
+
+        pstDelta->patchPos += usedLen;
+        pstDelta->stagedLen += outLen;
+
+        if ((stagedBufLen == pstDelta->stagedLen) || (pstDelta->dataLen == pstDelta->stagedLen))
+        {
+            ProgramStagedData();
+        }
+    }
+
+    return TRUE;
+}
+
+/* Download a compressed patch, old image is in the other bank (A/B) or at download address (in place).
+   Return TRUE if all blocks are accepted and the programmed image is new image. */
+static boolean RunDownload(const char *i_pName, const uint8 *i_pStream, const uint32 i_streamLen,
+                           const uint8 *i_pOld, const uint32 i_oldLen, const uint8 *i_pNew, const uint32 i_newLen,
+                           const uint32 i_downloadAddr, const boolean i_isInPlace)
+{
+    static uint8 aOldBank[TEST_FLASH_MAX_LEN];
+    tTestDelta *pstDelta = &gs_stDelta;
+    const uint32 offset = i_downloadAddr - gs_flashBase;
+    uint32 blockOffset = 0u;
+    uint32 blockLen = 0u;
+    uint32 blockCnt = 0u;
+    boolean isAccepted = TRUE;
+    boolean isSame = FALSE;
+
+    memset(gs_pFlash, 0xFF, gs_flashLen);
+    memset(aOldBank, 0xFF, gs_flashLen);
+    memset(pstDelta, 0, sizeof(*pstDelta));
+    memset(pstDelta->aStagedBuf, 0xFF, sizeof(pstDelta->aStagedBuf));
+    gs_sectorCnt = 0u;
+    pstDelta->isInPlace = i_isInPlace;
+    pstDelta->startAddr = i_downloadAddr;
+    pstDelta->dataLen = i_newLen;
+    pstDelta->sourceAddr = i_downloadAddr;
+    pstDelta->sectorAddr = i_downloadAddr - (i_downloadAddr % FLASH_SECTOR_LEN);
+
+    /* Old image is read in place from flash, in place it is overwritten sector by sector */
+    if (TRUE == i_isInPlace)
+    {
+        memcpy(&gs_pFlash[offset], i_pOld, i_oldLen);
+        Delta_Init(&gs_pFlash[offset], gs_flashLen - offset);
+    }
+    else
+    {
+        memcpy(&aOldBank[offset], i_pOld, i_oldLen);
+        Delta_Init(&aOldBank[offset], gs_flashLen - offset);
+    }
+
+    LZSS_Init();
+
+    for (blockOffset = 0u; (blockOffset < i_streamLen) && (TRUE == isAccepted); blockOffset += blockLen)
+    {
+        blockLen = ((i_streamLen - blockOffset) > TEST_BLOCK_DATA_LEN) ? TEST_BLOCK_DATA_LEN : (i_streamLen - blockOffset);
+        isAccepted = ApplyBlock(&i_pStream[blockOffset], blockLen);
+        blockCnt++;
+    }
+
+    isSame = ((TRUE == isAccepted) && (0u == pstDelta->dataLen) &&
+              (0 == memcmp(&gs_pFlash[offset], i_pNew, i_newLen))) ? TRUE : FALSE;
+    printf("%-10s %s: %u B patch in %u blocks, %u sectors updated, %s\n", i_pName,
+           (TRUE == i_isInPlace) ? "in place" : "A/B     ", (unsigned int)i_streamLen, (unsigned int)blockCnt,
+           (unsigned int)gs_sectorCnt, (TRUE != isAccepted) ? "rejected" :
+           ((TRUE == isSame) ? "image is new.bin" : "image is wrong"));
+    return isSame;
+}
+
+/* Flash from the sector of download address, the image fits in it */
+static boolean SetupFlash(const uint32 i_downloadAddr, const uint32 i_imageLen)
+{
+    gs_flashBase = i_downloadAddr - (i_downloadAddr % FLASH_SECTOR_LEN);
+    gs_flashLen = (i_downloadAddr - gs_flashBase) + i_imageLen;
+    gs_flashLen = ((gs_flashLen + FLASH_SECTOR_LEN - 1u) / FLASH_SECTOR_LEN) * FLASH_SECTOR_LEN;
+
+    if (gs_flashLen > TEST_FLASH_MAX_LEN)
+    {
+        printf("Images are more than 16 MB!\n");
+        return FALSE;
+    }
+
+    free(gs_pFlash);
+    gs_pFlash = (uint8 *)malloc(gs_flashLen);
+    return (NULL_PTR != gs_pFlash) ? TRUE : FALSE;
+}
+
+/* LZSS stream of literals only, a tag bit and 8 bits a byte */
+static uint32 LiteralStream(const uint8 *i_pData, const uint32 i_len, uint8 *o_pOut)
+{
+    uint32 bitPos = 0u;
+    uint32 index = 0u;
+    uint32 bit = 0u;
+    uint32 bits = 0u;
+
+    memset(o_pOut, 0, ((i_len * 9u) + 7u) / 8u);
+
+    for (index = 0u; index < i_len; index++)
+    {
+        bits = 0x100u | i_pData[index];
+
+        for (bit = 0u; bit < 9u; bit++, bitPos++)
+        {
+            if (0u != (bits & (0x100u >> bit)))
+            {
+                o_pOut[bitPos >> 3u] |= (uint8)(0x80u >> (bitPos & 7u));
+            }
+        }
+    }
+
+    return (bitPos + 7u) / 8u;
+}
+
+/* Patch of generated images for A/B and in place, its len is checked and it is downloaded */
+static unsigned long TestGeneratedPatch(const char *i_pName, const uint8 *i_pOld, const uint8 *i_pNew,
+                                        const uint32 i_downloadAddr)
+{
+    static unsigned char aPatch[(TEST_GEN_IMAGE_LEN * 17u) + 16u];
+    static uint8 aStream[((((TEST_GEN_IMAGE_LEN * 17u) + 16u) * 9u) / 8u) + 1u];
+    unsigned long errors = 0u;
+    unsigned long patchLen = 0u;
+    uint32 streamLen = 0u;
+    uint32 changedLen = 0u;
+    uint32 index = 0u;
+    boolean isInPlace = FALSE;
+
+    for (index = 0u; index < TEST_GEN_IMAGE_LEN; index++)
+    {
+        changedLen += (i_pOld[index] != i_pNew[index]) ? 1u : 0u;
+    }
+
+    for (index = 0u; index < 2u; index++)
+    {
+        isInPlace = (0u != index) ? TRUE : FALSE;
+        gs_downloadAddr = i_downloadAddr;
+        gs_sectorLen = (TRUE == isInPlace) ? FLASH_SECTOR_LEN : 0u;
+        patchLen = Diff(i_pOld, TEST_GEN_IMAGE_LEN, i_pNew, TEST_GEN_IMAGE_LEN, aPatch);
+        printf("%-10s %s: %u B changed, %lu B patch before LZSS\n", i_pName,
+               (TRUE == isInPlace) ? "in place" : "A/B     ", (unsigned int)changedLen, patchLen);
+
+        if ((patchLen > TEST_GEN_MAX_PATCH_LEN) ||
+                (0 == Verify(aPatch, patchLen, i_pOld, TEST_GEN_IMAGE_LEN, i_pNew, TEST_GEN_IMAGE_LEN)))
+        {
+            printf("FAILED: patch is more than %u B or it is not new image\n", (unsigned int)TEST_GEN_MAX_PATCH_LEN);
+            errors++;
+        }
+
+        streamLen = LiteralStream(aPatch, (uint32)patchLen, aStream);
+        errors += (TRUE == RunDownload(i_pName, aStream, streamLen, i_pOld, TEST_GEN_IMAGE_LEN,
+                                       i_pNew, TEST_GEN_IMAGE_LEN, i_downloadAddr, isInPlace)) ? 0u : 1u;
+    }
+
+    return errors;
+}
+
+/* Unchanged image, and a small change: a rewritten function and some relocated addresses */
+static unsigned long TestGeneratedImages(const uint32 i_downloadAddr)
+{
+    static uint8 aOld[TEST_GEN_IMAGE_LEN];
+    static uint8 aNew[TEST_GEN_IMAGE_LEN];
+    unsigned long errors = 0u;
+    uint32 index = 0u;
+    uint32 pos = 0u;
+
+    if (TRUE != SetupFlash(i_downloadAddr, TEST_GEN_IMAGE_LEN))
+    {
+        return 1u;
+    }
+
+    for (index = 0u; index < TEST_GEN_IMAGE_LEN; index++)
+    {
+        aOld[index] = (uint8)GetRand();
+    }
+
+    memcpy(aNew, aOld, sizeof(aNew));
+    errors += TestGeneratedPatch("unchanged", aOld, aNew, i_downloadAddr);
+
+    pos = TEST_GEN_IMAGE_LEN / 3u;
+
+    for (index = 0u; index < TEST_GEN_CHANGE_LEN; index++)
+    {
+        aNew[pos + index] = (uint8)GetRand();
+    }
+
+    for (index = 0u; index < TEST_GEN_RELOC_CNT; index++)
+    {
+        pos = (GetRand() % (TEST_GEN_IMAGE_LEN / 4u)) * 4u;
+        aNew[pos] = (uint8)(aNew[pos] + 0x40u);
+        aNew[pos + 1u] = (uint8)GetRand();
+    }
+
+    errors += TestGeneratedPatch("changed", aOld, aNew, i_downloadAddr);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    uint8 *pOld = NULL_PTR;
+    uint8 *pNew = NULL_PTR;
+    uint8 *pPatchAB = NULL_PTR;
+    uint8 *pPatchIP = NULL_PTR;
+    uint32 oldLen = 0u;
+    uint32 newLen = 0u;
+    uint32 patchABLen = 0u;
+    uint32 patchIPLen = 0u;
+    uint32 downloadAddr = 0u;
+    unsigned long errors = 0u;
+    int argIndex = 1;
+
+    if ((argc > 2) && (0 == strcmp(argv[1], "-a")))
+    {
+        downloadAddr = (uint32)strtoul(argv[2], NULL, 0);
+        argIndex = 3;
+    }
+
+    if ((argIndex != argc) && ((argIndex + 4) != argc))
+    {
+        printf("Usage: Delta_Test [-a download_addr] [old.bin new.bin patch_ab.lzss patch_ip.lzss]\n");
+        return 1;
+    }
+
+    errors += TestGeneratedImages(downloadAddr);
+
+    if (argIndex == argc)
+    {
+        printf("%lu errors\n", errors);
+        return (0u == errors) ? 0 : 1;
+    }
+
+    pOld = ReadFile(argv[argIndex], &oldLen);
+    pNew = ReadFile(argv[argIndex + 1], &newLen);
+    pPatchAB = ReadFile(argv[argIndex + 2], &patchABLen);
+    pPatchIP = ReadFile(argv[argIndex + 3], &patchIPLen);
+
+    if ((NULL_PTR == pOld) || (NULL_PTR == pNew) || (NULL_PTR == pPatchAB) || (NULL_PTR == pPatchIP))
+    {
+        printf("Read input files failed!\n");
+        return 1;
+    }
+
+    /* Old and new image fit in flash */
+    if (TRUE != SetupFlash(downloadAddr, (oldLen > newLen) ? oldLen : newLen))
+    {
+        return 1;
+    }
+
+    printf("old %u B, new %u B, download address 0x%08X, sector %u B, block %u B\n", (unsigned int)oldLen,
+           (unsigned int)newLen, (unsigned int)downloadAddr, (unsigned int)FLASH_SECTOR_LEN,
+           (unsigned int)TEST_BLOCK_DATA_LEN);
+
+    errors += (TRUE == RunDownload(argv[argIndex + 2], pPatchAB, patchABLen, pOld, oldLen, pNew, newLen,
+                                   downloadAddr, FALSE)) ? 0u : 1u;
+    /* Sector staged patch reads old data only above the rebuilding sector, so it is valid in A/B too */
+    errors += (TRUE == RunDownload(argv[argIndex + 3], pPatchIP, patchIPLen, pOld, oldLen, pNew, newLen,
+                                   downloadAddr, FALSE)) ? 0u : 1u;
+    errors += (TRUE == RunDownload(argv[argIndex + 3], pPatchIP, patchIPLen, pOld, oldLen, pNew, newLen,
+                                   downloadAddr, TRUE)) ? 0u : 1u;
+    /* Informative: A/B patch may read overwritten old data in place */
+    (void)RunDownload(argv[argIndex + 2], pPatchAB, patchABLen, pOld, oldLen, pNew, newLen, downloadAddr, TRUE);
+
+    printf("%lu errors\n", errors);
+    return (0u == errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
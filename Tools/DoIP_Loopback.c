@@ -0,0 +1,380 @@
+/*
+ * @ : DoIP_Loopback.c
+ * @ : Host DoIP TP loopback test
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host protocol and throughput test of DoIP TP over loopback TCP
+**
+**  Build (in repo root):
+**      gcc -O2 -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_ETHERNET_TP \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o DoIP_Loopback \
+**          Tools/DoIP_Loopback.c Tools/socket_hal_host.c UDS_DriverConfig/eth_driver.c \
+**          UDS_ProtocolStack/TP.c UDS_ProtocolStack/TP_cfg.c \
+**          UDS_ProtocolStack/DoIP_tp.c UDS_ProtocolStack/DoIP_tp_cfg.c \
+**          UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  Usage: DoIP_Loopback [messages]
+**
+**  Child process is the ECU: DoIP TP and eth_driver on Tools/socket_hal_host.c, port DOIP_TCP_PORT
+**  of 127.0.0.1. Each request <SID> <index> ... is answered <SID + 0x40> <index>.
+**  Parent process is the tester: checks routing activation, diagnostic message ACK/NACK, generic
+**  header NACK, alive check and initial inactivity, then times 150 bytes request/response pairs.
+*******************************************************/
+
+/* Before system headers, their macros break S32K144.h */
+#include "TP.h"
+#include "eth_driver.h"
+/* Byte order macros of common_types.h break socket headers, use functions of them */
+#undef ntohs
+#undef ntohl
+#undef htons
+#undef htonl
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <signal.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#define TEST_TESTER_ADDR    (DOIP_TESTER_ADDR_MIN)
+#define TEST_REQ_LEN        (150u)      /* Request len, max UDS message len */
+#define TEST_RX_TIMEOUT_MS  (3000)      /* No DoIP message, initial inactivity is 2 s */
+
+#define TEST_CHECK(x) do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); s_errors++; } } while (0)
+
+static unsigned long s_errors = 0u;
+
+/* Stubs of S32K SDK and timer HAL, CAN TP is enabled by user_config.h beside DoIP TP */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return 0u;
+}
+
+static long long GetTimeUs(void)
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (long long)stTime.tv_sec * 1000000LL + stTime.tv_nsec / 1000;
+}
+
+/* ECU, DoIP TP echo a response for each request. Run until killed. */
+static void RunECU(void)
+{
+    uint8 aMsgBuf[TP_MAX_MSG_LEN];
+    uint8 aResp[2u] = {0u};
+    uint32 msgId = 0u;
+    uint32 msgLen = 0u;
+    long long tickTime = GetTimeUs();
+    long long nowTime = 0;
+
+    TP_Init();
+    InitEth();
+
+    for (;;)
+    {
+        EthMsgMainFun();
+        TP_MainFun();
+
+        while (TRUE == TP_ReadAFrameDataFromTP(&msgId, &msgLen, aMsgBuf))
+        {
+            aResp[0u] = (uint8)(aMsgBuf[0u] + 0x40u);
+            aResp[1u] = (msgLen > 1u) ? aMsgBuf[1u] : 0u;
+            (void)TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), NULL_PTR, sizeof(aResp), aResp);
+        }
+
+        TP_MainFun();
+        EthMsgMainFun();
+        nowTime = GetTimeUs();
+
+        while ((nowTime - tickTime) >= 1000)
+        {
+            TP_SystemTickCtl();
+            tickTime += 1000;
+        }
+
+        usleep(10);
+    }
+}
+
+static int Connect(void)
+{
+    struct sockaddr_in stAddr;
+    int option = 1;
+    int fd = -1;
+    int retry = 0;
+
+    memset(&stAddr, 0, sizeof(stAddr));
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_port = htons(DOIP_TCP_PORT);
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    /* ECU is starting or closing last connection */
+    for (retry = 0; retry < 100; retry++)
+    {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+
+        if (0 == connect(fd, (struct sockaddr *)&stAddr, sizeof(stAddr)))
+        {
+            (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+            return fd;
+        }
+
+        close(fd);
+        usleep(20000);
+    }
+
+    printf("Connect ECU failed!\n");
+    exit(1);
+}
+
+static void SendMsg(const int fd, const uint16 type, const uint8 *pPayload, const uint32 len)
+{
+    uint8 aMsg[DOIP_HEADER_LEN + 512u];
+    aMsg[0u] = DOIP_PROTOCOL_VERSION;
+    aMsg[1u] = (uint8)~DOIP_PROTOCOL_VERSION;
+    aMsg[2u] = (uint8)(type >> 8u);
+    aMsg[3u] = (uint8)type;
+    aMsg[4u] = (uint8)(len >> 24u);
+    aMsg[5u] = (uint8)(len >> 16u);
+    aMsg[6u] = (uint8)(len >> 8u);
+    aMsg[7u] = (uint8)len;
+    memcpy(&aMsg[DOIP_HEADER_LEN], pPayload, len);
+    (void)send(fd, aMsg, DOIP_HEADER_LEN + len, MSG_NOSIGNAL);
+}
+
+static void SendDiagMsg(const int fd, const uint16 TA, const uint8 *pData, const uint32 len)
+{
+    uint8 aPayload[4u + 512u];
+    aPayload[0u] = (uint8)(TEST_TESTER_ADDR >> 8u);
+    aPayload[1u] = (uint8)TEST_TESTER_ADDR;
+    aPayload[2u] = (uint8)(TA >> 8u);
+    aPayload[3u] = (uint8)TA;
+    memcpy(&aPayload[4u], pData, len);
+    SendMsg(fd, DOIP_DIAG_MSG, aPayload, 4u + len);
+}
+
+static boolean RecvAll(const int fd, uint8 *pBuf, uint32 len)
+{
+    struct pollfd stPoll = {fd, POLLIN, 0};
+    ssize_t n = 0;
+
+    while (0u != len)
+    {
+        if (poll(&stPoll, 1, TEST_RX_TIMEOUT_MS) <= 0)
+        {
+            return FALSE;
+        }
+
+        n = recv(fd, pBuf, len, 0);
+
+        if (n <= 0)
+        {
+            return FALSE;
+        }
+
+        pBuf += n;
+        len -= (uint32)n;
+    }
+
+    return TRUE;
+}
+
+/* Receive a DoIP message, return payload type or -1 if socket is closed or timeout */
+static int RecvMsg(const int fd, uint8 *pPayload, uint32 *pLen)
+{
+    uint8 aHeader[DOIP_HEADER_LEN];
+    uint32 len = 0u;
+
+    if (TRUE != RecvAll(fd, aHeader, sizeof(aHeader)))
+    {
+        return -1;
+    }
+
+    len = ((uint32)aHeader[4u] << 24u) | ((uint32)aHeader[5u] << 16u) | ((uint32)aHeader[6u] << 8u) | aHeader[7u];
+
+    if ((len > 512u) || (TRUE != RecvAll(fd, pPayload, len)))
+    {
+        return -1;
+    }
+
+    *pLen = len;
+    return (int)(((uint32)aHeader[2u] << 8u) | aHeader[3u]);
+}
+
+static uint8 ActivateRouting(const int fd, const uint16 SA)
+{
+    uint8 aPayload[512u] = {0u};
+    uint32 len = 0u;
+    aPayload[0u] = (uint8)(SA >> 8u);
+    aPayload[1u] = (uint8)SA;
+    SendMsg(fd, DOIP_ROUTING_ACTIVATION_REQ, aPayload, 7u);
+    TEST_CHECK(DOIP_ROUTING_ACTIVATION_RSP == RecvMsg(fd, aPayload, &len));
+    TEST_CHECK((9u == len) && ((DOIP_ECU_ADDR >> 8u) == aPayload[2u]) && ((uint8)DOIP_ECU_ADDR == aPayload[3u]));
+    return aPayload[4u];
+}
+
+/* Expect a diagnostic message ACK/NACK with code */
+static void CheckDiagAck(const int fd, const uint16 type, const uint8 code)
+{
+    uint8 aPayload[512u];
+    uint32 len = 0u;
+    TEST_CHECK(type == RecvMsg(fd, aPayload, &len));
+    TEST_CHECK((len >= 5u) && (code == aPayload[4u]));
+}
+
+/* Expect a diagnostic message response: SA ECU | TA tester | data */
+static void CheckDiagResp(const int fd, const uint8 SID, const uint8 index)
+{
+    uint8 aPayload[512u];
+    uint32 len = 0u;
+    TEST_CHECK(DOIP_DIAG_MSG == RecvMsg(fd, aPayload, &len));
+    TEST_CHECK((6u == len) && ((uint8)DOIP_ECU_ADDR == aPayload[1u]) && ((uint8)TEST_TESTER_ADDR == aPayload[3u]) &&
+               ((uint8)(SID + 0x40u) == aPayload[4u]) && (index == aPayload[5u]));
+}
+
+static void CheckGenericNack(const int fd, const uint8 code)
+{
+    uint8 aPayload[512u];
+    uint32 len = 0u;
+    TEST_CHECK(DOIP_GENERIC_NACK == RecvMsg(fd, aPayload, &len));
+    TEST_CHECK((1u == len) && (code == aPayload[0u]));
+}
+
+static void CheckClosed(const int fd)
+{
+    uint8 aPayload[512u];
+    uint32 len = 0u;
+    TEST_CHECK(-1 == RecvMsg(fd, aPayload, &len));
+    close(fd);
+}
+
+static void RunProtocolTest(void)
+{
+    uint8 aData[512u] = {0u};
+    uint8 aBadHeader[DOIP_HEADER_LEN] = {DOIP_PROTOCOL_VERSION, DOIP_PROTOCOL_VERSION, 0u, 0x07u, 0u, 0u, 0u, 0u};
+    uint32 len = 0u;
+    long long startTime = 0;
+    int fd = Connect();
+
+    /* Diagnostic message before routing activation */
+    aData[0u] = 0x10u;
+    aData[1u] = 0x01u;
+    SendDiagMsg(fd, DOIP_ECU_ADDR, aData, 2u);
+    CheckDiagAck(fd, DOIP_DIAG_MSG_NEG_ACK, DOIP_DIAG_NACK_INVALID_SA);
+    CheckClosed(fd);
+
+    /* Unknown tester address */
+    fd = Connect();
+    TEST_CHECK(DOIP_RA_UNKNOWN_SA == ActivateRouting(fd, 0x0100u));
+    CheckClosed(fd);
+
+    fd = Connect();
+    TEST_CHECK(DOIP_RA_SUCCESSFUL == ActivateRouting(fd, TEST_TESTER_ADDR));
+
+    /* Unknown payload type is discarded, socket keeps open */
+    SendMsg(fd, 0x1234u, aData, 3u);
+    CheckGenericNack(fd, DOIP_NACK_UNKNOWN_TYPE);
+
+    SendDiagMsg(fd, DOIP_ECU_ADDR, aData, TP_MAX_MSG_LEN + 1u);
+    CheckGenericNack(fd, DOIP_NACK_MSG_TOO_LARGE);
+
+    SendDiagMsg(fd, 0x1234u, aData, 2u);
+    CheckDiagAck(fd, DOIP_DIAG_MSG_NEG_ACK, DOIP_DIAG_NACK_UNKNOWN_TA);
+
+    /* Functional request */
+    aData[0u] = 0x31u;
+    aData[1u] = 0x01u;
+    SendDiagMsg(fd, DOIP_FUN_ADDR, aData, 2u);
+    CheckDiagAck(fd, DOIP_DIAG_MSG_POS_ACK, DOIP_DIAG_ACK);
+    CheckDiagResp(fd, 0x31u, 0x01u);
+
+    SendMsg(fd, DOIP_ALIVE_CHECK_REQ, aData, 0u);
+    TEST_CHECK(DOIP_ALIVE_CHECK_RSP == RecvMsg(fd, aData, &len));
+    TEST_CHECK((2u == len) && ((DOIP_ECU_ADDR >> 8u) == aData[0u]) && ((uint8)DOIP_ECU_ADDR == aData[1u]));
+
+    /* Version and inverse version not match */
+    (void)send(fd, aBadHeader, sizeof(aBadHeader), MSG_NOSIGNAL);
+    CheckGenericNack(fd, DOIP_NACK_INCORRECT_PATTERN);
+    CheckClosed(fd);
+
+    /* No routing activation, closed after T_TCP_Initial_Inactivity */
+    fd = Connect();
+    startTime = GetTimeUs();
+    CheckClosed(fd);
+    startTime = GetTimeUs() - startTime;
+    TEST_CHECK((startTime > 1800000) && (startTime < 2500000));
+    printf("protocol: initial inactivity closed socket after %.2f s\n", (double)startTime / 1e6);
+}
+
+static void RunThroughputTest(const uint32 msgNum)
+{
+    uint8 aData[TEST_REQ_LEN] = {0x36u};
+    uint32 index = 0u;
+    long long usedTime = 0;
+    const int fd = Connect();
+
+    TEST_CHECK(DOIP_RA_SUCCESSFUL == ActivateRouting(fd, TEST_TESTER_ADDR));
+    usedTime = GetTimeUs();
+
+    for (index = 0u; index < msgNum; index++)
+    {
+        aData[1u] = (uint8)index;
+        SendDiagMsg(fd, DOIP_ECU_ADDR, aData, sizeof(aData));
+        CheckDiagAck(fd, DOIP_DIAG_MSG_POS_ACK, DOIP_DIAG_ACK);
+        CheckDiagResp(fd, 0x36u, (uint8)index);
+    }
+
+    usedTime = GetTimeUs() - usedTime;
+    close(fd);
+    printf("throughput: %u request/response of %u B in %.3f s, %.0f msg/s, %.0f B/s\n",
+           msgNum, TEST_REQ_LEN, (double)usedTime / 1e6,
+           (double)msgNum * 1e6 / (double)usedTime, (double)msgNum * TEST_REQ_LEN * 1e6 / (double)usedTime);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32 msgNum = (uint32)((argc > 1) ? atoi(argv[1]) : 5000);
+    pid_t ecuPid = 0;
+
+    if (0u == msgNum)
+    {
+        printf("Usage: DoIP_Loopback [messages]\n");
+        return 1;
+    }
+
+    fflush(stdout);
+    ecuPid = fork();
+
+    if (0 == ecuPid)
+    {
+        RunECU();
+        _exit(0);
+    }
+
+    RunProtocolTest();
+    RunThroughputTest(msgNum);
+    kill(ecuPid, SIGTERM);
+    waitpid(ecuPid, NULL, 0);
+    printf("%lu errors\n", s_errors);
+    return (0u == s_errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,108 @@
+/*
+ * @ : FIFO_Bench.c
+ * @ : Host FIFO microbenchmark
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host microbenchmark of FIFO operations on the four FIFOs in use
+**
+**  Build (in repo root):
+**      gcc -O2 -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o FIFO_Bench \
+**          Tools/FIFO_Bench.c UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  Usage: FIFO_Bench [loops] [message len]
+**  FIFOs are defined as the TP RX/TX queues and CAN RX/TX bus FIFOs are (same len).
+**  A loop is GetCanWriteLen, WriteDataInFifo, GetCanReadLen and ReadDataFromFifo of a message,
+**  result is FIFO operations per second.
+*******************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "multi_cyc_fifo.h"
+#include "TP_cfg.h"
+#include "can_tp_cfg.h"
+
+FIFO_DEFINE(gs_stRxTPQueue, RX_TP_QUEUE_ID, RX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stTxTPQueue, CAN_TX_TP_QUEUE_ID, TX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stCANRxBusFifo, CAN_RX_BUS_FIFO, CAN_RX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stCANTxBusFifo, CAN_TX_BUS_FIFO, CAN_TX_BUS_FIFO_LEN);
+
+typedef struct
+{
+    const char *pName;
+    tFifoHandle xFifo;
+    unsigned int fifoLen;
+} tBenchFifo;
+
+static double GetSeconds(void)
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (double)stTime.tv_sec + (double)stTime.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    const tBenchFifo astFifo[] =
+    {
+        {"TP RX queue", &gs_stRxTPQueue, RX_TP_QUEUE_LEN},
+        {"TP TX queue", &gs_stTxTPQueue, TX_TP_QUEUE_LEN},
+        {"CAN RX bus FIFO", &gs_stCANRxBusFifo, CAN_RX_BUS_FIFO_LEN},
+        {"CAN TX bus FIFO", &gs_stCANTxBusFifo, CAN_TX_BUS_FIFO_LEN},
+    };
+    const long loops = (argc > 1) ? atol(argv[1]) : 20000000L;
+    const tLen msgLen = (tLen)((argc > 2) ? atoi(argv[2]) : 20);
+    unsigned char aWriteBuf[64u];
+    unsigned char aReadBuf[64u];
+    unsigned int index = 0u;
+    long loop = 0;
+    unsigned long errors = 0u;
+    tLen xLen = 0u;
+    tErroCode eStatus = ERRO_NONE;
+    double startTime = 0.0;
+    double usedTime = 0.0;
+
+    if ((0 >= loops) || (0u == msgLen) || (msgLen > sizeof(aWriteBuf)))
+    {
+        printf("Usage: FIFO_Bench [loops] [message len 1..%u]\n", (unsigned int)sizeof(aWriteBuf));
+        return 1;
+    }
+
+    for (index = 0u; index < sizeof(aWriteBuf); index++)
+    {
+        aWriteBuf[index] = (unsigned char)index;
+    }
+
+    for (index = 0u; index < (sizeof(astFifo) / sizeof(astFifo[0u])); index++)
+    {
+        startTime = GetSeconds();
+
+        for (loop = 0; loop < loops; loop++)
+        {
+            GetCanWriteLen(astFifo[index].xFifo, &xLen, &eStatus);
+            WriteDataInFifo(astFifo[index].xFifo, aWriteBuf, msgLen, &eStatus);
+            errors += (ERRO_NONE != eStatus) ? 1u : 0u;
+            GetCanReadLen(astFifo[index].xFifo, &xLen, &eStatus);
+            ReadDataFromFifo(astFifo[index].xFifo, msgLen, aReadBuf, &xLen, &eStatus);
+            errors += ((ERRO_NONE != eStatus) || (msgLen != xLen)) ? 1u : 0u;
+        }
+
+        usedTime = GetSeconds() - startTime;
+        errors += (0 != memcmp(aWriteBuf, aReadBuf, msgLen)) ? 1u : 0u;
+        printf("%-16s len %4u: %6.1f Mops/s, %5.1f ns per write + read\n",
+               astFifo[index].pName,
+               astFifo[index].fifoLen,
+               4.0 * (double)loops / usedTime / 1e6,
+               usedTime * 1e9 / (double)loops);
+    }
+
+    printf("%lu errors\n", errors);
+    return (0u == errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
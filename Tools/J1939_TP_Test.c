@@ -0,0 +1,522 @@
+/*
+ * @ : J1939_TP_Test.c
+ * @ : Host J1939 TP protocol test and throughput vs CTS window
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host protocol test of J1939 TP (single frame, BAM, RTS/CTS, aborts, timeouts)
+**                and throughput of RTS/CTS against CTS window size
+**
+**  Build (in repo root):
+**      gcc -O2 -no-pie -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_J1939_TP \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o J1939_TP_Test \
+**          Tools/J1939_TP_Test.c UDS_ProtocolStack/TP.c UDS_ProtocolStack/TP_cfg.c \
+**          UDS_ProtocolStack/J1939_tp.c UDS_ProtocolStack/J1939_tp_cfg.c \
+**          UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  TX callbacks are saved as uint32 in the TX FIFOs, -no-pie keeps their addresses in 32 bits.
+**  Usage: J1939_TP_Test [tester reaction time us]
+**
+**  One CAN bus is simulated in virtual time, a 29 bits ID frame takes TEST_FRAME_US and the ECU
+**  TX frame wins arbitration. J1939 TP main function runs each 1 ms tick, frames are RX in the
+**  interrupt and TX frames are read from the TX FIFO as the CAN driver does. The tester answers
+**  a TP.CM or the last TP.DT of a window after its reaction time.
+**  Throughput is from tester RTS (or ECU RTS) to EndOfMsgAck of a 130 bytes TransferData:
+**  ECU RX uses J1939_TP_RX_CTS_PACKETS, ECU TX is measured with tester CTS window 1 ~ J1939_TP_TX_CTS_PACKETS.
+*******************************************************/
+
+#include "TP.h"
+#include "J1939_tp_cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_FRAME_US       (550u)      /* 29 bits ID, 8 bytes, 250 kbit/s with stuff bits */
+#define TEST_STEP_US        (50u)       /* Virtual time step */
+#define TEST_QUEUE_LEN      (64u)       /* Tester TX queue len */
+#define TEST_MSG_LEN        (130u)      /* Throughput message len, TransferData of 128 bytes */
+
+#define TEST_CHECK(x) do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); s_errors++; } } while (0)
+
+#define TEST_TESTER_ID(pgn, da) J1939_BuildID(J1939_TP_PRIO, (pgn), (da), J1939_TESTER_ADDR)
+
+/* A CAN frame */
+typedef struct
+{
+    uint32 msgId;       /* CAN ID */
+    uint8 aData[8u];    /* Data */
+    uint8 dataLen;      /* Data len */
+    uint32 readyTime;   /* Tester TX it not before this time, us */
+} tTestFrame;
+
+/* Tester state */
+typedef struct
+{
+    tTestFrame astTxQueue[TEST_QUEUE_LEN];  /* Tester TX queue */
+    uint32 txHead;                          /* Next frame to TX */
+    uint32 txTail;                          /* Next free entry */
+    uint8 isSilent;                         /* Tester does not answer */
+    uint32 ctsWindow;                       /* CTS packets when tester RX */
+    uint8 aTxMsg[TP_MAX_MSG_LEN];           /* Message TX by tester RTS/CTS */
+    uint32 txMsgLen;
+    uint8 aRxMsg[TP_MAX_MSG_LEN];           /* Message RX from ECU */
+    uint32 rxMsgLen;                        /* RX message len, 0 = not RX */
+    uint32 rxTotalLen;                      /* RTS message len */
+    uint32 rxPackets;                       /* RTS packets */
+    uint32 ctsCnt;                          /* CTS RX from ECU */
+    uint32 ctsTxCnt;                        /* CTS TX to ECU */
+    uint32 eomaCnt;                         /* EndOfMsgAck RX from ECU */
+    uint32 abortCnt;                        /* Abort RX from ECU */
+    uint8 abortReason;                      /* Last abort reason */
+    uint32 ecuFrames;                       /* Frames RX from ECU */
+    uint32 doneTime;                        /* EndOfMsgAck RX or TX time */
+} tTestTester;
+
+static unsigned long s_errors = 0u;
+static uint32 gs_timeUs = 0u;
+static uint32 gs_reactUs = 1000u;
+static tTestTester gs_stTester;
+static tTestFrame gs_stBusFrame;
+static uint8 gs_busOwner = 0u;          /* 0 idle, 1 ECU, 2 tester */
+static uint32 gs_busEndTime = 0u;
+static int gs_udsTxResult = -1;
+
+/* Stubs of S32K SDK and timer HAL, CAN TP is enabled by user_config.h beside J1939 TP */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return gs_timeUs / 1000u;
+}
+
+static void UDSTxCallBack(uint8 i_result)
+{
+    gs_udsTxResult = i_result;
+}
+
+static void TesterQueueFrame(const uint32 i_msgId, const uint8 *i_pData, const uint32 i_readyTime)
+{
+    tTestFrame *pstFrame = &gs_stTester.astTxQueue[gs_stTester.txTail % TEST_QUEUE_LEN];
+
+    pstFrame->msgId = i_msgId;
+    memcpy(pstFrame->aData, i_pData, 8u);
+    pstFrame->dataLen = 8u;
+    pstFrame->readyTime = i_readyTime;
+    gs_stTester.txTail++;
+}
+
+static void TesterQueueCM(const uint8 i_control, const uint8 i_byte1, const uint8 i_byte2, const uint8 i_byte3, const uint8 i_byte4)
+{
+    const uint8 aCM[8u] = {i_control, i_byte1, i_byte2, i_byte3, i_byte4,
+                           (uint8)J1939_UDS_PGN, (uint8)(J1939_UDS_PGN >> 8u), (uint8)(J1939_UDS_PGN >> 16u)
+                          };
+
+    TesterQueueFrame(TEST_TESTER_ID(J1939_TP_CM_PGN, J1939_ECU_ADDR), aCM, gs_timeUs + gs_reactUs);
+}
+
+/* Queue CTS of next window from packet i_nextSN */
+static void TesterQueueCTS(const uint32 i_nextSN)
+{
+    uint32 packets = gs_stTester.rxPackets - i_nextSN + 1u;
+
+    packets = (packets > gs_stTester.ctsWindow) ? gs_stTester.ctsWindow : packets;
+    gs_stTester.ctsTxCnt++;
+    TesterQueueCM(J1939_TP_CM_CTS, (uint8)packets, (uint8)i_nextSN, 0xFFu, 0xFFu);
+}
+
+/* Queue TP.DT of tester message */
+static void TesterQueueDT(const uint8 i_da, uint32 i_sn, const uint32 i_packets, uint32 i_readyTime)
+{
+    uint8 aDT[8u];
+    uint32 offset = 0u;
+    uint32 dataLen = 0u;
+    uint32 index = 0u;
+
+    for (index = 0u; index < i_packets; index++, i_sn++)
+    {
+        memset(aDT, 0xFFu, sizeof(aDT));
+        aDT[0u] = (uint8)i_sn;
+        offset = (i_sn - 1u) * J1939_TP_DT_DATA_LEN;
+        dataLen = gs_stTester.txMsgLen - offset;
+        dataLen = (dataLen > J1939_TP_DT_DATA_LEN) ? J1939_TP_DT_DATA_LEN : dataLen;
+        memcpy(&aDT[1u], &gs_stTester.aTxMsg[offset], dataLen);
+        TesterQueueFrame(TEST_TESTER_ID(J1939_TP_DT_PGN, i_da), aDT, i_readyTime);
+    }
+}
+
+/* Tester RX a frame of ECU */
+static void TesterRxFrame(const tTestFrame *i_pstFrame)
+{
+    const uint32 pgn = J1939_GetPGN(i_pstFrame->msgId);
+    const uint8 *pData = i_pstFrame->aData;
+    uint32 sn = 0u;
+
+    gs_stTester.ecuFrames++;
+
+    if (J1939_TP_CM_PGN == pgn)
+    {
+        switch (pData[0u])
+        {
+        case J1939_TP_CM_CTS:
+            gs_stTester.ctsCnt++;
+
+            if (FALSE == gs_stTester.isSilent)
+            {
+                TesterQueueDT(J1939_ECU_ADDR, pData[2u], pData[1u], gs_timeUs + gs_reactUs);
+            }
+
+            break;
+
+        case J1939_TP_CM_EOMA:
+            gs_stTester.eomaCnt++;
+            gs_stTester.doneTime = gs_timeUs;
+            break;
+
+        case J1939_TP_CM_ABORT:
+            gs_stTester.abortCnt++;
+            gs_stTester.abortReason = pData[1u];
+            break;
+
+        case J1939_TP_CM_RTS:
+            gs_stTester.rxTotalLen = (uint32)pData[1u] | ((uint32)pData[2u] << 8u);
+            gs_stTester.rxPackets = pData[3u];
+            gs_stTester.ctsWindow = (gs_stTester.ctsWindow > pData[4u]) ? pData[4u] : gs_stTester.ctsWindow;
+
+            if (FALSE == gs_stTester.isSilent)
+            {
+                TesterQueueCTS(1u);
+            }
+
+            break;
+
+        default:
+            break;
+        }
+    }
+    else if (J1939_TP_DT_PGN == pgn)
+    {
+        sn = pData[0u];
+
+        if ((0u != sn) && (sn <= gs_stTester.rxPackets))
+        {
+            memcpy(&gs_stTester.aRxMsg[(sn - 1u) * J1939_TP_DT_DATA_LEN], &pData[1u], J1939_TP_DT_DATA_LEN);
+        }
+
+        if (FALSE == gs_stTester.isSilent)
+        {
+            if (sn == gs_stTester.rxPackets)
+            {
+                gs_stTester.rxMsgLen = gs_stTester.rxTotalLen;
+                gs_stTester.doneTime = gs_timeUs + gs_reactUs;
+                TesterQueueCM(J1939_TP_CM_EOMA, (uint8)gs_stTester.rxTotalLen, (uint8)(gs_stTester.rxTotalLen >> 8u),
+                              (uint8)gs_stTester.rxPackets, 0xFFu);
+            }
+            else if (0u == (sn % gs_stTester.ctsWindow))
+            {
+                TesterQueueCTS(sn + 1u);
+            }
+            else
+            {
+                /* Wait next TP.DT of the window */
+            }
+        }
+    }
+    else
+    {
+        memcpy(gs_stTester.aRxMsg, pData, i_pstFrame->dataLen);
+        gs_stTester.rxMsgLen = i_pstFrame->dataLen;
+    }
+}
+
+/* Step virtual time, bus and ECU tick */
+static void StepTime(void)
+{
+    tTPTxMsgHeader stTxMsgHeader;
+
+    if ((0u != gs_busOwner) && (gs_timeUs >= gs_busEndTime))
+    {
+        if (1u == gs_busOwner)
+        {
+            J1939TP_DoTxMsgSuccessfulCallBack();
+            TesterRxFrame(&gs_stBusFrame);
+        }
+        else
+        {
+            (void)J1939TP_DriverWriteDataInJ1939TP(gs_stBusFrame.msgId, gs_stBusFrame.dataLen, gs_stBusFrame.aData);
+        }
+
+        gs_busOwner = 0u;
+    }
+
+    if (0u == gs_busOwner)
+    {
+        if (TRUE == J1939TP_DriverPeekDataFromJ1939TP(8u, gs_stBusFrame.aData, &stTxMsgHeader))
+        {
+            J1939TP_DriverReleaseDataFromJ1939TP();
+            gs_stBusFrame.msgId = stTxMsgHeader.TxMsgID;
+            gs_stBusFrame.dataLen = (uint8)stTxMsgHeader.TxMsgLength;
+            gs_busOwner = 1u;
+            gs_busEndTime = gs_timeUs + TEST_FRAME_US;
+        }
+        else if ((gs_stTester.txHead != gs_stTester.txTail) &&
+                 (gs_stTester.astTxQueue[gs_stTester.txHead % TEST_QUEUE_LEN].readyTime <= gs_timeUs))
+        {
+            gs_stBusFrame = gs_stTester.astTxQueue[gs_stTester.txHead % TEST_QUEUE_LEN];
+            gs_stTester.txHead++;
+            gs_busOwner = 2u;
+            gs_busEndTime = gs_timeUs + TEST_FRAME_US;
+        }
+        else
+        {
+            /* Bus idle */
+        }
+    }
+
+    if (0u == (gs_timeUs % 1000u))
+    {
+        TP_SystemTickCtl();
+        TP_MainFun();
+    }
+
+    gs_timeUs += TEST_STEP_US;
+}
+
+static void RunTime(const uint32 i_timeUs)
+{
+    const uint32 endTime = gs_timeUs + i_timeUs;
+
+    while (gs_timeUs < endTime)
+    {
+        StepTime();
+    }
+}
+
+/* Clear tester and bus, ECU session is ended by its timeouts before */
+static void ResetTester(const uint32 i_ctsWindow)
+{
+    memset(&gs_stTester, 0, sizeof(gs_stTester));
+    gs_stTester.ctsWindow = i_ctsWindow;
+    gs_busOwner = 0u;
+}
+
+/* Read a message of ECU UDS RX, return len or 0 */
+static uint32 ReadUDSMsg(uint32 *o_pMsgId, uint8 *o_pMsgBuf)
+{
+    uint32 msgLen = 0u;
+
+    if (FALSE == TP_ReadAFrameDataFromTP(o_pMsgId, &msgLen, o_pMsgBuf))
+    {
+        return 0u;
+    }
+
+    return msgLen;
+}
+
+/* UDS app TX a response on J1939 channel */
+static void WriteUDSMsg(const uint8 *i_pData, const uint32 i_len)
+{
+    gs_udsTxResult = -1;
+    TP_SetCurChannel(TP_J1939_CHANNEL);
+    TEST_CHECK(TRUE == TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), UDSTxCallBack, i_len, i_pData));
+}
+
+/* Tester TX a message by RTS/CTS, return used time us from RTS to EndOfMsgAck or 0 */
+static uint32 TesterTxRTS(const uint8 *i_pData, const uint32 i_len)
+{
+    const uint32 startTime = gs_timeUs;
+    const uint32 packets = (i_len + J1939_TP_DT_DATA_LEN - 1u) / J1939_TP_DT_DATA_LEN;
+    const uint8 aRTS[8u] = {J1939_TP_CM_RTS, (uint8)i_len, (uint8)(i_len >> 8u), (uint8)packets, 0xFFu,
+                            (uint8)J1939_UDS_PGN, (uint8)(J1939_UDS_PGN >> 8u), (uint8)(J1939_UDS_PGN >> 16u)
+                           };
+
+    memcpy(gs_stTester.aTxMsg, i_pData, i_len);
+    gs_stTester.txMsgLen = i_len;
+    TesterQueueFrame(TEST_TESTER_ID(J1939_TP_CM_PGN, J1939_ECU_ADDR), aRTS, gs_timeUs);
+
+    while ((0u == gs_stTester.eomaCnt) && (0u == gs_stTester.abortCnt) && ((gs_timeUs - startTime) < 2000000u))
+    {
+        StepTime();
+    }
+
+    return (0u != gs_stTester.eomaCnt) ? (gs_stTester.doneTime - startTime) : 0u;
+}
+
+static void TestProtocol(void)
+{
+    uint8 aMsg[TP_MAX_MSG_LEN];
+    uint8 aData[40u];
+    const uint8 aSF[8u] = {0x10u, 0x03u, 0u, 0u, 0u, 0u, 0u, 0u};
+    const uint8 aResp[3u] = {0x50u, 0x03u, 0x00u};
+    uint8 aBAM[8u] = {J1939_TP_CM_BAM, 20u, 0u, 3u, 0xFFu,
+                      (uint8)J1939_UDS_PGN, (uint8)(J1939_UDS_PGN >> 8u), (uint8)(J1939_UDS_PGN >> 16u)
+                     };
+    uint32 msgId = 0u;
+    uint32 index = 0u;
+
+    for (index = 0u; index < sizeof(aData); index++)
+    {
+        aData[index] = (uint8)(0x40u + index);
+    }
+
+    /* Single frame, physical and functional */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    (void)J1939TP_DriverWriteDataInJ1939TP(J1939_BuildID(J1939_UDS_PRIO, J1939_UDS_PGN, J1939_ECU_ADDR, J1939_TESTER_ADDR), 2u, aSF);
+    RunTime(2000u);
+    TEST_CHECK((2u == ReadUDSMsg(&msgId, aMsg)) && (J1939TP_GetConfigRxMsgPHYID() == msgId) && (TP_J1939_CHANNEL == TP_GetCurChannel()));
+    (void)J1939TP_DriverWriteDataInJ1939TP(J1939_BuildID(J1939_UDS_PRIO, J1939_UDS_PGN, J1939_GLOBAL_ADDR, J1939_TESTER_ADDR), 2u, aSF);
+    RunTime(2000u);
+    TEST_CHECK((2u == ReadUDSMsg(&msgId, aMsg)) && (J1939TP_GetConfigRxMsgFUNID() == msgId));
+    TEST_CHECK(FALSE == J1939TP_IsRxMsgID(J1939_BuildID(J1939_UDS_PRIO, J1939_UDS_PGN, J1939_ECU_ADDR, 0x33u)));
+    TEST_CHECK(FALSE == J1939TP_IsRxMsgID(J1939_BuildID(J1939_UDS_PRIO, 0xEA00u, J1939_ECU_ADDR, J1939_TESTER_ADDR)));
+    printf("RX single frame PHY/FUN, ID filter\n");
+
+    /* BAM of 20 bytes, ECU does not answer */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    memcpy(gs_stTester.aTxMsg, aData, 20u);
+    gs_stTester.txMsgLen = 20u;
+    TesterQueueFrame(TEST_TESTER_ID(J1939_TP_CM_PGN, J1939_GLOBAL_ADDR), aBAM, gs_timeUs);
+
+    for (index = 1u; index <= 3u; index++)
+    {
+        /* BAM TP.DT are 50 ~ 200 ms apart */
+        TesterQueueDT(J1939_GLOBAL_ADDR, index, 1u, gs_timeUs + index * 50000u);
+    }
+
+    RunTime(200000u);
+    TEST_CHECK((20u == ReadUDSMsg(&msgId, aMsg)) && (0 == memcmp(aMsg, aData, 20u)) &&
+               (J1939TP_GetConfigRxMsgFUNID() == msgId) && (0u == gs_stTester.ecuFrames));
+    printf("RX BAM, no ECU frame\n");
+
+    /* RTS/CTS with a bad SN, abort 7 */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    gs_stTester.isSilent = TRUE;
+    gs_stTester.txMsgLen = 30u;
+    aBAM[0u] = J1939_TP_CM_RTS;
+    aBAM[1u] = 30u;
+    aBAM[3u] = 5u;
+    TesterQueueFrame(TEST_TESTER_ID(J1939_TP_CM_PGN, J1939_ECU_ADDR), aBAM, gs_timeUs);
+    RunTime(4000u);
+    TesterQueueDT(J1939_ECU_ADDR, 3u, 1u, gs_timeUs);
+    RunTime(3000u);
+    TEST_CHECK((1u == gs_stTester.ctsCnt) && (1u == gs_stTester.abortCnt) && (J1939_ABORT_BAD_SN == gs_stTester.abortReason));
+    printf("RX bad SN, abort %u\n", gs_stTester.abortReason);
+
+    /* RTS more than TP_MAX_MSG_LEN, abort 2 */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    aBAM[1u] = 200u;
+    aBAM[3u] = 29u;
+    TesterQueueFrame(TEST_TESTER_ID(J1939_TP_CM_PGN, J1939_ECU_ADDR), aBAM, gs_timeUs);
+    RunTime(4000u);
+    TEST_CHECK((1u == gs_stTester.abortCnt) && (J1939_ABORT_RESOURCES == gs_stTester.abortReason));
+    printf("RX RTS too long, abort %u\n", gs_stTester.abortReason);
+
+    /* RTS and no TP.DT, T2 timeout abort 3 */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    gs_stTester.isSilent = TRUE;
+    aBAM[1u] = 30u;
+    aBAM[3u] = 5u;
+    TesterQueueFrame(TEST_TESTER_ID(J1939_TP_CM_PGN, J1939_ECU_ADDR), aBAM, gs_timeUs);
+    RunTime(1300000u);
+    TEST_CHECK((1u == gs_stTester.abortCnt) && (J1939_ABORT_TIMEOUT == gs_stTester.abortReason));
+    printf("RX T2 timeout, abort %u\n", gs_stTester.abortReason);
+
+    /* TX single frame and callback */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    WriteUDSMsg(aResp, sizeof(aResp));
+    RunTime(3000u);
+    TEST_CHECK((TX_MSG_SUCCESSFUL == gs_udsTxResult) && (sizeof(aResp) == gs_stTester.rxMsgLen) &&
+               (0 == memcmp(gs_stTester.aRxMsg, aResp, sizeof(aResp))));
+    printf("TX single frame and callback\n");
+
+    /* TX RTS/CTS, tester CTS window 2 */
+    ResetTester(2u);
+    WriteUDSMsg(aData, sizeof(aData));
+    RunTime(50000u);
+    TEST_CHECK((TX_MSG_SUCCESSFUL == gs_udsTxResult) && (sizeof(aData) == gs_stTester.rxMsgLen) &&
+               (0 == memcmp(gs_stTester.aRxMsg, aData, sizeof(aData))));
+    printf("TX RTS/CTS window 2, %u ECU frames\n", gs_stTester.ecuFrames);
+
+    /* TX RTS and tester silent, T3 timeout abort 3 */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    gs_stTester.isSilent = TRUE;
+    WriteUDSMsg(aData, sizeof(aData));
+    RunTime(3000000u);
+    TEST_CHECK((TX_MSG_TIMEOUT == gs_udsTxResult) && (1u == gs_stTester.abortCnt) &&
+               (J1939_ABORT_TIMEOUT == gs_stTester.abortReason));
+    printf("TX T3 timeout, abort %u\n", gs_stTester.abortReason);
+}
+
+static void TestThroughput(void)
+{
+    uint8 aMsg[TP_MAX_MSG_LEN];
+    uint8 aData[TEST_MSG_LEN];
+    const uint32 aWindow[] = {1u, 2u, 4u, 8u, 16u};
+    uint32 msgId = 0u;
+    uint32 index = 0u;
+    uint32 usedTime = 0u;
+    uint32 startTime = 0u;
+
+    for (index = 0u; index < sizeof(aData); index++)
+    {
+        aData[index] = (uint8)(index * 3u);
+    }
+
+    aData[0u] = 0x36u;
+
+    /* ECU RX, ECU CTS window */
+    ResetTester(J1939_TP_TX_CTS_PACKETS);
+    usedTime = TesterTxRTS(aData, sizeof(aData));
+    TEST_CHECK((0u != usedTime) && (sizeof(aData) == ReadUDSMsg(&msgId, aMsg)) && (0 == memcmp(aMsg, aData, sizeof(aData))));
+    printf("ECU RX window %2u: %2u CTS, %6.2f ms per %u B message, %6.0f B/s\n",
+           (unsigned int)J1939_TP_RX_CTS_PACKETS, gs_stTester.ctsCnt, (double)usedTime / 1000.0,
+           (unsigned int)sizeof(aData), (0u != usedTime) ? (double)sizeof(aData) * 1e6 / (double)usedTime : 0.0);
+    RunTime(3000u);
+
+    /* ECU TX, tester CTS window */
+    for (index = 0u; index < (sizeof(aWindow) / sizeof(aWindow[0u])); index++)
+    {
+        if (aWindow[index] > J1939_TP_TX_CTS_PACKETS)
+        {
+            continue;
+        }
+
+        ResetTester(aWindow[index]);
+        startTime = gs_timeUs;
+        WriteUDSMsg(aData, sizeof(aData));
+
+        while ((gs_udsTxResult < 0) && ((gs_timeUs - startTime) < 2000000u))
+        {
+            StepTime();
+        }
+
+        usedTime = gs_stTester.doneTime - startTime;
+        TEST_CHECK((TX_MSG_SUCCESSFUL == gs_udsTxResult) && (sizeof(aData) == gs_stTester.rxMsgLen) &&
+                   (0 == memcmp(gs_stTester.aRxMsg, aData, sizeof(aData))));
+        printf("ECU TX window %2u: %2u CTS, %6.2f ms per %u B message, %6.0f B/s\n",
+               (unsigned int)aWindow[index], (unsigned int)gs_stTester.ctsTxCnt,
+               (double)usedTime / 1000.0, (unsigned int)sizeof(aData),
+               (double)sizeof(aData) * 1e6 / (double)usedTime);
+        RunTime(3000u);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    gs_reactUs = (uint32)((argc > 1) ? atoi(argv[1]) : 1000);
+    TP_Init();
+    TestProtocol();
+    TestThroughput();
+    printf("%lu errors\n", s_errors);
+    return (0u == s_errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
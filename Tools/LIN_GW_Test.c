@@ -0,0 +1,714 @@
+/*
+ * @ : LIN_GW_Test.c
+ * @ : Host CAN to LIN gateway test
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host test of the CAN to LIN gateway: start/stop routing routine, relayed response,
+**                NRC 0x78 while waiting, buffered TransferData overlap, late NRC and 3E 80 keep alive
+**
+**  Build (in repo root):
+**      gcc -O2 -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_CAN_LIN_GATEWAY \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o LIN_GW_Test \
+**          Tools/LIN_GW_Test.c UDS_ProtocolStack/LIN_gateway.c UDS_ProtocolStack/uds_app.c UDS_ProtocolStack/uds_app_cfg.c \
+**          UDS_ProtocolStack/TP_cfg.c UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  Usage: LIN_GW_Test
+**
+**  LIN_gateway_cfg.c is replaced by the tool: its g_stLINGatewayCfgInfo plugs in host 0x3C/0x3D hooks
+**  as a ported LIN master driver does. A LIN slave is simulated behind the hooks, it answers a 0x3D
+**  header by LINGW_DriverWriteSlaveResp when its response is ready. TP_ReadAFrameDataFromTP and
+**  TP_WriteAFrameDataInTP are replaced by the tool, so the tester talks to UDS_MainFun directly.
+**  Time is virtual, each step is the 1 ms tick of UDS_MAIN_Process. fls_app, UDS_alg_hal, CRC_HAL,
+**  watchdog and boot are stubbed.
+*******************************************************/
+
+#include "uds_app.h"
+#include "LIN_gateway.h"
+#include "fls_app.h"
+#include "UDS_alg_hal.h"
+#include "CRC_hal.h"
+#include "watchdog_hal.h"
+#include "boot.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_RESP_LOG_LEN   (32u)       /* Tester responses kept */
+#define TEST_SLAVE_RESP_NUM (2u)        /* Slave responses queued, NRC 0x78 and the final one */
+#define TEST_BLOCK_LEN      (22u)       /* TransferData request len, LIN FF and 3 CF */
+#define TEST_NRC_WRONG_BSC  (0x73u)     /* Wrong block sequence counter */
+
+#define TEST_CHECK(x) do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); s_errors++; } } while (0)
+
+/* A response TX to tester */
+typedef struct
+{
+    uint8 aData[LIN_GW_MAX_PDU_LEN];    /* Response */
+    uint32 dataLen;                     /* Response len */
+    uint32 timeMs;                      /* TX time */
+} tTestResp;
+
+/* A slave response waiting for 0x3D headers */
+typedef struct
+{
+    uint8 aData[LIN_GW_MAX_PDU_LEN];    /* Response */
+    uint16 dataLen;                     /* Response len */
+    uint16 txDataLen;                   /* Response len already TX */
+    uint8 sn;                           /* Next CF SN */
+    uint32 readyTime;                   /* TX it not before this time, ms */
+} tTestSlaveResp;
+
+/* LIN slave state */
+typedef struct
+{
+    uint8 aReqBuf[LIN_GW_MAX_PDU_LEN];  /* Request RX from master */
+    uint16 reqLen;                      /* Request len */
+    uint16 reqRxLen;                    /* Request len already RX */
+    uint8 reqSN;                        /* Next CF SN */
+    uint32 masterFrames;                /* 0x3C frames RX */
+    uint32 headers;                     /* 0x3D headers RX */
+    uint32 keepAliveCnt;                /* 3E 80 RX */
+    uint32 blockCnt;                    /* TransferData RX */
+    uint8 lastBsc;                      /* Last TransferData block sequence counter */
+    uint8 rejectBsc;                    /* Answer TransferData of this counter NRC 0x73, 0 = no */
+    uint8 pendingCnt;                   /* Answer NRC 0x78 before the next response */
+    uint32 respDelayMs;                 /* Final response delay */
+    tTestSlaveResp astResp[TEST_SLAVE_RESP_NUM];
+    uint32 respHead;                    /* Next response to TX */
+    uint32 respTail;                    /* Next free entry */
+} tTestSlave;
+
+static unsigned long s_errors = 0u;
+static uint32 gs_timeMs = 0u;
+static tTestSlave gs_stSlave;
+static uint8 gs_aReq[LIN_GW_MAX_PDU_LEN];
+static uint32 gs_reqLen = 0u;
+static tTestResp gs_astResp[TEST_RESP_LOG_LEN];
+static uint32 gs_respCnt = 0u;
+static uint32 gs_respRead = 0u;
+
+static boolean TestMasterReqTx(const uint8 *i_pFrameBuf);
+static boolean TestSlaveRespHeaderTx(void);
+
+/* Gateway config of the tool, same timing as LIN_gateway_cfg.c with host hooks */
+const tLINGatewayCfg g_stLINGatewayCfgInfo =
+{
+    1u,
+    10u,
+    50u,
+    5000u,
+    1000u,
+    5000u,
+    500u,
+    300u,
+    2000u,
+    TestMasterReqTx,
+    TestSlaveRespHeaderTx
+};
+
+/* Stubs of S32K SDK and timer HAL */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return gs_timeMs;
+}
+
+/* TP RX and TX of UDS app */
+boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID, uint32 *o_pxRxDataLen, uint8 *o_pDataBuf)
+{
+    if (0u == gs_reqLen)
+    {
+        return FALSE;
+    }
+
+    *o_pRxMsgID = TP_GetConfigRxMsgPHYID();
+    *o_pxRxDataLen = gs_reqLen;
+    memcpy(o_pDataBuf, gs_aReq, gs_reqLen);
+    gs_reqLen = 0u;
+    return TRUE;
+}
+
+boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
+                               const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+                               const uint32 i_xTxDataLen,
+                               const uint8 *i_pDataBuf)
+{
+    tTestResp *pstResp = &gs_astResp[gs_respCnt % TEST_RESP_LOG_LEN];
+
+    TEST_CHECK(TP_GetConfigTxMsgID() == i_TxMsgID);
+    TEST_CHECK(i_xTxDataLen <= sizeof(pstResp->aData));
+    (void)i_pfUDSTxMsgCallBack;
+    pstResp->dataLen = i_xTxDataLen;
+    pstResp->timeMs = gs_timeMs;
+    memcpy(pstResp->aData, i_pDataBuf, (i_xTxDataLen > sizeof(pstResp->aData)) ? sizeof(pstResp->aData) : i_xTxDataLen);
+    gs_respCnt++;
+    return TRUE;
+}
+
+/* Stubs of fls_app */
+void Flash_InitDowloadInfo(void)
+{
+}
+
+uint8 Flash_ProgramRegion(const uint32 i_addr, const uint8 *i_pDataBuf, const uint32 i_dataLen)
+{
+    (void)i_addr;
+    (void)i_pDataBuf;
+    (void)i_dataLen;
+    return FALSE;
+}
+
+uint8 Flash_FlushProgramData(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_IsProgramFailed(void)
+{
+    return FALSE;
+}
+
+#ifdef EN_DOWNLOAD_STATISTICS
+void Flash_GetStatistics(tFlashStatistics *o_pstStatistics)
+{
+    memset(o_pstStatistics, 0, sizeof(*o_pstStatistics));
+}
+#endif
+
+uint8 Flash_IsReadAppInfoFromFlashValid(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_IsAppInFlashValid(void)
+{
+    return TRUE;
+}
+
+void Flash_SavedReceivedCheckSumCrc(uint32 i_receivedCrc)
+{
+    (void)i_receivedCrc;
+}
+
+void Flash_EraseFlashDriverInRAM(void)
+{
+}
+
+void Flash_SetNextDownloadStep(const tFlDownloadStepType i_donwloadStep)
+{
+    (void)i_donwloadStep;
+}
+
+tFlDownloadStepType Flash_GetCurDownloadStep(void)
+{
+    return FL_REQUEST_STEP;
+}
+
+void Flash_SaveDownloadDataInfo(const uint32 i_dataStartAddr, const uint32 i_dataLen)
+{
+    (void)i_dataStartAddr;
+    (void)i_dataLen;
+}
+
+void Flash_SetOperateFlashActiveJob(const tFlshJobModle i_activeJob,
+                                    const tpfResponse i_pfActiveFinshedCallBack,
+                                    const uint8 i_requestUDSSerID,
+                                    const tpfReuestMoreTime i_pfRequestMoreTimeCallback)
+{
+    (void)i_activeJob;
+    (void)i_pfActiveFinshedCallBack;
+    (void)i_requestUDSSerID;
+    (void)i_pfRequestMoreTimeCallback;
+}
+
+void Flash_SaveFingerPrint(const uint8 *i_pFingerPrint, const uint8 i_FingerPrintLen)
+{
+    (void)i_pFingerPrint;
+    (void)i_FingerPrintLen;
+}
+
+uint8 Flash_WriteFlashAppInfo(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_GetNewestAppInfo(uint8 *o_pFingerPrint, uint8 *o_pAppCnt)
+{
+    memset(o_pFingerPrint, 0x5A, FL_FINGER_PRINT_LENGTH);
+    *o_pAppCnt = 1u;
+    return TRUE;
+}
+
+/* Stubs of UDS_alg_hal, CRC_HAL, watchdog and boot */
+void UDS_ALG_HAL_Init(void)
+{
+}
+
+boolean UDS_ALG_HAL_DecryptData(const uint8 *i_pCipherText, const uint32 i_dataLen, uint8 *o_pPlainText)
+{
+    memcpy(o_pPlainText, i_pCipherText, i_dataLen);
+    return TRUE;
+}
+
+boolean UDS_ALG_HAL_GetRandom(const uint32 i_needRandomDataLen, uint8 *o_pRandomDataBuf)
+{
+    memset(o_pRandomDataBuf, 0x11, i_needRandomDataLen);
+    return TRUE;
+}
+
+void UDS_ALG_HAL_AddSWTimerTickCnt(void)
+{
+}
+
+void CRC_HAL_CreatHardwareCrc(const uint8 *i_pucDataBuf, const uint32 i_ulDataLen, uint32 *m_pCurCrc)
+{
+    (void)i_pucDataBuf;
+    (void)i_ulDataLen;
+    (void)m_pCurCrc;
+}
+
+void WATCHDOG_HAL_SystemReset(void)
+{
+}
+
+void SetDownloadAppSuccessful(void)
+{
+}
+
+/* Slave queues a response, TX it from i_readyTime */
+static void SlaveQueueResp(const uint8 *i_pData, const uint16 i_dataLen, const uint32 i_readyTime)
+{
+    tTestSlaveResp *pstResp = &gs_stSlave.astResp[gs_stSlave.respTail % TEST_SLAVE_RESP_NUM];
+
+    TEST_CHECK((gs_stSlave.respTail - gs_stSlave.respHead) < TEST_SLAVE_RESP_NUM);
+    memcpy(pstResp->aData, i_pData, i_dataLen);
+    pstResp->dataLen = i_dataLen;
+    pstResp->txDataLen = 0u;
+    pstResp->sn = 1u;
+    pstResp->readyTime = i_readyTime;
+    gs_stSlave.respTail++;
+}
+
+/* Slave RX a whole request */
+static void SlaveRxRequest(void)
+{
+    const uint8 *pReq = gs_stSlave.aReqBuf;
+    uint8 aResp[LIN_GW_MAX_PDU_LEN];
+    uint16 respLen = 0u;
+
+    if ((0x3Eu == pReq[0u]) && (0x80u == pReq[1u]))
+    {
+        gs_stSlave.keepAliveCnt++;
+        return;
+    }
+
+    if (0x36u == pReq[0u])
+    {
+        gs_stSlave.blockCnt++;
+        gs_stSlave.lastBsc = pReq[1u];
+    }
+
+    if (0u != gs_stSlave.pendingCnt)
+    {
+        gs_stSlave.pendingCnt--;
+        aResp[0u] = NEGTIVE_RESPONSE_ID;
+        aResp[1u] = pReq[0u];
+        aResp[2u] = NRC_SERVICE_BUSY;
+        SlaveQueueResp(aResp, 3u, gs_timeMs + 10u);
+    }
+
+    if ((0x36u == pReq[0u]) && (gs_stSlave.rejectBsc == pReq[1u]))
+    {
+        aResp[0u] = NEGTIVE_RESPONSE_ID;
+        aResp[1u] = pReq[0u];
+        aResp[2u] = TEST_NRC_WRONG_BSC;
+        respLen = 3u;
+    }
+    else if (0x22u == pReq[0u])
+    {
+        /* DID record of 8 bytes, response needs LIN FF and CF */
+        memcpy(aResp, pReq, 3u);
+        aResp[0u] = 0x62u;
+        memcpy(&aResp[3u], "LINSLAVE", 8u);
+        respLen = 11u;
+    }
+    else
+    {
+        aResp[0u] = pReq[0u] + 0x40u;
+        aResp[1u] = pReq[1u];
+        respLen = 2u;
+    }
+
+    SlaveQueueResp(aResp, respLen, gs_timeMs + gs_stSlave.respDelayMs);
+}
+
+/* 0x3C master request frame hook, LIN driver TX it in this frame slot */
+static boolean TestMasterReqTx(const uint8 *i_pFrameBuf)
+{
+    const uint8 pci = i_pFrameBuf[1u];
+    uint16 copyLen = 0u;
+
+    gs_stSlave.masterFrames++;
+
+    if (LIN_GW_SLAVE_NAD != i_pFrameBuf[0u])
+    {
+        return TRUE;
+    }
+
+    switch (pci & 0xF0u)
+    {
+    case 0x00u:
+        gs_stSlave.reqLen = pci & 0x0Fu;
+        memcpy(gs_stSlave.aReqBuf, &i_pFrameBuf[2u], gs_stSlave.reqLen);
+        gs_stSlave.reqRxLen = gs_stSlave.reqLen;
+        break;
+
+    case 0x10u:
+        gs_stSlave.reqLen = (uint16)(((uint16)(pci & 0x0Fu) << 8u) | i_pFrameBuf[2u]);
+        memcpy(gs_stSlave.aReqBuf, &i_pFrameBuf[3u], 5u);
+        gs_stSlave.reqRxLen = 5u;
+        gs_stSlave.reqSN = 1u;
+        return TRUE;
+
+    case 0x20u:
+        TEST_CHECK((pci & 0x0Fu) == (gs_stSlave.reqSN & 0x0Fu));
+        copyLen = gs_stSlave.reqLen - gs_stSlave.reqRxLen;
+        copyLen = (copyLen > 6u) ? 6u : copyLen;
+        memcpy(&gs_stSlave.aReqBuf[gs_stSlave.reqRxLen], &i_pFrameBuf[2u], copyLen);
+        gs_stSlave.reqRxLen += copyLen;
+        gs_stSlave.reqSN++;
+
+        if (gs_stSlave.reqRxLen < gs_stSlave.reqLen)
+        {
+            return TRUE;
+        }
+
+        break;
+
+    default:
+        TEST_CHECK(FALSE);
+        return TRUE;
+    }
+
+    SlaveRxRequest();
+    return TRUE;
+}
+
+/* 0x3D slave response header hook, slave answers by the LIN driver RX interrupt */
+static boolean TestSlaveRespHeaderTx(void)
+{
+    tTestSlaveResp *pstResp = &gs_stSlave.astResp[gs_stSlave.respHead % TEST_SLAVE_RESP_NUM];
+    uint8 aFrame[LIN_GW_FRAME_LEN];
+    uint16 copyLen = 0u;
+
+    gs_stSlave.headers++;
+
+    if ((gs_stSlave.respHead == gs_stSlave.respTail) || (gs_timeMs < pstResp->readyTime))
+    {
+        /* Slave response is not ready, no answer */
+        return TRUE;
+    }
+
+    memset(aFrame, 0xFF, sizeof(aFrame));
+    aFrame[0u] = LIN_GW_SLAVE_NAD;
+
+    if (pstResp->dataLen <= 6u)
+    {
+        aFrame[1u] = (uint8)pstResp->dataLen;
+        memcpy(&aFrame[2u], pstResp->aData, pstResp->dataLen);
+        pstResp->txDataLen = pstResp->dataLen;
+    }
+    else if (0u == pstResp->txDataLen)
+    {
+        aFrame[1u] = 0x10u | (uint8)((pstResp->dataLen >> 8u) & 0x0Fu);
+        aFrame[2u] = (uint8)pstResp->dataLen;
+        memcpy(&aFrame[3u], pstResp->aData, 5u);
+        pstResp->txDataLen = 5u;
+    }
+    else
+    {
+        aFrame[1u] = 0x20u | (pstResp->sn & 0x0Fu);
+        copyLen = pstResp->dataLen - pstResp->txDataLen;
+        copyLen = (copyLen > 6u) ? 6u : copyLen;
+        memcpy(&aFrame[2u], &pstResp->aData[pstResp->txDataLen], copyLen);
+        pstResp->txDataLen += copyLen;
+        pstResp->sn++;
+    }
+
+    TEST_CHECK(TRUE == LINGW_DriverWriteSlaveResp(aFrame));
+
+    if (pstResp->txDataLen >= pstResp->dataLen)
+    {
+        gs_stSlave.respHead++;
+    }
+
+    return TRUE;
+}
+
+/* Run i_ms ticks of UDS_MAIN_Process */
+static void RunMs(uint32 i_ms)
+{
+    while (0u != i_ms)
+    {
+        gs_timeMs++;
+        UDS_SystemTickCtl();
+        LINGW_SystemTickCtl();
+        UDS_MainFun();
+        LINGW_MainFun();
+        i_ms--;
+    }
+}
+
+/* Tester TX a request, UDS app RX it in next tick */
+static void TesterRequest(const uint8 *i_pReq, const uint32 i_reqLen)
+{
+    TEST_CHECK(0u == gs_reqLen);
+    memcpy(gs_aReq, i_pReq, i_reqLen);
+    gs_reqLen = i_reqLen;
+}
+
+/* Tester RX next response, NULL_PTR if none */
+static const tTestResp *TesterNextResp(void)
+{
+    if (gs_respRead == gs_respCnt)
+    {
+        return NULL_PTR;
+    }
+
+    return &gs_astResp[gs_respRead++ % TEST_RESP_LOG_LEN];
+}
+
+/* Is next response i_pExp? */
+static boolean TesterIsNextResp(const uint8 *i_pExp, const uint32 i_expLen)
+{
+    const tTestResp *pstResp = TesterNextResp();
+
+    if ((NULL_PTR == pstResp) || (pstResp->dataLen != i_expLen) || (0 != memcmp(pstResp->aData, i_pExp, i_expLen)))
+    {
+        printf("  unexpected response at %u ms: %s", (unsigned int)gs_timeMs, (NULL_PTR == pstResp) ? "none" : "");
+
+        if (NULL_PTR != pstResp)
+        {
+            printf("%02X %02X %02X, len %u", pstResp->aData[0u], pstResp->aData[1u], pstResp->aData[2u],
+                   (unsigned int)pstResp->dataLen);
+        }
+
+        printf("\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* TransferData block of i_bsc */
+static void TesterTransferData(const uint8 i_bsc)
+{
+    uint8 aReq[TEST_BLOCK_LEN];
+
+    memset(aReq, i_bsc, sizeof(aReq));
+    aReq[0u] = 0x36u;
+    aReq[1u] = i_bsc;
+    TesterRequest(aReq, sizeof(aReq));
+}
+
+/* Start and stop routing by RoutineControl F000 */
+static void TestStartStopRouting(void)
+{
+    static const uint8 aStart[] = {0x31u, 0x01u, LIN_GW_ROUTINE_ID_H, LIN_GW_ROUTINE_ID_L, LIN_GW_SLAVE_NAD};
+    static const uint8 aStartResp[] = {0x71u, 0x01u, LIN_GW_ROUTINE_ID_H, LIN_GW_ROUTINE_ID_L};
+    static const uint8 aStop[] = {0x31u, 0x02u, LIN_GW_ROUTINE_ID_H, LIN_GW_ROUTINE_ID_L};
+    static const uint8 aStopResp[] = {0x71u, 0x02u, LIN_GW_ROUTINE_ID_H, LIN_GW_ROUTINE_ID_L};
+    static const uint8 aRead[] = {0x22u, 0xF1u, 0x5Au};
+    uint32 frames = 0u;
+
+    TesterRequest(aStart, sizeof(aStart));
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aStartResp, sizeof(aStartResp)));
+    TEST_CHECK(TRUE == LINGW_IsRouting());
+
+    /* Routine control F000 is for the gateway self while routing */
+    TesterRequest(aStart, sizeof(aStart));
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aStartResp, sizeof(aStartResp)));
+    TEST_CHECK(0u == gs_stSlave.masterFrames);
+
+    TesterRequest(aStop, sizeof(aStop));
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aStopResp, sizeof(aStopResp)));
+    TEST_CHECK(FALSE == LINGW_IsRouting());
+
+    /* Not routed after stop, the bootloader answers by itself */
+    frames = gs_stSlave.masterFrames;
+    TesterRequest(aRead, sizeof(aRead));
+    RunMs(100u);
+    TEST_CHECK(NULL_PTR != TesterNextResp());
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+    TEST_CHECK(frames == gs_stSlave.masterFrames);
+
+    TesterRequest(aStart, sizeof(aStart));
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aStartResp, sizeof(aStartResp)));
+}
+
+/* Slave response of LIN FF and CF is relayed to tester in one message */
+static void TestRelayedResponse(void)
+{
+    static const uint8 aRead[] = {0x22u, 0xF1u, 0x90u};
+    static const uint8 aReadResp[] = {0x62u, 0xF1u, 0x90u, 'L', 'I', 'N', 'S', 'L', 'A', 'V', 'E'};
+    uint32 frames = gs_stSlave.masterFrames;
+
+    gs_stSlave.respDelayMs = 20u;
+    TesterRequest(aRead, sizeof(aRead));
+    RunMs(1u);
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+    RunMs(200u);
+    TEST_CHECK(TesterIsNextResp(aReadResp, sizeof(aReadResp)));
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+    TEST_CHECK((frames + 1u) == gs_stSlave.masterFrames);
+}
+
+/* Gateway TX NRC 0x78 before tester P2, slave NRC 0x78 extends slave P2 */
+static void TestResponsePending(void)
+{
+    static const uint8 aRoutine[] = {0x31u, 0x01u, 0x12u, 0x34u};
+    static const uint8 aPending[] = {NEGTIVE_RESPONSE_ID, 0x31u, NRC_SERVICE_BUSY};
+    static const uint8 aRoutineResp[] = {0x71u, 0x01u};
+    const uint32 startTime = gs_timeMs;
+
+    /* Slave answers NRC 0x78, then the final response after slave P2 */
+    gs_stSlave.pendingCnt = 1u;
+    gs_stSlave.respDelayMs = g_stLINGatewayCfgInfo.xSlaveP2 + 500u;
+    TesterRequest(aRoutine, sizeof(aRoutine));
+    RunMs(g_stLINGatewayCfgInfo.xP2Server);
+    TEST_CHECK(TesterIsNextResp(aPending, sizeof(aPending)));
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+
+    RunMs(gs_stSlave.respDelayMs + 200u - g_stLINGatewayCfgInfo.xP2Server);
+    TEST_CHECK(TesterIsNextResp(aRoutineResp, sizeof(aRoutineResp)));
+    TEST_CHECK((gs_astResp[(gs_respRead - 1u) % TEST_RESP_LOG_LEN].timeMs - startTime) >= gs_stSlave.respDelayMs);
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+    gs_stSlave.respDelayMs = 20u;
+}
+
+/* Next CAN block is accepted while the previous one is on LIN */
+static void TestBlockOverlap(void)
+{
+    static const uint8 aResp1[] = {0x76u, 0x01u};
+    static const uint8 aResp2[] = {0x76u, 0x02u};
+    static const uint8 aResp3[] = {0x76u, 0x03u};
+    static const uint8 aPending[] = {NEGTIVE_RESPONSE_ID, 0x36u, NRC_SERVICE_BUSY};
+    const uint32 blockCnt = gs_stSlave.blockCnt;
+
+    TesterTransferData(1u);
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aResp1, sizeof(aResp1)));
+
+    /* Block 1 takes 4 frame slots on LIN, block 2 is buffered meanwhile */
+    TesterTransferData(2u);
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aResp2, sizeof(aResp2)));
+    TEST_CHECK(blockCnt == gs_stSlave.blockCnt);
+
+    /* Queue is full, block 3 waits with NRC 0x78 and is answered when block 1 is done on LIN */
+    TesterTransferData(3u);
+    RunMs(1u);
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+    RunMs(100u);
+    TEST_CHECK((blockCnt + 1u) <= gs_stSlave.blockCnt);
+    TEST_CHECK(TesterIsNextResp(aPending, sizeof(aPending)));
+    TEST_CHECK(TesterIsNextResp(aResp3, sizeof(aResp3)));
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+
+    RunMs(300u);
+    TEST_CHECK((blockCnt + 3u) == gs_stSlave.blockCnt);
+    TEST_CHECK(3u == gs_stSlave.lastBsc);
+    TEST_CHECK(0u == memcmp(&gs_stSlave.aReqBuf[2u], "\x03\x03\x03\x03", 4u));
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+}
+
+/* Slave rejects a buffered block, NRC is reported on next tester request */
+static void TestLateNRC(void)
+{
+    static const uint8 aResp4[] = {0x76u, 0x04u};
+    static const uint8 aResp5[] = {0x76u, 0x05u};
+    static const uint8 aLateNRC[] = {NEGTIVE_RESPONSE_ID, 0x36u, TEST_NRC_WRONG_BSC};
+    static const uint8 aRead[] = {0x22u, 0xF1u, 0x90u};
+    static const uint8 aReadResp[] = {0x62u, 0xF1u, 0x90u, 'L', 'I', 'N', 'S', 'L', 'A', 'V', 'E'};
+    uint32 blockCnt = 0u;
+
+    gs_stSlave.rejectBsc = 4u;
+    TesterTransferData(4u);
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aResp4, sizeof(aResp4)));
+
+    /* Block 5 depends on block 4, it is dropped with it */
+    TesterTransferData(5u);
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aResp5, sizeof(aResp5)));
+    RunMs(200u);
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+    TEST_CHECK(4u == gs_stSlave.lastBsc);
+    blockCnt = gs_stSlave.blockCnt;
+
+    TesterTransferData(6u);
+    RunMs(1u);
+    TEST_CHECK(TesterIsNextResp(aLateNRC, sizeof(aLateNRC)));
+    RunMs(200u);
+    TEST_CHECK(blockCnt == gs_stSlave.blockCnt);
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+
+    /* Late NRC is reported once */
+    gs_stSlave.rejectBsc = 0u;
+    TesterRequest(aRead, sizeof(aRead));
+    RunMs(200u);
+    TEST_CHECK(TesterIsNextResp(aReadResp, sizeof(aReadResp)));
+}
+
+/* Gateway keeps the slave in session by 3E 80 while tester is silent, slave doesn't answer it */
+static void TestKeepAlive(void)
+{
+    const uint32 keepAliveCnt = gs_stSlave.keepAliveCnt;
+
+    /* Within S3 of the last tester request */
+    RunMs(2u * g_stLINGatewayCfgInfo.xKeepAliveTime + 500u);
+    TEST_CHECK(TRUE == LINGW_IsRouting());
+    TEST_CHECK((keepAliveCnt + 2u) == gs_stSlave.keepAliveCnt);
+    TEST_CHECK(NULL_PTR == TesterNextResp());
+}
+
+int main(void)
+{
+    UDS_Init();
+    LINGW_Init();
+    SetCurrentSession(PROGRAM_SESSION);
+    SetSecurityLevel(SECURITY_LEVEL_1);
+    RestartS3Server();
+
+    TestStartStopRouting();
+    printf("Start/stop routing:       %lu errors\n", s_errors);
+    TestRelayedResponse();
+    printf("Relayed response:         %lu errors\n", s_errors);
+    TestResponsePending();
+    printf("NRC 0x78 while waiting:   %lu errors\n", s_errors);
+    TestBlockOverlap();
+    printf("Block overlap:            %lu errors\n", s_errors);
+    TestLateNRC();
+    printf("Late NRC:                 %lu errors\n", s_errors);
+    TestKeepAlive();
+    printf("3E 80 keep alive:         %lu errors, %u LIN frames, %u headers\n", s_errors,
+           (unsigned int)gs_stSlave.masterFrames, (unsigned int)gs_stSlave.headers);
+
+    return (0u == s_errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
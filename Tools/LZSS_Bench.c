@@ -0,0 +1,472 @@
+/*
+ * @ : LZSS_Bench.c
+ * @ : Host LZSS decoder test and effective download rate on CAN
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host test of UDS_PortingFiles/LZSS.c with a stream of Tools/LZSS_Compress.c, decoder
+**                throughput, and image bytes/s of raw and LZSS TransferData on a simulated CAN bus
+**
+**  Build (in repo root):
+**      gcc -O2 -no-pie -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_LZSS_DECOMPRESS \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o LZSS_Bench \
+**          Tools/LZSS_Bench.c UDS_PortingFiles/LZSS.c UDS_ProtocolStack/TP.c UDS_ProtocolStack/TP_cfg.c \
+**          UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  TX callbacks are saved as uint32 in the TX FIFOs, -no-pie keeps their addresses in 32 bits.
+**  Usage: LZSS_Bench image.bin image.lzss [CAN bit rate] [target decode ns per output byte]
+**  E.g.   LZSS_Compress app.bin app.lzss && LZSS_Bench app.bin app.lzss 500000 300
+**
+**  1. image.lzss is decoded 50 times with random input and output split, and compared with image.bin.
+**  2. Host decode throughput.
+**  3. The image is TX raw and as image.lzss in TransferData blocks of TEST_BLOCK_DATA_LEN. One CAN
+**     bus is simulated in virtual time with the real CAN TP (BS and STmin of g_stCANUdsNetLayerCfgInfo),
+**     a frame takes TEST_FRAME_BITS bit times. The tool is the UDS app: each block is decoded by
+**     LZSS_Decode and answered 0x76 after the target decode time of its output bytes.
+**     Flash programming overlaps reception and is not counted. Decoded image is compared with image.bin.
+*******************************************************/
+
+#include "TP.h"
+#include "can_tp_cfg.h"
+#include "uds_app_cfg.h"
+#include "flash_hal_Cfg.h"
+#include "LZSS.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_FRAME_BITS     (125u)      /* 8 bytes standard frame, 111 bits with IFS and typical stuff bits */
+#define TEST_STEP_US        (10u)       /* Virtual time step */
+#define TEST_SPLIT_SEEDS    (50u)       /* Random split decode patterns */
+
+/* As DOWLOAD_BLOCK_DATA_LEN of uds_app_cfg.c */
+#define TEST_BLOCK_DATA_LEN \
+    ((((UDS_MAX_MSG_LEN - 2u) < MAX_FLASH_DATA_LEN) ? (UDS_MAX_MSG_LEN - 2u) : MAX_FLASH_DATA_LEN) & (~7u))
+
+/* CAN bus, a frame in flight */
+typedef struct
+{
+    uint8 isBusy;           /* A frame is in flight */
+    uint8 isFromECU;        /* Frame is TX by ECU */
+    uint32 endTime;         /* Frame end time, us */
+    uint32 msgId;           /* Frame ID */
+    uint8 aData[8u];        /* Frame data */
+    uint8 dataLen;          /* Frame data len */
+} tTestBus;
+
+static uint32 gs_timeUs = 0u;       /* Virtual time */
+static uint32 gs_frameUs = 0u;      /* A frame time on the bus */
+static uint32 gs_decodeNs = 0u;     /* Target decode time per output byte */
+static tTestBus gs_stBus;
+
+/* UDS app of the tool */
+static uint8 gs_isCompressed = FALSE;
+static uint8 *gs_pOutImage = NULL_PTR;
+static uint32 gs_outLen = 0u;
+static uint32 gs_imageLen = 0u;
+static uint32 gs_respTime = 0u;     /* Response is TX at this time, 0 = no response */
+static uint8 gs_aResp[2u] = {0x76u, 0u};
+
+/* Stubs of S32K SDK and timer HAL */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return gs_timeUs / 1000u;
+}
+
+static uint8 *ReadFile(const char *i_pName, uint32 *o_pLen)
+{
+    FILE *pFile = fopen(i_pName, "rb");
+    uint8 *pBuf = NULL_PTR;
+    long len = 0;
+
+    if (NULL_PTR == pFile)
+    {
+        return NULL_PTR;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    len = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pBuf = (uint8 *)malloc((size_t)len + 1u);
+
+    if ((NULL_PTR != pBuf) && ((size_t)len != fread(pBuf, 1u, (size_t)len, pFile)))
+    {
+        free(pBuf);
+        pBuf = NULL_PTR;
+    }
+
+    fclose(pFile);
+    *o_pLen = (uint32)len;
+    return pBuf;
+}
+
+/* Decode with random input and output len, return TRUE if output is the image and all input is used */
+static boolean DecodeSplit(const uint8 *i_pStream, const uint32 i_streamLen, const uint8 *i_pImage,
+                           const uint32 i_imageLen, uint8 *o_pOut, const uint32 i_seed)
+{
+    uint32 inPos = 0u;
+    uint32 outPos = 0u;
+    uint32 inLen = 0u;
+    uint32 outLen = 0u;
+    uint32 usedLen = 0u;
+    uint32 decodedLen = 0u;
+
+    srand(i_seed);
+    LZSS_Init();
+
+    while (outPos < i_imageLen)
+    {
+        inLen = (0u != i_seed) ? ((uint32)rand() % 300u) : (i_streamLen - inPos);
+        inLen = (inLen > (i_streamLen - inPos)) ? (i_streamLen - inPos) : inLen;
+        outLen = (0u != i_seed) ? (((uint32)rand() % 200u) + 1u) : (i_imageLen - outPos);
+        outLen = (outLen > (i_imageLen - outPos)) ? (i_imageLen - outPos) : outLen;
+        decodedLen = LZSS_Decode(&i_pStream[inPos], inLen, &usedLen, &o_pOut[outPos], outLen);
+        inPos += usedLen;
+        outPos += decodedLen;
+
+        if ((0u == decodedLen) && (inPos >= i_streamLen))
+        {
+            break;
+        }
+    }
+
+    return ((outPos == i_imageLen) && (inPos == i_streamLen) && (0 == memcmp(o_pOut, i_pImage, i_imageLen))) ? TRUE : FALSE;
+}
+
+/* UDS app of the tool in a tick: decode a TransferData and answer it after decode time */
+static void UDSAppMainFun(void)
+{
+    uint8 aMsgBuf[TP_MAX_MSG_LEN];
+    uint32 msgId = 0u;
+    uint32 msgLen = 0u;
+    uint32 usedLen = 0u;
+    uint32 decodedLen = 0u;
+
+    if ((0u != gs_respTime) && (gs_timeUs >= gs_respTime))
+    {
+        gs_respTime = 0u;
+        (void)TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), NULL_PTR, sizeof(gs_aResp), gs_aResp);
+    }
+
+    if ((0u == gs_respTime) && (TRUE == TP_ReadAFrameDataFromTP(&msgId, &msgLen, aMsgBuf)) &&
+            (msgLen > 2u) && (0x36u == aMsgBuf[0u]))
+    {
+        if (TRUE == gs_isCompressed)
+        {
+            decodedLen = LZSS_Decode(&aMsgBuf[2u], msgLen - 2u, &usedLen, &gs_pOutImage[gs_outLen], gs_imageLen - gs_outLen);
+        }
+        else
+        {
+            decodedLen = ((msgLen - 2u) > (gs_imageLen - gs_outLen)) ? (gs_imageLen - gs_outLen) : (msgLen - 2u);
+            memcpy(&gs_pOutImage[gs_outLen], &aMsgBuf[2u], decodedLen);
+        }
+
+        gs_outLen += decodedLen;
+        gs_aResp[1u] = aMsgBuf[1u];
+        gs_respTime = gs_timeUs + ((TRUE == gs_isCompressed) ? (uint32)(((uint64_t)decodedLen * gs_decodeNs) / 1000u) : 0u);
+    }
+}
+
+/* TX ECU frame first, it wins arbitration. Return TRUE if tester frame is on the bus. */
+static boolean StartBusFrame(const uint32 i_msgId, const uint8 *i_pData)
+{
+    tTPTxMsgHeader stTxMsgHeader;
+
+    if (TRUE == gs_stBus.isBusy)
+    {
+        return FALSE;
+    }
+
+    if (TRUE == CANTP_DriverPeekDataFromCANTP(8u, gs_stBus.aData, &stTxMsgHeader))
+    {
+        CANTP_DriverReleaseDataFromCANTP();
+        gs_stBus.isFromECU = TRUE;
+    }
+    else if (NULL_PTR != i_pData)
+    {
+        memcpy(gs_stBus.aData, i_pData, 8u);
+        stTxMsgHeader.TxMsgID = i_msgId;
+        stTxMsgHeader.TxMsgLength = 8u;
+        gs_stBus.isFromECU = FALSE;
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    gs_stBus.isBusy = TRUE;
+    gs_stBus.msgId = stTxMsgHeader.TxMsgID;
+    gs_stBus.dataLen = (uint8)stTxMsgHeader.TxMsgLength;
+    gs_stBus.endTime = gs_timeUs + gs_frameUs;
+    return (FALSE == gs_stBus.isFromECU) ? TRUE : FALSE;
+}
+
+/* Step virtual time, return frame RX by tester or NULL */
+static const tTestBus *StepTime(void)
+{
+    const tTestBus *pstRxFrame = NULL_PTR;
+
+    gs_timeUs += TEST_STEP_US;
+
+    if ((TRUE == gs_stBus.isBusy) && (gs_timeUs >= gs_stBus.endTime))
+    {
+        gs_stBus.isBusy = FALSE;
+
+        if (TRUE == gs_stBus.isFromECU)
+        {
+            pstRxFrame = &gs_stBus;
+            CANTP_DoTxMsgSuccessfulCallBack();
+        }
+        else
+        {
+            (void)CANTP_DriverWriteDataInCANTP(gs_stBus.msgId, gs_stBus.dataLen, gs_stBus.aData);
+        }
+    }
+
+    if (0u == (gs_timeUs % 1000u))
+    {
+        TP_SystemTickCtl();
+        TP_MainFun();
+        UDSAppMainFun();
+    }
+
+    (void)StartBusFrame(0u, NULL_PTR);
+    return pstRxFrame;
+}
+
+/* TX a tester frame, return FALSE if ECU TX a frame to tester before it */
+static boolean TesterTxFrame(const uint8 *i_pData)
+{
+    while (FALSE == StartBusFrame(RX_PHY_ADDR_ID, i_pData))
+    {
+        if (NULL_PTR != StepTime())
+        {
+            return FALSE;
+        }
+    }
+
+    /* Wait its end, STmin is from the end of a CF */
+    while (TRUE == gs_stBus.isBusy)
+    {
+        (void)StepTime();
+    }
+
+    return TRUE;
+}
+
+/* Wait a frame of ECU, return NULL after 1 s */
+static const tTestBus *TesterRxFrame(void)
+{
+    const tTestBus *pstRxFrame = NULL_PTR;
+    const uint32 startTime = gs_timeUs;
+
+    while ((NULL_PTR == (pstRxFrame = StepTime())) && ((gs_timeUs - startTime) < 1000000u))
+    {
+    }
+
+    return pstRxFrame;
+}
+
+/* Tester TX a request by ISO 15765-2, len > 7 */
+static boolean TesterTxRequest(const uint8 *i_pReq, const uint32 i_len)
+{
+    uint8 aFrame[8u];
+    uint32 sent = 6u;
+    uint32 dataLen = 0u;
+    uint32 blockSize = 0u;
+    uint32 cfInBlock = 0u;
+    uint32 stMinUs = 0u;
+    uint32 nextTime = 0u;
+    uint8 sn = 1u;
+    const tTestBus *pstRxFrame = NULL_PTR;
+
+    aFrame[0u] = (uint8)(0x10u | (i_len >> 8u));
+    aFrame[1u] = (uint8)i_len;
+    memcpy(&aFrame[2u], i_pReq, 6u);
+
+    if (FALSE == TesterTxFrame(aFrame))
+    {
+        return FALSE;
+    }
+
+    while (sent < i_len)
+    {
+        if ((0u == cfInBlock) || ((0u != blockSize) && (cfInBlock >= blockSize)))
+        {
+            pstRxFrame = TesterRxFrame();
+
+            if ((NULL_PTR == pstRxFrame) || (0x30u != pstRxFrame->aData[0u]))
+            {
+                return FALSE;
+            }
+
+            blockSize = pstRxFrame->aData[1u];
+            stMinUs = (pstRxFrame->aData[2u] <= 0x7Fu) ? (uint32)pstRxFrame->aData[2u] * 1000u : 100u;
+            cfInBlock = 0u;
+            nextTime = gs_timeUs;
+        }
+
+        while (gs_timeUs < nextTime)
+        {
+            if (NULL_PTR != StepTime())
+            {
+                return FALSE;
+            }
+        }
+
+        dataLen = ((i_len - sent) > 7u) ? 7u : (i_len - sent);
+        memset(aFrame, 0x55u, sizeof(aFrame));
+        aFrame[0u] = (uint8)(0x20u | (sn & 0x0Fu));
+        memcpy(&aFrame[1u], &i_pReq[sent], dataLen);
+
+        if (FALSE == TesterTxFrame(aFrame))
+        {
+            return FALSE;
+        }
+
+        nextTime = gs_timeUs + stMinUs;
+        sent += dataLen;
+        sn++;
+        cfInBlock++;
+    }
+
+    return TRUE;
+}
+
+/* TX stream in TransferData blocks, return used time us or 0 */
+static uint32 RunDownload(const uint8 *i_pStream, const uint32 i_streamLen, const uint8 i_isCompressed)
+{
+    static uint8 aReq[2u + TEST_BLOCK_DATA_LEN];
+    const uint32 startTime = gs_timeUs;
+    const tTestBus *pstRxFrame = NULL_PTR;
+    uint32 offset = 0u;
+    uint32 blockLen = 0u;
+    uint8 counter = 1u;
+
+    gs_isCompressed = i_isCompressed;
+    gs_outLen = 0u;
+    gs_respTime = 0u;
+    LZSS_Init();
+
+    for (offset = 0u; offset < i_streamLen; offset += blockLen)
+    {
+        blockLen = ((i_streamLen - offset) > TEST_BLOCK_DATA_LEN) ? TEST_BLOCK_DATA_LEN : (i_streamLen - offset);
+        /* A short last block is padded to a multi frame request, the decoder stops at image len */
+        aReq[0u] = 0x36u;
+        aReq[1u] = counter;
+        memset(&aReq[2u], 0u, sizeof(aReq) - 2u);
+        memcpy(&aReq[2u], &i_pStream[offset], blockLen);
+
+        if (FALSE == TesterTxRequest(aReq, (blockLen < 6u) ? 8u : (2u + blockLen)))
+        {
+            printf("TransferData %u: TX failed\n", (unsigned int)counter);
+            return 0u;
+        }
+
+        pstRxFrame = TesterRxFrame();
+
+        if ((NULL_PTR == pstRxFrame) || (0x02u != pstRxFrame->aData[0u]) ||
+                (0x76u != pstRxFrame->aData[1u]) || (counter != pstRxFrame->aData[2u]))
+        {
+            printf("TransferData %u: no positive response\n", (unsigned int)counter);
+            return 0u;
+        }
+
+        counter++;
+    }
+
+    return gs_timeUs - startTime;
+}
+
+int main(int argc, char **argv)
+{
+    uint8 *pImage = NULL_PTR;
+    uint8 *pStream = NULL_PTR;
+    uint32 imageLen = 0u;
+    uint32 streamLen = 0u;
+    uint32 bitRate = 0u;
+    uint32 seed = 0u;
+    uint32 loop = 0u;
+    uint32 usedLen = 0u;
+    uint32 rawTime = 0u;
+    uint32 lzssTime = 0u;
+    unsigned long errors = 0u;
+    clock_t startClock = 0;
+    double decodeTime = 0.0;
+
+    if (argc < 3)
+    {
+        printf("Usage: LZSS_Bench image.bin image.lzss [CAN bit rate] [target decode ns per output byte]\n");
+        return 1;
+    }
+
+    pImage = ReadFile(argv[1], &imageLen);
+    pStream = ReadFile(argv[2], &streamLen);
+    bitRate = (uint32)((argc > 3) ? atol(argv[3]) : 500000);
+    gs_decodeNs = (uint32)((argc > 4) ? atol(argv[4]) : 300);
+
+    if ((NULL_PTR == pImage) || (NULL_PTR == pStream) || (0u == imageLen) || (0u == streamLen) || (0u == bitRate))
+    {
+        printf("Read %s or %s failed!\n", argv[1], argv[2]);
+        return 1;
+    }
+
+    gs_pOutImage = (uint8 *)malloc(imageLen);
+    gs_imageLen = imageLen;
+
+    for (seed = 0u; seed < TEST_SPLIT_SEEDS; seed++)
+    {
+        if (FALSE == DecodeSplit(pStream, streamLen, pImage, imageLen, gs_pOutImage, seed))
+        {
+            printf("Split decode %u: output is not the image\n", (unsigned int)seed);
+            errors++;
+        }
+    }
+
+    startClock = clock();
+
+    for (loop = 0u; loop < 20u; loop++)
+    {
+        LZSS_Init();
+        (void)LZSS_Decode(pStream, streamLen, &usedLen, gs_pOutImage, imageLen);
+    }
+
+    decodeTime = (double)(clock() - startClock) / CLOCKS_PER_SEC / 20.0;
+    printf("%s: %u B as %u B (%.0f%%), %u split decodes OK, host decode %.1f MB/s\n",
+           argv[1], (unsigned int)imageLen, (unsigned int)streamLen, 100.0 * streamLen / imageLen,
+           (unsigned int)(TEST_SPLIT_SEEDS - errors), (double)imageLen / decodeTime / 1e6);
+
+    gs_frameUs = (TEST_FRAME_BITS * 1000000u + bitRate - 1u) / bitRate;
+    gs_frameUs = ((gs_frameUs + TEST_STEP_US - 1u) / TEST_STEP_US) * TEST_STEP_US;
+    TP_Init();
+    printf("CAN %u bit/s, %u us per frame, CAN TP BS %u STmin %u ms, %u B blocks, target decode %u ns/B\n",
+           (unsigned int)bitRate, (unsigned int)gs_frameUs, (unsigned int)g_stCANUdsNetLayerCfgInfo.xBlockSize,
+           (unsigned int)g_stCANUdsNetLayerCfgInfo.xSTmin, (unsigned int)TEST_BLOCK_DATA_LEN, (unsigned int)gs_decodeNs);
+
+    rawTime = RunDownload(pImage, imageLen, FALSE);
+    errors += ((0u == rawTime) || (gs_outLen != imageLen) || (0 != memcmp(gs_pOutImage, pImage, imageLen))) ? 1u : 0u;
+    memset(gs_pOutImage, 0, imageLen);
+    lzssTime = RunDownload(pStream, streamLen, TRUE);
+    errors += ((0u == lzssTime) || (gs_outLen != imageLen) || (0 != memcmp(gs_pOutImage, pImage, imageLen))) ? 1u : 0u;
+
+    printf("raw:  %8.2f s, %6.1f KB/s of image\n", (double)rawTime / 1e6,
+           (0u != rawTime) ? (double)imageLen / 1024.0 * 1e6 / (double)rawTime : 0.0);
+    printf("LZSS: %8.2f s, %6.1f KB/s of image\n", (double)lzssTime / 1e6,
+           (0u != lzssTime) ? (double)imageLen / 1024.0 * 1e6 / (double)lzssTime : 0.0);
+    printf("%lu errors\n", errors);
+    return (0u == errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,244 @@
+/*
+ * @ : LZSS_Compress.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host LZSS image compressor for RequestDownload compressionMethod 1
+**
+**  Build: gcc -O2 -o LZSS_Compress LZSS_Compress.c
+**  Usage: LZSS_Compress [-w window_bits] [-l lookahead_bits] image.bin image.lzss
+**  window_bits and lookahead_bits should be same as LZSS_WINDOW_BITS and LZSS_LOOKAHEAD_BITS in user_config.h.
+**  memorySize of RequestDownload is the image len, TransferData blocks carry image.lzss.
+**  Output is decoded again and compared with the image before it is written.
+*******************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LZSS_MIN_MATCH_LEN  (2u)
+
+typedef struct
+{
+    unsigned char *pBuf;
+    unsigned long len;
+    unsigned long bitLen;
+} tBitWriter;
+
+static unsigned int gs_windowBits = 10u;
+static unsigned int gs_lookaheadBits = 4u;
+
+static void PutBits(tBitWriter *m_pstWriter, unsigned long i_bits, unsigned int i_bitNum)
+{
+    while (0u != i_bitNum)
+    {
+        i_bitNum--;
+
+        if (0u == (m_pstWriter->bitLen & 7u))
+        {
+            m_pstWriter->pBuf[m_pstWriter->len++] = 0u;
+        }
+
+        if (0u != ((i_bits >> i_bitNum) & 1u))
+        {
+            m_pstWriter->pBuf[m_pstWriter->len - 1u] |= (unsigned char)(0x80u >> (m_pstWriter->bitLen & 7u));
+        }
+
+        m_pstWriter->bitLen++;
+    }
+}
+
+/* Window is 0 before the image, same as decoder */
+static unsigned char GetByte(const unsigned char *i_pImage, long i_pos)
+{
+    return (i_pos < 0) ? 0u : i_pImage[i_pos];
+}
+
+/* Greedy longest match, back reference may overlap the bytes being coded */
+static unsigned long Compress(const unsigned char *i_pImage, unsigned long i_len, unsigned char *o_pOut)
+{
+    const unsigned long windowSize = 1uL << gs_windowBits;
+    const unsigned long maxMatchLen = (1uL << gs_lookaheadBits) + LZSS_MIN_MATCH_LEN - 1u;
+    tBitWriter stWriter = {o_pOut, 0u, 0u};
+    unsigned long pos = 0u;
+
+    while (pos < i_len)
+    {
+        unsigned long bestLen = 0u;
+        unsigned long bestDist = 0u;
+        unsigned long maxLen = ((i_len - pos) < maxMatchLen) ? (i_len - pos) : maxMatchLen;
+        unsigned long dist = 0u;
+
+        for (dist = 1u; (dist <= windowSize) && (bestLen < maxLen); dist++)
+        {
+            unsigned long len = 0u;
+
+            while ((len < maxLen) && (GetByte(i_pImage, (long)(pos + len) - (long)dist) == i_pImage[pos + len]))
+            {
+                len++;
+            }
+
+            if (len > bestLen)
+            {
+                bestLen = len;
+                bestDist = dist;
+            }
+        }
+
+        if (bestLen >= LZSS_MIN_MATCH_LEN)
+        {
+            PutBits(&stWriter, 0u, 1u);
+            PutBits(&stWriter, bestDist - 1u, gs_windowBits);
+            PutBits(&stWriter, bestLen - LZSS_MIN_MATCH_LEN, gs_lookaheadBits);
+            pos += bestLen;
+        }
+        else
+        {
+            PutBits(&stWriter, 1u, 1u);
+            PutBits(&stWriter, i_pImage[pos], 8u);
+            pos++;
+        }
+    }
+
+    return stWriter.len;
+}
+
+static unsigned long GetBits(const unsigned char *i_pIn, unsigned long *m_pBitPos, unsigned int i_bitNum)
+{
+    unsigned long bits = 0u;
+
+    while (0u != i_bitNum)
+    {
+        bits = (bits << 1u) | ((i_pIn[*m_pBitPos >> 3u] >> (7u - (*m_pBitPos & 7u))) & 1u);
+        (*m_pBitPos)++;
+        i_bitNum--;
+    }
+
+    return bits;
+}
+
+/* Decode whole stream, return 0 if it is not same as image */
+static int Verify(const unsigned char *i_pIn, unsigned long i_inLen, const unsigned char *i_pImage, unsigned long i_len)
+{
+    const unsigned long windowSize = 1uL << gs_windowBits;
+    unsigned char *pWindow = calloc(windowSize, 1u);
+    unsigned long head = 0u;
+    unsigned long bitPos = 0u;
+    unsigned long pos = 0u;
+    int isSame = 1;
+
+    while ((pos < i_len) && (0 != isSame) && (bitPos < (i_inLen * 8u)))
+    {
+        unsigned long copyLen = 1u;
+        unsigned long index = 0u;
+        int isLiteral = (int)GetBits(i_pIn, &bitPos, 1u);
+
+        if (0 != isLiteral)
+        {
+            pWindow[head] = (unsigned char)GetBits(i_pIn, &bitPos, 8u);
+        }
+        else
+        {
+            index = GetBits(i_pIn, &bitPos, gs_windowBits);
+            copyLen = GetBits(i_pIn, &bitPos, gs_lookaheadBits) + LZSS_MIN_MATCH_LEN;
+        }
+
+        while ((0u != copyLen) && (0 != isSame))
+        {
+            if (0 == isLiteral)
+            {
+                pWindow[head] = pWindow[(head - index - 1u) & (windowSize - 1u)];
+            }
+
+            isSame = (pos < i_len) && (pWindow[head] == i_pImage[pos]);
+            head = (head + 1u) & (windowSize - 1u);
+            pos++;
+            copyLen--;
+        }
+    }
+
+    free(pWindow);
+    return isSame && (pos == i_len);
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *pFile = NULL;
+    unsigned char *pImage = NULL;
+    unsigned char *pOut = NULL;
+    unsigned long len = 0u;
+    unsigned long outLen = 0u;
+    int argIndex = 1;
+
+    while ((argIndex + 1 < argc) && ('-' == argv[argIndex][0]))
+    {
+        if (0 == strcmp(argv[argIndex], "-w"))
+        {
+            gs_windowBits = (unsigned int)atoi(argv[argIndex + 1]);
+        }
+        else if (0 == strcmp(argv[argIndex], "-l"))
+        {
+            gs_lookaheadBits = (unsigned int)atoi(argv[argIndex + 1]);
+        }
+
+        argIndex += 2;
+    }
+
+    if ((argIndex + 2 != argc) || (gs_windowBits < 4u) || (gs_windowBits > 15u) ||
+            (gs_lookaheadBits < 2u) || (gs_lookaheadBits >= gs_windowBits))
+    {
+        printf("Usage: %s [-w window_bits(4~15)] [-l lookahead_bits(2~window_bits-1)] image.bin image.lzss\n", argv[0]);
+        return 1;
+    }
+
+    pFile = fopen(argv[argIndex], "rb");
+
+    if (NULL == pFile)
+    {
+        printf("Open %s failed\n", argv[argIndex]);
+        return 1;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    len = (unsigned long)ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pImage = malloc(len + 1u);
+    /* Worst case every byte is a literal, 9 bits */
+    pOut = malloc((len * 9u) / 8u + 2u);
+
+    if ((NULL == pImage) || (NULL == pOut) || (len != fread(pImage, 1u, len, pFile)))
+    {
+        printf("Read %s failed\n", argv[argIndex]);
+        return 1;
+    }
+
+    fclose(pFile);
+    outLen = Compress(pImage, len, pOut);
+
+    if (0 == Verify(pOut, outLen, pImage, len))
+    {
+        printf("Verify compressed data failed\n");
+        return 1;
+    }
+
+    pFile = fopen(argv[argIndex + 1], "wb");
+
+    if ((NULL == pFile) || (outLen != fwrite(pOut, 1u, outLen, pFile)))
+    {
+        printf("Write %s failed\n", argv[argIndex + 1]);
+        return 1;
+    }
+
+    fclose(pFile);
+    printf("memorySize 0x%08lX, compressed %lu bytes (%.1f%%), window bits %u, lookahead bits %u\n",
+           len, outLen, (len != 0u) ? (100.0 * outLen / len) : 0.0, gs_windowBits, gs_lookaheadBits);
+    free(pImage);
+    free(pOut);
+    return 0;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
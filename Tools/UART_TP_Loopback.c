@@ -0,0 +1,391 @@
+/*
+ * @ : UART_TP_Loopback.c
+ * @ : Host UART TP pty loopback test
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host throughput and recovery test of UART TP over a pseudo terminal
+**
+**  Build (in repo root):
+**      gcc -O2 -D_GNU_SOURCE -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_UART_TP \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o UART_TP_Loopback \
+**          Tools/UART_TP_Loopback.c UDS_ProtocolStack/TP.c UDS_ProtocolStack/TP_cfg.c \
+**          UDS_ProtocolStack/uart_tp.c UDS_ProtocolStack/uart_tp_cfg.c \
+**          UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  Usage: UART_TP_Loopback [messages] [corrupt every Nth request CRC] [drop every Nth response ACK]
+**  E.g.   UART_TP_Loopback 2000 && UART_TP_Loopback 2000 7 5
+**
+**  Parent process is the ECU: UART TP on the pty master, bytes are written by
+**  UARTTP_DriverWriteDataInUARTTP and frames are read by UARTTP_DriverReadDataFromUARTTP as
+**  the LPUART DMA driver does. Each 150 bytes request 0x36 <index> is answered 0x76 <index>.
+**  Child process is the tester on the pty slave with its own frame coder and a window of
+**  UART_TP_TX_WINDOW frames. Errors are injected by the tester. ECU checks each request is
+**  received once and in order, tester checks each response is received once and in order.
+*******************************************************/
+
+/* Before termios.h, its CR0 macro breaks S32K144.h */
+#include "TP.h"
+#include "uart_tp_cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#define TEST_REQ_LEN        (150u)      /* Request len, as TransferData of a CAN FD block */
+#define TEST_TX_TIMEOUT_US  (50000)     /* Tester TX window again if no ACK */
+#define TEST_MAX_TIME_US    (60000000)  /* Test fail after it */
+
+/* Stubs of S32K SDK and timer HAL, CAN TP is enabled by user_config.h beside UART TP */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return 0u;
+}
+
+static long long GetTimeUs(void)
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (long long)stTime.tv_sec * 1000000LL + stTime.tv_nsec / 1000;
+}
+
+static void WriteAll(const int fd, const uint8 *pBuf, uint32 len)
+{
+    while (0u != len)
+    {
+        const ssize_t n = write(fd, pBuf, len);
+
+        if (n > 0)
+        {
+            pBuf += n;
+            len -= (uint32)n;
+        }
+        else
+        {
+            usleep(50);
+        }
+    }
+}
+
+/* CRC-16/CCITT, poly 0x1021, init 0xFFFF, bit by bit to check the table of UART TP */
+static uint16 CalcCRC16(const uint8 *pBuf, const uint32 len)
+{
+    uint16 crc = 0xFFFFu;
+    uint32 index = 0u;
+    uint32 bit = 0u;
+
+    for (index = 0u; index < len; index++)
+    {
+        crc ^= (uint16)(pBuf[index] << 8u);
+
+        for (bit = 0u; bit < 8u; bit++)
+        {
+            crc = (0u != (crc & 0x8000u)) ? (uint16)((crc << 1u) ^ 0x1021u) : (uint16)(crc << 1u);
+        }
+    }
+
+    return crc;
+}
+
+static uint32 BuildFrame(const uint8 type, const uint8 sn, const uint8 *pData, const uint32 dataLen, uint8 *pFrame)
+{
+    uint16 crc = 0u;
+    pFrame[0u] = UART_TP_SOF;
+    pFrame[1u] = type;
+    pFrame[2u] = sn;
+    pFrame[3u] = (uint8)dataLen;
+    memcpy(&pFrame[UART_TP_FRAME_HEAD_LEN], pData, dataLen);
+    crc = CalcCRC16(&pFrame[1u], UART_TP_FRAME_HEAD_LEN - 1u + dataLen);
+    pFrame[UART_TP_FRAME_HEAD_LEN + dataLen] = (uint8)(crc >> 8u);
+    pFrame[UART_TP_FRAME_HEAD_LEN + dataLen + 1u] = (uint8)crc;
+    return UART_TP_FRAME_HEAD_LEN + dataLen + UART_TP_FRAME_CRC_LEN;
+}
+
+/* Get a valid frame from RX bytes, return frame len or 0 */
+static uint32 ParseFrame(uint8 *pRxBuf, uint32 *pRxLen, uint8 *pFrame)
+{
+    uint32 frameLen = 0u;
+
+    while (0u != *pRxLen)
+    {
+        if ((UART_TP_SOF != pRxBuf[0u]) ||
+                ((*pRxLen >= UART_TP_FRAME_HEAD_LEN) &&
+                 ((UART_TP_FRAME_HEAD_LEN + pRxBuf[3u] + UART_TP_FRAME_CRC_LEN) <= *pRxLen) &&
+                 (CalcCRC16(&pRxBuf[1u], UART_TP_FRAME_HEAD_LEN - 1u + pRxBuf[3u]) !=
+                  (uint16)((pRxBuf[UART_TP_FRAME_HEAD_LEN + pRxBuf[3u]] << 8u) |
+                           pRxBuf[UART_TP_FRAME_HEAD_LEN + pRxBuf[3u] + 1u]))))
+        {
+            /* Not SOF or bad CRC, search next SOF */
+            (*pRxLen)--;
+            memmove(pRxBuf, &pRxBuf[1u], *pRxLen);
+            continue;
+        }
+
+        if ((*pRxLen < UART_TP_FRAME_HEAD_LEN) ||
+                ((UART_TP_FRAME_HEAD_LEN + pRxBuf[3u] + UART_TP_FRAME_CRC_LEN) > *pRxLen))
+        {
+            return 0u;
+        }
+
+        frameLen = UART_TP_FRAME_HEAD_LEN + pRxBuf[3u] + UART_TP_FRAME_CRC_LEN;
+        memcpy(pFrame, pRxBuf, frameLen);
+        *pRxLen -= frameLen;
+        memmove(pRxBuf, &pRxBuf[frameLen], *pRxLen);
+        return frameLen;
+    }
+
+    return 0u;
+}
+
+/* Tester, TX requests in a window and ACK responses. Return error count. */
+static unsigned long RunTester(const int fd, const uint32 msgNum, const uint32 corruptEvery, const uint32 dropAckEvery)
+{
+    static uint8 aRxBuf[8192u];
+    uint32 rxLen = 0u;
+    uint8 aFrame[UART_TP_MAX_FRAME_LEN];
+    uint8 aReq[TEST_REQ_LEN] = {0u};
+    uint32 base = 0u;               /* First request without ACK */
+    uint32 next = 0u;               /* Next request to TX */
+    uint32 responses = 0u;
+    uint32 txCnt = 0u;
+    uint32 rxAckCnt = 0u;
+    int lastRespSN = -1;
+    boolean isSync = TRUE;
+    unsigned long errors = 0u;
+    const long long startTime = GetTimeUs();
+    long long lastTxTime = startTime;
+    long long usedTime = 0;
+    uint32 frameLen = 0u;
+    ssize_t n = 0;
+
+    while ((responses < msgNum) && ((GetTimeUs() - startTime) < TEST_MAX_TIME_US))
+    {
+        while ((next < msgNum) && ((next - base) < UART_TP_TX_WINDOW))
+        {
+            aReq[0u] = 0x36u;
+            aReq[1u] = (uint8)next;
+            frameLen = BuildFrame((uint8)(UART_RX_PHY_ADDR_ID | (isSync ? UART_TP_SYNC_FLAG : 0u)),
+                                  (uint8)next, aReq, sizeof(aReq), aFrame);
+            txCnt++;
+
+            if ((0u != corruptEvery) && (0u == (txCnt % corruptEvery)))
+            {
+                aFrame[frameLen - 1u] ^= 0x01u;
+            }
+
+            WriteAll(fd, aFrame, frameLen);
+            next++;
+            lastTxTime = GetTimeUs();
+        }
+
+        n = read(fd, &aRxBuf[rxLen], sizeof(aRxBuf) - rxLen);
+
+        if (n > 0)
+        {
+            rxLen += (uint32)n;
+        }
+        else
+        {
+            usleep(20);
+        }
+
+        while (0u != (frameLen = ParseFrame(aRxBuf, &rxLen, aFrame)))
+        {
+            if (UART_TP_ACK_TYPE == aFrame[1u])
+            {
+                /* ACK SN is the last request received in order */
+                if ((base < next) && (((uint8)(aFrame[2u] - (uint8)base)) >= 0x80u))
+                {
+                    /* ECU received a request after a lost one, TX the window again */
+                    next = base;
+                }
+
+                while ((base < next) && (((uint8)(aFrame[2u] - (uint8)base)) < 0x80u))
+                {
+                    base++;
+                    isSync = FALSE;
+                }
+
+                lastTxTime = GetTimeUs();
+                continue;
+            }
+
+            if ((UART_TX_RESP_ADDR_ID != (aFrame[1u] & UART_TP_TYPE_MASK)) || (2u != aFrame[3u]))
+            {
+                errors++;
+                continue;
+            }
+
+            /* A response TX again because its ACK is dropped has the same SN */
+            if ((int)aFrame[2u] != lastRespSN)
+            {
+                lastRespSN = aFrame[2u];
+
+                if ((0x76u != aFrame[UART_TP_FRAME_HEAD_LEN]) ||
+                        ((uint8)responses != aFrame[UART_TP_FRAME_HEAD_LEN + 1u]))
+                {
+                    errors++;
+                }
+
+                responses++;
+            }
+
+            rxAckCnt++;
+
+            if ((0u == dropAckEvery) || (0u != (rxAckCnt % dropAckEvery)))
+            {
+                frameLen = BuildFrame(UART_TP_ACK_TYPE, aFrame[2u], NULL, 0u, aFrame);
+                WriteAll(fd, aFrame, frameLen);
+            }
+        }
+
+        /* No ACK, TX the window again */
+        if ((next > base) && ((GetTimeUs() - lastTxTime) > TEST_TX_TIMEOUT_US))
+        {
+            next = base;
+        }
+    }
+
+    usedTime = GetTimeUs() - startTime;
+    errors += (responses != msgNum) ? 1u : 0u;
+    printf("tester: %u requests of %u B, %u responses, %u frames TX, %.3f s, %.0f msg/s, %.0f B/s\n",
+           msgNum, TEST_REQ_LEN, responses, txCnt, (double)usedTime / 1e6,
+           (double)msgNum * 1e6 / (double)usedTime, (double)msgNum * TEST_REQ_LEN * 1e6 / (double)usedTime);
+    return errors;
+}
+
+/* ECU, UART TP echo a response for each request. Run until killed. */
+static void RunECU(const int fd)
+{
+    static uint8 aRxBuf[4096u];
+    uint32 rxLen = 0u;
+    uint32 written = 0u;
+    uint8 aMsgBuf[TP_MAX_MSG_LEN];
+    uint8 aFrame[UART_TP_MAX_FRAME_LEN];
+    uint8 aResp[2u] = {0x76u, 0u};
+    uint32 msgId = 0u;
+    uint32 msgLen = 0u;
+    uint32 expectIndex = 0u;
+    tTPTxMsgHeader stTxHeader;
+    long long tickTime = GetTimeUs();
+    long long nowTime = 0;
+    ssize_t n = 0;
+
+    TP_Init();
+
+    for (;;)
+    {
+        if (0u == rxLen)
+        {
+            n = read(fd, aRxBuf, sizeof(aRxBuf));
+            rxLen = (n > 0) ? (uint32)n : 0u;
+        }
+
+        if (0u != rxLen)
+        {
+            written = UARTTP_DriverWriteDataInUARTTP(rxLen, aRxBuf);
+            rxLen -= written;
+            memmove(aRxBuf, &aRxBuf[written], rxLen);
+        }
+
+        TP_MainFun();
+
+        while (TRUE == TP_ReadAFrameDataFromTP(&msgId, &msgLen, aMsgBuf))
+        {
+            if ((TEST_REQ_LEN != msgLen) || (0x36u != aMsgBuf[0u]) || ((uint8)expectIndex != aMsgBuf[1u]))
+            {
+                printf("ECU: request %u is not received once and in order\n", expectIndex);
+            }
+
+            expectIndex++;
+            aResp[1u] = aMsgBuf[1u];
+            (void)TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), NULL_PTR, sizeof(aResp), aResp);
+        }
+
+        TP_MainFun();
+
+        while (TRUE == UARTTP_DriverReadDataFromUARTTP(sizeof(aFrame), aFrame, &stTxHeader))
+        {
+            WriteAll(fd, aFrame, stTxHeader.TxMsgLength);
+        }
+
+        nowTime = GetTimeUs();
+
+        while ((nowTime - tickTime) >= 1000)
+        {
+            TP_SystemTickCtl();
+            tickTime += 1000;
+        }
+
+        usleep(20);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const uint32 msgNum = (uint32)((argc > 1) ? atoi(argv[1]) : 2000);
+    const uint32 corruptEvery = (uint32)((argc > 2) ? atoi(argv[2]) : 0);
+    const uint32 dropAckEvery = (uint32)((argc > 3) ? atoi(argv[3]) : 0);
+    struct termios stTio;
+    int masterFd = -1;
+    int slaveFd = -1;
+    pid_t ecuPid = 0;
+    unsigned long errors = 0u;
+
+    if ((0u == msgNum) || (1u == corruptEvery) || (1u == dropAckEvery))
+    {
+        printf("Usage: UART_TP_Loopback [messages] [corrupt every Nth request CRC, >1] [drop every Nth ACK, >1]\n");
+        return 1;
+    }
+
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((masterFd < 0) || (0 != grantpt(masterFd)) || (0 != unlockpt(masterFd)) ||
+            ((slaveFd = open(ptsname(masterFd), O_RDWR | O_NOCTTY)) < 0))
+    {
+        printf("Open pty failed!\n");
+        return 1;
+    }
+
+    tcgetattr(slaveFd, &stTio);
+    cfmakeraw(&stTio);
+    tcsetattr(slaveFd, TCSANOW, &stTio);
+    fcntl(masterFd, F_SETFL, O_NONBLOCK);
+    fcntl(slaveFd, F_SETFL, O_NONBLOCK);
+    fflush(stdout);
+    ecuPid = fork();
+
+    if (0 == ecuPid)
+    {
+        close(slaveFd);
+        RunECU(masterFd);
+        _exit(0);
+    }
+
+    close(masterFd);
+    errors = RunTester(slaveFd, msgNum, corruptEvery, dropAckEvery);
+    /* Let ECU report requests out of order before it is stopped */
+    usleep(100000);
+    kill(ecuPid, SIGTERM);
+    waitpid(ecuPid, NULL, 0);
+    printf("%lu errors\n", errors);
+    return (0u == errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
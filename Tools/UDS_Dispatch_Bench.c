@@ -0,0 +1,285 @@
+/*
+ * @ : UDS_Dispatch_Bench.c
+ * @ : Host UDS service dispatch microbenchmark
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host microbenchmark of UDS_MainFun per request: SID table lookup, permission mask
+**                test, sub-function/DID lookup and the service handler
+**
+**  Build (in repo root):
+**      gcc -O2 -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o UDS_Dispatch_Bench \
+**          Tools/UDS_Dispatch_Bench.c UDS_ProtocolStack/uds_app.c UDS_ProtocolStack/uds_app_cfg.c \
+**          UDS_ProtocolStack/TP_cfg.c UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  Usage: UDS_Dispatch_Bench [loops]
+**
+**  TP_ReadAFrameDataFromTP and TP_WriteAFrameDataInTP are replaced by the tool, each UDS_MainFun
+**  call reads the same request from the tester physical ID, so only the UDS app is timed.
+**  fls_app, UDS_alg_hal, CRC_HAL and boot are stubbed. The response of each request is checked.
+*******************************************************/
+
+#include "uds_app.h"
+#include "fls_app.h"
+#include "UDS_alg_hal.h"
+#include "CRC_hal.h"
+#include "watchdog_hal.h"
+#include "boot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* A benchmark request and its expected response */
+typedef struct
+{
+    const char *pName;          /* Request name */
+    uint8 aReq[8u];             /* Request */
+    uint32 reqLen;              /* Request len */
+    uint8 aResp[3u];            /* First bytes of expected response */
+    uint32 respLen;             /* Compared response len, 0 = no response */
+} tBenchRequest;
+
+static const tBenchRequest *gs_pstRequest = NULL_PTR;
+static uint8 gs_aResp[8u];
+static uint32 gs_respLen = 0u;
+static uint32 gs_respCnt = 0u;
+
+/* Stubs of S32K SDK and timer HAL */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return 0u;
+}
+
+/* TP RX and TX of UDS app */
+boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID, uint32 *o_pxRxDataLen, uint8 *o_pDataBuf)
+{
+    *o_pRxMsgID = TP_GetConfigRxMsgPHYID();
+    *o_pxRxDataLen = gs_pstRequest->reqLen;
+    memcpy(o_pDataBuf, gs_pstRequest->aReq, gs_pstRequest->reqLen);
+    return TRUE;
+}
+
+boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
+                               const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+                               const uint32 i_xTxDataLen,
+                               const uint8 *i_pDataBuf)
+{
+    (void)i_TxMsgID;
+    (void)i_pfUDSTxMsgCallBack;
+    gs_respLen = i_xTxDataLen;
+    memcpy(gs_aResp, i_pDataBuf, (i_xTxDataLen > sizeof(gs_aResp)) ? sizeof(gs_aResp) : i_xTxDataLen);
+    gs_respCnt++;
+    return TRUE;
+}
+
+/* Stubs of fls_app */
+void Flash_InitDowloadInfo(void)
+{
+}
+
+uint8 Flash_ProgramRegion(const uint32 i_addr, const uint8 *i_pDataBuf, const uint32 i_dataLen)
+{
+    (void)i_addr;
+    (void)i_pDataBuf;
+    (void)i_dataLen;
+    return FALSE;
+}
+
+uint8 Flash_FlushProgramData(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_IsProgramFailed(void)
+{
+    return FALSE;
+}
+
+#ifdef EN_DOWNLOAD_STATISTICS
+void Flash_GetStatistics(tFlashStatistics *o_pstStatistics)
+{
+    memset(o_pstStatistics, 0, sizeof(*o_pstStatistics));
+}
+#endif
+
+uint8 Flash_IsReadAppInfoFromFlashValid(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_IsAppInFlashValid(void)
+{
+    return TRUE;
+}
+
+void Flash_SavedReceivedCheckSumCrc(uint32 i_receivedCrc)
+{
+    (void)i_receivedCrc;
+}
+
+void Flash_EraseFlashDriverInRAM(void)
+{
+}
+
+void Flash_SetNextDownloadStep(const tFlDownloadStepType i_donwloadStep)
+{
+    (void)i_donwloadStep;
+}
+
+tFlDownloadStepType Flash_GetCurDownloadStep(void)
+{
+    return FL_REQUEST_STEP;
+}
+
+void Flash_SaveDownloadDataInfo(const uint32 i_dataStartAddr, const uint32 i_dataLen)
+{
+    (void)i_dataStartAddr;
+    (void)i_dataLen;
+}
+
+void Flash_SetOperateFlashActiveJob(const tFlshJobModle i_activeJob,
+                                    const tpfResponse i_pfActiveFinshedCallBack,
+                                    const uint8 i_requestUDSSerID,
+                                    const tpfReuestMoreTime i_pfRequestMoreTimeCallback)
+{
+    (void)i_activeJob;
+    (void)i_pfActiveFinshedCallBack;
+    (void)i_requestUDSSerID;
+    (void)i_pfRequestMoreTimeCallback;
+}
+
+void Flash_SaveFingerPrint(const uint8 *i_pFingerPrint, const uint8 i_FingerPrintLen)
+{
+    (void)i_pFingerPrint;
+    (void)i_FingerPrintLen;
+}
+
+uint8 Flash_WriteFlashAppInfo(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_GetNewestAppInfo(uint8 *o_pFingerPrint, uint8 *o_pAppCnt)
+{
+    memset(o_pFingerPrint, 0x5A, FL_FINGER_PRINT_LENGTH);
+    *o_pAppCnt = 1u;
+    return TRUE;
+}
+
+/* Stubs of UDS_alg_hal, CRC_HAL, watchdog and boot */
+void UDS_ALG_HAL_Init(void)
+{
+}
+
+boolean UDS_ALG_HAL_DecryptData(const uint8 *i_pCipherText, const uint32 i_dataLen, uint8 *o_pPlainText)
+{
+    memcpy(o_pPlainText, i_pCipherText, i_dataLen);
+    return TRUE;
+}
+
+boolean UDS_ALG_HAL_GetRandom(const uint32 i_needRandomDataLen, uint8 *o_pRandomDataBuf)
+{
+    memset(o_pRandomDataBuf, 0x11, i_needRandomDataLen);
+    return TRUE;
+}
+
+void UDS_ALG_HAL_AddSWTimerTickCnt(void)
+{
+}
+
+void CRC_HAL_CreatHardwareCrc(const uint8 *i_pucDataBuf, const uint32 i_ulDataLen, uint32 *m_pCurCrc)
+{
+    (void)i_pucDataBuf;
+    (void)i_ulDataLen;
+    (void)m_pCurCrc;
+}
+
+void WATCHDOG_HAL_SystemReset(void)
+{
+}
+
+void SetDownloadAppSuccessful(void)
+{
+}
+
+static double GetSeconds(void)
+{
+    struct timespec stTime;
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return (double)stTime.tv_sec + (double)stTime.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    static const tBenchRequest astRequest[] =
+    {
+        {"0x10 01 default session", {0x10u, 0x01u}, 2u, {0x50u, 0x01u}, 2u},
+        {"0x3E 00 tester present", {0x3Eu, 0x00u}, 2u, {0x7Eu, 0x00u}, 2u},
+        {"0x3E 80 suppress pos", {0x3Eu, 0x80u}, 2u, {0u}, 0u},
+        {"0x22 F15A fingerprint", {0x22u, 0xF1u, 0x5Au}, 3u, {0x62u, 0xF1u, 0x5Au}, 3u},
+        {"0x22 1234 unknown DID", {0x22u, 0x12u, 0x34u}, 3u, {0x7Fu, 0x22u, 0x31u}, 3u},
+        {"0x31 in default session", {0x31u, 0x01u, 0xFFu, 0x00u}, 4u, {0x7Fu, 0x31u, 0x11u}, 3u},
+        {"0xBA not supported", {0xBAu, 0x00u}, 2u, {0x7Fu, 0xBAu, 0x11u}, 3u},
+    };
+    const long loops = (argc > 1) ? atol(argv[1]) : 5000000L;
+    unsigned long errors = 0u;
+    unsigned int index = 0u;
+    long loop = 0;
+    double startTime = 0.0;
+    double usedTime = 0.0;
+
+    if (0 >= loops)
+    {
+        printf("Usage: UDS_Dispatch_Bench [loops]\n");
+        return 1;
+    }
+
+    UDS_Init();
+
+    for (index = 0u; index < (sizeof(astRequest) / sizeof(astRequest[0u])); index++)
+    {
+        gs_pstRequest = &astRequest[index];
+        gs_respCnt = 0u;
+        gs_respLen = 0u;
+        UDS_MainFun();
+
+        if (((0u == astRequest[index].respLen) && (0u != gs_respCnt)) ||
+                ((0u != astRequest[index].respLen) &&
+                 ((1u != gs_respCnt) || (gs_respLen < astRequest[index].respLen) ||
+                  (0 != memcmp(gs_aResp, astRequest[index].aResp, astRequest[index].respLen)))))
+        {
+            printf("%-24s unexpected response: %u responses, %02X %02X %02X\n",
+                   astRequest[index].pName, gs_respCnt, gs_aResp[0u], gs_aResp[1u], gs_aResp[2u]);
+            errors++;
+        }
+
+        startTime = GetSeconds();
+
+        for (loop = 0; loop < loops; loop++)
+        {
+            UDS_MainFun();
+        }
+
+        usedTime = GetSeconds() - startTime;
+        printf("%-24s %6.1f ns per request, %6.2f M requests/s\n",
+               astRequest[index].pName, usedTime * 1e9 / (double)loops, (double)loops / usedTime / 1e6);
+    }
+
+    printf("%lu errors\n", errors);
+    return (0u == errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
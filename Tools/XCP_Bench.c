@@ -0,0 +1,588 @@
+/*
+ * @ : XCP_Bench.c
+ * @ : Host XCP block mode vs UDS 0x36 download benchmark
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : Host benchmark of APP data download by XCP PROGRAM block mode and by UDS 0x36 on CAN TP
+**
+**  Build (in repo root):
+**      gcc -O2 -no-pie -include stdint.h -D_EWL_CSTDINT -DCPU_S32K144HFT0VLLT -DUDS_PROJECT_FOR_BOOTLOADER -DEN_XCP_ON_CAN \
+**          $(find UDS_* Generated_Code SDK -type d -printf '-I%p ') -o XCP_Bench \
+**          Tools/XCP_Bench.c UDS_ProtocolStack/xcp.c UDS_ProtocolStack/xcp_cfg.c \
+**          UDS_ProtocolStack/TP.c UDS_ProtocolStack/TP_cfg.c \
+**          UDS_ProtocolStack/can_tp.c UDS_ProtocolStack/can_tp_cfg.c \
+**          UDS_ProtocolStack/multi_cyc_fifo.c UDS_ProtocolStack/autolibc.c
+**  TX callbacks are saved as uint32 in the TX FIFOs, -no-pie keeps their addresses in 32 bits.
+**  Usage: XCP_Bench [download bytes] [CAN bit rate] [block len]
+**  E.g.   XCP_Bench 65536 500000 128
+**
+**  One CAN bus is simulated in virtual time, a frame takes TEST_FRAME_BITS bit times and the ECU
+**  TX frame wins arbitration. ECU main functions run each 1 ms tick, frames are RX in the
+**  interrupt and TX frames are read from the TX FIFOs as the CAN driver does.
+**  XCP: real XCP slave, CONNECT, PROGRAM_START, PROGRAM_CLEAR and SET_MTA, then the data is
+**  TX in PROGRAM/PROGRAM_NEXT blocks, back to back as MIN_ST_PGM is 0.
+**  UDS: real CAN TP with g_stCANUdsNetLayerCfgInfo (BS, STmin), a request 0x36 <counter> <block>
+**  is answered 0x76 <counter> by the tool in the next tick.
+**  fls_app is stubbed, a program job is finished in the next tick. Programmed data is checked.
+*******************************************************/
+
+#include "xcp.h"
+#include "fls_app.h"
+#include "TP.h"
+#include "can_tp_cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_FRAME_BITS     (125u)          /* 8 bytes standard frame, 111 bits with IFS and typical stuff bits */
+#define TEST_STEP_US        (10u)           /* Virtual time step */
+#define TEST_MAX_TIME_US    (600000000u)    /* Download fail after it */
+#define TEST_IMAGE_LEN      (APP_A_END_ADDR - APP_A_START_ADDR)
+
+/* CAN bus, a frame in flight */
+typedef struct
+{
+    uint8 isBusy;           /* A frame is in flight */
+    uint8 isFromECU;        /* Frame is TX by ECU */
+    uint8 isFromCANTP;      /* ECU frame is TX by CAN TP, else by XCP */
+    uint32 endTime;         /* Frame end time, us */
+    uint32 msgId;           /* Frame ID */
+    uint8 aData[8u];        /* Frame data */
+    uint8 dataLen;          /* Frame data len */
+} tTestBus;
+
+static uint32 gs_timeUs = 0u;               /* Virtual time */
+static uint32 gs_frameUs = 0u;              /* A frame time on the bus */
+static tTestBus gs_stBus;
+static uint32 gs_ecuFrames = 0u;            /* Frames TX by ECU */
+static uint32 gs_testerFrames = 0u;         /* Frames TX by tester */
+static uint8 gs_aImage[TEST_IMAGE_LEN];     /* Programmed APP */
+
+/* fls_app stubs */
+static tFlshJobModle gs_eJob = FLASH_IDLE;
+static tpfResponse gs_pfJobCallBack = NULL_PTR;
+
+/* Stubs of S32K SDK, timer HAL and UDS app */
+void INT_SYS_DisableIRQGlobal(void)
+{
+}
+
+void INT_SYS_EnableIRQGlobal(void)
+{
+}
+
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return gs_timeUs / 1000u;
+}
+
+void WATCHDOG_HAL_SystemReset(void)
+{
+}
+
+void RestartS3Server(void)
+{
+}
+
+void SetIsRxUdsMsg(const boolean i_setValue)
+{
+    (void)i_setValue;
+}
+
+void SetDownloadAppSuccessful(void)
+{
+}
+
+void Flash_SetNextDownloadStep(const tFlDownloadStepType i_donwloadStep)
+{
+    (void)i_donwloadStep;
+}
+
+void Flash_SaveDownloadDataInfo(const uint32 i_dataStartAddr, const uint32 i_dataLen)
+{
+    (void)i_dataStartAddr;
+    (void)i_dataLen;
+}
+
+uint8 Flash_ProgramRegion(const uint32 i_addr, const uint8 *i_pDataBuf, const uint32 i_dataLen)
+{
+    if ((i_addr < APP_A_START_ADDR) || ((i_addr + i_dataLen) > APP_A_END_ADDR))
+    {
+        return FALSE;
+    }
+
+    memcpy(&gs_aImage[i_addr - APP_A_START_ADDR], i_pDataBuf, i_dataLen);
+    gs_eJob = FLASH_PROGRAMMING;
+    return TRUE;
+}
+
+void Flash_SetOperateFlashActiveJob(const tFlshJobModle i_activeJob,
+                                    const tpfResponse i_pfActiveFinshedCallBack,
+                                    const uint8 i_requestUDSSerID,
+                                    const tpfReuestMoreTime i_pfRequestMoreTimeCallback)
+{
+    (void)i_requestUDSSerID;
+    (void)i_pfRequestMoreTimeCallback;
+    gs_eJob = i_activeJob;
+    gs_pfJobCallBack = i_pfActiveFinshedCallBack;
+}
+
+tFlshJobModle Flash_GetOperateFlashActiveJob(void)
+{
+    return gs_eJob;
+}
+
+void Flash_RegisterJobCallback(tpfResponse i_pfDoResponse)
+{
+    gs_pfJobCallBack = i_pfDoResponse;
+}
+
+void Flash_SetCheckSumVerifiedByHost(void)
+{
+}
+
+uint32 Flash_GetCountedCheckSumCrc(void)
+{
+    return 0u;
+}
+
+boolean Flash_IsFlashDriverDownloaded(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_IsAppInFlashValid(void)
+{
+    return TRUE;
+}
+
+uint8 Flash_WriteFlashAppInfo(void)
+{
+    return TRUE;
+}
+
+void Flash_EraseFlashDriverInRAM(void)
+{
+}
+
+/* Finish active flash job in a tick */
+static void RunFlashJob(void)
+{
+    tpfResponse pfCallBack = gs_pfJobCallBack;
+
+    if (FLASH_IDLE != gs_eJob)
+    {
+        gs_eJob = FLASH_IDLE;
+        gs_pfJobCallBack = NULL_PTR;
+
+        if (NULL_PTR != pfCallBack)
+        {
+            pfCallBack(TRUE);
+        }
+    }
+}
+
+/* TX ECU frame first, it wins arbitration. Tester frame is given by caller. Return TRUE if bus is taken. */
+static boolean StartBusFrame(const uint32 i_msgId, const uint8 *i_pData, const uint8 i_dataLen)
+{
+    tTPTxMsgHeader stTxMsgHeader;
+
+    if (TRUE == gs_stBus.isBusy)
+    {
+        return FALSE;
+    }
+
+    if (TRUE == CANTP_DriverPeekDataFromCANTP(8u, gs_stBus.aData, &stTxMsgHeader))
+    {
+        CANTP_DriverReleaseDataFromCANTP();
+        gs_stBus.isFromECU = TRUE;
+        gs_stBus.isFromCANTP = TRUE;
+    }
+    else if (TRUE == XCP_DriverPeekDataFromXCP(8u, gs_stBus.aData, &stTxMsgHeader))
+    {
+        XCP_DriverReleaseDataFromXCP();
+        gs_stBus.isFromECU = TRUE;
+        gs_stBus.isFromCANTP = FALSE;
+    }
+    else if (NULL_PTR != i_pData)
+    {
+        memcpy(gs_stBus.aData, i_pData, i_dataLen);
+        stTxMsgHeader.TxMsgID = i_msgId;
+        stTxMsgHeader.TxMsgLength = i_dataLen;
+        gs_stBus.isFromECU = FALSE;
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    gs_stBus.isBusy = TRUE;
+    gs_stBus.msgId = stTxMsgHeader.TxMsgID;
+    gs_stBus.dataLen = (uint8)stTxMsgHeader.TxMsgLength;
+    gs_stBus.endTime = gs_timeUs + gs_frameUs;
+    return (FALSE == gs_stBus.isFromECU) ? TRUE : FALSE;
+}
+
+/* Step virtual time, return frame RX by tester or NULL */
+static const tTestBus *StepTime(void)
+{
+    const tTestBus *pstRxFrame = NULL_PTR;
+
+    gs_timeUs += TEST_STEP_US;
+
+    if ((TRUE == gs_stBus.isBusy) && (gs_timeUs >= gs_stBus.endTime))
+    {
+        gs_stBus.isBusy = FALSE;
+
+        if (TRUE == gs_stBus.isFromECU)
+        {
+            gs_ecuFrames++;
+            pstRxFrame = &gs_stBus;
+
+            /* TX complete callback of the stack */
+            if (TRUE == gs_stBus.isFromCANTP)
+            {
+                CANTP_DoTxMsgSuccessfulCallBack();
+            }
+            else
+            {
+                XCP_DoTxMsgSuccessfulCallBack();
+            }
+        }
+        else
+        {
+            gs_testerFrames++;
+
+            if (XCP_GetConfigRxMsgID() == gs_stBus.msgId)
+            {
+                (void)XCP_DriverWriteDataInXCP(gs_stBus.dataLen, gs_stBus.aData);
+            }
+            else
+            {
+                (void)CANTP_DriverWriteDataInCANTP(gs_stBus.msgId, gs_stBus.dataLen, gs_stBus.aData);
+            }
+        }
+    }
+
+    if (0u == (gs_timeUs % 1000u))
+    {
+        TP_SystemTickCtl();
+        TP_MainFun();
+        XCP_MainFun();
+        RunFlashJob();
+    }
+
+    /* ECU TX is started when bus is idle */
+    (void)StartBusFrame(0u, NULL_PTR, 0u);
+
+    return pstRxFrame;
+}
+
+/* TX a tester frame, wait bus. Return FALSE if timeout. */
+static boolean TesterTxFrame(const uint32 i_msgId, const uint8 *i_pData)
+{
+    while (FALSE == StartBusFrame(i_msgId, i_pData, 8u))
+    {
+        if ((NULL_PTR != StepTime()) || (gs_timeUs > TEST_MAX_TIME_US))
+        {
+            /* Tester does not expect a frame during its TX */
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Wait a frame TX by ECU to tester */
+static const tTestBus *TesterRxFrame(void)
+{
+    const tTestBus *pstRxFrame = NULL_PTR;
+
+    while ((NULL_PTR == (pstRxFrame = StepTime())) && (gs_timeUs < TEST_MAX_TIME_US))
+    {
+    }
+
+    return pstRxFrame;
+}
+
+/* XCP CMD and its RES, return FALSE if RES is not positive */
+static boolean XCPCommand(const uint8 *i_pCmd)
+{
+    const tTestBus *pstRxFrame = NULL_PTR;
+    uint8 aCmd[8u] = {0u};
+
+    memcpy(aCmd, i_pCmd, sizeof(aCmd));
+
+    if (FALSE == TesterTxFrame(XCP_GetConfigRxMsgID(), aCmd))
+    {
+        return FALSE;
+    }
+
+    /* Skip EV_CMD_PENDING */
+    do
+    {
+        pstRxFrame = TesterRxFrame();
+    } while ((NULL_PTR != pstRxFrame) && (0xFDu == pstRxFrame->aData[0u]));
+
+    return ((NULL_PTR != pstRxFrame) && (0xFFu == pstRxFrame->aData[0u])) ? TRUE : FALSE;
+}
+
+/* XCP download, return used time us or 0 */
+static uint32 RunXCP(const uint8 *i_pData, const uint32 i_len, const uint32 i_blockLen)
+{
+    const uint8 aConnect[8u] = {0xFFu, 0u};
+    const uint8 aProgramStart[8u] = {0xD2u};
+    const uint8 aProgramClear[8u] = {0xD1u, 0u, 0u, 0u, 0u, 0u, 0x6Cu, 0u};
+    const uint8 aSetMTA[8u] = {0xF6u, 0u, 0u, 0u,
+                               (uint8)APP_A_START_ADDR, (uint8)(APP_A_START_ADDR >> 8u),
+                               (uint8)(APP_A_START_ADDR >> 16u), (uint8)(APP_A_START_ADDR >> 24u)
+                              };
+    uint8 aFrame[8u];
+    uint32 startTime = 0u;
+    uint32 offset = 0u;
+    uint32 blockLen = 0u;
+    uint32 remain = 0u;
+    uint32 dataLen = 0u;
+    const tTestBus *pstRxFrame = NULL_PTR;
+
+    XCP_Init();
+
+    if ((FALSE == XCPCommand(aConnect)) || (FALSE == XCPCommand(aProgramStart)) ||
+            (FALSE == XCPCommand(aProgramClear)) || (FALSE == XCPCommand(aSetMTA)))
+    {
+        printf("XCP: session setup failed\n");
+        return 0u;
+    }
+
+    startTime = gs_timeUs;
+    gs_ecuFrames = 0u;
+    gs_testerFrames = 0u;
+
+    for (offset = 0u; offset < i_len; offset += blockLen)
+    {
+        blockLen = ((i_len - offset) > i_blockLen) ? i_blockLen : (i_len - offset);
+
+        for (remain = blockLen; 0u != remain; remain -= dataLen)
+        {
+            dataLen = (remain > 6u) ? 6u : remain;
+            memset(aFrame, 0u, sizeof(aFrame));
+            aFrame[0u] = (remain == blockLen) ? 0xD0u : 0xCAu;
+            aFrame[1u] = (uint8)remain;
+            memcpy(&aFrame[2u], &i_pData[offset + blockLen - remain], dataLen);
+
+            if (FALSE == TesterTxFrame(XCP_GetConfigRxMsgID(), aFrame))
+            {
+                printf("XCP: unexpected frame in block at 0x%X\n", (unsigned int)offset);
+                return 0u;
+            }
+        }
+
+        pstRxFrame = TesterRxFrame();
+
+        if ((NULL_PTR == pstRxFrame) || (0xFFu != pstRxFrame->aData[0u]))
+        {
+            printf("XCP: block at 0x%X is not answered positive\n", (unsigned int)offset);
+            return 0u;
+        }
+    }
+
+    return gs_timeUs - startTime;
+}
+
+/* UDS 0x36 download on CAN TP, tester as ISO 15765-2 sender. Return used time us or 0 */
+static uint32 RunUDS(const uint8 *i_pData, const uint32 i_len, const uint32 i_blockLen)
+{
+    static uint8 aReq[2u + 4095u];
+    uint8 aMsgBuf[TP_MAX_MSG_LEN];
+    uint8 aResp[2u] = {0x76u, 0u};
+    uint8 aFrame[8u];
+    uint32 startTime = gs_timeUs;
+    uint32 offset = 0u;
+    uint32 blockLen = 0u;
+    uint32 reqLen = 0u;
+    uint32 sent = 0u;
+    uint32 dataLen = 0u;
+    uint32 msgId = 0u;
+    uint32 msgLen = 0u;
+    uint32 blockSize = 0u;      /* BS of last FC, 0 = no more FC */
+    uint32 cfInBlock = 0u;
+    uint32 stMinUs = 0u;
+    uint32 nextCFTime = 0u;
+    uint8 sn = 0u;
+    uint8 counter = 1u;
+    boolean isResp = FALSE;
+    const tTestBus *pstRxFrame = NULL_PTR;
+
+    TP_Init();
+
+    for (offset = 0u; offset < i_len; offset += blockLen)
+    {
+        blockLen = ((i_len - offset) > i_blockLen) ? i_blockLen : (i_len - offset);
+        aReq[0u] = 0x36u;
+        aReq[1u] = counter;
+        memcpy(&aReq[2u], &i_pData[offset], blockLen);
+        reqLen = 2u + blockLen;
+
+        /* FF */
+        aFrame[0u] = (uint8)(0x10u | (reqLen >> 8u));
+        aFrame[1u] = (uint8)reqLen;
+        memcpy(&aFrame[2u], aReq, 6u);
+        sent = 6u;
+        sn = 1u;
+        cfInBlock = 0u;
+        blockSize = 0u;
+
+        if (FALSE == TesterTxFrame(RX_PHY_ADDR_ID, aFrame))
+        {
+            return 0u;
+        }
+
+        while (sent < reqLen)
+        {
+            if ((0u == cfInBlock) || ((0u != blockSize) && (cfInBlock >= blockSize)))
+            {
+                /* Wait FC CTS */
+                pstRxFrame = TesterRxFrame();
+
+                if ((NULL_PTR == pstRxFrame) || (0x30u != pstRxFrame->aData[0u]))
+                {
+                    printf("UDS: no FC CTS of block %u\n", (unsigned int)counter);
+                    return 0u;
+                }
+
+                blockSize = pstRxFrame->aData[1u];
+                stMinUs = (pstRxFrame->aData[2u] <= 0x7Fu) ? (uint32)pstRxFrame->aData[2u] * 1000u : 100u;
+                cfInBlock = 0u;
+                nextCFTime = gs_timeUs;
+            }
+
+            while (gs_timeUs < nextCFTime)
+            {
+                if (NULL_PTR != StepTime())
+                {
+                    printf("UDS: unexpected frame during CF\n");
+                    return 0u;
+                }
+            }
+
+            dataLen = ((reqLen - sent) > 7u) ? 7u : (reqLen - sent);
+            memset(aFrame, 0x55u, sizeof(aFrame));
+            aFrame[0u] = (uint8)(0x20u | (sn & 0x0Fu));
+            memcpy(&aFrame[1u], &aReq[sent], dataLen);
+
+            if (FALSE == TesterTxFrame(RX_PHY_ADDR_ID, aFrame))
+            {
+                return 0u;
+            }
+
+            /* STmin is from the end of a CF to the start of next CF */
+            while (TRUE == gs_stBus.isBusy)
+            {
+                (void)StepTime();
+            }
+
+            nextCFTime = gs_timeUs + stMinUs;
+            sent += dataLen;
+            sn++;
+            cfInBlock++;
+        }
+
+        /* UDS app answers in the tick after the request is RX */
+        for (isResp = FALSE; FALSE == isResp;)
+        {
+            pstRxFrame = StepTime();
+
+            if (NULL_PTR != pstRxFrame)
+            {
+                isResp = ((0x02u == pstRxFrame->aData[0u]) && (0x76u == pstRxFrame->aData[1u]) &&
+                          (counter == pstRxFrame->aData[2u])) ? TRUE : FALSE;
+
+                if (FALSE == isResp)
+                {
+                    printf("UDS: bad response of block %u\n", (unsigned int)counter);
+                    return 0u;
+                }
+            }
+            else if (0u == (gs_timeUs % 1000u))
+            {
+                while (TRUE == TP_ReadAFrameDataFromTP(&msgId, &msgLen, aMsgBuf))
+                {
+                    if ((msgLen >= 2u) && (0x36u == aMsgBuf[0u]) && (aMsgBuf[1u] == counter) &&
+                            (TRUE == Flash_ProgramRegion(APP_A_START_ADDR + offset, &aMsgBuf[2u], msgLen - 2u)))
+                    {
+                        aResp[1u] = aMsgBuf[1u];
+                        (void)TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), NULL_PTR, sizeof(aResp), aResp);
+                    }
+                }
+            }
+            else if (gs_timeUs > TEST_MAX_TIME_US)
+            {
+                return 0u;
+            }
+        }
+
+        counter++;
+    }
+
+    return gs_timeUs - startTime;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8 aData[TEST_IMAGE_LEN];
+    const uint32 len = (uint32)((argc > 1) ? atol(argv[1]) : 65536);
+    const uint32 bitRate = (uint32)((argc > 2) ? atol(argv[2]) : 500000);
+    const uint32 blockLen = (uint32)((argc > 3) ? atoi(argv[3]) : (int)XCP_MAX_BLOCK_LEN);
+    uint32 index = 0u;
+    uint32 usedTime = 0u;
+    uint32 frames = 0u;
+    unsigned long errors = 0u;
+
+    if ((0u == len) || (len > TEST_IMAGE_LEN) || (0u == bitRate) || (0u == blockLen) ||
+            (blockLen > XCP_MAX_BLOCK_LEN) || ((2u + blockLen) > TP_MAX_MSG_LEN))
+    {
+        printf("Usage: XCP_Bench [download bytes 1..%u] [CAN bit rate] [block len 1..%u]\n",
+               (unsigned int)TEST_IMAGE_LEN, (unsigned int)XCP_MAX_BLOCK_LEN);
+        return 1;
+    }
+
+    gs_frameUs = (TEST_FRAME_BITS * 1000000u + bitRate - 1u) / bitRate;
+    gs_frameUs = ((gs_frameUs + TEST_STEP_US - 1u) / TEST_STEP_US) * TEST_STEP_US;
+
+    for (index = 0u; index < len; index++)
+    {
+        aData[index] = (uint8)((index * 7u) ^ (index >> 8u));
+    }
+
+    printf("%u bytes in %u bytes blocks, %u bit/s, %u us per frame, CAN TP BS %u STmin %u ms\n",
+           (unsigned int)len, (unsigned int)blockLen, (unsigned int)bitRate, (unsigned int)gs_frameUs,
+           (unsigned int)g_stCANUdsNetLayerCfgInfo.xBlockSize, (unsigned int)g_stCANUdsNetLayerCfgInfo.xSTmin);
+
+    gs_ecuFrames = 0u;
+    gs_testerFrames = 0u;
+    usedTime = RunXCP(aData, len, blockLen);
+    frames = gs_ecuFrames + gs_testerFrames;
+    errors += ((0u == usedTime) || (0 != memcmp(gs_aImage, aData, len))) ? 1u : 0u;
+    printf("XCP PROGRAM block: %8.1f ms, %6.0f B/s, %5u frames, %.2f frames per data byte\n",
+           (double)usedTime / 1000.0, (0u != usedTime) ? (double)len * 1e6 / (double)usedTime : 0.0,
+           (unsigned int)frames, (double)frames / (double)len);
+
+    memset(gs_aImage, 0u, sizeof(gs_aImage));
+    gs_ecuFrames = 0u;
+    gs_testerFrames = 0u;
+    usedTime = RunUDS(aData, len, blockLen);
+    frames = gs_ecuFrames + gs_testerFrames;
+    errors += ((0u == usedTime) || (0 != memcmp(gs_aImage, aData, len))) ? 1u : 0u;
+    printf("UDS 0x36 CAN TP:   %8.1f ms, %6.0f B/s, %5u frames, %.2f frames per data byte\n",
+           (double)usedTime / 1000.0, (0u != usedTime) ? (double)len * 1e6 / (double)usedTime : 0.0,
+           (unsigned int)frames, (double)frames / (double)len);
+
+    printf("%lu errors\n", errors);
+    return (0u == errors) ? 0 : 1;
+}
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,137 @@
+/*
+ * @ : socket_hal_host.c
+ * @ : Host SOCKET_HAL over loopback TCP
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+/*******************************************************
+**  Description : SOCKET_HAL of socket_hal.h on a Linux/macOS host, link it instead of
+**                UDS_PortingFiles/socket_hal.c to run DoIP TP on the host.
+**                Listen on 127.0.0.1 only, one connection is accepted, all calls are non blocking.
+*******************************************************/
+
+/* Before system headers, their macros break S32K144.h */
+#include "socket_hal.h"
+/* Byte order macros of common_types.h break socket headers, use functions of them */
+#undef ntohs
+#undef ntohl
+#undef htons
+#undef htonl
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#ifdef EN_ETHERNET_TP
+
+static int gs_listenFd = -1;    /* Listen socket */
+static int gs_connFd = -1;      /* Connected socket, -1 is not connected */
+
+static void SetNonBlock(const int i_fd)
+{
+    (void)fcntl(i_fd, F_SETFL, fcntl(i_fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+void SOCKET_HAL_Init(const uint16 i_port)
+{
+    struct sockaddr_in stAddr;
+    int option = 1;
+
+    memset(&stAddr, 0, sizeof(stAddr));
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_port = htons(i_port);
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    gs_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (gs_listenFd < 0)
+    {
+        return;
+    }
+
+    (void)setsockopt(gs_listenFd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+    if ((0 != bind(gs_listenFd, (struct sockaddr *)&stAddr, sizeof(stAddr))) || (0 != listen(gs_listenFd, 1)))
+    {
+        close(gs_listenFd);
+        gs_listenFd = -1;
+        return;
+    }
+
+    SetNonBlock(gs_listenFd);
+}
+
+boolean SOCKET_HAL_IsConnected(void)
+{
+    int option = 1;
+
+    if ((gs_connFd < 0) && (gs_listenFd >= 0))
+    {
+        gs_connFd = accept(gs_listenFd, NULL, NULL);
+
+        if (gs_connFd >= 0)
+        {
+            SetNonBlock(gs_connFd);
+            /* DoIP messages are small, TX them without Nagle delay */
+            (void)setsockopt(gs_connFd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+        }
+    }
+
+    return (gs_connFd >= 0) ? TRUE : FALSE;
+}
+
+uint32 SOCKET_HAL_Read(uint8 *o_pBuf, const uint32 i_bufLen)
+{
+    ssize_t readLen = 0;
+
+    if (gs_connFd < 0)
+    {
+        return 0u;
+    }
+
+    readLen = recv(gs_connFd, o_pBuf, i_bufLen, 0);
+
+    /* Closed by tester */
+    if (0 == readLen)
+    {
+        SOCKET_HAL_Close();
+        return 0u;
+    }
+
+    return (readLen > 0) ? (uint32)readLen : 0u;
+}
+
+uint32 SOCKET_HAL_Write(const uint8 *i_pBuf, const uint32 i_len)
+{
+    ssize_t writeLen = 0;
+
+    if (gs_connFd < 0)
+    {
+        return 0u;
+    }
+
+#ifdef MSG_NOSIGNAL
+    writeLen = send(gs_connFd, i_pBuf, i_len, MSG_NOSIGNAL);
+#else
+    writeLen = send(gs_connFd, i_pBuf, i_len, 0);
+#endif
+
+    return (writeLen > 0) ? (uint32)writeLen : 0u;
+}
+
+void SOCKET_HAL_Close(void)
+{
+    if (gs_connFd >= 0)
+    {
+        close(gs_connFd);
+        gs_connFd = -1;
+    }
+}
+
+#endif /* EN_ETHERNET_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
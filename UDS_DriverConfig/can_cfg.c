@@ -55,7 +55,14 @@ const tCANHardwareConfig g_stCANHardWareConfig =
 const tRxMsgConfig g_astRxMsgConfig[] =
 {
     {RX_FUN_ADDR_ID_MAILBOX, RX_FUN_ADDR_ID, RX_FUN_ADDR_ID_MASK, RX_FUN_ADDR_ID_TYPE},
-    {RX_PHY_ADDR_ID_MAILBOX, RX_PHY_ADDR_ID, RX_PHY_ADDR_ID_MASK, RX_PHY_ADDR_ID_TYPE}
+    {RX_PHY_ADDR_ID_MAILBOX, RX_PHY_ADDR_ID, RX_PHY_ADDR_ID_MASK, RX_PHY_ADDR_ID_TYPE},
+#ifdef EN_XCP_ON_CAN
+    {XCP_RX_ID_MAILBOX, XCP_RX_ID, XCP_RX_ID_MASK, XCP_RX_ID_TYPE},
+#endif
+#ifdef EN_J1939_TP
+    {J1939_RX_PHY_ID_MAILBOX, J1939_RX_PHY_ID, J1939_RX_ID_MASK, J1939_RX_ID_TYPE},
+    {J1939_RX_FUN_ID_MAILBOX, J1939_RX_FUN_ID, J1939_RX_ID_MASK, J1939_RX_ID_TYPE},
+#endif
 };
 
 const unsigned char g_ucRxCANMsgIDNum = sizeof(g_astRxMsgConfig) / sizeof(g_astRxMsgConfig[0u]);
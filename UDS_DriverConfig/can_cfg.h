@@ -12,7 +12,7 @@
 #ifndef CAN_CFG_H_
 #define CAN_CFG_H_
 
-#include "cpu.h"
+#include "Cpu.h"
 #include "user_config.h"
 
 #ifdef EN_CAN_TP
@@ -56,6 +56,23 @@
 #define RX_PHY_ADDR_ID_MAILBOX  (2u)
 #define TX_RESP_ADDR_ID_MAILBOX (3u)
 
+#ifdef EN_XCP_ON_CAN
+/* XCP CMD ID, same ID type as CAN TP. XCP RES ID is TX by TX_RESP_ADDR_ID_MAILBOX. */
+#define XCP_RX_ID_TYPE          RX_PHY_ADDR_ID_TYPE
+#define XCP_RX_ID_MASK          0xFFFFFFFFu
+#define XCP_RX_ID_MAILBOX       (4u)
+#endif
+
+#ifdef EN_J1939_TP
+/* J1939 TP frames to ECU address and global address from tester, PF is filtered by J1939 TP. TX by TX_RESP_ADDR_ID_MAILBOX. */
+#define J1939_RX_PHY_ID         (((uint32_t)J1939_ECU_ADDR << 8u) | J1939_TESTER_ADDR)
+#define J1939_RX_FUN_ID         (((uint32_t)0xFFu << 8u) | J1939_TESTER_ADDR)
+#define J1939_RX_ID_TYPE        FLEXCAN_MSG_ID_EXT
+#define J1939_RX_ID_MASK        0x0000FFFFu
+#define J1939_RX_PHY_ID_MAILBOX (5u)
+#define J1939_RX_FUN_ID_MAILBOX (6u)
+#endif
+
 #ifdef CAN_DRIVER_DEBUG
 #define CANDebugPrintf DebugPrintf
 #else
@@ -12,6 +12,13 @@
 #include "can_driver.h"
 #include "user_config.h"
 #include "TP.h"
+#include "can_tp_cfg.h"
+#ifdef EN_XCP_ON_CAN
+#include "xcp_cfg.h"
+#endif
+#ifdef EN_J1939_TP
+#include "J1939_tp_cfg.h"
+#endif
 
 #ifdef EN_CAN_TP
 
@@ -26,7 +33,10 @@ static void CAN_Filter_RXIndividual(void);
 static void Config_Rx_Buffer(void);
 static void Config_Tx_Buffer(void);
 static uint8_t IsRxCANMsgId(uint32_t i_usRxMsgId);
+static uint8_t IsTxCANMsgId(uint32_t i_usTxMsgId);
+static flexcan_msgbuff_id_type_t GetTxCANMsgIdType(uint32_t i_usTxMsgId);
 static void CheckCANTranmittedStatus(void);
+static void TxNextCANMsg(void);
 
 void RxCANMsgMainFun(void);
 void TransmittedCanMsgCallBack(void);
@@ -91,6 +101,52 @@ static uint8_t IsRxCANMsgId(uint32_t i_usRxMsgId)
     return FALSE;
 }
 
+static uint8_t IsTxCANMsgId(uint32_t i_usTxMsgId)
+{
+#ifdef EN_XCP_ON_CAN
+
+    /* XCP RES/ERR/EV is TX by TX mailbox too */
+    if (i_usTxMsgId == XCP_GetConfigTxMsgID())
+    {
+        return TRUE;
+    }
+
+#endif
+#ifdef EN_J1939_TP
+
+    /* J1939 TP frames are TX by TX mailbox too */
+    if (TRUE == J1939TP_IsTxMsgID(i_usTxMsgId))
+    {
+        return TRUE;
+    }
+
+#endif
+#ifdef EN_PERIODIC_DID
+
+    /* Periodic DID frames are TX by TX mailbox too */
+    if (i_usTxMsgId == CANTP_GetConfigTxPeriodicMsgID())
+    {
+        return TRUE;
+    }
+
+#endif
+    return (i_usTxMsgId == g_stTxMsgConfig.usTxID) ? TRUE : FALSE;
+}
+
+/* TX message ID type, J1939 TP frames are extended ID */
+static flexcan_msgbuff_id_type_t GetTxCANMsgIdType(uint32_t i_usTxMsgId)
+{
+#ifdef EN_J1939_TP
+
+    if (TRUE == J1939TP_IsTxMsgID(i_usTxMsgId))
+    {
+        return FLEXCAN_MSG_ID_EXT;
+    }
+
+#endif
+    return g_stTxMsgConfig.TxID_Type;
+}
+
 static void CheckCANTranmittedStatus(void)
 {
     status_t CANTxStatus;
@@ -110,6 +166,52 @@ static void CheckCANTranmittedStatus(void)
     }
 }
 
+/* CAN TX mailbox is transmitting a frame of TX BUS FIFO */
+static volatile uint8_t gs_ucIsCANTxBusy = FALSE;
+
+/* Peek next frame from CAN TP, then XCP, then J1939 TP, and TX it, called in TX complete interrupt or with interrupt disabled.
+   The frame is released from its FIFO only when the mailbox accepted it, else it is TX again by next StartTxCANMsg */
+static void TxNextCANMsg(void)
+{
+    uint8 aucMsgBuf[8u];
+    tTPTxMsgHeader stTxMsgHeader;
+
+    gs_ucIsCANTxBusy = FALSE;
+
+    if (TRUE == CANTP_DriverPeekDataFromCANTP(8u, &aucMsgBuf[0u], &stTxMsgHeader))
+    {
+        if (TRUE == TransmitCANMsg(stTxMsgHeader.TxMsgID, (uint8_t)stTxMsgHeader.TxMsgLength, aucMsgBuf, &TP_DoTxMsgSuccesfulCallback, 0u))
+        {
+            CANTP_DriverReleaseDataFromCANTP();
+            gs_ucIsCANTxBusy = TRUE;
+        }
+    }
+#ifdef EN_XCP_ON_CAN
+    else if (TRUE == XCP_DriverPeekDataFromXCP(8u, &aucMsgBuf[0u], &stTxMsgHeader))
+    {
+        if (TRUE == TransmitCANMsg(stTxMsgHeader.TxMsgID, (uint8_t)stTxMsgHeader.TxMsgLength, aucMsgBuf, &XCP_DoTxMsgSuccessfulCallBack, 0u))
+        {
+            XCP_DriverReleaseDataFromXCP();
+            gs_ucIsCANTxBusy = TRUE;
+        }
+    }
+#endif
+#ifdef EN_J1939_TP
+    else if (TRUE == J1939TP_DriverPeekDataFromJ1939TP(8u, &aucMsgBuf[0u], &stTxMsgHeader))
+    {
+        if (TRUE == TransmitCANMsg(stTxMsgHeader.TxMsgID, (uint8_t)stTxMsgHeader.TxMsgLength, aucMsgBuf, &J1939TP_DoTxMsgSuccessfulCallBack, 0u))
+        {
+            J1939TP_DriverReleaseDataFromJ1939TP();
+            gs_ucIsCANTxBusy = TRUE;
+        }
+    }
+#endif
+    else
+    {
+        /* Nothing to TX */
+    }
+}
+
 #ifdef IsUse_CAN_Pal_Driver
 static void CAN_RxTx_IRQCallback(uint32_t instance,
                                  flexcan_event_type_t eventType,
@@ -127,6 +229,7 @@ static void CAN_RxTx_IRQCallback(uint32_t instance,
 
         case CAN_EVENT_TX_COMPLETE:
             TxCANMsgMainFun();
+            TxNextCANMsg();
             break;
 
         default:
@@ -157,6 +260,7 @@ static void CAN_RxTx_IRQCallback(uint32_t instance,
 
         case FLEXCAN_EVENT_TX_COMPLETE:
             TxCANMsgMainFun();
+            TxNextCANMsg();
             break;
 
         default:
@@ -184,6 +288,14 @@ void InitCAN(void)
     Config_Tx_Buffer();
     /* Can RX individual filter */
     CAN_Filter_RXIndividual();
+    /* CAN TP starts TX when a frame is written in TX BUS FIFO */
+    CANTP_RegisterStartTxMsg(StartTxCANMsg);
+#ifdef EN_XCP_ON_CAN
+    XCP_RegisterStartTxMsg(StartTxCANMsg);
+#endif
+#ifdef EN_J1939_TP
+    J1939TP_RegisterStartTxMsg(StartTxCANMsg);
+#endif
     /* Start receiving data from CAN bus to RX_MAILBOX and Enable MBn of RX buffer interrupt */
     {
         uint32_t i = 0u;
@@ -212,6 +324,17 @@ void RxCANMsgMainFun(void)
     stRxCANMsg.ucRxDataLen = recvMsg.dataLen;
 #endif /* IsUse_CAN_Pal_Driver */
 
+#ifdef EN_J1939_TP
+
+    /* J1939 TP frame, if J1939 RX BUS FIFO is full the frame is lost and J1939 TP will timeout */
+    if ((0u != stRxCANMsg.ucRxDataLen) && (TRUE == J1939TP_IsRxMsgID(stRxCANMsg.usRxDataId)))
+    {
+        (void)J1939TP_DriverWriteDataInJ1939TP(stRxCANMsg.usRxDataId, stRxCANMsg.ucRxDataLen, recvMsg.data);
+        return;
+    }
+
+#endif
+
     if ((0u != stRxCANMsg.ucRxDataLen) &&
             (TRUE == IsRxCANMsgId(stRxCANMsg.usRxDataId)))
     {
@@ -221,6 +344,17 @@ void RxCANMsgMainFun(void)
             stRxCANMsg.aucDataBuf[CANDataIndex] = recvMsg.data[CANDataIndex];
         }
 
+#ifdef EN_XCP_ON_CAN
+
+        /* XCP CMD, if XCP RX FIFO is full the frame is lost and XCP master will timeout */
+        if (stRxCANMsg.usRxDataId == XCP_GetConfigRxMsgID())
+        {
+            (void)XCP_DriverWriteDataInXCP(stRxCANMsg.ucRxDataLen, stRxCANMsg.aucDataBuf);
+            return;
+        }
+
+#endif
+
         if (TRUE != TP_DriverWriteDataInTP(stRxCANMsg.usRxDataId, stRxCANMsg.ucRxDataLen, stRxCANMsg.aucDataBuf))
         {
             /* here is TP driver write data in TP failed, TP will lost CAN message */
@@ -236,6 +370,19 @@ void TxCANMsgMainFun(void)
     CheckCANTranmittedStatus();
 }
 
+/* Start TX CAN message if TX mailbox is idle, else TX complete interrupt TX next frame */
+void StartTxCANMsg(void)
+{
+    DisableAllInterrupts();
+
+    if (TRUE != gs_ucIsCANTxBusy)
+    {
+        TxNextCANMsg();
+    }
+
+    EnableAllInterrupts();
+}
+
 #if USE_CAN_ERRO == CAN_ERRO_INTERRUPUT
 
 #else
@@ -259,11 +406,14 @@ uint8_t TransmitCANMsg(const uint32_t i_usCANMsgID,
     can_message_t message;
     DEV_ASSERT(i_pucDataBuf != NULL);
 
-    if (i_usCANMsgID != g_stTxMsgConfig.usTxID)
+    if (TRUE != IsTxCANMsgId(i_usCANMsgID))
     {
         return FALSE;
     }
 
+    /* TX mailbox ID type is set by message ID */
+    buff_RxTx_Cfg.idType = GetTxCANMsgIdType(i_usCANMsgID);
+    CAN_ConfigTxBuff(&can_pal1_instance, g_stTxMsgConfig.ucTxMailBox, &buff_RxTx_Cfg);
     message.cs = 0u;
     message.id = i_usCANMsgID;
     message.length = i_ucDataLen;
@@ -277,11 +427,12 @@ uint8_t TransmitCANMsg(const uint32_t i_usCANMsgID,
 #else
     DEV_ASSERT(i_pucDataBuf != NULL);
 
-    if (i_usCANMsgID != g_stTxMsgConfig.usTxID)
+    if (TRUE != IsTxCANMsgId(i_usCANMsgID))
     {
         return FALSE;
     }
 
+    buff_RxTx_Cfg.msg_id_type = GetTxCANMsgIdType(i_usCANMsgID);
     CANTxStatus = FLEXCAN_DRV_Send(INST_CANCOM1, g_stTxMsgConfig.ucTxMailBox, &buff_RxTx_Cfg, i_usCANMsgID, i_pucDataBuf);
     g_stTxMsgConfig.pfCallBack = i_pfNetTxCallBack;
 #endif /* IsUse_CAN_Pal_Driver */
@@ -30,6 +30,8 @@ void RxCANMsgMainFun(void);
 
 void TxCANMsgMainFun(void);
 
+void StartTxCANMsg(void);
+
 uint8_t TransmitCANMsg(const uint32_t i_usCANMsgID,
                        const uint8_t i_ucDataLen,
                        const uint8_t *i_pucDataBuf,
@@ -0,0 +1,138 @@
+/*
+ * @ : eth_driver.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "eth_driver.h"
+#include "socket_hal.h"
+
+#ifdef EN_ETHERNET_TP
+
+static uint8_t gs_aucEthRxBuf[256u];            /* Bytes read from socket */
+static uint32_t gs_EthRxLen = 0u;               /* Bytes len in RX buffer */
+static uint32_t gs_EthRxIndex = 0u;             /* Bytes written in DoIP TP */
+static uint8_t gs_aucEthTxBuf[DOIP_MAX_MSG_LEN];/* DoIP message TX in socket */
+static uint32_t gs_EthTxLen = 0u;               /* DoIP message len, 0 is no message */
+static uint32_t gs_EthTxIndex = 0u;             /* Bytes written in socket */
+static boolean gs_isEthConnected = FALSE;       /* Socket is connected */
+static boolean gs_isEthCloseRequested = FALSE;  /* DoIP TP request close socket */
+
+static void CloseEthSocket(void);
+static void SetEthConnected(const boolean i_isConnected);
+static void RxEthMsgMainFun(void);
+static void TxEthMsgMainFun(void);
+
+/* DoIP TP request close socket, close it after DoIP messages are written in socket */
+static void CloseEthSocket(void)
+{
+    gs_isEthCloseRequested = TRUE;
+}
+
+/* Socket is connected or closed, report to DoIP TP */
+static void SetEthConnected(const boolean i_isConnected)
+{
+    gs_EthRxLen = 0u;
+    gs_EthRxIndex = 0u;
+    gs_EthTxLen = 0u;
+    gs_EthTxIndex = 0u;
+    gs_isEthCloseRequested = FALSE;
+    gs_isEthConnected = i_isConnected;
+    DoIPTP_DriverSetSocketConnected(i_isConnected);
+}
+
+/* Copy received bytes from socket in DoIP TP */
+static void RxEthMsgMainFun(void)
+{
+    uint32_t writtenLen = 0u;
+
+    for (;;)
+    {
+        if (gs_EthRxIndex == gs_EthRxLen)
+        {
+            gs_EthRxLen = SOCKET_HAL_Read(gs_aucEthRxBuf, sizeof(gs_aucEthRxBuf));
+            gs_EthRxIndex = 0u;
+
+            if (0u == gs_EthRxLen)
+            {
+                break;
+            }
+        }
+
+        writtenLen = DoIPTP_DriverWriteDataInDoIPTP(gs_EthRxLen - gs_EthRxIndex, &gs_aucEthRxBuf[gs_EthRxIndex]);
+        gs_EthRxIndex += writtenLen;
+
+        /* DoIP TP RX BUS FIFO is full, copy the left bytes next time */
+        if (gs_EthRxIndex != gs_EthRxLen)
+        {
+            break;
+        }
+    }
+}
+
+/* Write DoIP messages from DoIP TP in socket */
+static void TxEthMsgMainFun(void)
+{
+    tTPTxMsgHeader stTxMsgHeader;
+
+    for (;;)
+    {
+        if (0u == gs_EthTxLen)
+        {
+            if (TRUE != DoIPTP_DriverReadDataFromDoIPTP(sizeof(gs_aucEthTxBuf), gs_aucEthTxBuf, &stTxMsgHeader))
+            {
+                break;
+            }
+
+            gs_EthTxLen = stTxMsgHeader.TxMsgLength;
+            gs_EthTxIndex = 0u;
+        }
+
+        gs_EthTxIndex += SOCKET_HAL_Write(&gs_aucEthTxBuf[gs_EthTxIndex], gs_EthTxLen - gs_EthTxIndex);
+
+        /* Socket TX buffer is full, write the left bytes next time */
+        if (gs_EthTxIndex != gs_EthTxLen)
+        {
+            break;
+        }
+
+        gs_EthTxLen = 0u;
+        DoIPTP_DoTxMsgSuccessfulCallBack();
+    }
+}
+
+void InitEth(void)
+{
+    SOCKET_HAL_Init(DOIP_TCP_PORT);
+    DoIPTP_RegisterCloseSocket(CloseEthSocket);
+}
+
+void EthMsgMainFun(void)
+{
+    const boolean isConnected = SOCKET_HAL_IsConnected();
+
+    if (isConnected != gs_isEthConnected)
+    {
+        SetEthConnected(isConnected);
+    }
+
+    if (TRUE != gs_isEthConnected)
+    {
+        return;
+    }
+
+    RxEthMsgMainFun();
+    TxEthMsgMainFun();
+
+    if ((TRUE == gs_isEthCloseRequested) && (0u == gs_EthTxLen))
+    {
+        SOCKET_HAL_Close();
+        SetEthConnected(FALSE);
+    }
+}
+
+#endif /* EN_ETHERNET_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,25 @@
+/*
+ * @ : eth_driver.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef ETH_DRIVER_H_
+#define ETH_DRIVER_H_
+
+#include "user_config.h"
+#include "DoIP_tp.h"
+
+#ifdef EN_ETHERNET_TP
+
+void InitEth(void);
+
+void EthMsgMainFun(void);
+
+#endif /* EN_ETHERNET_TP */
+
+#endif /* ETH_DRIVER_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
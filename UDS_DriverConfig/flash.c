@@ -246,7 +246,7 @@ unsigned char ReadFlashByte(const unsigned long i_ulGloabalAddress)
 {
     unsigned char  ucReadvalue;
     /* From global address get values */
-    ucReadvalue = (*((unsigned long *)i_ulGloabalAddress));
+    ucReadvalue = (*((const unsigned char *)i_ulGloabalAddress));
     return ucReadvalue;
 }
 
@@ -261,15 +261,8 @@ void ReadFlashMemory(const unsigned long i_ulLogicalAddr,
                      const unsigned long i_ulLength,
                      unsigned char *o_pucDataBuf)
 {
-    unsigned long ulGlobalAddr;
-    unsigned long ulIndex = 0u;
-    ulGlobalAddr = i_ulLogicalAddr;
-
-    for (ulIndex = 0u; ulIndex < i_ulLength; ulIndex++)
-    {
-        o_pucDataBuf[ulIndex] = ReadFlashByte(ulGlobalAddr);
-        ulGlobalAddr++;
-    }
+    /* Logical address is global address, copy by words if it is aligned */
+    fsl_memcpy(o_pucDataBuf, (const void *)i_ulLogicalAddr, i_ulLength);
 }
 
 #ifdef FLASH_API_DEBUG
@@ -12,7 +12,7 @@
 #ifndef FLASH_CFG_H_
 #define FLASH_CFG_H_
 
-#include "cpu.h"
+#include "Cpu.h"
 
 //#define USE_FLASH_DRIVER
 
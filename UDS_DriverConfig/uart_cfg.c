@@ -0,0 +1,64 @@
+/*
+ * @ : uart_cfg.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "uart_cfg.h"
+
+#ifdef EN_UART_TP
+
+/* LPUART config of UART TP, DMA mode */
+const lpuart_user_config_t g_stUARTTPUserConfig =
+{
+    .transferType = LPUART_USING_DMA,
+    .baudRate = UART_TP_BAUD_RATE,
+    .parityMode = LPUART_PARITY_DISABLED,
+    .stopBitCount = LPUART_ONE_STOP_BIT,
+    .bitCountPerChar = LPUART_8_BITS_PER_CHAR,
+    .rxDMAChannel = UART_RX_DMA_CHANNEL,
+    .txDMAChannel = UART_TX_DMA_CHANNEL,
+};
+
+static edma_chn_state_t gs_stUARTRxDmaChnState;
+static edma_chn_state_t gs_stUARTTxDmaChnState;
+
+/* LPUART RX DMA channel, request by LPUART1 RX */
+static const edma_channel_config_t gs_stUARTRxDmaChnConfig =
+{
+    .channelPriority = EDMA_CHN_DEFAULT_PRIORITY,
+    .virtChnConfig = UART_RX_DMA_CHANNEL,
+    .source = EDMA_REQ_LPUART1_RX,
+    .callback = NULL,
+    .callbackParam = NULL,
+    .enableTrigger = false
+};
+
+/* LPUART TX DMA channel, request by LPUART1 TX */
+static const edma_channel_config_t gs_stUARTTxDmaChnConfig =
+{
+    .channelPriority = EDMA_CHN_DEFAULT_PRIORITY,
+    .virtChnConfig = UART_TX_DMA_CHANNEL,
+    .source = EDMA_REQ_LPUART1_TX,
+    .callback = NULL,
+    .callbackParam = NULL,
+    .enableTrigger = false
+};
+
+edma_chn_state_t * const g_apstUARTDmaChnState[UART_DMA_CHANNEL_NUM] =
+{
+    &gs_stUARTRxDmaChnState,
+    &gs_stUARTTxDmaChnState
+};
+
+const edma_channel_config_t * const g_apstUARTDmaChnConfig[UART_DMA_CHANNEL_NUM] =
+{
+    &gs_stUARTRxDmaChnConfig,
+    &gs_stUARTTxDmaChnConfig
+};
+
+#endif /* EN_UART_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
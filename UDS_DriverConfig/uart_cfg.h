@@ -0,0 +1,42 @@
+/*
+ * @ : uart_cfg.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef UART_CFG_H_
+#define UART_CFG_H_
+
+#include "Cpu.h"
+#include "user_config.h"
+
+#ifdef EN_UART_TP
+
+#define UART_TP_INSTANCE        (INST_LPUART1)  /* UART TP used LPUART instance */
+#define UART_TP_BASE            (LPUART1)       /* UART TP used LPUART registers */
+#define UART_RX_DMA_CHANNEL     (1u)            /* LPUART RX DMA channel, CAN RX FIFO DMA may use channel 0 */
+#define UART_TX_DMA_CHANNEL     (2u)            /* LPUART TX DMA channel */
+#define UART_DMA_CHANNEL_NUM    (2u)            /* DMA channels used by UART TP */
+
+/* RX DMA ring buffer len, power of 2. DMA write RX bytes in it circularly,
+   it should hold RX bytes between two UARTMsgMainFun at UART_TP_BAUD_RATE. */
+#define UART_RX_DMA_BUF_LEN     (1024u)
+
+#if (0u == UART_RX_DMA_BUF_LEN) || (0u != (UART_RX_DMA_BUF_LEN & (UART_RX_DMA_BUF_LEN - 1u)))
+#error "UART_RX_DMA_BUF_LEN should be power of 2"
+#endif
+
+/* LPUART config of UART TP, DMA mode */
+extern const lpuart_user_config_t g_stUARTTPUserConfig;
+
+/* DMA channel config and state of UART TP */
+extern edma_chn_state_t * const g_apstUARTDmaChnState[UART_DMA_CHANNEL_NUM];
+extern const edma_channel_config_t * const g_apstUARTDmaChnConfig[UART_DMA_CHANNEL_NUM];
+
+#endif /* EN_UART_TP */
+
+#endif /* UART_CFG_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
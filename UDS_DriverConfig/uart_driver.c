@@ -0,0 +1,116 @@
+/*
+ * @ : uart_driver.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "uart_driver.h"
+
+#ifdef EN_UART_TP
+
+static uint8_t gs_aucUARTRxDmaBuf[UART_RX_DMA_BUF_LEN];    /* RX DMA ring buffer */
+static uint32_t gs_UARTRxReadIndex = 0u;                    /* RX DMA ring buffer read index */
+static uint8_t gs_aucUARTTxBuf[UART_TP_MAX_FRAME_LEN];     /* TX DMA frame buffer */
+
+static void StartUARTRxDma(void);
+static void RxUARTMsgMainFun(void);
+static void TxUARTMsgMainFun(void);
+
+/* RX DMA write RX bytes in ring buffer circularly, never stop and no interrupt */
+static void StartUARTRxDma(void)
+{
+    (void)EDMA_DRV_ConfigMultiBlockTransfer(UART_RX_DMA_CHANNEL,
+                                            EDMA_TRANSFER_PERIPH2MEM,
+                                            (uint32_t)(&(UART_TP_BASE->DATA)),
+                                            (uint32_t)gs_aucUARTRxDmaBuf,
+                                            EDMA_TRANSFER_SIZE_1B,
+                                            1u,
+                                            UART_RX_DMA_BUF_LEN,
+                                            false);
+    /* After major loop, destination address back to ring buffer start */
+    EDMA_DRV_SetDestLastAddrAdjustment(UART_RX_DMA_CHANNEL, -(int32_t)UART_RX_DMA_BUF_LEN);
+    EDMA_DRV_ConfigureInterrupt(UART_RX_DMA_CHANNEL, EDMA_CHN_MAJOR_LOOP_INT, false);
+    EDMA_DRV_ConfigureInterrupt(UART_RX_DMA_CHANNEL, EDMA_CHN_HALF_MAJOR_LOOP_INT, false);
+    (void)EDMA_DRV_StartChannel(UART_RX_DMA_CHANNEL);
+    gs_UARTRxReadIndex = 0u;
+
+    /* Enable receiver and RX DMA request */
+    UART_TP_BASE->CTRL |= LPUART_CTRL_RE_MASK;
+    UART_TP_BASE->BAUD |= LPUART_BAUD_RDMAE_MASK;
+}
+
+/* Copy RX bytes from RX DMA ring buffer in UART TP */
+static void RxUARTMsgMainFun(void)
+{
+    uint32_t writeIndex = 0u;
+    uint32_t rxLen = 0u;
+    uint32_t writtenLen = 0u;
+
+    /* DMA write index is ring buffer len minus remaining major iterations */
+    writeIndex = (UART_RX_DMA_BUF_LEN - EDMA_DRV_GetRemainingMajorIterationsCount(UART_RX_DMA_CHANNEL)) &
+                 (UART_RX_DMA_BUF_LEN - 1u);
+
+    while (writeIndex != gs_UARTRxReadIndex)
+    {
+        /* Copy to ring buffer end at most once */
+        if (writeIndex > gs_UARTRxReadIndex)
+        {
+            rxLen = writeIndex - gs_UARTRxReadIndex;
+        }
+        else
+        {
+            rxLen = UART_RX_DMA_BUF_LEN - gs_UARTRxReadIndex;
+        }
+
+        writtenLen = UARTTP_DriverWriteDataInUARTTP(rxLen, &gs_aucUARTRxDmaBuf[gs_UARTRxReadIndex]);
+        gs_UARTRxReadIndex = (gs_UARTRxReadIndex + writtenLen) & (UART_RX_DMA_BUF_LEN - 1u);
+
+        /* UART TP RX BUS FIFO is full, copy the left bytes next time */
+        if (writtenLen < rxLen)
+        {
+            break;
+        }
+    }
+}
+
+/* TX a frame from UART TP by DMA if last frame is transmitted */
+static void TxUARTMsgMainFun(void)
+{
+    tTPTxMsgHeader stTxMsgHeader;
+
+    if (STATUS_BUSY == LPUART_DRV_GetTransmitStatus(UART_TP_INSTANCE, NULL))
+    {
+        return;
+    }
+
+    if (TRUE == UARTTP_DriverReadDataFromUARTTP(sizeof(gs_aucUARTTxBuf), gs_aucUARTTxBuf, &stTxMsgHeader))
+    {
+        (void)LPUART_DRV_SendData(UART_TP_INSTANCE, gs_aucUARTTxBuf, stTxMsgHeader.TxMsgLength);
+    }
+}
+
+void InitUART(void)
+{
+    /* Init DMA with UART TP RX and TX channels */
+    (void)EDMA_DRV_Init(&dmaController1_State,
+                        &dmaController1_InitConfig0,
+                        g_apstUARTDmaChnState,
+                        g_apstUARTDmaChnConfig,
+                        UART_DMA_CHANNEL_NUM);
+    /* Init LPUART in DMA mode, TX by LPUART_DRV_SendData */
+    (void)LPUART_DRV_Init(UART_TP_INSTANCE, &lpuart1_State, &g_stUARTTPUserConfig);
+    /* RX by ring buffer DMA, not LPUART_DRV_ReceiveData */
+    StartUARTRxDma();
+}
+
+void UARTMsgMainFun(void)
+{
+    RxUARTMsgMainFun();
+    TxUARTMsgMainFun();
+}
+
+#endif /* EN_UART_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
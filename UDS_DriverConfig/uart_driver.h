@@ -0,0 +1,25 @@
+/*
+ * @ : uart_driver.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef UART_DRIVER_H_
+#define UART_DRIVER_H_
+
+#include "uart_cfg.h"
+#include "uart_tp_cfg.h"
+
+#ifdef EN_UART_TP
+
+void InitUART(void);
+
+void UARTMsgMainFun(void);
+
+#endif /* EN_UART_TP */
+
+#endif /* UART_DRIVER_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
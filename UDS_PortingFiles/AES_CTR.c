@@ -0,0 +1,246 @@
+/*
+ * @ : AES_CTR.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "AES_CTR.h"
+
+#ifdef EN_AES_CTR_DECRYPT
+
+/*******************************************************
+**  Description : AES-128 CTR (NIST SP 800-38A) streaming encrypt/decrypt
+**
+**  Key stream block is AES(counter block), counter block is 128 bits big endian, +1 every block.
+**  Data can be split anywhere, unused key stream bytes are kept for the next call.
+**  Only AES encrypt is needed, rounds use one 1 KB T table and rotates.
+*******************************************************/
+
+#define AES_CTR_ROUNDS          (10u)   /* AES-128 rounds */
+#define AES_CTR_ROUND_KEY_NUM   (4u * (AES_CTR_ROUNDS + 1u))
+
+typedef struct
+{
+    uint32 aRoundKey[AES_CTR_ROUND_KEY_NUM];    /* Expanded key */
+    uint8 aCounter[AES_CTR_BLOCK_LEN];          /* Next counter block */
+    uint8 aKeyStream[AES_CTR_BLOCK_LEN];        /* Key stream of last counter block */
+    uint8 keyStreamPos;                         /* Used key stream bytes, AES_CTR_BLOCK_LEN is used up */
+} tAESCTRInfo;
+
+static tAESCTRInfo gs_stAESCTRInfo;
+
+static const uint8 gs_aSBox[256u] =
+{
+    0x63u, 0x7Cu, 0x77u, 0x7Bu, 0xF2u, 0x6Bu, 0x6Fu, 0xC5u, 0x30u, 0x01u, 0x67u, 0x2Bu, 0xFEu, 0xD7u, 0xABu, 0x76u,
+    0xCAu, 0x82u, 0xC9u, 0x7Du, 0xFAu, 0x59u, 0x47u, 0xF0u, 0xADu, 0xD4u, 0xA2u, 0xAFu, 0x9Cu, 0xA4u, 0x72u, 0xC0u,
+    0xB7u, 0xFDu, 0x93u, 0x26u, 0x36u, 0x3Fu, 0xF7u, 0xCCu, 0x34u, 0xA5u, 0xE5u, 0xF1u, 0x71u, 0xD8u, 0x31u, 0x15u,
+    0x04u, 0xC7u, 0x23u, 0xC3u, 0x18u, 0x96u, 0x05u, 0x9Au, 0x07u, 0x12u, 0x80u, 0xE2u, 0xEBu, 0x27u, 0xB2u, 0x75u,
+    0x09u, 0x83u, 0x2Cu, 0x1Au, 0x1Bu, 0x6Eu, 0x5Au, 0xA0u, 0x52u, 0x3Bu, 0xD6u, 0xB3u, 0x29u, 0xE3u, 0x2Fu, 0x84u,
+    0x53u, 0xD1u, 0x00u, 0xEDu, 0x20u, 0xFCu, 0xB1u, 0x5Bu, 0x6Au, 0xCBu, 0xBEu, 0x39u, 0x4Au, 0x4Cu, 0x58u, 0xCFu,
+    0xD0u, 0xEFu, 0xAAu, 0xFBu, 0x43u, 0x4Du, 0x33u, 0x85u, 0x45u, 0xF9u, 0x02u, 0x7Fu, 0x50u, 0x3Cu, 0x9Fu, 0xA8u,
+    0x51u, 0xA3u, 0x40u, 0x8Fu, 0x92u, 0x9Du, 0x38u, 0xF5u, 0xBCu, 0xB6u, 0xDAu, 0x21u, 0x10u, 0xFFu, 0xF3u, 0xD2u,
+    0xCDu, 0x0Cu, 0x13u, 0xECu, 0x5Fu, 0x97u, 0x44u, 0x17u, 0xC4u, 0xA7u, 0x7Eu, 0x3Du, 0x64u, 0x5Du, 0x19u, 0x73u,
+    0x60u, 0x81u, 0x4Fu, 0xDCu, 0x22u, 0x2Au, 0x90u, 0x88u, 0x46u, 0xEEu, 0xB8u, 0x14u, 0xDEu, 0x5Eu, 0x0Bu, 0xDBu,
+    0xE0u, 0x32u, 0x3Au, 0x0Au, 0x49u, 0x06u, 0x24u, 0x5Cu, 0xC2u, 0xD3u, 0xACu, 0x62u, 0x91u, 0x95u, 0xE4u, 0x79u,
+    0xE7u, 0xC8u, 0x37u, 0x6Du, 0x8Du, 0xD5u, 0x4Eu, 0xA9u, 0x6Cu, 0x56u, 0xF4u, 0xEAu, 0x65u, 0x7Au, 0xAEu, 0x08u,
+    0xBAu, 0x78u, 0x25u, 0x2Eu, 0x1Cu, 0xA6u, 0xB4u, 0xC6u, 0xE8u, 0xDDu, 0x74u, 0x1Fu, 0x4Bu, 0xBDu, 0x8Bu, 0x8Au,
+    0x70u, 0x3Eu, 0xB5u, 0x66u, 0x48u, 0x03u, 0xF6u, 0x0Eu, 0x61u, 0x35u, 0x57u, 0xB9u, 0x86u, 0xC1u, 0x1Du, 0x9Eu,
+    0xE1u, 0xF8u, 0x98u, 0x11u, 0x69u, 0xD9u, 0x8Eu, 0x94u, 0x9Bu, 0x1Eu, 0x87u, 0xE9u, 0xCEu, 0x55u, 0x28u, 0xDFu,
+    0x8Cu, 0xA1u, 0x89u, 0x0Du, 0xBFu, 0xE6u, 0x42u, 0x68u, 0x41u, 0x99u, 0x2Du, 0x0Fu, 0xB0u, 0x54u, 0xBBu, 0x16u
+};
+
+/* Te0[x] = {02}S[x], S[x], S[x], {03}S[x] */
+static const uint32 gs_aTe0[256u] =
+{
+    0xC66363A5u, 0xF87C7C84u, 0xEE777799u, 0xF67B7B8Du, 0xFFF2F20Du, 0xD66B6BBDu,
+    0xDE6F6FB1u, 0x91C5C554u, 0x60303050u, 0x02010103u, 0xCE6767A9u, 0x562B2B7Du,
+    0xE7FEFE19u, 0xB5D7D762u, 0x4DABABE6u, 0xEC76769Au, 0x8FCACA45u, 0x1F82829Du,
+    0x89C9C940u, 0xFA7D7D87u, 0xEFFAFA15u, 0xB25959EBu, 0x8E4747C9u, 0xFBF0F00Bu,
+    0x41ADADECu, 0xB3D4D467u, 0x5FA2A2FDu, 0x45AFAFEAu, 0x239C9CBFu, 0x53A4A4F7u,
+    0xE4727296u, 0x9BC0C05Bu, 0x75B7B7C2u, 0xE1FDFD1Cu, 0x3D9393AEu, 0x4C26266Au,
+    0x6C36365Au, 0x7E3F3F41u, 0xF5F7F702u, 0x83CCCC4Fu, 0x6834345Cu, 0x51A5A5F4u,
+    0xD1E5E534u, 0xF9F1F108u, 0xE2717193u, 0xABD8D873u, 0x62313153u, 0x2A15153Fu,
+    0x0804040Cu, 0x95C7C752u, 0x46232365u, 0x9DC3C35Eu, 0x30181828u, 0x379696A1u,
+    0x0A05050Fu, 0x2F9A9AB5u, 0x0E070709u, 0x24121236u, 0x1B80809Bu, 0xDFE2E23Du,
+    0xCDEBEB26u, 0x4E272769u, 0x7FB2B2CDu, 0xEA75759Fu, 0x1209091Bu, 0x1D83839Eu,
+    0x582C2C74u, 0x341A1A2Eu, 0x361B1B2Du, 0xDC6E6EB2u, 0xB45A5AEEu, 0x5BA0A0FBu,
+    0xA45252F6u, 0x763B3B4Du, 0xB7D6D661u, 0x7DB3B3CEu, 0x5229297Bu, 0xDDE3E33Eu,
+    0x5E2F2F71u, 0x13848497u, 0xA65353F5u, 0xB9D1D168u, 0x00000000u, 0xC1EDED2Cu,
+    0x40202060u, 0xE3FCFC1Fu, 0x79B1B1C8u, 0xB65B5BEDu, 0xD46A6ABEu, 0x8DCBCB46u,
+    0x67BEBED9u, 0x7239394Bu, 0x944A4ADEu, 0x984C4CD4u, 0xB05858E8u, 0x85CFCF4Au,
+    0xBBD0D06Bu, 0xC5EFEF2Au, 0x4FAAAAE5u, 0xEDFBFB16u, 0x864343C5u, 0x9A4D4DD7u,
+    0x66333355u, 0x11858594u, 0x8A4545CFu, 0xE9F9F910u, 0x04020206u, 0xFE7F7F81u,
+    0xA05050F0u, 0x783C3C44u, 0x259F9FBAu, 0x4BA8A8E3u, 0xA25151F3u, 0x5DA3A3FEu,
+    0x804040C0u, 0x058F8F8Au, 0x3F9292ADu, 0x219D9DBCu, 0x70383848u, 0xF1F5F504u,
+    0x63BCBCDFu, 0x77B6B6C1u, 0xAFDADA75u, 0x42212163u, 0x20101030u, 0xE5FFFF1Au,
+    0xFDF3F30Eu, 0xBFD2D26Du, 0x81CDCD4Cu, 0x180C0C14u, 0x26131335u, 0xC3ECEC2Fu,
+    0xBE5F5FE1u, 0x359797A2u, 0x884444CCu, 0x2E171739u, 0x93C4C457u, 0x55A7A7F2u,
+    0xFC7E7E82u, 0x7A3D3D47u, 0xC86464ACu, 0xBA5D5DE7u, 0x3219192Bu, 0xE6737395u,
+    0xC06060A0u, 0x19818198u, 0x9E4F4FD1u, 0xA3DCDC7Fu, 0x44222266u, 0x542A2A7Eu,
+    0x3B9090ABu, 0x0B888883u, 0x8C4646CAu, 0xC7EEEE29u, 0x6BB8B8D3u, 0x2814143Cu,
+    0xA7DEDE79u, 0xBC5E5EE2u, 0x160B0B1Du, 0xADDBDB76u, 0xDBE0E03Bu, 0x64323256u,
+    0x743A3A4Eu, 0x140A0A1Eu, 0x924949DBu, 0x0C06060Au, 0x4824246Cu, 0xB85C5CE4u,
+    0x9FC2C25Du, 0xBDD3D36Eu, 0x43ACACEFu, 0xC46262A6u, 0x399191A8u, 0x319595A4u,
+    0xD3E4E437u, 0xF279798Bu, 0xD5E7E732u, 0x8BC8C843u, 0x6E373759u, 0xDA6D6DB7u,
+    0x018D8D8Cu, 0xB1D5D564u, 0x9C4E4ED2u, 0x49A9A9E0u, 0xD86C6CB4u, 0xAC5656FAu,
+    0xF3F4F407u, 0xCFEAEA25u, 0xCA6565AFu, 0xF47A7A8Eu, 0x47AEAEE9u, 0x10080818u,
+    0x6FBABAD5u, 0xF0787888u, 0x4A25256Fu, 0x5C2E2E72u, 0x381C1C24u, 0x57A6A6F1u,
+    0x73B4B4C7u, 0x97C6C651u, 0xCBE8E823u, 0xA1DDDD7Cu, 0xE874749Cu, 0x3E1F1F21u,
+    0x964B4BDDu, 0x61BDBDDCu, 0x0D8B8B86u, 0x0F8A8A85u, 0xE0707090u, 0x7C3E3E42u,
+    0x71B5B5C4u, 0xCC6666AAu, 0x904848D8u, 0x06030305u, 0xF7F6F601u, 0x1C0E0E12u,
+    0xC26161A3u, 0x6A35355Fu, 0xAE5757F9u, 0x69B9B9D0u, 0x17868691u, 0x99C1C158u,
+    0x3A1D1D27u, 0x279E9EB9u, 0xD9E1E138u, 0xEBF8F813u, 0x2B9898B3u, 0x22111133u,
+    0xD26969BBu, 0xA9D9D970u, 0x078E8E89u, 0x339494A7u, 0x2D9B9BB6u, 0x3C1E1E22u,
+    0x15878792u, 0xC9E9E920u, 0x87CECE49u, 0xAA5555FFu, 0x50282878u, 0xA5DFDF7Au,
+    0x038C8C8Fu, 0x59A1A1F8u, 0x09898980u, 0x1A0D0D17u, 0x65BFBFDAu, 0xD7E6E631u,
+    0x844242C6u, 0xD06868B8u, 0x824141C3u, 0x299999B0u, 0x5A2D2D77u, 0x1E0F0F11u,
+    0x7BB0B0CBu, 0xA85454FCu, 0x6DBBBBD6u, 0x2C16163Au
+};
+
+/* Key expansion round constants */
+static const uint8 gs_aRcon[AES_CTR_ROUNDS] =
+{
+    0x01u, 0x02u, 0x04u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0x1Bu, 0x36u
+};
+
+#define AES_CTR_GetU32(pBuf) \
+    (((uint32)(pBuf)[0u] << 24u) | ((uint32)(pBuf)[1u] << 16u) | ((uint32)(pBuf)[2u] << 8u) | (uint32)(pBuf)[3u])
+
+#define AES_CTR_PutU32(pBuf, xValue) \
+    do{\
+        (pBuf)[0u] = (uint8)((xValue) >> 24u);\
+        (pBuf)[1u] = (uint8)((xValue) >> 16u);\
+        (pBuf)[2u] = (uint8)((xValue) >> 8u);\
+        (pBuf)[3u] = (uint8)(xValue);\
+    }while(0u)
+
+#define AES_CTR_ROR(xValue, bits) (((xValue) >> (bits)) | ((xValue) << (32u - (bits))))
+
+/* One round column, Te1 ~ Te3 are Te0 rotated */
+#define AES_CTR_Round(s0, s1, s2, s3, rk) \
+    (gs_aTe0[(s0) >> 24u] ^ \
+     AES_CTR_ROR(gs_aTe0[((s1) >> 16u) & 0xFFu], 8u) ^ \
+     AES_CTR_ROR(gs_aTe0[((s2) >> 8u) & 0xFFu], 16u) ^ \
+     AES_CTR_ROR(gs_aTe0[(s3) & 0xFFu], 24u) ^ (rk))
+
+/* Last round column, no MixColumns */
+#define AES_CTR_FinalRound(s0, s1, s2, s3, rk) \
+    (((uint32)gs_aSBox[(s0) >> 24u] << 24u) ^ \
+     ((uint32)gs_aSBox[((s1) >> 16u) & 0xFFu] << 16u) ^ \
+     ((uint32)gs_aSBox[((s2) >> 8u) & 0xFFu] << 8u) ^ \
+     (uint32)gs_aSBox[(s3) & 0xFFu] ^ (rk))
+
+/* Encrypt a block */
+static void AES_CTR_EncryptBlock(const uint8 *i_pInBlock, uint8 *o_pOutBlock)
+{
+    const uint32 *pRoundKey = gs_stAESCTRInfo.aRoundKey;
+    uint32 s0 = AES_CTR_GetU32(&i_pInBlock[0u]) ^ pRoundKey[0u];
+    uint32 s1 = AES_CTR_GetU32(&i_pInBlock[4u]) ^ pRoundKey[1u];
+    uint32 s2 = AES_CTR_GetU32(&i_pInBlock[8u]) ^ pRoundKey[2u];
+    uint32 s3 = AES_CTR_GetU32(&i_pInBlock[12u]) ^ pRoundKey[3u];
+    uint32 t0 = 0u;
+    uint32 t1 = 0u;
+    uint32 t2 = 0u;
+    uint32 t3 = 0u;
+    uint8 round = 0u;
+
+    for (round = 1u; round < AES_CTR_ROUNDS; round++)
+    {
+        pRoundKey += 4u;
+        t0 = AES_CTR_Round(s0, s1, s2, s3, pRoundKey[0u]);
+        t1 = AES_CTR_Round(s1, s2, s3, s0, pRoundKey[1u]);
+        t2 = AES_CTR_Round(s2, s3, s0, s1, pRoundKey[2u]);
+        t3 = AES_CTR_Round(s3, s0, s1, s2, pRoundKey[3u]);
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+
+    pRoundKey += 4u;
+    t0 = AES_CTR_FinalRound(s0, s1, s2, s3, pRoundKey[0u]);
+    t1 = AES_CTR_FinalRound(s1, s2, s3, s0, pRoundKey[1u]);
+    t2 = AES_CTR_FinalRound(s2, s3, s0, s1, pRoundKey[2u]);
+    t3 = AES_CTR_FinalRound(s3, s0, s1, s2, pRoundKey[3u]);
+    AES_CTR_PutU32(&o_pOutBlock[0u], t0);
+    AES_CTR_PutU32(&o_pOutBlock[4u], t1);
+    AES_CTR_PutU32(&o_pOutBlock[8u], t2);
+    AES_CTR_PutU32(&o_pOutBlock[12u], t3);
+}
+
+/* Init key and initial counter block, the key is expanded and not saved */
+void AES_CTR_Init(const uint8 *i_pKey, const uint8 *i_pIV)
+{
+    uint8 index = 0u;
+    uint32 temp = 0u;
+    uint32 *pRoundKey = gs_stAESCTRInfo.aRoundKey;
+    ASSERT(NULL_PTR == i_pKey);
+    ASSERT(NULL_PTR == i_pIV);
+
+    for (index = 0u; index < 4u; index++)
+    {
+        pRoundKey[index] = AES_CTR_GetU32(&i_pKey[4u * index]);
+    }
+
+    for (index = 4u; index < AES_CTR_ROUND_KEY_NUM; index++)
+    {
+        temp = pRoundKey[index - 1u];
+
+        if (0u == (index & 3u))
+        {
+            /* SubWord(RotWord(temp)) ^ Rcon */
+            temp = ((uint32)gs_aSBox[(temp >> 16u) & 0xFFu] << 24u) ^
+                   ((uint32)gs_aSBox[(temp >> 8u) & 0xFFu] << 16u) ^
+                   ((uint32)gs_aSBox[temp & 0xFFu] << 8u) ^
+                   (uint32)gs_aSBox[temp >> 24u] ^
+                   ((uint32)gs_aRcon[(index >> 2u) - 1u] << 24u);
+        }
+
+        pRoundKey[index] = pRoundKey[index - 4u] ^ temp;
+    }
+
+    fsl_memcpy(gs_stAESCTRInfo.aCounter, i_pIV, AES_CTR_BLOCK_LEN);
+    gs_stAESCTRInfo.keyStreamPos = AES_CTR_BLOCK_LEN;
+}
+
+/* Encrypt or decrypt data in place */
+void AES_CTR_Crypt(uint8 *m_pDataBuf, const uint32 i_dataLen)
+{
+    uint32 index = 0u;
+    uint8 counterIndex = 0u;
+    ASSERT(NULL_PTR == m_pDataBuf);
+
+    for (index = 0u; index < i_dataLen; index++)
+    {
+        if (AES_CTR_BLOCK_LEN <= gs_stAESCTRInfo.keyStreamPos)
+        {
+            AES_CTR_EncryptBlock(gs_stAESCTRInfo.aCounter, gs_stAESCTRInfo.aKeyStream);
+            gs_stAESCTRInfo.keyStreamPos = 0u;
+
+            /* Counter block + 1, big endian */
+            counterIndex = AES_CTR_BLOCK_LEN;
+
+            do
+            {
+                counterIndex--;
+                gs_stAESCTRInfo.aCounter[counterIndex]++;
+            } while ((0u == gs_stAESCTRInfo.aCounter[counterIndex]) && (0u != counterIndex));
+        }
+
+        m_pDataBuf[index] ^= gs_stAESCTRInfo.aKeyStream[gs_stAESCTRInfo.keyStreamPos];
+        gs_stAESCTRInfo.keyStreamPos++;
+    }
+}
+
+/* Clear expanded key and key stream */
+void AES_CTR_Deinit(void)
+{
+    fsl_memset(&gs_stAESCTRInfo, 0x0u, sizeof(gs_stAESCTRInfo));
+    gs_stAESCTRInfo.keyStreamPos = AES_CTR_BLOCK_LEN;
+}
+
+#endif /* EN_AES_CTR_DECRYPT */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,32 @@
+/*
+ * @ : AES_CTR.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef AES_CTR_H_
+#define AES_CTR_H_
+
+#include "includes.h"
+
+#ifdef EN_AES_CTR_DECRYPT
+
+/* encryptingMethod of RequestDownload dataFormatIdentifier */
+#define AES_CTR_ENCRYPTING_METHOD   (1u)
+
+#define AES_CTR_KEY_LEN             (16u)   /* AES-128 key len */
+#define AES_CTR_BLOCK_LEN           (16u)   /* AES block len, IV (initial counter block) len */
+
+void AES_CTR_Init(const uint8 *i_pKey, const uint8 *i_pIV);
+
+void AES_CTR_Crypt(uint8 *m_pDataBuf, const uint32 i_dataLen);
+
+void AES_CTR_Deinit(void);
+
+#endif /* EN_AES_CTR_DECRYPT */
+
+#endif /* AES_CTR_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
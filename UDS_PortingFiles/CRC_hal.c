@@ -12,7 +12,7 @@
 #include "CRC_hal.h"
 
 #ifdef EN_CRC_HARDWARE
-#include "cpu.h"
+#include "Cpu.h"
 #include "crc_cfg.h"
 #endif
 
@@ -0,0 +1,348 @@
+/*
+ * @ : Delta.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "Delta.h"
+
+#ifdef EN_DELTA_UPDATE
+
+/*******************************************************
+**  Description : Delta patch streaming decoder, bsdiff like patch for small RAM
+**
+**  Header: 'D' 'P' version.
+**  Records until new image is rebuilt:
+**      copyLen (varint), addLen (varint), extraLen (varint), seek (zigzag varint),
+**      copyLen bytes without patch data: new = old[oldPos++],
+**      addLen diff bytes: new = old[oldPos++] + diff,
+**      extraLen bytes: new = extra,
+**      oldPos += seek.
+**  Varint is LEB128, 7 bits a byte and LSB first, bit 7 is set if more bytes follow.
+**  Old image is read in place (memory mapped flash), no old data is copied in RAM.
+**  Old data below low limit may be overwritten already, patch reads it is invalid.
+**  Decoder keeps its state between calls, input and output can be split anywhere.
+**  Copy bytes need no input, call decoder again while Delta_IsCopyPending even if input is used up.
+*******************************************************/
+
+/* Max bytes of a uint32 varint */
+#define DELTA_VARINT_MAX_LEN (5u)
+
+typedef enum
+{
+    DELTA_HEADER_STEP,      /* Wait header */
+    DELTA_COPY_LEN_STEP,    /* Wait copyLen */
+    DELTA_ADD_LEN_STEP,     /* Wait addLen */
+    DELTA_EXTRA_LEN_STEP,   /* Wait extraLen */
+    DELTA_SEEK_STEP,        /* Wait seek */
+    DELTA_COPY_STEP,        /* Copy old data */
+    DELTA_ADD_STEP,         /* Add diff bytes to old data */
+    DELTA_EXTRA_STEP,       /* Copy extra bytes */
+    DELTA_ERROR_STEP        /* Patch is invalid */
+} tDeltaDecodeStep;
+
+typedef struct
+{
+    const uint8 *pOldImage;     /* Old image */
+    uint32 oldLen;              /* Old image len */
+    uint32 oldLowLimit;         /* Old data below it is invalid */
+    uint32 oldPos;              /* Next old data position */
+    uint32 copyLen;             /* Remain copy bytes of record */
+    uint32 addLen;              /* Remain diff bytes of record */
+    uint32 extraLen;            /* Remain extra bytes of record */
+    uint32 zigzagSeek;          /* Seek of record, done after the diff and extra bytes */
+    uint32 varint;              /* Decoding varint */
+    uint8 varintLen;            /* Decoded bytes of varint, header bytes in header step */
+    tDeltaDecodeStep eStep;     /* Decode step */
+} tDeltaDecodeInfo;
+
+static tDeltaDecodeInfo gs_stDeltaDecodeInfo;
+
+/* Decode a byte of varint, return TRUE if the varint is finished */
+static boolean Delta_DecodeVarint(const uint8 i_data);
+
+/* Move old data position by zigzag seek, return FALSE if the position is out of range */
+static boolean Delta_SeekOldPos(const uint32 i_zigzagSeek);
+
+/* Record is done if no copy, diff and extra bytes remain, then do its seek and wait next record */
+static void Delta_EndRecordIfDone(void);
+
+/* First step of record data: copy, add or extra */
+static void Delta_StartRecordData(void);
+
+/* Init decoder for a new patch, old image is the installed image read by patch */
+void Delta_Init(const uint8 *i_pOldImage, const uint32 i_oldLen)
+{
+    ASSERT(NULL_PTR == i_pOldImage);
+
+    fsl_memset(&gs_stDeltaDecodeInfo, 0x0u, sizeof(gs_stDeltaDecodeInfo));
+    gs_stDeltaDecodeInfo.pOldImage = i_pOldImage;
+    gs_stDeltaDecodeInfo.oldLen = i_oldLen;
+    gs_stDeltaDecodeInfo.eStep = DELTA_HEADER_STEP;
+}
+
+/* Old data below i_oldPos is overwritten, e.g. sector staged update in place */
+void Delta_SetOldLowLimit(const uint32 i_oldPos)
+{
+    gs_stDeltaDecodeInfo.oldLowLimit = i_oldPos;
+}
+
+/* Decode patch to new image until input is used up or output is full. Return FALSE if patch is invalid. */
+boolean Delta_Decode(const uint8 *i_pInBuf,
+                     const uint32 i_inLen,
+                     uint32 *o_pInUsedLen,
+                     uint8 *o_pOutBuf,
+                     const uint32 i_outLen,
+                     uint32 *o_pOutLen)
+{
+    uint32 inPos = 0u;
+    uint32 outPos = 0u;
+    uint32 copyLen = 0u;
+    tDeltaDecodeInfo *pstDelta = &gs_stDeltaDecodeInfo;
+    ASSERT(NULL_PTR == i_pInBuf);
+    ASSERT(NULL_PTR == o_pInUsedLen);
+    ASSERT(NULL_PTR == o_pOutBuf);
+    ASSERT(NULL_PTR == o_pOutLen);
+
+    /* Every step uses input except copy, copy, diff and extra bytes need output */
+    while (((inPos < i_inLen) || (DELTA_COPY_STEP == pstDelta->eStep)) && (DELTA_ERROR_STEP != pstDelta->eStep))
+    {
+        if (((DELTA_COPY_STEP == pstDelta->eStep) || (DELTA_ADD_STEP == pstDelta->eStep) ||
+                (DELTA_EXTRA_STEP == pstDelta->eStep)) && (outPos >= i_outLen))
+        {
+            break;
+        }
+
+        switch (pstDelta->eStep)
+        {
+            case DELTA_HEADER_STEP:
+                if (((0u == pstDelta->varintLen) && (DELTA_PATCH_MAGIC_0 != i_pInBuf[inPos])) ||
+                        ((1u == pstDelta->varintLen) && (DELTA_PATCH_MAGIC_1 != i_pInBuf[inPos])) ||
+                        ((2u == pstDelta->varintLen) && (DELTA_PATCH_VERSION != i_pInBuf[inPos])))
+                {
+                    pstDelta->eStep = DELTA_ERROR_STEP;
+                    break;
+                }
+
+                inPos++;
+                pstDelta->varintLen++;
+
+                if (DELTA_PATCH_HEADER_LEN == pstDelta->varintLen)
+                {
+                    pstDelta->varintLen = 0u;
+                    pstDelta->eStep = DELTA_COPY_LEN_STEP;
+                }
+
+                break;
+
+            case DELTA_COPY_LEN_STEP:
+                if (TRUE == Delta_DecodeVarint(i_pInBuf[inPos]))
+                {
+                    pstDelta->copyLen = pstDelta->varint;
+                    pstDelta->eStep = DELTA_ADD_LEN_STEP;
+                }
+
+                inPos++;
+                break;
+
+            case DELTA_ADD_LEN_STEP:
+                if (TRUE == Delta_DecodeVarint(i_pInBuf[inPos]))
+                {
+                    pstDelta->addLen = pstDelta->varint;
+                    pstDelta->eStep = DELTA_EXTRA_LEN_STEP;
+                }
+
+                inPos++;
+                break;
+
+            case DELTA_EXTRA_LEN_STEP:
+                if (TRUE == Delta_DecodeVarint(i_pInBuf[inPos]))
+                {
+                    pstDelta->extraLen = pstDelta->varint;
+                    pstDelta->eStep = DELTA_SEEK_STEP;
+                }
+
+                inPos++;
+                break;
+
+            case DELTA_SEEK_STEP:
+                if (TRUE == Delta_DecodeVarint(i_pInBuf[inPos]))
+                {
+                    /* Seek is done after the copy, diff and extra bytes of record */
+                    pstDelta->zigzagSeek = pstDelta->varint;
+                    Delta_StartRecordData();
+                }
+
+                inPos++;
+                break;
+
+            case DELTA_COPY_STEP:
+                copyLen = (pstDelta->copyLen < (i_outLen - outPos)) ? pstDelta->copyLen : (i_outLen - outPos);
+
+                if ((pstDelta->oldPos < pstDelta->oldLowLimit) || (copyLen > (pstDelta->oldLen - pstDelta->oldPos)))
+                {
+                    pstDelta->eStep = DELTA_ERROR_STEP;
+                    break;
+                }
+
+                fsl_memcpy(&o_pOutBuf[outPos], &pstDelta->pOldImage[pstDelta->oldPos], copyLen);
+                outPos += copyLen;
+                pstDelta->oldPos += copyLen;
+                pstDelta->copyLen -= copyLen;
+
+                if (0u == pstDelta->copyLen)
+                {
+                    Delta_StartRecordData();
+                }
+
+                break;
+
+            case DELTA_ADD_STEP:
+                copyLen = (pstDelta->addLen < (i_outLen - outPos)) ? pstDelta->addLen : (i_outLen - outPos);
+                copyLen = (copyLen < (i_inLen - inPos)) ? copyLen : (i_inLen - inPos);
+
+                if ((pstDelta->oldPos < pstDelta->oldLowLimit) || (copyLen > (pstDelta->oldLen - pstDelta->oldPos)))
+                {
+                    pstDelta->eStep = DELTA_ERROR_STEP;
+                    break;
+                }
+
+                pstDelta->addLen -= copyLen;
+
+                while (0u != copyLen)
+                {
+                    o_pOutBuf[outPos] = (uint8)(pstDelta->pOldImage[pstDelta->oldPos] + i_pInBuf[inPos]);
+                    outPos++;
+                    inPos++;
+                    pstDelta->oldPos++;
+                    copyLen--;
+                }
+
+                if (0u == pstDelta->addLen)
+                {
+                    pstDelta->eStep = DELTA_EXTRA_STEP;
+                    Delta_EndRecordIfDone();
+                }
+
+                break;
+
+            case DELTA_EXTRA_STEP:
+                copyLen = (pstDelta->extraLen < (i_outLen - outPos)) ? pstDelta->extraLen : (i_outLen - outPos);
+                copyLen = (copyLen < (i_inLen - inPos)) ? copyLen : (i_inLen - inPos);
+                fsl_memcpy(&o_pOutBuf[outPos], &i_pInBuf[inPos], copyLen);
+                outPos += copyLen;
+                inPos += copyLen;
+                pstDelta->extraLen -= copyLen;
+                Delta_EndRecordIfDone();
+                break;
+
+            default:
+                pstDelta->eStep = DELTA_ERROR_STEP;
+                break;
+        }
+    }
+
+    *o_pInUsedLen = inPos;
+    *o_pOutLen = outPos;
+    return (DELTA_ERROR_STEP != pstDelta->eStep) ? TRUE : FALSE;
+}
+
+/* Copy bytes of record remain, they are rebuilt without more input */
+boolean Delta_IsCopyPending(void)
+{
+    return (DELTA_COPY_STEP == gs_stDeltaDecodeInfo.eStep) ? TRUE : FALSE;
+}
+
+/* Decode a byte of varint, return TRUE if the varint is finished */
+static boolean Delta_DecodeVarint(const uint8 i_data)
+{
+    tDeltaDecodeInfo *pstDelta = &gs_stDeltaDecodeInfo;
+
+    if (0u == pstDelta->varintLen)
+    {
+        pstDelta->varint = 0u;
+    }
+
+    /* More than 32 bits */
+    if ((pstDelta->varintLen >= DELTA_VARINT_MAX_LEN) ||
+            (((DELTA_VARINT_MAX_LEN - 1u) == pstDelta->varintLen) && (i_data > 0x0Fu)))
+    {
+        pstDelta->eStep = DELTA_ERROR_STEP;
+        return FALSE;
+    }
+
+    pstDelta->varint |= (uint32)(i_data & 0x7Fu) << (7u * pstDelta->varintLen);
+    pstDelta->varintLen++;
+
+    if (0u != (i_data & 0x80u))
+    {
+        return FALSE;
+    }
+
+    pstDelta->varintLen = 0u;
+    return TRUE;
+}
+
+/* Move old data position by zigzag seek, return FALSE if the position is out of range */
+static boolean Delta_SeekOldPos(const uint32 i_zigzagSeek)
+{
+    uint32 seekLen = i_zigzagSeek >> 1u;
+    tDeltaDecodeInfo *pstDelta = &gs_stDeltaDecodeInfo;
+
+    if (0u != (i_zigzagSeek & 0x01u))
+    {
+        /* Backward (seekLen + 1) bytes */
+        if (seekLen >= pstDelta->oldPos)
+        {
+            return FALSE;
+        }
+
+        pstDelta->oldPos -= seekLen + 1u;
+    }
+    else
+    {
+        if (seekLen > (pstDelta->oldLen - pstDelta->oldPos))
+        {
+            return FALSE;
+        }
+
+        pstDelta->oldPos += seekLen;
+    }
+
+    return TRUE;
+}
+
+/* Record is done if no copy, diff and extra bytes remain, then do its seek and wait next record */
+static void Delta_EndRecordIfDone(void)
+{
+    tDeltaDecodeInfo *pstDelta = &gs_stDeltaDecodeInfo;
+
+    if ((0u != pstDelta->copyLen) || (0u != pstDelta->addLen) || (0u != pstDelta->extraLen))
+    {
+        return;
+    }
+
+    pstDelta->eStep = (TRUE == Delta_SeekOldPos(pstDelta->zigzagSeek)) ? DELTA_COPY_LEN_STEP : DELTA_ERROR_STEP;
+}
+
+/* First step of record data: copy, add or extra */
+static void Delta_StartRecordData(void)
+{
+    tDeltaDecodeInfo *pstDelta = &gs_stDeltaDecodeInfo;
+
+    if (0u != pstDelta->copyLen)
+    {
+        pstDelta->eStep = DELTA_COPY_STEP;
+    }
+    else
+    {
+        pstDelta->eStep = (0u != pstDelta->addLen) ? DELTA_ADD_STEP : DELTA_EXTRA_STEP;
+        Delta_EndRecordIfDone();
+    }
+}
+
+#endif /* EN_DELTA_UPDATE */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
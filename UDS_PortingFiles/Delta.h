@@ -0,0 +1,45 @@
+/*
+ * @ : Delta.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef DELTA_H_
+#define DELTA_H_
+
+#include "includes.h"
+
+#ifdef EN_DELTA_UPDATE
+
+#ifndef EN_LZSS_DECOMPRESS
+#error "EN_DELTA_UPDATE needs EN_LZSS_DECOMPRESS, delta patch is LZSS compressed"
+#endif
+
+/* compressionMethod of RequestDownload dataFormatIdentifier: LZSS compressed delta patch */
+#define DELTA_COMPRESSION_METHOD (2u)
+
+#define DELTA_PATCH_MAGIC_0      (0x44u)     /* 'D' */
+#define DELTA_PATCH_MAGIC_1      (0x50u)     /* 'P' */
+#define DELTA_PATCH_VERSION      (2u)        /* Patch format version, 2 has copy bytes in record */
+#define DELTA_PATCH_HEADER_LEN   (3u)        /* Magic + version */
+
+void Delta_Init(const uint8 *i_pOldImage, const uint32 i_oldLen);
+
+void Delta_SetOldLowLimit(const uint32 i_oldPos);
+
+boolean Delta_Decode(const uint8 *i_pInBuf,
+                     const uint32 i_inLen,
+                     uint32 *o_pInUsedLen,
+                     uint8 *o_pOutBuf,
+                     const uint32 i_outLen,
+                     uint32 *o_pOutLen);
+
+boolean Delta_IsCopyPending(void);
+
+#endif /* EN_DELTA_UPDATE */
+
+#endif /* DELTA_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
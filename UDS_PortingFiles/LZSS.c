@@ -0,0 +1,171 @@
+/*
+ * @ : LZSS.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "LZSS.h"
+
+#ifdef EN_LZSS_DECOMPRESS
+
+/*******************************************************
+**  Description : LZSS streaming decoder, heatshrink like bit stream (MSB first)
+**
+**  1 + 8 bits: literal byte.
+**  0 + LZSS_WINDOW_BITS index + LZSS_LOOKAHEAD_BITS count:
+**      copy (count + LZSS_MIN_MATCH_LEN) bytes from (index + 1) bytes back in window.
+**  Window is 0 at start. Last byte is padded with 0 bits, the partial back reference is not decoded.
+**  Decoder keeps its state between calls, input and output can be split anywhere.
+*******************************************************/
+
+typedef enum
+{
+    LZSS_TAG_STEP,          /* Wait tag bit */
+    LZSS_LITERAL_STEP,      /* Wait literal byte */
+    LZSS_BACKREF_STEP,      /* Wait back reference index and count */
+    LZSS_COPY_STEP          /* Copy back reference */
+} tLZSSDecodeStep;
+
+typedef struct
+{
+    uint32 bitBuf;                      /* Input bits, low bitCnt bits are not decoded */
+    uint8 bitCnt;                       /* Not decoded bits count */
+    tLZSSDecodeStep eStep;              /* Decode step */
+    uint16 backrefIndex;                /* Back reference index, copy from (index + 1) bytes back */
+    uint16 copyLen;                     /* Back reference remain copy len */
+    uint16 windowHead;                  /* Next window write position */
+    uint8 aWindow[LZSS_WINDOW_SIZE];    /* Decoded data window */
+} tLZSSDecodeInfo;
+
+static tLZSSDecodeInfo gs_stLZSSDecodeInfo;
+
+/* Get bits from input, return FALSE if input is not enough */
+static boolean LZSS_GetBits(const uint8 i_bitNum,
+                            const uint8 *i_pInBuf,
+                            const uint32 i_inLen,
+                            uint32 *m_pInPos,
+                            uint32 *o_pBits);
+
+/* Output a decoded byte and save it in window */
+#define LZSS_OutputByte(ucData, pucOut) \
+    do{\
+        *(pucOut) = (ucData);\
+        gs_stLZSSDecodeInfo.aWindow[gs_stLZSSDecodeInfo.windowHead] = (ucData);\
+        gs_stLZSSDecodeInfo.windowHead = (uint16)((gs_stLZSSDecodeInfo.windowHead + 1u) & (LZSS_WINDOW_SIZE - 1u));\
+    }while(0u)
+
+/* Init decoder for a new stream */
+void LZSS_Init(void)
+{
+    fsl_memset(&gs_stLZSSDecodeInfo, 0x0u, sizeof(gs_stLZSSDecodeInfo));
+    gs_stLZSSDecodeInfo.eStep = LZSS_TAG_STEP;
+}
+
+/* Decode input to output until input is used up or output is full. Return decoded len. */
+uint32 LZSS_Decode(const uint8 *i_pInBuf,
+                   const uint32 i_inLen,
+                   uint32 *o_pInUsedLen,
+                   uint8 *o_pOutBuf,
+                   const uint32 i_outLen)
+{
+    uint32 inPos = 0u;
+    uint32 outPos = 0u;
+    uint32 bits = 0u;
+    uint8 ucData = 0u;
+    boolean isInputEnough = TRUE;
+    ASSERT(NULL_PTR == i_pInBuf);
+    ASSERT(NULL_PTR == o_pInUsedLen);
+    ASSERT(NULL_PTR == o_pOutBuf);
+
+    while ((outPos < i_outLen) && (TRUE == isInputEnough))
+    {
+        switch (gs_stLZSSDecodeInfo.eStep)
+        {
+            case LZSS_TAG_STEP:
+                isInputEnough = LZSS_GetBits(1u, i_pInBuf, i_inLen, &inPos, &bits);
+
+                if (TRUE == isInputEnough)
+                {
+                    gs_stLZSSDecodeInfo.eStep = (0u != bits) ? LZSS_LITERAL_STEP : LZSS_BACKREF_STEP;
+                }
+
+                break;
+
+            case LZSS_LITERAL_STEP:
+                isInputEnough = LZSS_GetBits(8u, i_pInBuf, i_inLen, &inPos, &bits);
+
+                if (TRUE == isInputEnough)
+                {
+                    LZSS_OutputByte((uint8)bits, &o_pOutBuf[outPos]);
+                    outPos++;
+                    gs_stLZSSDecodeInfo.eStep = LZSS_TAG_STEP;
+                }
+
+                break;
+
+            case LZSS_BACKREF_STEP:
+                isInputEnough = LZSS_GetBits(LZSS_WINDOW_BITS + LZSS_LOOKAHEAD_BITS, i_pInBuf, i_inLen, &inPos, &bits);
+
+                if (TRUE == isInputEnough)
+                {
+                    gs_stLZSSDecodeInfo.backrefIndex = (uint16)(bits >> LZSS_LOOKAHEAD_BITS);
+                    gs_stLZSSDecodeInfo.copyLen = (uint16)((bits & ((1uL << LZSS_LOOKAHEAD_BITS) - 1u)) + LZSS_MIN_MATCH_LEN);
+                    gs_stLZSSDecodeInfo.eStep = LZSS_COPY_STEP;
+                }
+
+                break;
+
+            case LZSS_COPY_STEP:
+                /* Copy byte by byte, back reference may overlap the bytes copied now */
+                ucData = gs_stLZSSDecodeInfo.aWindow[(gs_stLZSSDecodeInfo.windowHead - gs_stLZSSDecodeInfo.backrefIndex - 1u) &
+                                                      (LZSS_WINDOW_SIZE - 1u)];
+                LZSS_OutputByte(ucData, &o_pOutBuf[outPos]);
+                outPos++;
+                gs_stLZSSDecodeInfo.copyLen--;
+
+                if (0u == gs_stLZSSDecodeInfo.copyLen)
+                {
+                    gs_stLZSSDecodeInfo.eStep = LZSS_TAG_STEP;
+                }
+
+                break;
+
+            default:
+                LZSS_Init();
+                break;
+        }
+    }
+
+    *o_pInUsedLen = inPos;
+    return outPos;
+}
+
+/* Get bits from input, return FALSE if input is not enough */
+static boolean LZSS_GetBits(const uint8 i_bitNum,
+                            const uint8 *i_pInBuf,
+                            const uint32 i_inLen,
+                            uint32 *m_pInPos,
+                            uint32 *o_pBits)
+{
+    while (gs_stLZSSDecodeInfo.bitCnt < i_bitNum)
+    {
+        if (*m_pInPos >= i_inLen)
+        {
+            return FALSE;
+        }
+
+        gs_stLZSSDecodeInfo.bitBuf = (gs_stLZSSDecodeInfo.bitBuf << 8u) | i_pInBuf[*m_pInPos];
+        gs_stLZSSDecodeInfo.bitCnt += 8u;
+        (*m_pInPos)++;
+    }
+
+    gs_stLZSSDecodeInfo.bitCnt -= i_bitNum;
+    *o_pBits = (gs_stLZSSDecodeInfo.bitBuf >> gs_stLZSSDecodeInfo.bitCnt) & ((1uL << i_bitNum) - 1u);
+    return TRUE;
+}
+
+#endif /* EN_LZSS_DECOMPRESS */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,40 @@
+/*
+ * @ : LZSS.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef LZSS_H_
+#define LZSS_H_
+
+#include "includes.h"
+
+#ifdef EN_LZSS_DECOMPRESS
+
+/* compressionMethod of RequestDownload dataFormatIdentifier */
+#define LZSS_COMPRESSION_METHOD (1u)
+
+#define LZSS_WINDOW_SIZE        (1uL << LZSS_WINDOW_BITS)                           /* Decoder window RAM */
+#define LZSS_MIN_MATCH_LEN      (2u)                                                /* Min back reference len */
+#define LZSS_MAX_MATCH_LEN      ((1uL << LZSS_LOOKAHEAD_BITS) + LZSS_MIN_MATCH_LEN - 1u) /* Max back reference len */
+
+#if (LZSS_WINDOW_BITS < 4u) || (LZSS_WINDOW_BITS > 15u) || \
+    (LZSS_LOOKAHEAD_BITS < 2u) || (LZSS_LOOKAHEAD_BITS >= LZSS_WINDOW_BITS)
+#error "LZSS_WINDOW_BITS should config [4, 15] and LZSS_LOOKAHEAD_BITS should config [2, LZSS_WINDOW_BITS)"
+#endif
+
+void LZSS_Init(void);
+
+uint32 LZSS_Decode(const uint8 *i_pInBuf,
+                   const uint32 i_inLen,
+                   uint32 *o_pInUsedLen,
+                   uint8 *o_pOutBuf,
+                   const uint32 i_outLen);
+
+#endif /* EN_LZSS_DECOMPRESS */
+
+#endif /* LZSS_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -13,6 +13,7 @@
 #include "timer_hal.h"
 #include "AES.h"
 #include "ZLGKey.h"
+#include "AES_CTR.h"
 
 #ifdef EN_AES_SA_ALGORITHM_SW
 static const uint8 gs_aKey[] =
@@ -22,6 +23,13 @@ static const uint8 gs_aKey[] =
 };
 #endif
 
+#ifdef EN_AES_CTR_DECRYPT
+/* TODO Bootloader: #10 Download data key source, there is no default key */
+#ifndef AES_CTR_KEY_FLASH_ADDR
+#error "EN_AES_CTR_DECRYPT needs a download key source, define AES_CTR_KEY_FLASH_ADDR in user_config.h"
+#endif
+#endif
+
 #if defined (EN_AES_SA_ALGORITHM_SW) || defined (EN_ZLG_SA_ALGORITHM)
 /* Here is not init, because this used for software random */
 static uint32 gs_UDS_SWTimerTickCnt;
@@ -129,6 +137,42 @@ boolean UDS_ALG_HAL_GetRandom(const uint32 i_needRandomDataLen, uint8 *o_pRandom
     return ret;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : UDS_ALG_HAL_GetDownloadKey
+ * Description   : This function is get download data key from key slot.
+ *
+ * Implements : UDS_ALG_hal_Init_Activity
+ *END**************************************************************************/
+boolean UDS_ALG_HAL_GetDownloadKey(uint8 *o_pKey)
+{
+    boolean ret = FALSE;
+#ifdef EN_AES_CTR_DECRYPT
+
+    const uint8 *pKeySlot = (const uint8 *)AES_CTR_KEY_FLASH_ADDR;
+    uint8 index = 0u;
+
+    if (NULL_PTR != o_pKey)
+    {
+        /* Erased key slot is not a key */
+        for (index = 0u; index < AES_CTR_KEY_LEN; index++)
+        {
+            if (0xFFu != pKeySlot[index])
+            {
+                ret = TRUE;
+            }
+        }
+
+        if (TRUE == ret)
+        {
+            fsl_memcpy(o_pKey, pKeySlot, AES_CTR_KEY_LEN);
+        }
+    }
+
+#endif
+    return ret;
+}
+
 /* UDS software timer tick */
 void UDS_ALG_HAL_AddSWTimerTickCnt(void)
 {
@@ -51,6 +51,16 @@ boolean UDS_ALG_HAL_DecryptData(const uint8 *i_pCipherText, const uint32 i_dataL
  */
 boolean UDS_ALG_HAL_GetRandom(const uint32 i_needRandomDataLen, uint8 *o_pRandomDataBuf);
 
+/*!
+ * @brief To UDS get download data key.
+ *
+ * This function returns get download data key status.
+ *
+ * @param[out]  o_pKey point key buff, AES_CTR_KEY_LEN bytes
+ * @return get download data key status.
+ */
+boolean UDS_ALG_HAL_GetDownloadKey(uint8 *o_pKey);
+
 /* UDS software timer tick */
 void UDS_ALG_HAL_AddSWTimerTickCnt(void);
 
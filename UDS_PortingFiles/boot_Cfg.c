@@ -10,7 +10,7 @@
  */
 
 #include "boot_Cfg.h"
-#include "flash_hal_cfg.h"
+#include "flash_hal_Cfg.h"
 #include "fls_app.h"
 #include "CRC_hal.h"
 
@@ -143,7 +143,8 @@ static boolean FLASH_HAL_WriteData(const uint32 i_startAddr,
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLASH_HAL_ReadData
- * Description   : This function is read data in RAM. if read data successfully return TRUE, else return FALSE.
+ * Description   : This function is read flash data in RAM. Flash is memory mapped, flash driver is not needed.
+ *                 if read data successfully return TRUE, else return FALSE.
  * Parameters    : i_startAddr input for start flash address
                    i_readLen read data length
                    o_pDataBuf read data buffer
@@ -153,8 +154,12 @@ static boolean FLASH_HAL_ReadData(const uint32 i_startAddr,
                                   const uint32 i_readLen,
                                   uint8 *o_pDataBuf)
 {
-    FLSDebugPrintf("\n %s\n", __func__);
-    //ReadFlashMemory(i_startAddr, i_readLen, o_pDataBuf);
+    if ((NULL_PTR == o_pDataBuf) || (0u == i_readLen))
+    {
+        return FALSE;
+    }
+
+    ReadFlashMemory(i_startAddr, i_readLen, o_pDataBuf);
     return TRUE;
 }
 
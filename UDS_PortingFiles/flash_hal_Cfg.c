@@ -12,7 +12,7 @@
 #include "flash_hal_Cfg.h"
 
 /* Define a sector = bytes */
-#define SECTOR_LEN                      (FEATURE_FLS_PF_BLOCK_SECTOR_SIZE)
+#define SECTOR_LEN                      (FLASH_SECTOR_LEN)
 
 /* Reset handler information */
 #define EN_WRITE_RESET_HANDLER_IN_FLASH (FALSE) /* Enable write reset handler in flash or not */
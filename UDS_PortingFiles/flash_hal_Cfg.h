@@ -22,9 +22,16 @@ typedef struct
     tLogicalAddr xBlockEndLogicalAddr;   /* block end logical addr */
 } BlockInfo_t;
 
+/* Flash sector length, erase unit */
+#define FLASH_SECTOR_LEN (FEATURE_FLS_PF_BLOCK_SECTOR_SIZE)
+
 /* Program data buffer max length */
 #define MAX_FLASH_DATA_LEN (200u)
 
+#if ((MAX_FLASH_DATA_LEN & 0x07u) != 0u)
+#error "MAX_FLASH_DATA_LEN should be aligned to flash phrase (8 bytes), last data is filled 0xFF to align"
+#endif
+
 /* Check flash config valid or not? */
 boolean FLASH_HAL_APPAddrCheck(void);
 
@@ -14,7 +14,7 @@
 
 /* Common_types.h define uint32/sint32... */
 #include "stdint.h"
-#include "cpu.h"
+#include "Cpu.h"
 
 #include "common_types.h"
 #include "toolchain.h"
@@ -99,29 +99,42 @@
 
 /* TP enable and define message ID */
 
-/* TP enable check */
-#if (defined EN_CAN_TP)
-#if (defined EN_LIN_TP) || (defined EN_ETHERNET_TP) || (defined EN_OTHERS_TP)
-#error "Please check multi TP was enabled!"
+/* TP enable check, more than one TP can be enabled */
+#if (!defined EN_CAN_TP) && (!defined EN_LIN_TP) && (!defined EN_UART_TP) && (!defined EN_ETHERNET_TP)
+#error "Please enable at least one TP (EN_CAN_TP/EN_LIN_TP/EN_UART_TP/EN_ETHERNET_TP)"
 #endif
 
-#elif defined EN_LIN_TP
-#if (defined EN_CAN_TP) ||  (defined EN_ETHERNET_TP) || (defined EN_OTHERS_TP)
-#error "Please check multi TP was enabled!"
+#if (defined EN_OTHERS_TP)
+#error "EN_OTHERS_TP is reserved, there is no TP for it"
 #endif
 
-#elif defined  EN_ETHERNET_TP
-#if (defined EN_CAN_TP) || (defined EN_LIN_TP) || (defined EN_OTHERS_TP)
-#error "Please check multi TP was enabled!"
+/* UART TP and debug print both use LPUART1 */
+#if (defined EN_UART_TP) && (defined EN_DEBUG_PRINT)
+#error "EN_UART_TP can't work with debug print, please disable debug modules!"
 #endif
 
-#elif defined EN_OTHERS_TP
-#if (defined EN_CAN_TP) || (defined EN_LIN_TP) || (defined EN_ETHERNET_TP)
-#error "Please check multi TP was enabled!"
+/* CAN to LIN gateway check */
+#if (defined EN_CAN_LIN_GATEWAY) && (!defined EN_CAN_TP)
+#error "EN_CAN_LIN_GATEWAY need EN_CAN_TP enabled!"
 #endif
 
-#else
-#error "Please enable one TP (EN_CAN_TP/EN_LIN_TP/EN_ETHERNET_TP/EN_OTHERS_TP)"
+#if (defined EN_CAN_LIN_GATEWAY) && (defined EN_LIN_TP)
+#error "EN_CAN_LIN_GATEWAY is LIN master, it can't work with LIN TP (LIN slave)!"
+#endif
+
+/* XCP on CAN check */
+#if (defined EN_XCP_ON_CAN) && (!defined EN_CAN_TP)
+#error "EN_XCP_ON_CAN need EN_CAN_TP enabled!"
+#endif
+
+/* J1939 TP check */
+#if (defined EN_J1939_TP) && (!defined EN_CAN_TP)
+#error "EN_J1939_TP need EN_CAN_TP enabled!"
+#endif
+
+/* Periodic DID check */
+#if (defined EN_PERIODIC_DID) && (!defined EN_CAN_TP)
+#error "EN_PERIODIC_DID need EN_CAN_TP enabled!"
 #endif
 
 #endif /* INCLUDES_H_ */
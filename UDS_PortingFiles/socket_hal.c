@@ -0,0 +1,48 @@
+/*
+ * @ : socket_hal.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "socket_hal.h"
+
+#ifdef EN_ETHERNET_TP
+
+/* TODO Bootloader: #09 S32K144 has no Ethernet, port these functions to TCP/IP stack of ECU with Ethernet */
+/* Tools/socket_hal_host.c is a host port on loopback TCP, used by Tools/DoIP_Loopback.c */
+
+void SOCKET_HAL_Init(const uint16 i_port)
+{
+    (void)i_port;
+}
+
+boolean SOCKET_HAL_IsConnected(void)
+{
+    return FALSE;
+}
+
+uint32 SOCKET_HAL_Read(uint8 *o_pBuf, const uint32 i_bufLen)
+{
+    (void)o_pBuf;
+    (void)i_bufLen;
+
+    return 0u;
+}
+
+uint32 SOCKET_HAL_Write(const uint8 *i_pBuf, const uint32 i_len)
+{
+    (void)i_pBuf;
+    (void)i_len;
+
+    return 0u;
+}
+
+void SOCKET_HAL_Close(void)
+{
+}
+
+#endif /* EN_ETHERNET_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,35 @@
+/*
+ * @ : socket_hal.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef SOCKET_HAL_H_
+#define SOCKET_HAL_H_
+
+#include "includes.h"
+
+#ifdef EN_ETHERNET_TP
+
+/* Listen on TCP port, only one connection is accepted */
+void SOCKET_HAL_Init(const uint16 i_port);
+
+/* Accept connection if not connected, return connection is active or not */
+boolean SOCKET_HAL_IsConnected(void);
+
+/* Read received bytes without blocking, return read len */
+uint32 SOCKET_HAL_Read(uint8 *o_pBuf, const uint32 i_bufLen);
+
+/* Write bytes without blocking, return written len */
+uint32 SOCKET_HAL_Write(const uint8 *i_pBuf, const uint32 i_len);
+
+/* Close connection, listen again */
+void SOCKET_HAL_Close(void);
+
+#endif /* EN_ETHERNET_TP */
+
+#endif /* SOCKET_HAL_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
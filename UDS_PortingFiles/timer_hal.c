@@ -14,6 +14,7 @@
 
 static uint16 gs_1msCnt = 0u;
 static uint16 gs_100msCnt = 0u;
+static volatile uint32 gs_msTickCnt = 0u;
 
 static void LPTimerISR(void)
 {
@@ -45,6 +46,7 @@ void TIMER_HAL_1msPeriod(void)
 {
     uint16 cntTmp = 0u;
     /* Just for check time overflow or not? */
+    gs_msTickCnt++;
     cntTmp = gs_1msCnt + 1u;
 
     if (0u != cntTmp)
@@ -100,6 +102,12 @@ boolean TIMER_HAL_Is100msTickTimeout(void)
     return result;
 }
 
+/* Get ms tick cnt after init, overflow after 49 days */
+uint32 TIMER_HAL_GetMsTickCnt(void)
+{
+    return gs_msTickCnt;
+}
+
 /* Get timer tick cnt for random seed. */
 uint32 TIMER_HAL_GetTimerTickCnt(void)
 {
@@ -24,6 +24,9 @@ void TIMER_HAL_1msPeriod(void);
 /* check 100ms timeout? */
 boolean TIMER_HAL_Is100msTickTimeout(void);
 
+/* Get ms tick cnt after init, used to measure time */
+uint32 TIMER_HAL_GetMsTickCnt(void);
+
 /* get timer tick cnt for random seed. */
 uint32 TIMER_HAL_GetTimerTickCnt(void);
 
@@ -72,6 +72,8 @@
 
 /* -------------------- Enable debug FIFO -------------------- */
 //#define EN_DEBUG_FIFO
+#define EN_FIFO_STATISTICS /* Record FIFO max used len, over max count and moved bytes */
+#define EN_DOWNLOAD_STATISTICS /* Record received bytes, flash job time and TP errors, read by ReadDataByIdentifier */
 
 #if (defined EN_DEBUG_FLS_MODULE) || (defined EN_UDS_DEBUG) || (defined EN_TP_DEBUG) || (defined EN_APP_DEBUG) || (defined EN_DEBUG_FIFO)
 #ifndef EN_DEBUG_PRINT
@@ -91,11 +93,13 @@
 #define SA_ALGORITHM_SEED_LEN (16u) /* Seed Length */
 
 /* -------------------- TP enable and define message ID -------------------- */
-/* Only one TP can be enabled */
+/* One or more TPs can be enabled, UDS response is TX on the TP which received the request */
 #define EN_CAN_TP
 //#define EN_LIN_TP
-//#define EN_ETHERNET_TP
-//#define EN_OTHERS_TP
+//#define EN_UART_TP        /* LPUART1 with DMA, can't work with debug print */
+//#define EN_ETHERNET_TP    /* DoIP (ISO 13400-2) on TCP, need SOCKET_HAL port of ECU TCP/IP stack */
+//#define EN_J1939_TP       /* J1939-21 TP (BAM/RTS-CTS) on CAN bus beside CAN TP, need EN_CAN_TP */
+//#define EN_OTHERS_TP      /* Reserved */
 
 #ifdef EN_CAN_TP
 
@@ -107,22 +111,94 @@
 #define RX_FUN_ADDR_ID       (0x7DFu)    /* FuncReq  - CAN TP RX function ID */
 #define RX_PHY_ADDR_ID       (0x74Cu)    /* PhysReq  - CAN TP RX physical ID */
 #define TX_RESP_ADDR_ID      (0x75Cu)    /* PhysResp - CAN TP TX physical ID */
+#define TX_PERIODIC_ADDR_ID  (0x76Cu)    /* PeriodicResp - ReadDataByPeriodicIdentifier frames ID, lower priority than tester IDs */
 #elif defined (USE_CAN_EXT_ID)
 #define RX_FUN_ADDR_ID       (0x18DA5536u)    /* FuncReq  - CAN TP RX function ID */
 #define RX_PHY_ADDR_ID       (0x18DA5535u)    /* PhysReq  - CAN TP RX physical ID */
 #define TX_RESP_ADDR_ID      (0x18DA3555u)    /* PhysResp - CAN TP TX physical ID */
+#define TX_PERIODIC_ADDR_ID  (0x1CDA3555u)    /* PeriodicResp - ReadDataByPeriodicIdentifier frames ID, lower priority than tester IDs */
 #else
 #error "ѡʵ CAN ID "
 #endif
 #endif
 
 #ifdef EN_LIN_TP
-#define RX_BOARD_ID          (0x7Fu) /* LIN TP RX board ID -- all messages, response unexpected, but supported */
-#define RX_FUN_ADDR_ID       (0x7Eu) /* LIN TP RX function ID -- don't need response/only support SF */
-#define RX_PHY_ADDR_ID       (0x55u) /* LIN TP RX physical ID */
-#define TX_RESP_ADDR_ID      (0x35u) /* LIN TP TX ID (master NAD ID) */
+#define LIN_RX_BOARD_ID      (0x7Fu) /* LIN TP RX board ID -- all messages, response unexpected, but supported */
+#define LIN_RX_FUN_ADDR_ID   (0x7Eu) /* LIN TP RX function ID -- don't need response/only support SF */
+#define LIN_RX_PHY_ADDR_ID   (0x55u) /* LIN TP RX physical ID */
+#define LIN_TX_RESP_ADDR_ID  (0x35u) /* LIN TP TX ID (master NAD ID) */
 #endif
 
+#ifdef EN_UART_TP
+#define UART_TP_BAUD_RATE    (2000000u)  /* UART TP baud rate, 1M ~ 3M */
+#define UART_RX_FUN_ADDR_ID  (0x02u)     /* UART TP RX function frame type */
+#define UART_RX_PHY_ADDR_ID  (0x01u)     /* UART TP RX physical frame type */
+#define UART_TX_RESP_ADDR_ID (0x03u)     /* UART TP TX response frame type */
+#endif
+
+#ifdef EN_ETHERNET_TP
+#define DOIP_TCP_PORT        (13400u)    /* DoIP TCP data port */
+#define DOIP_ECU_ADDR        (0x0E80u)   /* DoIP ECU logical address -- physical request TA and response SA */
+#define DOIP_FUN_ADDR        (0xE400u)   /* DoIP functional logical address */
+#define DOIP_TESTER_ADDR_MIN (0x0E00u)   /* DoIP accepted tester logical address min */
+#define DOIP_TESTER_ADDR_MAX (0x0FFFu)   /* DoIP accepted tester logical address max */
+#endif
+
+#ifdef EN_J1939_TP
+#define J1939_ECU_ADDR       (0x17u)     /* J1939 ECU address -- physical request DA and response SA */
+#define J1939_TESTER_ADDR    (0xF9u)     /* J1939 tester address, off-board diagnostic-service tool #1 */
+#define J1939_UDS_PGN        (0xEF00u)   /* J1939 UDS message PGN, proprietary A (PDU1) */
+#endif
+
+/* -------------------- CAN to LIN gateway programming -------------------- */
+/* Route tester requests received from CAN TP to a LIN slave, this ECU is LIN master. Need EN_CAN_TP. */
+//#define EN_CAN_LIN_GATEWAY
+
+#ifdef EN_CAN_LIN_GATEWAY
+#define LIN_GW_SLAVE_NAD     (0x55u)     /* Default LIN slave NAD */
+#define LIN_GW_REQ_BUF_NUM   (2u)        /* Buffered requests, >= 2 overlap CAN TP RX and LIN TX */
+#endif
+
+/* -------------------- XCP on CAN flash programming -------------------- */
+/* XCP slave beside UDS, PROGRAM_CLEAR/PROGRAM block mode/BUILD_CHECKSUM on fls_app jobs. No seed & key, for tools and HIL rigs only. */
+//#define EN_XCP_ON_CAN
+
+#ifdef EN_XCP_ON_CAN
+#define XCP_RX_ID            (0x7F0u)    /* XCP CMD ID, master to slave, same ID type as CAN TP */
+#define XCP_TX_ID            (0x7F1u)    /* XCP RES/ERR/EV ID, slave to master */
+#endif
+
+/* -------------------- Download data format -------------------- */
+/* RequestDownload dataFormatIdentifier compressionMethod 1: LZSS image, compressed by Tools/LZSS_Compress.c with same bits */
+//#define EN_LZSS_DECOMPRESS
+
+#ifdef EN_LZSS_DECOMPRESS
+#define LZSS_WINDOW_BITS     (10u)       /* Window 1 KB, decoder RAM */
+#define LZSS_LOOKAHEAD_BITS  (4u)        /* Back reference len 2 ~ 17 */
+#endif
+
+/* compressionMethod 2: LZSS compressed delta patch of installed APP, made by Tools/Delta_Diff.c, needs EN_LZSS_DECOMPRESS.
+   New APP is rebuilt in old APP with EN_SUPPORT_APP_B, else in place sector by sector without erase routine. */
+//#define EN_DELTA_UPDATE
+
+/* encryptingMethod 1: AES-128-CTR, IV (16 bytes) follows memorySize in RequestDownload, data is compressed before encrypted */
+//#define EN_AES_CTR_DECRYPT
+
+#ifdef EN_AES_CTR_DECRYPT
+/* Download data key source, must be configured: 16 bytes key written at production, e.g. in D-Flash protected by FDPROT.
+   Erased key (all 0xFF) is rejected, RequestDownload with encryption gets NRC 0x22. */
+//#define AES_CTR_KEY_FLASH_ADDR   (0x10000000u)
+#endif
+
+/* -------------------- Memory read back -------------------- */
+/* RequestUpload (0x35) + TransferData and ReadMemoryByAddress (0x23), readable ranges are in uds_app_cfg.c */
+//#define EN_UPLOAD_MEMORY
+
+/* -------------------- Periodic progress -------------------- */
+/* ReadDataByPeriodicIdentifier (0x2A): download progress DIDs 0xF2xx are TX as single frames on TX_PERIODIC_ADDR_ID,
+   only when no CAN TP frame is waiting. Need EN_CAN_TP. */
+//#define EN_PERIODIC_DID
+
 /* -------------------- CRC module selection -------------------- */
 //#define DebugBootloader_NOTCRC /* Enable CRC or not */
 
@@ -133,27 +209,57 @@
 #define FALSH_ADDRESS_CONTINUE (FALSE)
 
 /* -------------------- FIFO Configuration -------------------- */
-/* RX message from BUS FIFO ID */
-#define RX_BUS_FIFO         ('r')       /* RX bus FIFO */
-
+/* Every TP has RX message from BUS FIFO and TX message to BUS FIFO */
 #ifdef EN_CAN_TP
-#define RX_BUS_FIFO_LEN     (300u)      /* RX BUS FIFO length */
-#elif defined (EN_LIN_TP)
-#define RX_BUS_FIFO_LEN     (50)        /* RX BUS FIFO length */
-#else
-#define RX_BUS_FIFO_LEN     (50u)       /* RX BUS FIFO length */
+#define CAN_RX_BUS_FIFO     ('r')       /* CAN RX bus FIFO ID */
+#define CAN_RX_BUS_FIFO_LEN (256u)      /* CAN RX BUS FIFO length, power of 2 */
+#define CAN_TX_BUS_FIFO     ('t')       /* CAN TX bus FIFO ID */
+#define CAN_TX_BUS_FIFO_LEN (128u)      /* CAN TX BUS FIFO length, power of 2 */
+#define CAN_TX_HIGH_BUS_FIFO     ('h')  /* CAN TX high priority bus FIFO ID, FC and response pending frames */
+#define CAN_TX_HIGH_BUS_FIFO_LEN (64u)  /* CAN TX high priority BUS FIFO length, power of 2 */
+#define CAN_TX_LOW_BUS_FIFO      ('p')  /* CAN TX low priority bus FIFO ID, periodic DID frames */
+#define CAN_TX_LOW_BUS_FIFO_LEN  (64u)  /* CAN TX low priority BUS FIFO length, power of 2 */
 #endif
 
-#ifdef EN_CAN_TP
-/* TX message to BUS FIFO ID */
-#define TX_BUS_FIFO         ('t')       /* RX bus FIFO */
-#define TX_BUS_FIFO_LEN     (100u)      /* RX BUS FIFO length */
-#elif defined (EN_LIN_TP)
-/* TX message to BUS FIFO ID */
-#define TX_BUS_FIFO         ('t')       /* RX bus FIFO */
-#define TX_BUS_FIFO_LEN     (50u)       /* RX BUS FIFO length */
-#else
+#ifdef EN_LIN_TP
+#define LIN_RX_BUS_FIFO     ('n')       /* LIN RX bus FIFO ID */
+#define LIN_RX_BUS_FIFO_LEN (64u)       /* LIN RX BUS FIFO length, power of 2 */
+#define LIN_TX_BUS_FIFO     ('m')       /* LIN TX bus FIFO ID */
+#define LIN_TX_BUS_FIFO_LEN (64u)       /* LIN TX BUS FIFO length, power of 2 */
+#endif
+
+#ifdef EN_UART_TP
+#define UART_RX_BUS_FIFO     ('u')      /* UART RX bus FIFO ID, byte stream */
+#define UART_RX_BUS_FIFO_LEN (512u)     /* UART RX BUS FIFO length, power of 2 */
+#define UART_TX_BUS_FIFO     ('v')      /* UART TX bus FIFO ID, a message is a frame */
+#define UART_TX_BUS_FIFO_LEN (512u)     /* UART TX BUS FIFO length, power of 2 */
+#endif
+
+#ifdef EN_ETHERNET_TP
+#define DOIP_RX_BUS_FIFO     ('e')      /* DoIP RX bus FIFO ID, TCP byte stream */
+#define DOIP_RX_BUS_FIFO_LEN (512u)     /* DoIP RX BUS FIFO length, power of 2 */
+#define DOIP_TX_BUS_FIFO     ('f')      /* DoIP TX bus FIFO ID, a message is a DoIP message */
+#define DOIP_TX_BUS_FIFO_LEN (512u)     /* DoIP TX BUS FIFO length, power of 2 */
+#endif
+
+#ifdef EN_J1939_TP
+#define J1939_RX_BUS_FIFO     ('j')     /* J1939 RX bus FIFO ID, a message is CAN ID + frame */
+#define J1939_RX_BUS_FIFO_LEN (512u)    /* J1939 RX BUS FIFO length, power of 2, hold a CTS window of TP.DT */
+#define J1939_TX_BUS_FIFO     ('k')     /* J1939 TX bus FIFO ID */
+#define J1939_TX_BUS_FIFO_LEN (512u)    /* J1939 TX BUS FIFO length, power of 2 */
+#endif
+
+#ifdef EN_CAN_LIN_GATEWAY
+/* LIN slave response frame FIFO ID */
+#define LIN_GW_RX_FIFO      ('l')       /* LIN gateway RX FIFO */
+#define LIN_GW_RX_FIFO_LEN  (32u)       /* LIN gateway RX FIFO length, power of 2 */
+#endif
 
+#ifdef EN_XCP_ON_CAN
+#define XCP_RX_FIFO         ('x')       /* XCP RX FIFO ID, a message is a CAN frame */
+#define XCP_RX_FIFO_LEN     (512u)      /* XCP RX FIFO length, power of 2, hold a whole PROGRAM block */
+#define XCP_TX_FIFO         ('y')       /* XCP TX FIFO ID */
+#define XCP_TX_FIFO_LEN     (64u)       /* XCP TX FIFO length, power of 2 */
 #endif
 
 /* -------------------- FOTA A/B Configuration -------------------- */
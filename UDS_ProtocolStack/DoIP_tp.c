@@ -0,0 +1,545 @@
+/*
+ * @ : DoIP_tp.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "DoIP_tp.h"
+
+#ifdef EN_ETHERNET_TP
+#include "TP_cfg.h"
+
+/*********************************************************
+**  RA - Routing Activation
+**  One TCP data socket, one tester is activated on it.
+**  Diagnostic message is exchanged after routing activation.
+*********************************************************/
+
+typedef enum
+{
+    DOIPTP_RX_HEADER,   /* Wait generic header */
+    DOIPTP_RX_PAYLOAD,  /* Wait payload */
+    DOIPTP_RX_DISCARD   /* Discard payload of unknown or too large message */
+} tDoIPTpRxStatus;
+
+typedef struct
+{
+    tDoIPTpRxStatus eStatus;                    /* RX message status */
+    uint32 xRxLen;                              /* Received header or payload len */
+    uint32 xPayloadLen;                         /* Payload len in header */
+    uint16 usPayloadType;                       /* Payload type in header */
+    uint8 aHeaderBuf[DOIP_HEADER_LEN];          /* RX header buffer */
+    uint8 aPayloadBuf[DOIP_MAX_PAYLOAD_LEN];    /* RX payload buffer */
+} tDoIPTpRxInfo;
+
+typedef struct
+{
+    boolean isConnected;        /* TCP socket is connected */
+    boolean isClosing;          /* Wait driver close socket, RX and TX are stopped */
+    boolean isRoutingActive;    /* Routing is activated */
+    boolean isAliveCheck;       /* Wait alive check response */
+    uint16 usTesterAddr;        /* Activated tester logical address */
+    uint32 xInactivityTimeout;  /* Inactivity or alive check timeout */
+} tDoIPTpSocketInfo;
+
+typedef struct
+{
+    uint32 xMsgLen;                         /* Pending diagnostic message len, 0 is no pending */
+    tpfUDSTxMsgCallBack pfCallBack;         /* UDS TX message callback */
+    uint8 aMsgBuf[DOIP_MAX_MSG_LEN];        /* Diagnostic message buffer */
+} tDoIPTpTxInfo;
+
+static tDoIPTpRxInfo gs_stDoIPTPRxInfo;         /* DoIP TP RX info */
+static tDoIPTpSocketInfo gs_stDoIPTPSocketInfo; /* DoIP TP socket info */
+static tDoIPTpTxInfo gs_stDoIPTPTxInfo;         /* DoIP TP TX info */
+
+/* Build generic header, return header len */
+static uint32 DoIPTP_BuildHeader(const uint16 i_payloadType, const uint32 i_payloadLen, uint8 *o_pMsgBuf);
+
+/* TX a DoIP message without UDS data */
+static void DoIPTP_TxCtrlMsg(const uint16 i_payloadType, const uint8 *i_pPayload, const uint32 i_payloadLen);
+
+/* TX generic header NACK */
+static void DoIPTP_TxGenericNack(const uint8 i_nackCode);
+
+/* TX diagnostic message ACK or NACK */
+static void DoIPTP_TxDiagAck(const uint16 i_payloadType, const uint16 i_SA, const uint16 i_TA, const uint8 i_ackCode);
+
+/* Stop RX and TX, then driver close socket */
+static void DoIPTP_CloseSocket(void);
+
+/* Restart inactivity timer, any message is received from tester */
+static void DoIPTP_RestartInactivityTimer(void);
+
+/* Read received bytes from RX BUS FIFO and parse DoIP messages */
+static void DoIPTP_DoReceive(void);
+
+/* Received a generic header, check it and decide how to receive payload */
+static void DoIPTP_DoReceiveHeader(void);
+
+/* Received a DoIP message */
+static void DoIPTP_DoReceiveMsg(void);
+
+/* Received routing activation request */
+static void DoIPTP_DoRoutingActivation(const uint8 *i_pPayload);
+
+/* Received diagnostic message */
+static void DoIPTP_DoReceiveDiagMsg(const uint8 *i_pPayload, const uint32 i_payloadLen);
+
+/* Check inactivity and alive check timeout */
+static void DoIPTP_CheckTimeout(void);
+
+/* Read UDS message from TX TP queue and TX it in diagnostic message */
+static void DoIPTP_DoTransmit(void);
+
+/* Read big endian */
+#define DOIP_GET_U16(pBuf) ((uint16)(((uint16)(pBuf)[0u] << 8u) | (pBuf)[1u]))
+#define DOIP_GET_U32(pBuf) (((uint32)(pBuf)[0u] << 24u) | ((uint32)(pBuf)[1u] << 16u) | \
+                            ((uint32)(pBuf)[2u] << 8u) | (pBuf)[3u])
+
+void DoIPTP_Init(void)
+{
+    fsl_memset(&gs_stDoIPTPTxInfo, 0u, sizeof(gs_stDoIPTPTxInfo));
+    DoIPTP_DriverSetSocketConnected(FALSE);
+}
+
+/* Driver report socket is connected or closed, every connection starts without routing activation */
+void DoIPTP_DriverSetSocketConnected(const boolean i_isConnected)
+{
+    fsl_memset(&gs_stDoIPTPRxInfo, 0u, sizeof(gs_stDoIPTPRxInfo));
+    fsl_memset(&gs_stDoIPTPSocketInfo, 0u, sizeof(gs_stDoIPTPSocketInfo));
+    gs_stDoIPTPRxInfo.eStatus = DOIPTP_RX_HEADER;
+    gs_stDoIPTPSocketInfo.isConnected = i_isConnected;
+    gs_stDoIPTPSocketInfo.xInactivityTimeout = g_stUdsDoIPNetLayerCfgInfo.initialInactivityTime;
+    DoIPTP_ClearBusFifo();
+
+    /* Response of last connection is not TX */
+    if (0u != gs_stDoIPTPTxInfo.xMsgLen)
+    {
+        TP_RegisterTransmittedAFrmaeMsgCallBack(gs_stDoIPTPTxInfo.pfCallBack);
+        TP_DoTransmittedAFrameMsgCallBack(TX_MSG_FAILD);
+        gs_stDoIPTPTxInfo.xMsgLen = 0u;
+    }
+}
+
+/* DoIP TP system tick control. This function should period called by system. */
+void DoIPTP_SytstemTickControl(void)
+{
+    if (gs_stDoIPTPSocketInfo.xInactivityTimeout)
+    {
+        gs_stDoIPTPSocketInfo.xInactivityTimeout--;
+    }
+}
+
+/* UDS network man function */
+void DoIPTP_MainFun(void)
+{
+    if ((TRUE == gs_stDoIPTPSocketInfo.isConnected) && (TRUE != gs_stDoIPTPSocketInfo.isClosing))
+    {
+        DoIPTP_DoReceive();
+        DoIPTP_CheckTimeout();
+    }
+
+    DoIPTP_DoTransmit();
+}
+
+/* Build generic header, return header len */
+static uint32 DoIPTP_BuildHeader(const uint16 i_payloadType, const uint32 i_payloadLen, uint8 *o_pMsgBuf)
+{
+    ASSERT(NULL_PTR == o_pMsgBuf);
+
+    o_pMsgBuf[0u] = DOIP_PROTOCOL_VERSION;
+    o_pMsgBuf[1u] = (uint8)(~DOIP_PROTOCOL_VERSION);
+    o_pMsgBuf[2u] = (uint8)(i_payloadType >> 8u);
+    o_pMsgBuf[3u] = (uint8)i_payloadType;
+    o_pMsgBuf[4u] = (uint8)(i_payloadLen >> 24u);
+    o_pMsgBuf[5u] = (uint8)(i_payloadLen >> 16u);
+    o_pMsgBuf[6u] = (uint8)(i_payloadLen >> 8u);
+    o_pMsgBuf[7u] = (uint8)i_payloadLen;
+
+    return DOIP_HEADER_LEN;
+}
+
+/* TX a DoIP message without UDS data. If TX BUS FIFO is full it is lost, tester will timeout. */
+static void DoIPTP_TxCtrlMsg(const uint16 i_payloadType, const uint8 *i_pPayload, const uint32 i_payloadLen)
+{
+    uint8 aucMsgBuf[DOIP_HEADER_LEN + 16u];
+    uint32 headerLen = 0u;
+
+    if (i_payloadLen > (sizeof(aucMsgBuf) - DOIP_HEADER_LEN))
+    {
+        return;
+    }
+
+    headerLen = DoIPTP_BuildHeader(i_payloadType, i_payloadLen, aucMsgBuf);
+
+    if (0u != i_payloadLen)
+    {
+        fsl_memcpy(&aucMsgBuf[headerLen], i_pPayload, i_payloadLen);
+    }
+
+    if (TRUE != g_stUdsDoIPNetLayerCfgInfo.pfNetTx(aucMsgBuf, headerLen + i_payloadLen, NULL_PTR))
+    {
+        TPDebugPrintf("DoIP TX payload type %X failed!\n", i_payloadType);
+    }
+}
+
+/* TX generic header NACK */
+static void DoIPTP_TxGenericNack(const uint8 i_nackCode)
+{
+    TPDebugPrintf("DoIP generic NACK %X\n", i_nackCode);
+    DoIPTP_TxCtrlMsg(DOIP_GENERIC_NACK, &i_nackCode, 1u);
+}
+
+/* TX diagnostic message ACK or NACK, SA is the target address of diagnostic message */
+static void DoIPTP_TxDiagAck(const uint16 i_payloadType, const uint16 i_SA, const uint16 i_TA, const uint8 i_ackCode)
+{
+    uint8 aucPayload[5u];
+
+    aucPayload[0u] = (uint8)(i_SA >> 8u);
+    aucPayload[1u] = (uint8)i_SA;
+    aucPayload[2u] = (uint8)(i_TA >> 8u);
+    aucPayload[3u] = (uint8)i_TA;
+    aucPayload[4u] = i_ackCode;
+    DoIPTP_TxCtrlMsg(i_payloadType, aucPayload, sizeof(aucPayload));
+}
+
+/* Stop RX and TX, then driver close socket after TX BUS FIFO is empty */
+static void DoIPTP_CloseSocket(void)
+{
+    gs_stDoIPTPSocketInfo.isClosing = TRUE;
+    gs_stDoIPTPSocketInfo.isRoutingActive = FALSE;
+    DoIPTP_DoCloseSocket();
+}
+
+/* Restart inactivity timer, any message is received from tester */
+static void DoIPTP_RestartInactivityTimer(void)
+{
+    if (TRUE == gs_stDoIPTPSocketInfo.isRoutingActive)
+    {
+        gs_stDoIPTPSocketInfo.isAliveCheck = FALSE;
+        gs_stDoIPTPSocketInfo.xInactivityTimeout = g_stUdsDoIPNetLayerCfgInfo.generalInactivityTime;
+    }
+}
+
+/* Read received bytes from RX BUS FIFO and parse DoIP messages */
+static void DoIPTP_DoReceive(void)
+{
+    tDoIPTpRxInfo *pstRxInfo = &gs_stDoIPTPRxInfo;
+    uint8 aucDiscardBuf[32u];
+    uint32 needLen = 0u;
+    uint32 rxLen = 0u;
+
+    while (TRUE != gs_stDoIPTPSocketInfo.isClosing)
+    {
+        switch (pstRxInfo->eStatus)
+        {
+            case DOIPTP_RX_HEADER:
+                needLen = DOIP_HEADER_LEN - pstRxInfo->xRxLen;
+                rxLen = g_stUdsDoIPNetLayerCfgInfo.pfNetRx(&pstRxInfo->aHeaderBuf[pstRxInfo->xRxLen], needLen);
+                break;
+
+            case DOIPTP_RX_PAYLOAD:
+                needLen = pstRxInfo->xPayloadLen - pstRxInfo->xRxLen;
+                rxLen = g_stUdsDoIPNetLayerCfgInfo.pfNetRx(&pstRxInfo->aPayloadBuf[pstRxInfo->xRxLen], needLen);
+                break;
+
+            default:
+                needLen = pstRxInfo->xPayloadLen - pstRxInfo->xRxLen;
+                needLen = (needLen > sizeof(aucDiscardBuf)) ? sizeof(aucDiscardBuf) : needLen;
+                rxLen = g_stUdsDoIPNetLayerCfgInfo.pfNetRx(aucDiscardBuf, needLen);
+                break;
+        }
+
+        /* Payload len is 0, message is received without read */
+        if ((0u == rxLen) && (0u != needLen))
+        {
+            break;
+        }
+
+        pstRxInfo->xRxLen += rxLen;
+
+        if (rxLen != needLen)
+        {
+            continue;
+        }
+
+        if (DOIPTP_RX_HEADER == pstRxInfo->eStatus)
+        {
+            DoIPTP_DoReceiveHeader();
+        }
+        else if (DOIPTP_RX_PAYLOAD == pstRxInfo->eStatus)
+        {
+            DoIPTP_DoReceiveMsg();
+            pstRxInfo->eStatus = DOIPTP_RX_HEADER;
+            pstRxInfo->xRxLen = 0u;
+        }
+        else if (pstRxInfo->xRxLen == pstRxInfo->xPayloadLen)
+        {
+            pstRxInfo->eStatus = DOIPTP_RX_HEADER;
+            pstRxInfo->xRxLen = 0u;
+        }
+        else
+        {
+            /* Discard left payload */
+        }
+    }
+}
+
+/* Received a generic header, check it and decide how to receive payload */
+static void DoIPTP_DoReceiveHeader(void)
+{
+    tDoIPTpRxInfo *pstRxInfo = &gs_stDoIPTPRxInfo;
+    const uint8 *pucHeader = pstRxInfo->aHeaderBuf;
+    boolean isLenValid = FALSE;
+
+    pstRxInfo->usPayloadType = DOIP_GET_U16(&pucHeader[2u]);
+    pstRxInfo->xPayloadLen = DOIP_GET_U32(&pucHeader[4u]);
+    pstRxInfo->xRxLen = 0u;
+
+    /* Version 1 ~ 3 with inverse version, 0xFF is only for vehicle identification on UDP */
+    if ((0xFFu != (pucHeader[0u] ^ pucHeader[1u])) || (pucHeader[0u] < 0x01u) || (pucHeader[0u] > 0x03u))
+    {
+        DoIPTP_TxGenericNack(DOIP_NACK_INCORRECT_PATTERN);
+        DoIPTP_CloseSocket();
+        return;
+    }
+
+    switch (pstRxInfo->usPayloadType)
+    {
+        case DOIP_ROUTING_ACTIVATION_REQ:
+            isLenValid = (boolean)((7u == pstRxInfo->xPayloadLen) || (11u == pstRxInfo->xPayloadLen));
+            break;
+
+        case DOIP_ALIVE_CHECK_REQ:
+            isLenValid = (boolean)(0u == pstRxInfo->xPayloadLen);
+            break;
+
+        case DOIP_ALIVE_CHECK_RSP:
+            isLenValid = (boolean)(2u == pstRxInfo->xPayloadLen);
+            break;
+
+        case DOIP_DIAG_MSG:
+            isLenValid = (boolean)(pstRxInfo->xPayloadLen > 4u);
+            break;
+
+        default:
+            DoIPTP_TxGenericNack(DOIP_NACK_UNKNOWN_TYPE);
+            pstRxInfo->eStatus = DOIPTP_RX_DISCARD;
+            return;
+    }
+
+    if (TRUE != isLenValid)
+    {
+        DoIPTP_TxGenericNack(DOIP_NACK_INVALID_LEN);
+        DoIPTP_CloseSocket();
+        return;
+    }
+
+    if (pstRxInfo->xPayloadLen > DOIP_MAX_PAYLOAD_LEN)
+    {
+        DoIPTP_TxGenericNack(DOIP_NACK_MSG_TOO_LARGE);
+        pstRxInfo->eStatus = DOIPTP_RX_DISCARD;
+        return;
+    }
+
+    pstRxInfo->eStatus = DOIPTP_RX_PAYLOAD;
+}
+
+/* Received a DoIP message */
+static void DoIPTP_DoReceiveMsg(void)
+{
+    tDoIPTpRxInfo *pstRxInfo = &gs_stDoIPTPRxInfo;
+    uint8 aucPayload[2u];
+
+    switch (pstRxInfo->usPayloadType)
+    {
+        case DOIP_ROUTING_ACTIVATION_REQ:
+            DoIPTP_DoRoutingActivation(pstRxInfo->aPayloadBuf);
+            break;
+
+        case DOIP_ALIVE_CHECK_REQ:
+            aucPayload[0u] = (uint8)(DoIPTP_GetConfigTxMsgID() >> 8u);
+            aucPayload[1u] = (uint8)DoIPTP_GetConfigTxMsgID();
+            DoIPTP_TxCtrlMsg(DOIP_ALIVE_CHECK_RSP, aucPayload, sizeof(aucPayload));
+            DoIPTP_RestartInactivityTimer();
+            break;
+
+        case DOIP_ALIVE_CHECK_RSP:
+            if (DOIP_GET_U16(pstRxInfo->aPayloadBuf) == gs_stDoIPTPSocketInfo.usTesterAddr)
+            {
+                DoIPTP_RestartInactivityTimer();
+            }
+
+            break;
+
+        case DOIP_DIAG_MSG:
+            DoIPTP_DoReceiveDiagMsg(pstRxInfo->aPayloadBuf, pstRxInfo->xPayloadLen);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Received routing activation request: SA (2) | activation type | reserved (4) | OEM (4, optional) */
+static void DoIPTP_DoRoutingActivation(const uint8 *i_pPayload)
+{
+    tDoIPTpSocketInfo *pstSocketInfo = &gs_stDoIPTPSocketInfo;
+    const uint16 testerAddr = DOIP_GET_U16(i_pPayload);
+    const uint16 ecuAddr = (uint16)DoIPTP_GetConfigTxMsgID();
+    uint8 aucPayload[9u] = {0u};
+    uint8 responseCode = DOIP_RA_SUCCESSFUL;
+
+    if (TRUE != DoIPTP_IsTesterAddrValid(testerAddr))
+    {
+        responseCode = DOIP_RA_UNKNOWN_SA;
+    }
+    /* Default and WWH-OBD activation type */
+    else if (i_pPayload[2u] > 0x01u)
+    {
+        responseCode = DOIP_RA_UNSUPPORTED_TYPE;
+    }
+    else if ((TRUE == pstSocketInfo->isRoutingActive) && (testerAddr != pstSocketInfo->usTesterAddr))
+    {
+        responseCode = DOIP_RA_SA_DIFFERENT;
+    }
+    else
+    {
+        pstSocketInfo->isRoutingActive = TRUE;
+        pstSocketInfo->usTesterAddr = testerAddr;
+        DoIPTP_RestartInactivityTimer();
+    }
+
+    /* Tester address (2) | ECU address (2) | response code | reserved (4) */
+    aucPayload[0u] = (uint8)(testerAddr >> 8u);
+    aucPayload[1u] = (uint8)testerAddr;
+    aucPayload[2u] = (uint8)(ecuAddr >> 8u);
+    aucPayload[3u] = (uint8)ecuAddr;
+    aucPayload[4u] = responseCode;
+    DoIPTP_TxCtrlMsg(DOIP_ROUTING_ACTIVATION_RSP, aucPayload, sizeof(aucPayload));
+
+    if (DOIP_RA_SUCCESSFUL != responseCode)
+    {
+        TPDebugPrintf("DoIP routing activation failed %X!\n", responseCode);
+        DoIPTP_CloseSocket();
+    }
+}
+
+/* Received diagnostic message: SA (2) | TA (2) | UDS data. Write UDS data in TP RX FIFO and ACK. */
+static void DoIPTP_DoReceiveDiagMsg(const uint8 *i_pPayload, const uint32 i_payloadLen)
+{
+    tErroCode eStatus;
+    tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
+    const uint16 SA = DOIP_GET_U16(i_pPayload);
+    const uint16 TA = DOIP_GET_U16(&i_pPayload[2u]);
+
+    if ((TRUE != gs_stDoIPTPSocketInfo.isRoutingActive) || (SA != gs_stDoIPTPSocketInfo.usTesterAddr))
+    {
+        DoIPTP_TxDiagAck(DOIP_DIAG_MSG_NEG_ACK, TA, SA, DOIP_DIAG_NACK_INVALID_SA);
+        DoIPTP_CloseSocket();
+        return;
+    }
+
+    DoIPTP_RestartInactivityTimer();
+
+    if (TRUE != DoIPTP_IsReceivedMsgIDValid(TA))
+    {
+        DoIPTP_TxDiagAck(DOIP_DIAG_MSG_NEG_ACK, TA, SA, DOIP_DIAG_NACK_UNKNOWN_TA);
+        return;
+    }
+
+    exchangeMsgInfo.msgID = TA;
+    exchangeMsgInfo.dataLen = i_payloadLen - 4u;
+    exchangeMsgInfo.pfCallBack = NULL_PTR;
+    exchangeMsgInfo.channel = (uint32)TP_DOIP_CHANNEL;
+    /* Write UDS receive ID, data len and data */
+    PushMsgInFifo(g_xRxTPQueue, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), &i_pPayload[4u], (tLen)exchangeMsgInfo.dataLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        DoIPTP_TxDiagAck(DOIP_DIAG_MSG_NEG_ACK, TA, SA, DOIP_DIAG_NACK_OUT_OF_MEM);
+        return;
+    }
+
+    DoIPTP_TxDiagAck(DOIP_DIAG_MSG_POS_ACK, TA, SA, DOIP_DIAG_ACK);
+}
+
+/* Check inactivity and alive check timeout */
+static void DoIPTP_CheckTimeout(void)
+{
+    tDoIPTpSocketInfo *pstSocketInfo = &gs_stDoIPTPSocketInfo;
+
+    if ((TRUE == pstSocketInfo->isClosing) || (0u != pstSocketInfo->xInactivityTimeout))
+    {
+        return;
+    }
+
+    /* No routing activation after connected, or no alive check response */
+    if ((TRUE != pstSocketInfo->isRoutingActive) || (TRUE == pstSocketInfo->isAliveCheck))
+    {
+        TPDebugPrintf("DoIP socket inactivity timeout!\n");
+        DoIPTP_CloseSocket();
+        return;
+    }
+
+    /* General inactivity, check tester is alive */
+    DoIPTP_TxCtrlMsg(DOIP_ALIVE_CHECK_REQ, NULL_PTR, 0u);
+    pstSocketInfo->isAliveCheck = TRUE;
+    pstSocketInfo->xInactivityTimeout = g_stUdsDoIPNetLayerCfgInfo.aliveCheckTime;
+}
+
+/* Read UDS message from TX TP queue and TX it in diagnostic message. Without routing activation it is dropped. */
+static void DoIPTP_DoTransmit(void)
+{
+    tErroCode eStatus;
+    tLen xRealReadLen = 0u;
+    tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
+    tDoIPTpTxInfo *pstTxInfo = &gs_stDoIPTPTxInfo;
+    uint8 *pucPayload = &pstTxInfo->aMsgBuf[DOIP_HEADER_LEN];
+
+    if (0u == pstTxInfo->xMsgLen)
+    {
+        /* Read UDS transmit ID, data len and data after SA and TA */
+        PopMsgFromFifo(g_xDoIPTxTPQueue,
+                       (uint8 *)&exchangeMsgInfo,
+                       sizeof(tUDSAndTPExchangeMsgInfo),
+                       &pucPayload[4u],
+                       TP_MAX_MSG_LEN,
+                       &xRealReadLen,
+                       &eStatus);
+
+        if (ERRO_NO_MSG == eStatus)
+        {
+            return;
+        }
+
+        if ((ERRO_NONE != eStatus) || (exchangeMsgInfo.dataLen != xRealReadLen) ||
+                (TRUE != gs_stDoIPTPSocketInfo.isRoutingActive))
+        {
+            TPDebugPrintf("DoIP drop UDS message!\n");
+            TP_RegisterTransmittedAFrmaeMsgCallBack(exchangeMsgInfo.pfCallBack);
+            TP_DoTransmittedAFrameMsgCallBack(TX_MSG_FAILD);
+            return;
+        }
+
+        pucPayload[0u] = (uint8)(exchangeMsgInfo.msgID >> 8u);
+        pucPayload[1u] = (uint8)exchangeMsgInfo.msgID;
+        pucPayload[2u] = (uint8)(gs_stDoIPTPSocketInfo.usTesterAddr >> 8u);
+        pucPayload[3u] = (uint8)gs_stDoIPTPSocketInfo.usTesterAddr;
+        pstTxInfo->xMsgLen = DoIPTP_BuildHeader(DOIP_DIAG_MSG, 4u + xRealReadLen, pstTxInfo->aMsgBuf) + 4u + xRealReadLen;
+        pstTxInfo->pfCallBack = exchangeMsgInfo.pfCallBack;
+    }
+
+    /* If TX BUS FIFO is full, TX it in next period. Callback is done after driver write it in socket. */
+    if (TRUE == g_stUdsDoIPNetLayerCfgInfo.pfNetTx(pstTxInfo->aMsgBuf, pstTxInfo->xMsgLen, pstTxInfo->pfCallBack))
+    {
+        pstTxInfo->xMsgLen = 0u;
+        pstTxInfo->pfCallBack = NULL_PTR;
+    }
+}
+#endif /* EN_ETHERNET_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,30 @@
+/*
+ * @ : DoIP_tp.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef DOIP_TP_H_
+#define DOIP_TP_H_
+
+#include "DoIP_tp_cfg.h"
+
+#ifdef EN_ETHERNET_TP
+
+#include "multi_cyc_fifo.h"
+
+void DoIPTP_MainFun(void);
+
+void DoIPTP_SytstemTickControl(void);
+
+void DoIPTP_Init(void);
+
+void DoIPTP_DriverSetSocketConnected(const boolean i_isConnected);
+
+#endif /* EN_ETHERNET_TP */
+
+#endif /* DOIP_TP_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,255 @@
+/*
+ * @ : DoIP_tp_cfg.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "DoIP_tp_cfg.h"
+
+#ifdef EN_ETHERNET_TP
+
+#include "multi_cyc_fifo.h"
+#include "DoIP_tp.h"
+
+static void (*gs_pfDoIPTPCloseSocket)(void) = NULL_PTR;
+static tpfUDSTxMsgCallBack gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+static uint8 DoIPTP_TxMsg(const uint8 *i_pMsgBuf, const uint32 i_msgLen, const tpfUDSTxMsgCallBack i_pfCallBack);
+
+static uint32 DoIPTP_RxBytes(uint8 *o_pRxBuf, const uint32 i_bufLen);
+
+
+/* Define DoIP TP TX queue and BUS FIFOs at compile time */
+FIFO_DEFINE(gs_stDoIPTxTPQueue, DOIP_TX_TP_QUEUE_ID, TX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stDoIPRxBusFifo, DOIP_RX_BUS_FIFO, DOIP_RX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stDoIPTxBusFifo, DOIP_TX_BUS_FIFO, DOIP_TX_BUS_FIFO_LEN);
+
+const tFifoHandle g_xDoIPTxTPQueue = &gs_stDoIPTxTPQueue;       /* DoIP TP TX queue */
+static const tFifoHandle gs_xRxBusFifo = &gs_stDoIPRxBusFifo;  /* RX bus FIFO, TCP byte stream */
+static const tFifoHandle gs_xTxBusFifo = &gs_stDoIPTxBusFifo;  /* TX bus FIFO, a message is a DoIP message */
+
+/* DoIP TP channel config */
+const tTPChannelCfg g_stDoIPTPChannelCfg =
+{
+    DoIPTP_Init,                   /* TP init */
+    DoIPTP_MainFun,                /* TP main function */
+    DoIPTP_SytstemTickControl,     /* TP system tick control */
+    DoIPTP_GetConfigTxMsgID,       /* Get TX message ID */
+    DoIPTP_GetConfigRxMsgFUNID,    /* Get RX function ID */
+    DoIPTP_GetConfigRxMsgPHYID,    /* Get RX physical ID */
+    &gs_stDoIPTxTPQueue,           /* TX TP queue */
+};
+
+/* UDS network layer config info */
+const tUdsDoIPNetLayerCfg g_stUdsDoIPNetLayerCfgInfo =
+{
+    1u,                   /* Called DoIP TP main function period */
+    DOIP_FUN_ADDR,        /* DoIP TP RX FUN ID */
+    DOIP_ECU_ADDR,        /* DoIP TP RX PHY ID */
+    DOIP_ECU_ADDR,        /* DoIP TP TX RESP ID */
+    DOIP_TESTER_ADDR_MIN, /* Accepted tester address min */
+    DOIP_TESTER_ADDR_MAX, /* Accepted tester address max */
+    2000u,                /* T_TCP_Initial_Inactivity */
+    300000u,              /* T_TCP_General_Inactivity */
+    500u,                 /* T_TCP_Alive_Check */
+    DoIPTP_TxMsg,         /* DoIP TP TX */
+    DoIPTP_RxBytes,       /* DoIP TP RX */
+};
+
+
+/* DoIP TP TX a message: write message in TX BUS FIFO, driver write it in socket */
+static uint8 DoIPTP_TxMsg(const uint8 *i_pMsgBuf, const uint32 i_msgLen, const tpfUDSTxMsgCallBack i_pfCallBack)
+{
+    tErroCode eStatus;
+    tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const tLen xMsgLen = (tLen)(sizeof(tTPTxMsgHeader) + i_msgLen);
+    ASSERT(NULL_PTR == i_pMsgBuf);
+
+    if (i_msgLen > DOIP_MAX_MSG_LEN)
+    {
+        return FALSE;
+    }
+
+    /* Build TX message in TX BUS FIFO, if TX BUS FIFO is full nothing is written */
+    pstTxMsgInfo = (tTPTxMsgHeader *)ReserveMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    pstTxMsgInfo->TxMsgID = ((uint32)i_pMsgBuf[2u] << 8u) | i_pMsgBuf[3u];
+    pstTxMsgInfo->TxMsgLength = i_msgLen;
+    pstTxMsgInfo->TxMsgCallBack = (uint32)i_pfCallBack;
+    fsl_memcpy((uint8 *)(pstTxMsgInfo + 1u), i_pMsgBuf, i_msgLen);
+    CommitMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* DoIP TP RX bytes: read RX bytes from RX BUS FIFO, return read len */
+static uint32 DoIPTP_RxBytes(uint8 *o_pRxBuf, const uint32 i_bufLen)
+{
+    tErroCode eStatus;
+    tLen xReadLen = 0u;
+    ASSERT(NULL_PTR == o_pRxBuf);
+
+    ReadDataFromFifo(gs_xRxBusFifo, (tLen)i_bufLen, o_pRxBuf, &xReadLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return 0u;
+    }
+
+    return (uint32)xReadLen;
+}
+
+/* Clear DoIP TP BUS FIFOs, the socket is connected or closed */
+void DoIPTP_ClearBusFifo(void)
+{
+    tErroCode eStatus;
+
+    ClearFIFO(gs_xRxBusFifo, &eStatus);
+    ClearFIFO(gs_xTxBusFifo, &eStatus);
+    gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+}
+
+/* Driver write received bytes in DoIP TP, return written len. Not written bytes should be written again. */
+uint32 DoIPTP_DriverWriteDataInDoIPTP(const uint32 i_dataLen, const uint8 *i_pDataBuf)
+{
+    tErroCode eStatus;
+    tLen xCanWriteLen = 0u;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    GetCanWriteLen(gs_xRxBusFifo, &xCanWriteLen, &eStatus);
+
+    if ((ERRO_NONE != eStatus) || (0u == xCanWriteLen) || (0u == i_dataLen))
+    {
+        return 0u;
+    }
+
+    if (xCanWriteLen > i_dataLen)
+    {
+        xCanWriteLen = (tLen)i_dataLen;
+    }
+
+    WriteDataInFifo(gs_xRxBusFifo, (uint8 *)i_pDataBuf, xCanWriteLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return 0u;
+    }
+
+    return (uint32)xCanWriteLen;
+}
+
+/* Driver read a DoIP message from DoIP TP */
+boolean DoIPTP_DriverReadDataFromDoIPTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
+{
+    boolean result = FALSE;
+    tLen xReadDataLen = 0u;
+    tErroCode eStatus;
+    tTPTxMsgHeader TxMsgInfo;
+    ASSERT(NULL_PTR == o_pReadDataBuf);
+    ASSERT(NULL_PTR == o_pstTxMsgHeader);
+    PopMsgFromFifo(gs_xTxBusFifo,
+                   (uint8 *)&TxMsgInfo,
+                   sizeof(tTPTxMsgHeader),
+                   o_pReadDataBuf,
+                   (tLen)i_readDataLen,
+                   &xReadDataLen,
+                   &eStatus);
+
+    if ((ERRO_NONE == eStatus) && (xReadDataLen == TxMsgInfo.TxMsgLength))
+    {
+        result = TRUE;
+        *o_pstTxMsgHeader = TxMsgInfo;
+
+        /* Storage callback, driver call DoIPTP_DoTxMsgSuccessfulCallBack after the message is written in socket */
+        gs_pfTxMsgSuccessfulCallBack = (tpfUDSTxMsgCallBack)TxMsgInfo.TxMsgCallBack;
+    }
+
+    return result;
+}
+
+/* Get config DoIP TP TX ID */
+tUdsId DoIPTP_GetConfigTxMsgID(void)
+{
+    return g_stUdsDoIPNetLayerCfgInfo.xTxId;
+}
+
+/* Get config DoIP TP receive function message ID */
+tUdsId DoIPTP_GetConfigRxMsgFUNID(void)
+{
+    return g_stUdsDoIPNetLayerCfgInfo.xRxFunId;
+}
+
+/* Get config DoIP TP receive physical message ID */
+tUdsId DoIPTP_GetConfigRxMsgPHYID(void)
+{
+    return g_stUdsDoIPNetLayerCfgInfo.xRxPhyId;
+}
+
+/* Is received message valid? */
+boolean DoIPTP_IsReceivedMsgIDValid(const uint32 i_receiveMsgID)
+{
+    boolean result = FALSE;
+
+    if ((i_receiveMsgID == DoIPTP_GetConfigRxMsgFUNID())
+            || (i_receiveMsgID == DoIPTP_GetConfigRxMsgPHYID()))
+    {
+        result = TRUE;
+    }
+
+    return result;
+}
+
+/* Is tester logical address accepted? */
+boolean DoIPTP_IsTesterAddrValid(const uint16 i_testerAddr)
+{
+    boolean result = FALSE;
+
+    if ((i_testerAddr >= g_stUdsDoIPNetLayerCfgInfo.usTesterAddrMin) &&
+            (i_testerAddr <= g_stUdsDoIPNetLayerCfgInfo.usTesterAddrMax))
+    {
+        result = TRUE;
+    }
+
+    return result;
+}
+
+/* Register close socket */
+void DoIPTP_RegisterCloseSocket(void (*i_pfCloseSocket)(void))
+{
+    gs_pfDoIPTPCloseSocket = i_pfCloseSocket;
+}
+
+/* Close socket, driver will report socket closed */
+void DoIPTP_DoCloseSocket(void)
+{
+    if (NULL_PTR != gs_pfDoIPTPCloseSocket)
+    {
+        (gs_pfDoIPTPCloseSocket)();
+    }
+}
+
+/* Do TX message successful callback */
+void DoIPTP_DoTxMsgSuccessfulCallBack(void)
+{
+    if (NULL_PTR != gs_pfTxMsgSuccessfulCallBack)
+    {
+        TP_RegisterTransmittedAFrmaeMsgCallBack(gs_pfTxMsgSuccessfulCallBack);
+        TP_DoTransmittedAFrameMsgCallBack(TX_MSG_SUCCESSFUL);
+        gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+    }
+}
+#endif /* EN_ETHERNET_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
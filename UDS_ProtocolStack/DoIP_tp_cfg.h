@@ -0,0 +1,123 @@
+/*
+ * @ : DoIP_tp_cfg.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef DOIP_TP_CFG_H_
+#define DOIP_TP_CFG_H_
+
+#include "includes.h"
+
+#ifdef EN_ETHERNET_TP
+#include "TP_cfg.h"
+
+/*******************************************************
+**  Description : ISO 13400-2 (DoIP) configuration file
+**
+**  Only TCP data socket is supported, vehicle identification on UDP is not supported.
+**  DoIP message: version | inverse version | payload type (2) | payload len (4) | payload
+**  A UDS message is a diagnostic message, SA is tester address and TA is DOIP_ECU_ADDR or DOIP_FUN_ADDR.
+*******************************************************/
+
+#define DOIP_PROTOCOL_VERSION       (0x02u)     /* ISO 13400-2:2012 */
+#define DOIP_HEADER_LEN             (8u)        /* DoIP generic header len */
+
+/* Payload type */
+#define DOIP_GENERIC_NACK           (0x0000u)   /* Generic header negative acknowledge */
+#define DOIP_ROUTING_ACTIVATION_REQ (0x0005u)   /* Routing activation request */
+#define DOIP_ROUTING_ACTIVATION_RSP (0x0006u)   /* Routing activation response */
+#define DOIP_ALIVE_CHECK_REQ        (0x0007u)   /* Alive check request */
+#define DOIP_ALIVE_CHECK_RSP        (0x0008u)   /* Alive check response */
+#define DOIP_DIAG_MSG               (0x8001u)   /* Diagnostic message */
+#define DOIP_DIAG_MSG_POS_ACK       (0x8002u)   /* Diagnostic message positive acknowledge */
+#define DOIP_DIAG_MSG_NEG_ACK       (0x8003u)   /* Diagnostic message negative acknowledge */
+
+/* Generic header NACK code */
+#define DOIP_NACK_INCORRECT_PATTERN (0x00u)     /* Incorrect pattern format, close socket */
+#define DOIP_NACK_UNKNOWN_TYPE      (0x01u)     /* Unknown payload type */
+#define DOIP_NACK_MSG_TOO_LARGE     (0x02u)     /* Message too large */
+#define DOIP_NACK_INVALID_LEN       (0x04u)     /* Invalid payload length, close socket */
+
+/* Routing activation response code */
+#define DOIP_RA_UNKNOWN_SA          (0x00u)     /* Unknown source address, close socket */
+#define DOIP_RA_SA_DIFFERENT        (0x02u)     /* Source address differs from activated one, close socket */
+#define DOIP_RA_UNSUPPORTED_TYPE    (0x06u)     /* Unsupported routing activation type, close socket */
+#define DOIP_RA_SUCCESSFUL          (0x10u)     /* Routing successfully activated */
+
+/* Diagnostic message ACK code */
+#define DOIP_DIAG_ACK               (0x00u)     /* Positive ACK */
+#define DOIP_DIAG_NACK_INVALID_SA   (0x02u)     /* Invalid source address, close socket */
+#define DOIP_DIAG_NACK_UNKNOWN_TA   (0x03u)     /* Unknown target address */
+#define DOIP_DIAG_NACK_TOO_LARGE    (0x04u)     /* Diagnostic message too large */
+#define DOIP_DIAG_NACK_OUT_OF_MEM   (0x05u)     /* Out of memory */
+
+/* Max payload len, diagnostic message with SA and TA is the largest */
+#define DOIP_MAX_PAYLOAD_LEN        (4u + TP_MAX_MSG_LEN)
+#define DOIP_MAX_MSG_LEN            (DOIP_HEADER_LEN + DOIP_MAX_PAYLOAD_LEN)
+
+#define DOIP_TX_TP_QUEUE_ID         ('D')       /* DoIP TP TX queue ID */
+
+#if (!IsFifoLenValid(DOIP_RX_BUS_FIFO_LEN)) || (DOIP_RX_BUS_FIFO_LEN < DOIP_MAX_MSG_LEN)
+#error "DoIP RX BUS FIFO len should be power of 2 and not less than a DoIP message"
+#endif
+
+#if (!IsFifoLenValid(DOIP_TX_BUS_FIFO_LEN)) || \
+    (FifoMaxMsgLen(DOIP_TX_BUS_FIFO_LEN) < (12u + DOIP_MAX_MSG_LEN))
+#error "DoIP TX BUS FIFO len should be power of 2 and not too small for a DoIP message (tTPTxMsgHeader + message)"
+#endif
+
+typedef uint8 (*tDoIPNetTx)(const uint8 *, const uint32, const tpfUDSTxMsgCallBack);
+typedef uint32 (*tDoIPNetRx)(uint8 *, const uint32);
+
+typedef struct
+{
+    uint8 ucCalledPeriod;           /* Called DoIP TP main function period */
+    tUdsId xRxFunId;                /* RX FUN ID, functional logical address */
+    tUdsId xRxPhyId;                /* RX PHY ID, ECU logical address */
+    tUdsId xTxId;                   /* TX RESP ID, ECU logical address */
+    uint16 usTesterAddrMin;         /* Accepted tester logical address min */
+    uint16 usTesterAddrMax;         /* Accepted tester logical address max */
+    uint32 initialInactivityTime;   /* T_TCP_Initial_Inactivity, no routing activation after connected */
+    uint32 generalInactivityTime;   /* T_TCP_General_Inactivity, then TX alive check request */
+    uint32 aliveCheckTime;          /* T_TCP_Alive_Check, wait alive check response */
+    tDoIPNetTx pfNetTx;             /* Net TX a DoIP message with non blocking */
+    tDoIPNetRx pfNetRx;             /* Net RX bytes */
+} tUdsDoIPNetLayerCfg;
+
+/* UDS network layer config info */
+extern const tUdsDoIPNetLayerCfg g_stUdsDoIPNetLayerCfgInfo;
+
+/* UDS send message to DoIP TP queue */
+extern const tFifoHandle g_xDoIPTxTPQueue;
+
+
+tUdsId DoIPTP_GetConfigTxMsgID(void);
+
+tUdsId DoIPTP_GetConfigRxMsgFUNID(void);
+
+tUdsId DoIPTP_GetConfigRxMsgPHYID(void);
+
+boolean DoIPTP_IsReceivedMsgIDValid(const uint32 i_receiveMsgID);
+
+boolean DoIPTP_IsTesterAddrValid(const uint16 i_testerAddr);
+
+void DoIPTP_ClearBusFifo(void);
+
+uint32 DoIPTP_DriverWriteDataInDoIPTP(const uint32 i_dataLen, const uint8 *i_pDataBuf);
+
+boolean DoIPTP_DriverReadDataFromDoIPTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader);
+
+void DoIPTP_RegisterCloseSocket(void (*i_pfCloseSocket)(void));
+
+void DoIPTP_DoCloseSocket(void);
+
+void DoIPTP_DoTxMsgSuccessfulCallBack(void);
+
+#endif /* EN_ETHERNET_TP */
+
+#endif /* DOIP_TP_CFG_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,652 @@
+/*
+ * @ : J1939_tp.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "J1939_tp.h"
+
+#ifdef EN_J1939_TP
+#include "TP_cfg.h"
+
+/*********************************************************
+**  RX: single frame, RTS -> CTS -> TP.DT ... -> CTS ... -> EndOfMsgAck, BAM -> TP.DT ...
+**  TX: single frame, RTS -> wait CTS -> TP.DT ... -> wait CTS ... -> wait EndOfMsgAck
+**  A RTS/CTS RX session and a BAM RX session can be received at the same time.
+*********************************************************/
+
+typedef enum
+{
+    J1939TP_RX_IDLE,        /* No RX session */
+    J1939TP_RX_WAIT_DT      /* Wait TP.DT */
+} tJ1939TpRxStatus;
+
+typedef struct
+{
+    tJ1939TpRxStatus eStatus;       /* RX session status */
+    uint32 xMsgLen;                 /* Message len */
+    uint8 ucPackets;                /* Message TP.DT packets */
+    uint8 ucNextSN;                 /* Expect TP.DT SN */
+    uint8 ucWindowEndSN;            /* Last TP.DT SN of CTS window */
+    uint8 ucMaxCtsPackets;          /* Max packets of a CTS, sender set in RTS */
+    tNetTime xTimeout;              /* Wait TP.DT timeout */
+    uint8 aMsgBuf[J1939_TP_MAX_PACKETS * J1939_TP_DT_DATA_LEN];  /* RX message buffer */
+} tJ1939TpRxInfo;
+
+typedef enum
+{
+    J1939TP_TX_IDLE,        /* No TX message */
+    J1939TP_TX_SF,          /* TX single frame */
+    J1939TP_TX_WAIT_SF,     /* Wait single frame transmitted */
+    J1939TP_TX_RTS,         /* TX RTS */
+    J1939TP_TX_WAIT_CTS,    /* Wait CTS or EndOfMsgAck */
+    J1939TP_TX_DT           /* TX TP.DT of CTS window */
+} tJ1939TpTxStatus;
+
+typedef struct
+{
+    tJ1939TpTxStatus eStatus;       /* TX status */
+    uint32 xMsgLen;                 /* Message len */
+    uint8 ucPackets;                /* Message TP.DT packets */
+    uint8 ucNextSN;                 /* Next TX TP.DT SN */
+    uint8 ucWindowEndSN;            /* Last TP.DT SN of CTS window */
+    tNetTime xTimeout;              /* TX or wait timeout */
+    tpfUDSTxMsgCallBack pfCallBack; /* UDS TX message callback */
+    uint8 aMsgBuf[J1939_TP_MAX_PACKETS * J1939_TP_DT_DATA_LEN];  /* TX message buffer */
+} tJ1939TpTxInfo;
+
+static tJ1939TpRxInfo gs_stJ1939TPRxInfo;       /* RTS/CTS RX session */
+static tJ1939TpRxInfo gs_stJ1939TPBamRxInfo;    /* BAM RX session */
+static tJ1939TpTxInfo gs_stJ1939TPTxInfo;       /* TX info */
+static volatile boolean gs_isJ1939TxSFDone = FALSE;  /* Single frame is transmitted, set in CAN TX interrupt */
+
+#define J1939TpTimeToCount(xTime) ((xTime) / g_stUdsJ1939NetLayerCfgInfo.ucCalledPeriod)
+
+/* Received a frame */
+static void J1939TP_DoReceiveFrame(const tUdsId i_xRxId, const uint8 *i_pFrameBuf, const uint8 i_frameLen);
+
+/* Received TP.CM */
+static void J1939TP_DoReceiveCM(const uint32 i_da, const uint8 *i_pFrameBuf);
+
+/* Received RTS, start a RX session */
+static void J1939TP_DoReceiveRTS(const uint8 *i_pFrameBuf);
+
+/* Received BAM, start a BAM RX session */
+static void J1939TP_DoReceiveBAM(const uint8 *i_pFrameBuf);
+
+/* Received CTS */
+static void J1939TP_DoReceiveCTS(const uint8 *i_pFrameBuf);
+
+/* Received TP.DT */
+static void J1939TP_DoReceiveDT(const uint32 i_da, const uint8 *i_pFrameBuf);
+
+/* Write received UDS message in TP RX FIFO */
+static boolean J1939TP_DoReceiveMsg(const tUdsId i_xMsgId, const uint8 *i_pMsgBuf, const uint32 i_msgLen);
+
+/* TX TP.CM, last 3 bytes are UDS PGN */
+static boolean J1939TP_TxCM(const uint8 i_control, const uint8 i_byte1, const uint8 i_byte2, const uint8 i_byte3, const uint8 i_byte4);
+
+/* TX CTS of next window */
+static void J1939TP_TxCTS(void);
+
+/* TX abort */
+static void J1939TP_TxAbort(const uint8 i_reason);
+
+/* TX UDS message */
+static void J1939TP_DoTransmit(void);
+
+/* TX TP.DT of CTS window */
+static void J1939TP_DoTransmitDT(void);
+
+/* Check RX and TX timeout */
+static void J1939TP_CheckTimeout(void);
+
+/* TX message finished, do UDS TX message callback */
+static void J1939TP_DoTransmitDone(const uint8 i_result);
+
+/* Single frame transmitted callback, called in CAN TX interrupt */
+static void J1939TP_DoTxSFCallBack(uint8 i_result);
+
+void J1939TP_Init(void)
+{
+    fsl_memset(&gs_stJ1939TPRxInfo, 0u, sizeof(gs_stJ1939TPRxInfo));
+    fsl_memset(&gs_stJ1939TPBamRxInfo, 0u, sizeof(gs_stJ1939TPBamRxInfo));
+    fsl_memset(&gs_stJ1939TPTxInfo, 0u, sizeof(gs_stJ1939TPTxInfo));
+    gs_isJ1939TxSFDone = FALSE;
+}
+
+/* J1939 TP system tick control. This function should period called by system. */
+void J1939TP_SytstemTickControl(void)
+{
+    if (gs_stJ1939TPRxInfo.xTimeout)
+    {
+        gs_stJ1939TPRxInfo.xTimeout--;
+    }
+
+    if (gs_stJ1939TPBamRxInfo.xTimeout)
+    {
+        gs_stJ1939TPBamRxInfo.xTimeout--;
+    }
+
+    if (gs_stJ1939TPTxInfo.xTimeout)
+    {
+        gs_stJ1939TPTxInfo.xTimeout--;
+    }
+}
+
+/* UDS network man function */
+void J1939TP_MainFun(void)
+{
+    uint8 aucFrameBuf[J1939_FRAME_LEN];
+    tUdsId xRxId = 0u;
+    uint8 frameLen = 0u;
+
+    /* Read all received frames from RX BUS FIFO */
+    do
+    {
+        frameLen = g_stUdsJ1939NetLayerCfgInfo.pfNetRx(&xRxId, aucFrameBuf, sizeof(aucFrameBuf));
+
+        if (0u != frameLen)
+        {
+            J1939TP_DoReceiveFrame(xRxId, aucFrameBuf, frameLen);
+        }
+    } while (0u != frameLen);
+
+    J1939TP_CheckTimeout();
+    J1939TP_DoTransmit();
+}
+
+/* Received a frame, dispatch by PGN */
+static void J1939TP_DoReceiveFrame(const tUdsId i_xRxId, const uint8 *i_pFrameBuf, const uint8 i_frameLen)
+{
+    const uint32 xPgn = J1939_GetPGN(i_xRxId);
+    const uint32 xDa = J1939_GetDA(i_xRxId);
+
+    if (xPgn == g_stUdsJ1939NetLayerCfgInfo.xUdsPgn)
+    {
+        /* Single frame, data len is frame DLC */
+        (void)J1939TP_DoReceiveMsg((J1939_GLOBAL_ADDR == xDa) ? J1939TP_GetConfigRxMsgFUNID() : J1939TP_GetConfigRxMsgPHYID(),
+                                   i_pFrameBuf, i_frameLen);
+    }
+    else if (J1939_FRAME_LEN != i_frameLen)
+    {
+        TPDebugPrintf("J1939 TP RX invalid TP frame len %d!\n", i_frameLen);
+    }
+    else if (J1939_TP_CM_PGN == xPgn)
+    {
+        J1939TP_DoReceiveCM(xDa, i_pFrameBuf);
+    }
+    else if (J1939_TP_DT_PGN == xPgn)
+    {
+        J1939TP_DoReceiveDT(xDa, i_pFrameBuf);
+    }
+    else
+    {
+        /* Not J1939 TP frame */
+    }
+}
+
+/* Received TP.CM, PGN of message should be UDS PGN */
+static void J1939TP_DoReceiveCM(const uint32 i_da, const uint8 *i_pFrameBuf)
+{
+    const uint32 xPgn = (uint32)i_pFrameBuf[5u] | ((uint32)i_pFrameBuf[6u] << 8u) | ((uint32)i_pFrameBuf[7u] << 16u);
+
+    if (xPgn != g_stUdsJ1939NetLayerCfgInfo.xUdsPgn)
+    {
+        TPDebugPrintf("J1939 TP RX TP.CM of PGN %X!\n", xPgn);
+
+        if ((J1939_GLOBAL_ADDR != i_da) && (J1939_TP_CM_RTS == i_pFrameBuf[0u]))
+        {
+            J1939TP_TxAbort(J1939_ABORT_RESOURCES);
+        }
+
+        return;
+    }
+
+    /* BAM is only to global address, other TP.CM are only to ECU address */
+    if (J1939_GLOBAL_ADDR == i_da)
+    {
+        if (J1939_TP_CM_BAM == i_pFrameBuf[0u])
+        {
+            J1939TP_DoReceiveBAM(i_pFrameBuf);
+        }
+
+        return;
+    }
+
+    switch (i_pFrameBuf[0u])
+    {
+        case J1939_TP_CM_RTS:
+            J1939TP_DoReceiveRTS(i_pFrameBuf);
+            break;
+
+        case J1939_TP_CM_CTS:
+            J1939TP_DoReceiveCTS(i_pFrameBuf);
+            break;
+
+        case J1939_TP_CM_EOMA:
+            if ((J1939TP_TX_WAIT_CTS == gs_stJ1939TPTxInfo.eStatus) &&
+                    (gs_stJ1939TPTxInfo.ucNextSN > gs_stJ1939TPTxInfo.ucPackets))
+            {
+                J1939TP_DoTransmitDone(TX_MSG_SUCCESSFUL);
+            }
+
+            break;
+
+        case J1939_TP_CM_ABORT:
+            TPDebugPrintf("J1939 TP RX abort, reason %d!\n", i_pFrameBuf[1u]);
+
+            /* Tester abort TX message first, then RX message */
+            if ((J1939TP_TX_WAIT_CTS == gs_stJ1939TPTxInfo.eStatus) || (J1939TP_TX_DT == gs_stJ1939TPTxInfo.eStatus))
+            {
+                J1939TP_DoTransmitDone(TX_MSG_FAILD);
+            }
+            else
+            {
+                gs_stJ1939TPRxInfo.eStatus = J1939TP_RX_IDLE;
+            }
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Received RTS, start a RX session. A new RTS replaces the RX session, tester restarted TX. */
+static void J1939TP_DoReceiveRTS(const uint8 *i_pFrameBuf)
+{
+    tJ1939TpRxInfo *pstRxInfo = &gs_stJ1939TPRxInfo;
+    const uint32 xMsgLen = (uint32)i_pFrameBuf[1u] | ((uint32)i_pFrameBuf[2u] << 8u);
+    const uint8 packets = i_pFrameBuf[3u];
+
+    if ((xMsgLen <= J1939_FRAME_LEN) || (xMsgLen > TP_MAX_MSG_LEN) ||
+            (packets != ((xMsgLen + J1939_TP_DT_DATA_LEN - 1u) / J1939_TP_DT_DATA_LEN)))
+    {
+        TPDebugPrintf("J1939 TP RX RTS invalid len %d!\n", xMsgLen);
+        pstRxInfo->eStatus = J1939TP_RX_IDLE;
+        J1939TP_TxAbort(J1939_ABORT_RESOURCES);
+        return;
+    }
+
+    pstRxInfo->xMsgLen = xMsgLen;
+    pstRxInfo->ucPackets = packets;
+    pstRxInfo->ucNextSN = 1u;
+    pstRxInfo->ucMaxCtsPackets = (0u == i_pFrameBuf[4u]) ? 0xFFu : i_pFrameBuf[4u];
+    pstRxInfo->eStatus = J1939TP_RX_WAIT_DT;
+    J1939TP_TxCTS();
+}
+
+/* Received BAM, start a BAM RX session. No CTS and EndOfMsgAck for BAM. */
+static void J1939TP_DoReceiveBAM(const uint8 *i_pFrameBuf)
+{
+    tJ1939TpRxInfo *pstRxInfo = &gs_stJ1939TPBamRxInfo;
+    const uint32 xMsgLen = (uint32)i_pFrameBuf[1u] | ((uint32)i_pFrameBuf[2u] << 8u);
+    const uint8 packets = i_pFrameBuf[3u];
+
+    if ((xMsgLen <= J1939_FRAME_LEN) || (xMsgLen > TP_MAX_MSG_LEN) ||
+            (packets != ((xMsgLen + J1939_TP_DT_DATA_LEN - 1u) / J1939_TP_DT_DATA_LEN)))
+    {
+        TPDebugPrintf("J1939 TP RX BAM invalid len %d!\n", xMsgLen);
+        pstRxInfo->eStatus = J1939TP_RX_IDLE;
+        return;
+    }
+
+    pstRxInfo->xMsgLen = xMsgLen;
+    pstRxInfo->ucPackets = packets;
+    pstRxInfo->ucNextSN = 1u;
+    pstRxInfo->ucWindowEndSN = packets;
+    pstRxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT1);
+    pstRxInfo->eStatus = J1939TP_RX_WAIT_DT;
+}
+
+/* Received CTS. 0 packets is hold, else TX packets from next SN. */
+static void J1939TP_DoReceiveCTS(const uint8 *i_pFrameBuf)
+{
+    tJ1939TpTxInfo *pstTxInfo = &gs_stJ1939TPTxInfo;
+    const uint8 packets = i_pFrameBuf[1u];
+    const uint8 nextSN = i_pFrameBuf[2u];
+
+    if (J1939TP_TX_DT == pstTxInfo->eStatus)
+    {
+        J1939TP_TxAbort(J1939_ABORT_CTS_IN_DT);
+        J1939TP_DoTransmitDone(TX_MSG_FAILD);
+        return;
+    }
+
+    if (J1939TP_TX_WAIT_CTS != pstTxInfo->eStatus)
+    {
+        return;
+    }
+
+    if (0u == packets)
+    {
+        pstTxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT4);
+        return;
+    }
+
+    if ((0u == nextSN) || (nextSN > pstTxInfo->ucPackets))
+    {
+        J1939TP_TxAbort(J1939_ABORT_BAD_SN);
+        J1939TP_DoTransmitDone(TX_MSG_FAILD);
+        return;
+    }
+
+    pstTxInfo->ucNextSN = nextSN;
+    pstTxInfo->ucWindowEndSN = ((uint32)nextSN + packets - 1u > pstTxInfo->ucPackets) ?
+                               pstTxInfo->ucPackets : (uint8)(nextSN + packets - 1u);
+    pstTxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT3);
+    pstTxInfo->eStatus = J1939TP_TX_DT;
+}
+
+/* Received TP.DT, to ECU address is RTS/CTS session, to global address is BAM session */
+static void J1939TP_DoReceiveDT(const uint32 i_da, const uint8 *i_pFrameBuf)
+{
+    const boolean isBAM = (J1939_GLOBAL_ADDR == i_da) ? TRUE : FALSE;
+    tJ1939TpRxInfo *pstRxInfo = (TRUE == isBAM) ? &gs_stJ1939TPBamRxInfo : &gs_stJ1939TPRxInfo;
+    const uint8 SN = i_pFrameBuf[0u];
+    uint32 offset = 0u;
+    uint32 copyLen = J1939_TP_DT_DATA_LEN;
+
+    if (J1939TP_RX_WAIT_DT != pstRxInfo->eStatus)
+    {
+        return;
+    }
+
+    if ((SN != pstRxInfo->ucNextSN) || (SN > pstRxInfo->ucWindowEndSN))
+    {
+        TPDebugPrintf("J1939 TP RX SN %d, expect %d!\n", SN, pstRxInfo->ucNextSN);
+        pstRxInfo->eStatus = J1939TP_RX_IDLE;
+
+        if (TRUE != isBAM)
+        {
+            J1939TP_TxAbort(J1939_ABORT_BAD_SN);
+        }
+
+        return;
+    }
+
+    offset = (uint32)(SN - 1u) * J1939_TP_DT_DATA_LEN;
+
+    if ((offset + copyLen) > pstRxInfo->xMsgLen)
+    {
+        copyLen = pstRxInfo->xMsgLen - offset;
+    }
+
+    fsl_memcpy(&pstRxInfo->aMsgBuf[offset], &i_pFrameBuf[1u], copyLen);
+    pstRxInfo->ucNextSN++;
+    pstRxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT1);
+
+    if (SN == pstRxInfo->ucPackets)
+    {
+        pstRxInfo->eStatus = J1939TP_RX_IDLE;
+
+        if (TRUE == isBAM)
+        {
+            (void)J1939TP_DoReceiveMsg(J1939TP_GetConfigRxMsgFUNID(), pstRxInfo->aMsgBuf, pstRxInfo->xMsgLen);
+        }
+        else if (TRUE == J1939TP_DoReceiveMsg(J1939TP_GetConfigRxMsgPHYID(), pstRxInfo->aMsgBuf, pstRxInfo->xMsgLen))
+        {
+            (void)J1939TP_TxCM(J1939_TP_CM_EOMA, (uint8)pstRxInfo->xMsgLen, (uint8)(pstRxInfo->xMsgLen >> 8u),
+                               pstRxInfo->ucPackets, 0xFFu);
+        }
+        else
+        {
+            /* TP RX FIFO is full, tester should TX the message again */
+            J1939TP_TxAbort(J1939_ABORT_RESOURCES);
+        }
+    }
+    else if ((TRUE != isBAM) && (SN == pstRxInfo->ucWindowEndSN))
+    {
+        J1939TP_TxCTS();
+    }
+    else
+    {
+        /* Wait next TP.DT */
+    }
+}
+
+/* Write received UDS message in TP RX FIFO */
+static boolean J1939TP_DoReceiveMsg(const tUdsId i_xMsgId, const uint8 *i_pMsgBuf, const uint32 i_msgLen)
+{
+    tErroCode eStatus;
+    tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
+
+    exchangeMsgInfo.msgID = i_xMsgId;
+    exchangeMsgInfo.dataLen = i_msgLen;
+    exchangeMsgInfo.pfCallBack = NULL_PTR;
+    exchangeMsgInfo.channel = (uint32)TP_J1939_CHANNEL;
+    /* Write UDS receive ID, data len and data */
+    PushMsgInFifo(g_xRxTPQueue, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), i_pMsgBuf, (tLen)i_msgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        TPDebugPrintf("J1939 TP write RX FIFO failed!\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* TX TP.CM, last 3 bytes are UDS PGN. If TX BUS FIFO is full TP.CM is lost, tester will timeout. */
+static boolean J1939TP_TxCM(const uint8 i_control, const uint8 i_byte1, const uint8 i_byte2, const uint8 i_byte3, const uint8 i_byte4)
+{
+    uint8 aucFrame[J1939_FRAME_LEN];
+    const uint32 xPgn = g_stUdsJ1939NetLayerCfgInfo.xUdsPgn;
+
+    aucFrame[0u] = i_control;
+    aucFrame[1u] = i_byte1;
+    aucFrame[2u] = i_byte2;
+    aucFrame[3u] = i_byte3;
+    aucFrame[4u] = i_byte4;
+    aucFrame[5u] = (uint8)xPgn;
+    aucFrame[6u] = (uint8)(xPgn >> 8u);
+    aucFrame[7u] = (uint8)(xPgn >> 16u);
+
+    if (TRUE != g_stUdsJ1939NetLayerCfgInfo.pfNetTx(J1939TP_GetConfigTxCMMsgID(), J1939_FRAME_LEN, aucFrame, NULL_PTR))
+    {
+        TPDebugPrintf("J1939 TP TX TP.CM %d failed!\n", i_control);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* TX CTS of next window, packets is not more than config, RTS max packets and left packets */
+static void J1939TP_TxCTS(void)
+{
+    tJ1939TpRxInfo *pstRxInfo = &gs_stJ1939TPRxInfo;
+    uint8 packets = g_stUdsJ1939NetLayerCfgInfo.ucRxCtsPackets;
+
+    if (packets > pstRxInfo->ucMaxCtsPackets)
+    {
+        packets = pstRxInfo->ucMaxCtsPackets;
+    }
+
+    if (packets > (uint8)(pstRxInfo->ucPackets - pstRxInfo->ucNextSN + 1u))
+    {
+        packets = (uint8)(pstRxInfo->ucPackets - pstRxInfo->ucNextSN + 1u);
+    }
+
+    pstRxInfo->ucWindowEndSN = (uint8)(pstRxInfo->ucNextSN + packets - 1u);
+    pstRxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT2);
+    (void)J1939TP_TxCM(J1939_TP_CM_CTS, packets, pstRxInfo->ucNextSN, 0xFFu, 0xFFu);
+}
+
+/* TX abort */
+static void J1939TP_TxAbort(const uint8 i_reason)
+{
+    (void)J1939TP_TxCM(J1939_TP_CM_ABORT, i_reason, 0xFFu, 0xFFu, 0xFFu);
+}
+
+/* TX UDS message: read it from TX TP queue, TX single frame or RTS, then TP.DT of CTS window */
+static void J1939TP_DoTransmit(void)
+{
+    tErroCode eStatus;
+    tLen xRealReadLen = 0u;
+    tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
+    tJ1939TpTxInfo *pstTxInfo = &gs_stJ1939TPTxInfo;
+
+    if (J1939TP_TX_IDLE == pstTxInfo->eStatus)
+    {
+        /* Read UDS transmit ID, data len and data */
+        PopMsgFromFifo(g_xJ1939TxTPQueue,
+                       (uint8 *)&exchangeMsgInfo,
+                       sizeof(tUDSAndTPExchangeMsgInfo),
+                       pstTxInfo->aMsgBuf,
+                       TP_MAX_MSG_LEN,
+                       &xRealReadLen,
+                       &eStatus);
+
+        if (ERRO_NO_MSG == eStatus)
+        {
+            return;
+        }
+
+        if ((ERRO_NONE != eStatus) || (exchangeMsgInfo.dataLen != xRealReadLen) || (0u == xRealReadLen))
+        {
+            TPDebugPrintf("J1939 TP read TX queue error!\n");
+            TP_RegisterTransmittedAFrmaeMsgCallBack(exchangeMsgInfo.pfCallBack);
+            TP_DoTransmittedAFrameMsgCallBack(TX_MSG_FAILD);
+            return;
+        }
+
+        pstTxInfo->xMsgLen = xRealReadLen;
+        pstTxInfo->ucPackets = (uint8)((xRealReadLen + J1939_TP_DT_DATA_LEN - 1u) / J1939_TP_DT_DATA_LEN);
+        pstTxInfo->pfCallBack = exchangeMsgInfo.pfCallBack;
+        pstTxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xTr);
+        pstTxInfo->eStatus = (xRealReadLen <= J1939_FRAME_LEN) ? J1939TP_TX_SF : J1939TP_TX_RTS;
+    }
+
+    switch (pstTxInfo->eStatus)
+    {
+        case J1939TP_TX_SF:
+            gs_isJ1939TxSFDone = FALSE;
+
+            if (TRUE == g_stUdsJ1939NetLayerCfgInfo.pfNetTx(J1939TP_GetConfigTxMsgID(), (uint8)pstTxInfo->xMsgLen,
+                                                              pstTxInfo->aMsgBuf, J1939TP_DoTxSFCallBack))
+            {
+                pstTxInfo->eStatus = J1939TP_TX_WAIT_SF;
+            }
+
+            break;
+
+        case J1939TP_TX_WAIT_SF:
+            if (TRUE == gs_isJ1939TxSFDone)
+            {
+                J1939TP_DoTransmitDone(TX_MSG_SUCCESSFUL);
+            }
+
+            break;
+
+        case J1939TP_TX_RTS:
+            if (TRUE == J1939TP_TxCM(J1939_TP_CM_RTS, (uint8)pstTxInfo->xMsgLen, (uint8)(pstTxInfo->xMsgLen >> 8u),
+                                     pstTxInfo->ucPackets, g_stUdsJ1939NetLayerCfgInfo.ucTxCtsPackets))
+            {
+                pstTxInfo->ucNextSN = 1u;
+                pstTxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT3);
+                pstTxInfo->eStatus = J1939TP_TX_WAIT_CTS;
+            }
+
+            break;
+
+        case J1939TP_TX_DT:
+            J1939TP_DoTransmitDT();
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* TX TP.DT of CTS window until TX BUS FIFO is full, then wait CTS or EndOfMsgAck */
+static void J1939TP_DoTransmitDT(void)
+{
+    uint8 aucFrame[J1939_FRAME_LEN];
+    tJ1939TpTxInfo *pstTxInfo = &gs_stJ1939TPTxInfo;
+    uint32 offset = 0u;
+    uint32 copyLen = 0u;
+
+    while (pstTxInfo->ucNextSN <= pstTxInfo->ucWindowEndSN)
+    {
+        offset = (uint32)(pstTxInfo->ucNextSN - 1u) * J1939_TP_DT_DATA_LEN;
+        copyLen = pstTxInfo->xMsgLen - offset;
+
+        if (copyLen > J1939_TP_DT_DATA_LEN)
+        {
+            copyLen = J1939_TP_DT_DATA_LEN;
+        }
+
+        fsl_memset(aucFrame, 0xFFu, sizeof(aucFrame));
+        aucFrame[0u] = pstTxInfo->ucNextSN;
+        fsl_memcpy(&aucFrame[1u], &pstTxInfo->aMsgBuf[offset], copyLen);
+
+        /* TX BUS FIFO is full, TX it in next period */
+        if (TRUE != g_stUdsJ1939NetLayerCfgInfo.pfNetTx(J1939TP_GetConfigTxDTMsgID(), J1939_FRAME_LEN, aucFrame, NULL_PTR))
+        {
+            return;
+        }
+
+        pstTxInfo->ucNextSN++;
+    }
+
+    pstTxInfo->xTimeout = J1939TpTimeToCount(g_stUdsJ1939NetLayerCfgInfo.xT3);
+    pstTxInfo->eStatus = J1939TP_TX_WAIT_CTS;
+}
+
+/* Check RX and TX timeout. RX session timeout is aborted, TX timeout is aborted and callback UDS. */
+static void J1939TP_CheckTimeout(void)
+{
+    tJ1939TpTxInfo *pstTxInfo = &gs_stJ1939TPTxInfo;
+
+    if ((J1939TP_RX_IDLE != gs_stJ1939TPRxInfo.eStatus) && (0u == gs_stJ1939TPRxInfo.xTimeout))
+    {
+        TPDebugPrintf("J1939 TP wait TP.DT timeout!\n");
+        gs_stJ1939TPRxInfo.eStatus = J1939TP_RX_IDLE;
+        J1939TP_TxAbort(J1939_ABORT_TIMEOUT);
+    }
+
+    if ((J1939TP_RX_IDLE != gs_stJ1939TPBamRxInfo.eStatus) && (0u == gs_stJ1939TPBamRxInfo.xTimeout))
+    {
+        TPDebugPrintf("J1939 TP wait BAM TP.DT timeout!\n");
+        gs_stJ1939TPBamRxInfo.eStatus = J1939TP_RX_IDLE;
+    }
+
+    if ((J1939TP_TX_IDLE != pstTxInfo->eStatus) && (0u == pstTxInfo->xTimeout))
+    {
+        TPDebugPrintf("J1939 TP TX timeout, status %d!\n", pstTxInfo->eStatus);
+
+        if ((J1939TP_TX_WAIT_CTS == pstTxInfo->eStatus) || (J1939TP_TX_DT == pstTxInfo->eStatus))
+        {
+            J1939TP_TxAbort(J1939_ABORT_TIMEOUT);
+        }
+
+        J1939TP_DoTransmitDone(TX_MSG_TIMEOUT);
+    }
+}
+
+/* TX message finished, do UDS TX message callback */
+static void J1939TP_DoTransmitDone(const uint8 i_result)
+{
+    tJ1939TpTxInfo *pstTxInfo = &gs_stJ1939TPTxInfo;
+
+    pstTxInfo->eStatus = J1939TP_TX_IDLE;
+    pstTxInfo->xTimeout = 0u;
+    TP_RegisterTransmittedAFrmaeMsgCallBack(pstTxInfo->pfCallBack);
+    TP_DoTransmittedAFrameMsgCallBack(i_result);
+    pstTxInfo->pfCallBack = NULL_PTR;
+}
+
+/* Single frame transmitted callback, called in CAN TX interrupt */
+static void J1939TP_DoTxSFCallBack(uint8 i_result)
+{
+    if (TX_MSG_SUCCESSFUL == i_result)
+    {
+        gs_isJ1939TxSFDone = TRUE;
+    }
+}
+#endif /* EN_J1939_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,28 @@
+/*
+ * @ : J1939_tp.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef J1939_TP_H_
+#define J1939_TP_H_
+
+#include "J1939_tp_cfg.h"
+
+#ifdef EN_J1939_TP
+
+#include "multi_cyc_fifo.h"
+
+void J1939TP_MainFun(void);
+
+void J1939TP_SytstemTickControl(void);
+
+void J1939TP_Init(void);
+
+#endif /* EN_J1939_TP */
+
+#endif /* J1939_TP_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
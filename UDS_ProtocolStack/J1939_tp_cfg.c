@@ -0,0 +1,283 @@
+/*
+ * @ : J1939_tp_cfg.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "J1939_tp_cfg.h"
+
+#ifdef EN_J1939_TP
+
+#include "multi_cyc_fifo.h"
+#include "J1939_tp.h"
+
+static tpfStartTxMsg gs_pfJ1939StartTxMsg = NULL_PTR;
+static tpfUDSTxMsgCallBack gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+static uint8 J1939TP_TxFrame(const tUdsId i_xTxId, const uint8 i_frameLen, const uint8 *i_pFrameBuf, const tpfUDSTxMsgCallBack i_pfCallBack);
+
+static uint8 J1939TP_RxFrame(tUdsId *o_pxRxId, uint8 *o_pFrameBuf, const uint8 i_bufLen);
+
+
+/* Define J1939 TP TX queue and BUS FIFOs at compile time */
+FIFO_DEFINE(gs_stJ1939TxTPQueue, J1939_TX_TP_QUEUE_ID, TX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stJ1939RxBusFifo, J1939_RX_BUS_FIFO, J1939_RX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stJ1939TxBusFifo, J1939_TX_BUS_FIFO, J1939_TX_BUS_FIFO_LEN);
+
+const tFifoHandle g_xJ1939TxTPQueue = &gs_stJ1939TxTPQueue;     /* J1939 TP TX queue */
+static const tFifoHandle gs_xRxBusFifo = &gs_stJ1939RxBusFifo; /* RX bus FIFO, a message is CAN ID + frame */
+static const tFifoHandle gs_xTxBusFifo = &gs_stJ1939TxBusFifo; /* TX bus FIFO, a message is tTPTxMsgHeader + frame */
+
+/* J1939 TP channel config */
+const tTPChannelCfg g_stJ1939TPChannelCfg =
+{
+    J1939TP_Init,                  /* TP init */
+    J1939TP_MainFun,               /* TP main function */
+    J1939TP_SytstemTickControl,    /* TP system tick control */
+    J1939TP_GetConfigTxMsgID,      /* Get TX message ID */
+    J1939TP_GetConfigRxMsgFUNID,   /* Get RX function ID */
+    J1939TP_GetConfigRxMsgPHYID,   /* Get RX physical ID */
+    &gs_stJ1939TxTPQueue,          /* TX TP queue */
+};
+
+/* UDS network layer config info */
+const tUdsJ1939NetLayerCfg g_stUdsJ1939NetLayerCfgInfo =
+{
+    1u,                       /* Called J1939 TP main function period */
+    J1939_ECU_ADDR,           /* ECU address */
+    J1939_TESTER_ADDR,        /* Tester address */
+    J1939_UDS_PGN,            /* UDS message PGN */
+    J1939_TP_RX_CTS_PACKETS,  /* Max packets of a CTS when RX */
+    J1939_TP_TX_CTS_PACKETS,  /* Max packets of a CTS when TX */
+    200u,                     /* Tr */
+    750u,                     /* T1 */
+    1250u,                    /* T2 */
+    1250u,                    /* T3 */
+    1050u,                    /* T4 */
+    J1939TP_TxFrame,          /* J1939 TP TX */
+    J1939TP_RxFrame,          /* J1939 TP RX */
+};
+
+
+/* J1939 TP TX a frame: write frame in TX BUS FIFO and start CAN driver TX */
+static uint8 J1939TP_TxFrame(const tUdsId i_xTxId, const uint8 i_frameLen, const uint8 *i_pFrameBuf, const tpfUDSTxMsgCallBack i_pfCallBack)
+{
+    tErroCode eStatus;
+    tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const tLen xMsgLen = (tLen)(sizeof(tTPTxMsgHeader) + i_frameLen);
+    ASSERT(NULL_PTR == i_pFrameBuf);
+
+    if ((0u == i_frameLen) || (i_frameLen > J1939_FRAME_LEN))
+    {
+        return FALSE;
+    }
+
+    /* Build TX message in TX BUS FIFO, if TX BUS FIFO is full nothing is written */
+    pstTxMsgInfo = (tTPTxMsgHeader *)ReserveMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    pstTxMsgInfo->TxMsgID = i_xTxId;
+    pstTxMsgInfo->TxMsgLength = i_frameLen;
+    pstTxMsgInfo->TxMsgCallBack = (uint32)i_pfCallBack;
+    fsl_memcpy((uint8 *)(pstTxMsgInfo + 1u), i_pFrameBuf, i_frameLen);
+    CommitMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    if (NULL_PTR != gs_pfJ1939StartTxMsg)
+    {
+        (gs_pfJ1939StartTxMsg)();
+    }
+
+    return TRUE;
+}
+
+/* J1939 TP RX a frame: read a frame from RX BUS FIFO, return frame len */
+static uint8 J1939TP_RxFrame(tUdsId *o_pxRxId, uint8 *o_pFrameBuf, const uint8 i_bufLen)
+{
+    tErroCode eStatus;
+    tLen xReadLen = 0u;
+    ASSERT(NULL_PTR == o_pxRxId);
+    ASSERT(NULL_PTR == o_pFrameBuf);
+
+    PopMsgFromFifo(gs_xRxBusFifo, (uint8 *)o_pxRxId, sizeof(tUdsId), o_pFrameBuf, (tLen)i_bufLen, &xReadLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return 0u;
+    }
+
+    return (uint8)xReadLen;
+}
+
+/* Driver write a received frame in J1939 TP. If RX BUS FIFO is full the frame is lost, J1939 TP will timeout. */
+boolean J1939TP_DriverWriteDataInJ1939TP(const uint32 i_RxID, const uint32 i_dataLen, const uint8 *i_pDataBuf)
+{
+    tErroCode eStatus;
+    const tUdsId xRxId = i_RxID;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    if ((0u == i_dataLen) || (i_dataLen > J1939_FRAME_LEN))
+    {
+        return FALSE;
+    }
+
+    PushMsgInFifo(gs_xRxBusFifo, (const uint8 *)&xRxId, sizeof(tUdsId), i_pDataBuf, (tLen)i_dataLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Driver peek a frame from J1939TP TX FIFO, it is kept in FIFO until driver release it after TX started */
+boolean J1939TP_DriverPeekDataFromJ1939TP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
+{
+    tLen xMsgLen = 0u;
+    tErroCode eStatus;
+    uint32 index = 0u;
+    const tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const uint8 *pucData = NULL_PTR;
+    ASSERT(NULL_PTR == o_pReadDataBuf);
+    ASSERT(NULL_PTR == o_pstTxMsgHeader);
+    pstTxMsgInfo = (const tTPTxMsgHeader *)PeekMsgFromFifo(gs_xTxBusFifo, &xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    /* Not a frame, drop it */
+    if ((xMsgLen < sizeof(tTPTxMsgHeader)) ||
+            ((xMsgLen - sizeof(tTPTxMsgHeader)) < pstTxMsgInfo->TxMsgLength) ||
+            (pstTxMsgInfo->TxMsgLength > i_readDataLen))
+    {
+        ReleaseMsgFromFifo(gs_xTxBusFifo, &eStatus);
+        return FALSE;
+    }
+
+    pucData = (const uint8 *)pstTxMsgInfo + sizeof(tTPTxMsgHeader);
+
+    for (index = 0u; index < pstTxMsgInfo->TxMsgLength; index++)
+    {
+        o_pReadDataBuf[index] = pucData[index];
+    }
+
+    *o_pstTxMsgHeader = *pstTxMsgInfo;
+
+    /* Storage callback, driver call J1939TP_DoTxMsgSuccessfulCallBack after the frame is transmitted */
+    gs_pfTxMsgSuccessfulCallBack = (tpfUDSTxMsgCallBack)pstTxMsgInfo->TxMsgCallBack;
+
+    return TRUE;
+}
+
+/* Driver release the peeked frame after TX started */
+void J1939TP_DriverReleaseDataFromJ1939TP(void)
+{
+    tErroCode eStatus;
+    ReleaseMsgFromFifo(gs_xTxBusFifo, &eStatus);
+}
+
+/* Get config J1939 TP TX ID, UDS response */
+tUdsId J1939TP_GetConfigTxMsgID(void)
+{
+    return J1939_BuildID(J1939_UDS_PRIO, g_stUdsJ1939NetLayerCfgInfo.xUdsPgn,
+                         g_stUdsJ1939NetLayerCfgInfo.ucTesterAddr, g_stUdsJ1939NetLayerCfgInfo.ucEcuAddr);
+}
+
+/* Get config J1939 TP receive function message ID */
+tUdsId J1939TP_GetConfigRxMsgFUNID(void)
+{
+    return J1939_BuildID(J1939_UDS_PRIO, g_stUdsJ1939NetLayerCfgInfo.xUdsPgn,
+                         J1939_GLOBAL_ADDR, g_stUdsJ1939NetLayerCfgInfo.ucTesterAddr);
+}
+
+/* Get config J1939 TP receive physical message ID */
+tUdsId J1939TP_GetConfigRxMsgPHYID(void)
+{
+    return J1939_BuildID(J1939_UDS_PRIO, g_stUdsJ1939NetLayerCfgInfo.xUdsPgn,
+                         g_stUdsJ1939NetLayerCfgInfo.ucEcuAddr, g_stUdsJ1939NetLayerCfgInfo.ucTesterAddr);
+}
+
+/* Get config J1939 TP.CM TX ID */
+tUdsId J1939TP_GetConfigTxCMMsgID(void)
+{
+    return J1939_BuildID(J1939_TP_PRIO, J1939_TP_CM_PGN,
+                         g_stUdsJ1939NetLayerCfgInfo.ucTesterAddr, g_stUdsJ1939NetLayerCfgInfo.ucEcuAddr);
+}
+
+/* Get config J1939 TP.DT TX ID */
+tUdsId J1939TP_GetConfigTxDTMsgID(void)
+{
+    return J1939_BuildID(J1939_TP_PRIO, J1939_TP_DT_PGN,
+                         g_stUdsJ1939NetLayerCfgInfo.ucTesterAddr, g_stUdsJ1939NetLayerCfgInfo.ucEcuAddr);
+}
+
+/* Is received CAN ID for J1939 TP? Priority is not checked, sender may change it. */
+boolean J1939TP_IsRxMsgID(const uint32 i_msgID)
+{
+    const uint32 xPgn = J1939_GetPGN(i_msgID);
+    const uint32 xDa = J1939_GetDA(i_msgID);
+
+    if ((i_msgID > 0x1FFFFFFFu) || (J1939_GetSA(i_msgID) != g_stUdsJ1939NetLayerCfgInfo.ucTesterAddr))
+    {
+        return FALSE;
+    }
+
+    if ((xDa != g_stUdsJ1939NetLayerCfgInfo.ucEcuAddr) && (xDa != J1939_GLOBAL_ADDR))
+    {
+        return FALSE;
+    }
+
+    if ((xPgn != g_stUdsJ1939NetLayerCfgInfo.xUdsPgn) && (xPgn != J1939_TP_CM_PGN) && (xPgn != J1939_TP_DT_PGN))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Is TX CAN ID of J1939 TP? */
+boolean J1939TP_IsTxMsgID(const uint32 i_msgID)
+{
+    if ((i_msgID == J1939TP_GetConfigTxMsgID()) || (i_msgID == J1939TP_GetConfigTxCMMsgID())
+            || (i_msgID == J1939TP_GetConfigTxDTMsgID()))
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* Register start TX message, CAN driver starts TX if it is idle */
+void J1939TP_RegisterStartTxMsg(const tpfStartTxMsg i_pfStartTxMsg)
+{
+    gs_pfJ1939StartTxMsg = i_pfStartTxMsg;
+}
+
+/* Do TX message successful callback */
+void J1939TP_DoTxMsgSuccessfulCallBack(void)
+{
+    tpfUDSTxMsgCallBack pfTxMsgCallBack = gs_pfTxMsgSuccessfulCallBack;
+
+    gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+    if (NULL_PTR != pfTxMsgCallBack)
+    {
+        (pfTxMsgCallBack)(TX_MSG_SUCCESSFUL);
+    }
+}
+#endif /* EN_J1939_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,140 @@
+/*
+ * @ : J1939_tp_cfg.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef J1939_TP_CFG_H_
+#define J1939_TP_CFG_H_
+
+#include "includes.h"
+
+#ifdef EN_J1939_TP
+#include "TP_cfg.h"
+
+/*******************************************************
+**  Description : J1939-21 TP configuration file
+**
+**  UDS message is on J1939_UDS_PGN (PDU1, PS is DA), data len is CAN frame DLC.
+**  Message not more than 8 bytes is a single frame, longer message is TX by TP:
+**  RTS/CTS (CMDT) to ECU or tester address, BAM to global address (function request).
+**  TP.CM (PGN 0xEC00): RTS | CTS | EndOfMsgAck | BAM | Abort, last 3 bytes are PGN of message.
+**  TP.DT (PGN 0xEB00): SN 1 ~ 255 | 7 data bytes, last packet padding 0xFF.
+**  UDS message is not more than TP_MAX_MSG_LEN, ETP (more than 1785 bytes) is not needed.
+*******************************************************/
+
+#define J1939_GLOBAL_ADDR       (0xFFu)     /* J1939 global destination address */
+#define J1939_TP_CM_PGN         (0xEC00u)   /* TP.CM PGN */
+#define J1939_TP_DT_PGN         (0xEB00u)   /* TP.DT PGN */
+#define J1939_UDS_PRIO          (6u)        /* UDS message priority */
+#define J1939_TP_PRIO           (7u)        /* TP.CM and TP.DT priority */
+
+#define J1939_TP_CM_RTS         (16u)       /* TP.CM control byte: request to send */
+#define J1939_TP_CM_CTS         (17u)       /* TP.CM control byte: clear to send */
+#define J1939_TP_CM_EOMA        (19u)       /* TP.CM control byte: end of message ACK */
+#define J1939_TP_CM_BAM         (32u)       /* TP.CM control byte: broadcast announce message */
+#define J1939_TP_CM_ABORT       (255u)      /* TP.CM control byte: connection abort */
+
+#define J1939_ABORT_BUSY        (1u)        /* Abort reason: already in a session */
+#define J1939_ABORT_RESOURCES   (2u)        /* Abort reason: no resources, message too long or RX FIFO full */
+#define J1939_ABORT_TIMEOUT     (3u)        /* Abort reason: timeout */
+#define J1939_ABORT_CTS_IN_DT   (4u)        /* Abort reason: CTS received when TX TP.DT */
+#define J1939_ABORT_BAD_SN      (7u)        /* Abort reason: bad TP.DT SN */
+
+#define J1939_FRAME_LEN         (8u)        /* J1939 frame len, TP.CM and TP.DT */
+#define J1939_TP_DT_DATA_LEN    (7u)        /* TP.DT data len */
+#define J1939_TP_MAX_PACKETS    ((TP_MAX_MSG_LEN + J1939_TP_DT_DATA_LEN - 1u) / J1939_TP_DT_DATA_LEN)
+
+#define J1939_TP_RX_CTS_PACKETS (16u)       /* Max packets of a CTS when RX, TP.DT received in a window */
+#define J1939_TP_TX_CTS_PACKETS (16u)       /* Max packets of a CTS when TX, set in RTS */
+
+#define J1939_TX_TP_QUEUE_ID    ('J')       /* J1939 TP TX queue ID */
+
+/* Build J1939 CAN ID of a PDU1 PGN */
+#define J1939_BuildID(prio, pgn, da, sa) \
+    (((uint32)(prio) << 26u) | ((uint32)(pgn) << 8u) | ((uint32)(da) << 8u) | (uint32)(sa))
+
+/* Get PDU1 PGN (PS is DA), DA and SA of J1939 CAN ID */
+#define J1939_GetPGN(xId)       (((xId) >> 8u) & 0x3FF00u)
+#define J1939_GetDA(xId)        (((xId) >> 8u) & 0xFFu)
+#define J1939_GetSA(xId)        ((xId) & 0xFFu)
+
+#if ((J1939_UDS_PGN & 0xFFu) != 0u) || ((J1939_UDS_PGN & 0xFF00u) >= 0xF000u) || (J1939_UDS_PGN > 0x3FFFFu)
+#error "J1939_UDS_PGN should be a PDU1 PGN, DA is in PS"
+#endif
+
+#if (J1939_TP_MAX_PACKETS > 0xFFu) || (J1939_TP_RX_CTS_PACKETS == 0u) || (J1939_TP_TX_CTS_PACKETS == 0u)
+#error "J1939 TP packets config is invalid"
+#endif
+
+/* A RX frame slot is FIFO message head + CAN ID + frame, one slot may be skipped at FIFO end */
+#if (!IsFifoLenValid(J1939_RX_BUS_FIFO_LEN)) || \
+    (J1939_RX_BUS_FIFO_LEN < ((J1939_TP_RX_CTS_PACKETS + 2u) * (4u + 4u + J1939_FRAME_LEN)))
+#error "J1939 RX BUS FIFO len should be power of 2 and hold a CTS window of TP.DT"
+#endif
+
+#if (!IsBusFifoLenValid(J1939_TX_BUS_FIFO_LEN))
+#error "J1939 TX BUS FIFO len should be power of 2 and not too small for a frame (tTPTxMsgHeader + frame)"
+#endif
+
+/* TX a frame, callback is called after the frame is transmitted */
+typedef uint8 (*tJ1939NetTx)(const tUdsId, const uint8, const uint8 *, const tpfUDSTxMsgCallBack);
+
+/* RX a frame, return frame len, 0 is no frame */
+typedef uint8 (*tJ1939NetRx)(tUdsId *, uint8 *, const uint8);
+
+typedef struct
+{
+    uint8 ucCalledPeriod;       /* Called J1939 TP main function period */
+    uint8 ucEcuAddr;            /* ECU address, SA of TX and DA of physical RX */
+    uint8 ucTesterAddr;         /* Tester address */
+    uint32 xUdsPgn;             /* UDS message PGN */
+    uint8 ucRxCtsPackets;       /* Max packets of a CTS when RX */
+    uint8 ucTxCtsPackets;       /* Max packets of a CTS when TX */
+    tNetTime xTr;               /* Max time of TX a frame */
+    tNetTime xT1;               /* Max time between two TP.DT when RX */
+    tNetTime xT2;               /* Max time of wait TP.DT after CTS */
+    tNetTime xT3;               /* Max time of wait CTS or EndOfMsgAck after the last TP.DT */
+    tNetTime xT4;               /* Max time of wait CTS after hold CTS (0 packets) */
+    tJ1939NetTx pfNetTx;        /* Net TX a frame with non blocking */
+    tJ1939NetRx pfNetRx;        /* Net RX a frame */
+} tUdsJ1939NetLayerCfg;
+
+/* UDS network layer config info */
+extern const tUdsJ1939NetLayerCfg g_stUdsJ1939NetLayerCfgInfo;
+
+/* J1939 TP TX queue, UDS write TX message in it */
+extern const tFifoHandle g_xJ1939TxTPQueue;
+
+
+tUdsId J1939TP_GetConfigTxMsgID(void);
+
+tUdsId J1939TP_GetConfigRxMsgFUNID(void);
+
+tUdsId J1939TP_GetConfigRxMsgPHYID(void);
+
+tUdsId J1939TP_GetConfigTxCMMsgID(void);
+
+tUdsId J1939TP_GetConfigTxDTMsgID(void);
+
+boolean J1939TP_IsRxMsgID(const uint32 i_msgID);
+
+boolean J1939TP_IsTxMsgID(const uint32 i_msgID);
+
+boolean J1939TP_DriverWriteDataInJ1939TP(const uint32 i_RxID, const uint32 i_dataLen, const uint8 *i_pDataBuf);
+
+boolean J1939TP_DriverPeekDataFromJ1939TP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader);
+
+void J1939TP_DriverReleaseDataFromJ1939TP(void);
+
+void J1939TP_RegisterStartTxMsg(const tpfStartTxMsg i_pfStartTxMsg);
+
+void J1939TP_DoTxMsgSuccessfulCallBack(void);
+
+#endif /* EN_J1939_TP */
+
+#endif /* J1939_TP_CFG_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
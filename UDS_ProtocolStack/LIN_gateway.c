@@ -0,0 +1,817 @@
+/*
+ * @ : LIN_gateway.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "LIN_gateway.h"
+
+#ifdef EN_CAN_LIN_GATEWAY
+
+#include "TP.h"
+#include "uds_app_cfg.h"
+#include "multi_cyc_fifo.h"
+
+/*********************************************************
+**  LIN diagnostic frame: NAD | PCI | data...
+**  SF - Single Frame       PCI = 0x0L
+**  FF - First Frame        PCI = 0x1H, LEN = L
+**  CF - Consecutive Frame  PCI = 0x2N, N = SN
+*********************************************************/
+#define LIN_GW_PCI_SF (0x00u)
+#define LIN_GW_PCI_FF (0x10u)
+#define LIN_GW_PCI_CF (0x20u)
+
+#define LIN_GW_SF_DATA_MAX_LEN (6u) /* Max single frame data len */
+#define LIN_GW_FF_DATA_LEN (5u)     /* First frame data len */
+#define LIN_GW_CF_DATA_LEN (6u)     /* Consecutive frame data len */
+#define LIN_GW_PAD_VALUE (0xFFu)    /* Unused data bytes */
+
+#define LIN_GW_TRANSFER_DATA_SID (0x36u)
+#define LIN_GW_ROUTINE_CONTROL_SID (0x31u)
+#define LIN_GW_TESTER_PRESENT_SID (0x3Eu)
+
+/* Send NRC 0x78 to tester before P2/P2* timeout */
+#define LIN_GW_P2_WATERMARK_PERCENT (90u)
+
+/* LIN gateway time to count */
+#define LINGWTimeToCount(xTime) ((xTime) / g_stLINGatewayCfgInfo.ucCalledPeriod)
+
+#if (LIN_GW_REQ_BUF_NUM < 2u)
+#error "LIN_GW_REQ_BUF_NUM should >= 2, else CAN TP RX cannot overlap with LIN TX"
+#endif
+
+#if !IsFifoLenValid(LIN_GW_RX_FIFO_LEN)
+#error "LIN_GW_RX_FIFO_LEN should be power of 2"
+#endif
+
+typedef enum
+{
+    LINGW_IDLE,     /* LIN gateway idle */
+    LINGW_TX_REQ,   /* TX master request frames */
+    LINGW_WAIT_RESP /* Poll slave response frames */
+} tLINGWStatus;
+
+typedef struct
+{
+    uint8 isBuffered;                   /* Tester got positive response already, slave response checked by gateway */
+    uint8 isSuppressResp;               /* Suppress positive response */
+    uint16 xDataLen;                    /* Request data len */
+    uint8 aDataBuf[LIN_GW_MAX_PDU_LEN]; /* Request data buffer */
+} tLINGWReqInfo;
+
+typedef struct
+{
+    tLINGWStatus eStatus;               /* LIN gateway status */
+    uint8 isRouting;                    /* Routing tester request to LIN slave */
+    uint8 ucSlaveNAD;                   /* LIN slave NAD */
+    uint8 ucSN;                         /* TX/RX SN */
+    uint8 ucLateNRC;                    /* NRC of a failed buffered request, 0 = no error */
+    uint16 xTxDataLen;                  /* Request data len already TX */
+    uint16 xRespDataLen;                /* Slave response data len */
+    uint16 xRespRxDataLen;              /* Slave response data len already RX */
+    tLINGWTime xFrameSlotTime;          /* Frame slot timer */
+    tLINGWTime xMaxWaitTimeout;         /* N_As/N_Cr/slave P2 timer */
+    tLINGWTime xKeepAliveTime;          /* Slave tester present timer */
+    uint8 isTesterWaiting;              /* Tester waiting response from gateway */
+    uint8 ucTesterWaitSID;              /* Tester waiting response SID */
+    tLINGWTime xTesterP2Time;           /* Tester P2/P2* timer */
+    tTPChannel eTesterChannel;          /* TP channel of the last routed request, responses are TX on it */
+    uint8 aRespBuf[LIN_GW_MAX_PDU_LEN]; /* Slave response buffer */
+} tLINGWInfo;
+
+typedef void (*tpfLINGWFun)(void);
+typedef struct
+{
+    tLINGWStatus eLINGWStatus;
+    tpfLINGWFun pfLINGWFun;
+} tLINGWFunInfo;
+
+/* Request queue. Head request is on LIN bus, the others are waiting. */
+static tLINGWReqInfo gs_astLINGWReqQueue[LIN_GW_REQ_BUF_NUM];
+static uint8 gs_ucLINGWReqHead = 0u;
+static uint8 gs_ucLINGWReqCnt = 0u;
+
+/* Tester request waiting for a free queue item */
+static tLINGWReqInfo gs_stLINGWHoldReq;
+static uint8 gs_isLINGWHoldReq = FALSE;
+
+static tLINGWInfo gs_stLINGWInfo;
+
+/* Slave response frames FIFO, written by LIN driver */
+FIFO_DEFINE(gs_stLINGWRxFifo, LIN_GW_RX_FIFO, LIN_GW_RX_FIFO_LEN);
+static const tFifoHandle gs_xLINGWRxFifo = &gs_stLINGWRxFifo;
+
+/* LIN gateway idle */
+static void LINGW_DoIdle(void);
+
+/* TX master request frames */
+static void LINGW_DoTxReq(void);
+
+/* Poll slave response frames */
+static void LINGW_DoWaitResp(void);
+
+/* Is request routed to LIN slave? */
+static boolean LINGW_IsRoutedRequest(const uint32 i_xRxId, const uint32 i_xDataLen, const uint8 *i_pDataBuf);
+
+/* Is suppress positive response bit set? */
+static boolean LINGW_IsSuppressPosResp(const uint32 i_xDataLen, const uint8 *i_pDataBuf);
+
+/* Move hold request in queue */
+static void LINGW_MoveHoldReqInQueue(void);
+
+/* Clear all requests */
+static void LINGW_ClearAllReq(void);
+
+/* Received a slave response frame. If received a whole response return TRUE. */
+static boolean LINGW_RxRespFrame(const uint8 *i_pFrameBuf);
+
+/* Finish head request of queue */
+static void LINGW_FinishHeadReq(const boolean i_isReceivedResp);
+
+/* Check slave response of a buffered request */
+static uint8 LINGW_CheckBufferedResp(const tLINGWReqInfo *i_pstReq, const boolean i_isReceivedResp);
+
+/* A buffered request failed, report it to tester */
+static void LINGW_SetLateError(const uint8 i_ucNRC);
+
+/* Start/stop tester P2 timer */
+static void LINGW_StartTesterWait(const uint8 i_ucSID);
+static void LINGW_StopTesterWait(void);
+
+/* Send NRC 0x78 if tester P2 timer timeout */
+static void LINGW_CheckTesterP2(void);
+
+/* Response to tester */
+static void LINGW_ResponseToTester(const uint16 i_xDataLen, const uint8 *i_pDataBuf);
+static void LINGW_ResponseNRCToTester(const uint8 i_ucSID, const uint8 i_ucNRC);
+
+static const tLINGWFunInfo gs_astLINGWFunInfo[] =
+{
+    {LINGW_IDLE, LINGW_DoIdle},
+    {LINGW_TX_REQ, LINGW_DoTxReq},
+    {LINGW_WAIT_RESP, LINGW_DoWaitResp}
+};
+
+void LINGW_Init(void)
+{
+    LINGW_StopRouting();
+}
+
+/* LIN gateway system tick control. This function should period called by system. */
+void LINGW_SystemTickCtl(void)
+{
+    if (gs_stLINGWInfo.xFrameSlotTime)
+    {
+        gs_stLINGWInfo.xFrameSlotTime--;
+    }
+
+    if (gs_stLINGWInfo.xMaxWaitTimeout)
+    {
+        gs_stLINGWInfo.xMaxWaitTimeout--;
+    }
+
+    if (gs_stLINGWInfo.xKeepAliveTime)
+    {
+        gs_stLINGWInfo.xKeepAliveTime--;
+    }
+
+    if (gs_stLINGWInfo.xTesterP2Time)
+    {
+        gs_stLINGWInfo.xTesterP2Time--;
+    }
+}
+
+/* LIN gateway main function */
+void LINGW_MainFun(void)
+{
+    uint8 index = 0u;
+    const uint8 findCnt = sizeof(gs_astLINGWFunInfo) / sizeof(gs_astLINGWFunInfo[0u]);
+
+    if (TRUE != gs_stLINGWInfo.isRouting)
+    {
+        return;
+    }
+
+    LINGW_MoveHoldReqInQueue();
+
+    while (index < findCnt)
+    {
+        if (gs_stLINGWInfo.eStatus == gs_astLINGWFunInfo[index].eLINGWStatus)
+        {
+            gs_astLINGWFunInfo[index].pfLINGWFun();
+            break;
+        }
+
+        index++;
+    }
+
+    LINGW_CheckTesterP2();
+}
+
+/* Start routing tester request to LIN slave. Return FALSE if LIN master driver is not ported. */
+boolean LINGW_StartRouting(const uint8 i_ucSlaveNAD)
+{
+    LINGW_StopRouting();
+
+    if ((NULL_PTR == g_stLINGatewayCfgInfo.pfMasterReqTx) || (NULL_PTR == g_stLINGatewayCfgInfo.pfSlaveRespHeaderTx))
+    {
+        return FALSE;
+    }
+
+    gs_stLINGWInfo.ucSlaveNAD = i_ucSlaveNAD;
+    gs_stLINGWInfo.xKeepAliveTime = LINGWTimeToCount(g_stLINGatewayCfgInfo.xKeepAliveTime);
+    gs_stLINGWInfo.isRouting = TRUE;
+    return TRUE;
+}
+
+/* Stop routing, all requests not finished are dropped */
+void LINGW_StopRouting(void)
+{
+    tErroCode eStatus = ERRO_NONE;
+    LINGW_ClearAllReq();
+    LINGW_StopTesterWait();
+    gs_stLINGWInfo.eStatus = LINGW_IDLE;
+    gs_stLINGWInfo.isRouting = FALSE;
+    gs_stLINGWInfo.ucLateNRC = 0u;
+    ClearFIFO(gs_xLINGWRxFifo, &eStatus);
+}
+
+/* Is routing tester request to LIN slave? */
+boolean LINGW_IsRouting(void)
+{
+    return (boolean)gs_stLINGWInfo.isRouting;
+}
+
+/* Route tester request to LIN slave. If request is routed return TRUE, gateway will response tester. */
+boolean LINGW_RouteRequest(const uint32 i_xRxId, const uint32 i_xDataLen, const uint8 *i_pDataBuf)
+{
+    tLINGWReqInfo *pstReq = NULL_PTR;
+    uint8 aRespBuf[2u] = {0u};
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    if (TRUE != LINGW_IsRoutedRequest(i_xRxId, i_xDataLen, i_pDataBuf))
+    {
+        return FALSE;
+    }
+
+    gs_stLINGWInfo.eTesterChannel = TP_GetCurChannel();
+
+    /* A buffered request failed on LIN bus, report it on this request */
+    if (0u != gs_stLINGWInfo.ucLateNRC)
+    {
+        LINGW_ResponseNRCToTester(i_pDataBuf[0u], gs_stLINGWInfo.ucLateNRC);
+        gs_stLINGWInfo.ucLateNRC = 0u;
+
+        return TRUE;
+    }
+
+    /* Tester should wait last request response */
+    if ((TRUE == gs_isLINGWHoldReq) || (TRUE == gs_stLINGWInfo.isTesterWaiting))
+    {
+        LINGW_ResponseNRCToTester(i_pDataBuf[0u], NRC_BUSY_REPEAT_REQUEST);
+
+        return TRUE;
+    }
+
+    if ((i_xDataLen > LIN_GW_MAX_PDU_LEN) ||
+            ((LIN_GW_TRANSFER_DATA_SID == i_pDataBuf[0u]) && (i_xDataLen < 2u)))
+    {
+        LINGW_ResponseNRCToTester(i_pDataBuf[0u], NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT);
+
+        return TRUE;
+    }
+
+    if (LIN_GW_REQ_BUF_NUM > gs_ucLINGWReqCnt)
+    {
+        pstReq = &gs_astLINGWReqQueue[(gs_ucLINGWReqHead + gs_ucLINGWReqCnt) % LIN_GW_REQ_BUF_NUM];
+        gs_ucLINGWReqCnt++;
+    }
+    else
+    {
+        pstReq = &gs_stLINGWHoldReq;
+        gs_isLINGWHoldReq = TRUE;
+    }
+
+    fsl_memcpy(pstReq->aDataBuf, i_pDataBuf, i_xDataLen);
+    pstReq->xDataLen = (uint16)i_xDataLen;
+    pstReq->isSuppressResp = LINGW_IsSuppressPosResp(i_xDataLen, i_pDataBuf);
+    /* Transfer data is buffered, tester can TX next block when this block is on LIN bus */
+    pstReq->isBuffered = (LIN_GW_TRANSFER_DATA_SID == i_pDataBuf[0u]) ? TRUE : FALSE;
+
+    if ((TRUE == pstReq->isBuffered) && (&gs_stLINGWHoldReq != pstReq))
+    {
+        aRespBuf[0u] = LIN_GW_TRANSFER_DATA_SID + 0x40u;
+        aRespBuf[1u] = i_pDataBuf[1u];
+        LINGW_ResponseToTester(sizeof(aRespBuf), aRespBuf);
+    }
+    else if (TRUE != pstReq->isSuppressResp)
+    {
+        LINGW_StartTesterWait(i_pDataBuf[0u]);
+    }
+    else
+    {
+        /* Suppress positive response, tester doesn't wait */
+    }
+
+    return TRUE;
+}
+
+/* LIN driver write a slave response frame in gateway. Called when received slave response (0x3D). */
+boolean LINGW_DriverWriteSlaveResp(const uint8 *i_pFrameBuf)
+{
+    boolean result = FALSE;
+    tLen xCanWriteLen = 0u;
+    tErroCode eStatus = ERRO_NONE;
+    ASSERT(NULL_PTR == i_pFrameBuf);
+    GetCanWriteLen(gs_xLINGWRxFifo, &xCanWriteLen, &eStatus);
+
+    if ((ERRO_NONE == eStatus) && (LIN_GW_FRAME_LEN <= xCanWriteLen))
+    {
+        WriteDataInFifo(gs_xLINGWRxFifo, (uint8 *)i_pFrameBuf, LIN_GW_FRAME_LEN, &eStatus);
+
+        if (ERRO_NONE == eStatus)
+        {
+            result = TRUE;
+        }
+    }
+
+    return result;
+}
+
+/* LIN gateway idle: start TX head request, or keep LIN slave in session */
+static void LINGW_DoIdle(void)
+{
+    tLINGWReqInfo *pstReq = NULL_PTR;
+
+    if (0u == gs_ucLINGWReqCnt)
+    {
+        if (0u != gs_stLINGWInfo.xKeepAliveTime)
+        {
+            return;
+        }
+
+        /* Tester present with suppress positive response */
+        pstReq = &gs_astLINGWReqQueue[gs_ucLINGWReqHead];
+        pstReq->aDataBuf[0u] = LIN_GW_TESTER_PRESENT_SID;
+        pstReq->aDataBuf[1u] = 0x80u;
+        pstReq->xDataLen = 2u;
+        pstReq->isBuffered = TRUE;
+        pstReq->isSuppressResp = TRUE;
+        gs_ucLINGWReqCnt++;
+    }
+
+    gs_stLINGWInfo.xTxDataLen = 0u;
+    gs_stLINGWInfo.ucSN = 0u;
+    gs_stLINGWInfo.xMaxWaitTimeout = LINGWTimeToCount(g_stLINGatewayCfgInfo.xNAs);
+    gs_stLINGWInfo.xKeepAliveTime = LINGWTimeToCount(g_stLINGatewayCfgInfo.xKeepAliveTime);
+    gs_stLINGWInfo.eStatus = LINGW_TX_REQ;
+}
+
+/* TX master request frames, one frame in a frame slot */
+static void LINGW_DoTxReq(void)
+{
+    tLINGWReqInfo *pstReq = &gs_astLINGWReqQueue[gs_ucLINGWReqHead];
+    uint8 aFrameBuf[LIN_GW_FRAME_LEN];
+    uint16 xFrameDataLen = 0u;
+    tErroCode eStatus = ERRO_NONE;
+
+    if (0u == gs_stLINGWInfo.xMaxWaitTimeout)
+    {
+        TPDebugPrintf("LIN gateway TX master request timeout!\n");
+        LINGW_FinishHeadReq(FALSE);
+
+        return;
+    }
+
+    if (0u != gs_stLINGWInfo.xFrameSlotTime)
+    {
+        return;
+    }
+
+    fsl_memset(aFrameBuf, LIN_GW_PAD_VALUE, sizeof(aFrameBuf));
+    aFrameBuf[0u] = gs_stLINGWInfo.ucSlaveNAD;
+
+    if (pstReq->xDataLen <= LIN_GW_SF_DATA_MAX_LEN)
+    {
+        aFrameBuf[1u] = LIN_GW_PCI_SF | (uint8)pstReq->xDataLen;
+        xFrameDataLen = pstReq->xDataLen;
+        fsl_memcpy(&aFrameBuf[2u], pstReq->aDataBuf, xFrameDataLen);
+    }
+    else if (0u == gs_stLINGWInfo.xTxDataLen)
+    {
+        aFrameBuf[1u] = LIN_GW_PCI_FF | (uint8)((pstReq->xDataLen >> 8u) & 0x0Fu);
+        aFrameBuf[2u] = (uint8)pstReq->xDataLen;
+        xFrameDataLen = LIN_GW_FF_DATA_LEN;
+        fsl_memcpy(&aFrameBuf[3u], pstReq->aDataBuf, xFrameDataLen);
+    }
+    else
+    {
+        aFrameBuf[1u] = LIN_GW_PCI_CF | (gs_stLINGWInfo.ucSN & 0x0Fu);
+        xFrameDataLen = pstReq->xDataLen - gs_stLINGWInfo.xTxDataLen;
+
+        if (xFrameDataLen > LIN_GW_CF_DATA_LEN)
+        {
+            xFrameDataLen = LIN_GW_CF_DATA_LEN;
+        }
+
+        fsl_memcpy(&aFrameBuf[2u], &pstReq->aDataBuf[gs_stLINGWInfo.xTxDataLen], xFrameDataLen);
+    }
+
+    gs_stLINGWInfo.xFrameSlotTime = LINGWTimeToCount(g_stLINGatewayCfgInfo.xFrameSlotTime);
+
+    /* LIN driver busy, TX again in next frame slot */
+    if (TRUE != g_stLINGatewayCfgInfo.pfMasterReqTx(aFrameBuf))
+    {
+        return;
+    }
+
+    gs_stLINGWInfo.xTxDataLen += xFrameDataLen;
+    gs_stLINGWInfo.ucSN++;
+    gs_stLINGWInfo.xMaxWaitTimeout = LINGWTimeToCount(g_stLINGatewayCfgInfo.xNAs);
+
+    if (gs_stLINGWInfo.xTxDataLen >= pstReq->xDataLen)
+    {
+        /* Drop slave response frames not belong to this request */
+        ClearFIFO(gs_xLINGWRxFifo, &eStatus);
+        gs_stLINGWInfo.ucSN = 0u;
+        gs_stLINGWInfo.xRespDataLen = 0u;
+        gs_stLINGWInfo.xRespRxDataLen = 0u;
+        gs_stLINGWInfo.xMaxWaitTimeout = LINGWTimeToCount(g_stLINGatewayCfgInfo.xSlaveP2);
+        gs_stLINGWInfo.eStatus = LINGW_WAIT_RESP;
+    }
+}
+
+/* Poll slave response frames, one header in a frame slot */
+static void LINGW_DoWaitResp(void)
+{
+    uint8 aFrameBuf[LIN_GW_FRAME_LEN] = {0u};
+    tLen xCanReadLen = 0u;
+    tErroCode eStatus = ERRO_NONE;
+    GetCanReadLen(gs_xLINGWRxFifo, &xCanReadLen, &eStatus);
+
+    while ((ERRO_NONE == eStatus) && (LIN_GW_FRAME_LEN <= xCanReadLen))
+    {
+        ReadDataFromFifo(gs_xLINGWRxFifo, LIN_GW_FRAME_LEN, aFrameBuf, &xCanReadLen, &eStatus);
+
+        if ((ERRO_NONE == eStatus) && (LIN_GW_FRAME_LEN == xCanReadLen))
+        {
+            if (TRUE == LINGW_RxRespFrame(aFrameBuf))
+            {
+                LINGW_FinishHeadReq(TRUE);
+
+                return;
+            }
+        }
+
+        GetCanReadLen(gs_xLINGWRxFifo, &xCanReadLen, &eStatus);
+    }
+
+    if (0u == gs_stLINGWInfo.xMaxWaitTimeout)
+    {
+        LINGW_FinishHeadReq(FALSE);
+
+        return;
+    }
+
+    if (0u == gs_stLINGWInfo.xFrameSlotTime)
+    {
+        gs_stLINGWInfo.xFrameSlotTime = LINGWTimeToCount(g_stLINGatewayCfgInfo.xFrameSlotTime);
+        (void)g_stLINGatewayCfgInfo.pfSlaveRespHeaderTx();
+    }
+}
+
+/* Is request routed to LIN slave? */
+static boolean LINGW_IsRoutedRequest(const uint32 i_xRxId, const uint32 i_xDataLen, const uint8 *i_pDataBuf)
+{
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    if ((TRUE != gs_stLINGWInfo.isRouting) || (0u == i_xDataLen))
+    {
+        return FALSE;
+    }
+
+    /* Function request is for gateway self */
+    if (i_xRxId != TP_GetConfigRxMsgPHYID())
+    {
+        return FALSE;
+    }
+
+    /* Tester present keep gateway in session, gateway keep LIN slave in session */
+    if (LIN_GW_TESTER_PRESENT_SID == i_pDataBuf[0u])
+    {
+        return FALSE;
+    }
+
+    /* Start/stop routing routine control */
+    if ((LIN_GW_ROUTINE_CONTROL_SID == i_pDataBuf[0u]) && (i_xDataLen >= 4u) &&
+            (LIN_GW_ROUTINE_ID_H == i_pDataBuf[2u]) && (LIN_GW_ROUTINE_ID_L == i_pDataBuf[3u]))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Is suppress positive response bit set? */
+static boolean LINGW_IsSuppressPosResp(const uint32 i_xDataLen, const uint8 *i_pDataBuf)
+{
+    boolean result = FALSE;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    if ((i_xDataLen >= 2u) && (0u != (i_pDataBuf[1u] & 0x80u)))
+    {
+        switch (i_pDataBuf[0u])
+        {
+            case 0x10u :
+            case 0x11u :
+            case 0x28u :
+            case 0x31u :
+            case 0x3Eu :
+            case 0x85u :
+                result = TRUE;
+                break;
+
+            default :
+                break;
+        }
+    }
+
+    return result;
+}
+
+/* Move hold request in queue */
+static void LINGW_MoveHoldReqInQueue(void)
+{
+    tLINGWReqInfo *pstReq = NULL_PTR;
+    uint8 aRespBuf[2u] = {0u};
+
+    if ((TRUE != gs_isLINGWHoldReq) || (LIN_GW_REQ_BUF_NUM <= gs_ucLINGWReqCnt))
+    {
+        return;
+    }
+
+    pstReq = &gs_astLINGWReqQueue[(gs_ucLINGWReqHead + gs_ucLINGWReqCnt) % LIN_GW_REQ_BUF_NUM];
+    *pstReq = gs_stLINGWHoldReq;
+    gs_ucLINGWReqCnt++;
+    gs_isLINGWHoldReq = FALSE;
+
+    if (TRUE == pstReq->isBuffered)
+    {
+        LINGW_StopTesterWait();
+        aRespBuf[0u] = LIN_GW_TRANSFER_DATA_SID + 0x40u;
+        aRespBuf[1u] = pstReq->aDataBuf[1u];
+        LINGW_ResponseToTester(sizeof(aRespBuf), aRespBuf);
+    }
+}
+
+/* Clear all requests */
+static void LINGW_ClearAllReq(void)
+{
+    gs_ucLINGWReqHead = 0u;
+    gs_ucLINGWReqCnt = 0u;
+    gs_isLINGWHoldReq = FALSE;
+    gs_stLINGWInfo.eStatus = LINGW_IDLE;
+}
+
+/* Received a slave response frame. If received a whole response return TRUE. */
+static boolean LINGW_RxRespFrame(const uint8 *i_pFrameBuf)
+{
+    const uint8 ucPCI = i_pFrameBuf[1u];
+    uint16 xCopyLen = 0u;
+    ASSERT(NULL_PTR == i_pFrameBuf);
+
+    if (gs_stLINGWInfo.ucSlaveNAD != i_pFrameBuf[0u])
+    {
+        return FALSE;
+    }
+
+    switch (ucPCI & 0xF0u)
+    {
+        case LIN_GW_PCI_SF :
+            xCopyLen = ucPCI & 0x0Fu;
+
+            if ((0u == xCopyLen) || (xCopyLen > LIN_GW_SF_DATA_MAX_LEN))
+            {
+                return FALSE;
+            }
+
+            fsl_memcpy(gs_stLINGWInfo.aRespBuf, &i_pFrameBuf[2u], xCopyLen);
+            gs_stLINGWInfo.xRespDataLen = xCopyLen;
+            gs_stLINGWInfo.xRespRxDataLen = xCopyLen;
+            break;
+
+        case LIN_GW_PCI_FF :
+            gs_stLINGWInfo.xRespDataLen = ((uint16)(ucPCI & 0x0Fu) << 8u) | i_pFrameBuf[2u];
+
+            if ((gs_stLINGWInfo.xRespDataLen <= LIN_GW_SF_DATA_MAX_LEN) ||
+                    (gs_stLINGWInfo.xRespDataLen > LIN_GW_MAX_PDU_LEN))
+            {
+                gs_stLINGWInfo.xRespDataLen = 0u;
+
+                return FALSE;
+            }
+
+            fsl_memcpy(gs_stLINGWInfo.aRespBuf, &i_pFrameBuf[3u], LIN_GW_FF_DATA_LEN);
+            gs_stLINGWInfo.xRespRxDataLen = LIN_GW_FF_DATA_LEN;
+            gs_stLINGWInfo.ucSN = 1u;
+            gs_stLINGWInfo.xMaxWaitTimeout = LINGWTimeToCount(g_stLINGatewayCfgInfo.xNCr);
+
+            return FALSE;
+
+        case LIN_GW_PCI_CF :
+            if (gs_stLINGWInfo.xRespRxDataLen >= gs_stLINGWInfo.xRespDataLen)
+            {
+                return FALSE;
+            }
+
+            if ((ucPCI & 0x0Fu) != (gs_stLINGWInfo.ucSN & 0x0Fu))
+            {
+                /* Wrong SN, drop this response and wait slave response timeout */
+                gs_stLINGWInfo.xRespDataLen = 0u;
+                gs_stLINGWInfo.xRespRxDataLen = 0u;
+
+                return FALSE;
+            }
+
+            xCopyLen = gs_stLINGWInfo.xRespDataLen - gs_stLINGWInfo.xRespRxDataLen;
+
+            if (xCopyLen > LIN_GW_CF_DATA_LEN)
+            {
+                xCopyLen = LIN_GW_CF_DATA_LEN;
+            }
+
+            fsl_memcpy(&gs_stLINGWInfo.aRespBuf[gs_stLINGWInfo.xRespRxDataLen], &i_pFrameBuf[2u], xCopyLen);
+            gs_stLINGWInfo.xRespRxDataLen += xCopyLen;
+            gs_stLINGWInfo.ucSN++;
+            gs_stLINGWInfo.xMaxWaitTimeout = LINGWTimeToCount(g_stLINGatewayCfgInfo.xNCr);
+
+            if (gs_stLINGWInfo.xRespRxDataLen < gs_stLINGWInfo.xRespDataLen)
+            {
+                return FALSE;
+            }
+
+            break;
+
+        default :
+            return FALSE;
+    }
+
+    /* Slave request more time, waiting slave final response */
+    if ((3u == gs_stLINGWInfo.xRespDataLen) &&
+            (NEGTIVE_RESPONSE_ID == gs_stLINGWInfo.aRespBuf[0u]) &&
+            (NRC_SERVICE_BUSY == gs_stLINGWInfo.aRespBuf[2u]))
+    {
+        gs_stLINGWInfo.xRespDataLen = 0u;
+        gs_stLINGWInfo.xRespRxDataLen = 0u;
+        gs_stLINGWInfo.xMaxWaitTimeout = LINGWTimeToCount(g_stLINGatewayCfgInfo.xSlaveP2Ext);
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Finish head request of queue */
+static void LINGW_FinishHeadReq(const boolean i_isReceivedResp)
+{
+    const tLINGWReqInfo *pstReq = &gs_astLINGWReqQueue[gs_ucLINGWReqHead];
+    uint8 ucNRC = 0u;
+
+    if (TRUE == pstReq->isBuffered)
+    {
+        /* Tester got positive response, check slave response here */
+        if (TRUE != pstReq->isSuppressResp)
+        {
+            ucNRC = LINGW_CheckBufferedResp(pstReq, i_isReceivedResp);
+        }
+    }
+    else if (TRUE == i_isReceivedResp)
+    {
+        LINGW_StopTesterWait();
+        LINGW_ResponseToTester(gs_stLINGWInfo.xRespDataLen, gs_stLINGWInfo.aRespBuf);
+    }
+    else if (TRUE != pstReq->isSuppressResp)
+    {
+        TPDebugPrintf("LIN gateway slave no response!\n");
+        LINGW_StopTesterWait();
+        LINGW_ResponseNRCToTester(pstReq->aDataBuf[0u], NRC_CONDITIONS_NOT_CORRECT);
+    }
+    else
+    {
+        /* Suppress positive response and slave no response */
+    }
+
+    gs_ucLINGWReqHead = (gs_ucLINGWReqHead + 1u) % LIN_GW_REQ_BUF_NUM;
+    gs_ucLINGWReqCnt--;
+    gs_stLINGWInfo.eStatus = LINGW_IDLE;
+
+    if (0u != ucNRC)
+    {
+        LINGW_SetLateError(ucNRC);
+    }
+}
+
+/* Check slave response of a buffered request. Return 0 if positive, else NRC. */
+static uint8 LINGW_CheckBufferedResp(const tLINGWReqInfo *i_pstReq, const boolean i_isReceivedResp)
+{
+    uint8 ucNRC = 0u;
+    ASSERT(NULL_PTR == i_pstReq);
+
+    if (TRUE != i_isReceivedResp)
+    {
+        ucNRC = NRC_GENERAL_PROGRAMMING_FAILURE;
+    }
+    else if ((NEGTIVE_RESPONSE_ID == gs_stLINGWInfo.aRespBuf[0u]) && (3u <= gs_stLINGWInfo.xRespDataLen))
+    {
+        ucNRC = gs_stLINGWInfo.aRespBuf[2u];
+    }
+    else if (((i_pstReq->aDataBuf[0u] + 0x40u) != gs_stLINGWInfo.aRespBuf[0u]) ||
+             (i_pstReq->aDataBuf[1u] != gs_stLINGWInfo.aRespBuf[1u]))
+    {
+        /* Block sequence counter not match */
+        ucNRC = NRC_GENERAL_PROGRAMMING_FAILURE;
+    }
+    else
+    {
+        ucNRC = 0u;
+    }
+
+    return ucNRC;
+}
+
+/* A buffered request failed. Report it to the waiting tester, or to next tester request. */
+static void LINGW_SetLateError(const uint8 i_ucNRC)
+{
+    TPDebugPrintf("LIN gateway buffered request failed, NRC = %X\n", i_ucNRC);
+
+    /* Following requests depend on the failed one, drop them */
+    LINGW_ClearAllReq();
+
+    if (TRUE == gs_stLINGWInfo.isTesterWaiting)
+    {
+        LINGW_ResponseNRCToTester(gs_stLINGWInfo.ucTesterWaitSID, i_ucNRC);
+        LINGW_StopTesterWait();
+    }
+    else
+    {
+        gs_stLINGWInfo.ucLateNRC = i_ucNRC;
+    }
+}
+
+/* Start tester P2 timer */
+static void LINGW_StartTesterWait(const uint8 i_ucSID)
+{
+    gs_stLINGWInfo.isTesterWaiting = TRUE;
+    gs_stLINGWInfo.ucTesterWaitSID = i_ucSID;
+    gs_stLINGWInfo.xTesterP2Time =
+        LINGWTimeToCount((g_stLINGatewayCfgInfo.xP2Server * LIN_GW_P2_WATERMARK_PERCENT) / 100u);
+}
+
+/* Stop tester P2 timer */
+static void LINGW_StopTesterWait(void)
+{
+    gs_stLINGWInfo.isTesterWaiting = FALSE;
+    gs_stLINGWInfo.xTesterP2Time = 0u;
+}
+
+/* Send NRC 0x78 if tester P2 timer timeout */
+static void LINGW_CheckTesterP2(void)
+{
+    if ((TRUE != gs_stLINGWInfo.isTesterWaiting) || (0u != gs_stLINGWInfo.xTesterP2Time))
+    {
+        return;
+    }
+
+    LINGW_ResponseNRCToTester(gs_stLINGWInfo.ucTesterWaitSID, NRC_SERVICE_BUSY);
+    gs_stLINGWInfo.xTesterP2Time =
+        LINGWTimeToCount((g_stLINGatewayCfgInfo.xP2ExtServer * LIN_GW_P2_WATERMARK_PERCENT) / 100u);
+    RestartS3Server();
+}
+
+/* Response to tester */
+static void LINGW_ResponseToTester(const uint16 i_xDataLen, const uint8 *i_pDataBuf)
+{
+    const tTPChannel eCurChannel = TP_GetCurChannel();
+    ASSERT(NULL_PTR == i_pDataBuf);
+    /* Slave response comes later, current channel may be changed by requests of other channels */
+    TP_SetCurChannel(gs_stLINGWInfo.eTesterChannel);
+    (void)TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), NULL_PTR, i_xDataLen, i_pDataBuf);
+    TP_SetCurChannel(eCurChannel);
+}
+
+/* Response negative code to tester */
+static void LINGW_ResponseNRCToTester(const uint8 i_ucSID, const uint8 i_ucNRC)
+{
+    uint8 aRespBuf[3u] = {0u};
+    aRespBuf[0u] = NEGTIVE_RESPONSE_ID;
+    aRespBuf[1u] = i_ucSID;
+    aRespBuf[2u] = i_ucNRC;
+    LINGW_ResponseToTester(sizeof(aRespBuf), aRespBuf);
+}
+
+#endif /* EN_CAN_LIN_GATEWAY */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
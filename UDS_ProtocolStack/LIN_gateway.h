@@ -0,0 +1,40 @@
+/*
+ * @ : LIN_gateway.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef LIN_GATEWAY_H_
+#define LIN_GATEWAY_H_
+
+#include "LIN_gateway_cfg.h"
+
+#ifdef EN_CAN_LIN_GATEWAY
+
+/* Routine control ID for start(0x01)/stop(0x02) routing to LIN slave */
+#define LIN_GW_ROUTINE_ID_H (0xF0u)
+#define LIN_GW_ROUTINE_ID_L (0x00u)
+
+void LINGW_Init(void);
+
+void LINGW_MainFun(void);
+
+void LINGW_SystemTickCtl(void);
+
+boolean LINGW_StartRouting(const uint8 i_ucSlaveNAD);
+
+void LINGW_StopRouting(void);
+
+boolean LINGW_IsRouting(void);
+
+boolean LINGW_RouteRequest(const uint32 i_xRxId, const uint32 i_xDataLen, const uint8 *i_pDataBuf);
+
+boolean LINGW_DriverWriteSlaveResp(const uint8 *i_pFrameBuf);
+
+#endif /* EN_CAN_LIN_GATEWAY */
+
+#endif /* LIN_GATEWAY_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
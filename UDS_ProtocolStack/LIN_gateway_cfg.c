@@ -0,0 +1,33 @@
+/*
+ * @ : LIN_gateway_cfg.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "LIN_gateway_cfg.h"
+
+#ifdef EN_CAN_LIN_GATEWAY
+
+/* LIN gateway config info */
+const tLINGatewayCfg g_stLINGatewayCfgInfo =
+{
+    1u,                         /* Called LIN gateway main function period */
+    10u,                        /* Frame slot 10ms */
+    50u,                        /* P2 */
+    5000u,                      /* P2* */
+    1000u,                      /* Slave P2 */
+    5000u,                      /* Slave P2* */
+    500u,                       /* N_Cr, same as LIN TP slave */
+    300u,                       /* N_As, same as LIN TP slave */
+    2000u,                      /* Keep LIN slave in session, less than slave S3 */
+    /* TODO Bootloader: #07 LIN master driver: TX master request frame (0x3C) with 8 bytes data */
+    NULL_PTR,                   /* TX master request frame */
+    /* TODO Bootloader: #08 LIN master driver: TX slave response header (0x3D), call LINGW_DriverWriteSlaveResp when received */
+    NULL_PTR,                   /* TX slave response header */
+};
+
+#endif /* EN_CAN_LIN_GATEWAY */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
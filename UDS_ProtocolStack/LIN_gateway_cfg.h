@@ -0,0 +1,58 @@
+/*
+ * @ : LIN_gateway_cfg.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef LIN_GATEWAY_CFG_H_
+#define LIN_GATEWAY_CFG_H_
+
+#include "includes.h"
+
+#ifdef EN_CAN_LIN_GATEWAY
+
+/*******************************************************
+**  Description : CAN to LIN gateway configuration file.
+**  This ECU is LIN master, tester requests received
+**  over CAN TP are routed to a LIN slave (ISO 17987-2).
+*******************************************************/
+
+typedef unsigned short tLINGWTime;
+
+/* Transmit a master request frame (0x3C). Return TRUE if LIN driver accepted the frame.
+   Routing is refused (NRC 0x22) while the LIN driver hooks are NULL_PTR. */
+typedef boolean (*tpfLINMasterReqTx)(const uint8 *i_pFrameBuf);
+
+/* Transmit a slave response header (0x3D). Slave data is given back by LINGW_DriverWriteSlaveResp. */
+typedef boolean (*tpfLINSlaveRespHeaderTx)(void);
+
+#define LIN_GW_MASTER_REQ_ID (0x3Cu)  /* Master request frame ID */
+#define LIN_GW_SLAVE_RESP_ID (0x3Du)  /* Slave response frame ID */
+#define LIN_GW_FRAME_LEN (8u)         /* LIN diagnostic frame length */
+#define LIN_GW_MAX_PDU_LEN (150u)     /* Max routed request/response len, same as UDS APP buffer */
+
+typedef struct
+{
+    uint8 ucCalledPeriod;                       /* Called LIN gateway main function period */
+    tLINGWTime xFrameSlotTime;                  /* Diagnostic frame slot in LIN schedule table */
+    tLINGWTime xP2Server;                       /* Tester P2 server time */
+    tLINGWTime xP2ExtServer;                    /* Tester P2* server time */
+    tLINGWTime xSlaveP2;                        /* Wait slave response time */
+    tLINGWTime xSlaveP2Ext;                     /* Wait slave response time after slave NRC 0x78 */
+    tLINGWTime xNCr;                            /* Wait slave consecutive frame time */
+    tLINGWTime xNAs;                            /* Wait LIN driver accept master request frame time */
+    tLINGWTime xKeepAliveTime;                  /* Tester present period to LIN slave when routing */
+    tpfLINMasterReqTx pfMasterReqTx;            /* LIN driver TX master request frame */
+    tpfLINSlaveRespHeaderTx pfSlaveRespHeaderTx;/* LIN driver TX slave response header */
+} tLINGatewayCfg;
+
+/* LIN gateway config info */
+extern const tLINGatewayCfg g_stLINGatewayCfgInfo;
+
+#endif /* EN_CAN_LIN_GATEWAY */
+
+#endif /* LIN_GATEWAY_CFG_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
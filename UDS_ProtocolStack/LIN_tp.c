@@ -402,55 +402,7 @@ static const tLINTpFunInfo gs_astLINTpFunInfo[] =
 
 void LINTP_Init(void)
 {
-    tErroCode eStatus;
-    ApplyFifo(RX_TP_QUEUE_LEN, RX_TP_QUEUE_ID, &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-        TPDebugPrintf("Apply FIFO RX error!\n");
-
-        while (1)
-        {
-        }
-    }
-
-    ApplyFifo(TX_TP_QUEUE_LEN, TX_TP_QUEUE_ID, &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-#ifdef EN_TP_DEBUG
-        TPDebugPrintf("Apply FIFO TX error code!\n");
-#endif
-
-        while (1)
-        {
-        }
-    }
-
-    ApplyFifo(RX_BUS_FIFO_LEN, RX_BUS_FIFO, &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-        TPDebugPrintf("Apply RX FIFO from BUS error code!\n");
-
-        while (1)
-        {
-        }
-    }
-
-#ifdef EN_LIN_TP
-    ApplyFifo(TX_BUS_FIFO_LEN, TX_BUS_FIFO, &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-        TPDebugPrintf("Apply TX FIFO TO BUS error code!\n");
-
-        while (1)
-        {
-        }
-    }
-
-#endif
+    /* TP FIFOs are defined at compile time in TP_cfg.c, nothing to apply */
 }
 
 /* CAN TP system tick control. This function should period called by system. */
@@ -548,7 +500,6 @@ static uint8 LINTP_CopyAFrameDataInRxFifo(const tUdsId i_xRxCanID,
                                           const uint8 *i_pucDataBuf)
 {
     tErroCode eStatus;
-    tLen xCanWriteLen = 0u;
     tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
     ASSERT(NULL_PTR == i_pucDataBuf);
 
@@ -557,27 +508,12 @@ static uint8 LINTP_CopyAFrameDataInRxFifo(const tUdsId i_xRxCanID,
         return FALSE;
     }
 
-    /* Check CAN write data len */
-    GetCanWriteLen(RX_TP_QUEUE_ID, &xCanWriteLen, &eStatus);
-
-    if ((ERRO_NONE != eStatus) || (xCanWriteLen < (i_xRxDataLen + sizeof(tUDSAndTPExchangeMsgInfo))))
-    {
-        return FALSE;
-    }
-
     exchangeMsgInfo.msgID = i_xRxCanID;
     exchangeMsgInfo.dataLen = i_xRxDataLen;
     exchangeMsgInfo.pfCallBack = NULL_PTR;
-    /* Write data UDS transmit ID and data len */
-    WriteDataInFifo(RX_TP_QUEUE_ID, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-        return FALSE;
-    }
-
-    /* Write data in FIFO */
-    WriteDataInFifo(RX_TP_QUEUE_ID, (uint8 *)i_pucDataBuf, i_xRxDataLen, &eStatus);
+    exchangeMsgInfo.channel = (uint32)TP_LIN_CHANNEL;
+    /* Write UDS transmit ID, data len and data */
+    PushMsgInFifo(g_xRxTPQueue, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), i_pucDataBuf, i_xRxDataLen, &eStatus);
 
     if (ERRO_NONE != eStatus)
     {
@@ -598,32 +534,14 @@ static uint8 LINTP_CopyAFrameFromFifoToBuf(tUdsId *o_pxTxCanID,
     ASSERT(NULL_PTR == o_pxTxCanID);
     ASSERT(NULL_PTR == o_pucTxDataLen);
     ASSERT(NULL_PTR == o_pucDataBuf);
-    /* CAN read data from buffer */
-    GetCanReadLen(TX_TP_QUEUE_ID, &xRealReadLen, &eStatus);
-
-    if ((ERRO_NONE != eStatus) || (0u == xRealReadLen) || (xRealReadLen < sizeof(tUDSAndTPExchangeMsgInfo)))
-    {
-        return FALSE;
-    }
-
-    /* Read receive ID */
-    ReadDataFromFifo(TX_TP_QUEUE_ID,
-                     sizeof(tUDSAndTPExchangeMsgInfo),
-                     (uint8 *)&exchangeMsgInfo,
-                     &xRealReadLen,
-                     &eStatus);
-
-    if (ERRO_NONE != eStatus || sizeof(tUDSAndTPExchangeMsgInfo) != xRealReadLen)
-    {
-        return FALSE;
-    }
-
-    /* Read data from FIFO */
-    ReadDataFromFifo(TX_TP_QUEUE_ID,
-                     exchangeMsgInfo.dataLen,
-                     o_pucDataBuf,
-                     &xRealReadLen,
-                     &eStatus);
+    /* Read UDS transmit ID, data len and data */
+    PopMsgFromFifo(g_xLINTxTPQueue,
+                   (uint8 *)&exchangeMsgInfo,
+                   sizeof(tUDSAndTPExchangeMsgInfo),
+                   o_pucDataBuf,
+                   MAX_CF_DATA_LEN,
+                   &xRealReadLen,
+                   &eStatus);
 
     if (ERRO_NONE != eStatus || exchangeMsgInfo.dataLen != xRealReadLen)
     {
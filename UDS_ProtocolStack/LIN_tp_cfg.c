@@ -14,6 +14,7 @@
 #ifdef EN_LIN_TP
 
 #include "multi_cyc_fifo.h"
+#include "LIN_tp.h"
 
 static tpfAbortTxMsg gs_pfLINTPAbortTxMsg = NULL_PTR;
 static tpfNetTxCallBack gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
@@ -34,26 +35,47 @@ static void LINTP_AbortTxMsg(void);
 static boolean LINTP_ClearTXBUSFIFO(void);
 
 
+/* Define LIN TP TX queue and BUS FIFOs at compile time */
+FIFO_DEFINE(gs_stLINTxTPQueue, LIN_TX_TP_QUEUE_ID, TX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stLINRxBusFifo, LIN_RX_BUS_FIFO, LIN_RX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stLINTxBusFifo, LIN_TX_BUS_FIFO, LIN_TX_BUS_FIFO_LEN);
+
+const tFifoHandle g_xLINTxTPQueue = &gs_stLINTxTPQueue;        /* LIN TP TX queue */
+static const tFifoHandle gs_xRxBusFifo = &gs_stLINRxBusFifo;  /* RX bus FIFO */
+static const tFifoHandle gs_xTxBusFifo = &gs_stLINTxBusFifo;  /* TX bus FIFO */
+
+/* LIN TP channel config */
+const tTPChannelCfg g_stLINTPChannelCfg =
+{
+    LINTP_Init,                    /* TP init */
+    LINTP_MainFun,                 /* TP main function */
+    LINTP_SytstemTickControl,      /* TP system tick control */
+    LINTP_GetConfigTxMsgID,        /* Get TX message ID */
+    LINTP_GetConfigRxMsgFUNID,     /* Get RX function ID */
+    LINTP_GetConfigRxMsgPHYID,     /* Get RX physical ID */
+    &gs_stLINTxTPQueue,            /* TX TP queue */
+};
+
 /* UDS network layer config info */
 const tUdsLINNetLayerCfg g_stUdsLINNetLayerCfgInfo =
 {
-    1u,                 /* Called LIN TP main function period */
-    RX_BOARD_ID,        /* LIN TP RX broadcast ID */
-    RX_FUN_ADDR_ID,     /* LIN TP RX FUN ID */
-    RX_PHY_ADDR_ID,     /* LIN TP RX PHY ID */
-    TX_RESP_ADDR_ID,    /* LIN TP TX RESP ID */
-    0u,                 /* BS = block size */
-    0u,                 /* STmin */
-    300u,               /* N_As */
-    300u,               /* N_Ar */
-    300u,               /* N_Bs */
-    0u,                 /* N_Br */
-    300u,               /* N_Cs < 0.9 N_Cr */
-    500u,               /* N_Cr */
-    0u,                 /* Max blocking time 0ms, > 0u mean waiting send successful. equal 0 is not waiting. */
-    LINTP_TxMsg,        /* LIN TP TX */
-    LINTP_RxMsg,        /* LIN TP RX */
-    LINTP_AbortTxMsg,   /* Abort TX message */
+    1u,                  /* Called LIN TP main function period */
+    LIN_RX_BOARD_ID,     /* LIN TP RX broadcast ID */
+    LIN_RX_FUN_ADDR_ID,  /* LIN TP RX FUN ID */
+    LIN_RX_PHY_ADDR_ID,  /* LIN TP RX PHY ID */
+    LIN_TX_RESP_ADDR_ID, /* LIN TP TX RESP ID */
+    0u,                  /* BS = block size */
+    0u,                  /* STmin */
+    300u,                /* N_As */
+    300u,                /* N_Ar */
+    300u,                /* N_Bs */
+    0u,                  /* N_Br */
+    300u,                /* N_Cs < 0.9 N_Cr */
+    500u,                /* N_Cr */
+    0u,                  /* Max blocking time 0ms, > 0u mean waiting send successful. equal 0 is not waiting. */
+    LINTP_TxMsg,         /* LIN TP TX */
+    LINTP_RxMsg,         /* LIN TP RX */
+    LINTP_AbortTxMsg,    /* Abort TX message */
 };
 
 
@@ -64,11 +86,10 @@ static uint8 LINTP_TxMsg(const tUdsId i_xTxId,
                          const tpfNetTxCallBack i_pfNetTxCallBack,
                          const uint32 txBlockingMaxtime)
 {
-    tLen xCanWriteDataLen = 0u;
     tErroCode eStatus;
-    uint8 aMsgBuf[8] = {0};
-    tTPTxMsgHeader TxMsgInfo;
-    const uint32 msgInfoLen = sizeof(tTPTxMsgHeader) + sizeof(aMsgBuf);
+    tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    uint8 *pucMsgBuf = NULL_PTR;
+    const tLen xMsgLen = (tLen)(sizeof(tTPTxMsgHeader) + 8u);
     ASSERT(NULL_PTR == i_pDataBuf);
 
     if (i_DataLen > 7u)
@@ -76,30 +97,26 @@ static uint8 LINTP_TxMsg(const tUdsId i_xTxId,
         return FALSE;
     }
 
-    GetCanWriteLen(TX_BUS_FIFO, &xCanWriteDataLen, &eStatus);
+    /* Build TX message in TX BUS FIFO, if TX BUS FIFO is full nothing is written */
+    pstTxMsgInfo = (tTPTxMsgHeader *)ReserveMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
 
-    if ((ERRO_NONE == eStatus) && (msgInfoLen <= xCanWriteDataLen))
+    if (ERRO_NONE != eStatus)
     {
-        TxMsgInfo.TxMsgID = i_xTxId;
-        TxMsgInfo.TxMsgLength = sizeof(aMsgBuf);
-        TxMsgInfo.TxMsgCallBack = (uint32)i_pfNetTxCallBack;
-        aMsgBuf[0u] = (uint8)i_xTxId;
-        fsl_memcpy(&aMsgBuf[1u], i_pDataBuf, i_DataLen);
-        WriteDataInFifo(TX_BUS_FIFO, (uint8 *)&TxMsgInfo, sizeof(tTPTxMsgHeader), &eStatus);
-
-        if (ERRO_NONE != eStatus)
-        {
-            ClearFIFO(TX_BUS_FIFO, &eStatus);
-            return FALSE;
-        }
+        return FALSE;
+    }
 
-        WriteDataInFifo(TX_BUS_FIFO, (uint8 *)aMsgBuf, 8, &eStatus);
+    pstTxMsgInfo->TxMsgID = i_xTxId;
+    pstTxMsgInfo->TxMsgLength = 8u;
+    pstTxMsgInfo->TxMsgCallBack = (uint32)i_pfNetTxCallBack;
+    pucMsgBuf = (uint8 *)(pstTxMsgInfo + 1u);
+    fsl_memset(pucMsgBuf, 0u, 8u);
+    pucMsgBuf[0u] = (uint8)i_xTxId;
+    fsl_memcpy(&pucMsgBuf[1u], i_pDataBuf, i_DataLen);
+    CommitMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
 
-        if (ERRO_NONE != eStatus)
-        {
-            ClearFIFO(TX_BUS_FIFO, &eStatus);
-            return FALSE;
-        }
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
     }
 
     return TRUE;
@@ -110,60 +127,49 @@ static uint8 LINTP_RxMsg(tUdsId *o_pxRxId,
                          uint8 *o_pRxDataLen,
                          uint8 *o_pRxBuf)
 {
-    tLen xCanRxDataLen = 0u;
-    tLen xReadDataLen = 0u;
+    uint8 result = FALSE;
+    tLen xMsgLen = 0u;
     tErroCode eStatus;
-    tRxMsgInfo stRxCanMsg = {0u};
+    const tRxMsgInfo *pstRxCanMsg = NULL_PTR;
     uint8 ucIndex = 0u;
-    const uint32 headerLen = sizeof(stRxCanMsg.rxDataId) + sizeof(stRxCanMsg.rxDataLen);
+    const uint32 headerLen = sizeof(pstRxCanMsg->rxDataId) + sizeof(pstRxCanMsg->rxDataLen);
     ASSERT(NULL_PTR == o_pxRxId);
     ASSERT(NULL_PTR == o_pRxBuf);
     ASSERT(NULL_PTR == o_pRxDataLen);
-    GetCanReadLen(RX_BUS_FIFO, &xCanRxDataLen, &eStatus);
+    pstRxCanMsg = (const tRxMsgInfo *)PeekMsgFromFifo(gs_xRxBusFifo, &xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
 
-    if ((ERRO_NONE == eStatus) && (headerLen <= xCanRxDataLen))
+    /* Parse RX message in RX BUS FIFO */
+    if ((headerLen <= xMsgLen) &&
+            ((xMsgLen - headerLen) == pstRxCanMsg->rxDataLen) &&
+            (TRUE == LINTP_IsReceivedMsgIDValid(pstRxCanMsg->rxDataId)))
     {
-        ReadDataFromFifo(RX_BUS_FIFO,
-                         headerLen,
-                         (uint8 *)&stRxCanMsg,
-                         &xReadDataLen,
-                         &eStatus);
+        *o_pxRxId = pstRxCanMsg->rxDataId;
+        *o_pRxDataLen = pstRxCanMsg->rxDataLen;
 
-        if ((ERRO_NONE == eStatus) && (headerLen <= xCanRxDataLen))
+        for (ucIndex = 0u; ucIndex < pstRxCanMsg->rxDataLen; ucIndex++)
         {
-            ReadDataFromFifo(RX_BUS_FIFO,
-                             stRxCanMsg.rxDataLen,
-                             (uint8 *)&stRxCanMsg.aucDataBuf,
-                             &xCanRxDataLen,
-                             &eStatus);
-
-            if (TRUE != LINTP_IsReceivedMsgIDValid(stRxCanMsg.rxDataId))
-            {
-                return FALSE;
-            }
-
-            *o_pxRxId = stRxCanMsg.rxDataId;
-            *o_pRxDataLen = stRxCanMsg.rxDataLen;
-
-            for (ucIndex = 0u; ucIndex < stRxCanMsg.rxDataLen; ucIndex++)
-            {
-                o_pRxBuf[ucIndex] = stRxCanMsg.aucDataBuf[ucIndex];
-            }
-
-            return TRUE;
+            o_pRxBuf[ucIndex] = pstRxCanMsg->aucDataBuf[ucIndex];
         }
+
+        result = TRUE;
     }
 
-    return FALSE;
+    ReleaseMsgFromFifo(gs_xRxBusFifo, &eStatus);
+
+    return result;
 }
 
 /* Write data in LIN TP */
 boolean LINTP_DriverWriteDataInLINTP(const uint32 i_RxNAD, const uint32 i_dataLen, const uint8 *i_pDataBuf)
 {
-    tLen xCanWriteDataLen = 0u;
     tErroCode eStatus;
-    tRxMsgInfo stRxCanMsg;
-    const uint32 headerLen = sizeof(stRxCanMsg.rxDataId) + sizeof(stRxCanMsg.rxDataLen);
+    tRxMsgInfo *pstRxCanMsg = NULL_PTR;
+    const uint32 headerLen = sizeof(pstRxCanMsg->rxDataId) + sizeof(pstRxCanMsg->rxDataLen);
     ASSERT(NULL_PTR == i_pDataBuf);
 
     if (i_dataLen > 7u)
@@ -171,25 +177,28 @@ boolean LINTP_DriverWriteDataInLINTP(const uint32 i_RxNAD, const uint32 i_dataLe
         return FALSE;
     }
 
-    GetCanWriteLen(RX_BUS_FIFO, &xCanWriteDataLen, &eStatus);
+    pstRxCanMsg = (tRxMsgInfo *)ReserveMsgInFifo(gs_xRxBusFifo, (tLen)(headerLen + i_dataLen), &eStatus);
 
-    if ((ERRO_NONE == eStatus) && ((i_dataLen + headerLen) <= xCanWriteDataLen))
+    /* If RX BUS FIFO is full, this frame is lost and TP will check timeout. */
+    if (ERRO_OVER_MAX == eStatus)
     {
-        stRxCanMsg.rxDataId = i_RxNAD;
-        stRxCanMsg.rxDataLen = i_dataLen;
-        WriteDataInFifo(RX_BUS_FIFO, (uint8 *)&stRxCanMsg, headerLen, &eStatus);
+        return TRUE;
+    }
 
-        if (ERRO_NONE != eStatus)
-        {
-            return FALSE;
-        }
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
 
-        WriteDataInFifo(RX_BUS_FIFO, (uint8 *)i_pDataBuf, stRxCanMsg.rxDataLen, &eStatus);
+    /* Build RX message in RX BUS FIFO */
+    pstRxCanMsg->rxDataId = i_RxNAD;
+    pstRxCanMsg->rxDataLen = i_dataLen;
+    fsl_memcpy(pstRxCanMsg->aucDataBuf, i_pDataBuf, i_dataLen);
+    CommitMsgInFifo(gs_xRxBusFifo, (tLen)(headerLen + i_dataLen), &eStatus);
 
-        if (ERRO_NONE != eStatus)
-        {
-            return FALSE;
-        }
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
     }
 
     return TRUE;
@@ -199,44 +208,27 @@ boolean LINTP_DriverWriteDataInLINTP(const uint32 i_RxNAD, const uint32 i_dataLe
 boolean LINTP_DriverReadDataFromLINTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
 {
     boolean result = FALSE;
-    tLen xCanRxDataLen = 0u;
+    tLen xReadDataLen = 0u;
     tErroCode eStatus;
     tTPTxMsgHeader TxMsgInfo;
-    const uint32 msgInfoLen = sizeof(tTPTxMsgHeader);
     ASSERT(NULL_PTR == o_pReadDataBuf);
     ASSERT(NULL_PTR == o_pstTxMsgHeader);
     ASSERT(8u != i_readDataLen);
-    GetCanReadLen(TX_BUS_FIFO, &xCanRxDataLen, &eStatus);
-
-    if ((ERRO_NONE == eStatus) && (xCanRxDataLen >= (i_readDataLen + msgInfoLen)))
+    PopMsgFromFifo(gs_xTxBusFifo,
+                   (uint8 *)&TxMsgInfo,
+                   sizeof(tTPTxMsgHeader),
+                   o_pReadDataBuf,
+                   (tLen)i_readDataLen,
+                   &xReadDataLen,
+                   &eStatus);
+
+    if ((ERRO_NONE == eStatus) && (xReadDataLen == i_readDataLen))
     {
-        ReadDataFromFifo(TX_BUS_FIFO,
-                         sizeof(tTPTxMsgHeader),
-                         (uint8 *)&TxMsgInfo,
-                         &xCanRxDataLen,
-                         &eStatus);
-
-        if ((ERRO_NONE == eStatus) && (xCanRxDataLen == sizeof(tTPTxMsgHeader)))
-        {
-            result = TRUE;
-        }
+        result = TRUE;
+        *o_pstTxMsgHeader = TxMsgInfo;
 
-        if (TRUE == result)
-        {
-            ReadDataFromFifo(TX_BUS_FIFO,
-                             i_readDataLen,
-                             o_pReadDataBuf,
-                             &xCanRxDataLen,
-                             &eStatus);
-
-            if ((ERRO_NONE == eStatus) && (xCanRxDataLen == i_readDataLen))
-            {
-                result = TRUE;
-                *o_pstTxMsgHeader = TxMsgInfo;
-                /* Storage callback, if user want to TX message callback please call TP_DoTxMsgSuccesfulCallback or self call callback */
-                gs_pfTxMsgSuccessfulCallBack = (tpfNetTxCallBack)TxMsgInfo.TxMsgCallBack;
-            }
-        }
+        /* Storage callback, if user want to TX message callback please call TP_DoTxMsgSuccesfulCallback or self call callback */
+        gs_pfTxMsgSuccessfulCallBack = (tpfNetTxCallBack)TxMsgInfo.TxMsgCallBack;
     }
 
     return result;
@@ -247,7 +239,7 @@ static boolean LINTP_ClearTXBUSFIFO(void)
 {
     boolean result = FALSE;
     tErroCode eStatus = ERRO_NONE;
-    ClearFIFO(TX_BUS_FIFO, &eStatus);
+    ClearFIFO(gs_xTxBusFifo, &eStatus);
 
     if (ERRO_NONE == eStatus)
     {
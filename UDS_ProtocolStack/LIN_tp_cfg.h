@@ -21,22 +21,29 @@
 **  Description : ISO 17987-2 configuration file
 *******************************************************/
 
-typedef uint32 tUdsId;
-typedef uint32 tUdsLen;
-typedef unsigned short tNetTime;
-typedef unsigned short tBlockSize;
-typedef void (*tpfNetTxCallBack)(void);
-typedef unsigned char (*tNetTxMsg)(const tUdsId, const unsigned short, const unsigned char *, const tpfNetTxCallBack, const uint32);
-typedef unsigned char (*tNetRx)(tUdsId *, unsigned char *, unsigned char *);
 typedef unsigned short tLINTpDataLen;
-typedef void (*tpfAbortTxMsg)(void);
 
 #define DATA_LEN (7u)
 
 #define SF_DATA_MAX_LEN (6u)   /* Max Single Frame data len */
 #define FF_DATA_MIN_LEN (7u)   /* Min First Frame data len */
 #define CF_DATA_MAX_LEN (6u)   /* Single Consecutive frame max data len */
-#define MAX_CF_DATA_LEN (150u) /* Max First Frame data len */
+#define MAX_CF_DATA_LEN (TP_MAX_MSG_LEN) /* Max First Frame data len */
+
+#if (MAX_CF_DATA_LEN > TP_MAX_MSG_LEN)
+#error "MAX_CF_DATA_LEN is more than TP_MAX_MSG_LEN"
+#endif
+
+/* FF len is 12 bits */
+#if (MAX_CF_DATA_LEN > 0xFFFu)
+#error "MAX_CF_DATA_LEN is more than 4095"
+#endif
+
+#define LIN_TX_TP_QUEUE_ID ('L')   /* LIN TP TX queue ID */
+
+#if !IsBusFifoLenValid(LIN_RX_BUS_FIFO_LEN) || !IsBusFifoLenValid(LIN_TX_BUS_FIFO_LEN)
+#error "LIN BUS FIFO len should be power of 2 and not too small for a frame message"
+#endif
 
 typedef struct
 {
@@ -62,6 +69,9 @@ typedef struct
 /* UDS network layer config info */
 extern const tUdsLINNetLayerCfg g_stUdsLINNetLayerCfgInfo;
 
+/* UDS send message to LIN TP queue */
+extern const tFifoHandle g_xLINTxTPQueue;
+
 
 tUdsId LINTP_GetConfigTxMsgID(void);
 
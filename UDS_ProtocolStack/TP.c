@@ -10,15 +10,6 @@
  */
 
 #include "TP.h"
-
-#ifdef EN_CAN_TP
-#include "can_tp.h"
-#endif
-
-#ifdef EN_LIN_TP
-#include "LIN_TP.h"
-#endif
-
 #include "multi_cyc_fifo.h"
 
 /*FUNCTION**********************************************************************
@@ -30,13 +21,12 @@
  *END**************************************************************************/
 void TP_Init(void)
 {
-#ifdef EN_CAN_TP
-    CANTP_Init();
-#endif
+    uint8 index = 0u;
 
-#ifdef EN_LIN_TP
-    LINTP_Init();
-#endif
+    for (index = 0u; index < (uint8)TP_CHANNEL_NUM; index++)
+    {
+        TP_GetChannelCfg((tTPChannel)index)->pfInit();
+    }
 }
 
 /*FUNCTION**********************************************************************
@@ -48,28 +38,27 @@ void TP_Init(void)
  *END**************************************************************************/
 void TP_MainFun(void)
 {
-#ifdef EN_CAN_TP
-    CANTP_MainFun();
-#endif
+    uint8 index = 0u;
 
-#ifdef EN_LIN_TP
-    LINTP_MainFun();
-#endif
+    for (index = 0u; index < (uint8)TP_CHANNEL_NUM; index++)
+    {
+        TP_GetChannelCfg((tTPChannel)index)->pfMainFun();
+    }
 }
 
 /* TP system tick control */
 void TP_SystemTickCtl(void)
 {
-#ifdef EN_CAN_TP
-    CANTP_SytstemTickControl();
-#endif
+    uint8 index = 0u;
 
-#ifdef EN_LIN_TP
-    LINTP_SytstemTickControl();
-#endif
+    for (index = 0u; index < (uint8)TP_CHANNEL_NUM; index++)
+    {
+        TP_GetChannelCfg((tTPChannel)index)->pfSystemTickCtl();
+    }
 }
 
-/* Read a frame from TP RX FIFO. If no data can read return FALSE, else return TRUE */
+/* Read a frame from TP RX FIFO. If no data can read return FALSE, else return TRUE.
+   The channel received this frame becomes current channel, UDS response is TX on it. */
 boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID,
                                 uint32 *o_pxRxDataLen,
                                 uint8 *o_pDataBuf)
@@ -80,59 +69,46 @@ boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID,
     ASSERT(NULL_PTR == o_pRxMsgID);
     ASSERT(NULL_PTR == o_pDataBuf);
     ASSERT(NULL_PTR == o_pxRxDataLen);
-    /* CAN read data from buffer */
-    GetCanReadLen(RX_TP_QUEUE_ID, &xReadDataLen, &eStatus);
-
-    if (ERRO_NONE != eStatus || (xReadDataLen < sizeof(tUDSAndTPExchangeMsgInfo)))
+    /* Read receive ID, data len and data */
+    PopMsgFromFifo(g_xRxTPQueue,
+                   (uint8 *)&exchangeMsgInfo,
+                   sizeof(exchangeMsgInfo),
+                   o_pDataBuf,
+                   TP_MAX_MSG_LEN,
+                   &xReadDataLen,
+                   &eStatus);
+
+    if (ERRO_NO_MSG == eStatus)
     {
         return FALSE;
     }
 
-    /* Read receive ID and data len */
-    ReadDataFromFifo(RX_TP_QUEUE_ID,
-                     sizeof(exchangeMsgInfo),
-                     (uint8 *)&exchangeMsgInfo,
-                     &xReadDataLen,
-                     &eStatus);
-
-    if (ERRO_NONE != eStatus || sizeof(exchangeMsgInfo) != xReadDataLen)
-    {
-        TPDebugPrintf("Read data len error!\n");
-        return FALSE;
-    }
-
-    /* Read data from FIFO */
-    ReadDataFromFifo(RX_TP_QUEUE_ID,
-                     exchangeMsgInfo.dataLen,
-                     o_pDataBuf,
-                     &xReadDataLen,
-                     &eStatus);
-
     if (ERRO_NONE != eStatus || (exchangeMsgInfo.dataLen != xReadDataLen))
     {
         TPDebugPrintf("Read data error!\n");
         return FALSE;
     }
 
+    TP_SetCurChannel((tTPChannel)exchangeMsgInfo.channel);
     *o_pRxMsgID = exchangeMsgInfo.msgID;
     *o_pxRxDataLen = exchangeMsgInfo.dataLen;
     return TRUE;
 }
 
-/* Write a frame data to TP TX FIFO */
+/* Write a frame data to TX TP queue of current channel */
 boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
                                const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
                                const uint32 i_xTxDataLen,
                                const uint8 *i_pDataBuf)
 {
     tErroCode eStatus;
-    tLen xCanWriteLen = 0u;
     tLen xWritDataLen = (tLen)i_xTxDataLen;
+    const tTPChannelCfg *pstChannelCfg = TP_GetChannelCfg(TP_GetCurChannel());
     tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
-    uint32 totalWriteDataLen = i_xTxDataLen + sizeof(tUDSAndTPExchangeMsgInfo);
     exchangeMsgInfo.msgID = (uint32)i_TxMsgID;
     exchangeMsgInfo.dataLen = (uint32)i_xTxDataLen;
     exchangeMsgInfo.pfCallBack = (tpfUDSTxMsgCallBack)i_pfUDSTxMsgCallBack;
+    exchangeMsgInfo.channel = (uint32)TP_GetCurChannel();
     ASSERT(NULL_PTR == i_pDataBuf);
 
     /* Check transmit ID */
@@ -141,29 +117,13 @@ boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
         return FALSE;
     }
 
-    if (0u == xWritDataLen)
-    {
-        return FALSE;
-    }
-
-    /* Check can write data len */
-    GetCanWriteLen(TX_TP_QUEUE_ID, &xCanWriteLen, &eStatus);
-
-    if (ERRO_NONE != eStatus || xCanWriteLen < totalWriteDataLen)
-    {
-        return FALSE;
-    }
-
-    /* Write UDS transmit ID */
-    WriteDataInFifo(TX_TP_QUEUE_ID, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), &eStatus);
-
-    if (ERRO_NONE != eStatus)
+    if ((0u == xWritDataLen) || (NULL_PTR == pstChannelCfg))
     {
         return FALSE;
     }
 
-    /* Write data in FIFO */
-    WriteDataInFifo(TX_TP_QUEUE_ID, (uint8 *)i_pDataBuf, xWritDataLen, &eStatus);
+    /* Write UDS transmit ID, data len and data */
+    PushMsgInFifo(pstChannelCfg->xTxTPQueue, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), i_pDataBuf, xWritDataLen, &eStatus);
 
     if (ERRO_NONE != eStatus)
     {
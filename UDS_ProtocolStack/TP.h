@@ -15,14 +15,6 @@
 #include "includes.h"
 #include "TP_cfg.h"
 
-#ifdef EN_CAN_TP
-#include "can_tp.h"
-#endif
-
-#ifdef EN_LIN_TP
-#include "LIN_TP.h"
-#endif
-
 void TP_Init(void);
 
 void TP_MainFun(void);
@@ -11,65 +11,93 @@
 
 #include "TP_cfg.h"
 
+/* Bus driver interface of TP_DriverXXX is the first enabled TP, other TP drivers call their TP directly */
 #ifdef EN_CAN_TP
 #include "can_tp_cfg.h"
-#endif
-
-#ifdef EN_LIN_TP
+#elif defined (EN_LIN_TP)
 #include "LIN_tp_cfg.h"
 #endif
 
 static tpfUDSTxMsgCallBack gs_pfUDSTxMsgCallBack = NULL_PTR; /* TX message callback */
 
+/* Define TP RX FIFO at compile time */
+FIFO_DEFINE(gs_stRxTPQueue, RX_TP_QUEUE_ID, RX_TP_QUEUE_LEN);
 
-/* Get TP config TX message ID */
-uint32 TP_GetConfigTxMsgID(void)
+const tFifoHandle g_xRxTPQueue = &gs_stRxTPQueue;   /* TP RX FIFO */
+
+/* All enabled TP channels, index is tTPChannel */
+static const tTPChannelCfg *const gs_apstTPChannelCfg[TP_CHANNEL_NUM] =
 {
-    uint32 txMsgID = 0u;
 #ifdef EN_CAN_TP
-    txMsgID = CANTP_GetConfigTxMsgID();
+    &g_stCANTPChannelCfg,
 #endif
+
 #ifdef EN_LIN_TP
-    txMsgID = LINTP_GetConfigTxMsgID();
+    &g_stLINTPChannelCfg,
 #endif
-    return txMsgID;
-}
 
-/* Get TP config receive Function ID */
-uint32 TP_GetConfigRxMsgFUNID(void)
-{
-    uint32 rxMsgFUNID = 0u;
-#ifdef EN_CAN_TP
-    rxMsgFUNID = CANTP_GetConfigRxMsgFUNID();
+#ifdef EN_UART_TP
+    &g_stUARTTPChannelCfg,
 #endif
-#ifdef EN_LIN_TP
-    rxMsgFUNID = LINTP_GetConfigRxMsgFUNID();
+
+#ifdef EN_ETHERNET_TP
+    &g_stDoIPTPChannelCfg,
+#endif
+
+#ifdef EN_J1939_TP
+    &g_stJ1939TPChannelCfg,
 #endif
-    return rxMsgFUNID;
+};
+
+/* The channel received the last UDS request, UDS response is TX on it */
+static tTPChannel gs_eCurChannel = (tTPChannel)0u;
+
+
+/* Set current TP channel */
+void TP_SetCurChannel(const tTPChannel i_eChannel)
+{
+    if (i_eChannel < TP_CHANNEL_NUM)
+    {
+        gs_eCurChannel = i_eChannel;
+    }
 }
 
-/* Get TP config receive physical ID */
-uint32 TP_GetConfigRxMsgPHYID(void)
+/* Get current TP channel */
+tTPChannel TP_GetCurChannel(void)
 {
-    uint32 rxMsgPHYID = 0u;
-#ifdef EN_CAN_TP
-    rxMsgPHYID = CANTP_GetConfigRxMsgPHYID();
-#endif
-#ifdef EN_LIN_TP
-    rxMsgPHYID = LINTP_GetConfigRxMsgPHYID();
-#endif
-    return rxMsgPHYID;
+    return gs_eCurChannel;
 }
 
-#ifdef EN_LIN_TP
-/* Get TP config received broadcast ID */
-uint32 TP_GetConfigRxMsgBoardcastID(void)
+/* Get TP channel config, NULL_PTR if channel is invalid */
+const tTPChannelCfg *TP_GetChannelCfg(const tTPChannel i_eChannel)
 {
-    uint32 rxMsgBoardcastID = 0u;
-    rxMsgBoardcastID = LINTP_GetConfigRxMsgBroadcastID();
-    return rxMsgBoardcastID;
+    ASSERT(i_eChannel >= TP_CHANNEL_NUM);
+
+    if (i_eChannel >= TP_CHANNEL_NUM)
+    {
+        return NULL_PTR;
+    }
+
+    return gs_apstTPChannelCfg[i_eChannel];
+}
+
+/* Get TP config TX message ID of current channel */
+uint32 TP_GetConfigTxMsgID(void)
+{
+    return gs_apstTPChannelCfg[gs_eCurChannel]->pfGetConfigTxMsgID();
+}
+
+/* Get TP config receive Function ID of current channel */
+uint32 TP_GetConfigRxMsgFUNID(void)
+{
+    return gs_apstTPChannelCfg[gs_eCurChannel]->pfGetConfigRxMsgFUNID();
+}
+
+/* Get TP config receive physical ID of current channel */
+uint32 TP_GetConfigRxMsgPHYID(void)
+{
+    return gs_apstTPChannelCfg[gs_eCurChannel]->pfGetConfigRxMsgPHYID();
 }
-#endif
 
 
 /* Register transmit a frame message callback */
@@ -96,8 +124,7 @@ boolean TP_DriverWriteDataInTP(const uint32 i_RxID, const uint32 i_RxDataLen, co
     ASSERT(0u == i_RxDataLen);
 #ifdef EN_CAN_TP
     result = CANTP_DriverWriteDataInCANTP(i_RxID, i_RxDataLen, i_pRxDataBuf);
-#endif
-#ifdef EN_LIN_TP
+#elif defined (EN_LIN_TP)
     result = LINTP_DriverWriteDataInLINTP(i_pRxDataBuf[0u], i_RxDataLen - 1u, &i_pRxDataBuf[1u]);
 #endif
     return result;
@@ -112,11 +139,10 @@ boolean TP_DriverReadDataFromTP(const uint32 i_readDataLen, uint8 *o_pReadDatabu
     ASSERT(NULL_PTR == o_pReadDatabuf);
     ASSERT(NULL_PTR == o_pTxMsgID);
     ASSERT(NULL_PTR == o_pTxMsgLength);
-#ifdef EN_LIN_TP
-    result = LINTP_DriverReadDataFromLINTP(i_readDataLen, o_pReadDatabuf, &TPTxMsgHeader);
-#endif
 #ifdef EN_CAN_TP
     result = CANTP_DriverReadDataFromCANTP(i_readDataLen, o_pReadDatabuf, &TPTxMsgHeader);
+#elif defined (EN_LIN_TP)
+    result = LINTP_DriverReadDataFromLINTP(i_readDataLen, o_pReadDatabuf, &TPTxMsgHeader);
 #endif
 
     if (TRUE == result)
@@ -133,8 +159,7 @@ void TP_RegisterAbortTxMsg(void (*i_pfAbortTxMsg)(void))
 {
 #ifdef EN_CAN_TP
     CANTP_RegisterAbortTxMsg((const tpfAbortTxMsg)i_pfAbortTxMsg);
-#endif
-#ifdef EN_LIN_TP
+#elif defined (EN_LIN_TP)
     LINTP_RegisterAbortTxMsg((const tpfAbortTxMsg)i_pfAbortTxMsg);
 #endif
 }
@@ -142,11 +167,10 @@ void TP_RegisterAbortTxMsg(void (*i_pfAbortTxMsg)(void))
 /* Do TP TX message successful callback */
 void TP_DoTxMsgSuccesfulCallback(void)
 {
-#ifdef EN_LIN_TP
-    LINTP_DoTxMsgSuccessfulCallBack();
-#endif
 #ifdef EN_CAN_TP
     CANTP_DoTxMsgSuccessfulCallBack();
+#elif defined (EN_LIN_TP)
+    LINTP_DoTxMsgSuccessfulCallBack();
 #endif
 }
 
@@ -13,10 +13,60 @@
 #define TP_CFG_H_
 
 #include "includes.h"
+#include "multi_cyc_fifo.h"
 
 /* TX message callback */
 typedef void (*tpfUDSTxMsgCallBack)(uint8);
 
+/* Common types of every TP */
+typedef uint32 tUdsId;
+typedef uint32 tUdsLen;
+typedef uint16 tNetTime;
+typedef uint16 tBlockSize;
+typedef void (*tpfNetTxCallBack)(void);
+typedef uint8 (*tNetTxMsg)(const tUdsId, const uint16, const uint8 *, const tpfNetTxCallBack, const uint32);
+typedef uint8 (*tNetRx)(tUdsId *, uint8 *, uint8 *);
+typedef void (*tpfAbortTxMsg)(void);
+typedef void (*tpfStartTxMsg)(void);
+
+/* TP channel. UDS response is TX on the channel which received the request. */
+typedef enum
+{
+#ifdef EN_CAN_TP
+    TP_CAN_CHANNEL,     /* CAN TP */
+#endif
+
+#ifdef EN_LIN_TP
+    TP_LIN_CHANNEL,     /* LIN TP */
+#endif
+
+#ifdef EN_UART_TP
+    TP_UART_CHANNEL,    /* UART TP */
+#endif
+
+#ifdef EN_ETHERNET_TP
+    TP_DOIP_CHANNEL,    /* DoIP TP */
+#endif
+
+#ifdef EN_J1939_TP
+    TP_J1939_CHANNEL,   /* J1939 TP */
+#endif
+
+    TP_CHANNEL_NUM
+} tTPChannel;
+
+/* TP channel config. Every TP export one, TP multiplex all enabled channels. */
+typedef struct
+{
+    void (*pfInit)(void);                   /* TP init */
+    void (*pfMainFun)(void);                /* TP main function */
+    void (*pfSystemTickCtl)(void);          /* TP system tick control */
+    tUdsId (*pfGetConfigTxMsgID)(void);     /* Get TX message ID */
+    tUdsId (*pfGetConfigRxMsgFUNID)(void);  /* Get RX function ID */
+    tUdsId (*pfGetConfigRxMsgPHYID)(void);  /* Get RX physical ID */
+    tFifoHandle xTxTPQueue;                 /* UDS send message to this TP queue */
+} tTPChannelCfg;
+
 /* Single message buffer len */
 #define MAX_MESSAGE_LEN (64u)
 
@@ -32,14 +82,60 @@ typedef struct
     uint32 msgID;                   /* Message ID */
     uint32 dataLen;                 /* Data length */
     tpfUDSTxMsgCallBack pfCallBack; /* Callback */
+    uint32 channel;                 /* TP channel (tTPChannel) received the message */
 } tUDSAndTPExchangeMsgInfo;
 
-#define RX_TP_QUEUE_ID ('R')   /* TP RX FIFO ID */
-#define TX_TP_QUEUE_ID ('T')   /* TP TX FIFO ID */
+/* Max UDS message len exchanged with TP, every TP max message len is not more than this.
+   TransferData maxNumberOfBlockLength is derived from it and MAX_FLASH_DATA_LEN */
+#define TP_MAX_MSG_LEN (150u)
 
-/* Define FIFO length */
-#define TX_TP_QUEUE_LEN (50u)  /* UDS send message to TP max length */
-#define RX_TP_QUEUE_LEN (150)  /* UDS read message from TP max length */
+#define RX_TP_QUEUE_ID ('R')   /* TP RX FIFO ID, all TP channels write received message in it */
+
+/* Define FIFO length. TP queue and BUS FIFO are message FIFO. */
+#define TX_TP_QUEUE_LEN (512u) /* UDS send message to TP max length, every TP channel has one */
+#define RX_TP_QUEUE_LEN (512u) /* UDS read message from TP max length */
+
+/* Exchange message header (tUDSAndTPExchangeMsgInfo) len is not more than this */
+#define TP_QUEUE_MSG_HEADER_LEN (16u)
+
+/* BUS FIFO message header (tTPTxMsgHeader/tRxMsgInfo) + a frame is not more than this */
+#define BUS_FIFO_MSG_MAX_LEN (12u + 8u)
+
+#if !IsFifoLenValid(TX_TP_QUEUE_LEN) || !IsFifoLenValid(RX_TP_QUEUE_LEN)
+#error "TP queue len should be power of 2"
+#endif
+
+#if (FifoMaxMsgLen(RX_TP_QUEUE_LEN) < (TP_MAX_MSG_LEN + TP_QUEUE_MSG_HEADER_LEN)) || \
+    (FifoMaxMsgLen(TX_TP_QUEUE_LEN) < (TP_MAX_MSG_LEN + TP_QUEUE_MSG_HEADER_LEN))
+#error "TP queue len is too small for a max TP message"
+#endif
+
+/* Check BUS FIFO len of a TP channel */
+#define IsBusFifoLenValid(xFifoLen) (IsFifoLenValid(xFifoLen) && (FifoMaxMsgLen(xFifoLen) >= BUS_FIFO_MSG_MAX_LEN))
+
+/* TP RX FIFO handle, FIFO is defined in TP_cfg.c. TX TP queue and BUS FIFOs are defined in every TP config. */
+extern const tFifoHandle g_xRxTPQueue;  /* TP RX FIFO */
+
+/* TP channel config, defined in every TP config */
+#ifdef EN_CAN_TP
+extern const tTPChannelCfg g_stCANTPChannelCfg;
+#endif
+
+#ifdef EN_LIN_TP
+extern const tTPChannelCfg g_stLINTPChannelCfg;
+#endif
+
+#ifdef EN_UART_TP
+extern const tTPChannelCfg g_stUARTTPChannelCfg;
+#endif
+
+#ifdef EN_ETHERNET_TP
+extern const tTPChannelCfg g_stDoIPTPChannelCfg;
+#endif
+
+#ifdef EN_J1939_TP
+extern const tTPChannelCfg g_stJ1939TPChannelCfg;
+#endif
 
 typedef enum
 {
@@ -55,16 +151,18 @@ typedef struct
     uint32 TxMsgCallBack; /* TX message callback */
 } tTPTxMsgHeader;
 
+void TP_SetCurChannel(const tTPChannel i_eChannel);
+
+tTPChannel TP_GetCurChannel(void);
+
+const tTPChannelCfg *TP_GetChannelCfg(const tTPChannel i_eChannel);
+
 uint32 TP_GetConfigTxMsgID(void);
 
 uint32 TP_GetConfigRxMsgFUNID(void);
 
 uint32 TP_GetConfigRxMsgPHYID(void);
 
-#ifdef EN_LIN_TP
-uint32 TP_GetConfigRxMsgBoardcastID(void);
-#endif
-
 void TP_RegisterTransmittedAFrmaeMsgCallBack(const tpfUDSTxMsgCallBack i_pfTxMsgCallBack);
 
 void TP_DoTransmittedAFrameMsgCallBack(const uint8 i_result);
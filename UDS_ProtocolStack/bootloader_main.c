@@ -17,7 +17,13 @@
 #include "timer_hal.h"
 #include "watchdog_hal.h"
 #include "boot.h"
-#include "CRC_HAL.h"
+#include "CRC_hal.h"
+#ifdef EN_CAN_LIN_GATEWAY
+#include "LIN_gateway.h"
+#endif
+#ifdef EN_XCP_ON_CAN
+#include "xcp.h"
+#endif
 
 
 void UDS_MAIN_Init(void (*pfBSP_Init)(void), void (*pfAbortTxMsg)(void))
@@ -53,6 +59,12 @@ void UDS_MAIN_Init(void (*pfBSP_Init)(void), void (*pfAbortTxMsg)(void))
     WATCHDOG_HAL_Init();
     TIMER_HAL_Init();
     TP_Init();
+#ifdef EN_CAN_LIN_GATEWAY
+    LINGW_Init();
+#endif
+#ifdef EN_XCP_ON_CAN
+    XCP_Init();
+#endif
 
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 
@@ -87,6 +99,9 @@ void UDS_MAIN_Process(void)
     {
         TP_SystemTickCtl();
         UDS_SystemTickCtl();
+#ifdef EN_CAN_LIN_GATEWAY
+        LINGW_SystemTickCtl();
+#endif
 #ifdef EN_DEBUG_IO
 
         timerCnt1Ms++;
@@ -110,6 +125,12 @@ void UDS_MAIN_Process(void)
 
     TP_MainFun();
     UDS_MainFun();
+#ifdef EN_CAN_LIN_GATEWAY
+    LINGW_MainFun();
+#endif
+#ifdef EN_XCP_ON_CAN
+    XCP_MainFun();
+#endif
     Flash_OperateMainFunction();
 }
 
@@ -140,6 +140,9 @@ static tCanTpInfo gs_stCanTPRxDataInfo;      /* CAN TP RX data */
 static tCanTpWorkStatus gs_eCanTpWorkStatus = IDLE;
 static volatile tCanTPTxMsgStatus gs_eCANTPTxMsStatus = CANTP_TX_MSG_IDLE;
 static tpfNetTxCallBack gs_pfCANTPTxMsgCallBack = NULL_PTR;
+#ifdef EN_DOWNLOAD_STATISTICS
+static tCanTpErrorCnt gs_stCanTpErrorCnt;    /* CAN TP error counters */
+#endif
 
 #define CanTpTimeToCount(xTime) ((xTime) / g_stCANUdsNetLayerCfgInfo.ucCalledPeriod)
 #define IsSF(xNetWorkFrameType) ((((xNetWorkFrameType) >> 4u) == SF) ? TRUE : FALSE)
@@ -408,6 +411,11 @@ static void CANTP_RegisterTxMsgCallBack(const tpfNetTxCallBack i_pfNetTxCallBack
 /* Do register TX message callback */
 static void CANTP_DoRegisterTxMsgCallBack(void);
 
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Count CAN TP error */
+static void CANTP_CountError(const tN_Result i_result);
+#endif
+
 static const tCanTpFunInfo gs_astCanTpFunInfo[] =
 {
     {IDLE, CANTP_DoCanTpIdle},
@@ -425,51 +433,59 @@ static const tCanTpFunInfo gs_astCanTpFunInfo[] =
 
 void CANTP_Init(void)
 {
-    tErroCode eStatus;
-    ApplyFifo(RX_TP_QUEUE_LEN, RX_TP_QUEUE_ID, &eStatus);
+    /* TP FIFOs are defined at compile time in TP_cfg.c, nothing to apply */
+}
 
-    if (ERRO_NONE != eStatus)
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Count CAN TP error */
+static void CANTP_CountError(const tN_Result i_result)
+{
+    uint16 *pCnt = NULL_PTR;
+
+    switch (i_result)
     {
-        TPDebugPrintf("Apply RX_TP_QUEUE_ID failed!\n");
+        case N_OK:
+            break;
 
-        while (1)
-        {
-        }
-    }
+        case N_TIMEOUT_A:
+        case N_TIMEOUT_Bs:
+        case N_TIMEOUT_Cr:
+            pCnt = &gs_stCanTpErrorCnt.timeoutCnt;
+            break;
 
-    ApplyFifo(TX_TP_QUEUE_LEN, TX_TP_QUEUE_ID, &eStatus);
+        case N_WRONG_SN:
+            pCnt = &gs_stCanTpErrorCnt.wrongSNCnt;
+            break;
 
-    if (ERRO_NONE != eStatus)
-    {
-        TPDebugPrintf("Apply TX_TP_QUEUE_ID failed\n");
+        case N_UNEXP_PDU:
+            pCnt = &gs_stCanTpErrorCnt.unexpPDUCnt;
+            break;
 
-        while (1)
-        {
-        }
-    }
+        case N_INVALID_FS:
+        case N_WTF_OVRN:
+        case N_BUFFER_OVFLW:
+            pCnt = &gs_stCanTpErrorCnt.overflowCnt;
+            break;
 
-    ApplyFifo(RX_BUS_FIFO_LEN, RX_BUS_FIFO, &eStatus);
+        default:
+            pCnt = &gs_stCanTpErrorCnt.otherErrorCnt;
+            break;
+    }
 
-    if (ERRO_NONE != eStatus)
+    if ((NULL_PTR != pCnt) && (0xFFFFu != *pCnt))
     {
-        TPDebugPrintf("Apply RX_BUS_FIFO failed!\n");
-
-        while (1)
-        {
-        }
+        (*pCnt)++;
     }
+}
 
-    ApplyFifo(TX_BUS_FIFO_LEN, TX_BUS_FIFO, &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-        TPDebugPrintf("Apply TX_BUS_FIFOfailed!\n");
+/* Get CAN TP error counters */
+void CANTP_GetErrorCnt(tCanTpErrorCnt *o_pstErrorCnt)
+{
+    ASSERT(NULL_PTR == o_pstErrorCnt);
 
-        while (1)
-        {
-        }
-    }
+    *o_pstErrorCnt = gs_stCanTpErrorCnt;
 }
+#endif
 
 /* CAN TP system tick control. This function should period called by system. */
 void CANTP_SytstemTickControl(void)
@@ -531,6 +547,9 @@ void CANTP_MainFun(void)
             if (NULL_PTR != gs_astCanTpFunInfo[index].pfCanTpFun)
             {
                 result = gs_astCanTpFunInfo[index].pfCanTpFun(&stRxCanTpMsg, GetCurCANTPStatusPtr());
+#ifdef EN_DOWNLOAD_STATISTICS
+                CANTP_CountError(result);
+#endif
             }
         }
 
@@ -561,7 +580,6 @@ static uint8 CANTP_CopyAFrameDataInRxFifo(const tUdsId i_xRxCanID,
                                           const uint8 *i_pDataBuf)
 {
     tErroCode eStatus;
-    tLen xCanWriteLen = 0u;
     tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
     ASSERT(NULL_PTR == i_pDataBuf);
 
@@ -570,27 +588,12 @@ static uint8 CANTP_CopyAFrameDataInRxFifo(const tUdsId i_xRxCanID,
         return FALSE;
     }
 
-    /* Check can write data len */
-    GetCanWriteLen(RX_TP_QUEUE_ID, &xCanWriteLen, &eStatus);
-
-    if ((ERRO_NONE != eStatus) || (xCanWriteLen < (i_xRxDataLen + sizeof(tUDSAndTPExchangeMsgInfo))))
-    {
-        return FALSE;
-    }
-
     exchangeMsgInfo.msgID = i_xRxCanID;
     exchangeMsgInfo.dataLen = i_xRxDataLen;
     exchangeMsgInfo.pfCallBack = NULL_PTR;
-    /* Write data UDS transmit ID and data len */
-    WriteDataInFifo(RX_TP_QUEUE_ID, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), &eStatus);
-
-    if (ERRO_NONE != eStatus)
-    {
-        return FALSE;
-    }
-
-    /* Write data in FIFO */
-    WriteDataInFifo(RX_TP_QUEUE_ID, (uint8 *)i_pDataBuf, i_xRxDataLen, &eStatus);
+    exchangeMsgInfo.channel = (uint32)TP_CAN_CHANNEL;
+    /* Write UDS transmit ID, data len and data */
+    PushMsgInFifo(g_xRxTPQueue, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), i_pDataBuf, i_xRxDataLen, &eStatus);
 
     if (ERRO_NONE != eStatus)
     {
@@ -611,32 +614,14 @@ static uint8 CANTP_CopyAFrameFromFifoToBuf(tUdsId *o_pxTxCanID,
     ASSERT(NULL_PTR == o_pxTxCanID);
     ASSERT(NULL_PTR == o_pTxDataLen);
     ASSERT(NULL_PTR == o_pDataBuf);
-    /* Can read data from buffer */
-    GetCanReadLen(TX_TP_QUEUE_ID, &xRealReadLen, &eStatus);
-
-    if ((ERRO_NONE != eStatus) || (0u == xRealReadLen) || (xRealReadLen < sizeof(tUDSAndTPExchangeMsgInfo)))
-    {
-        return FALSE;
-    }
-
-    /* Read receive ID */
-    ReadDataFromFifo(TX_TP_QUEUE_ID,
-                     sizeof(tUDSAndTPExchangeMsgInfo),
-                     (uint8 *)&exchangeMsgInfo,
-                     &xRealReadLen,
-                     &eStatus);
-
-    if (ERRO_NONE != eStatus || sizeof(tUDSAndTPExchangeMsgInfo) != xRealReadLen)
-    {
-        return FALSE;
-    }
-
-    /* Read data from FIFO */
-    ReadDataFromFifo(TX_TP_QUEUE_ID,
-                     exchangeMsgInfo.dataLen,
-                     o_pDataBuf,
-                     &xRealReadLen,
-                     &eStatus);
+    /* Read UDS transmit ID, data len and data */
+    PopMsgFromFifo(g_xCANTxTPQueue,
+                   (uint8 *)&exchangeMsgInfo,
+                   sizeof(tUDSAndTPExchangeMsgInfo),
+                   o_pDataBuf,
+                   MAX_CF_DATA_LEN,
+                   &xRealReadLen,
+                   &eStatus);
 
     if (ERRO_NONE != eStatus || exchangeMsgInfo.dataLen != xRealReadLen)
     {
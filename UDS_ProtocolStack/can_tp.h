@@ -24,6 +24,20 @@ void CANTP_SytstemTickControl(void);
 
 void CANTP_Init(void);
 
+#ifdef EN_DOWNLOAD_STATISTICS
+/* CAN TP error counters after init, counters stop at 0xFFFF */
+typedef struct
+{
+    uint16 timeoutCnt;      /* N_Ar/N_As, N_Bs and N_Cr timeout */
+    uint16 wrongSNCnt;      /* CF with unexpected SN */
+    uint16 unexpPDUCnt;     /* Unexpected PDU, e.g. new SF/FF when receiving CF */
+    uint16 overflowCnt;     /* Invalid FS, FC overflow or too long FF */
+    uint16 otherErrorCnt;   /* Other errors, e.g. invalid frame len or TX failed */
+} tCanTpErrorCnt;
+
+void CANTP_GetErrorCnt(tCanTpErrorCnt *o_pstErrorCnt);
+#endif
+
 #endif /* EN_CAN_TP */
 
 #endif /* CAN_TP_H_ */
@@ -14,10 +14,25 @@
 #ifdef EN_CAN_TP
 #include "can_tp_cfg.h"
 #include "multi_cyc_fifo.h"
+#include "can_tp.h"
+#include "timer_hal.h"
 //#include "can_driver.h"
 static tpfAbortTxMsg gs_pfCANTPAbortTxMsg = NULL_PTR;
+static tpfStartTxMsg gs_pfCANTPStartTxMsg = NULL_PTR;
 static tpfNetTxCallBack gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
 
+/* CAN TX BUS FIFO message header */
+typedef struct
+{
+    tTPTxMsgHeader stTxMsgHeader;   /* TX message header */
+    uint32 writtenTime;             /* Written in TX BUS FIFO ms tick */
+} tCANTPTxBusMsgHeader;
+
+/* TX frame read by driver, latency is counted when it is TX successful */
+static tCANTPTxPrio gs_eTxingPrio = CANTP_TX_PRIO_NORMAL;
+static uint32 gs_txingWrittenTime = 0u;
+static tCANTPTxLatency gs_astTxLatency[CANTP_TX_PRIO_NUM];
+
 
 static uint8 CANTP_TxMsg(const tUdsId i_xTxId,
                          const uint16 i_DataLen,
@@ -31,9 +46,51 @@ static uint8 CANTP_RxMsg(tUdsId *o_pxRxId,
 
 static void CANTP_AbortTxMsg(void);
 
+static tCANTPTxPrio CANTP_GetTxPrio(const uint8 *i_pDataBuf, const uint16 i_DataLen);
+
+/* Write a frame in TX BUS FIFO and kick driver */
+static uint8 CANTP_WriteTxBusFifo(const tFifoHandle i_xTxBusFifo,
+                                  const tUdsId i_xTxId,
+                                  const uint8 i_DataLen,
+                                  const uint8 *i_pDataBuf,
+                                  const tpfNetTxCallBack i_pfNetTxCallBack);
+
 /* Clear CAN TP TX BUS FIFO */
 static boolean CANTP_ClearTXBUSFIFO(void);
 
+/* Define CAN TP TX queue and BUS FIFOs at compile time */
+FIFO_DEFINE(gs_stCANTxTPQueue, CAN_TX_TP_QUEUE_ID, TX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stCANRxBusFifo, CAN_RX_BUS_FIFO, CAN_RX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stCANTxBusFifo, CAN_TX_BUS_FIFO, CAN_TX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stCANTxHighBusFifo, CAN_TX_HIGH_BUS_FIFO, CAN_TX_HIGH_BUS_FIFO_LEN);
+#ifdef EN_PERIODIC_DID
+FIFO_DEFINE(gs_stCANTxLowBusFifo, CAN_TX_LOW_BUS_FIFO, CAN_TX_LOW_BUS_FIFO_LEN);
+#endif
+
+const tFifoHandle g_xCANTxTPQueue = &gs_stCANTxTPQueue;        /* CAN TP TX queue */
+static const tFifoHandle gs_xRxBusFifo = &gs_stCANRxBusFifo;  /* RX bus FIFO */
+/* TX bus FIFOs, index is tCANTPTxPrio */
+static const tFifoHandle gs_axTxBusFifo[CANTP_TX_PRIO_NUM] =
+{
+    &gs_stCANTxHighBusFifo,
+    &gs_stCANTxBusFifo,
+#ifdef EN_PERIODIC_DID
+    &gs_stCANTxLowBusFifo,
+#endif
+};
+
+/* CAN TP channel config */
+const tTPChannelCfg g_stCANTPChannelCfg =
+{
+    CANTP_Init,                    /* TP init */
+    CANTP_MainFun,                 /* TP main function */
+    CANTP_SytstemTickControl,      /* TP system tick control */
+    CANTP_GetConfigTxMsgID,        /* Get TX message ID */
+    CANTP_GetConfigRxMsgFUNID,     /* Get RX function ID */
+    CANTP_GetConfigRxMsgPHYID,     /* Get RX physical ID */
+    &gs_stCANTxTPQueue,            /* TX TP queue */
+};
+
 /* UDS Network layer config info */
 const tUdsCANNetLayerCfg g_stCANUdsNetLayerCfgInfo =
 {
@@ -62,11 +119,6 @@ static uint8 CANTP_TxMsg(const tUdsId i_xTxId,
                          const tpfNetTxCallBack i_pfNetTxCallBack,
                          const uint32 txBlockingMaxtime)
 {
-    tLen xCanWriteDataLen = 0u;
-    tErroCode eStatus;
-    uint8 aMsgBuf[8] = {0};
-    tTPTxMsgHeader TxMsgInfo;
-    const uint32 msgInfoLen = sizeof(tTPTxMsgHeader) + sizeof(aMsgBuf);
     ASSERT(NULL_PTR == i_pDataBuf);
 
     if (i_DataLen > 8u)
@@ -74,33 +126,101 @@ static uint8 CANTP_TxMsg(const tUdsId i_xTxId,
         return FALSE;
     }
 
-    GetCanWriteLen(TX_BUS_FIFO, &xCanWriteDataLen, &eStatus);
+    return CANTP_WriteTxBusFifo(gs_axTxBusFifo[CANTP_GetTxPrio(i_pDataBuf, i_DataLen)],
+                                i_xTxId,
+                                (uint8)i_DataLen,
+                                i_pDataBuf,
+                                i_pfNetTxCallBack);
+    //ret = TransmitCANMsg(i_xTxId, i_DataLen, i_pDataBuf, i_pfNetTxCallBack, txBlockingMaxtime);
+}
 
-    if ((ERRO_NONE == eStatus) && (msgInfoLen <= xCanWriteDataLen))
+/* Write a frame in TX BUS FIFO and kick driver. If TX BUS FIFO is full nothing is written. */
+static uint8 CANTP_WriteTxBusFifo(const tFifoHandle i_xTxBusFifo,
+                                  const tUdsId i_xTxId,
+                                  const uint8 i_DataLen,
+                                  const uint8 *i_pDataBuf,
+                                  const tpfNetTxCallBack i_pfNetTxCallBack)
+{
+    tErroCode eStatus;
+    tCANTPTxBusMsgHeader *pstTxMsgInfo = NULL_PTR;
+    uint8 *pucMsgBuf = NULL_PTR;
+    const tLen xMsgLen = (tLen)(sizeof(tCANTPTxBusMsgHeader) + 8u);
+
+    /* Build TX message in TX BUS FIFO */
+    pstTxMsgInfo = (tCANTPTxBusMsgHeader *)ReserveMsgInFifo(i_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
     {
-        TxMsgInfo.TxMsgID = i_xTxId;
-        TxMsgInfo.TxMsgLength = sizeof(aMsgBuf);
-        TxMsgInfo.TxMsgCallBack = (uint32)i_pfNetTxCallBack;
-        fsl_memcpy(&aMsgBuf[0u], i_pDataBuf, i_DataLen);
-        WriteDataInFifo(TX_BUS_FIFO, (uint8 *)&TxMsgInfo, sizeof(tTPTxMsgHeader), &eStatus);
+        return FALSE;
+    }
 
-        if (ERRO_NONE != eStatus)
-        {
-            ClearFIFO(TX_BUS_FIFO, &eStatus);
-            return FALSE;
-        }
+    pstTxMsgInfo->stTxMsgHeader.TxMsgID = i_xTxId;
+    pstTxMsgInfo->stTxMsgHeader.TxMsgLength = 8u;
+    pstTxMsgInfo->stTxMsgHeader.TxMsgCallBack = (uint32)i_pfNetTxCallBack;
+    pstTxMsgInfo->writtenTime = TIMER_HAL_GetMsTickCnt();
+    pucMsgBuf = (uint8 *)(pstTxMsgInfo + 1u);
+    fsl_memset(pucMsgBuf, 0u, 8u);
+    fsl_memcpy(pucMsgBuf, i_pDataBuf, i_DataLen);
+    CommitMsgInFifo(i_xTxBusFifo, xMsgLen, &eStatus);
 
-        WriteDataInFifo(TX_BUS_FIFO, (uint8 *)aMsgBuf, 8, &eStatus);
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
 
-        if (ERRO_NONE != eStatus)
-        {
-            ClearFIFO(TX_BUS_FIFO, &eStatus);
-            return FALSE;
-        }
+    /* Kick driver, it starts TX at once if TX mailbox is idle, else TX complete interrupt will TX the frame */
+    if (NULL_PTR != gs_pfCANTPStartTxMsg)
+    {
+        (gs_pfCANTPStartTxMsg)();
     }
 
     return TRUE;
-    //ret = TransmitCANMsg(i_xTxId, i_DataLen, i_pDataBuf, i_pfNetTxCallBack, txBlockingMaxtime);
+}
+
+#ifdef EN_PERIODIC_DID
+/* Get config CAN periodic DID frames ID */
+tUdsId CANTP_GetConfigTxPeriodicMsgID(void)
+{
+    return TX_PERIODIC_ADDR_ID;
+}
+
+/* TX a periodic DID single frame in low priority TX BUS FIFO, return FALSE if the FIFO is full and the frame is dropped.
+   Driver reads it only when high and normal priority FIFOs are empty, a TP frame waits one frame time at most. */
+boolean CANTP_TxPeriodicFrame(const uint8 *i_pDataBuf, const uint8 i_DataLen)
+{
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    if (i_DataLen > 8u)
+    {
+        return FALSE;
+    }
+
+    return CANTP_WriteTxBusFifo(gs_axTxBusFifo[CANTP_TX_PRIO_LOW],
+                                CANTP_GetConfigTxPeriodicMsgID(),
+                                i_DataLen,
+                                i_pDataBuf,
+                                NULL_PTR);
+}
+#endif
+
+/* Get CAN TX frame priority: FC and NRC 0x78 SF are high priority */
+static tCANTPTxPrio CANTP_GetTxPrio(const uint8 *i_pDataBuf, const uint16 i_DataLen)
+{
+    const uint8 pciType = (uint8)(i_pDataBuf[0u] >> 4u);
+
+    /* Flow control frame */
+    if (0x03u == pciType)
+    {
+        return CANTP_TX_PRIO_HIGH;
+    }
+
+    /* Single frame: 0x7F SID 0x78 */
+    if ((0x00u == pciType) && (i_DataLen >= 4u) && (0x7Fu == i_pDataBuf[1u]) && (0x78u == i_pDataBuf[3u]))
+    {
+        return CANTP_TX_PRIO_HIGH;
+    }
+
+    return CANTP_TX_PRIO_NORMAL;
 }
 
 /* CAN TP RX message: read RX msg from CAN driver RxFIFO */
@@ -108,58 +228,46 @@ static uint8 CANTP_RxMsg(tUdsId *o_pxRxId,
                          uint8 *o_pRxDataLen,
                          uint8 *o_pRxBuf)
 {
-    tLen xCanRxDataLen = 0u;
-    tLen xReadDataLen = 0u;
+    uint8 result = FALSE;
+    tLen xMsgLen = 0u;
     tErroCode eStatus;
-    tRxMsgInfo stRxCanMsg = {0u};
+    const tRxMsgInfo *pstRxCanMsg = NULL_PTR;
     uint8 ucIndex = 0u;
-    const uint32 headerLen = sizeof(stRxCanMsg.rxDataId) + sizeof(stRxCanMsg.rxDataLen);
+    const uint32 headerLen = sizeof(pstRxCanMsg->rxDataId) + sizeof(pstRxCanMsg->rxDataLen);
     ASSERT(NULL_PTR == o_pxRxId);
     ASSERT(NULL_PTR == o_pRxBuf);
     ASSERT(NULL_PTR == o_pRxDataLen);
-    GetCanReadLen(RX_BUS_FIFO, &xCanRxDataLen, &eStatus);
+    pstRxCanMsg = (const tRxMsgInfo *)PeekMsgFromFifo(gs_xRxBusFifo, &xMsgLen, &eStatus);
 
-    if ((ERRO_NONE == eStatus) && (headerLen <= xCanRxDataLen))
+    if (ERRO_NONE != eStatus)
     {
-        ReadDataFromFifo(RX_BUS_FIFO,
-                         headerLen,
-                         (uint8 *)&stRxCanMsg,
-                         &xReadDataLen,
-                         &eStatus);
-
-        if ((ERRO_NONE == eStatus) && (headerLen <= xCanRxDataLen))
+        if (ERRO_NO_MSG != eStatus)
         {
-            ReadDataFromFifo(RX_BUS_FIFO,
-                             stRxCanMsg.rxDataLen,
-                             (uint8 *)&stRxCanMsg.aucDataBuf,
-                             &xCanRxDataLen,
-                             &eStatus);
-
-            if (TRUE != CANTP_IsReceivedMsgIDValid(stRxCanMsg.rxDataId))
-            {
-                return FALSE;
-            }
-
-            *o_pxRxId = stRxCanMsg.rxDataId;
-            *o_pRxDataLen = stRxCanMsg.rxDataLen;
-
-            for (ucIndex = 0u; ucIndex < stRxCanMsg.rxDataLen; ucIndex++)
-            {
-                o_pRxBuf[ucIndex] = stRxCanMsg.aucDataBuf[ucIndex];
-            }
-
-            return TRUE;
+            TPDebugPrintf("\n %s read message from FIFO failed! status = %d\n", __func__, eStatus);
         }
+
+        return FALSE;
     }
-    else
+
+    /* Parse RX message in RX BUS FIFO */
+    if ((headerLen <= xMsgLen) &&
+            ((xMsgLen - headerLen) == pstRxCanMsg->rxDataLen) &&
+            (TRUE == CANTP_IsReceivedMsgIDValid(pstRxCanMsg->rxDataId)))
     {
-        if ((0u != xCanRxDataLen) || (ERRO_NONE != eStatus))
+        *o_pxRxId = pstRxCanMsg->rxDataId;
+        *o_pRxDataLen = pstRxCanMsg->rxDataLen;
+
+        for (ucIndex = 0u; ucIndex < pstRxCanMsg->rxDataLen; ucIndex++)
         {
-            TPDebugPrintf("\n %s write message in FIFO failed! status = %d, FIFO avaliable Length=%d\n", __func__, eStatus, xCanRxDataLen);
+            o_pRxBuf[ucIndex] = pstRxCanMsg->aucDataBuf[ucIndex];
         }
+
+        result = TRUE;
     }
 
-    return FALSE;
+    ReleaseMsgFromFifo(gs_xRxBusFifo, &eStatus);
+
+    return result;
 }
 
 /* Get config CAN TP TX Response Address ID */
@@ -228,13 +336,18 @@ void CANTP_RegisterAbortTxMsg(const tpfAbortTxMsg i_pfAbortTxMsg)
     gs_pfCANTPAbortTxMsg = (tpfAbortTxMsg)i_pfAbortTxMsg;
 }
 
+/* Register start TX message, called after a frame is written in TX BUS FIFO */
+void CANTP_RegisterStartTxMsg(const tpfStartTxMsg i_pfStartTxMsg)
+{
+    gs_pfCANTPStartTxMsg = i_pfStartTxMsg;
+}
+
 /* Write data in CAN TP */
 boolean CANTP_DriverWriteDataInCANTP(const uint32 i_RxID, const uint32 i_dataLen, const uint8 *i_pDataBuf)
 {
-    tLen xCanWriteDataLen = 0u;
     tErroCode eStatus;
-    tRxMsgInfo stRxCanMsg;
-    const uint32 headerLen = sizeof(stRxCanMsg.rxDataId) + sizeof(stRxCanMsg.rxDataLen);
+    tRxMsgInfo *pstRxCanMsg = NULL_PTR;
+    const uint32 headerLen = sizeof(pstRxCanMsg->rxDataId) + sizeof(pstRxCanMsg->rxDataLen);
     ASSERT(NULL_PTR == i_pDataBuf);
 
     if (i_dataLen > 8u)
@@ -242,72 +355,98 @@ boolean CANTP_DriverWriteDataInCANTP(const uint32 i_RxID, const uint32 i_dataLen
         return FALSE;
     }
 
-    GetCanWriteLen(RX_BUS_FIFO, &xCanWriteDataLen, &eStatus);
+    pstRxCanMsg = (tRxMsgInfo *)ReserveMsgInFifo(gs_xRxBusFifo, (tLen)(headerLen + i_dataLen), &eStatus);
 
-    if ((ERRO_NONE == eStatus) && ((i_dataLen + headerLen) <= xCanWriteDataLen))
+    /* If RX BUS FIFO is full, this frame is lost and TP will check timeout. */
+    if (ERRO_OVER_MAX == eStatus)
     {
-        stRxCanMsg.rxDataId = i_RxID;
-        stRxCanMsg.rxDataLen = i_dataLen;
-        WriteDataInFifo(RX_BUS_FIFO, (uint8 *)&stRxCanMsg, headerLen, &eStatus);
+        return TRUE;
+    }
 
-        if (ERRO_NONE != eStatus)
-        {
-            return FALSE;
-        }
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
 
-        WriteDataInFifo(RX_BUS_FIFO, (uint8 *)i_pDataBuf, stRxCanMsg.rxDataLen, &eStatus);
+    /* Build RX message in RX BUS FIFO */
+    pstRxCanMsg->rxDataId = i_RxID;
+    pstRxCanMsg->rxDataLen = i_dataLen;
+    fsl_memcpy(pstRxCanMsg->aucDataBuf, i_pDataBuf, i_dataLen);
+    CommitMsgInFifo(gs_xRxBusFifo, (tLen)(headerLen + i_dataLen), &eStatus);
 
-        if (ERRO_NONE != eStatus)
-        {
-            return FALSE;
-        }
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
     }
 
     return TRUE;
 }
 
-boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
+/* Driver peek a frame from high to low priority TX BUS FIFO, it is kept in FIFO until driver release it after TX started */
+boolean CANTP_DriverPeekDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
 {
-    boolean result = FALSE;
-    tLen xCanRxDataLen = 0u;
-    tErroCode eStatus;
-    tTPTxMsgHeader TxMsgInfo;
-    const uint32 msgInfoLen = sizeof(tTPTxMsgHeader);
+    tLen xMsgLen = 0u;
+    tErroCode eStatus = ERRO_NO_MSG;
+    const tCANTPTxBusMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const uint8 *pucData = NULL_PTR;
+    uint32 index = 0u;
+    uint8 prio = 0u;
     ASSERT(NULL_PTR == o_pReadDataBuf);
     ASSERT(NULL_PTR == o_pstTxMsgHeader);
     ASSERT(0u == i_readDataLen);
-    GetCanReadLen(TX_BUS_FIFO, &xCanRxDataLen, &eStatus);
 
-    if ((ERRO_NONE == eStatus) && (xCanRxDataLen > msgInfoLen))
+    for (prio = 0u; (prio < (uint8)CANTP_TX_PRIO_NUM) && (ERRO_NONE != eStatus); prio++)
     {
-        ReadDataFromFifo(TX_BUS_FIFO,
-                         sizeof(tTPTxMsgHeader),
-                         (uint8 *)&TxMsgInfo,
-                         &xCanRxDataLen,
-                         &eStatus);
+        pstTxMsgInfo = (const tCANTPTxBusMsgHeader *)PeekMsgFromFifo(gs_axTxBusFifo[prio], &xMsgLen, &eStatus);
+    }
 
-        if ((ERRO_NONE == eStatus) && (xCanRxDataLen == sizeof(tTPTxMsgHeader)))
-        {
-            result = TRUE;
-        }
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
 
-        if (TRUE == result)
-        {
-            ReadDataFromFifo(TX_BUS_FIFO,
-                             i_readDataLen,
-                             o_pReadDataBuf,
-                             &xCanRxDataLen,
-                             &eStatus);
-
-            if ((ERRO_NONE == eStatus) && (xCanRxDataLen == i_readDataLen) && (i_readDataLen >= TxMsgInfo.TxMsgLength))
-            {
-                result = TRUE;
-                *o_pstTxMsgHeader = TxMsgInfo;
-
-                /* Storage callback, if user want to TX message callback please call TP_DoTxMsgSuccesfulCallback or self call callback */
-                gs_pfTxMsgSuccessfulCallBack = (tpfNetTxCallBack)TxMsgInfo.TxMsgCallBack;
-            }
-        }
+    gs_eTxingPrio = (tCANTPTxPrio)(prio - 1u);
+
+    /* Not a frame, drop it */
+    if ((xMsgLen < sizeof(tCANTPTxBusMsgHeader)) ||
+            ((xMsgLen - sizeof(tCANTPTxBusMsgHeader)) < pstTxMsgInfo->stTxMsgHeader.TxMsgLength) ||
+            (pstTxMsgInfo->stTxMsgHeader.TxMsgLength > i_readDataLen))
+    {
+        CANTP_DriverReleaseDataFromCANTP();
+        return FALSE;
+    }
+
+    pucData = (const uint8 *)pstTxMsgInfo + sizeof(tCANTPTxBusMsgHeader);
+
+    for (index = 0u; index < pstTxMsgInfo->stTxMsgHeader.TxMsgLength; index++)
+    {
+        o_pReadDataBuf[index] = pucData[index];
+    }
+
+    *o_pstTxMsgHeader = pstTxMsgInfo->stTxMsgHeader;
+    gs_txingWrittenTime = pstTxMsgInfo->writtenTime;
+
+    /* Storage callback, if user want to TX message callback please call TP_DoTxMsgSuccesfulCallback or self call callback */
+    gs_pfTxMsgSuccessfulCallBack = (tpfNetTxCallBack)pstTxMsgInfo->stTxMsgHeader.TxMsgCallBack;
+
+    return TRUE;
+}
+
+/* Driver release the peeked frame after TX started */
+void CANTP_DriverReleaseDataFromCANTP(void)
+{
+    tErroCode eStatus;
+    ReleaseMsgFromFifo(gs_axTxBusFifo[gs_eTxingPrio], &eStatus);
+}
+
+/* Driver read a frame from CAN TP, high priority TX BUS FIFO is read first */
+boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
+{
+    boolean result = CANTP_DriverPeekDataFromCANTP(i_readDataLen, o_pReadDataBuf, o_pstTxMsgHeader);
+
+    if (TRUE == result)
+    {
+        CANTP_DriverReleaseDataFromCANTP();
     }
 
     return result;
@@ -316,6 +455,17 @@ boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pRead
 /* Do TX message successful callback */
 void CANTP_DoTxMsgSuccessfulCallBack(void)
 {
+    tCANTPTxLatency *pstLatency = &gs_astTxLatency[gs_eTxingPrio];
+    const uint32 latency = TIMER_HAL_GetMsTickCnt() - gs_txingWrittenTime;
+
+    pstLatency->txCnt++;
+    pstLatency->totalLatency += latency;
+
+    if (latency > pstLatency->maxLatency)
+    {
+        pstLatency->maxLatency = latency;
+    }
+
     if (NULL_PTR != gs_pfTxMsgSuccessfulCallBack)
     {
         (gs_pfTxMsgSuccessfulCallBack)();
@@ -323,14 +473,40 @@ void CANTP_DoTxMsgSuccessfulCallBack(void)
     }
 }
 
+/* Get CAN TX latency statistics of a priority */
+void CANTP_GetTxLatency(const tCANTPTxPrio i_ePrio, tCANTPTxLatency *o_pstLatency)
+{
+    ASSERT(NULL_PTR == o_pstLatency);
+
+    if (i_ePrio < CANTP_TX_PRIO_NUM)
+    {
+        DisableAllInterrupts();
+        *o_pstLatency = gs_astTxLatency[i_ePrio];
+        EnableAllInterrupts();
+    }
+}
+
+/* Reset CAN TX latency statistics */
+void CANTP_ResetTxLatency(void)
+{
+    DisableAllInterrupts();
+    fsl_memset(gs_astTxLatency, 0u, sizeof(gs_astTxLatency));
+    EnableAllInterrupts();
+}
+
 /* Clear CAN TP TX BUS FIFO */
 static boolean CANTP_ClearTXBUSFIFO(void)
 {
     boolean result = FALSE;
     tErroCode eStatus = ERRO_NONE;
-    ClearFIFO(TX_BUS_FIFO, &eStatus);
-
-    if (ERRO_NONE == eStatus)
+    tErroCode eHighStatus = ERRO_NONE;
+    /* TX complete interrupt reads TX BUS FIFOs */
+    DisableAllInterrupts();
+    ClearFIFO(gs_axTxBusFifo[CANTP_TX_PRIO_HIGH], &eHighStatus);
+    ClearFIFO(gs_axTxBusFifo[CANTP_TX_PRIO_NORMAL], &eStatus);
+    EnableAllInterrupts();
+
+    if ((ERRO_NONE == eStatus) && (ERRO_NONE == eHighStatus))
     {
         result = TRUE;
     }
@@ -22,15 +22,7 @@
 **  Description : ISO 15765-2 configuration file
 *******************************************************/
 
-typedef uint32 tUdsId;
-typedef uint32 tUdsLen;
-typedef uint16 tNetTime;
-typedef uint16 tBlockSize;
-typedef void (*tpfNetTxCallBack)(void);
-typedef uint8 (*tNetTxMsg)(const tUdsId, const uint16, const uint8 *, const tpfNetTxCallBack, const uint32);
-typedef uint8 (*tNetRx)(tUdsId *, uint8 *, uint8 *);
 typedef uint16 tCanTpDataLen;
-typedef void (*tpfAbortTxMsg)(void);
 
 
 #define DATA_LEN                (8u)
@@ -43,7 +35,56 @@ typedef void (*tpfAbortTxMsg)(void);
 #define FF_DATA_MIN_LEN         (8u)    /* Min First Frame data len*/
 
 #define CF_DATA_MAX_LEN         (7u)    /* Single Consecutive Frame max data len */
-#define MAX_CF_DATA_LEN         (150u)  /* Max Consecutive Frame data len */
+#define MAX_CF_DATA_LEN         (TP_MAX_MSG_LEN)  /* Max Consecutive Frame data len */
+
+#if (MAX_CF_DATA_LEN > TP_MAX_MSG_LEN)
+#error "MAX_CF_DATA_LEN is more than TP_MAX_MSG_LEN"
+#endif
+
+/* FF_DL escape sequence (more than 4095 bytes) is not supported */
+#if (MAX_CF_DATA_LEN > 0xFFFu)
+#error "MAX_CF_DATA_LEN is more than 4095"
+#endif
+
+#define CAN_TX_TP_QUEUE_ID ('T')   /* CAN TP TX queue ID */
+
+#if !IsBusFifoLenValid(CAN_RX_BUS_FIFO_LEN) || !IsBusFifoLenValid(CAN_TX_BUS_FIFO_LEN)
+#error "CAN BUS FIFO len should be power of 2 and not too small for a frame message"
+#endif
+
+/* CAN TX BUS FIFO message: tTPTxMsgHeader + written time + frame */
+#define CAN_TX_BUS_MSG_LEN (12u + 4u + DATA_LEN)
+
+#if (!IsFifoLenValid(CAN_TX_HIGH_BUS_FIFO_LEN)) || \
+    (FifoMaxMsgLen(CAN_TX_BUS_FIFO_LEN) < CAN_TX_BUS_MSG_LEN) || \
+    (FifoMaxMsgLen(CAN_TX_HIGH_BUS_FIFO_LEN) < CAN_TX_BUS_MSG_LEN)
+#error "CAN TX BUS FIFOs len should be power of 2 and not too small for a frame message with written time"
+#endif
+
+#ifdef EN_PERIODIC_DID
+#if (!IsFifoLenValid(CAN_TX_LOW_BUS_FIFO_LEN)) || (FifoMaxMsgLen(CAN_TX_LOW_BUS_FIFO_LEN) < CAN_TX_BUS_MSG_LEN)
+#error "CAN TX low priority BUS FIFO len should be power of 2 and not too small for a frame message with written time"
+#endif
+#endif
+
+/* CAN TX priority. High priority frames are TX before any normal priority frame, low priority frames are TX last. */
+typedef enum
+{
+    CANTP_TX_PRIO_HIGH,     /* FC and NRC 0x78 response pending, must be TX in N_Bs/P2* */
+    CANTP_TX_PRIO_NORMAL,   /* Other frames */
+#ifdef EN_PERIODIC_DID
+    CANTP_TX_PRIO_LOW,      /* Periodic DID frames, TX when no TP frame is waiting */
+#endif
+    CANTP_TX_PRIO_NUM
+} tCANTPTxPrio;
+
+/* CAN TX latency statistics of a priority, from written in TX BUS FIFO to TX successful */
+typedef struct
+{
+    uint32 txCnt;           /* TX successful frames */
+    uint32 totalLatency;    /* Sum of latency, ms */
+    uint32 maxLatency;      /* Max latency, ms */
+} tCANTPTxLatency;
 
 #define NORMAL_ADDRESSING (0u) /* Normal addressing */
 #define MIXED_ADDRESSING  (1u) /* Mixed addressing */
@@ -72,6 +113,9 @@ typedef struct
 /* UDS Network layer config info */
 extern const tUdsCANNetLayerCfg g_stCANUdsNetLayerCfgInfo;
 
+/* UDS send message to CAN TP queue */
+extern const tFifoHandle g_xCANTxTPQueue;
+
 
 tUdsId CANTP_GetConfigTxMsgID(void);
 
@@ -89,8 +133,24 @@ boolean CANTP_DriverWriteDataInCANTP(const uint32 i_RxID, const uint32 i_dataLen
 
 void CANTP_RegisterAbortTxMsg(const tpfAbortTxMsg i_pfAbortTxMsg);
 
+void CANTP_RegisterStartTxMsg(const tpfStartTxMsg i_pfStartTxMsg);
+
 void CANTP_DoTxMsgSuccessfulCallBack(void);
 
+void CANTP_GetTxLatency(const tCANTPTxPrio i_ePrio, tCANTPTxLatency *o_pstLatency);
+
+void CANTP_ResetTxLatency(void);
+
+#ifdef EN_PERIODIC_DID
+tUdsId CANTP_GetConfigTxPeriodicMsgID(void);
+
+boolean CANTP_TxPeriodicFrame(const uint8 *i_pDataBuf, const uint8 i_DataLen);
+#endif
+
+boolean CANTP_DriverPeekDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader);
+
+void CANTP_DriverReleaseDataFromCANTP(void);
+
 boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader);
 
 #endif /* EN_CAN_TP*/
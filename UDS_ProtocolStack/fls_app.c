@@ -13,11 +13,17 @@
 #include "CRC_hal.h"
 #include "watchdog_hal.h"
 #include "uds_app.h"
+#ifdef EN_DOWNLOAD_STATISTICS
+#include "timer_hal.h"
+#endif
 
 
 #define MAX_DATA_ITEM (16u)      /* Max data item */
 #define MAX_DATA_BUF_LEN (128u)  /* Max data buffer len */
 
+/* Max time of check sum, CRC not more than 1ms per KB */
+#define FlashChecksumMaxTimeMs(xLen) (((xLen) >> 10u) + 1u)
+
 typedef struct
 {
     uint32 startAddr;   /* Start addr */
@@ -59,6 +65,19 @@ typedef struct
 } tAppFlashStatus;
 
 
+/* A buffered block of program data */
+typedef struct
+{
+    /* Block data len, 0 is free buffer */
+    uint32 dataLen;
+
+    /* Programmed data len of the block */
+    uint32 programmedLen;
+
+    /* Block data, last data is filled 0xFF to align 8 bytes */
+    uint8 aDataBuf[MAX_FLASH_DATA_LEN];
+} tProgramDataBuff;
+
 typedef struct
 {
     /* Flag if finger print has written */
@@ -73,8 +92,41 @@ typedef struct
     /* Request active job UDS service ID */
     uint8 requestActiveJobUDSSerID;
 
-    /* Storage program data buffer */
-    uint8 aProgramDataBuff[MAX_FLASH_DATA_LEN];
+    /* Flag if next check sum is compared by host, e.g. XCP BUILD_CHECKSUM */
+    uint8 isCheckSumVerifiedByHost;
+
+    /* Flag if a buffered block is programmed failed after its positive response */
+    uint8 isProgramFailed;
+
+    /* Buffered blocks are programmed in received order */
+    uint8 ucProgramBuffHead;
+
+    /* Buffered blocks count */
+    uint8 ucProgramBuffCnt;
+
+    /* Storage program data buffers */
+    tProgramDataBuff astProgramDataBuff[PROGRAM_BUFF_NUM];
+
+#if (defined EN_DELTA_UPDATE) && (!defined EN_SUPPORT_APP_B)
+    /* Sector updated by FLASH_UPDATING_SECTOR job */
+    uint32 sectorAddr;
+
+    /* Sector data, kept by caller until the job finished */
+    const uint8 *pSectorBuf;
+
+    /* Programmed data len of the sector */
+    uint32 sectorProgrammedLen;
+
+    /* Flag if the sector is erased */
+    uint8 isSectorErased;
+#endif
+
+#ifdef EN_PERIODIC_DID
+    /* Erased sectors, total sectors and next erase sector address of the erase job */
+    uint32 erasedSectors;
+    uint32 eraseTotalSectors;
+    uint32 eraseAddr;
+#endif
 
     /* Current process start address */
     uint32 startAddr;
@@ -91,8 +143,8 @@ typedef struct
     /* Received CRC value */
     uint32 receivedCRC;
 
-    /* Received program data length */
-    uint32 receiveProgramDataLength;
+    /* Last counted CRC value */
+    uint32 countedCRC;
 
     /* Flash loader download step */
     tFlDownloadStepType eDownloadStep;
@@ -100,6 +152,9 @@ typedef struct
     /* Current job status */
     tFlshJobModle eActiveJob;
 
+    /* Job continued after FLASH_WAITING */
+    tFlshJobModle eWaitingJob;
+
     /* Active job finished callback */
     tpfResponse pfActiveJobFinshedCallBack;
 
@@ -154,6 +209,20 @@ static uint8 gs_reqTimeStatus = 0xFFu;
 /* Application flash status */
 static tAppFlashStatus gs_stAppFlashStatus;
 
+#ifdef EN_UPLOAD_MEMORY
+/* Read flash data API, flash is memory mapped and read without flash driver */
+static tpfReadFlashData gs_pfReadFlashData = NULL_PTR;
+#endif
+
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Flash job statistics */
+static tFlashStatistics gs_stFlashStatistics;
+
+/* Timed job and its start ms tick */
+static tFlshJobModle gs_eTimedJob = FLASH_IDLE;
+static uint32 gs_jobStartMs = 0u;
+#endif
+
 /* Set request time status */
 #define ClearRequestTimeStauts()\
     do{\
@@ -241,7 +310,15 @@ static uint8 FlashChecksum(boolean *o_pbIsOperateFinsh);
 static uint8 FlashErase(boolean *o_pbIsOperateFinsh);
 
 /* Save flash data buffer */
-static uint8 SavedFlashData(const uint8 *i_pDataBuf, const uint8 i_dataLen);
+static uint8 SavedFlashData(const uint8 *i_pDataBuf, const uint32 i_dataLen);
+
+/* Program buffered blocks until not more than i_buffCnt blocks are buffered */
+static uint8 FlashWriteBuffers(const uint8 i_buffCnt);
+
+#if (defined EN_DELTA_UPDATE) && (!defined EN_SUPPORT_APP_B)
+/* Erase the sector, then program it a unit once */
+static uint8 FlashUpdateSector(boolean *o_pbIsOperateFinsh);
+#endif
 
 /* Read application information from flash */
 static void ReadNewestAppInfoFromFlash(void);
@@ -249,10 +326,22 @@ static void ReadNewestAppInfoFromFlash(void);
 /* Restore operate flash active job */
 static void RestoreOperateFlashActiveJob(const tFlshJobModle i_activeJob);
 
+/* Is operate time enough before host timeout? */
+static boolean IsOperateTimeEnough(const uint32 i_operateTimeMs);
+
+/* Request more time successful from host */
+static void RequetMoreTimeSuccessfulFromHost(uint8 i_txMsgStatus);
+
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Count time of the timed job when active job is changed */
+static void CountFlashJobTime(const tFlshJobModle i_activeJob);
+#endif
+
 /* Init flash download */
 void Flash_InitDowloadInfo(void)
 {
     gs_stFlashDownloadInfo.isFingerPrintWritten = FALSE;
+    gs_stFlashDownloadInfo.isCheckSumVerifiedByHost = FALSE;
 
     if (TRUE == IsFlashDriverDownload())
     {
@@ -265,6 +354,8 @@ void Flash_InitDowloadInfo(void)
 
     Flash_SetNextDownloadStep(FL_REQUEST_STEP);
     Flash_SetOperateFlashActiveJob(FLASH_IDLE, NULL_PTR, INVALID_UDS_SERVICES_ID, NULL_PTR);
+    gs_stFlashDownloadInfo.ucProgramBuffHead = 0u;
+    gs_stFlashDownloadInfo.ucProgramBuffCnt = 0u;
     gs_stFlashDownloadInfo.pstAppFlashStatus = &gs_stAppFlashStatus;
     fsl_memset(&gs_stFlashDownloadInfo.stFlashOperateAPI, 0x0u, sizeof(tFlashOperateAPI));
     fsl_memset(&gs_stAppFlashStatus, 0xFFu, sizeof(tAppFlashStatus));
@@ -273,17 +364,33 @@ void Flash_InitDowloadInfo(void)
 /* Flash APP module init */
 void FLASH_APP_Init(void)
 {
+#ifdef EN_UPLOAD_MEMORY
+    tFlashOperateAPI stFlashOperateAPI;
+#endif
     gs_stFlashDownloadInfo.isFingerPrintWritten = FALSE;
+    gs_stFlashDownloadInfo.isCheckSumVerifiedByHost = FALSE;
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
     /* TODO : #00 ļַռ⣬APP вִбᵼ HardFault */
     Flash_EraseFlashDriverInRAM();
 #endif
     SetFlashDriverNotDonwload();
+    gs_stFlashDownloadInfo.isProgramFailed = FALSE;
     Flash_SetNextDownloadStep(FL_REQUEST_STEP);
     Flash_SetOperateFlashActiveJob(FLASH_IDLE, NULL_PTR, INVALID_UDS_SERVICES_ID, NULL_PTR);
+    gs_stFlashDownloadInfo.ucProgramBuffHead = 0u;
+    gs_stFlashDownloadInfo.ucProgramBuffCnt = 0u;
     gs_stFlashDownloadInfo.pstAppFlashStatus = &gs_stAppFlashStatus;
     fsl_memset(&gs_stFlashDownloadInfo.stFlashOperateAPI, 0x0u, sizeof(tFlashOperateAPI));
     fsl_memset(&gs_stAppFlashStatus, 0xFFu, sizeof(tAppFlashStatus));
+#ifdef EN_UPLOAD_MEMORY
+
+    /* Read API is kept, flash driver API is cleared when download info is init */
+    if (TRUE == FLASH_HAL_RegisterFlashAPI(&stFlashOperateAPI))
+    {
+        gs_pfReadFlashData = stFlashOperateAPI.pfReadFlashData;
+    }
+
+#endif
 }
 
 /* Flash operate main function */
@@ -291,6 +398,7 @@ void Flash_OperateMainFunction(void)
 {
     tFlshJobModle currentFlashJob = FLASH_IDLE;
     boolean bIsOperateFinshed = FALSE;
+    tpfResponse pfActiveJobFinshedCallBack = NULL_PTR;
     currentFlashJob = Flash_GetOperateFlashActiveJob();
 
     switch (currentFlashJob)
@@ -303,7 +411,7 @@ void Flash_OperateMainFunction(void)
 
         case FLASH_PROGRAMMING:
             bIsOperateFinshed = TRUE;
-            /* Do the flash program */
+            /* Program a unit of buffered blocks, TP receives next block between units */
             gs_stFlashDownloadInfo.errorCode = FlashWrite(&bIsOperateFinshed);
             break;
 
@@ -313,11 +421,19 @@ void Flash_OperateMainFunction(void)
             gs_stFlashDownloadInfo.errorCode = FlashChecksum(&bIsOperateFinshed);
             break;
 
+#if (defined EN_DELTA_UPDATE) && (!defined EN_SUPPORT_APP_B)
+
+        case FLASH_UPDATING_SECTOR:
+            bIsOperateFinshed = FALSE;
+            gs_stFlashDownloadInfo.errorCode = FlashUpdateSector(&bIsOperateFinshed);
+            break;
+#endif
+
         case FLASH_WAITING:
             if (TRUE == IsReqestTimeSuccessfull())
             {
                 ClearRequestTimeStauts();
-                RestoreOperateFlashActiveJob(FLASH_ERASING);
+                RestoreOperateFlashActiveJob(gs_stFlashDownloadInfo.eWaitingJob);
             }
             else if (TRUE == IsRequestTimeFailed())
             {
@@ -343,23 +459,31 @@ void Flash_OperateMainFunction(void)
     /* Just operate flash finished, can do callback and set next job. */
     if (TRUE == bIsOperateFinshed)
     {
-        if ((NULL_PTR != gs_stFlashDownloadInfo.pfActiveJobFinshedCallBack) && (FLASH_IDLE != currentFlashJob))
-        {
-            (gs_stFlashDownloadInfo.pfActiveJobFinshedCallBack)(gs_stFlashDownloadInfo.errorCode);
-            gs_stFlashDownloadInfo.pfActiveJobFinshedCallBack = NULL_PTR;
-        }
+        pfActiveJobFinshedCallBack = gs_stFlashDownloadInfo.pfActiveJobFinshedCallBack;
 
         if ((gs_stFlashDownloadInfo.errorCode != TRUE) &&
                 ((FLASH_ERASING == currentFlashJob) ||
                  (FLASH_PROGRAMMING == currentFlashJob) ||
-                 (FLASH_CHECKING == currentFlashJob)))
+                 (FLASH_CHECKING == currentFlashJob) ||
+                 (FLASH_UPDATING_SECTOR == currentFlashJob)))
         {
             /* Initialize the flash download state */
             Flash_InitDowloadInfo();
+
+            if (FLASH_PROGRAMMING == currentFlashJob)
+            {
+                /* Block has been responded positive, report it at next TransferData or RequestTransferExit */
+                gs_stFlashDownloadInfo.isProgramFailed = TRUE;
+            }
         }
 
-        /* Set flash job is IDLE */
+        /* Set flash job is IDLE before callback, callback may set next job */
         Flash_SetOperateFlashActiveJob(FLASH_IDLE, NULL_PTR, INVALID_UDS_SERVICES_ID, NULL_PTR);
+
+        if ((NULL_PTR != pfActiveJobFinshedCallBack) && (FLASH_IDLE != currentFlashJob))
+        {
+            pfActiveJobFinshedCallBack(gs_stFlashDownloadInfo.errorCode);
+        }
     }
 }
 
@@ -397,6 +521,8 @@ void Flash_SaveDownloadDataInfo(const uint32 i_dataStartAddr, const uint32 i_dat
     /* Calculate data CRC info */
     gs_stFlashDownloadInfo.receivedDataStartAddr = i_dataStartAddr;
     gs_stFlashDownloadInfo.receivedDataLength = i_dataLen;
+    /* New download, program failed is reported already */
+    gs_stFlashDownloadInfo.isProgramFailed = FALSE;
 }
 
 /* Set operate flash active job. */
@@ -405,6 +531,9 @@ void Flash_SetOperateFlashActiveJob(const tFlshJobModle i_activeJob,
                                     const uint8 i_requestUDSSerID,
                                     const tpfReuestMoreTime i_pfRequestMoreTimeCallback)
 {
+#ifdef EN_DOWNLOAD_STATISTICS
+    CountFlashJobTime(i_activeJob);
+#endif
     gs_stFlashDownloadInfo.eActiveJob = i_activeJob;
     gs_stFlashDownloadInfo.requestActiveJobUDSSerID = i_requestUDSSerID;
     gs_stFlashDownloadInfo.pfRequestMoreTime = i_pfRequestMoreTimeCallback;
@@ -417,6 +546,101 @@ static void RestoreOperateFlashActiveJob(const tFlshJobModle i_activeJob)
     gs_stFlashDownloadInfo.eActiveJob = i_activeJob;
 }
 
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Count time of the timed job when active job is changed. A job waiting more time is not changed.
+   ms tick difference of a short job is 0 or 1, sum of many jobs is right in average. */
+static void CountFlashJobTime(const tFlshJobModle i_activeJob)
+{
+    const uint32 curMs = TIMER_HAL_GetMsTickCnt();
+
+    if (i_activeJob == gs_eTimedJob)
+    {
+        return;
+    }
+
+    if (gs_eTimedJob < FLASH_WAITING)
+    {
+        gs_stFlashStatistics.aJobTimeMs[gs_eTimedJob] += curMs - gs_jobStartMs;
+    }
+
+    gs_eTimedJob = i_activeJob;
+    gs_jobStartMs = curMs;
+}
+
+/* Get flash job statistics, the running job is counted when it is finished */
+void Flash_GetStatistics(tFlashStatistics *o_pstStatistics)
+{
+    ASSERT(NULL_PTR == o_pstStatistics);
+
+    *o_pstStatistics = gs_stFlashStatistics;
+}
+#endif
+
+#ifdef EN_PERIODIC_DID
+/* Get flash download progress */
+void Flash_GetProgress(tFlashProgress *o_pstProgress)
+{
+    tFlshJobModle eActiveJob = gs_stFlashDownloadInfo.eActiveJob;
+    ASSERT(NULL_PTR == o_pstProgress);
+
+    o_pstProgress->isWaitingMoreTime = (FLASH_WAITING == eActiveJob) ? TRUE : FALSE;
+
+    if (FLASH_WAITING == eActiveJob)
+    {
+        eActiveJob = gs_stFlashDownloadInfo.eWaitingJob;
+    }
+
+    o_pstProgress->eDownloadStep = gs_stFlashDownloadInfo.eDownloadStep;
+    o_pstProgress->eActiveJob = eActiveJob;
+    o_pstProgress->isProgramFailed = gs_stFlashDownloadInfo.isProgramFailed;
+    o_pstProgress->dataLen = gs_stFlashDownloadInfo.receivedDataLength;
+    o_pstProgress->programmedLen = 0u;
+    o_pstProgress->erasedSectors = gs_stFlashDownloadInfo.erasedSectors;
+    o_pstProgress->totalSectors = gs_stFlashDownloadInfo.eraseTotalSectors;
+    o_pstProgress->curAddr = gs_stFlashDownloadInfo.startAddr;
+
+    /* Remain len is counted down by program job after RequestDownload, received len is cleared by check sum */
+    if (gs_stFlashDownloadInfo.length <= gs_stFlashDownloadInfo.receivedDataLength)
+    {
+        o_pstProgress->programmedLen = gs_stFlashDownloadInfo.receivedDataLength - gs_stFlashDownloadInfo.length;
+    }
+
+    if (FLASH_ERASING == eActiveJob)
+    {
+        o_pstProgress->curAddr = gs_stFlashDownloadInfo.eraseAddr;
+    }
+
+#if (defined EN_DELTA_UPDATE) && (!defined EN_SUPPORT_APP_B)
+
+    if (FLASH_UPDATING_SECTOR == eActiveJob)
+    {
+        o_pstProgress->curAddr = gs_stFlashDownloadInfo.sectorAddr + gs_stFlashDownloadInfo.sectorProgrammedLen;
+    }
+
+#endif
+}
+#endif
+
+/* Is operate time enough before host timeout? If not, request more time from host and wait in FLASH_WAITING */
+static boolean IsOperateTimeEnough(const uint32 i_operateTimeMs)
+{
+    if (NULL_PTR == gs_stFlashDownloadInfo.pfRequestMoreTime)
+    {
+        return TRUE;
+    }
+
+    if (TRUE == gs_stFlashDownloadInfo.pfRequestMoreTime(gs_stFlashDownloadInfo.requestActiveJobUDSSerID,
+            i_operateTimeMs,
+            RequetMoreTimeSuccessfulFromHost))
+    {
+        return TRUE;
+    }
+
+    gs_stFlashDownloadInfo.eWaitingJob = gs_stFlashDownloadInfo.eActiveJob;
+    RestoreOperateFlashActiveJob(FLASH_WAITING);
+    return FALSE;
+}
+
 /* Get operate flash active job */
 tFlshJobModle Flash_GetOperateFlashActiveJob(void)
 {
@@ -429,18 +653,43 @@ void Flash_RegisterJobCallback(tpfResponse i_pfDoResponse)
     gs_stFlashDownloadInfo.pfActiveJobFinshedCallBack = i_pfDoResponse;
 }
 
-/* Save flash data buffer */
-static uint8 SavedFlashData(const uint8 *i_pDataBuf, const uint8 i_dataLen)
+/* Save flash data in a free buffer */
+static uint8 SavedFlashData(const uint8 *i_pDataBuf, const uint32 i_dataLen)
 {
+    tProgramDataBuff *pstProgramDataBuff = NULL_PTR;
     ASSERT(NULL_PTR == i_pDataBuf);
 
-    if (i_dataLen > MAX_FLASH_DATA_LEN)
+    if ((0u == i_dataLen) || (i_dataLen > MAX_FLASH_DATA_LEN) ||
+            (gs_stFlashDownloadInfo.ucProgramBuffCnt >= PROGRAM_BUFF_NUM))
     {
         return FALSE;
     }
 
-    fsl_memcpy(gs_stFlashDownloadInfo.aProgramDataBuff, i_pDataBuf, i_dataLen);
-    gs_stFlashDownloadInfo.receiveProgramDataLength = i_dataLen;
+    pstProgramDataBuff = &gs_stFlashDownloadInfo.astProgramDataBuff[(gs_stFlashDownloadInfo.ucProgramBuffHead +
+                                                                      gs_stFlashDownloadInfo.ucProgramBuffCnt) %
+                                                                     PROGRAM_BUFF_NUM];
+    fsl_memcpy(pstProgramDataBuff->aDataBuf, i_pDataBuf, i_dataLen);
+    pstProgramDataBuff->dataLen = i_dataLen;
+    pstProgramDataBuff->programmedLen = 0u;
+    gs_stFlashDownloadInfo.ucProgramBuffCnt++;
+    return TRUE;
+}
+
+/* Program buffered blocks until not more than i_buffCnt blocks are buffered */
+static uint8 FlashWriteBuffers(const uint8 i_buffCnt)
+{
+    boolean bIsOperateFinsh = FALSE;
+
+    while (gs_stFlashDownloadInfo.ucProgramBuffCnt > i_buffCnt)
+    {
+        if (TRUE != FlashWrite(&bIsOperateFinsh))
+        {
+            Flash_InitDowloadInfo();
+            gs_stFlashDownloadInfo.isProgramFailed = TRUE;
+            return FALSE;
+        }
+    }
+
     return TRUE;
 }
 
@@ -469,7 +718,7 @@ static uint8 FlashErase(boolean *o_pbIsOperateFinsh)
     static BlockInfo_t *s_pAppFlashMemoryInfo = NULL_PTR;
     static uint32 s_appFlashItem = 0u;
     uint32 sectorNo = 0u;
-    const uint32 maxEraseSectors = UDS_GetUDSS3WatermarkTimerMs() / FLASH_HAL_GetEraseFlashASectorMaxTimeMs();
+    const uint32 maxEraseSectors = UDS_GetUDSP2ExtWatermarkTimerMs() / FLASH_HAL_GetEraseFlashASectorMaxTimeMs();
     uint32 totalSectors = 0u;
     uint32 canEraseMaxSectors = 0u;
     static uint32 s_eraseSectorsCnt = 0u;
@@ -494,10 +743,17 @@ static uint8 FlashErase(boolean *o_pbIsOperateFinsh)
             s_appFlashItem = 0u;
             s_eraseSectorsCnt = 0u;
             s_result = TRUE;
+#ifdef EN_PERIODIC_DID
+            gs_stFlashDownloadInfo.erasedSectors = 0u;
+            gs_stFlashDownloadInfo.eraseTotalSectors = FLASH_HAL_GetTotalSectors(s_appType);
+#endif
 
             /* Get old APP type flash config */
             if (TRUE == FLASH_HAL_GetFlashConfigInfo(s_appType, &s_pAppFlashMemoryInfo, &s_appFlashItem))
             {
+#ifdef EN_PERIODIC_DID
+                gs_stFlashDownloadInfo.eraseAddr = s_pAppFlashMemoryInfo->xBlockStartLogicalAddr;
+#endif
                 SetEraseFlashStep(DO_ERASING_FLASH);
             }
 
@@ -507,6 +763,19 @@ static uint8 FlashErase(boolean *o_pbIsOperateFinsh)
             /* Get total sectors */
             totalSectors = FLASH_HAL_GetTotalSectors(s_appType);
 
+            /* Sectors erased once (interrupts disabled) should be done before host timeout, else wait more time */
+            sectorNo = maxEraseSectors - (s_eraseSectorsCnt % maxEraseSectors);
+
+            if (sectorNo > (totalSectors - s_eraseSectorsCnt))
+            {
+                sectorNo = totalSectors - s_eraseSectorsCnt;
+            }
+
+            if (TRUE != IsOperateTimeEnough(sectorNo * FLASH_HAL_GetEraseFlashASectorMaxTimeMs()))
+            {
+                break;
+            }
+
             /* One time erase all flash sectors */
             if (totalSectors <= maxEraseSectors)
             {
@@ -657,7 +926,7 @@ static uint8 FlashErase(boolean *o_pbIsOperateFinsh)
                     /* Add erased sectors count */
                     s_eraseSectorsCnt += sectorNo;
 
-                    /* If erase max Erase sectors and have some sectors wait to erase, then request time from host */
+                    /* If erase max Erase sectors and have some sectors wait to erase, then erase them in next time slice */
                     if ((0u == (s_eraseSectorsCnt % maxEraseSectors)) && (s_eraseSectorsCnt < totalSectors))
                     {
                         *o_pbIsOperateFinsh = FALSE;
@@ -666,15 +935,20 @@ static uint8 FlashErase(boolean *o_pbIsOperateFinsh)
                 }
             }
 
-            if ((FALSE == *o_pbIsOperateFinsh) && (TRUE == s_result) && (s_eraseSectorsCnt < totalSectors))
+#ifdef EN_PERIODIC_DID
+            gs_stFlashDownloadInfo.erasedSectors = s_eraseSectorsCnt;
+
+            /* Erased sectors are continuous, next sector follows the last erased one */
+            if (0u != eraseFlashStartAddr)
             {
-                RestoreOperateFlashActiveJob(FLASH_WAITING);
+                gs_stFlashDownloadInfo.eraseAddr = eraseFlashStartAddr;
+            }
 
-                /* Request more time from host */
-                if (NULL_PTR != gs_stFlashDownloadInfo.pfRequestMoreTime)
-                {
-                    gs_stFlashDownloadInfo.pfRequestMoreTime(gs_stFlashDownloadInfo.requestActiveJobUDSSerID, RequetMoreTimeSuccessfulFromHost);
-                }
+#endif
+
+            if ((FALSE == *o_pbIsOperateFinsh) && (TRUE == s_result) && (s_eraseSectorsCnt < totalSectors))
+            {
+                /* Do nothing, continue erasing when operate time is enough */
             }
             else
             {
@@ -711,13 +985,17 @@ static uint8 FlashErase(boolean *o_pbIsOperateFinsh)
     return s_result;
 }
 
-/* Flash write */
+/* Flash write a program unit of the oldest buffered block. Finished if all buffered blocks are programmed. */
 static uint8 FlashWrite(boolean *o_pbIsOperateFinsh)
 {
     uint8 result = FALSE;
     uint32 countCrc = 0u;
-    uint8 flashDataIndex = 0u;
-    uint8 fillCnt = 0u;
+    uint32 programLen = 0u;
+    uint32 fillCnt = 0u;
+    tProgramDataBuff *pstProgramDataBuff = NULL_PTR;
+    ASSERT(NULL_PTR == o_pbIsOperateFinsh);
+
+    *o_pbIsOperateFinsh = TRUE;
 
     /* Check flash driver valid or not? */
     if (TRUE != IsFlashDriverDownload())
@@ -725,107 +1003,167 @@ static uint8 FlashWrite(boolean *o_pbIsOperateFinsh)
         return FALSE;
     }
 
-    result = TRUE;
+    if (0u == gs_stFlashDownloadInfo.ucProgramBuffCnt)
+    {
+        return TRUE;
+    }
+
+    pstProgramDataBuff = &gs_stFlashDownloadInfo.astProgramDataBuff[gs_stFlashDownloadInfo.ucProgramBuffHead];
+    programLen = pstProgramDataBuff->dataLen - pstProgramDataBuff->programmedLen;
 
-    while (gs_stFlashDownloadInfo.receiveProgramDataLength >= PROGRAM_SIZE)
+    if (programLen > PROGRAM_SIZE)
     {
-        /* Count application flash CRC */
-        CreateAppStatusCrc(&countCrc);
+        programLen = PROGRAM_SIZE;
+    }
+    else
+    {
+        /* Calculate if program data is align < 8 bytes, need to fill 0xFF to align 8 bytes. */
+        fillCnt = (~programLen + 1u) & 0x07u;
+        fsl_memset((void *)&pstProgramDataBuff->aDataBuf[pstProgramDataBuff->dataLen], 0xFFu, fillCnt);
+    }
 
-        if (TRUE != IsFlashAppCrcEqualStorage(countCrc))
-        {
-            /* CRC not right */
-            result = FALSE;
-            break;
-        }
+    /* Count application flash CRC */
+    CreateAppStatusCrc(&countCrc);
 
-        if ((TRUE == IsFlashEraseSuccessful()) &&
-                (TRUE == IsFlashStructValid()))
-        {
-            WATCHDOG_HAL_Feed();
+    if ((TRUE == IsFlashAppCrcEqualStorage(countCrc)) &&
+            (TRUE == IsFlashEraseSuccessful()) &&
+            (TRUE == IsFlashStructValid()) &&
+            (NULL_PTR != gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData))
+    {
+        WATCHDOG_HAL_Feed();
+        /* Write data in flash */
+        DisableAllInterrupts();
+        result = gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData(gs_stFlashDownloadInfo.startAddr,
+                 &pstProgramDataBuff->aDataBuf[pstProgramDataBuff->programmedLen],
+                 programLen + fillCnt);
+        EnableAllInterrupts();
+    }
 
-            /* Write data in flash */
-            if (NULL_PTR != gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData)
-            {
-                DisableAllInterrupts();
-                result = gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData(gs_stFlashDownloadInfo.startAddr,
-                         &gs_stFlashDownloadInfo.aProgramDataBuff[flashDataIndex * PROGRAM_SIZE],
-                         PROGRAM_SIZE);
-                EnableAllInterrupts();
-            }
-            else
-            {
-                result = FALSE;
-            }
+    if (TRUE != result)
+    {
+        return FALSE;
+    }
 
-            if (TRUE == result)
-            {
-                gs_stFlashDownloadInfo.length -= PROGRAM_SIZE;
-                gs_stFlashDownloadInfo.receiveProgramDataLength -= PROGRAM_SIZE;
-                gs_stFlashDownloadInfo.startAddr += PROGRAM_SIZE;
-                flashDataIndex++;
-            }
-            else
-            {
-                result = FALSE;
-                break;
-            }
-        }
-        else
-        {
-            result = FALSE;
-            break;
-        }
+    gs_stFlashDownloadInfo.length -= programLen;
+    gs_stFlashDownloadInfo.startAddr += programLen + fillCnt;
+    pstProgramDataBuff->programmedLen += programLen;
+#ifdef EN_DOWNLOAD_STATISTICS
+    gs_stFlashStatistics.programmedBytes += programLen;
+#endif
+
+    /* The block is programmed, free the buffer */
+    if (pstProgramDataBuff->programmedLen >= pstProgramDataBuff->dataLen)
+    {
+        pstProgramDataBuff->dataLen = 0u;
+        gs_stFlashDownloadInfo.ucProgramBuffHead = (gs_stFlashDownloadInfo.ucProgramBuffHead + 1u) % PROGRAM_BUFF_NUM;
+        gs_stFlashDownloadInfo.ucProgramBuffCnt--;
+        SetFlashProgramStatus(TRUE);
+        CreateAndSaveAppStatusCrc(&countCrc);
     }
 
-    /* Calculate if program data is align < 8 bytes, need to fill 0xFF to align 8 bytes. */
-    if ((0u != gs_stFlashDownloadInfo.receiveProgramDataLength) && (TRUE == result))
+    *o_pbIsOperateFinsh = (0u == gs_stFlashDownloadInfo.ucProgramBuffCnt) ? TRUE : FALSE;
+    return TRUE;
+}
+
+#if (defined EN_DELTA_UPDATE) && (!defined EN_SUPPORT_APP_B)
+/* Erase the sector, then program it a unit once, TP and UDS run between units. Finished if the sector is programmed. */
+static uint8 FlashUpdateSector(boolean *o_pbIsOperateFinsh)
+{
+    uint8 result = FALSE;
+    uint32 countCrc = 0u;
+    uint32 index = 0u;
+    const uint8 *pProgramData = NULL_PTR;
+    ASSERT(NULL_PTR == o_pbIsOperateFinsh);
+
+    *o_pbIsOperateFinsh = TRUE;
+
+    /* Count application flash CRC */
+    CreateAppStatusCrc(&countCrc);
+
+    if ((TRUE != IsFlashDriverDownload()) ||
+            (TRUE != IsFlashAppCrcEqualStorage(countCrc)) ||
+            (TRUE != IsFlashEraseSuccessful()) ||
+            (TRUE != IsFlashStructValid()) ||
+            (NULL_PTR == gs_stFlashDownloadInfo.stFlashOperateAPI.pfEraserSecotr) ||
+            (NULL_PTR == gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData))
     {
-        fillCnt = (uint8)(gs_stFlashDownloadInfo.receiveProgramDataLength & 0x07u);
-        fillCnt = (~fillCnt + 1u) & 0x07u;
-        fsl_memset((void *)&gs_stFlashDownloadInfo.aProgramDataBuff[flashDataIndex * PROGRAM_SIZE + gs_stFlashDownloadInfo.receiveProgramDataLength],
-                   0xFFu,
-                   fillCnt);
-        gs_stFlashDownloadInfo.receiveProgramDataLength += fillCnt;
+        return FALSE;
+    }
 
-        /* Write data in flash */
-        if (NULL_PTR != gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData)
-        {
-            DisableAllInterrupts();
-            result = gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData(gs_stFlashDownloadInfo.startAddr,
-                     &gs_stFlashDownloadInfo.aProgramDataBuff[flashDataIndex * PROGRAM_SIZE],
-                     gs_stFlashDownloadInfo.receiveProgramDataLength);
-            EnableAllInterrupts();
-        }
-        else
+    if (TRUE != gs_stFlashDownloadInfo.isSectorErased)
+    {
+        /* Erase a sector (interrupts disabled) should be done before host timeout, else wait more time */
+        if (TRUE != IsOperateTimeEnough(FLASH_HAL_GetEraseFlashASectorMaxTimeMs()))
         {
-            result = FALSE;
+            *o_pbIsOperateFinsh = FALSE;
+            return TRUE;
         }
 
-        if (TRUE == result)
-        {
-            gs_stFlashDownloadInfo.length -= (gs_stFlashDownloadInfo.receiveProgramDataLength - fillCnt);
-            gs_stFlashDownloadInfo.startAddr += gs_stFlashDownloadInfo.receiveProgramDataLength;
-            gs_stFlashDownloadInfo.receiveProgramDataLength = 0;
-            flashDataIndex++;
-        }
+        WATCHDOG_HAL_Feed();
+        DisableAllInterrupts();
+        result = gs_stFlashDownloadInfo.stFlashOperateAPI.pfEraserSecotr(gs_stFlashDownloadInfo.sectorAddr, 1u);
+        EnableAllInterrupts();
+        gs_stFlashDownloadInfo.isSectorErased = TRUE;
+        *o_pbIsOperateFinsh = (TRUE == result) ? FALSE : TRUE;
+        return result;
     }
 
-    if (TRUE == result)
+    pProgramData = &gs_stFlashDownloadInfo.pSectorBuf[gs_stFlashDownloadInfo.sectorProgrammedLen];
+
+    /* Erased flash is 0xFF, all 0xFF unit is not programmed */
+    while ((index < PROGRAM_SIZE) && (0xFFu == pProgramData[index]))
     {
-        SetFlashProgramStatus(TRUE);
-        CreateAndSaveAppStatusCrc(&countCrc);
+        index++;
+    }
+
+    result = TRUE;
+
+    if (index < PROGRAM_SIZE)
+    {
+        WATCHDOG_HAL_Feed();
+        DisableAllInterrupts();
+        result = gs_stFlashDownloadInfo.stFlashOperateAPI.pfProgramData(gs_stFlashDownloadInfo.sectorAddr +
+                 gs_stFlashDownloadInfo.sectorProgrammedLen,
+                 pProgramData,
+                 PROGRAM_SIZE);
+        EnableAllInterrupts();
+#ifdef EN_DOWNLOAD_STATISTICS
+        gs_stFlashStatistics.programmedBytes += PROGRAM_SIZE;
+#endif
+    }
+
+    if (TRUE != result)
+    {
+        return FALSE;
+    }
+
+    gs_stFlashDownloadInfo.sectorProgrammedLen += PROGRAM_SIZE;
+
+    if (gs_stFlashDownloadInfo.sectorProgrammedLen < FLASH_HAL_Get1SectorBytes())
+    {
+        *o_pbIsOperateFinsh = FALSE;
         return TRUE;
     }
 
-    Flash_InitDowloadInfo();
-    return FALSE;
+    SetFlashProgramStatus(TRUE);
+    CreateAndSaveAppStatusCrc(&countCrc);
+    return TRUE;
 }
+#endif
 
 /* Flash check sum */
 static uint8 FlashChecksum(boolean *o_pbIsOperateFinsh)
 {
     tCrc xCountCrc = 0u;
+    ASSERT(NULL_PTR == o_pbIsOperateFinsh);
+
+    /* Check sum should be done before host timeout, else wait more time */
+    if (TRUE != IsOperateTimeEnough(FlashChecksumMaxTimeMs(gs_stFlashDownloadInfo.receivedDataLength)))
+    {
+        *o_pbIsOperateFinsh = FALSE;
+        return TRUE;
+    }
+
     WATCHDOG_HAL_Feed();
 
     /* Reserved the if and else for external flash memory, like external flash need to flash driver read or write. */
@@ -847,12 +1185,15 @@ static uint8 FlashChecksum(boolean *o_pbIsOperateFinsh)
 
     /* Feed watch dog */
     WATCHDOG_HAL_Feed();
+    gs_stFlashDownloadInfo.countedCRC = xCountCrc;
 #ifdef DebugBootloader_NOTCRC
     if (1)
 #else
-    if (gs_stFlashDownloadInfo.receivedCRC == xCountCrc)
+    if ((TRUE == gs_stFlashDownloadInfo.isCheckSumVerifiedByHost) || (gs_stFlashDownloadInfo.receivedCRC == xCountCrc))
 #endif
     {
+        gs_stFlashDownloadInfo.isCheckSumVerifiedByHost = FALSE;
+
         if ((TRUE == IsFlashDriverSoftwareData()))
         {
             SetFlashDriverDowload();
@@ -873,6 +1214,7 @@ static uint8 FlashChecksum(boolean *o_pbIsOperateFinsh)
         return TRUE;
     }
 
+    gs_stFlashDownloadInfo.isCheckSumVerifiedByHost = FALSE;
     return FALSE;
 }
 
@@ -882,23 +1224,34 @@ void Flash_SavedReceivedCheckSumCrc(uint32 i_receivedCrc)
     gs_stFlashDownloadInfo.receivedCRC = (tCrc)i_receivedCrc;
 }
 
-/* Flash program region. Called by UDS service 0x36u */
+/* Next check sum is accepted and the counted CRC is compared by host */
+void Flash_SetCheckSumVerifiedByHost(void)
+{
+    gs_stFlashDownloadInfo.isCheckSumVerifiedByHost = TRUE;
+}
+
+/* Get CRC counted by last check sum */
+uint32 Flash_GetCountedCheckSumCrc(void)
+{
+    return gs_stFlashDownloadInfo.countedCRC;
+}
+
+/* Is flash driver downloaded? Erase and program APP need it */
+boolean Flash_IsFlashDriverDownloaded(void)
+{
+    return (boolean)IsFlashDriverDownload();
+}
+
+/* Flash program region. Called by UDS service 0x36u.
+   APP data is saved in a free buffer and programmed by flash job, the oldest block is programmed now if no free buffer. */
 uint8 Flash_ProgramRegion(const uint32 i_addr,
                           const uint8 *i_pDataBuf,
                           const uint32 i_dataLen)
 {
-    uint8 dataLen = (uint8)i_dataLen;
     uint8 result = TRUE;
     ASSERT(NULL_PTR == i_pDataBuf);
-    result = TRUE;
 
-    if (FL_TRANSFER_STEP != Flash_GetCurDownloadStep())
-    {
-        result = FALSE;
-    }
-
-    /* Saved flash data */
-    if (TRUE != SavedFlashData(i_pDataBuf, dataLen))
+    if ((FL_TRANSFER_STEP != Flash_GetCurDownloadStep()) || (i_dataLen > MAX_FLASH_DATA_LEN))
     {
         result = FALSE;
     }
@@ -910,16 +1263,21 @@ uint8 Flash_ProgramRegion(const uint32 i_addr,
             /* If flash driver, copy the data to RAM */
             if (TRUE == IsFlashDriverSoftwareData())
             {
-                fsl_memcpy((void *)i_addr, (void *)i_pDataBuf, dataLen);
+                fsl_memcpy((void *)i_addr, (void *)i_pDataBuf, i_dataLen);
             }
 
             Flash_SetOperateFlashActiveJob(FLASH_IDLE, NULL_PTR, INVALID_UDS_SERVICES_ID, NULL_PTR);
         }
-        else
+        else if ((TRUE == FlashWriteBuffers(PROGRAM_BUFF_NUM - 1u)) &&
+                 (TRUE == SavedFlashData(i_pDataBuf, i_dataLen)))
         {
             Flash_SetOperateFlashActiveJob(FLASH_PROGRAMMING, NULL_PTR, INVALID_UDS_SERVICES_ID, NULL_PTR);
             gs_stFlashDownloadInfo.errorCode = TRUE;
         }
+        else
+        {
+            result = FALSE;
+        }
     }
 
     /* Received error data. */
@@ -931,6 +1289,35 @@ uint8 Flash_ProgramRegion(const uint32 i_addr,
     return result;
 }
 
+/* Program all buffered blocks now, called before RequestTransferExit response */
+uint8 Flash_FlushProgramData(void)
+{
+    return FlashWriteBuffers(0u);
+}
+
+/* Is a buffered block programmed failed after its positive response? It is cleared by next request download. */
+uint8 Flash_IsProgramFailed(void)
+{
+    return gs_stFlashDownloadInfo.isProgramFailed;
+}
+
+#ifdef EN_UPLOAD_MEMORY
+/* Read flash data. Called by UDS service 0x23u and 0x36u. Flash is not read when it is erased or programmed. */
+uint8 Flash_ReadData(const uint32 i_addr, const uint32 i_dataLen, uint8 *o_pDataBuf)
+{
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    if ((NULL_PTR == gs_pfReadFlashData) ||
+            (FLASH_IDLE != Flash_GetOperateFlashActiveJob()) ||
+            (0u != gs_stFlashDownloadInfo.ucProgramBuffCnt))
+    {
+        return FALSE;
+    }
+
+    return (uint8)gs_pfReadFlashData(i_addr, i_dataLen, o_pDataBuf);
+}
+#endif
+
 /* Get rest hander address */
 uint32 Flash_GetResetHandlerAddr(void)
 {
@@ -1096,6 +1483,102 @@ uint8 Flash_WriteFlashAppInfo(void)
     return result;
 }
 
+#ifdef EN_DELTA_UPDATE
+/* Get installed APP image address of a download address, delta patch reads it. Installed APP should be valid. */
+boolean Flash_GetDeltaSourceInfo(const uint32 i_addr, uint32 *o_pSourceAddr, uint32 *o_pSourceLen)
+{
+    uint32 newestAppInfoStartAddr = 0u;
+    uint32 newestAppBlockSize = 0u;
+    uint32 oldAppInfoStartAddr = 0u;
+    uint32 oldAppBlockSize = 0u;
+    tCrc xCrc = 0u;
+    tAppFlashStatus stAppStatus;
+    ASSERT(NULL_PTR == o_pSourceAddr);
+    ASSERT(NULL_PTR == o_pSourceLen);
+
+    if ((TRUE != FLASH_HAL_GetAPPInfo(Flash_GetNewestAPPType(), &newestAppInfoStartAddr, &newestAppBlockSize)) ||
+            (TRUE != FLASH_HAL_GetAPPInfo(Flash_GetOldAPPType(), &oldAppInfoStartAddr, &oldAppBlockSize)) ||
+            (sizeof(tAppFlashStatus) > newestAppBlockSize))
+    {
+        return FALSE;
+    }
+
+    /* Download address is in the APP will be programmed (old APP), same offset in the newest APP is the source */
+    if ((i_addr < oldAppInfoStartAddr) || ((i_addr - oldAppInfoStartAddr) >= newestAppBlockSize) ||
+            ((i_addr - oldAppInfoStartAddr) >= oldAppBlockSize))
+    {
+        return FALSE;
+    }
+
+    /* Read newest APP info in a copy, download APP status is kept */
+    stAppStatus = *(tAppFlashStatus *)newestAppInfoStartAddr;
+    CRC_HAL_CreatSoftwareCrc((uint8 *)&stAppStatus, sizeof(stAppStatus) - 4u, &xCrc);
+
+    if ((stAppStatus.crc != xCrc) ||
+            (TRUE != stAppStatus.isFlashProgramSuccessfull) ||
+            (TRUE != stAppStatus.isFlashErasedSuccessfull) ||
+            (TRUE != stAppStatus.isFlashStructValid))
+    {
+        return FALSE;
+    }
+
+    *o_pSourceAddr = newestAppInfoStartAddr + (i_addr - oldAppInfoStartAddr);
+    *o_pSourceLen = newestAppBlockSize - (i_addr - oldAppInfoStartAddr);
+    return TRUE;
+}
+
+#ifndef EN_SUPPORT_APP_B
+/* Start sector staged download in place, sectors are erased one by one by Flash_UpdateSector, not by erase routine.
+   The first updated sector has APP info, so APP is invalid in flash once a sector is updated. */
+uint8 Flash_StartSectorStagedDownload(const uint32 i_addr)
+{
+    uint32 appInfoStartAddr = 0u;
+    uint32 appBlockSize = 0u;
+    tCrc xCrc = 0u;
+    const uint32 sectorLen = FLASH_HAL_Get1SectorBytes();
+
+    if ((TRUE != IsFlashDriverDownload()) ||
+            (TRUE != FLASH_HAL_GetAPPInfo(Flash_GetOldAPPType(), &appInfoStartAddr, &appBlockSize)) ||
+            ((appInfoStartAddr / sectorLen) != (i_addr / sectorLen)))
+    {
+        return FALSE;
+    }
+
+    SetAPPStatus(TRUE, FALSE, TRUE);
+    CreateAndSaveAppStatusCrc(&xCrc);
+    return TRUE;
+}
+
+/* Erase a sector and program sector data by flash job, sector data is kept until job finished. Called by UDS service 0x36u. */
+uint8 Flash_UpdateSector(const uint32 i_sectorAddr,
+                         const uint8 *i_pSectorBuf,
+                         const tpfResponse i_pfActiveFinshedCallBack,
+                         const uint8 i_requestUDSSerID,
+                         const tpfReuestMoreTime i_pfRequestMoreTimeCallback)
+{
+    ASSERT(NULL_PTR == i_pSectorBuf);
+
+    if ((FL_TRANSFER_STEP != Flash_GetCurDownloadStep()) ||
+            (TRUE != IsFlashDriverDownload()) ||
+            (FLASH_IDLE != Flash_GetOperateFlashActiveJob()))
+    {
+        return FALSE;
+    }
+
+    gs_stFlashDownloadInfo.sectorAddr = i_sectorAddr;
+    gs_stFlashDownloadInfo.pSectorBuf = i_pSectorBuf;
+    gs_stFlashDownloadInfo.sectorProgrammedLen = 0u;
+    gs_stFlashDownloadInfo.isSectorErased = FALSE;
+    gs_stFlashDownloadInfo.errorCode = TRUE;
+    Flash_SetOperateFlashActiveJob(FLASH_UPDATING_SECTOR,
+                                   i_pfActiveFinshedCallBack,
+                                   i_requestUDSSerID,
+                                   i_pfRequestMoreTimeCallback);
+    return TRUE;
+}
+#endif /* EN_SUPPORT_APP_B */
+#endif /* EN_DELTA_UPDATE */
+
 #ifdef EN_SUPPORT_APP_B
 static tAPPType DoCheckNewestAPPCnt(const tAppFlashStatus *i_pAppAInfo, const tAppFlashStatus *i_pAppBInfo)
 {
@@ -1238,6 +1721,35 @@ tAPPType Flash_GetNewestAPPType(void)
 #endif /* EN_SUPPORT_APP_B */
 }
 
+/* Get finger print and APP counter of the newest APP info in flash. Return FALSE if APP info is invalid. */
+uint8 Flash_GetNewestAppInfo(uint8 *o_pFingerPrint, uint8 *o_pAppCnt)
+{
+    uint32 appInfoStart = 0u;
+    uint32 appInfoBlocksize = 0u;
+    tCrc xCrc = 0u;
+    const tAppFlashStatus *pstAppInfo = NULL_PTR;
+    ASSERT(NULL_PTR == o_pFingerPrint);
+    ASSERT(NULL_PTR == o_pAppCnt);
+
+    if ((TRUE != FLASH_HAL_GetAPPInfo(Flash_GetNewestAPPType(), &appInfoStart, &appInfoBlocksize)) ||
+            (sizeof(tAppFlashStatus) > appInfoBlocksize))
+    {
+        return FALSE;
+    }
+
+    pstAppInfo = (const tAppFlashStatus *)appInfoStart;
+    CRC_HAL_CreatSoftwareCrc((const uint8 *)pstAppInfo, sizeof(tAppFlashStatus) - 4u, &xCrc);
+
+    if (xCrc != pstAppInfo->crc)
+    {
+        return FALSE;
+    }
+
+    fsl_memcpy(o_pFingerPrint, pstAppInfo->aFingerPrint, FL_FINGER_PRINT_LENGTH);
+    *o_pAppCnt = pstAppInfo->appCnt;
+    return TRUE;
+}
+
 /* Get old APP info */
 tAPPType Flash_GetOldAPPType(void)
 {
@@ -15,8 +15,21 @@
 #include "flash_hal.h"
 #include "includes.h"
 
-/* Every program flash size */
-#define PROGRAM_SIZE (128u)
+/* Every program flash size, a unit is programmed with interrupts disabled in a flash main function.
+   Small unit lets TP TX flow control and receive next block between units. */
+#define PROGRAM_SIZE (32u)
+
+#if ((PROGRAM_SIZE & 0x07u) != 0u) || (PROGRAM_SIZE == 0u)
+#error "PROGRAM_SIZE should be aligned to flash phrase (8 bytes)"
+#endif
+
+/* Program data buffers, 2 is double buffering, 3 is triple buffering.
+   Next block is received in a free buffer when the oldest block is programmed. */
+#define PROGRAM_BUFF_NUM (2u)
+
+#if (PROGRAM_BUFF_NUM < 1u) || (PROGRAM_BUFF_NUM > 0xFFu)
+#error "PROGRAM_BUFF_NUM should config [1, 255]"
+#endif
 
 /* Flash finger print length */
 #define FL_FINGER_PRINT_LENGTH  (17u)
@@ -26,11 +39,12 @@
 
 typedef enum
 {
-    FLASH_IDLE,           /* Flash idle */
-    FLASH_ERASING,        /* Erase flash */
-    FLASH_PROGRAMMING,    /* Program flash */
-    FLASH_CHECKING,       /* Check flash */
-    FLASH_WAITING         /* Waiting transmitted message successful */
+    FLASH_IDLE,             /* Flash idle */
+    FLASH_ERASING,          /* Erase flash */
+    FLASH_PROGRAMMING,      /* Program flash */
+    FLASH_CHECKING,         /* Check flash */
+    FLASH_UPDATING_SECTOR,  /* Erase a sector and program it, sector staged download */
+    FLASH_WAITING           /* Waiting transmitted message successful, then continue the job */
 } tFlshJobModle;
 
 typedef enum
@@ -49,9 +63,36 @@ typedef enum
 } tFlDownloadStepType;
 
 
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Flash job statistics after bootloader start */
+typedef struct
+{
+    uint32 aJobTimeMs[FLASH_WAITING];   /* Active time of every job, FLASH_WAITING of a job is counted in the job */
+    uint32 programmedBytes;             /* Programmed APP bytes */
+} tFlashStatistics;
+#endif
+
+#ifdef EN_PERIODIC_DID
+/* Flash download progress, pushed by periodic DIDs */
+typedef struct
+{
+    tFlDownloadStepType eDownloadStep;  /* Download step */
+    tFlshJobModle eActiveJob;           /* Active job, job waiting more time from host is reported */
+    uint8 isWaitingMoreTime;            /* Active job is waiting more time from host */
+    uint8 isProgramFailed;              /* A buffered block is programmed failed after its positive response */
+    uint32 dataLen;                     /* Data len of the download */
+    uint32 programmedLen;               /* Programmed data len of the download, sector staged update is not counted */
+    uint32 erasedSectors;               /* Erased sectors of the erase job */
+    uint32 totalSectors;                /* Total sectors of the erase job */
+    uint32 curAddr;                     /* Next program address, next erase sector address in erase job */
+} tFlashProgress;
+#endif
+
 /* input parameter : TRUE/FALSE. TRUE = operation successful, else failed. */
 typedef void (*tpfResponse)(uint8);
-typedef void (*tpfReuestMoreTime)(uint8, void (*)(uint8));
+/* Request operate time (ms) from host before a blocking job slice, input: service ID, time, TX pending callback.
+** return TRUE: time is enough, do it now. FALSE: host is requested more time, callback is called after pending TX. */
+typedef boolean (*tpfReuestMoreTime)(uint8, uint32, void (*)(uint8));
 
 void FLASH_APP_Init(void);
 
@@ -63,12 +104,34 @@ uint8 Flash_ProgramRegion(const uint32 i_addr,
                           const uint8 *i_pDataBuf,
                           const uint32 i_dataLen);
 
+uint8 Flash_FlushProgramData(void);
+
+uint8 Flash_IsProgramFailed(void);
+
+#ifdef EN_UPLOAD_MEMORY
+uint8 Flash_ReadData(const uint32 i_addr, const uint32 i_dataLen, uint8 *o_pDataBuf);
+#endif
+
+#ifdef EN_DOWNLOAD_STATISTICS
+void Flash_GetStatistics(tFlashStatistics *o_pstStatistics);
+#endif
+
+#ifdef EN_PERIODIC_DID
+void Flash_GetProgress(tFlashProgress *o_pstProgress);
+#endif
+
 uint8 Flash_IsReadAppInfoFromFlashValid(void);
 
 uint8 Flash_IsAppInFlashValid(void);
 
 void Flash_SavedReceivedCheckSumCrc(uint32 i_receivedCrc);
 
+void Flash_SetCheckSumVerifiedByHost(void);
+
+uint32 Flash_GetCountedCheckSumCrc(void);
+
+boolean Flash_IsFlashDriverDownloaded(void);
+
 void Flash_EraseFlashDriverInRAM(void);
 
 void Flash_SetNextDownloadStep(const tFlDownloadStepType i_donwloadStep);
@@ -94,6 +157,22 @@ uint8 Flash_WriteFlashAppInfo(void);
 
 tAPPType Flash_GetNewestAPPType(void);
 
+uint8 Flash_GetNewestAppInfo(uint8 *o_pFingerPrint, uint8 *o_pAppCnt);
+
+#ifdef EN_DELTA_UPDATE
+boolean Flash_GetDeltaSourceInfo(const uint32 i_addr, uint32 *o_pSourceAddr, uint32 *o_pSourceLen);
+
+#ifndef EN_SUPPORT_APP_B
+uint8 Flash_StartSectorStagedDownload(const uint32 i_addr);
+
+uint8 Flash_UpdateSector(const uint32 i_sectorAddr,
+                         const uint8 *i_pSectorBuf,
+                         const tpfResponse i_pfActiveFinshedCallBack,
+                         const uint8 i_requestUDSSerID,
+                         const tpfReuestMoreTime i_pfRequestMoreTimeCallback);
+#endif
+#endif
+
 tAPPType Flash_GetOldAPPType(void);
 
 uint32 Flash_GetResetHandlerAddr(void);
@@ -11,306 +11,565 @@
 
 #include "multi_cyc_fifo.h"
 
-typedef enum
-{
-    FIFO_EMPTY, /* FIFO empty */
-    FIFO_USING, /* FIFO using */
-    FIFO_FULL   /* FIFO full */
-} tFifoStatus;
-
+/*********************************************************
+**  Message slot: | message head | message | pad to 4 bytes |
+**  A slot is never split by FIFO end, so reserved/peeked message
+**  is contiguous and 4 bytes aligned. If the slot not fit in the
+**  rest of FIFO, producer writes a skip head there and the slot
+**  starts at FIFO start. Consumer jumps over the skip head.
+**  Push/Pop message is reserve/commit and peek/release with copy.
+*********************************************************/
 typedef struct
 {
-    tId xOwnerId;                  /* Owner FIFO ID */
-    tLen xFifoLen;                 /* FIFO len */
-    tLen xReadAddr;                /* Read FIFO addr */
-    tLen xWriteAddr;               /* Write FIFO addr */
-    tFifoStatus eFifoStatus;       /* FIFO status */
-    unsigned char *pStartFifoAddr; /* Start FIFO addr */
-    void *pvNextFifoList;          /* Next FIFO list */
-} tFifoInfo;
-
-#define STRUCT_LEN (20u) /* Every FIFO struct used space */
-#define TOTAL_BYTES ((STRUCT_LEN) * (FIFO_NUM) + TOTAL_FIFO_BYTES) /* config total bytes */
-
-static unsigned char gs_ucFifo[TOTAL_BYTES] = {0};    /* Total FIFO len */
-static tFifoInfo *gs_pstListHeader = (tFifoInfo *)0u; /* Manage list FIFO header */
-static tLen gs_xCleanFifoLen = TOTAL_BYTES;           /* Can used FIFO len */
-
-/**********************************************************
-** Description      :   Add counter
-** Input Parameter  :   i_xFifoLen total FIFO len
-** Modify Parameter :   m_pxCounter need modify counter  Read/Write counter
-***********************************************************/
-#define AddCounter(i_xFifoLen, m_pxCounter)\
-    do{\
-        (*(m_pxCounter))++;\
-        if(*(m_pxCounter) >= (i_xFifoLen))\
-        {\
-            *(m_pxCounter) -= (i_xFifoLen);\
-        }\
-    }while(0)
+    tLen xMsgLen;   /* Message len or MSG_SKIP_MARK */
+    tLen xReserved; /* Keep message 4 bytes aligned */
+} tMsgHead;
+
+#define MSG_HEAD_SIZE ((tLen)sizeof(tMsgHead))
+#define MSG_ALIGN_MASK (3u)
+#define MSG_SKIP_MARK (0xFFFFu)  /* FIFO len not more than 32768, never a message len */
+
+/* Get message slot len, calculate as uint32 for not overflow */
+#define MsgSlotLen(i_xMsgLen) ((uint32)MSG_HEAD_SIZE + (((uint32)(i_xMsgLen) + MSG_ALIGN_MASK) & ~(uint32)MSG_ALIGN_MASK))
+
+/* Get message head at counter. Slot and skip head are 4 bytes aligned, so head never wrap. */
+#define FifoMsgHead(i_pstNode, i_xCounter) ((tMsgHead *)(&((i_pstNode)->pStartFifoAddr)[FifoIndex((i_pstNode), (i_xCounter))]))
+
+/* Get FIFO index from read/write counter */
+#define FifoIndex(i_pstNode, i_xCounter) ((tLen)((i_xCounter) & ((i_pstNode)->xFifoLen - 1u)))
+
+/*********************************************************
+**  Memory barrier between FIFO data access and counter publish.
+**  Consumer: get write counter -> barrier -> read data -> barrier -> publish read counter.
+**  Producer: get read counter -> barrier -> write data -> barrier -> publish write counter.
+*********************************************************/
+#if defined (__GNUC__)
+#define FifoMemoryBarrier() __sync_synchronize()
+#else
+#define FifoMemoryBarrier() ASM_KEYWORD("dmb")
+#endif
 
-/* Add write counter used in write FIFO */
-#define AddWriteCounter(m_pstNode)\
+#ifdef EN_FIFO_STATISTICS
+/* Producer: FIFO have no space */
+#define FifoStatisticsOverMax(m_pstNode)\
     do{\
-        AddCounter(m_pstNode->xFifoLen, &(m_pstNode->xWriteAddr));\
+        (m_pstNode)->overMaxCnt++;\
     }while(0)
 
-/* Check and change current  write FIFO status */
-#define CheckAndChangeWriteFIFOStatus(m_pstNode) \
+/* Producer: after write counter published, record written bytes and max used len */
+#define FifoStatisticsWrite(m_pstNode, i_xWriteLen)\
     do{\
-        DisableAllInterrupts();\
-        if((m_pstNode)->xWriteAddr == (m_pstNode)->xReadAddr)\
-        {\
-            (m_pstNode)->eFifoStatus = FIFO_FULL;\
-        }\
-        else\
+        const tLen xUsedLenTmp = FifoCanReadLen(m_pstNode);\
+        (m_pstNode)->writeBytes += (i_xWriteLen);\
+        if (xUsedLenTmp > (m_pstNode)->xMaxUsedLen)\
         {\
-            (m_pstNode)->eFifoStatus = FIFO_USING;\
+            (m_pstNode)->xMaxUsedLen = xUsedLenTmp;\
         }\
-        EnableAllInterrupts();\
-    }while(0u)
-
-/* Add read counter used in read FIFO */
-#define AddReadCounter(m_pstNode)\
-    do{\
-        AddCounter(m_pstNode->xFifoLen, &(m_pstNode->xReadAddr));\
     }while(0)
 
-/* Check and change current read FIFO status */
-#define CheckAndChangeReadFIFOStatus(m_pstNode) \
+/* Consumer: record read bytes */
+#define FifoStatisticsRead(m_pstNode, i_xReadLen)\
     do{\
-        DisableAllInterrupts();\
-        if((m_pstNode)->xWriteAddr == (m_pstNode)->xReadAddr)\
-        {\
-            (m_pstNode)->eFifoStatus = FIFO_EMPTY;\
-        }\
-        else\
-        {\
-            (m_pstNode)->eFifoStatus = FIFO_USING;\
-        }\
-        EnableAllInterrupts();\
-    }while(0u)
-
+        (m_pstNode)->readBytes += (i_xReadLen);\
+    }while(0)
 
-/* Get FIFO list header */
-#define GetListHeader(o_psListHeader)\
+/* Clear FIFO statistics */
+#define FifoStatisticsClear(m_pstNode)\
     do{\
-        (o_psListHeader) = gs_pstListHeader;\
+        (m_pstNode)->xMaxUsedLen = 0u;\
+        (m_pstNode)->overMaxCnt = 0u;\
+        (m_pstNode)->writeBytes = 0u;\
+        (m_pstNode)->readBytes = 0u;\
     }while(0)
+#else
+#define FifoStatisticsOverMax(m_pstNode)
+#define FifoStatisticsWrite(m_pstNode, i_xWriteLen)
+#define FifoStatisticsRead(m_pstNode, i_xReadLen)
+#define FifoStatisticsClear(m_pstNode)
+#endif
 
-static void AddInList(tFifoInfo *i_pstFifoNode, tFifoInfo **m_ppstHeader, tErroCode *o_peAddStatus);
-static void FindFifo(tId i_xFifoId, tFifoInfo **o_ppstNode, tErroCode *o_peFindStatus);
+static tLen FifoCanReadLen(const tFifoInfo *i_pstNode);
+static tLen FifoCanWriteLen(const tFifoInfo *i_pstNode);
+static void FifoCopyIn(tFifoInfo *m_pstNode, tLen i_xWriteAddr, const unsigned char *i_pucDataBuf, tLen i_xDataLen);
+static void FifoCopyOut(const tFifoInfo *i_pstNode, tLen i_xReadAddr, unsigned char *o_pucDataBuf, tLen i_xDataLen);
+static tMsgHead *FifoGetFirstMsg(tFifoInfo *m_pstNode, tErroCode *o_peGetStatus);
 
 /**********************************************************
-**  Function Name       :   ApplyFifo
-**  Description         :   Apply a FIFO
-**  Input Parameter     :   i_xApplyFifoLen need apply FIFO len
-                            i_xFifoId FIFO ID. Use find this FIFO.
+**  Function Name       :   WriteDataInFifo
+**  Description         :   write data in FIFO.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_pucWriteDataBuf Need write data buffer
+                            i_xWriteDatalen  write data len
 **  Modify Parameter    :   none
-**  Output Parameter    :   o_peApplyStatus apply status. If apply success ERRO_NONE, else ERRO_XXX
+**  Output Parameter    :   o_peWriteStatus write data status. If successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void ApplyFifo(tLen i_xApplyFifoLen, tLen i_xFifoId, tErroCode *o_peApplyStatus)
+void WriteDataInFifo(tFifoHandle i_xFifo,
+                     unsigned char *i_pucWriteDataBuf,
+                     tLen i_xWriteDatalen,
+                     tErroCode *o_peWriteStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
-    tLen xNodeNeedSpace = 0u;
-    uint32 CleanFIFOLenTmp = 0u;
+    tFifoInfo *pstNode = i_xFifo;
+    tLen xWriteAddr = 0u;
+    tLen xCanWriteLen = 0u;
 #ifdef SAFE_LEVEL_O3
 
-    if ((tErroCode *)0u == o_peApplyStatus)
+    if ((tErroCode *)0u == o_peWriteStatus)
     {
         return;
     }
 
-    /* Confirm apply FIFO header start align as 4Bytes */
-    CleanFIFOLenTmp = (uint32)(&gs_ucFifo[TOTAL_BYTES - gs_xCleanFifoLen]) & 0x03u;
-
-    if ((i_xApplyFifoLen + STRUCT_LEN + CleanFIFOLenTmp) > gs_xCleanFifoLen)
+    if ((unsigned char *)0u == i_pucWriteDataBuf)
     {
-        *o_peApplyStatus = ERRO_OVER_MAX;
+        *o_peWriteStatus = ERRO_POINTER_NULL;
         return;
     }
 
 #endif
-    FindFifo(i_xFifoId, &pstNode, o_peApplyStatus);
 
-    if (ERRO_NONE == *o_peApplyStatus)   /* Note if ERRO_NONE that means ID have registered. */
+    if (NULL_FIFO_HANDLE == pstNode)
     {
-        *o_peApplyStatus = ERRO_REGISTERED_SECOND;
+        *o_peWriteStatus = ERRO_NO_NODE;
         return;
     }
 
-    if (CleanFIFOLenTmp)
+    xWriteAddr = pstNode->xWriteAddr;
+    xCanWriteLen = FifoCanWriteLen(pstNode);
+    FifoMemoryBarrier();
+
+    if (i_xWriteDatalen > xCanWriteLen)
     {
-        gs_xCleanFifoLen -= CleanFIFOLenTmp;
+        FifoStatisticsOverMax(pstNode);
+        *o_peWriteStatus = ERRO_OVER_MAX;
+        return;
     }
 
-    pstNode = (tFifoInfo *)(&gs_ucFifo[TOTAL_BYTES - gs_xCleanFifoLen]);
-    pstNode->xOwnerId = i_xFifoId;
-    pstNode->pvNextFifoList = (void *)0u;
-    pstNode->xFifoLen = i_xApplyFifoLen;
-    pstNode->xReadAddr = 0u;
-    pstNode->xWriteAddr = 0u;
-    pstNode->pStartFifoAddr = (unsigned char *)((tFifoInfo *)(&gs_ucFifo[TOTAL_BYTES - gs_xCleanFifoLen]) + 1u);
-    pstNode->eFifoStatus = FIFO_EMPTY;
-    xNodeNeedSpace = (tLen)((unsigned char *)((tFifoInfo *)(&gs_ucFifo[TOTAL_BYTES - gs_xCleanFifoLen]) + 1u) -
-                            (unsigned char *)(&gs_ucFifo[TOTAL_BYTES - gs_xCleanFifoLen]));
-    xNodeNeedSpace += i_xApplyFifoLen;
-    gs_xCleanFifoLen -= xNodeNeedSpace;
-    AddInList(pstNode, &gs_pstListHeader, o_peApplyStatus);
+    FifoCopyIn(pstNode, xWriteAddr, i_pucWriteDataBuf, i_xWriteDatalen);
+
+    /* Data should be in FIFO before consumer see the new write counter */
+    FifoMemoryBarrier();
+    pstNode->xWriteAddr = (tLen)(xWriteAddr + i_xWriteDatalen);
+    FifoStatisticsWrite(pstNode, i_xWriteDatalen);
+    *o_peWriteStatus = ERRO_NONE;
 }
 
 /**********************************************************
-**  Function Name       :   WriteDataInFifo
-**  Description         :   write data in FIFO.
-**  Input Parameter     :   i_xFifoId   FIFO ID
-                            i_pucWriteDataBuf Need write data buffer
-                            i_xWriteDatalen  write data len
+**  Function Name       :   ReadDataFromFifo
+**  Description         :   Read data from FIFO.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xNeedReadDataLen read data len
 **  Modify Parameter    :   none
-**  Output Parameter    :   o_peWriteStatus write data status. If successful ERRO_NONE, else ERRO_XX
+**  Output Parameter    :   o_pucReadDataBuf need read data buffer.
+                            o_pxReadLen need read data len
+                            o_peReadStatus read status. If read successful ERRO_NONE, else ERRO_XXX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void WriteDataInFifo(tId i_xFifoId,
-                     unsigned char *i_pucWriteDataBuf,
-                     tLen i_xWriteDatalen,
-                     tErroCode *o_peWriteStatus)
+void ReadDataFromFifo(tFifoHandle i_xFifo, tLen i_xNeedReadDataLen,
+                      unsigned char *o_pucReadDataBuf,
+                      tLen *o_pxReadLen,
+                      tErroCode *o_peReadStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
-    tLen xIndex = 0u;
-    tLen xCanWriteTotal = 0u;
+    tFifoInfo *pstNode = i_xFifo;
+    tLen xReadAddr = 0u;
+    tLen xCanReadTotal = 0u;
 #ifdef SAFE_LEVEL_O3
 
-    if ((tErroCode *)0u == o_peWriteStatus)
+    if ((tErroCode *)0u == o_peReadStatus)
     {
         return;
     }
 
-    if ((unsigned char *)0u == i_pucWriteDataBuf)
+    if ((unsigned char *)0u == o_pucReadDataBuf ||
+            (tLen *)0u == o_pxReadLen ||
+            (tLen)0u == i_xNeedReadDataLen )
     {
-        *o_peWriteStatus = ERRO_POINTER_NULL;
+        *o_peReadStatus = ERRO_POINTER_NULL;
         return;
     }
 
 #endif
-    GetCanWriteLen(i_xFifoId, &xCanWriteTotal, o_peWriteStatus);
 
-    if (ERRO_NONE != *o_peWriteStatus)
+    if (NULL_FIFO_HANDLE == pstNode)
     {
+        *o_peReadStatus = ERRO_NO_NODE;
         return;
     }
 
-    if (i_xWriteDatalen > xCanWriteTotal)
+    xReadAddr = pstNode->xReadAddr;
+    xCanReadTotal = FifoCanReadLen(pstNode);
+    FifoMemoryBarrier();
+
+    xCanReadTotal = xCanReadTotal > i_xNeedReadDataLen ? i_xNeedReadDataLen : xCanReadTotal;
+    *o_pxReadLen = xCanReadTotal;
+
+    FifoCopyOut(pstNode, xReadAddr, o_pucReadDataBuf, xCanReadTotal);
+
+    /* Data should be read out before producer see the new read counter */
+    FifoMemoryBarrier();
+    pstNode->xReadAddr = (tLen)(xReadAddr + xCanReadTotal);
+    FifoStatisticsRead(pstNode, xCanReadTotal);
+    *o_peReadStatus = ERRO_NONE;
+}
+
+/**********************************************************
+**  Function Name       :   ReserveMsgInFifo
+**  Description         :   Reserve a contiguous message space in FIFO. Message is built in place
+                            and write in FIFO by CommitMsgInFifo. Only call by producer.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xMsgLen need reserve message len, slot should not more than half FIFO len
+                            that always can be reserved after FIFO is empty.
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peReserveStatus reserve status. If successful ERRO_NONE,
+                            ERRO_OVER_MAX if FIFO have no space for message, else ERRO_XX
+**  Return Value        :   Reserved message address, 4 bytes aligned. NULL if reserve failed.
+**  Version             :   v00.00.01
+**********************************************************/
+unsigned char *ReserveMsgInFifo(tFifoHandle i_xFifo, tLen i_xMsgLen, tErroCode *o_peReserveStatus)
+{
+    tFifoInfo *pstNode = i_xFifo;
+    tLen xWriteAddr = 0u;
+    tLen xCanWriteLen = 0u;
+    tLen xTailLen = 0u;
+    uint32 slotLen = 0u;
+    uint32 needLen = 0u;
+#ifdef SAFE_LEVEL_O3
+
+    if ((tErroCode *)0u == o_peReserveStatus)
+    {
+        return (unsigned char *)0u;
+    }
+
+#endif
+
+    if (NULL_FIFO_HANDLE == pstNode)
+    {
+        *o_peReserveStatus = ERRO_NO_NODE;
+        return (unsigned char *)0u;
+    }
+
+    xWriteAddr = pstNode->xWriteAddr;
+    xCanWriteLen = FifoCanWriteLen(pstNode);
+    FifoMemoryBarrier();
+
+    slotLen = MsgSlotLen(i_xMsgLen);
+    xTailLen = (tLen)(pstNode->xFifoLen - FifoIndex(pstNode, xWriteAddr));
+    needLen = slotLen;
+
+    /* Slot not fit in the rest of FIFO, skip the rest */
+    if (slotLen > xTailLen)
+    {
+        needLen += xTailLen;
+    }
+
+    if (needLen > xCanWriteLen)
+    {
+        FifoStatisticsOverMax(pstNode);
+        *o_peReserveStatus = ERRO_OVER_MAX;
+        return (unsigned char *)0u;
+    }
+
+    /* Skip head is not seen by consumer until message is committed */
+    if (slotLen > xTailLen)
+    {
+        FifoMsgHead(pstNode, xWriteAddr)->xMsgLen = MSG_SKIP_MARK;
+        xWriteAddr = (tLen)(xWriteAddr + xTailLen);
+    }
+
+    pstNode->xReserveAddr = xWriteAddr;
+    pstNode->xReserveLen = i_xMsgLen;
+    *o_peReserveStatus = ERRO_NONE;
+
+    return (unsigned char *)(FifoMsgHead(pstNode, xWriteAddr) + 1u);
+}
+
+/**********************************************************
+**  Function Name       :   CommitMsgInFifo
+**  Description         :   Commit reserved message, consumer can read the message after commit.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xMsgLen real message len, not more than reserved len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peCommitStatus commit status. If successful ERRO_NONE,
+                            ERRO_WRITE_ERRO if no message reserved, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void CommitMsgInFifo(tFifoHandle i_xFifo, tLen i_xMsgLen, tErroCode *o_peCommitStatus)
+{
+    tFifoInfo *pstNode = i_xFifo;
+    tLen xReserveAddr = 0u;
+#ifdef SAFE_LEVEL_O3
+
+    if ((tErroCode *)0u == o_peCommitStatus)
     {
-        *o_peWriteStatus = ERRO_OVER_MAX;
         return;
     }
 
-    FindFifo(i_xFifoId, &pstNode, o_peWriteStatus);
+#endif
+
+    if (NULL_FIFO_HANDLE == pstNode)
+    {
+        *o_peCommitStatus = ERRO_NO_NODE;
+        return;
+    }
 
-    if (ERRO_NONE != *o_peWriteStatus)
+    if (MSG_NO_RESERVE == pstNode->xReserveLen)
     {
+        *o_peCommitStatus = ERRO_WRITE_ERRO;
         return;
     }
 
-    for (xIndex = 0u; xIndex < i_xWriteDatalen; xIndex++)
+    if (i_xMsgLen > pstNode->xReserveLen)
     {
-        (pstNode->pStartFifoAddr)[pstNode->xWriteAddr] = i_pucWriteDataBuf[xIndex];
-        AddWriteCounter(pstNode);
+        *o_peCommitStatus = ERRO_OVER_MAX;
+        return;
     }
 
-    /* Check and change write FIFO status */
-    CheckAndChangeWriteFIFOStatus(pstNode);
-    *o_peWriteStatus = ERRO_NONE;
+    xReserveAddr = pstNode->xReserveAddr;
+    FifoMsgHead(pstNode, xReserveAddr)->xMsgLen = i_xMsgLen;
+    pstNode->xReserveLen = MSG_NO_RESERVE;
+
+    /* Message should be in FIFO before consumer see the new write counter */
+    FifoMemoryBarrier();
+    pstNode->xWriteAddr = (tLen)(xReserveAddr + MsgSlotLen(i_xMsgLen));
+    FifoStatisticsWrite(pstNode, i_xMsgLen);
+    *o_peCommitStatus = ERRO_NONE;
 }
 
 /**********************************************************
-**  Function Name       :   ReadDataFromFifo
-**  Description         :   Read data from FIFO.
-**  Input Parameter     :   i_xFifoId need read FIFO
-                            i_xNeedReadDataLen read data len
+**  Function Name       :   PeekMsgFromFifo
+**  Description         :   Get the first message in FIFO without read out. Message is parsed in place
+                            and removed by ReleaseMsgFromFifo. Only call by consumer.
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
-**  Output Parameter    :   o_pucReadDataBuf need read data buffer.
-                            o_pxReadLen need read data len
-                            o_peReadStatus read status. If read successful ERRO_NONE, else ERRO_XXX
+**  Output Parameter    :   o_pxMsgLen message len
+                            o_pePeekStatus peek status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty.
+                            If FIFO data is not a message, all data is dropped and return ERRO_READ_ERRO.
+**  Return Value        :   Message address, 4 bytes aligned. NULL if no message.
+**  Version             :   v00.00.01
+**********************************************************/
+unsigned char *PeekMsgFromFifo(tFifoHandle i_xFifo, tLen *o_pxMsgLen, tErroCode *o_pePeekStatus)
+{
+    tMsgHead *pstMsgHead = (tMsgHead *)0u;
+#ifdef SAFE_LEVEL_O3
+
+    if ((tErroCode *)0u == o_pePeekStatus)
+    {
+        return (unsigned char *)0u;
+    }
+
+    if ((tLen *)0u == o_pxMsgLen)
+    {
+        *o_pePeekStatus = ERRO_POINTER_NULL;
+        return (unsigned char *)0u;
+    }
+
+#endif
+
+    if (NULL_FIFO_HANDLE == i_xFifo)
+    {
+        *o_pePeekStatus = ERRO_NO_NODE;
+        return (unsigned char *)0u;
+    }
+
+    pstMsgHead = FifoGetFirstMsg(i_xFifo, o_pePeekStatus);
+
+    if (ERRO_NONE != *o_pePeekStatus)
+    {
+        return (unsigned char *)0u;
+    }
+
+    *o_pxMsgLen = pstMsgHead->xMsgLen;
+
+    return (unsigned char *)(pstMsgHead + 1u);
+}
+
+/**********************************************************
+**  Function Name       :   ReleaseMsgFromFifo
+**  Description         :   Release the first message in FIFO, producer can reuse the space after release.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peReleaseStatus release status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty.
 **  Return Value        :   none
 **  Version             :   v00.00.01
-**  Author              :   Tomlin
-**  Created Date        :   2013-3-27
 **********************************************************/
-void ReadDataFromFifo(tId i_xFifoId, tLen i_xNeedReadDataLen,
-                      unsigned char *o_pucReadDataBuf,
-                      tLen *o_pxReadLen,
-                      tErroCode *o_peReadStatus)
+void ReleaseMsgFromFifo(tFifoHandle i_xFifo, tErroCode *o_peReleaseStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
-    tLen xIndex = 0u;
-    tLen xCanReadTotal = 0u;
+    tFifoInfo *pstNode = i_xFifo;
+    tMsgHead *pstMsgHead = (tMsgHead *)0u;
+    tLen xReadAddr = 0u;
+    tLen xMsgLen = 0u;
 #ifdef SAFE_LEVEL_O3
 
-    if ((tErroCode *)0u == o_peReadStatus)
+    if ((tErroCode *)0u == o_peReleaseStatus)
     {
         return;
     }
 
-    if ((unsigned char *)0u == o_pucReadDataBuf ||
-            (tLen *)0u == o_pxReadLen ||
-            (tLen)0u == i_xNeedReadDataLen )
+#endif
+
+    if (NULL_FIFO_HANDLE == pstNode)
+    {
+        *o_peReleaseStatus = ERRO_NO_NODE;
+        return;
+    }
+
+    pstMsgHead = FifoGetFirstMsg(pstNode, o_peReleaseStatus);
+
+    if (ERRO_NONE != *o_peReleaseStatus)
     {
-        *o_peReadStatus = ERRO_POINTER_NULL;
+        return;
+    }
+
+    xReadAddr = pstNode->xReadAddr;
+    xMsgLen = pstMsgHead->xMsgLen;
+
+    /* Message should be used before producer see the new read counter */
+    FifoMemoryBarrier();
+    pstNode->xReadAddr = (tLen)(xReadAddr + MsgSlotLen(xMsgLen));
+    FifoStatisticsRead(pstNode, xMsgLen);
+}
+
+/**********************************************************
+**  Function Name       :   PushMsgInFifo
+**  Description         :   Push a message (header + data) in FIFO.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_pucHeader message header
+                            i_xHeaderLen message header len
+                            i_pucDataBuf message data, can be null if data len is 0
+                            i_xDataLen message data len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pePushStatus push status. If successful ERRO_NONE,
+                            ERRO_OVER_MAX if FIFO have no space for whole message, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.02
+**********************************************************/
+void PushMsgInFifo(tFifoHandle i_xFifo,
+                   const unsigned char *i_pucHeader,
+                   tLen i_xHeaderLen,
+                   const unsigned char *i_pucDataBuf,
+                   tLen i_xDataLen,
+                   tErroCode *o_pePushStatus)
+{
+    unsigned char *pucMsg = (unsigned char *)0u;
+#ifdef SAFE_LEVEL_O3
+
+    if ((tErroCode *)0u == o_pePushStatus)
+    {
+        return;
+    }
+
+    if (((unsigned char *)0u == i_pucHeader) ||
+            (((unsigned char *)0u == i_pucDataBuf) && ((tLen)0u != i_xDataLen)))
+    {
+        *o_pePushStatus = ERRO_POINTER_NULL;
         return;
     }
 
 #endif
-    GetCanReadLen(i_xFifoId, &xCanReadTotal, o_peReadStatus);
 
-    if (ERRO_NONE != *o_peReadStatus)
+    if (((uint32)i_xHeaderLen + i_xDataLen) >= MSG_SKIP_MARK)
     {
+        *o_pePushStatus = ERRO_OVER_MAX;
         return;
     }
 
-    FindFifo(i_xFifoId, &pstNode, o_peReadStatus);
+    pucMsg = ReserveMsgInFifo(i_xFifo, (tLen)(i_xHeaderLen + i_xDataLen), o_pePushStatus);
 
-    if (ERRO_NONE != *o_peReadStatus)
+    if (ERRO_NONE != *o_pePushStatus)
     {
         return;
     }
 
-    xCanReadTotal = xCanReadTotal > i_xNeedReadDataLen ? i_xNeedReadDataLen : xCanReadTotal;
-    *o_pxReadLen = xCanReadTotal;
+    fsl_memcpy(pucMsg, i_pucHeader, i_xHeaderLen);
+    fsl_memcpy(&pucMsg[i_xHeaderLen], i_pucDataBuf, i_xDataLen);
+    CommitMsgInFifo(i_xFifo, (tLen)(i_xHeaderLen + i_xDataLen), o_pePushStatus);
+}
+
+/**********************************************************
+**  Function Name       :   PopMsgFromFifo
+**  Description         :   Pop a message from FIFO, split it to header and data.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xHeaderLen message header len
+                            i_xDataBufLen data buffer len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pucHeader message header
+                            o_pucDataBuf message data
+                            o_pxDataLen message data len
+                            o_pePopStatus pop status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty.
+                            If message not match header len or data buffer, message is dropped and return ERRO_READ_ERRO.
+**  Return Value        :   none
+**  Version             :   v00.00.02
+**********************************************************/
+void PopMsgFromFifo(tFifoHandle i_xFifo,
+                    unsigned char *o_pucHeader,
+                    tLen i_xHeaderLen,
+                    unsigned char *o_pucDataBuf,
+                    tLen i_xDataBufLen,
+                    tLen *o_pxDataLen,
+                    tErroCode *o_pePopStatus)
+{
+    const unsigned char *pucMsg = (unsigned char *)0u;
+    tLen xMsgLen = 0u;
+    tLen xDataLen = 0u;
+#ifdef SAFE_LEVEL_O3
 
-    for (xIndex = 0u; xIndex < xCanReadTotal; xIndex++)
+    if ((tErroCode *)0u == o_pePopStatus)
     {
-        o_pucReadDataBuf[xIndex] = (pstNode->pStartFifoAddr)[pstNode->xReadAddr] ;
-        AddReadCounter(pstNode);
+        return;
     }
 
-    /* Check and change read FIFO status */
-    CheckAndChangeReadFIFOStatus(pstNode);
-    *o_peReadStatus = ERRO_NONE;
+    if (((unsigned char *)0u == o_pucHeader) ||
+            ((unsigned char *)0u == o_pucDataBuf) ||
+            ((tLen *)0u == o_pxDataLen))
+    {
+        *o_pePopStatus = ERRO_POINTER_NULL;
+        return;
+    }
+
+#endif
+
+    pucMsg = PeekMsgFromFifo(i_xFifo, &xMsgLen, o_pePopStatus);
+
+    if (ERRO_NONE != *o_pePopStatus)
+    {
+        return;
+    }
+
+    xDataLen = (tLen)(xMsgLen - i_xHeaderLen);
+
+    if ((xMsgLen < i_xHeaderLen) || (xDataLen > i_xDataBufLen))
+    {
+        ReleaseMsgFromFifo(i_xFifo, o_pePopStatus);
+        *o_pePopStatus = ERRO_READ_ERRO;
+        return;
+    }
+
+    fsl_memcpy(o_pucHeader, pucMsg, i_xHeaderLen);
+    fsl_memcpy(o_pucDataBuf, &pucMsg[i_xHeaderLen], xDataLen);
+    *o_pxDataLen = xDataLen;
+    ReleaseMsgFromFifo(i_xFifo, o_pePopStatus);
 }
 
 /**********************************************************
 **  Function Name       :   GetCanReadLen
 **  Description         :   Get FIFO have data.
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_pxCanReadLen how much data can read.
                             o_peGetStatus get status. If get successful ERRO_NONE, else ERRO_XXX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void GetCanReadLen(tId i_xFifoId, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus)
+void GetCanReadLen(tFifoHandle i_xFifo, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
 #ifdef SAFE_LEVEL_O3
 
     if ((tErroCode *)0u == o_peGetStatus)
@@ -325,46 +584,31 @@ void GetCanReadLen(tId i_xFifoId, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus
     }
 
 #endif
-    FindFifo(i_xFifoId, &pstNode, o_peGetStatus);
 
-    if (ERRO_NONE != *o_peGetStatus)
+    if (NULL_FIFO_HANDLE == i_xFifo)
     {
+        *o_peGetStatus = ERRO_NO_NODE;
         return;
     }
 
-    if (FIFO_USING == pstNode->eFifoStatus)
-    {
-        *o_pxCanReadLen = (pstNode->xReadAddr > pstNode->xWriteAddr) ?
-                          (pstNode->xFifoLen - pstNode->xReadAddr + pstNode->xWriteAddr) :
-                          (pstNode->xWriteAddr - pstNode->xReadAddr);
-    }
-    else if (FIFO_FULL == pstNode->eFifoStatus)
-    {
-        *o_pxCanReadLen = pstNode->xFifoLen;
-    }
-    else
-    {
-        *o_pxCanReadLen = (tLen)0u;
-    }
-
+    *o_pxCanReadLen = FifoCanReadLen(i_xFifo);
     *o_peGetStatus = ERRO_NONE;
 }
 
 /**********************************************************
 **  Function Name       :   GetCanWriteLen
 **  Description         :   Get can write data.
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_pxCanWriteLen how much data can write.
                             o_peGetStatus get data status. If get successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void GetCanWriteLen(tId i_xFifoId, tLen *o_pxCanWriteLen, tErroCode *o_peGetStatus)
+void GetCanWriteLen(tFifoHandle i_xFifo, tLen *o_pxCanWriteLen, tErroCode *o_peGetStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
 #ifdef SAFE_LEVEL_O3
 
     if ((tErroCode *)0u == o_peGetStatus)
@@ -379,165 +623,301 @@ void GetCanWriteLen(tId i_xFifoId, tLen *o_pxCanWriteLen, tErroCode *o_peGetStat
     }
 
 #endif
-    FindFifo(i_xFifoId, &pstNode, o_peGetStatus);
 
-    if (ERRO_NONE != *o_peGetStatus)
+    if (NULL_FIFO_HANDLE == i_xFifo)
     {
+        *o_peGetStatus = ERRO_NO_NODE;
         return;
     }
 
-    if (FIFO_USING == pstNode->eFifoStatus)
+    *o_pxCanWriteLen = FifoCanWriteLen(i_xFifo);
+    *o_peGetStatus = ERRO_NONE;
+}
+
+/**********************************************************
+**  Function Name       :   FifoCanReadLen
+**  Description         :   Calculate FIFO have data.
+**  Input Parameter     :   i_pstNode FIFO node
+**  Modify Parameter    :   none
+**  Output Parameter    :   none
+**  Return Value        :   how much data can read.
+**  Version             :   v00.00.01
+**********************************************************/
+static tLen FifoCanReadLen(const tFifoInfo *i_pstNode)
+{
+    return (tLen)(i_pstNode->xWriteAddr - i_pstNode->xReadAddr);
+}
+
+/**********************************************************
+**  Function Name       :   FifoCanWriteLen
+**  Description         :   Calculate FIFO can write data.
+**  Input Parameter     :   i_pstNode FIFO node
+**  Modify Parameter    :   none
+**  Output Parameter    :   none
+**  Return Value        :   how much data can write.
+**  Version             :   v00.00.01
+**********************************************************/
+static tLen FifoCanWriteLen(const tFifoInfo *i_pstNode)
+{
+    return (tLen)(i_pstNode->xFifoLen - (tLen)(i_pstNode->xWriteAddr - i_pstNode->xReadAddr));
+}
+
+/**********************************************************
+**  Function Name       :   FifoCopyIn
+**  Description         :   Copy data in FIFO, max two segments if data wrap FIFO end.
+**  Input Parameter     :   i_xWriteAddr write counter
+                            i_pucDataBuf data buffer
+                            i_xDataLen data len, not more than can write len
+**  Modify Parameter    :   m_pstNode FIFO node
+**  Output Parameter    :   none
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+static void FifoCopyIn(tFifoInfo *m_pstNode, tLen i_xWriteAddr, const unsigned char *i_pucDataBuf, tLen i_xDataLen)
+{
+    const tLen xIndex = FifoIndex(m_pstNode, i_xWriteAddr);
+    tLen xFirstLen = m_pstNode->xFifoLen - xIndex;
+
+    if (xFirstLen > i_xDataLen)
     {
-        *o_pxCanWriteLen = (pstNode->xReadAddr > pstNode->xWriteAddr) ?
-                           (pstNode->xReadAddr - pstNode->xWriteAddr) :
-                           (pstNode->xFifoLen + pstNode->xReadAddr - pstNode->xWriteAddr);
+        xFirstLen = i_xDataLen;
     }
-    else if (FIFO_EMPTY == pstNode->eFifoStatus)
+
+    fsl_memcpy(&(m_pstNode->pStartFifoAddr)[xIndex], i_pucDataBuf, xFirstLen);
+
+    if (i_xDataLen > xFirstLen)
     {
-        *o_pxCanWriteLen = pstNode->xFifoLen;
+        fsl_memcpy(m_pstNode->pStartFifoAddr, &i_pucDataBuf[xFirstLen], i_xDataLen - xFirstLen);
     }
-    else
+}
+
+/**********************************************************
+**  Function Name       :   FifoCopyOut
+**  Description         :   Copy data from FIFO, max two segments if data wrap FIFO end.
+**  Input Parameter     :   i_pstNode FIFO node
+                            i_xReadAddr read counter
+                            i_xDataLen data len, not more than can read len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pucDataBuf data buffer
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+static void FifoCopyOut(const tFifoInfo *i_pstNode, tLen i_xReadAddr, unsigned char *o_pucDataBuf, tLen i_xDataLen)
+{
+    const tLen xIndex = FifoIndex(i_pstNode, i_xReadAddr);
+    tLen xFirstLen = i_pstNode->xFifoLen - xIndex;
+
+    if (xFirstLen > i_xDataLen)
     {
-        *o_pxCanWriteLen = (tLen)0u;
+        xFirstLen = i_xDataLen;
     }
 
-    *o_peGetStatus = ERRO_NONE;
+    fsl_memcpy(o_pucDataBuf, &(i_pstNode->pStartFifoAddr)[xIndex], xFirstLen);
+
+    if (i_xDataLen > xFirstLen)
+    {
+        fsl_memcpy(&o_pucDataBuf[xFirstLen], i_pstNode->pStartFifoAddr, i_xDataLen - xFirstLen);
+    }
 }
 
 /**********************************************************
-**  Function Name       :   AddInList
-**  Description         :   Add node in list
-**  Input Parameter     :   i_pstFifoNode need add in list node.
-**  Modify Parameter    :   m_ppstHeader header list
-**  Output Parameter    :   o_peAddStatus add status
-**  Return Value        :   none
+**  Function Name       :   FifoGetFirstMsg
+**  Description         :   Get the first message head in FIFO, skip heads before it are read out.
+                            If FIFO data is not a message, drop all data.
+**  Input Parameter     :   none
+**  Modify Parameter    :   m_pstNode FIFO node
+**  Output Parameter    :   o_peGetStatus get status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty,
+                            ERRO_READ_ERRO if FIFO data is not a message.
+**  Return Value        :   the first message head
 **  Version             :   v00.00.01
-**  Author              :   Tomlin
-**  Created Date        :   2013-3-26
 **********************************************************/
-static void AddInList(tFifoInfo *i_pstFifoNode, tFifoInfo **m_ppstHeader, tErroCode *o_peAddStatus)
+static tMsgHead *FifoGetFirstMsg(tFifoInfo *m_pstNode, tErroCode *o_peGetStatus)
 {
-    tFifoInfo *pstTemp = (tFifoInfo *)0u;
-#ifdef SAFE_LEVEL_O3
+    tMsgHead *pstMsgHead = (tMsgHead *)0u;
+    tLen xReadAddr = m_pstNode->xReadAddr;
+    tLen xCanReadLen = FifoCanReadLen(m_pstNode);
+    tLen xTailLen = 0u;
+    FifoMemoryBarrier();
 
-    if ((tErroCode *)0u == o_peAddStatus)
+    while (MSG_HEAD_SIZE <= xCanReadLen)
     {
-        return;
+        pstMsgHead = FifoMsgHead(m_pstNode, xReadAddr);
+        xTailLen = (tLen)(m_pstNode->xFifoLen - FifoIndex(m_pstNode, xReadAddr));
+
+        if (MSG_SKIP_MARK != pstMsgHead->xMsgLen)
+        {
+            if ((MsgSlotLen(pstMsgHead->xMsgLen) > xCanReadLen) || (MsgSlotLen(pstMsgHead->xMsgLen) > xTailLen))
+            {
+                break;
+            }
+
+            *o_peGetStatus = ERRO_NONE;
+            return pstMsgHead;
+        }
+
+        if (xTailLen > xCanReadLen)
+        {
+            break;
+        }
+
+        /* Read out skip head, the message is at FIFO start */
+        xReadAddr = (tLen)(xReadAddr + xTailLen);
+        xCanReadLen = (tLen)(xCanReadLen - xTailLen);
+        FifoMemoryBarrier();
+        m_pstNode->xReadAddr = xReadAddr;
     }
 
-    if ((tFifoInfo **)0u == m_ppstHeader || (tFifoInfo *)0u == i_pstFifoNode)
+    if (0u == xCanReadLen)
     {
-        *o_peAddStatus = ERRO_POINTER_NULL;
-        return;
+        *o_peGetStatus = ERRO_NO_MSG;
+    }
+    else
+    {
+        /* Not a message, FIFO is written by WriteDataInFifo. Drop all data. */
+        FifoMemoryBarrier();
+        m_pstNode->xReadAddr = (tLen)(xReadAddr + xCanReadLen);
+        *o_peGetStatus = ERRO_READ_ERRO;
     }
 
-#endif
+    return (tMsgHead *)0u;
+}
+
+/**********************************************************
+**  Function Name       :   ClearFIFO
+**  Description         :   Clear FIFO, set read counter equal write counter. Only call by consumer.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peGetStatus get data status. If get successful ERRO_NONE, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.02
+**  Author              :   Tomlin
+**  Created Date        :   2019-6-18
+**********************************************************/
+void ClearFIFO(tFifoHandle i_xFifo, tErroCode *o_peGetStatus)
+{
+    tFifoInfo *pstNode = i_xFifo;
+#ifdef SAFE_LEVEL_O3
 
-    if ((tFifoInfo *)0u == *m_ppstHeader)
+    if ((tErroCode *)0u == o_peGetStatus)
     {
-        *m_ppstHeader = i_pstFifoNode;
-        *o_peAddStatus = ERRO_NONE;
         return;
     }
 
-    pstTemp = *m_ppstHeader;
+#endif
 
-    while ((void *)0u != pstTemp->pvNextFifoList)
+    if (NULL_FIFO_HANDLE == pstNode)
     {
-        if (i_pstFifoNode == pstTemp)
-        {
-            *o_peAddStatus = ERRO_REGISTERED_SECOND;
-            return;
-        }
-
-        pstTemp = (tFifoInfo *)(pstTemp->pvNextFifoList);
+        *o_peGetStatus = ERRO_NO_NODE;
+        return;
     }
 
-    pstTemp->pvNextFifoList = (void *)i_pstFifoNode;
-    i_pstFifoNode->pvNextFifoList = (tErroCode *)0u;
-    *o_peAddStatus = ERRO_NONE;
+    pstNode->xReadAddr = pstNode->xWriteAddr;
+    *o_peGetStatus = ERRO_NONE;
 }
 
+#ifdef EN_FIFO_STATISTICS
 /**********************************************************
-**  Function Name       :   FindFifo
-**  Description         :   Find FIFO in FIFO list.
-**  Input Parameter     :   FindFifo
+**  Function Name       :   GetFifoStatistics
+**  Description         :   Get FIFO statistics, used to size FIFO len.
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
-**  Output Parameter    :   o_ppstNode
-                            o_peFindStatus
+**  Output Parameter    :   o_pstStatistics FIFO statistics
+                            o_peGetStatus get status. If get successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
 **  Version             :   v00.00.01
-**  Author              :   Tomlin
-**  Created Date        :   2013-3-26
 **********************************************************/
-static void FindFifo(tId i_xFifoId, tFifoInfo **o_ppstNode, tErroCode *o_peFindStatus)
+void GetFifoStatistics(tFifoHandle i_xFifo, tFifoStatistics *o_pstStatistics, tErroCode *o_peGetStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
+    const tFifoInfo *pstNode = i_xFifo;
 #ifdef SAFE_LEVEL_O3
 
-    if ((tErroCode *)0u == o_peFindStatus)
+    if ((tErroCode *)0u == o_peGetStatus)
     {
         return;
     }
 
-    if ((tFifoInfo **)0u == o_ppstNode)
+    if ((tFifoStatistics *)0u == o_pstStatistics)
     {
-        *o_peFindStatus = ERRO_POINTER_NULL;
+        *o_peGetStatus = ERRO_POINTER_NULL;
         return;
     }
 
 #endif
-    GetListHeader(pstNode);
 
-    while ((tFifoInfo *)0u != pstNode)
+    if (NULL_FIFO_HANDLE == pstNode)
     {
-        if (i_xFifoId == pstNode->xOwnerId)
-        {
-            *o_peFindStatus = ERRO_NONE;
-            *o_ppstNode = pstNode;
-            return;
-        }
-
-        pstNode = (tFifoInfo *)pstNode->pvNextFifoList;
+        *o_peGetStatus = ERRO_NO_NODE;
+        return;
     }
 
-    *o_peFindStatus = ERRO_NO_NODE;
+    o_pstStatistics->xOwnerId = pstNode->xOwnerId;
+    o_pstStatistics->xFifoLen = pstNode->xFifoLen;
+    o_pstStatistics->xUsedLen = FifoCanReadLen(pstNode);
+    o_pstStatistics->xMaxUsedLen = pstNode->xMaxUsedLen;
+    o_pstStatistics->overMaxCnt = pstNode->overMaxCnt;
+    o_pstStatistics->writeBytes = pstNode->writeBytes;
+    o_pstStatistics->readBytes = pstNode->readBytes;
+    *o_peGetStatus = ERRO_NONE;
 }
 
 /**********************************************************
-**  Function Name       :   ClearFIFO
-**  Description         :   Clear FIFO, set read pointer equal write pointer
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Function Name       :   ResetFifoStatistics
+**  Description         :   Reset FIFO statistics. Statistics changed by producer/consumer at the same
+                            time may be not reset, that is acceptable for statistics.
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
-**  Output Parameter    :   o_peGetStatus get data status. If get successful ERRO_NONE, else ERRO_XX
+**  Output Parameter    :   o_peResetStatus reset status. If reset successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
 **  Version             :   v00.00.01
-**  Author              :   Tomlin
-**  Created Date        :   2019-6-18
 **********************************************************/
-void ClearFIFO(tId i_xFifoId, tErroCode *o_peGetStatus)
+void ResetFifoStatistics(tFifoHandle i_xFifo, tErroCode *o_peResetStatus)
 {
-    tFifoInfo *pstNode = (tFifoInfo *)0u;
+    tFifoInfo *pstNode = i_xFifo;
 #ifdef SAFE_LEVEL_O3
 
-    if ((tErroCode *)0u == o_peGetStatus)
+    if ((tErroCode *)0u == o_peResetStatus)
     {
         return;
     }
 
 #endif
-    FindFifo(i_xFifoId, &pstNode, o_peGetStatus);
 
-    if (ERRO_NONE != *o_peGetStatus)
+    if (NULL_FIFO_HANDLE == pstNode)
     {
+        *o_peResetStatus = ERRO_NO_NODE;
         return;
     }
 
-    DisableAllInterrupts();
-    pstNode->eFifoStatus = FIFO_EMPTY;
-    pstNode->xReadAddr = pstNode->xWriteAddr;
-    EnableAllInterrupts();
-    *o_peGetStatus = ERRO_NONE;
+    FifoStatisticsClear(pstNode);
+    *o_peResetStatus = ERRO_NONE;
+}
+
+/**********************************************************
+**  Function Name       :   PrintFifoStatistics
+**  Description         :   Print FIFO statistics by FIFODebugPrintf.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   none
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void PrintFifoStatistics(tFifoHandle i_xFifo)
+{
+    const tFifoInfo *pstNode = i_xFifo;
+
+    if (NULL_FIFO_HANDLE == pstNode)
+    {
+        return;
+    }
+
+    FIFODebugPrintf("FIFO %c: len=%d, max used=%d, over max=%d, write=%d, read=%d\n",
+                    (char)pstNode->xOwnerId,
+                    pstNode->xFifoLen,
+                    pstNode->xMaxUsedLen,
+                    pstNode->overMaxCnt,
+                    pstNode->writeBytes,
+                    pstNode->readBytes);
 }
+#endif /* EN_FIFO_STATISTICS */
 
 /* -------------------------------------------- END OF FILE -------------------------------------------- */
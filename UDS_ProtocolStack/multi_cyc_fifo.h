@@ -38,50 +38,86 @@ typedef enum
     ERRO_TIME_USEING,
     ERRO_TIMEOUT,           /* Timeout*/
     ERRO_WRITE_ERRO,
-    ERRO_READ_ERRO
+    ERRO_READ_ERRO,
+    ERRO_NO_MSG             /* No message in FIFO */
 } tErroCode;
 
 typedef unsigned short tId;
 typedef unsigned short tLen;
 
-#define FIFO_NUM (4u)           /* FIFO num */
+/*********************************************************
+**  Single producer single consumer ring.
+**  Read/Write counter are free running, only the consumer
+**  changes read counter and only the producer changes write
+**  counter. FIFO len is power of 2, so:
+**  have data  = write counter - read counter
+**  FIFO index = counter & (FIFO len - 1)
+**  Defined by FIFO_DEFINE, members are only used in multi_cyc_fifo.c.
+*********************************************************/
+typedef struct FifoInfo
+{
+    tId xOwnerId;                  /* Owner FIFO ID */
+    tLen xFifoLen;                 /* FIFO len, power of 2 */
+    volatile tLen xReadAddr;       /* Read counter, changed by consumer */
+    volatile tLen xWriteAddr;      /* Write counter, changed by producer */
+    tLen xReserveAddr;             /* Reserved message write counter, only used by producer */
+    tLen xReserveLen;              /* Reserved message len, MSG_NO_RESERVE if no message reserved */
+    unsigned char *pStartFifoAddr; /* Start FIFO addr */
+#ifdef EN_FIFO_STATISTICS
+    tLen xMaxUsedLen;              /* Max used len, changed by producer */
+    uint32 overMaxCnt;             /* Write/Reserve rejected count, changed by producer */
+    uint32 writeBytes;             /* Written bytes, changed by producer */
+    uint32 readBytes;              /* Read bytes, changed by consumer */
+#endif
+} tFifoInfo;
+
+/* FIFO handle, used by all FIFO operations */
+typedef tFifoInfo *tFifoHandle;
+
+#define NULL_FIFO_HANDLE ((tFifoHandle)0u)
+
+#define MSG_NO_RESERVE (0xFFFFu) /* No message reserved */
 
-#ifdef EN_LIN_TP
-#define TOTAL_FIFO_BYTES (450u) /* Config total bytes */
-#elif defined EN_CAN_TP
-#define TOTAL_FIFO_BYTES (800u) /* Config total bytes */
+/* FIFO len should be power of 2 and not more than 32768. Can be used in #if. */
+#define IsFifoLenValid(xLen) (((xLen) > 0u) && ((xLen) <= 32768u) && (0u == ((xLen) & ((xLen) - 1u))))
+
+/*
+** Define a FIFO at compile time, FIFO len is checked at compile time.
+** FIFO buffer is 4 bytes aligned and FIFO len should not less than 8.
+** E.g. FIFO_DEFINE(gs_stRxFifo, 'r', 64u); then use &gs_stRxFifo as FIFO handle.
+*/
+#ifdef EN_FIFO_STATISTICS
+#define FIFO_STATISTICS_INIT , 0u, 0u, 0u, 0u /* xMaxUsedLen, overMaxCnt, writeBytes, readBytes */
 #else
-#define TOTAL_FIFO_BYTES (100u) /* Config total bytes */
+#define FIFO_STATISTICS_INIT
 #endif
 
-/**********************************************************
-**  Function Name       :   ApplyFifo
-**  Description         :   Apply a FIFO
-**  Input Parameter     :   i_xApplyFifoLen need apply FIFO len
-                            i_xFifoId FIFO ID. Use find this FIFO.
-**  Modify Parameter    :   none
-**  Output Parameter    :   o_peApplyStatus apply status. If apply success ERRO_NONE, else ERRO_XXX
-**  Return Value        :   none
-**  Version             :   v00.00.01
-**  Author              :   Tomlin
-**  Created Date        :   2013-3-27
-**********************************************************/
-void ApplyFifo(tLen i_xApplyFifoLen, tLen i_xFifoId, tErroCode *o_peApplyStatus);
+#define FIFO_DEFINE(xFifoName, xFifoId, xFifoLen)\
+    typedef char xFifoName##_LenShouldBePowerOf2[(IsFifoLenValid(xFifoLen) && ((xFifoLen) >= 8u)) ? 1 : -1];\
+    static uint32 xFifoName##_aulBuf[(xFifoLen) / sizeof(uint32)];\
+    static tFifoInfo xFifoName = {(xFifoId), (xFifoLen), 0u, 0u, 0u, MSG_NO_RESERVE, (unsigned char *)xFifoName##_aulBuf FIFO_STATISTICS_INIT}
+
+/*
+** A FIFO is used as byte stream (WriteDataInFifo/ReadDataFromFifo) or as message FIFO
+** (Reserve/Commit, Peek/Release, Push/Pop), not both. Message FIFO len should not less than 8.
+** Max message len that always can be written after FIFO is empty. Can be used in #if.
+*/
+#define FifoMaxMsgLen(xFifoLen) ((xFifoLen) / 2u - 4u)
 
 /**********************************************************
 **  Function Name       :   WriteDataInFifo
 **  Description         :   write data in FIFO.
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Input Parameter     :   i_xFifo FIFO handle
                             i_pucWriteDataBuf Need write data buffer
                             i_xWriteDatalen  write data len
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_peWriteStatus write data status. If successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void WriteDataInFifo(tId i_xFifoId,
+void WriteDataInFifo(tFifoHandle i_xFifo,
                      unsigned char *i_pucWriteDataBuf,
                      tLen i_xWriteDatalen,
                      tErroCode *o_peWriteStatus);
@@ -89,62 +125,207 @@ void WriteDataInFifo(tId i_xFifoId,
 /**********************************************************
 **  Function Name       :   ReadDataFromFifo
 **  Description         :   Read data from FIFO.
-**  Input Parameter     :   i_xFifoId need read FIFO
+**  Input Parameter     :   i_xFifo FIFO handle
                             i_xNeedReadDataLen read data len
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_pucReadDataBuf need read data buffer.
                             o_pxReadLen need read data len
                             o_peReadStatus read status. If read successful ERRO_NONE, else ERRO_XXX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void ReadDataFromFifo(tId i_xFifoId, tLen i_xNeedReadDataLen,
+void ReadDataFromFifo(tFifoHandle i_xFifo, tLen i_xNeedReadDataLen,
                       unsigned char *o_pucReadDataBuf,
                       tLen *o_pxReadLen,
                       tErroCode *o_peReadStatus);
 
+/**********************************************************
+**  Function Name       :   ReserveMsgInFifo
+**  Description         :   Reserve a contiguous message space in FIFO. Message is built in place
+                            and write in FIFO by CommitMsgInFifo. Only call by producer.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xMsgLen need reserve message len, slot should not more than half FIFO len
+                            that always can be reserved after FIFO is empty.
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peReserveStatus reserve status. If successful ERRO_NONE,
+                            ERRO_OVER_MAX if FIFO have no space for message, else ERRO_XX
+**  Return Value        :   Reserved message address, 4 bytes aligned. NULL if reserve failed.
+**  Version             :   v00.00.01
+**********************************************************/
+unsigned char *ReserveMsgInFifo(tFifoHandle i_xFifo, tLen i_xMsgLen, tErroCode *o_peReserveStatus);
+
+/**********************************************************
+**  Function Name       :   CommitMsgInFifo
+**  Description         :   Commit reserved message, consumer can read the message after commit.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xMsgLen real message len, not more than reserved len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peCommitStatus commit status. If successful ERRO_NONE,
+                            ERRO_WRITE_ERRO if no message reserved, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void CommitMsgInFifo(tFifoHandle i_xFifo, tLen i_xMsgLen, tErroCode *o_peCommitStatus);
+
+/**********************************************************
+**  Function Name       :   PeekMsgFromFifo
+**  Description         :   Get the first message in FIFO without read out. Message is parsed in place
+                            and removed by ReleaseMsgFromFifo. Only call by consumer.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pxMsgLen message len
+                            o_pePeekStatus peek status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty.
+                            If FIFO data is not a message, all data is dropped and return ERRO_READ_ERRO.
+**  Return Value        :   Message address, 4 bytes aligned. NULL if no message.
+**  Version             :   v00.00.01
+**********************************************************/
+unsigned char *PeekMsgFromFifo(tFifoHandle i_xFifo, tLen *o_pxMsgLen, tErroCode *o_pePeekStatus);
+
+/**********************************************************
+**  Function Name       :   ReleaseMsgFromFifo
+**  Description         :   Release the first message in FIFO, producer can reuse the space after release.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peReleaseStatus release status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty.
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void ReleaseMsgFromFifo(tFifoHandle i_xFifo, tErroCode *o_peReleaseStatus);
+
+/**********************************************************
+**  Function Name       :   PushMsgInFifo
+**  Description         :   Push a message (header + data) in FIFO.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_pucHeader message header
+                            i_xHeaderLen message header len
+                            i_pucDataBuf message data, can be null if data len is 0
+                            i_xDataLen message data len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pePushStatus push status. If successful ERRO_NONE,
+                            ERRO_OVER_MAX if FIFO have no space for whole message, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.02
+**********************************************************/
+void PushMsgInFifo(tFifoHandle i_xFifo,
+                   const unsigned char *i_pucHeader,
+                   tLen i_xHeaderLen,
+                   const unsigned char *i_pucDataBuf,
+                   tLen i_xDataLen,
+                   tErroCode *o_pePushStatus);
+
+/**********************************************************
+**  Function Name       :   PopMsgFromFifo
+**  Description         :   Pop a message from FIFO, split it to header and data.
+**  Input Parameter     :   i_xFifo FIFO handle
+                            i_xHeaderLen message header len
+                            i_xDataBufLen data buffer len
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pucHeader message header
+                            o_pucDataBuf message data
+                            o_pxDataLen message data len
+                            o_pePopStatus pop status. If successful ERRO_NONE, ERRO_NO_MSG if FIFO is empty.
+                            If message not match header len or data buffer, message is dropped and return ERRO_READ_ERRO.
+**  Return Value        :   none
+**  Version             :   v00.00.02
+**********************************************************/
+void PopMsgFromFifo(tFifoHandle i_xFifo,
+                    unsigned char *o_pucHeader,
+                    tLen i_xHeaderLen,
+                    unsigned char *o_pucDataBuf,
+                    tLen i_xDataBufLen,
+                    tLen *o_pxDataLen,
+                    tErroCode *o_pePopStatus);
+
 /**********************************************************
 **  Function Name       :   GetCanReadLen
 **  Description         :   Get FIFO have data.
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_pxCanReadLen how much data can read.
                             o_peGetStatus get status. If get successful ERRO_NONE, else ERRO_XXX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void GetCanReadLen(tId i_xFifoId, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus);
+void GetCanReadLen(tFifoHandle i_xFifo, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus);
 
 /**********************************************************
 **  Function Name       :   GetCanWriteLen
 **  Description         :   Get can write data.
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_pxCanWriteLen how much data can write.
                             o_peGetStatus get data status. If get successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2013-3-27
 **********************************************************/
-void GetCanWriteLen(tId i_xFifoId, tLen *o_pxCanWriteLen, tErroCode *o_peGetStatus);
+void GetCanWriteLen(tFifoHandle i_xFifo, tLen *o_pxCanWriteLen, tErroCode *o_peGetStatus);
 
 /**********************************************************
 **  Function Name       :   ClearFIFO
-**  Description         :   Clear FIFO, set read pointer equal write pointer
-**  Input Parameter     :   i_xFifoId FIFO ID
+**  Description         :   Clear FIFO, set read counter equal write counter. Only call by consumer.
+**  Input Parameter     :   i_xFifo FIFO handle
 **  Modify Parameter    :   none
 **  Output Parameter    :   o_peGetStatus get data status. If get successful ERRO_NONE, else ERRO_XX
 **  Return Value        :   none
-**  Version             :   v00.00.01
+**  Version             :   v00.00.02
 **  Author              :   Tomlin
 **  Created Date        :   2019-6-18
 **********************************************************/
-void ClearFIFO(tId i_xFifoId, tErroCode *o_peGetStatus);
+void ClearFIFO(tFifoHandle i_xFifo, tErroCode *o_peGetStatus);
+
+#ifdef EN_FIFO_STATISTICS
+typedef struct
+{
+    tId xOwnerId;       /* FIFO ID */
+    tLen xFifoLen;      /* FIFO len */
+    tLen xUsedLen;      /* Now used len */
+    tLen xMaxUsedLen;   /* Max used len after reset, message FIFO include message head */
+    uint32 overMaxCnt;  /* Write/Reserve rejected by ERRO_OVER_MAX count */
+    uint32 writeBytes;  /* Written bytes */
+    uint32 readBytes;   /* Read bytes */
+} tFifoStatistics;
+
+/**********************************************************
+**  Function Name       :   GetFifoStatistics
+**  Description         :   Get FIFO statistics, used to size FIFO len.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_pstStatistics FIFO statistics
+                            o_peGetStatus get status. If get successful ERRO_NONE, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void GetFifoStatistics(tFifoHandle i_xFifo, tFifoStatistics *o_pstStatistics, tErroCode *o_peGetStatus);
+
+/**********************************************************
+**  Function Name       :   ResetFifoStatistics
+**  Description         :   Reset FIFO statistics. Statistics changed by producer/consumer at the same
+                            time may be not reset, that is acceptable for statistics.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   o_peResetStatus reset status. If reset successful ERRO_NONE, else ERRO_XX
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void ResetFifoStatistics(tFifoHandle i_xFifo, tErroCode *o_peResetStatus);
+
+/**********************************************************
+**  Function Name       :   PrintFifoStatistics
+**  Description         :   Print FIFO statistics by FIFODebugPrintf.
+**  Input Parameter     :   i_xFifo FIFO handle
+**  Modify Parameter    :   none
+**  Output Parameter    :   none
+**  Return Value        :   none
+**  Version             :   v00.00.01
+**********************************************************/
+void PrintFifoStatistics(tFifoHandle i_xFifo);
+#endif /* EN_FIFO_STATISTICS */
 
 #endif /* MULTI_CYC_FIFO_H_ */
 
@@ -0,0 +1,479 @@
+/*
+ * @ : uart_tp.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "uart_tp.h"
+
+#ifdef EN_UART_TP
+#include "TP_cfg.h"
+
+/*********************************************************
+**  Frame: SOF | type | SN | data len | data | CRC16
+**  Data frame - type is UDS message ID, maybe with SYNC flag
+**  ACK frame  - type is ACK, SN is the last data frame SN received in order
+*********************************************************/
+
+typedef enum
+{
+    UARTTP_RX_SOF,    /* Wait start of frame */
+    UARTTP_RX_HEAD,   /* Wait frame head */
+    UARTTP_RX_DATA    /* Wait data and CRC */
+} tUARTTpRxStatus;
+
+typedef struct
+{
+    tUARTTpRxStatus eStatus;                /* RX frame status */
+    uint32 xRxLen;                          /* Received frame len */
+    uint32 xFrameLen;                       /* Frame len */
+    tNetTime xByteTimeout;                  /* Wait next byte of frame timeout */
+    uint8 ucExpectSN;                       /* Expect data frame SN */
+    uint8 ucLastSN;                         /* Last data frame SN received in order */
+    boolean isSynced;                       /* Received a data frame in order */
+    uint8 aFrameBuf[UART_TP_MAX_FRAME_LEN]; /* RX frame buffer */
+} tUARTTpRxInfo;
+
+typedef struct
+{
+    uint32 xFrameLen;                       /* Frame len */
+    tpfUDSTxMsgCallBack pfCallBack;         /* UDS TX message callback */
+    uint8 aFrameBuf[UART_TP_MAX_FRAME_LEN]; /* TX frame buffer */
+} tUARTTpTxSlot;
+
+typedef struct
+{
+    tUARTTpTxSlot astSlot[UART_TP_TX_WINDOW];   /* TX window */
+    uint8 ucFirst;                              /* First slot waiting ACK */
+    uint8 ucUsed;                               /* Used slots from first */
+    uint8 ucSent;                               /* Sent slots from first */
+    uint8 ucNextSN;                             /* Next data frame SN */
+    uint8 ucRetry;                              /* TX again times */
+    boolean isSync;                             /* TX data frame with SYNC flag until received ACK */
+    tNetTime xAckTimeout;                       /* Wait ACK timeout */
+} tUARTTpTxInfo;
+
+static tUARTTpRxInfo gs_stUARTTPRxInfo;     /* UART TP RX info */
+static tUARTTpTxInfo gs_stUARTTPTxInfo;     /* UART TP TX info */
+
+/* CRC16/CCITT half byte table */
+static const uint16 gs_auCRC16Table[16u] =
+{
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu
+};
+
+/* Calculate CRC16/CCITT */
+static uint16 UARTTP_CalcCRC16(const uint8 *i_pDataBuf, const uint32 i_dataLen);
+
+/* Build frame with head and CRC, return frame len */
+static uint32 UARTTP_BuildFrame(const uint8 i_type, const uint8 i_SN, const uint8 *i_pDataBuf, const uint32 i_dataLen, uint8 *o_pFrameBuf);
+
+/* RX a byte of frame */
+static void UARTTP_RxByte(const uint8 i_byte);
+
+/* Received a frame with valid CRC */
+static void UARTTP_DoReceiveFrame(void);
+
+/* Received a data frame */
+static void UARTTP_DoReceiveDataFrame(const uint8 i_type, const uint8 i_SN, const uint8 *i_pDataBuf, const uint32 i_dataLen);
+
+/* Received an ACK frame */
+static void UARTTP_DoReceiveAck(const uint8 i_SN);
+
+/* TX ACK frame */
+static void UARTTP_TxAck(const uint8 i_SN);
+
+/* Read UDS message from TX TP queue in free slots of TX window */
+static void UARTTP_FillTxWindow(void);
+
+/* TX not sent frames in TX window */
+static void UARTTP_DoTransmitWindow(void);
+
+/* Check wait ACK timeout */
+static void UARTTP_CheckAckTimeout(void);
+
+/* Release first slot of TX window and do UDS TX message callback */
+static void UARTTP_ReleaseFirstSlot(const uint8 i_result);
+
+void UARTTP_Init(void)
+{
+    fsl_memset(&gs_stUARTTPRxInfo, 0u, sizeof(gs_stUARTTPRxInfo));
+    fsl_memset(&gs_stUARTTPTxInfo, 0u, sizeof(gs_stUARTTPTxInfo));
+    gs_stUARTTPRxInfo.eStatus = UARTTP_RX_SOF;
+    gs_stUARTTPTxInfo.isSync = TRUE;
+}
+
+/* UART TP system tick control. This function should period called by system. */
+void UARTTP_SytstemTickControl(void)
+{
+    if (gs_stUARTTPRxInfo.xByteTimeout)
+    {
+        gs_stUARTTPRxInfo.xByteTimeout--;
+    }
+
+    if (gs_stUARTTPTxInfo.xAckTimeout)
+    {
+        gs_stUARTTPTxInfo.xAckTimeout--;
+    }
+}
+
+/* UDS network man function */
+void UARTTP_MainFun(void)
+{
+    uint8 aucRxBuf[32u];
+    uint32 rxLen = 0u;
+    uint32 index = 0u;
+
+    /* Drop received part of frame if next byte timeout */
+    if ((UARTTP_RX_SOF != gs_stUARTTPRxInfo.eStatus) && (0u == gs_stUARTTPRxInfo.xByteTimeout))
+    {
+        TPDebugPrintf("UART TP wait byte timeout, drop frame!\n");
+        gs_stUARTTPRxInfo.eStatus = UARTTP_RX_SOF;
+    }
+
+    /* Read all received bytes from RX BUS FIFO */
+    do
+    {
+        rxLen = g_stUdsUARTNetLayerCfgInfo.pfNetRx(aucRxBuf, sizeof(aucRxBuf));
+
+        for (index = 0u; index < rxLen; index++)
+        {
+            UARTTP_RxByte(aucRxBuf[index]);
+        }
+    } while (0u != rxLen);
+
+    UARTTP_CheckAckTimeout();
+    UARTTP_FillTxWindow();
+    UARTTP_DoTransmitWindow();
+}
+
+/* Calculate CRC16/CCITT */
+static uint16 UARTTP_CalcCRC16(const uint8 *i_pDataBuf, const uint32 i_dataLen)
+{
+    uint16 crc = 0xFFFFu;
+    uint32 index = 0u;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    for (index = 0u; index < i_dataLen; index++)
+    {
+        crc = (uint16)((crc << 4u) ^ gs_auCRC16Table[((crc >> 12u) ^ (i_pDataBuf[index] >> 4u)) & 0x0Fu]);
+        crc = (uint16)((crc << 4u) ^ gs_auCRC16Table[((crc >> 12u) ^ i_pDataBuf[index]) & 0x0Fu]);
+    }
+
+    return crc;
+}
+
+/* Build frame with head and CRC, return frame len */
+static uint32 UARTTP_BuildFrame(const uint8 i_type, const uint8 i_SN, const uint8 *i_pDataBuf, const uint32 i_dataLen, uint8 *o_pFrameBuf)
+{
+    uint16 crc = 0u;
+    ASSERT(NULL_PTR == o_pFrameBuf);
+
+    o_pFrameBuf[0u] = UART_TP_SOF;
+    o_pFrameBuf[1u] = i_type;
+    o_pFrameBuf[2u] = i_SN;
+    o_pFrameBuf[3u] = (uint8)i_dataLen;
+
+    if (0u != i_dataLen)
+    {
+        fsl_memcpy(&o_pFrameBuf[UART_TP_FRAME_HEAD_LEN], i_pDataBuf, i_dataLen);
+    }
+
+    crc = UARTTP_CalcCRC16(&o_pFrameBuf[1u], UART_TP_FRAME_HEAD_LEN - 1u + i_dataLen);
+    o_pFrameBuf[UART_TP_FRAME_HEAD_LEN + i_dataLen] = (uint8)(crc >> 8u);
+    o_pFrameBuf[UART_TP_FRAME_HEAD_LEN + i_dataLen + 1u] = (uint8)crc;
+
+    return UART_TP_FRAME_HEAD_LEN + i_dataLen + UART_TP_FRAME_CRC_LEN;
+}
+
+/* RX a byte of frame */
+static void UARTTP_RxByte(const uint8 i_byte)
+{
+    tUARTTpRxInfo *pstRxInfo = &gs_stUARTTPRxInfo;
+
+    switch (pstRxInfo->eStatus)
+    {
+        case UARTTP_RX_SOF:
+            if (UART_TP_SOF == i_byte)
+            {
+                pstRxInfo->aFrameBuf[0u] = i_byte;
+                pstRxInfo->xRxLen = 1u;
+                pstRxInfo->xByteTimeout = g_stUdsUARTNetLayerCfgInfo.xNByte;
+                pstRxInfo->eStatus = UARTTP_RX_HEAD;
+            }
+
+            break;
+
+        case UARTTP_RX_HEAD:
+            pstRxInfo->aFrameBuf[pstRxInfo->xRxLen++] = i_byte;
+            pstRxInfo->xByteTimeout = g_stUdsUARTNetLayerCfgInfo.xNByte;
+
+            if (UART_TP_FRAME_HEAD_LEN == pstRxInfo->xRxLen)
+            {
+                /* Data len is invalid, hunt start of frame again */
+                if ((i_byte > UART_TP_MAX_DATA_LEN) ||
+                        ((UART_TP_ACK_TYPE == pstRxInfo->aFrameBuf[1u]) && (0u != i_byte)))
+                {
+                    TPDebugPrintf("UART TP RX invalid frame len %d!\n", i_byte);
+                    pstRxInfo->eStatus = UARTTP_RX_SOF;
+                }
+                else
+                {
+                    pstRxInfo->xFrameLen = UART_TP_FRAME_HEAD_LEN + i_byte + UART_TP_FRAME_CRC_LEN;
+                    pstRxInfo->eStatus = UARTTP_RX_DATA;
+                }
+            }
+
+            break;
+
+        case UARTTP_RX_DATA:
+            pstRxInfo->aFrameBuf[pstRxInfo->xRxLen++] = i_byte;
+            pstRxInfo->xByteTimeout = g_stUdsUARTNetLayerCfgInfo.xNByte;
+
+            if (pstRxInfo->xFrameLen == pstRxInfo->xRxLen)
+            {
+                UARTTP_DoReceiveFrame();
+                pstRxInfo->eStatus = UARTTP_RX_SOF;
+            }
+
+            break;
+
+        default:
+            pstRxInfo->eStatus = UARTTP_RX_SOF;
+            break;
+    }
+}
+
+/* Received a frame with valid CRC */
+static void UARTTP_DoReceiveFrame(void)
+{
+    const uint8 *pucFrame = gs_stUARTTPRxInfo.aFrameBuf;
+    const uint32 dataLen = pucFrame[3u];
+    const uint16 crc = (uint16)(((uint16)pucFrame[UART_TP_FRAME_HEAD_LEN + dataLen] << 8u) |
+                                pucFrame[UART_TP_FRAME_HEAD_LEN + dataLen + 1u]);
+
+    if (crc != UARTTP_CalcCRC16(&pucFrame[1u], UART_TP_FRAME_HEAD_LEN - 1u + dataLen))
+    {
+        TPDebugPrintf("UART TP RX frame CRC error!\n");
+        return;
+    }
+
+    if (UART_TP_ACK_TYPE == pucFrame[1u])
+    {
+        UARTTP_DoReceiveAck(pucFrame[2u]);
+    }
+    else
+    {
+        UARTTP_DoReceiveDataFrame(pucFrame[1u], pucFrame[2u], &pucFrame[UART_TP_FRAME_HEAD_LEN], dataLen);
+    }
+}
+
+/* Received a data frame, write it in TP RX FIFO and ACK. If TP RX FIFO is full, not ACK and sender will TX it again. */
+static void UARTTP_DoReceiveDataFrame(const uint8 i_type, const uint8 i_SN, const uint8 *i_pDataBuf, const uint32 i_dataLen)
+{
+    tErroCode eStatus;
+    tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
+    tUARTTpRxInfo *pstRxInfo = &gs_stUARTTPRxInfo;
+    const uint32 msgID = (uint32)(i_type & UART_TP_TYPE_MASK);
+
+    if ((TRUE != UARTTP_IsReceivedMsgIDValid(msgID)) || (0u == i_dataLen))
+    {
+        TPDebugPrintf("Received invalid message ID\n");
+        return;
+    }
+
+    /* Sender restarted SN, but TX again the last received frame is not new frame */
+    if ((0u != (i_type & UART_TP_SYNC_FLAG)) &&
+            !((TRUE == pstRxInfo->isSynced) && (i_SN == pstRxInfo->ucLastSN)))
+    {
+        pstRxInfo->ucExpectSN = i_SN;
+    }
+
+    /* Repeated or lost frame, ACK the last SN received in order */
+    if (i_SN != pstRxInfo->ucExpectSN)
+    {
+        if (TRUE == pstRxInfo->isSynced)
+        {
+            UARTTP_TxAck(pstRxInfo->ucLastSN);
+        }
+
+        return;
+    }
+
+    exchangeMsgInfo.msgID = msgID;
+    exchangeMsgInfo.dataLen = i_dataLen;
+    exchangeMsgInfo.pfCallBack = NULL_PTR;
+    exchangeMsgInfo.channel = (uint32)TP_UART_CHANNEL;
+    /* Write UDS receive ID, data len and data */
+    PushMsgInFifo(g_xRxTPQueue, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), i_pDataBuf, (tLen)i_dataLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        TPDebugPrintf("UART TP write RX FIFO failed!\n");
+        return;
+    }
+
+    pstRxInfo->ucLastSN = i_SN;
+    pstRxInfo->ucExpectSN = (uint8)(i_SN + 1u);
+    pstRxInfo->isSynced = TRUE;
+    UARTTP_TxAck(i_SN);
+}
+
+/* Received an ACK frame, release all slots which SN is not after ACK SN */
+static void UARTTP_DoReceiveAck(const uint8 i_SN)
+{
+    tUARTTpTxInfo *pstTxInfo = &gs_stUARTTPTxInfo;
+    boolean isReleased = FALSE;
+
+    while ((0u != pstTxInfo->ucSent) &&
+            ((uint8)(i_SN - pstTxInfo->astSlot[pstTxInfo->ucFirst].aFrameBuf[2u]) < 0x80u))
+    {
+        UARTTP_ReleaseFirstSlot(TX_MSG_SUCCESSFUL);
+        isReleased = TRUE;
+    }
+
+    if (TRUE == isReleased)
+    {
+        pstTxInfo->ucRetry = 0u;
+        pstTxInfo->isSync = FALSE;
+        pstTxInfo->xAckTimeout = g_stUdsUARTNetLayerCfgInfo.xNAck;
+    }
+}
+
+/* TX ACK frame. If TX BUS FIFO is full ACK is lost, sender will TX the data frame again. */
+static void UARTTP_TxAck(const uint8 i_SN)
+{
+    uint8 aucFrame[UART_TP_FRAME_HEAD_LEN + UART_TP_FRAME_CRC_LEN];
+    const uint32 frameLen = UARTTP_BuildFrame(UART_TP_ACK_TYPE, i_SN, NULL_PTR, 0u, aucFrame);
+
+    if (TRUE != g_stUdsUARTNetLayerCfgInfo.pfNetTx(aucFrame, frameLen))
+    {
+        TPDebugPrintf("UART TP TX ACK failed!\n");
+    }
+}
+
+/* Read UDS message from TX TP queue in free slots of TX window */
+static void UARTTP_FillTxWindow(void)
+{
+    tErroCode eStatus;
+    tLen xRealReadLen = 0u;
+    tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
+    uint8 aucDataBuf[UART_TP_MAX_DATA_LEN];
+    tUARTTpTxInfo *pstTxInfo = &gs_stUARTTPTxInfo;
+    tUARTTpTxSlot *pstSlot = NULL_PTR;
+    uint8 type = 0u;
+
+    while (pstTxInfo->ucUsed < UART_TP_TX_WINDOW)
+    {
+        /* Read UDS transmit ID, data len and data */
+        PopMsgFromFifo(g_xUARTTxTPQueue,
+                       (uint8 *)&exchangeMsgInfo,
+                       sizeof(tUDSAndTPExchangeMsgInfo),
+                       aucDataBuf,
+                       UART_TP_MAX_DATA_LEN,
+                       &xRealReadLen,
+                       &eStatus);
+
+        if (ERRO_NO_MSG == eStatus)
+        {
+            break;
+        }
+
+        if ((ERRO_NONE != eStatus) || (exchangeMsgInfo.dataLen != xRealReadLen))
+        {
+            TPDebugPrintf("UART TP read TX queue error!\n");
+            continue;
+        }
+
+        type = (uint8)(exchangeMsgInfo.msgID & UART_TP_TYPE_MASK);
+
+        if (TRUE == pstTxInfo->isSync)
+        {
+            type |= UART_TP_SYNC_FLAG;
+        }
+
+        pstSlot = &pstTxInfo->astSlot[(pstTxInfo->ucFirst + pstTxInfo->ucUsed) % UART_TP_TX_WINDOW];
+        pstSlot->pfCallBack = exchangeMsgInfo.pfCallBack;
+        pstSlot->xFrameLen = UARTTP_BuildFrame(type, pstTxInfo->ucNextSN, aucDataBuf, xRealReadLen, pstSlot->aFrameBuf);
+        pstTxInfo->ucNextSN++;
+        pstTxInfo->ucUsed++;
+    }
+}
+
+/* TX not sent frames in TX window */
+static void UARTTP_DoTransmitWindow(void)
+{
+    tUARTTpTxInfo *pstTxInfo = &gs_stUARTTPTxInfo;
+    const tUARTTpTxSlot *pstSlot = NULL_PTR;
+
+    while (pstTxInfo->ucSent < pstTxInfo->ucUsed)
+    {
+        pstSlot = &pstTxInfo->astSlot[(pstTxInfo->ucFirst + pstTxInfo->ucSent) % UART_TP_TX_WINDOW];
+
+        /* TX BUS FIFO is full, TX it in next period */
+        if (TRUE != g_stUdsUARTNetLayerCfgInfo.pfNetTx(pstSlot->aFrameBuf, pstSlot->xFrameLen))
+        {
+            break;
+        }
+
+        if (0u == pstTxInfo->ucSent)
+        {
+            pstTxInfo->xAckTimeout = g_stUdsUARTNetLayerCfgInfo.xNAck;
+        }
+
+        pstTxInfo->ucSent++;
+    }
+}
+
+/* Check wait ACK timeout, TX all frames in TX window again. Over max retry times, drop them. */
+static void UARTTP_CheckAckTimeout(void)
+{
+    tUARTTpTxInfo *pstTxInfo = &gs_stUARTTPTxInfo;
+
+    if ((0u == pstTxInfo->ucSent) || (0u != pstTxInfo->xAckTimeout))
+    {
+        return;
+    }
+
+    pstTxInfo->ucRetry++;
+
+    if (pstTxInfo->ucRetry > g_stUdsUARTNetLayerCfgInfo.ucMaxRetry)
+    {
+        TPDebugPrintf("UART TP wait ACK timeout, drop %d frames!\n", pstTxInfo->ucUsed);
+
+        while (0u != pstTxInfo->ucUsed)
+        {
+            UARTTP_ReleaseFirstSlot(TX_MSG_TIMEOUT);
+        }
+
+        pstTxInfo->ucRetry = 0u;
+        pstTxInfo->isSync = TRUE;
+    }
+    else
+    {
+        pstTxInfo->ucSent = 0u;
+    }
+}
+
+/* Release first slot of TX window and do UDS TX message callback */
+static void UARTTP_ReleaseFirstSlot(const uint8 i_result)
+{
+    tUARTTpTxInfo *pstTxInfo = &gs_stUARTTPTxInfo;
+
+    TP_RegisterTransmittedAFrmaeMsgCallBack(pstTxInfo->astSlot[pstTxInfo->ucFirst].pfCallBack);
+    TP_DoTransmittedAFrameMsgCallBack(i_result);
+    pstTxInfo->astSlot[pstTxInfo->ucFirst].pfCallBack = NULL_PTR;
+    pstTxInfo->ucFirst = (uint8)((pstTxInfo->ucFirst + 1u) % UART_TP_TX_WINDOW);
+    pstTxInfo->ucUsed--;
+
+    if (0u != pstTxInfo->ucSent)
+    {
+        pstTxInfo->ucSent--;
+    }
+}
+#endif /* EN_UART_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
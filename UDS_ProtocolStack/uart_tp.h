@@ -0,0 +1,28 @@
+/*
+ * @ : uart_tp.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef UART_TP_H_
+#define UART_TP_H_
+
+#include "uart_tp_cfg.h"
+
+#ifdef EN_UART_TP
+
+#include "multi_cyc_fifo.h"
+
+void UARTTP_MainFun(void);
+
+void UARTTP_SytstemTickControl(void);
+
+void UARTTP_Init(void);
+
+#endif /* EN_UART_TP */
+
+#endif /* UART_TP_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,209 @@
+/*
+ * @ : uart_tp_cfg.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "uart_tp_cfg.h"
+
+#ifdef EN_UART_TP
+
+#include "multi_cyc_fifo.h"
+#include "uart_tp.h"
+
+static uint8 UARTTP_TxFrame(const uint8 *i_pFrameBuf, const uint32 i_frameLen);
+
+static uint32 UARTTP_RxBytes(uint8 *o_pRxBuf, const uint32 i_bufLen);
+
+
+/* Define UART TP TX queue and BUS FIFOs at compile time */
+FIFO_DEFINE(gs_stUARTTxTPQueue, UART_TX_TP_QUEUE_ID, TX_TP_QUEUE_LEN);
+FIFO_DEFINE(gs_stUARTRxBusFifo, UART_RX_BUS_FIFO, UART_RX_BUS_FIFO_LEN);
+FIFO_DEFINE(gs_stUARTTxBusFifo, UART_TX_BUS_FIFO, UART_TX_BUS_FIFO_LEN);
+
+const tFifoHandle g_xUARTTxTPQueue = &gs_stUARTTxTPQueue;       /* UART TP TX queue */
+static const tFifoHandle gs_xRxBusFifo = &gs_stUARTRxBusFifo;  /* RX bus FIFO, byte stream */
+static const tFifoHandle gs_xTxBusFifo = &gs_stUARTTxBusFifo;  /* TX bus FIFO, a message is a frame */
+
+/* UART TP channel config */
+const tTPChannelCfg g_stUARTTPChannelCfg =
+{
+    UARTTP_Init,                   /* TP init */
+    UARTTP_MainFun,                /* TP main function */
+    UARTTP_SytstemTickControl,     /* TP system tick control */
+    UARTTP_GetConfigTxMsgID,       /* Get TX message ID */
+    UARTTP_GetConfigRxMsgFUNID,    /* Get RX function ID */
+    UARTTP_GetConfigRxMsgPHYID,    /* Get RX physical ID */
+    &gs_stUARTTxTPQueue,           /* TX TP queue */
+};
+
+/* UDS network layer config info */
+const tUdsUARTNetLayerCfg g_stUdsUARTNetLayerCfgInfo =
+{
+    1u,                   /* Called UART TP main function period */
+    UART_RX_FUN_ADDR_ID,  /* UART TP RX FUN ID */
+    UART_RX_PHY_ADDR_ID,  /* UART TP RX PHY ID */
+    UART_TX_RESP_ADDR_ID, /* UART TP TX RESP ID */
+    20u,                  /* Wait ACK max time */
+    5u,                   /* Max time between two bytes of a frame */
+    5u,                   /* Max TX again times */
+    UARTTP_TxFrame,       /* UART TP TX */
+    UARTTP_RxBytes,       /* UART TP RX */
+};
+
+
+/* UART TP TX a frame: write frame in TX BUS FIFO, driver TX it by DMA */
+static uint8 UARTTP_TxFrame(const uint8 *i_pFrameBuf, const uint32 i_frameLen)
+{
+    tErroCode eStatus;
+    tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const tLen xMsgLen = (tLen)(sizeof(tTPTxMsgHeader) + i_frameLen);
+    ASSERT(NULL_PTR == i_pFrameBuf);
+
+    if (i_frameLen > UART_TP_MAX_FRAME_LEN)
+    {
+        return FALSE;
+    }
+
+    /* Build TX message in TX BUS FIFO, if TX BUS FIFO is full nothing is written */
+    pstTxMsgInfo = (tTPTxMsgHeader *)ReserveMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    pstTxMsgInfo->TxMsgID = i_pFrameBuf[1u];
+    pstTxMsgInfo->TxMsgLength = i_frameLen;
+    pstTxMsgInfo->TxMsgCallBack = 0u;
+    fsl_memcpy((uint8 *)(pstTxMsgInfo + 1u), i_pFrameBuf, i_frameLen);
+    CommitMsgInFifo(gs_xTxBusFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* UART TP RX bytes: read RX bytes from RX BUS FIFO, return read len */
+static uint32 UARTTP_RxBytes(uint8 *o_pRxBuf, const uint32 i_bufLen)
+{
+    tErroCode eStatus;
+    tLen xReadLen = 0u;
+    ASSERT(NULL_PTR == o_pRxBuf);
+
+    ReadDataFromFifo(gs_xRxBusFifo, (tLen)i_bufLen, o_pRxBuf, &xReadLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return 0u;
+    }
+
+    return (uint32)xReadLen;
+}
+
+/* Driver write received bytes in UART TP, return written len. Not written bytes should be written again. */
+uint32 UARTTP_DriverWriteDataInUARTTP(const uint32 i_dataLen, const uint8 *i_pDataBuf)
+{
+    tErroCode eStatus;
+    tLen xCanWriteLen = 0u;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    GetCanWriteLen(gs_xRxBusFifo, &xCanWriteLen, &eStatus);
+
+    if ((ERRO_NONE != eStatus) || (0u == xCanWriteLen) || (0u == i_dataLen))
+    {
+        return 0u;
+    }
+
+    if (xCanWriteLen > i_dataLen)
+    {
+        xCanWriteLen = (tLen)i_dataLen;
+    }
+
+    WriteDataInFifo(gs_xRxBusFifo, (uint8 *)i_pDataBuf, xCanWriteLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return 0u;
+    }
+
+    return (uint32)xCanWriteLen;
+}
+
+/* Driver read a frame from UART TP */
+boolean UARTTP_DriverReadDataFromUARTTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
+{
+    boolean result = FALSE;
+    tLen xReadDataLen = 0u;
+    tErroCode eStatus;
+    tTPTxMsgHeader TxMsgInfo;
+    ASSERT(NULL_PTR == o_pReadDataBuf);
+    ASSERT(NULL_PTR == o_pstTxMsgHeader);
+    PopMsgFromFifo(gs_xTxBusFifo,
+                   (uint8 *)&TxMsgInfo,
+                   sizeof(tTPTxMsgHeader),
+                   o_pReadDataBuf,
+                   (tLen)i_readDataLen,
+                   &xReadDataLen,
+                   &eStatus);
+
+    if ((ERRO_NONE == eStatus) && (xReadDataLen == TxMsgInfo.TxMsgLength))
+    {
+        result = TRUE;
+        *o_pstTxMsgHeader = TxMsgInfo;
+    }
+
+    return result;
+}
+
+/* Get config UART TP TX ID */
+tUdsId UARTTP_GetConfigTxMsgID(void)
+{
+    return g_stUdsUARTNetLayerCfgInfo.xTxId;
+}
+
+/* Get config UART TP receive function message ID */
+tUdsId UARTTP_GetConfigRxMsgFUNID(void)
+{
+    return g_stUdsUARTNetLayerCfgInfo.xRxFunId;
+}
+
+/* Get config UART TP receive physical message ID */
+tUdsId UARTTP_GetConfigRxMsgPHYID(void)
+{
+    return g_stUdsUARTNetLayerCfgInfo.xRxPhyId;
+}
+
+/* Get UART TP config TX handler */
+tUARTNetTx UARTTP_GetConfigTxHandle(void)
+{
+    return g_stUdsUARTNetLayerCfgInfo.pfNetTx;
+}
+
+/* Get UART TP config RX handler */
+tUARTNetRx UARTTP_GetConfigRxHandle(void)
+{
+    return g_stUdsUARTNetLayerCfgInfo.pfNetRx;
+}
+
+/* Is received message valid? */
+boolean UARTTP_IsReceivedMsgIDValid(const uint32 i_receiveMsgID)
+{
+    boolean result = FALSE;
+
+    if ((i_receiveMsgID == UARTTP_GetConfigRxMsgFUNID())
+            || (i_receiveMsgID == UARTTP_GetConfigRxMsgPHYID()))
+    {
+        result = TRUE;
+    }
+
+    return result;
+}
+#endif /* EN_UART_TP */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,102 @@
+/*
+ * @ : uart_tp_cfg.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef UART_TP_CFG_H_
+#define UART_TP_CFG_H_
+
+#include "includes.h"
+
+#ifdef EN_UART_TP
+#include "TP_cfg.h"
+
+/*******************************************************
+**  Description : UART TP configuration file
+**
+**  Frame: SOF | type | SN | data len | data | CRC high | CRC low
+**  CRC is CRC-16/CCITT (poly 0x1021, init 0xFFFF) of type, SN, data len and data.
+**  A UDS message is TX in one data frame, type is UDS message ID (RX FUN/RX PHY/TX RESP ID).
+**  Receiver ACK received data frames, SN of ACK is the last SN received in order.
+**  Sender TX max UART_TP_TX_WINDOW frames without ACK, and TX them again if no ACK.
+*******************************************************/
+
+#define UART_TP_SOF             (0xA5u)     /* Start of frame */
+#define UART_TP_ACK_TYPE        (0x80u)     /* ACK frame type, without data */
+#define UART_TP_SYNC_FLAG       (0x40u)     /* Data frame type flag, receiver take the SN as expected SN */
+#define UART_TP_TYPE_MASK       (0x3Fu)     /* Data frame type mask */
+
+#define UART_TP_FRAME_HEAD_LEN  (4u)        /* SOF + type + SN + data len */
+#define UART_TP_FRAME_CRC_LEN   (2u)        /* CRC16 */
+#define UART_TP_MAX_DATA_LEN    (TP_MAX_MSG_LEN)
+#define UART_TP_MAX_FRAME_LEN   (UART_TP_FRAME_HEAD_LEN + UART_TP_MAX_DATA_LEN + UART_TP_FRAME_CRC_LEN)
+
+#define UART_TP_TX_WINDOW       (2u)        /* Max TX frames waiting ACK */
+
+#define UART_TX_TP_QUEUE_ID     ('U')       /* UART TP TX queue ID */
+
+#if (UART_RX_FUN_ADDR_ID > UART_TP_TYPE_MASK) || (UART_RX_PHY_ADDR_ID > UART_TP_TYPE_MASK) || \
+    (UART_TX_RESP_ADDR_ID > UART_TP_TYPE_MASK)
+#error "UART TP message ID should not more than UART_TP_TYPE_MASK"
+#endif
+
+#if (UART_TP_MAX_DATA_LEN > 0xFFu)
+#error "UART TP data len is one byte in frame"
+#endif
+
+#if (!IsFifoLenValid(UART_RX_BUS_FIFO_LEN)) || (UART_RX_BUS_FIFO_LEN < UART_TP_MAX_FRAME_LEN)
+#error "UART RX BUS FIFO len should be power of 2 and not less than a frame"
+#endif
+
+#if (!IsFifoLenValid(UART_TX_BUS_FIFO_LEN)) || \
+    (FifoMaxMsgLen(UART_TX_BUS_FIFO_LEN) < (12u + UART_TP_MAX_FRAME_LEN))
+#error "UART TX BUS FIFO len should be power of 2 and not too small for a frame message (tTPTxMsgHeader + frame)"
+#endif
+
+typedef uint8 (*tUARTNetTx)(const uint8 *, const uint32);
+typedef uint32 (*tUARTNetRx)(uint8 *, const uint32);
+
+typedef struct
+{
+    uint8 ucCalledPeriod;       /* Called UART TP main function period */
+    tUdsId xRxFunId;            /* RX FUN ID, function request frame type */
+    tUdsId xRxPhyId;            /* RX PHY ID, physical request frame type */
+    tUdsId xTxId;               /* TX RESP ID, response frame type */
+    tNetTime xNAck;             /* Wait ACK max time, then TX frames without ACK again */
+    tNetTime xNByte;            /* Max time between two bytes of a frame, then drop the frame */
+    uint8 ucMaxRetry;           /* Max TX again times, then drop frames without ACK */
+    tUARTNetTx pfNetTx;         /* Net TX a frame with non blocking */
+    tUARTNetRx pfNetRx;         /* Net RX bytes */
+} tUdsUARTNetLayerCfg;
+
+/* UDS network layer config info */
+extern const tUdsUARTNetLayerCfg g_stUdsUARTNetLayerCfgInfo;
+
+/* UDS send message to UART TP queue */
+extern const tFifoHandle g_xUARTTxTPQueue;
+
+
+tUdsId UARTTP_GetConfigTxMsgID(void);
+
+tUdsId UARTTP_GetConfigRxMsgFUNID(void);
+
+tUdsId UARTTP_GetConfigRxMsgPHYID(void);
+
+tUARTNetTx UARTTP_GetConfigTxHandle(void);
+
+tUARTNetRx UARTTP_GetConfigRxHandle(void);
+
+boolean UARTTP_IsReceivedMsgIDValid(const uint32 i_receiveMsgID);
+
+uint32 UARTTP_DriverWriteDataInUARTTP(const uint32 i_dataLen, const uint8 *i_pDataBuf);
+
+boolean UARTTP_DriverReadDataFromUARTTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader);
+
+#endif /* EN_UART_TP */
+
+#endif /* UART_TP_CFG_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -11,9 +11,12 @@
 
 #include "uds_app.h"
 #include "TP.h"
-#include "Boot.h"
+#include "boot.h"
 #include "fls_app.h"
-#include "uds_alg_hal.h"
+#include "UDS_alg_hal.h"
+#ifdef EN_CAN_LIN_GATEWAY
+#include "LIN_gateway.h"
+#endif
 
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 #ifdef EN_DELAY_TIME
@@ -34,12 +37,9 @@ void UDS_Init(void)
 
 void UDS_MainFun(void)
 {
-    uint8 UDSSerIndex = 0u;
-    uint8 UDSSerNum = 0u;
-    tUdsAppMsgInfo stUdsAppMsg = {0u, 0u, {0u}, NULL_PTR};
-    uint8 isFindService = FALSE;
-    uint8 SupSerItem = 0u;
-    tUDSService *pstUDSService = NULL_PTR;
+    /* Static, a max UDS message may be too large for stack */
+    static tUdsAppMsgInfo s_stUdsAppMsg;
+    const tUDSService *pstUDSService = NULL_PTR;
 #if defined (EN_AES_SA_ALGORITHM_SW) || defined (EN_ZLG_SA_ALGORITHM)
     UDS_ALG_HAL_AddSWTimerTickCnt();
 #endif
@@ -51,12 +51,32 @@ void UDS_MainFun(void)
         /* Set security level. If S3server timeout, clear current security */
         SetSecurityLevel(NONE_SECURITY);
         Flash_InitDowloadInfo();
+        /* Tester is lost, stop long running service */
+        UDS_StopResponsePending();
+#ifdef EN_CAN_LIN_GATEWAY
+
+        if (TRUE == LINGW_IsRouting())
+        {
+            LINGW_StopRouting();
+        }
+
+#endif
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+        UDS_StopPeriodicDid();
+#endif
     }
 
+    /* TX NRC 0x78 of long running service */
+    UDS_ResponsePendingMainFun();
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+    /* TX periodic DIDs */
+    UDS_PeriodicDidMainFun();
+#endif
+
     /* Read data from can TP */
-    if (TRUE == TP_ReadAFrameDataFromTP(&stUdsAppMsg.xUdsId,
-                                        &stUdsAppMsg.xDataLen,
-                                        stUdsAppMsg.aDataBuf))
+    if (TRUE == TP_ReadAFrameDataFromTP(&s_stUdsAppMsg.xUdsId,
+                                        &s_stUdsAppMsg.xDataLen,
+                                        s_stUdsAppMsg.aDataBuf))
     {
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
         SetIsRxUdsMsg(TRUE);
@@ -69,77 +89,47 @@ void UDS_MainFun(void)
         }
 
         /* Save request ID type */
-        SaveRequestIdType(stUdsAppMsg.xUdsId);
+        SaveRequestIdType(s_stUdsAppMsg.xUdsId);
     }
     else
     {
         return;
     }
 
-    /* Get UDS service Information, start PTR and service item */
-    pstUDSService = GetUDSServiceInfo(&SupSerItem);
-    /* Get UDS service ID */
-    UDSSerNum = stUdsAppMsg.aDataBuf[0u];
+#ifdef EN_CAN_LIN_GATEWAY
 
-    while ((UDSSerIndex < SupSerItem) && (NULL_PTR != pstUDSService))
+    /* Routing to LIN slave, gateway response tester */
+    if (TRUE == LINGW_RouteRequest(s_stUdsAppMsg.xUdsId, s_stUdsAppMsg.xDataLen, s_stUdsAppMsg.aDataBuf))
     {
-        if (UDSSerNum == pstUDSService[UDSSerIndex].SerNum)
-        {
-            isFindService = TRUE;
-
-            if (TRUE != IsCurRxIdCanRequest(pstUDSService[UDSSerIndex].SupReqMode))
-            {
-                /* received ID can't request this service */
-                SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], NRC_SERVICE_NOT_SUPPORTED, &stUdsAppMsg);
-                break;
-            }
-
-            if (TRUE != IsCurSeesionCanRequest(pstUDSService[UDSSerIndex].SessionMode))
-            {
-                /* Current session mode can't request this service */
-                SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], NRC_SERVICE_NOT_SUPPORTED, &stUdsAppMsg);
-                break;
-            }
-
-            if (TRUE != IsCurSecurityLevelRequet(pstUDSService[UDSSerIndex].ReqLevel))
-            {
-                /* Current security level can't request this service */
-                SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], NRC_SERVICE_NOT_SUPPORTED, &stUdsAppMsg);
-                break;
-            }
-
-            stUdsAppMsg.pfUDSTxMsgServiceCallBack = NULL_PTR;
-
-            /* Find service and do it */
-            if (NULL_PTR != pstUDSService[UDSSerIndex].pfSerNameFun)
-            {
-                pstUDSService[UDSSerIndex].pfSerNameFun((tUDSService *)&pstUDSService[UDSSerIndex], &stUdsAppMsg);
-            }
-            else
-            {
-                /* Current security level cann't request this service */
-                SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], NRC_SERVICE_NOT_SUPPORTED, &stUdsAppMsg);
-            }
-
-            break;
-        }
-
-        UDSSerIndex++;
+        return;
     }
 
-    if (TRUE != isFindService)
+#endif
+
+    s_stUdsAppMsg.pfUDSTxMsgServiceCallBack = NULL_PTR;
+
+    /* Get UDS service Information by SID */
+    pstUDSService = GetUDSServiceInfo(s_stUdsAppMsg.aDataBuf[0u]);
+
+    if ((NULL_PTR == pstUDSService) ||
+            (TRUE != IsCurPermissionCanRequest(pstUDSService->PermissionMask)))
+    {
+        /* Service not supported, or received ID, current session mode or security level can't request this service */
+        SetNegativeErroCode(s_stUdsAppMsg.aDataBuf[0u], NRC_SERVICE_NOT_SUPPORTED, &s_stUdsAppMsg);
+    }
+    else
     {
-        /* Response not support service */
-        SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], NRC_SERVICE_NOT_SUPPORTED, &stUdsAppMsg);
+        /* Find service and do it */
+        pstUDSService->pfSerNameFun((tUDSService *)pstUDSService, &s_stUdsAppMsg);
     }
 
-    if (0u != stUdsAppMsg.xDataLen)
+    if (0u != s_stUdsAppMsg.xDataLen)
     {
-        stUdsAppMsg.xUdsId = TP_GetConfigTxMsgID();
-        (void)TP_WriteAFrameDataInTP(stUdsAppMsg.xUdsId,
-                                     stUdsAppMsg.pfUDSTxMsgServiceCallBack,
-                                     stUdsAppMsg.xDataLen,
-                                     stUdsAppMsg.aDataBuf);
+        s_stUdsAppMsg.xUdsId = TP_GetConfigTxMsgID();
+        (void)TP_WriteAFrameDataInTP(s_stUdsAppMsg.xUdsId,
+                                     s_stUdsAppMsg.pfUDSTxMsgServiceCallBack,
+                                     s_stUdsAppMsg.xDataLen,
+                                     s_stUdsAppMsg.aDataBuf);
     }
 }
 
@@ -14,13 +14,34 @@
 #include "fls_app.h"
 #include "boot.h"
 #include "watchdog_hal.h"
-#include "uds_alg_hal.h"
+#include "UDS_alg_hal.h"
+#include "CRC_hal.h"
+#ifdef EN_LZSS_DECOMPRESS
+#include "LZSS.h"
+#endif
+#ifdef EN_AES_CTR_DECRYPT
+#include "AES_CTR.h"
+#endif
+#ifdef EN_DELTA_UPDATE
+#include "Delta.h"
+#endif
+#ifdef EN_CAN_LIN_GATEWAY
+#include "LIN_gateway.h"
+#endif
+#if (defined EN_DOWNLOAD_STATISTICS) && (defined EN_CAN_TP)
+#include "can_tp.h"
+#endif
+#ifdef EN_PERIODIC_DID
+#include "can_tp_cfg.h"
+#endif
 
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 typedef struct
 {
     uint32 StartAddr; /* Data start address */
     uint32 DataLen;   /* Data len */
+    uint8 CompressionMethod; /* compressionMethod of dataFormatIdentifier, DataLen is decompressed len */
+    uint8 EncryptingMethod;  /* encryptingMethod of dataFormatIdentifier */
 } tDowloadDataInfo;
 
 /* Define security access info */
@@ -43,15 +64,192 @@ typedef struct
     void (*pfRoutine)(void); /* Routine */
 } tWriteDataByIdentifierInfo;
 
-typedef enum
+/* Define routine control, routine is found by sub-function and RID */
+typedef struct
+{
+    uint8 Subfunction;       /* Sub-function */
+    uint16 RoutineId;        /* RID */
+    void (*pfRoutine)(struct UDSServiceInfo *, tUdsAppMsgInfo *);   /* Routine */
+} tRoutineControlInfo;
+
+/* Define data identifier, routine is found by DID */
+typedef struct
+{
+    uint16 DataId;           /* DID */
+    void (*pfRoutine)(struct UDSServiceInfo *, tUdsAppMsgInfo *);   /* Routine */
+} tDataIdentifierInfo;
+
+/* Define read data identifier, routine encodes DataLen bytes of the DID data */
+typedef struct
+{
+    uint16 DataId;           /* DID */
+    uint8 DataLen;           /* Data len */
+    uint8 RequestSession;    /* Request session */
+    uint8 RequestLevel;      /* Security mask, see UNLOCKED_SECURITY_LEVEL_1 */
+    uint8 (*pfReadData)(uint8 *);   /* Routine, return FALSE if data is not available */
+} tReadDataIdentifierInfo;
+
+/* Max DIDs of a ReadDataByIdentifier request */
+#define READ_DID_MAX_NUM (8u)
+
+/* DID data len, response of a DID is SID + DID + data */
+#define DID_APP_COUNTER_LEN (1u)
+#define DID_TRANSFER_STATISTICS_LEN (16u)
+#define DID_FLASH_JOB_TIME_LEN (12u)
+#define DID_CAN_TP_ERROR_CNT_LEN (10u)
+#define DID_TP_QUEUE_STATISTICS_LEN (12u)
+
+#if (FL_FINGER_PRINT_LENGTH > (UDS_MAX_MSG_LEN - 3u)) || (DID_TRANSFER_STATISTICS_LEN > (UDS_MAX_MSG_LEN - 3u))
+#error "DID data len should be not more than a UDS message"
+#endif
+
+#ifdef EN_PERIODIC_DID
+/* Periodic DID is 0xF200 + pDID, periodic frame is pDID + data in a CAN frame */
+#define PERIODIC_DID_BASE (0xF200u)
+#define PERIODIC_DID_MAX_DATA_LEN (7u)
+
+/* Max scheduled pDIDs */
+#define PERIODIC_DID_MAX_NUM (4u)
+
+/* Periodic DID data len */
+#define DID_FLASH_JOB_STATE_LEN (6u)
+#define DID_FLASH_PROGRESS_LEN (5u)
+#define DID_FLASH_POSITION_LEN (6u)
+
+#if (DID_FLASH_JOB_STATE_LEN > PERIODIC_DID_MAX_DATA_LEN) || (DID_FLASH_PROGRESS_LEN > PERIODIC_DID_MAX_DATA_LEN) || \
+    (DID_FLASH_POSITION_LEN > PERIODIC_DID_MAX_DATA_LEN)
+#error "Periodic DID data len should be in a single frame with pDID"
+#endif
+
+/* transmissionMode of ReadDataByPeriodicIdentifier */
+#define PERIODIC_SEND_AT_SLOW_RATE (1u)
+#define PERIODIC_SEND_AT_MEDIUM_RATE (2u)
+#define PERIODIC_SEND_AT_FAST_RATE (3u)
+#define PERIODIC_STOP_SENDING (4u)
+
+/* Scheduled periodic DID */
+typedef struct
+{
+    const tReadDataIdentifierInfo *pstDid;  /* Scheduled DID, NULL_PTR is a free slot */
+    tUdsTime xPeriod;                       /* TX period */
+    tUdsTime xTimer;                        /* Time of TX next frame */
+} tPeriodicDidInfo;
+
+/* Last negative response, except NRC 0x78 */
+typedef struct
+{
+    uint8 SerNum;           /* Service ID */
+    uint8 NegativeCode;     /* NRC */
+} tLastNegativeResponse;
+#endif
+
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Download statistics after bootloader start */
+typedef struct
+{
+    uint32 ReceivedBytes;    /* TransferData received data bytes, before decrypted or decompressed */
+    uint32 BlockCnt;         /* TransferData blocks responded positive */
+    uint32 RejectedBlockCnt; /* TransferData blocks responded negative */
+} tDownloadStatistics;
+#endif
+
+/* Last TransferData block responded positive, its response may be lost and the block is repeated */
+typedef struct
 {
-    ERASE_MEMORY_ROUTINE_CONTROL,    /* Check erase memory routine control */
-    CHECK_SUM_ROUTINE_CONTROL,       /* Check sum routine control */
-    CHECK_DEPENDENCY_ROUTINE_CONTROL /* Check dependency routine control */
-} tCheckRoutineCtlInfo;
+    boolean IsValid;        /* Block is responded positive */
+    uint8 BlockNum;         /* blockSequenceCounter */
+    uint32 DataLen;         /* Block data len */
+    uint32 Crc;             /* CRC of block data, before decrypted */
+} tLastTransferBlockInfo;
 
 #define DOWLOAD_DATA_ADDR_LEN (4u) /* Download data addr len */
 #define DOWLOAD_DATA_LEN (4u)      /* Download data len */
+
+/* Block data is aligned to flash phrase, next block start address is aligned too */
+#define DOWLOAD_BLOCK_ALIGN (8u)
+
+/* Max data len of a TransferData block, limited by UDS message (SID + counter + data) and program buffer */
+#define DOWLOAD_BLOCK_DATA_LEN \
+    ((((UDS_MAX_MSG_LEN - 2u) < MAX_FLASH_DATA_LEN) ? (UDS_MAX_MSG_LEN - 2u) : MAX_FLASH_DATA_LEN) & \
+     (~(DOWLOAD_BLOCK_ALIGN - 1u)))
+
+/* TODO Bootloader: #05 maxNumberOfBlockLength includes SID and counter, e.g. ZCANPRO transfers block len - 2 data */
+#define DOWLOAD_MAX_BLOCK_LEN (DOWLOAD_BLOCK_DATA_LEN + 2u)
+
+/* Bytes of maxNumberOfBlockLength in RequestDownload response, high nibble of lengthFormatIdentifier */
+#define DOWLOAD_MAX_BLOCK_LEN_LEN (2u)
+
+#if (DOWLOAD_BLOCK_DATA_LEN < DOWLOAD_BLOCK_ALIGN) || \
+    (DOWLOAD_MAX_BLOCK_LEN > ((1uL << (8u * DOWLOAD_MAX_BLOCK_LEN_LEN)) - 1u)) || \
+    (DOWLOAD_MAX_BLOCK_LEN > UDS_MAX_MSG_LEN) || (DOWLOAD_BLOCK_DATA_LEN > MAX_FLASH_DATA_LEN)
+#error "TransferData block len is invalid, check TP_MAX_MSG_LEN and MAX_FLASH_DATA_LEN"
+#endif
+
+#define DOWLOAD_NOT_COMPRESSED (0u)  /* compressionMethod: not compressed */
+#define DOWLOAD_NOT_ENCRYPTED (0u)   /* encryptingMethod: not encrypted */
+
+#ifdef EN_UPLOAD_MEMORY
+/* Define readable memory range of RequestUpload and ReadMemoryByAddress */
+typedef struct
+{
+    uint32 StartAddr;        /* Range start address */
+    uint32 EndAddr;          /* Range end address, not included */
+    uint8 RequestSession;    /* Request session */
+    uint8 RequestLevel;      /* Security mask, see UNLOCKED_SECURITY_LEVEL_1 */
+} tReadMemoryRangeInfo;
+
+/* Upload data info, TransferData reads a block at start addr */
+typedef struct
+{
+    boolean IsUploading;     /* RequestUpload is accepted, TransferData and RequestTransferExit are upload */
+    uint32 StartAddr;        /* Next block address */
+    uint32 DataLen;          /* Remain data len */
+    uint32 BlockDataLen;     /* Data len of the last block, read again if the last block is requested again */
+    uint8 BlockNum;          /* The last block sequence counter */
+} tUploadDataInfo;
+
+/* maxNumberOfBlockLength of RequestUpload, TransferData response is SID + counter + data */
+#define UPLOAD_MAX_BLOCK_LEN (UDS_MAX_MSG_LEN)
+
+/* Max memory size of ReadMemoryByAddress, response is SID + data */
+#define READ_MEMORY_MAX_LEN (UDS_MAX_MSG_LEN - 1u)
+
+#if (UPLOAD_MAX_BLOCK_LEN > ((1uL << (8u * DOWLOAD_MAX_BLOCK_LEN_LEN)) - 1u))
+#error "RequestUpload maxNumberOfBlockLength is more than DOWLOAD_MAX_BLOCK_LEN_LEN bytes"
+#endif
+#endif
+
+#ifdef EN_LZSS_DECOMPRESS
+/* Decompressed data is staged and programmed in DOWLOAD_BLOCK_DATA_LEN chunks, address keeps aligned */
+typedef struct
+{
+    uint32 DataLen;                             /* Staged data len */
+    uint8 aDataBuf[DOWLOAD_BLOCK_DATA_LEN];     /* Staged data */
+} tDecompressDataInfo;
+#endif
+
+#ifdef EN_DELTA_UPDATE
+/* Patch is decompressed in chunks, then applied to installed APP */
+#define DELTA_PATCH_BUF_LEN (64u)
+
+typedef struct
+{
+    uint32 SourceAddr;                          /* Installed APP address of download start address */
+    const uint8 *pInBuf;                        /* Block data */
+    uint32 InLen;                               /* Block data len */
+    uint32 InPos;                               /* Decompressed block data len */
+    uint32 PatchLen;                            /* Decompressed patch len */
+    uint32 PatchPos;                            /* Applied patch len */
+    uint8 aPatchBuf[DELTA_PATCH_BUF_LEN];       /* Decompressed patch */
+#ifndef EN_SUPPORT_APP_B
+    uint8 BlockNum;                             /* Block sequence counter, responded after sectors are updated */
+    uint32 SectorAddr;                          /* Staged sector address */
+    uint32 SectorDataLen;                       /* Staged download data len in sector */
+    uint8 aInBuf[DOWLOAD_BLOCK_DATA_LEN];       /* Block data copy, UDS message may be overwritten when sector is updated */
+    uint8 aSectorBuf[FLASH_SECTOR_LEN];         /* Staged sector, not downloaded data is 0xFF */
+#endif
+} tDeltaDataInfo;
+#endif
 #endif
 
 /* Support function/physical ID request */
@@ -66,6 +264,8 @@ const tUdsTimeInfo gs_stUdsAppCfg =
     1u,
     3u,
     10000u,
+    5000u,
+    50u,
     5000u
 };
 
@@ -76,6 +276,13 @@ uint32 UDS_GetUDSS3WatermarkTimerMs(void)
     return (uint32)watermarkTimerMs;
 }
 
+/* Get UDS P2* water mark timer. return P2* * P2_TIMER_WATERMARK_PERCENT / 100 */
+uint32 UDS_GetUDSP2ExtWatermarkTimerMs(void)
+{
+    const uint32 watermarkTimerMs = (gs_stUdsAppCfg.xP2ExtServer * P2_TIMER_WATERMARK_PERCENT) / 100u;
+    return (uint32)watermarkTimerMs;
+}
+
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 #ifdef EN_DELAY_TIME
 tJumpAppDelayTimeInfo gs_stJumpAPPDelayTimeInfo = {FALSE, 0u};
@@ -101,6 +308,23 @@ typedef struct
     tUdsTime xSecurityReqLockTime;  /* Security request lock time */
 } tUdsInfo;
 
+/* Response pending status */
+typedef enum
+{
+    RESPONSE_PENDING_IDLE,      /* No long running service */
+    RESPONSE_PENDING_TIMING,    /* Wait P2/P2* water mark */
+    RESPONSE_PENDING_TX         /* NRC 0x78 is TX */
+} tResponsePendingStatus;
+
+typedef struct
+{
+    uint8 SerNum;                       /* Long running service ID */
+    tResponsePendingStatus eStatus;     /* Response pending status */
+    tUdsTime xPendingTime;              /* Time of TX next NRC 0x78 */
+    void (*pfTxCallBack)(uint8);        /* Called after NRC 0x78 TX successful, job requested more time */
+    tTPChannel eChannel;                /* TP channel received the request, NRC 0x78 and final response are TX on it */
+} tUdsResponsePendingInfo;
+
 /***********************UDS Information Static Global value************************/
 /* UDS support Session mode? RequestId and Security level config */
 static tUdsInfo gs_stUdsInfo =
@@ -112,6 +336,16 @@ static tUdsInfo gs_stUdsInfo =
     0u,
 };
 
+/* Long running service response pending info */
+static tUdsResponsePendingInfo gs_stUdsResponsePendingInfo =
+{
+    0u,
+    RESPONSE_PENDING_IDLE,
+    0u,
+    NULL_PTR,
+    (tTPChannel)0u,
+};
+
 static tUdsTime GetUdsS3ServerTime(void)
 {
     return (gs_stUdsInfo.xUdsS3ServerTime);
@@ -175,21 +409,59 @@ static void AppMemcopy(const void *i_pvSource, const uint8 i_CopyLen, void *o_pv
 /* APP memset */
 static void AppMemset(const uint8 i_SetValue, const uint16 i_Len, void *m_pvSource);
 
-/* Check routine control right? */
-static uint8 IsCheckRoutineControlRight(const tCheckRoutineCtlInfo i_eCheckRoutineCtlId,
-                                        const tUdsAppMsgInfo *m_pstPDUMsg);
+/* Erase memory routine */
+static void EraseMemoryRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/* Check sum routine */
+static void CheckSumRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/* Check programming dependency routine */
+static void CheckProgrammingDependencyRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+#ifdef EN_CAN_LIN_GATEWAY
+/* Start/stop routing to LIN slave routine */
+static void StartLINGatewayRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+static void StopLINGatewayRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+#endif
+
+/* Write finger print */
+static void WriteFingerprint(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/* Read finger print of the newest APP */
+static uint8 ReadFingerprint(uint8 *o_pDataBuf);
 
-/* Is erase memory routine control? */
-static uint8 IsEraseMemoryRoutineControl(const tUdsAppMsgInfo *m_pstPDUMsg);
+/* Read APP counter of the newest APP */
+static uint8 ReadAppCounter(uint8 *o_pDataBuf);
 
-/* Is check sum routine control? */
-static uint8 IsCheckSumRoutineControl(const tUdsAppMsgInfo *m_pstPDUMsg);
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Read received bytes, blocks and programmed bytes */
+static uint8 ReadTransferStatistics(uint8 *o_pDataBuf);
 
-/* Is check programming dependency? */
-static uint8 IsCheckProgrammingDependency(const tUdsAppMsgInfo *m_pstPDUMsg);
+/* Read erase, program and check sum time */
+static uint8 ReadFlashJobTime(uint8 *o_pDataBuf);
 
-/* Is write finger print right? */
-static uint8 IsWriteFingerprintRight(const tUdsAppMsgInfo *m_pstPDUMsg);
+#ifdef EN_CAN_TP
+/* Read CAN TP error counters */
+static uint8 ReadCanTpErrorCnt(uint8 *o_pDataBuf);
+#endif
+#endif
+
+#ifdef EN_FIFO_STATISTICS
+/* Read TP queue max used len */
+static uint8 ReadTPQueueStatistics(uint8 *o_pDataBuf);
+#endif
+
+#ifdef EN_PERIODIC_DID
+/* Read download step, flash job and error codes */
+static uint8 ReadFlashJobState(uint8 *o_pDataBuf);
+
+/* Read programmed bytes and percent */
+static uint8 ReadFlashProgress(uint8 *o_pDataBuf);
+
+/* Read flash address and sector of the job */
+static uint8 ReadFlashPosition(uint8 *o_pDataBuf);
+#endif
 
 /* Is download data address valid? */
 static uint8 IsDownloadDataAddrValid(const uint32 i_DataAddr);
@@ -202,12 +474,6 @@ static uint8 IsReceivedKeyRight(const uint8 *i_pReceivedKey,
                                 const uint8 *i_pTxSeed,
                                 const uint8 KeyLen);
 
-/* Do check sum. If check sum right return TRUE, else return FALSE. */
-static void DoCheckSum(uint8 i_TxStatus);
-
-/* Do erase flash */
-static void DoEraseFlash(uint8 i_TxStatus);
-
 /* Do check programming dependency */
 static uint8 DoCheckProgrammingDependency(void);
 
@@ -217,8 +483,11 @@ static void DoResponseChecksum(uint8 i_Status);
 /* Do erase flash response */
 static void DoEraseFlashResponse(uint8 i_Status);
 
+/* Do routine control start routine response */
+static void DoRoutineControlResponse(const uint16 i_RoutineId, const uint8 i_Status);
+
 /* When do UDS service need more time, need call the function */
-static void RequestMoreTime(const uint8 UDSServiceID, void (*pcallback)(uint8));
+static boolean RequestMoreTime(const uint8 UDSServiceID, const uint32 i_TimeMs, void (*pcallback)(uint8));
 #endif
 
 /* Do reset MCU */
@@ -237,6 +506,14 @@ static void CommunicationControl(struct UDSServiceInfo *i_pstUDSServiceInfo, tUd
 /* Security access */
 static void SecurityAccess(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
 
+/* Read data by identifier */
+static void ReadDataByIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+#ifdef EN_PERIODIC_DID
+/* Read data by periodic identifier */
+static void ReadDataByPeriodicIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+#endif
+
 /* Write data by identifier */
 static void WriteDataByIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
 
@@ -249,6 +526,14 @@ static void TransferData(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgI
 /* Request transfer exit */
 static void RequestTransferExit(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
 
+#ifdef EN_UPLOAD_MEMORY
+/* Request upload */
+static void RequestUpload(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/* Read memory by address */
+static void ReadMemoryByAddress(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+#endif
+
 /* Routine control */
 static void RoutineControl(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
 
@@ -259,122 +544,183 @@ static void ResetECU(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo
 static void TesterPresent(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
 
 /***********************UDS service Static Global value************************/
+/* SID indexed service entry, permission mask is combined at compile time. SID not in table is not supported. */
+#define UDS_SERVICE(xSerNum, xSessionMode, xSupReqMode, xReqLevel, pfSerNameFun) \
+    [(xSerNum)] = {(xSerNum), UDS_PermissionMask((xSessionMode), (xSupReqMode), (xReqLevel)), (pfSerNameFun)}
+
 /* XXX Bootloader: #00 UDS Service Configuration Table */
-static const tUDSService gs_astUDSService[] =
+static const tUDSService gs_astUDSService[UDS_SID_NUM] =
 {
     /* Diagnose mode control */
-    {
-        0x10u,
-        DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
-        SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
-        NONE_SECURITY,
-        DigSession
-    },
+    UDS_SERVICE(0x10u,
+                DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
+                NONE_SECURITY,
+                DigSession),
 
     /* Communication control */
-    {
-        0x28u,
-        DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
-        SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
-        NONE_SECURITY,
-        CommunicationControl
-    },
+    UDS_SERVICE(0x28u,
+                DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
+                NONE_SECURITY,
+                CommunicationControl),
 
     /* Control DTC setting */
-    {
-        0x85u,
-        DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
-        SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
-        NONE_SECURITY,
-        ControlDTCSetting
-    },
+    UDS_SERVICE(0x85u,
+                DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
+                NONE_SECURITY,
+                ControlDTCSetting),
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
     /* Security access */
-    {
-        0x27u,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR,
-        NONE_SECURITY,
-        SecurityAccess
-    },
+    UDS_SERVICE(0x27u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                NONE_SECURITY,
+                SecurityAccess),
+
+    /* Read data by identifier, DID permission is checked too */
+    UDS_SERVICE(0x22u,
+                DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                ReadDataByIdentifier),
+#ifdef EN_PERIODIC_DID
+    /* Read data by periodic identifier, DID permission is checked too */
+    UDS_SERVICE(0x2Au,
+                PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                ReadDataByPeriodicIdentifier),
+#endif
 
     /* Write data by identifier */
-    {
-        0x2Eu,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR,
-        SECURITY_LEVEL_1,
-        WriteDataByIdentifier
-    },
+    UDS_SERVICE(0x2Eu,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                WriteDataByIdentifier),
 
     /* Request download data */
-    {
-        0x34u,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR,
-        SECURITY_LEVEL_1,
-        RequestDownload
-    },
+    UDS_SERVICE(0x34u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                RequestDownload),
 
     /* Transfer data */
-    {
-        0x36u,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR,
-        SECURITY_LEVEL_1,
-        TransferData
-    },
+    UDS_SERVICE(0x36u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                TransferData),
 
     /* Request exit transfer data */
-    {
-        0x37u,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR,
-        SECURITY_LEVEL_1,
-        RequestTransferExit
-    },
+    UDS_SERVICE(0x37u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                RequestTransferExit),
+#ifdef EN_UPLOAD_MEMORY
+    /* Request upload data */
+    UDS_SERVICE(0x35u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                RequestUpload),
+
+    /* Read memory by address, memory range permission is checked too */
+    UDS_SERVICE(0x23u,
+                PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                ReadMemoryByAddress),
+#endif
 
     /* Routine control */
-    {
-        0x31u,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR,
-        SECURITY_LEVEL_1,
-        RoutineControl
-    },
+    UDS_SERVICE(0x31u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR,
+                SECURITY_LEVEL_1,
+                RoutineControl),
 
     /* Reset ECU */
-    {
-        0x11u,
-        PROGRAM_SESSION,
-        SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
-        SECURITY_LEVEL_1,
-        ResetECU
-    },
+    UDS_SERVICE(0x11u,
+                PROGRAM_SESSION,
+                SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
+                SECURITY_LEVEL_1,
+                ResetECU),
 #endif
     /* Tester present service */
-    {
-        0x3Eu,
-        DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
-        SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
-        NONE_SECURITY,
-        TesterPresent
-    },
+    UDS_SERVICE(0x3Eu,
+                DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
+                SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
+                NONE_SECURITY,
+                TesterPresent),
 };
 
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 /* UDS service sub function config table */
-/* Erase memory routine control ID */
-static const uint8 gs_aEraseMemoryRoutineControlId[] = {0x31u, 0x01u, 0xFFu, 0x00u};
+#define ERASE_MEMORY_ROUTINE_ID         (0xFF00u)   /* Erase memory RID */
+#define CHECK_SUM_ROUTINE_ID            (0x0202u)   /* Check sum RID */
+#define CHECK_DEPENDENCY_ROUTINE_ID     (0xFF01u)   /* Check programming dependency RID */
+
+/* Routine control table: sub-function, RID and routine */
+static const tRoutineControlInfo gs_astRoutineControlInfo[] =
+{
+    {0x01u, ERASE_MEMORY_ROUTINE_ID, EraseMemoryRoutine},                 /* Erase memory */
+    {0x01u, CHECK_SUM_ROUTINE_ID, CheckSumRoutine},                       /* Check sum */
+    {0x01u, CHECK_DEPENDENCY_ROUTINE_ID, CheckProgrammingDependencyRoutine}, /* Check programming dependency */
+#ifdef EN_CAN_LIN_GATEWAY
+    {0x01u, (uint16)((LIN_GW_ROUTINE_ID_H << 8u) | LIN_GW_ROUTINE_ID_L), StartLINGatewayRoutine},  /* Start routing to LIN slave */
+    {0x02u, (uint16)((LIN_GW_ROUTINE_ID_H << 8u) | LIN_GW_ROUTINE_ID_L), StopLINGatewayRoutine},   /* Stop routing to LIN slave */
+#endif
+};
+
+/* Write data by identifier table: DID and routine */
+static const tDataIdentifierInfo gs_astWriteDataIdentifierInfo[] =
+{
+    {0xF15Au, WriteFingerprint},                            /* Write finger print */
+};
 
-/* Check sum routine control ID */
-static const uint8 gs_aCheckSumRoutineControlId[] = {0x31u, 0x01u, 0x02u, 0x02u};
+/* TODO Bootloader: #12 Read data by identifier table: DID, data len, session, security mask and routine.
+   Identification DIDs are public (NONE_SECURITY), telemetry DIDs need security access. */
+static const tReadDataIdentifierInfo gs_astReadDataIdentifierInfo[] =
+{
+    {0xF15Au, FL_FINGER_PRINT_LENGTH, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, NONE_SECURITY, ReadFingerprint},    /* Finger print */
+    {0xFD00u, DID_APP_COUNTER_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, NONE_SECURITY, ReadAppCounter},       /* APP counter */
+#ifdef EN_DOWNLOAD_STATISTICS
+    {0xFD01u, DID_TRANSFER_STATISTICS_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadTransferStatistics}, /* Transfer statistics */
+    {0xFD02u, DID_FLASH_JOB_TIME_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadFlashJobTime},   /* Flash job time */
+#ifdef EN_CAN_TP
+    {0xFD03u, DID_CAN_TP_ERROR_CNT_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadCanTpErrorCnt}, /* CAN TP error counters */
+#endif
+#endif
+#ifdef EN_FIFO_STATISTICS
+    {0xFD04u, DID_TP_QUEUE_STATISTICS_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadTPQueueStatistics}, /* TP queue statistics */
+#endif
+#ifdef EN_PERIODIC_DID
+    {0xF201u, DID_FLASH_JOB_STATE_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadFlashJobState},  /* Flash job state and error codes, pDID 0x01 */
+    {0xF202u, DID_FLASH_PROGRESS_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadFlashProgress},   /* Programmed bytes and percent, pDID 0x02 */
+    {0xF203u, DID_FLASH_POSITION_LEN, DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1, ReadFlashPosition},   /* Flash address and sector, pDID 0x03 */
+#endif
+};
 
-/* Check programming dependency */
-static const uint8 gs_aCheckProgrammingDependencyId[] = {0x31u, 0x01u, 0xFFu, 0x01u};
+#ifdef EN_PERIODIC_DID
+/* TODO Bootloader: #13 ReadDataByPeriodicIdentifier slow, medium and fast rate (ms), pDIDs are 0xF2xx DIDs of the table above */
+static const tUdsTime gs_axPeriodicRateMs[PERIODIC_STOP_SENDING - 1u] = {1000u, 200u, 50u};
+#endif
 
-/* Write finger print ID */
-static const uint8 gs_aWriteFingerprintId[] = {0x2Eu, 0xF1u, 0x5Au};
+#ifdef EN_UPLOAD_MEMORY
+/* TODO Bootloader: #11 Readable memory ranges of RequestUpload and ReadMemoryByAddress, bootloader is not readable */
+static const tReadMemoryRangeInfo gs_astReadMemoryRangeInfo[] =
+{
+    {APP_A_START_ADDR, APP_A_END_ADDR, PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1},    /* APP A */
+#ifdef EN_SUPPORT_APP_B
+    {APP_B_START_ADDR, APP_B_END_ADDR, PROGRAM_SESSION | EXTEND_SESSION, UNLOCKED_SECURITY_LEVEL_1},    /* APP B */
+#endif
+};
+#endif
 #endif
 
 /**********************UDS service correlation main function realizing************************/
@@ -382,6 +728,9 @@ static const uint8 gs_aWriteFingerprintId[] = {0x2Eu, 0xF1u, 0x5Au};
 static void DigSession(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
 {
     uint8 RequestSubfunction = 0u;
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+    const uint8 OldSessionMode = gs_stUdsInfo.CurSessionMode;
+#endif
     ASSERT(NULL_PTR == m_pstPDUMsg);
     ASSERT(NULL_PTR == i_pstUDSServiceInfo);
     RequestSubfunction = m_pstPDUMsg->aDataBuf[1u];
@@ -445,6 +794,16 @@ static void DigSession(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInf
             SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
             break;
     }
+
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+
+    /* Session is changed, stop periodic DIDs scheduled in the old session */
+    if (OldSessionMode != gs_stUdsInfo.CurSessionMode)
+    {
+        UDS_StopPeriodicDid();
+    }
+
+#endif
 }
 
 /* Control DTC setting */
@@ -559,243 +918,1568 @@ static void SecurityAccess(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMs
     }
 }
 
-/* Write data by identifier */
-static void WriteDataByIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+/* Read data by identifier. DIDs are responded in request order, DID not supported in active session is skipped. */
+static void ReadDataByIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
 {
+    uint8 Index = 0u;
+    uint8 DidIndex = 0u;
+    uint8 DidNum = 0u;
+    uint16 aDataId[READ_DID_MAX_NUM] = {0u};
+    uint32 ResponseLen = 1u;
+    uint8 NegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+    const tReadDataIdentifierInfo *pstDid = NULL_PTR;
     ASSERT(NULL_PTR == m_pstPDUMsg);
     ASSERT(NULL_PTR == i_pstUDSServiceInfo);
 
-    /* Is write finger print ID right? */
-    if (TRUE == IsWriteFingerprintRight(m_pstPDUMsg))   //
-    {
-        /* Do write finger print */
-        Flash_SaveFingerPrint(&m_pstPDUMsg->aDataBuf[3u], (m_pstPDUMsg->xDataLen - 3u));
-        m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
-        m_pstPDUMsg->aDataBuf[1u] = 0xF1u;
-        m_pstPDUMsg->aDataBuf[2u] = 0x5Au;
-        m_pstPDUMsg->xDataLen = 3u;
-    }
-    else
+    /* Request is SID + DIDs */
+    if ((m_pstPDUMsg->xDataLen < 3u) || (0u == (m_pstPDUMsg->xDataLen & 0x01u)) ||
+            (((m_pstPDUMsg->xDataLen - 1u) >> 1u) > READ_DID_MAX_NUM))
     {
-        /* Don't have this routine control ID */
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        return;
     }
-}
-
-/* Download data info */
-static tDowloadDataInfo gs_stDowloadDataInfo = {0u, 0u};
-
-/* Received block number */
-static uint8 gs_RxBlockNum = 0u;
 
-/* Request download */
-static void RequestDownload(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    uint8 Index = 0u;
-    uint8 Ret = TRUE;
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    /* Response is written in request buffer, save DIDs first */
+    DidNum = (uint8)((m_pstPDUMsg->xDataLen - 1u) >> 1u);
 
-    if (m_pstPDUMsg->xDataLen < (DOWLOAD_DATA_ADDR_LEN + DOWLOAD_DATA_LEN + 1u + 2u))
+    for (DidIndex = 0u; DidIndex < DidNum; DidIndex++)
     {
-        Ret = FALSE;
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        aDataId[DidIndex] = (uint16)(((uint16)m_pstPDUMsg->aDataBuf[1u + (DidIndex << 1u)] << 8u) |
+                                     m_pstPDUMsg->aDataBuf[2u + (DidIndex << 1u)]);
     }
 
-    if (TRUE == Ret)
+    for (DidIndex = 0u; DidIndex < DidNum; DidIndex++)
     {
-        /* Get data addr */
-        gs_stDowloadDataInfo.StartAddr = 0u;
+        pstDid = NULL_PTR;
 
-        for (Index = 0u; Index < DOWLOAD_DATA_ADDR_LEN; Index++)
+        /* Find DID in read data identifier table */
+        for (Index = 0u; Index < (sizeof(gs_astReadDataIdentifierInfo) / sizeof(gs_astReadDataIdentifierInfo[0u])); Index++)
         {
-            gs_stDowloadDataInfo.StartAddr <<= 8u;
-            /* 3u = N_PCI(1) + SID34(1) + dataFormatldentifier(1) */
-            gs_stDowloadDataInfo.StartAddr |= m_pstPDUMsg->aDataBuf[Index + 3u];
+            if ((aDataId[DidIndex] == gs_astReadDataIdentifierInfo[Index].DataId) &&
+                    (TRUE == IsCurSeesionCanRequest(gs_astReadDataIdentifierInfo[Index].RequestSession)))
+            {
+                pstDid = &gs_astReadDataIdentifierInfo[Index];
+                break;
+            }
         }
 
-        /* Get data len */
-        gs_stDowloadDataInfo.DataLen = 0u;
-
-        for (Index = 0u; Index < DOWLOAD_DATA_LEN; Index++)
+        if (NULL_PTR != pstDid)
         {
-            gs_stDowloadDataInfo.DataLen <<= 8u;
-            gs_stDowloadDataInfo.DataLen |= m_pstPDUMsg->aDataBuf[Index + 7u];
+            if (TRUE != IsCurSecurityLevelInMask(pstDid->RequestLevel))
+            {
+                NegativeCode = NRC_SECURITY_ACCESS_DENIED;
+                break;
+            }
+
+            /* DID and data should be in the response */
+            if ((ResponseLen + 2u + pstDid->DataLen) > UDS_MAX_MSG_LEN)
+            {
+                NegativeCode = NRC_RESPONSE_TOO_LONG;
+                break;
+            }
+
+            if (TRUE != pstDid->pfReadData(&m_pstPDUMsg->aDataBuf[ResponseLen + 2u]))
+            {
+                NegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+                break;
+            }
+
+            m_pstPDUMsg->aDataBuf[ResponseLen] = (uint8)(pstDid->DataId >> 8u);
+            m_pstPDUMsg->aDataBuf[ResponseLen + 1u] = (uint8)pstDid->DataId;
+            ResponseLen += 2u + pstDid->DataLen;
         }
     }
 
-    /* Is download data addr and len valid? */
-    if (((TRUE != IsDownloadDataAddrValid(gs_stDowloadDataInfo.StartAddr)) ||
-            (TRUE != IsDownloadDataLenValid(gs_stDowloadDataInfo.DataLen))) && (TRUE == Ret))
+    /* Failed or no DID is supported */
+    if ((DidIndex < DidNum) || (1u == ResponseLen))
     {
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
-        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NegativeCode, m_pstPDUMsg);
+        return;
     }
 
-    if (TRUE == Ret)
-    {
-        /* Set wait transfer data step(0x34 service) */
-        Flash_SetNextDownloadStep(FL_TRANSFER_STEP);
-        /* Save received program addr and data len */
-        Flash_SaveDownloadDataInfo(gs_stDowloadDataInfo.StartAddr, gs_stDowloadDataInfo.DataLen);
-        /* Fill positive message */
-        m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
-        m_pstPDUMsg->aDataBuf[1u] = 0x10u;
-        m_pstPDUMsg->aDataBuf[2u] = 0x82u; /* TODO Bootloader: #05 Ϊ ZCANPROԭ 0x80 Ϊ 0x82 */
-        m_pstPDUMsg->xDataLen = 3u;
-        /* Set wait received block number */
-        gs_RxBlockNum = 1u;
-    }
-    else
-    {
-        FLSDebugPrintf("\n 4\n");
-        Flash_InitDowloadInfo();
-        /* Set request transfer data step(0x34 service) */
-        Flash_SetNextDownloadStep(FL_REQUEST_STEP);
-    }
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = ResponseLen;
 }
 
-/* Transfer data */
-static void TransferData(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+/* Write data in buffer by big endian */
+static void PutDataBigEndian(const uint32 i_Data, const uint8 i_DataLen, uint8 *o_pDataBuf)
 {
-    uint8 Ret = TRUE;
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    uint8 Index = 0u;
+    ASSERT(NULL_PTR == o_pDataBuf);
 
-    /* Request sequence error */
-    if ((FL_TRANSFER_STEP != Flash_GetCurDownloadStep()) && (TRUE == Ret))
+    for (Index = 0u; Index < i_DataLen; Index++)
     {
-        Ret = FALSE;
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
+        o_pDataBuf[Index] = (uint8)(i_Data >> (8u * (i_DataLen - 1u - Index)));
     }
+}
 
-    if ((gs_RxBlockNum != m_pstPDUMsg->aDataBuf[1u]) && (TRUE == Ret))
-    {
-        Ret = FALSE;
-        /* Received data is not wait block number */
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
-    }
+/* Read finger print of the newest APP */
+static uint8 ReadFingerprint(uint8 *o_pDataBuf)
+{
+    uint8 AppCnt = 0u;
 
-    gs_RxBlockNum++;
+    return Flash_GetNewestAppInfo(o_pDataBuf, &AppCnt);
+}
 
-    /* Copy flash data in flash area */
-    if ((TRUE != Flash_ProgramRegion(gs_stDowloadDataInfo.StartAddr,
-                                     &m_pstPDUMsg->aDataBuf[2u],
-                                     (m_pstPDUMsg->xDataLen - 2u))) && (TRUE == Ret))
-    {
-        Ret = FALSE;
-        /* Saved data and information failed! */
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
-    }
-    else
-    {
-        gs_stDowloadDataInfo.StartAddr += (m_pstPDUMsg->xDataLen - 2u);
-        gs_stDowloadDataInfo.DataLen -= (m_pstPDUMsg->xDataLen - 2u);
-    }
+/* Read APP counter of the newest APP */
+static uint8 ReadAppCounter(uint8 *o_pDataBuf)
+{
+    uint8 aFingerPrint[FL_FINGER_PRINT_LENGTH] = {0u};
 
-    /* Received all data */
-    if ((0u == gs_stDowloadDataInfo.DataLen) && (TRUE == Ret))
-    {
-        gs_RxBlockNum = 0u;
-        /* Set wait exit transfer step(0x37 service) */
-        Flash_SetNextDownloadStep(FL_EXIT_TRANSFER_STEP);
-    }
+    return Flash_GetNewestAppInfo(aFingerPrint, o_pDataBuf);
+}
 
-    if (TRUE == Ret)
-    {
-        /* Transmitted positive message. */
+#ifdef EN_DOWNLOAD_STATISTICS
+/* Download statistics */
+static tDownloadStatistics gs_stDownloadStatistics = {0u, 0u, 0u};
+
+/* Read received bytes, positive and negative responded blocks and programmed bytes */
+static uint8 ReadTransferStatistics(uint8 *o_pDataBuf)
+{
+    tFlashStatistics stFlashStatistics;
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    Flash_GetStatistics(&stFlashStatistics);
+    PutDataBigEndian(gs_stDownloadStatistics.ReceivedBytes, 4u, &o_pDataBuf[0u]);
+    PutDataBigEndian(gs_stDownloadStatistics.BlockCnt, 4u, &o_pDataBuf[4u]);
+    PutDataBigEndian(gs_stDownloadStatistics.RejectedBlockCnt, 4u, &o_pDataBuf[8u]);
+    PutDataBigEndian(stFlashStatistics.programmedBytes, 4u, &o_pDataBuf[12u]);
+    return TRUE;
+}
+
+/* Read erase, program and check sum time in ms, sector staged update is counted in program */
+static uint8 ReadFlashJobTime(uint8 *o_pDataBuf)
+{
+    tFlashStatistics stFlashStatistics;
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    Flash_GetStatistics(&stFlashStatistics);
+    PutDataBigEndian(stFlashStatistics.aJobTimeMs[FLASH_ERASING], 4u, &o_pDataBuf[0u]);
+    PutDataBigEndian(stFlashStatistics.aJobTimeMs[FLASH_PROGRAMMING] +
+                     stFlashStatistics.aJobTimeMs[FLASH_UPDATING_SECTOR], 4u, &o_pDataBuf[4u]);
+    PutDataBigEndian(stFlashStatistics.aJobTimeMs[FLASH_CHECKING], 4u, &o_pDataBuf[8u]);
+    return TRUE;
+}
+
+#ifdef EN_CAN_TP
+/* Read CAN TP error counters */
+static uint8 ReadCanTpErrorCnt(uint8 *o_pDataBuf)
+{
+    tCanTpErrorCnt stErrorCnt;
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    CANTP_GetErrorCnt(&stErrorCnt);
+    PutDataBigEndian(stErrorCnt.timeoutCnt, 2u, &o_pDataBuf[0u]);
+    PutDataBigEndian(stErrorCnt.wrongSNCnt, 2u, &o_pDataBuf[2u]);
+    PutDataBigEndian(stErrorCnt.unexpPDUCnt, 2u, &o_pDataBuf[4u]);
+    PutDataBigEndian(stErrorCnt.overflowCnt, 2u, &o_pDataBuf[6u]);
+    PutDataBigEndian(stErrorCnt.otherErrorCnt, 2u, &o_pDataBuf[8u]);
+    return TRUE;
+}
+#endif
+#endif
+
+#ifdef EN_FIFO_STATISTICS
+/* Read max used len, len and rejected count of TP RX queue and TX queue of the request channel */
+static uint8 ReadTPQueueStatistics(uint8 *o_pDataBuf)
+{
+    uint8 Index = 0u;
+    tErroCode eStatus = ERRO_NONE;
+    tFifoStatistics stStatistics;
+    const tFifoHandle axQueue[2u] = {g_xRxTPQueue, TP_GetChannelCfg(TP_GetCurChannel())->xTxTPQueue};
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    for (Index = 0u; Index < 2u; Index++)
+    {
+        GetFifoStatistics(axQueue[Index], &stStatistics, &eStatus);
+
+        if (ERRO_NONE != eStatus)
+        {
+            return FALSE;
+        }
+
+        PutDataBigEndian(stStatistics.xMaxUsedLen, 2u, &o_pDataBuf[6u * Index]);
+        PutDataBigEndian(stStatistics.xFifoLen, 2u, &o_pDataBuf[(6u * Index) + 2u]);
+        PutDataBigEndian((stStatistics.overMaxCnt > 0xFFFFu) ? 0xFFFFu : stStatistics.overMaxCnt, 2u,
+                         &o_pDataBuf[(6u * Index) + 4u]);
+    }
+
+    return TRUE;
+}
+#endif
+
+#ifdef EN_PERIODIC_DID
+/* Scheduled periodic DIDs */
+static tPeriodicDidInfo gs_astPeriodicDidInfo[PERIODIC_DID_MAX_NUM];
+
+/* Last negative response */
+static tLastNegativeResponse gs_stLastNegativeResponse = {0u, 0u};
+
+/* Read data by periodic identifier. pDIDs not supported in active session are skipped,
+   scheduled pDID gets the new rate, stop without pDID stops all. Frames are TX by UDS_PeriodicDidMainFun. */
+static void ReadDataByPeriodicIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Index = 0u;
+    uint8 DidIndex = 0u;
+    uint8 SlotIndex = 0u;
+    uint8 DidNum = 0u;
+    uint8 SupportedDidNum = 0u;
+    uint8 TransmissionMode = 0u;
+    const tReadDataIdentifierInfo *pstDid = NULL_PTR;
+    const tReadDataIdentifierInfo *apstDid[PERIODIC_DID_MAX_NUM] = {NULL_PTR};
+    tPeriodicDidInfo astSchedule[PERIODIC_DID_MAX_NUM];
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    /* Request is SID + transmissionMode + pDIDs, stop may have no pDID */
+    if (m_pstPDUMsg->xDataLen < 2u)
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        return;
+    }
+
+    TransmissionMode = m_pstPDUMsg->aDataBuf[1u];
+    DidNum = (uint8)(m_pstPDUMsg->xDataLen - 2u);
+
+    if ((TransmissionMode < PERIODIC_SEND_AT_SLOW_RATE) || (TransmissionMode > PERIODIC_STOP_SENDING))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+        return;
+    }
+
+    if (((PERIODIC_STOP_SENDING != TransmissionMode) && (0u == DidNum)) ||
+            ((m_pstPDUMsg->xDataLen - 2u) > PERIODIC_DID_MAX_NUM))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        return;
+    }
+
+    /* Periodic frames are TX on CAN */
+    if (TP_CAN_CHANNEL != TP_GetCurChannel())
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
+        return;
+    }
+
+    for (DidIndex = 0u; DidIndex < DidNum; DidIndex++)
+    {
+        pstDid = NULL_PTR;
+
+        /* Find periodic DID in read data identifier table */
+        for (Index = 0u; Index < (sizeof(gs_astReadDataIdentifierInfo) / sizeof(gs_astReadDataIdentifierInfo[0u])); Index++)
+        {
+            if (((PERIODIC_DID_BASE | m_pstPDUMsg->aDataBuf[2u + DidIndex]) == gs_astReadDataIdentifierInfo[Index].DataId) &&
+                    (TRUE == IsCurSeesionCanRequest(gs_astReadDataIdentifierInfo[Index].RequestSession)))
+            {
+                pstDid = &gs_astReadDataIdentifierInfo[Index];
+                break;
+            }
+        }
+
+        if (NULL_PTR != pstDid)
+        {
+            if (TRUE != IsCurSecurityLevelInMask(pstDid->RequestLevel))
+            {
+                SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SECURITY_ACCESS_DENIED, m_pstPDUMsg);
+                return;
+            }
+
+            apstDid[SupportedDidNum] = pstDid;
+            SupportedDidNum++;
+        }
+    }
+
+    if ((0u != DidNum) && (0u == SupportedDidNum))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+        return;
+    }
+
+    /* Schedule is changed in a copy, it is kept if scheduler is full */
+    fsl_memcpy(astSchedule, gs_astPeriodicDidInfo, sizeof(astSchedule));
+
+    if ((PERIODIC_STOP_SENDING == TransmissionMode) && (0u == DidNum))
+    {
+        fsl_memset(astSchedule, 0u, sizeof(astSchedule));
+    }
+
+    for (DidIndex = 0u; DidIndex < SupportedDidNum; DidIndex++)
+    {
+        /* Find the scheduled slot of the DID, else a free slot */
+        for (SlotIndex = 0u; SlotIndex < PERIODIC_DID_MAX_NUM; SlotIndex++)
+        {
+            if (apstDid[DidIndex] == astSchedule[SlotIndex].pstDid)
+            {
+                break;
+            }
+        }
+
+        if (PERIODIC_STOP_SENDING == TransmissionMode)
+        {
+            if (SlotIndex < PERIODIC_DID_MAX_NUM)
+            {
+                astSchedule[SlotIndex].pstDid = NULL_PTR;
+            }
+
+            continue;
+        }
+
+        for (Index = 0u; (SlotIndex >= PERIODIC_DID_MAX_NUM) && (Index < PERIODIC_DID_MAX_NUM); Index++)
+        {
+            if (NULL_PTR == astSchedule[Index].pstDid)
+            {
+                SlotIndex = Index;
+            }
+        }
+
+        if (SlotIndex >= PERIODIC_DID_MAX_NUM)
+        {
+            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+            return;
+        }
+
+        /* First frame is TX at once */
+        astSchedule[SlotIndex].pstDid = apstDid[DidIndex];
+        astSchedule[SlotIndex].xPeriod = UdsAppTimeToCount(gs_axPeriodicRateMs[TransmissionMode - 1u]);
+        astSchedule[SlotIndex].xTimer = 0u;
+    }
+
+    fsl_memcpy(gs_astPeriodicDidInfo, astSchedule, sizeof(gs_astPeriodicDidInfo));
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 1u;
+}
+
+/* Read download step, active job, waiting more time and program failed flag, last negative response SID and NRC */
+static uint8 ReadFlashJobState(uint8 *o_pDataBuf)
+{
+    tFlashProgress stProgress;
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    Flash_GetProgress(&stProgress);
+    o_pDataBuf[0u] = (uint8)stProgress.eDownloadStep;
+    o_pDataBuf[1u] = (uint8)stProgress.eActiveJob;
+    o_pDataBuf[2u] = stProgress.isWaitingMoreTime;
+    o_pDataBuf[3u] = stProgress.isProgramFailed;
+    o_pDataBuf[4u] = gs_stLastNegativeResponse.SerNum;
+    o_pDataBuf[5u] = gs_stLastNegativeResponse.NegativeCode;
+    return TRUE;
+}
+
+/* Read programmed bytes of the download, and percent of the erase job or the download */
+static uint8 ReadFlashProgress(uint8 *o_pDataBuf)
+{
+    uint32 Percent = 0u;
+    tFlashProgress stProgress;
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    Flash_GetProgress(&stProgress);
+
+    if (FLASH_ERASING == stProgress.eActiveJob)
+    {
+        if (0u != stProgress.totalSectors)
+        {
+            Percent = (stProgress.erasedSectors * 100u) / stProgress.totalSectors;
+        }
+    }
+    else if (0u != stProgress.dataLen)
+    {
+        Percent = (stProgress.programmedLen * 100u) / stProgress.dataLen;
+    }
+    else
+    {
+        /* Nothing to do */
+    }
+
+    PutDataBigEndian(stProgress.programmedLen, 4u, &o_pDataBuf[0u]);
+    o_pDataBuf[4u] = (uint8)Percent;
+    return TRUE;
+}
+
+/* Read next program or erase address and its sector number */
+static uint8 ReadFlashPosition(uint8 *o_pDataBuf)
+{
+    tFlashProgress stProgress;
+    ASSERT(NULL_PTR == o_pDataBuf);
+
+    Flash_GetProgress(&stProgress);
+    PutDataBigEndian(stProgress.curAddr, 4u, &o_pDataBuf[0u]);
+    PutDataBigEndian(stProgress.curAddr / FLASH_HAL_Get1SectorBytes(), 2u, &o_pDataBuf[4u]);
+    return TRUE;
+}
+
+/* Stop all periodic DIDs */
+void UDS_StopPeriodicDid(void)
+{
+    fsl_memset(gs_astPeriodicDidInfo, 0u, sizeof(gs_astPeriodicDidInfo));
+}
+
+/* TX periodic DIDs at their rate, a frame is pDID + data. If low priority TX BUS FIFO is full the frame is dropped,
+   next frame carries newer data. */
+void UDS_PeriodicDidMainFun(void)
+{
+    uint8 Index = 0u;
+    uint8 aFrameBuf[1u + PERIODIC_DID_MAX_DATA_LEN] = {0u};
+    tPeriodicDidInfo *pstPeriodicDid = NULL_PTR;
+
+    for (Index = 0u; Index < PERIODIC_DID_MAX_NUM; Index++)
+    {
+        pstPeriodicDid = &gs_astPeriodicDidInfo[Index];
+
+        if ((NULL_PTR == pstPeriodicDid->pstDid) || (0u != pstPeriodicDid->xTimer))
+        {
+            continue;
+        }
+
+        pstPeriodicDid->xTimer = pstPeriodicDid->xPeriod;
+        aFrameBuf[0u] = (uint8)pstPeriodicDid->pstDid->DataId;
+
+        if (TRUE == pstPeriodicDid->pstDid->pfReadData(&aFrameBuf[1u]))
+        {
+            (void)CANTP_TxPeriodicFrame(aFrameBuf, (uint8)(1u + pstPeriodicDid->pstDid->DataLen));
+        }
+    }
+}
+#endif
+
+/* Write data by identifier */
+static void WriteDataByIdentifier(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Index = 0u;
+    uint16 DataId = 0u;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if (m_pstPDUMsg->xDataLen >= 3u)
+    {
+        DataId = (uint16)(((uint16)m_pstPDUMsg->aDataBuf[1u] << 8u) | m_pstPDUMsg->aDataBuf[2u]);
+
+        /* Find DID in write data identifier table */
+        for (Index = 0u; Index < (sizeof(gs_astWriteDataIdentifierInfo) / sizeof(gs_astWriteDataIdentifierInfo[0u])); Index++)
+        {
+            if (DataId == gs_astWriteDataIdentifierInfo[Index].DataId)
+            {
+                gs_astWriteDataIdentifierInfo[Index].pfRoutine(i_pstUDSServiceInfo, m_pstPDUMsg);
+                return;
+            }
+        }
+    }
+
+    /* Don't have this data identifier */
+    SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
+}
+
+/* Write finger print */
+static void WriteFingerprint(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    /* Do write finger print */
+    Flash_SaveFingerPrint(&m_pstPDUMsg->aDataBuf[3u], (m_pstPDUMsg->xDataLen - 3u));
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[1u] = 0xF1u;
+    m_pstPDUMsg->aDataBuf[2u] = 0x5Au;
+    m_pstPDUMsg->xDataLen = 3u;
+}
+
+/* Download data info */
+static tDowloadDataInfo gs_stDowloadDataInfo = {0u, 0u, DOWLOAD_NOT_COMPRESSED, DOWLOAD_NOT_ENCRYPTED};
+
+/* Received block number */
+static uint8 gs_RxBlockNum = 0u;
+
+/* Last TransferData block */
+static tLastTransferBlockInfo gs_stLastTransferBlockInfo = {FALSE, 0u, 0u, 0u};
+
+/* Is the block a repeat of last block? Positive response is lost, tester transfers the block again. */
+static boolean IsRepeatedTransferBlock(const tUdsAppMsgInfo *i_pstPDUMsg);
+
+/* Save received block, it is valid after responded positive */
+static void SaveTransferBlock(const tUdsAppMsgInfo *i_pstPDUMsg);
+
+#ifdef EN_UPLOAD_MEMORY
+/* Upload data info */
+static tUploadDataInfo gs_stUploadDataInfo = {FALSE, 0u, 0u, 0u, 0u};
+
+/* TransferData of upload, read a block */
+static void UploadData(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/* RequestTransferExit of upload */
+static void ExitUpload(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+#endif
+
+/* End a TransferData block */
+static void EndTransferData(const uint8 i_Ret);
+
+#ifdef EN_LZSS_DECOMPRESS
+static tDecompressDataInfo gs_stDecompressDataInfo;
+#endif
+
+#ifdef EN_DELTA_UPDATE
+static tDeltaDataInfo gs_stDeltaDataInfo;
+
+#ifndef EN_SUPPORT_APP_B
+/* Sector is updated, continue block data and response TransferData */
+static void DoDeltaSectorUpdatedResponse(uint8 i_Status);
+#endif
+#endif
+
+/* Program download data at start addr, then move to next data */
+static uint8 ProgramDownloadData(const uint8 *i_pDataBuf, const uint32 i_DataLen)
+{
+    uint8 Ret = FALSE;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    Ret = Flash_ProgramRegion(gs_stDowloadDataInfo.StartAddr, i_pDataBuf, i_DataLen);
+
+    if (TRUE == Ret)
+    {
+        gs_stDowloadDataInfo.StartAddr += i_DataLen;
+        gs_stDowloadDataInfo.DataLen -= i_DataLen;
+    }
+
+    return Ret;
+}
+
+#ifdef EN_LZSS_DECOMPRESS
+/* Decompress block data and program it, decompressed data should not be more than remain data len */
+static uint8 DecompressDownloadData(const uint8 *i_pDataBuf, const uint32 i_DataLen, uint8 *o_pNegativeCode)
+{
+    uint32 InPos = 0u;
+    uint32 InUsedLen = 0u;
+    uint32 OutLen = 0u;
+    tDecompressDataInfo *pstDecompress = &gs_stDecompressDataInfo;
+    ASSERT(NULL_PTR == i_pDataBuf);
+    ASSERT(NULL_PTR == o_pNegativeCode);
+
+    while (InPos < i_DataLen)
+    {
+        /* All data is decompressed, but block has more data */
+        if (0u == gs_stDowloadDataInfo.DataLen)
+        {
+            *o_pNegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+            return FALSE;
+        }
+
+        /* Decoder output is bounded by staged buffer and remain data len */
+        OutLen = DOWLOAD_BLOCK_DATA_LEN - pstDecompress->DataLen;
+
+        if (OutLen > (gs_stDowloadDataInfo.DataLen - pstDecompress->DataLen))
+        {
+            OutLen = gs_stDowloadDataInfo.DataLen - pstDecompress->DataLen;
+        }
+
+        OutLen = LZSS_Decode(&i_pDataBuf[InPos],
+                             i_DataLen - InPos,
+                             &InUsedLen,
+                             &pstDecompress->aDataBuf[pstDecompress->DataLen],
+                             OutLen);
+        InPos += InUsedLen;
+        pstDecompress->DataLen += OutLen;
+
+        /* Staged buffer is full or it is the last data */
+        if ((DOWLOAD_BLOCK_DATA_LEN == pstDecompress->DataLen) ||
+                (gs_stDowloadDataInfo.DataLen == pstDecompress->DataLen))
+        {
+            if (TRUE != ProgramDownloadData(pstDecompress->aDataBuf, pstDecompress->DataLen))
+            {
+                *o_pNegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+                return FALSE;
+            }
+
+            pstDecompress->DataLen = 0u;
+        }
+    }
+
+    return TRUE;
+}
+#endif
+
+/* Is dataFormatIdentifier supported? */
+static uint8 IsDownloadDataFormatValid(const uint8 i_CompressionMethod, const uint8 i_EncryptingMethod)
+{
+    uint8 Ret = FALSE;
+
+    if ((DOWLOAD_NOT_COMPRESSED == i_CompressionMethod)
+#ifdef EN_LZSS_DECOMPRESS
+            || (LZSS_COMPRESSION_METHOD == i_CompressionMethod)
+#endif
+#ifdef EN_DELTA_UPDATE
+            || (DELTA_COMPRESSION_METHOD == i_CompressionMethod)
+#endif
+       )
+    {
+        Ret = TRUE;
+    }
+
+    if ((DOWLOAD_NOT_ENCRYPTED != i_EncryptingMethod)
+#ifdef EN_AES_CTR_DECRYPT
+            && (AES_CTR_ENCRYPTING_METHOD != i_EncryptingMethod)
+#endif
+       )
+    {
+        Ret = FALSE;
+    }
+
+    return Ret;
+}
+
+#ifdef EN_DELTA_UPDATE
+/* Start delta download, patch reads installed APP at same offset of download address */
+static uint8 StartDeltaDownload(uint8 *o_pNegativeCode)
+{
+    uint32 SourceLen = 0u;
+    tDeltaDataInfo *pstDelta = &gs_stDeltaDataInfo;
+    ASSERT(NULL_PTR == o_pNegativeCode);
+
+    /* Installed APP is valid */
+    if (TRUE != Flash_GetDeltaSourceInfo(gs_stDowloadDataInfo.StartAddr, &pstDelta->SourceAddr, &SourceLen))
+    {
+        *o_pNegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+        return FALSE;
+    }
+
+    /* New APP is in APP flash */
+    if (gs_stDowloadDataInfo.DataLen > SourceLen)
+    {
+        *o_pNegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+        return FALSE;
+    }
+
+#ifndef EN_SUPPORT_APP_B
+
+    /* Update in place, the first sector has APP info */
+    if (TRUE != Flash_StartSectorStagedDownload(gs_stDowloadDataInfo.StartAddr))
+    {
+        *o_pNegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+        return FALSE;
+    }
+
+    pstDelta->SectorAddr = gs_stDowloadDataInfo.StartAddr - (gs_stDowloadDataInfo.StartAddr % FLASH_SECTOR_LEN);
+    pstDelta->SectorDataLen = 0u;
+    fsl_memset(pstDelta->aSectorBuf, 0xFFu, sizeof(pstDelta->aSectorBuf));
+#endif
+    Delta_Init((const uint8 *)pstDelta->SourceAddr, SourceLen);
+    pstDelta->InLen = 0u;
+    pstDelta->InPos = 0u;
+    pstDelta->PatchLen = 0u;
+    pstDelta->PatchPos = 0u;
+    return TRUE;
+}
+
+/* Decompress patch of block data and apply it, rebuilt data is programmed when staged buffer is full.
+   Sector staged update stops at a full sector, then *o_pbIsSectorUpdating is TRUE and block data is continued after it. */
+static uint8 ApplyDeltaDownloadData(uint8 *o_pNegativeCode, boolean *o_pbIsSectorUpdating)
+{
+    uint32 UsedLen = 0u;
+    uint32 OutLen = 0u;
+    tDeltaDataInfo *pstDelta = &gs_stDeltaDataInfo;
+#ifdef EN_SUPPORT_APP_B
+    uint8 *pStagedBuf = gs_stDecompressDataInfo.aDataBuf;
+    uint32 *pStagedLen = &gs_stDecompressDataInfo.DataLen;
+    const uint32 StagedBufLen = DOWLOAD_BLOCK_DATA_LEN;
+#else
+    const uint32 SectorOffset = gs_stDowloadDataInfo.StartAddr - pstDelta->SectorAddr;
+    uint8 *pStagedBuf = &pstDelta->aSectorBuf[SectorOffset];
+    uint32 *pStagedLen = &pstDelta->SectorDataLen;
+    const uint32 StagedBufLen = FLASH_SECTOR_LEN - SectorOffset;
+#endif
+    ASSERT(NULL_PTR == o_pNegativeCode);
+    ASSERT(NULL_PTR == o_pbIsSectorUpdating);
+
+    *o_pbIsSectorUpdating = FALSE;
+
+    /* Copy bytes of patch are rebuilt without block data */
+    while ((pstDelta->PatchPos < pstDelta->PatchLen) || (pstDelta->InPos < pstDelta->InLen) ||
+            (TRUE == Delta_IsCopyPending()))
+    {
+        /* All data is rebuilt, but block has more data */
+        if (0u == gs_stDowloadDataInfo.DataLen)
+        {
+            *o_pNegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+            return FALSE;
+        }
+
+        if ((pstDelta->PatchPos >= pstDelta->PatchLen) && (pstDelta->InPos < pstDelta->InLen))
+        {
+            pstDelta->PatchLen = LZSS_Decode(&pstDelta->pInBuf[pstDelta->InPos],
+                                             pstDelta->InLen - pstDelta->InPos,
+                                             &UsedLen,
+                                             pstDelta->aPatchBuf,
+                                             DELTA_PATCH_BUF_LEN);
+            pstDelta->InPos += UsedLen;
+            pstDelta->PatchPos = 0u;
+            continue;
+        }
+
+        /* Rebuilt data is bounded by staged buffer and remain data len */
+        OutLen = StagedBufLen - *pStagedLen;
+
+        if (OutLen > (gs_stDowloadDataInfo.DataLen - *pStagedLen))
+        {
+            OutLen = gs_stDowloadDataInfo.DataLen - *pStagedLen;
+        }
+
+        if (TRUE != Delta_Decode(&pstDelta->aPatchBuf[pstDelta->PatchPos],
+                                 pstDelta->PatchLen - pstDelta->PatchPos,
+                                 &UsedLen,
+                                 &pStagedBuf[*pStagedLen],
+                                 OutLen,
+                                 &OutLen))
+        {
+            *o_pNegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+            return FALSE;
+        }
+
+        pstDelta->PatchPos += UsedLen;
+        *pStagedLen += OutLen;
+
+        /* Staged buffer is full or it is the last data */
+        if ((StagedBufLen == *pStagedLen) || (gs_stDowloadDataInfo.DataLen == *pStagedLen))
+        {
+#ifdef EN_SUPPORT_APP_B
+
+            if (TRUE != ProgramDownloadData(pStagedBuf, *pStagedLen))
+            {
+                *o_pNegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+                return FALSE;
+            }
+
+            *pStagedLen = 0u;
+#else
+            /* Not downloaded data of sector is erased */
+            fsl_memset(&pStagedBuf[*pStagedLen], 0xFFu, StagedBufLen - *pStagedLen);
+
+            if (TRUE != Flash_UpdateSector(pstDelta->SectorAddr,
+                                           pstDelta->aSectorBuf,
+                                           &DoDeltaSectorUpdatedResponse,
+                                           0x36u,
+                                           &RequestMoreTime))
+            {
+                *o_pNegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+                return FALSE;
+            }
+
+            *o_pbIsSectorUpdating = TRUE;
+            return TRUE;
+#endif
+        }
+    }
+
+    return TRUE;
+}
+#endif
+
+/* Request download */
+static void RequestDownload(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Index = 0u;
+    uint8 Ret = TRUE;
+#ifdef EN_DELTA_UPDATE
+    uint8 NegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+#endif
+#ifdef EN_AES_CTR_DECRYPT
+    uint8 aKey[AES_CTR_KEY_LEN];
+#endif
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+#ifdef EN_UPLOAD_MEMORY
+    /* Download ends active upload */
+    gs_stUploadDataInfo.IsUploading = FALSE;
+#endif
+
+    if (m_pstPDUMsg->xDataLen < (DOWLOAD_DATA_ADDR_LEN + DOWLOAD_DATA_LEN + 1u + 2u))
+    {
+        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+    }
+
+    if (TRUE == Ret)
+    {
+        /* dataFormatIdentifier: compressionMethod (high nibble) and encryptingMethod (low nibble) */
+        gs_stDowloadDataInfo.CompressionMethod = (uint8)(m_pstPDUMsg->aDataBuf[1u] >> 4u);
+        gs_stDowloadDataInfo.EncryptingMethod = (uint8)(m_pstPDUMsg->aDataBuf[1u] & 0x0Fu);
+
+        if (TRUE != IsDownloadDataFormatValid(gs_stDowloadDataInfo.CompressionMethod,
+                                              gs_stDowloadDataInfo.EncryptingMethod))
+        {
+            Ret = FALSE;
+            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+        }
+    }
+
+    if (TRUE == Ret)
+    {
+        /* Get data addr */
+        gs_stDowloadDataInfo.StartAddr = 0u;
+
+        for (Index = 0u; Index < DOWLOAD_DATA_ADDR_LEN; Index++)
+        {
+            gs_stDowloadDataInfo.StartAddr <<= 8u;
+            /* 3u = N_PCI(1) + SID34(1) + dataFormatldentifier(1) */
+            gs_stDowloadDataInfo.StartAddr |= m_pstPDUMsg->aDataBuf[Index + 3u];
+        }
+
+        /* Get data len */
+        gs_stDowloadDataInfo.DataLen = 0u;
+
+        for (Index = 0u; Index < DOWLOAD_DATA_LEN; Index++)
+        {
+            gs_stDowloadDataInfo.DataLen <<= 8u;
+            gs_stDowloadDataInfo.DataLen |= m_pstPDUMsg->aDataBuf[Index + 7u];
+        }
+    }
+
+    /* Is download data addr and len valid? */
+    if (((TRUE != IsDownloadDataAddrValid(gs_stDowloadDataInfo.StartAddr)) ||
+            (TRUE != IsDownloadDataLenValid(gs_stDowloadDataInfo.DataLen))) && (TRUE == Ret))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+        Ret = FALSE;
+    }
+
+#ifdef EN_DELTA_UPDATE
+
+    if ((DELTA_COMPRESSION_METHOD == gs_stDowloadDataInfo.CompressionMethod) && (TRUE == Ret))
+    {
+        Ret = StartDeltaDownload(&NegativeCode);
+
+        if (TRUE != Ret)
+        {
+            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NegativeCode, m_pstPDUMsg);
+        }
+    }
+
+#endif
+#ifdef EN_AES_CTR_DECRYPT
+
+    if ((AES_CTR_ENCRYPTING_METHOD == gs_stDowloadDataInfo.EncryptingMethod) && (TRUE == Ret))
+    {
+        /* IV follows memorySize */
+        if (m_pstPDUMsg->xDataLen < (DOWLOAD_DATA_ADDR_LEN + DOWLOAD_DATA_LEN + 3u + AES_CTR_BLOCK_LEN))
+        {
+            Ret = FALSE;
+            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        }
+        else if (TRUE != UDS_ALG_HAL_GetDownloadKey(aKey))
+        {
+            Ret = FALSE;
+            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
+        }
+        else
+        {
+            AES_CTR_Init(aKey, &m_pstPDUMsg->aDataBuf[DOWLOAD_DATA_ADDR_LEN + DOWLOAD_DATA_LEN + 3u]);
+        }
+
+        /* Key is only in expanded key after here */
+        fsl_memset(aKey, 0x0u, sizeof(aKey));
+    }
+
+#endif
+
+    if (TRUE == Ret)
+    {
+        /* Set wait transfer data step(0x34 service) */
+        Flash_SetNextDownloadStep(FL_TRANSFER_STEP);
+        /* Save received program addr and data len */
+        Flash_SaveDownloadDataInfo(gs_stDowloadDataInfo.StartAddr, gs_stDowloadDataInfo.DataLen);
+        /* Fill positive message */
+        m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+        m_pstPDUMsg->aDataBuf[1u] = (uint8)(DOWLOAD_MAX_BLOCK_LEN_LEN << 4u);
+
+        /* maxNumberOfBlockLength, MSB first */
+        for (Index = 0u; Index < DOWLOAD_MAX_BLOCK_LEN_LEN; Index++)
+        {
+            m_pstPDUMsg->aDataBuf[2u + Index] =
+                (uint8)(DOWLOAD_MAX_BLOCK_LEN >> (8u * (DOWLOAD_MAX_BLOCK_LEN_LEN - 1u - Index)));
+        }
+
+        m_pstPDUMsg->xDataLen = 2u + DOWLOAD_MAX_BLOCK_LEN_LEN;
+        /* Set wait received block number */
+        gs_RxBlockNum = 1u;
+        gs_stLastTransferBlockInfo.IsValid = FALSE;
+#ifdef EN_LZSS_DECOMPRESS
+        LZSS_Init();
+        gs_stDecompressDataInfo.DataLen = 0u;
+#endif
+    }
+    else
+    {
+        FLSDebugPrintf("\n 4\n");
+        Flash_InitDowloadInfo();
+        /* Set request transfer data step(0x34 service) */
+        Flash_SetNextDownloadStep(FL_REQUEST_STEP);
+    }
+}
+
+/* Transfer data */
+static void TransferData(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Ret = TRUE;
+    uint8 NegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+#ifdef EN_DELTA_UPDATE
+    boolean bIsSectorUpdating = FALSE;
+#endif
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+#ifdef EN_UPLOAD_MEMORY
+
+    if (TRUE == gs_stUploadDataInfo.IsUploading)
+    {
+        UploadData(i_pstUDSServiceInfo, m_pstPDUMsg);
+        return;
+    }
+
+#endif
+
+    /* A buffered block is programmed failed after its positive response */
+    if (TRUE == Flash_IsProgramFailed())
+    {
+        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_GENERAL_PROGRAMMING_FAILURE, m_pstPDUMsg);
+    }
+
+    /* Block is programmed already, only response again. No NRC 0x24 and download is not restarted. */
+    if ((TRUE == Ret) && (TRUE == IsRepeatedTransferBlock(m_pstPDUMsg)))
+    {
+        m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+        m_pstPDUMsg->xDataLen = 4u;
+        return;
+    }
+
+    /* Request sequence error */
+    if ((FL_TRANSFER_STEP != Flash_GetCurDownloadStep()) && (TRUE == Ret))
+    {
+        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
+    }
+
+    if ((gs_RxBlockNum != m_pstPDUMsg->aDataBuf[1u]) && (TRUE == Ret))
+    {
+        Ret = FALSE;
+        /* Received data is not wait block number */
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
+    }
+
+    /* Block is SID + counter + data, not more than maxNumberOfBlockLength and remain data len (not compressed) */
+    if (((m_pstPDUMsg->xDataLen <= 2u) ||
+            (m_pstPDUMsg->xDataLen > DOWLOAD_MAX_BLOCK_LEN) ||
+            ((DOWLOAD_NOT_COMPRESSED == gs_stDowloadDataInfo.CompressionMethod) &&
+             ((m_pstPDUMsg->xDataLen - 2u) > gs_stDowloadDataInfo.DataLen))) && (TRUE == Ret))
+    {
+        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+    }
+
+    gs_RxBlockNum++;
+
+    if (TRUE == Ret)
+    {
+        NegativeCode = NRC_CONDITIONS_NOT_CORRECT;
+        SaveTransferBlock(m_pstPDUMsg);
+#ifdef EN_DOWNLOAD_STATISTICS
+        gs_stDownloadStatistics.ReceivedBytes += m_pstPDUMsg->xDataLen - 2u;
+#endif
+#ifdef EN_AES_CTR_DECRYPT
+
+        /* Decrypt in place, then plain data is decompressed or programmed */
+        if (AES_CTR_ENCRYPTING_METHOD == gs_stDowloadDataInfo.EncryptingMethod)
+        {
+            AES_CTR_Crypt(&m_pstPDUMsg->aDataBuf[2u], (m_pstPDUMsg->xDataLen - 2u));
+        }
+
+#endif
+#ifdef EN_DELTA_UPDATE
+
+        if (DELTA_COMPRESSION_METHOD == gs_stDowloadDataInfo.CompressionMethod)
+        {
+#ifdef EN_SUPPORT_APP_B
+            gs_stDeltaDataInfo.pInBuf = &m_pstPDUMsg->aDataBuf[2u];
+#else
+            /* UDS message may be overwritten before the block is applied */
+            fsl_memcpy(gs_stDeltaDataInfo.aInBuf, &m_pstPDUMsg->aDataBuf[2u], (m_pstPDUMsg->xDataLen - 2u));
+            gs_stDeltaDataInfo.pInBuf = gs_stDeltaDataInfo.aInBuf;
+            gs_stDeltaDataInfo.BlockNum = m_pstPDUMsg->aDataBuf[1u];
+#endif
+            gs_stDeltaDataInfo.InLen = m_pstPDUMsg->xDataLen - 2u;
+            gs_stDeltaDataInfo.InPos = 0u;
+            Ret = ApplyDeltaDownloadData(&NegativeCode, &bIsSectorUpdating);
+        }
+        else
+#endif
+#ifdef EN_LZSS_DECOMPRESS
+
+        if (LZSS_COMPRESSION_METHOD == gs_stDowloadDataInfo.CompressionMethod)
+        {
+            Ret = DecompressDownloadData(&m_pstPDUMsg->aDataBuf[2u], (m_pstPDUMsg->xDataLen - 2u), &NegativeCode);
+        }
+        else
+#endif
+        {
+            /* Copy flash data in flash area */
+            Ret = ProgramDownloadData(&m_pstPDUMsg->aDataBuf[2u], (m_pstPDUMsg->xDataLen - 2u));
+        }
+
+        if (TRUE != Ret)
+        {
+            /* Saved data and information failed! Program failed if no free buffer and the oldest block is programmed failed */
+            if (TRUE == Flash_IsProgramFailed())
+            {
+                NegativeCode = NRC_GENERAL_PROGRAMMING_FAILURE;
+            }
+
+            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NegativeCode, m_pstPDUMsg);
+        }
+    }
+
+#ifdef EN_DELTA_UPDATE
+
+    /* Sector is updating (long running), TransferData is responded after the block is applied */
+    if ((TRUE == Ret) && (TRUE == bIsSectorUpdating))
+    {
+        UDS_StartResponsePending(i_pstUDSServiceInfo->SerNum);
+        m_pstPDUMsg->xDataLen = 0u;
+        return;
+    }
+
+#endif
+    EndTransferData(Ret);
+
+    if (TRUE == Ret)
+    {
+        gs_stLastTransferBlockInfo.IsValid = TRUE;
+        /* Transmitted positive message. */
         m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
         m_pstPDUMsg->xDataLen = 4u;
     }
+}
+
+/* End a TransferData block: wait exit transfer if all data is received, or request download again if failed */
+static void EndTransferData(const uint8 i_Ret)
+{
+#ifdef EN_DOWNLOAD_STATISTICS
+
+    if (TRUE == i_Ret)
+    {
+        gs_stDownloadStatistics.BlockCnt++;
+    }
+    else
+    {
+        gs_stDownloadStatistics.RejectedBlockCnt++;
+    }
+
+#endif
+
+    /* Received all data */
+    if ((0u == gs_stDowloadDataInfo.DataLen) && (TRUE == i_Ret))
+    {
+        gs_RxBlockNum = 0u;
+        /* Set wait exit transfer step(0x37 service) */
+        Flash_SetNextDownloadStep(FL_EXIT_TRANSFER_STEP);
+#ifdef EN_AES_CTR_DECRYPT
+        AES_CTR_Deinit();
+#endif
+    }
+
+    if (TRUE != i_Ret)
+    {
+        Flash_InitDowloadInfo();
+        /* Set request transfer data step(0x34 service) */
+        Flash_SetNextDownloadStep(FL_REQUEST_STEP);
+        gs_RxBlockNum = 0u;
+        gs_stLastTransferBlockInfo.IsValid = FALSE;
+#ifdef EN_AES_CTR_DECRYPT
+        AES_CTR_Deinit();
+#endif
+    }
+}
+
+/* Is the block a repeat of last block? Positive response is lost, tester transfers the block again. */
+static boolean IsRepeatedTransferBlock(const tUdsAppMsgInfo *i_pstPDUMsg)
+{
+    uint32 xCrc = 0u;
+    const tFlDownloadStepType eDownloadStep = Flash_GetCurDownloadStep();
+    const tLastTransferBlockInfo *pstLastBlock = &gs_stLastTransferBlockInfo;
+    ASSERT(NULL_PTR == i_pstPDUMsg);
+
+    /* Wait next block, or RequestTransferExit after the last block */
+    if ((TRUE != pstLastBlock->IsValid) ||
+            ((FL_TRANSFER_STEP != eDownloadStep) && (FL_EXIT_TRANSFER_STEP != eDownloadStep)) ||
+            (i_pstPDUMsg->xDataLen <= 2u) ||
+            (pstLastBlock->BlockNum != i_pstPDUMsg->aDataBuf[1u]) ||
+            (pstLastBlock->DataLen != (i_pstPDUMsg->xDataLen - 2u)))
+    {
+        return FALSE;
+    }
+
+    CRC_HAL_CreatHardwareCrc(&i_pstPDUMsg->aDataBuf[2u], (i_pstPDUMsg->xDataLen - 2u), &xCrc);
+
+    return (pstLastBlock->Crc == xCrc) ? TRUE : FALSE;
+}
+
+/* Save received block, it is valid after responded positive */
+static void SaveTransferBlock(const tUdsAppMsgInfo *i_pstPDUMsg)
+{
+    tLastTransferBlockInfo *pstLastBlock = &gs_stLastTransferBlockInfo;
+    ASSERT(NULL_PTR == i_pstPDUMsg);
+
+    pstLastBlock->IsValid = FALSE;
+    pstLastBlock->BlockNum = i_pstPDUMsg->aDataBuf[1u];
+    pstLastBlock->DataLen = i_pstPDUMsg->xDataLen - 2u;
+    pstLastBlock->Crc = 0u;
+    CRC_HAL_CreatHardwareCrc(&i_pstPDUMsg->aDataBuf[2u], pstLastBlock->DataLen, &pstLastBlock->Crc);
+}
+
+#if (defined EN_DELTA_UPDATE) && (!defined EN_SUPPORT_APP_B)
+/* Sector is updated, continue block data, then response TransferData */
+static void DoDeltaSectorUpdatedResponse(uint8 i_Status)
+{
+    uint8 aResponseBuf[3u] = {0u};
+    uint8 ResponseLen = 0u;
+    uint8 Ret = i_Status;
+    uint8 NegativeCode = NRC_GENERAL_PROGRAMMING_FAILURE;
+    boolean bIsSectorUpdating = FALSE;
+    tDeltaDataInfo *pstDelta = &gs_stDeltaDataInfo;
+
+    if (TRUE == Ret)
+    {
+        gs_stDowloadDataInfo.StartAddr += pstDelta->SectorDataLen;
+        gs_stDowloadDataInfo.DataLen -= pstDelta->SectorDataLen;
+        pstDelta->SectorAddr += FLASH_SECTOR_LEN;
+        pstDelta->SectorDataLen = 0u;
+        fsl_memset(pstDelta->aSectorBuf, 0xFFu, sizeof(pstDelta->aSectorBuf));
+        /* Installed APP below next sector is overwritten */
+        Delta_SetOldLowLimit(pstDelta->SectorAddr - pstDelta->SourceAddr);
+        Ret = ApplyDeltaDownloadData(&NegativeCode, &bIsSectorUpdating);
+
+        if ((TRUE == Ret) && (TRUE == bIsSectorUpdating))
+        {
+            return;
+        }
+    }
+
+    UDS_StopResponsePending();
+    EndTransferData(Ret);
+
+    if (TRUE == Ret)
+    {
+        gs_stLastTransferBlockInfo.IsValid = TRUE;
+        aResponseBuf[0u] = 0x36u + 0x40u;
+        aResponseBuf[1u] = pstDelta->BlockNum;
+        ResponseLen = 2u;
+    }
+    else
+    {
+        aResponseBuf[0u] = NEGTIVE_RESPONSE_ID;
+        aResponseBuf[1u] = 0x36u;
+        aResponseBuf[2u] = NegativeCode;
+        ResponseLen = 3u;
+    }
+
+    (void)TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), NULL_PTR, ResponseLen, aResponseBuf);
+}
+#endif
+
+/* Request transfer exit */
+static void RequestTransferExit(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Ret = TRUE;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+#ifdef EN_UPLOAD_MEMORY
+
+    if (TRUE == gs_stUploadDataInfo.IsUploading)
+    {
+        ExitUpload(i_pstUDSServiceInfo, m_pstPDUMsg);
+        return;
+    }
+
+#endif
+
+    /* Buffered blocks are programmed before exit, failed block is reported here if it is the last */
+    if ((TRUE == Flash_IsProgramFailed()) || (TRUE != Flash_FlushProgramData()))
+    {
+        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_GENERAL_PROGRAMMING_FAILURE, m_pstPDUMsg);
+    }
+
+    if ((FL_EXIT_TRANSFER_STEP != Flash_GetCurDownloadStep()) && (TRUE == Ret))
+    {
+        Ret = FALSE;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
+    }
+
+    if (TRUE == Ret)
+    {
+        Flash_SetNextDownloadStep(FL_CHECKSUM_STEP);
+        /* Transmitted positive message. */
+        m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+        m_pstPDUMsg->xDataLen = 1u;
+    }
+    else
+    {
+        Flash_InitDowloadInfo();
+    }
+}
+
+#ifdef EN_UPLOAD_MEMORY
+/* Get memoryAddress and memorySize by addressAndLengthFormatIdentifier (1 ~ 4 bytes each), message len should be matched */
+static uint8 GetMemoryAddrAndSize(const uint8 *i_pDataBuf, const uint32 i_DataLen, uint32 *o_pAddr, uint32 *o_pSize)
+{
+    uint8 Index = 0u;
+    const uint8 AddrLen = (uint8)(i_pDataBuf[0u] & 0x0Fu);
+    const uint8 SizeLen = (uint8)(i_pDataBuf[0u] >> 4u);
+    ASSERT(NULL_PTR == i_pDataBuf);
+    ASSERT(NULL_PTR == o_pAddr);
+    ASSERT(NULL_PTR == o_pSize);
+
+    if ((0u == AddrLen) || (AddrLen > 4u) || (0u == SizeLen) || (SizeLen > 4u) ||
+            (i_DataLen != (1u + (uint32)AddrLen + (uint32)SizeLen)))
+    {
+        return FALSE;
+    }
+
+    *o_pAddr = 0u;
+    *o_pSize = 0u;
+
+    for (Index = 0u; Index < AddrLen; Index++)
+    {
+        *o_pAddr = (*o_pAddr << 8u) | i_pDataBuf[1u + Index];
+    }
+
+    for (Index = 0u; Index < SizeLen; Index++)
+    {
+        *o_pSize = (*o_pSize << 8u) | i_pDataBuf[1u + AddrLen + Index];
+    }
+
+    return TRUE;
+}
+
+/* Is memory in a readable range and can be read in current session and security level? */
+static uint8 IsReadMemoryValid(const uint32 i_Addr, const uint32 i_Size, uint8 *o_pNegativeCode)
+{
+    uint8 Index = 0u;
+    const tReadMemoryRangeInfo *pstRange = NULL_PTR;
+    ASSERT(NULL_PTR == o_pNegativeCode);
+
+    for (Index = 0u; Index < (sizeof(gs_astReadMemoryRangeInfo) / sizeof(gs_astReadMemoryRangeInfo[0u])); Index++)
+    {
+        pstRange = &gs_astReadMemoryRangeInfo[Index];
+
+        /* Memory is in the range, no address overflow */
+        if ((0u != i_Size) && (i_Addr >= pstRange->StartAddr) && (i_Addr < pstRange->EndAddr) &&
+                (i_Size <= (pstRange->EndAddr - i_Addr)))
+        {
+            if ((TRUE != IsCurSeesionCanRequest(pstRange->RequestSession)) ||
+                    (TRUE != IsCurSecurityLevelInMask(pstRange->RequestLevel)))
+            {
+                *o_pNegativeCode = NRC_SECURITY_ACCESS_DENIED;
+                return FALSE;
+            }
+
+            return TRUE;
+        }
+    }
+
+    *o_pNegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+    return FALSE;
+}
+
+/* Request upload */
+static void RequestUpload(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Index = 0u;
+    uint32 Addr = 0u;
+    uint32 Size = 0u;
+    uint8 NegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+    tFlDownloadStepType eDownloadStep = Flash_GetCurDownloadStep();
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    gs_stUploadDataInfo.IsUploading = FALSE;
+
+    /* SID + dataFormatIdentifier + addressAndLengthFormatIdentifier + memoryAddress + memorySize */
+    if ((m_pstPDUMsg->xDataLen < 3u) ||
+            (TRUE != GetMemoryAddrAndSize(&m_pstPDUMsg->aDataBuf[2u], m_pstPDUMsg->xDataLen - 2u, &Addr, &Size)))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        return;
+    }
+
+    /* Uploaded data is not compressed or encrypted */
+    if (0u != m_pstPDUMsg->aDataBuf[1u])
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+        return;
+    }
+
+    if (TRUE != IsReadMemoryValid(Addr, Size, &NegativeCode))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NegativeCode, m_pstPDUMsg);
+        return;
+    }
+
+    /* Not in a download, flash is not programmed */
+    if ((FL_TRANSFER_STEP == eDownloadStep) || (FL_EXIT_TRANSFER_STEP == eDownloadStep) ||
+            (FLASH_IDLE != Flash_GetOperateFlashActiveJob()))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
+        return;
+    }
+
+    gs_stUploadDataInfo.IsUploading = TRUE;
+    gs_stUploadDataInfo.StartAddr = Addr;
+    gs_stUploadDataInfo.DataLen = Size;
+    gs_stUploadDataInfo.BlockDataLen = 0u;
+    gs_stUploadDataInfo.BlockNum = 0u;
+
+    /* Fill positive message */
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[1u] = (uint8)(DOWLOAD_MAX_BLOCK_LEN_LEN << 4u);
+
+    /* maxNumberOfBlockLength, MSB first */
+    for (Index = 0u; Index < DOWLOAD_MAX_BLOCK_LEN_LEN; Index++)
+    {
+        m_pstPDUMsg->aDataBuf[2u + Index] =
+            (uint8)(UPLOAD_MAX_BLOCK_LEN >> (8u * (DOWLOAD_MAX_BLOCK_LEN_LEN - 1u - Index)));
+    }
+
+    m_pstPDUMsg->xDataLen = 2u + DOWLOAD_MAX_BLOCK_LEN_LEN;
+}
+
+/* TransferData of upload, read a block. The last block is read again if its counter is requested again (response lost). */
+static void UploadData(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint32 BlockAddr = 0u;
+    uint32 BlockDataLen = 0u;
+    uint8 BlockNum = 0u;
+    tUploadDataInfo *pstUpload = &gs_stUploadDataInfo;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if (2u != m_pstPDUMsg->xDataLen)
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        return;
+    }
+
+    BlockNum = m_pstPDUMsg->aDataBuf[1u];
+
+    if ((0u != pstUpload->BlockDataLen) && (BlockNum == pstUpload->BlockNum))
+    {
+        /* Repeated last block */
+        BlockAddr = pstUpload->StartAddr - pstUpload->BlockDataLen;
+        BlockDataLen = pstUpload->BlockDataLen;
+    }
+    else if ((0u != pstUpload->DataLen) && (BlockNum == (uint8)(pstUpload->BlockNum + 1u)))
+    {
+        BlockAddr = pstUpload->StartAddr;
+        BlockDataLen = (pstUpload->DataLen < (UPLOAD_MAX_BLOCK_LEN - 2u)) ? pstUpload->DataLen : (UPLOAD_MAX_BLOCK_LEN - 2u);
+    }
     else
     {
-        Flash_InitDowloadInfo();
-        /* Set request transfer data step(0x34 service) */
-        Flash_SetNextDownloadStep(FL_REQUEST_STEP);
-        gs_RxBlockNum = 0u;
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
+        return;
+    }
+
+    /* Read in response directly */
+    if (TRUE != Flash_ReadData(BlockAddr, BlockDataLen, &m_pstPDUMsg->aDataBuf[2u]))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
+        return;
+    }
+
+    if (BlockAddr == pstUpload->StartAddr)
+    {
+        pstUpload->StartAddr += BlockDataLen;
+        pstUpload->DataLen -= BlockDataLen;
+        pstUpload->BlockDataLen = BlockDataLen;
+        pstUpload->BlockNum = BlockNum;
+    }
+
+    /* Transmitted positive message, counter is kept */
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 2u + BlockDataLen;
+}
+
+/* RequestTransferExit of upload, upload is ended */
+static void ExitUpload(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    gs_stUploadDataInfo.IsUploading = FALSE;
+
+    if (0u != gs_stUploadDataInfo.DataLen)
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
+        return;
+    }
+
+    /* Transmitted positive message. */
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 1u;
+}
+
+/* Read memory by address */
+static void ReadMemoryByAddress(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint32 Addr = 0u;
+    uint32 Size = 0u;
+    uint8 NegativeCode = NRC_REQUEST_OUT_OF_RANGE;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    /* SID + addressAndLengthFormatIdentifier + memoryAddress + memorySize */
+    if ((m_pstPDUMsg->xDataLen < 2u) ||
+            (TRUE != GetMemoryAddrAndSize(&m_pstPDUMsg->aDataBuf[1u], m_pstPDUMsg->xDataLen - 1u, &Addr, &Size)))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT, m_pstPDUMsg);
+        return;
+    }
+
+    /* Response is in a UDS message */
+    if (Size > READ_MEMORY_MAX_LEN)
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_OUT_OF_RANGE, m_pstPDUMsg);
+        return;
+    }
+
+    if (TRUE != IsReadMemoryValid(Addr, Size, &NegativeCode))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NegativeCode, m_pstPDUMsg);
+        return;
+    }
+
+    if (TRUE != Flash_ReadData(Addr, Size, &m_pstPDUMsg->aDataBuf[1u]))
+    {
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
+        return;
+    }
+
+    /* Transmitted positive message. */
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 1u + Size;
+}
+#endif
+
+/* Routine control */
+static void RoutineControl(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Index = 0u;
+    uint8 Subfunction = 0u;
+    uint16 RoutineId = 0u;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    RestartS3Server();
+
+    if (m_pstPDUMsg->xDataLen >= 4u)
+    {
+        Subfunction = m_pstPDUMsg->aDataBuf[1u];
+        RoutineId = (uint16)(((uint16)m_pstPDUMsg->aDataBuf[2u] << 8u) | m_pstPDUMsg->aDataBuf[3u]);
+
+        /* Find sub-function and RID in routine control table */
+        for (Index = 0u; Index < (sizeof(gs_astRoutineControlInfo) / sizeof(gs_astRoutineControlInfo[0u])); Index++)
+        {
+            if ((RoutineId == gs_astRoutineControlInfo[Index].RoutineId) &&
+                    (Subfunction == gs_astRoutineControlInfo[Index].Subfunction))
+            {
+                gs_astRoutineControlInfo[Index].pfRoutine(i_pstUDSServiceInfo, m_pstPDUMsg);
+                return;
+            }
+        }
     }
+
+    /* Don't have this routine control ID */
+    SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
 }
 
-/* Request transfer exit */
-static void RequestTransferExit(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+/* Erase memory routine */
+static void EraseMemoryRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
 {
-    uint8 Ret = TRUE;
     ASSERT(NULL_PTR == m_pstPDUMsg);
     ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    /* Erase flash is long running, NRC 0x78 is TX before P2/P2* timeout until response */
+    UDS_StartResponsePending(i_pstUDSServiceInfo->SerNum);
+    Flash_SetOperateFlashActiveJob(FLASH_ERASING, &DoEraseFlashResponse, i_pstUDSServiceInfo->SerNum, &RequestMoreTime);
+    m_pstPDUMsg->xDataLen = 0u;
+}
+
+/* Check sum routine */
+static void CheckSumRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint32 ReceivedCrc = 0u;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    ReceivedCrc = m_pstPDUMsg->aDataBuf[4u];
+    ReceivedCrc = (ReceivedCrc << 8u) | m_pstPDUMsg->aDataBuf[5u];
+    /* TODO Bootloader: #04 SID_31 Uncomment this 2 lines when CRC32 used */
+    //        ReceivedCrc = (ReceivedCrc << 8u) | m_pstPDUMsg->aDataBuf[6u];
+    //        ReceivedCrc = (ReceivedCrc << 8u) | m_pstPDUMsg->aDataBuf[7u];
+    Flash_SavedReceivedCheckSumCrc(ReceivedCrc);
+    /* Check sum is long running, NRC 0x78 is TX before P2/P2* timeout until response */
+    UDS_StartResponsePending(i_pstUDSServiceInfo->SerNum);
+    Flash_SetOperateFlashActiveJob(FLASH_CHECKING, &DoResponseChecksum, i_pstUDSServiceInfo->SerNum, &RequestMoreTime);
+    m_pstPDUMsg->xDataLen = 0u;
+}
 
-    if (FL_EXIT_TRANSFER_STEP != Flash_GetCurDownloadStep())
-    {
-        Ret = FALSE;
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_REQUEST_SEQUENCE_ERROR, m_pstPDUMsg);
-    }
+/* Check programming dependency routine */
+static void CheckProgrammingDependencyRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 Ret = FALSE;
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    /* Write application information in flash. */
+    (void)Flash_WriteFlashAppInfo();
+    /* Do check programming dependency */
+    Ret = DoCheckProgrammingDependency();
 
     if (TRUE == Ret)
     {
-        Flash_SetNextDownloadStep(FL_CHECKSUM_STEP);
-        /* Transmitted positive message. */
         m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
-        m_pstPDUMsg->xDataLen = 1u;
+        m_pstPDUMsg->xDataLen = 4u;
     }
     else
     {
-        Flash_InitDowloadInfo();
+        /* Don't have this routine control ID */
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
     }
 }
 
-/* Routine control */
-static void RoutineControl(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+#ifdef EN_CAN_LIN_GATEWAY
+/* Start routing to LIN slave, LIN slave NAD is optional */
+static void StartLINGatewayRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
 {
-    uint8 Ret = FALSE;
-    uint32 ReceivedCrc = 0u;
+    uint8 SlaveNAD = LIN_GW_SLAVE_NAD;
     ASSERT(NULL_PTR == m_pstPDUMsg);
     ASSERT(NULL_PTR == i_pstUDSServiceInfo);
-    RestartS3Server();
 
-    /* Is erase memory routine control? */
-    if (TRUE == IsEraseMemoryRoutineControl(m_pstPDUMsg))
-    {
-        /* Request client timeout time */
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SERVICE_BUSY, m_pstPDUMsg);
-        m_pstPDUMsg->pfUDSTxMsgServiceCallBack = &DoEraseFlash;
-    }
-    /* Is check sum routine control? */
-    else if (TRUE == IsCheckSumRoutineControl(m_pstPDUMsg))
+    if (m_pstPDUMsg->xDataLen > 4u)
     {
-        ReceivedCrc = m_pstPDUMsg->aDataBuf[4u];
-        ReceivedCrc = (ReceivedCrc << 8u) | m_pstPDUMsg->aDataBuf[5u];
-        /* TODO Bootloader: #04 SID_31 Uncomment this 2 lines when CRC32 used */
-        //        ReceivedCrc = (ReceivedCrc << 8u) | m_pstPDUMsg->aDataBuf[6u];
-        //        ReceivedCrc = (ReceivedCrc << 8u) | m_pstPDUMsg->aDataBuf[7u];
-        Flash_SavedReceivedCheckSumCrc(ReceivedCrc);
-        /* Request client timeout time */
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SERVICE_BUSY, m_pstPDUMsg);
-        m_pstPDUMsg->pfUDSTxMsgServiceCallBack = &DoCheckSum;
+        SlaveNAD = m_pstPDUMsg->aDataBuf[4u];
     }
-    /* Is check programming dependency? */
-    else if (TRUE == IsCheckProgrammingDependency(m_pstPDUMsg))
-    {
-        /* Write application information in flash. */
-        (void)Flash_WriteFlashAppInfo();
-        /* Do check programming dependency */
-        Ret = DoCheckProgrammingDependency();
 
-        if (TRUE == Ret)
-        {
-            m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
-            m_pstPDUMsg->xDataLen = 4u;
-        }
-        else
-        {
-            /* Don't have this routine control ID */
-            SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
-        }
-    }
-    else
+    /* LIN master driver is not ported, nothing can be routed */
+    if (TRUE != LINGW_StartRouting(SlaveNAD))
     {
-        /* Don't have this routine control ID */
-        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_SUBFUNCTION_NOT_SUPPORTED, m_pstPDUMsg);
+        SetNegativeErroCode(i_pstUDSServiceInfo->SerNum, NRC_CONDITIONS_NOT_CORRECT, m_pstPDUMsg);
+        return;
     }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 4u;
+}
+
+/* Stop routing to LIN slave */
+static void StopLINGatewayRoutine(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+    LINGW_StopRouting();
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->SerNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 4u;
 }
+#endif
 
 /* Reset ECU */
 static void ResetECU(struct UDSServiceInfo *i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
@@ -857,12 +2541,17 @@ static void DoResetMCU(uint8 Txstatus)
 }
 
 /**********************UDS service correlation other function realizing************************/
-/* Get UDS service config information */
-tUDSService *GetUDSServiceInfo(uint8 *m_pSupServItem)
+/* Get UDS service config information by SID, not supported service return NULL_PTR */
+const tUDSService *GetUDSServiceInfo(const uint8 i_SerNum)
 {
-    ASSERT(NULL_PTR == m_pSupServItem);
-    *m_pSupServItem = sizeof(gs_astUDSService) / sizeof(gs_astUDSService[0u]);
-    return (tUDSService *) &gs_astUDSService[0u];
+    const tUDSService *pstUDSService = &gs_astUDSService[i_SerNum];
+
+    if (NULL_PTR == pstUDSService->pfSerNameFun)
+    {
+        return NULL_PTR;
+    }
+
+    return pstUDSService;
 }
 
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
@@ -903,6 +2592,15 @@ void SetNegativeErroCode(const uint8 i_UDSServiceNum,
     m_pstPDUMsg->aDataBuf[1u] = i_UDSServiceNum;
     m_pstPDUMsg->aDataBuf[2u] = i_ErroCode;
     m_pstPDUMsg->xDataLen = 3u;
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+
+    if (NRC_SERVICE_BUSY != i_ErroCode)
+    {
+        gs_stLastNegativeResponse.SerNum = i_UDSServiceNum;
+        gs_stLastNegativeResponse.NegativeCode = i_ErroCode;
+    }
+
+#endif
 }
 
 /* Is current session DEFAULT return TRUE, else return FALSE. */
@@ -1013,6 +2711,40 @@ uint8 IsCurSecurityLevelRequet(uint8 i_SerSecurityLevel)
     return status;
 }
 
+/* Is current security level in security mask of a memory range or DID? Locked is only in mask with NONE_SECURITY. */
+uint8 IsCurSecurityLevelInMask(const uint8 i_SecurityMask)
+{
+    uint8 status = FALSE;
+
+    if ((0u != (i_SecurityMask & NONE_SECURITY)) ||
+            (0u != (i_SecurityMask & gs_stUdsInfo.SecurityLevel & (uint8)(~NONE_SECURITY))))
+    {
+        status = TRUE;
+    }
+
+    return status;
+}
+
+/* Is current session, request ID and security level can request? Check them once with permission mask. */
+uint8 IsCurPermissionCanRequest(const uint8 i_SerPermissionMask)
+{
+    uint8 status = FALSE;
+    const uint8 CurPermissionMask = UDS_PermissionMask(gs_stUdsInfo.CurSessionMode,
+                                                       gs_stUdsInfo.RequsetIdMode,
+                                                       gs_stUdsInfo.SecurityLevel);
+
+    if ((i_SerPermissionMask & CurPermissionMask) == CurPermissionMask)
+    {
+        status = TRUE;
+    }
+    else
+    {
+        status = FALSE;
+    }
+
+    return status;
+}
+
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 /**********************UDS service correlation sub-function realizing************************/
 /* APP memcopy */
@@ -1055,103 +2787,6 @@ static uint8 IsReceivedKeyRight(const uint8 *i_pReceivedKey,
     return TRUE;
 }
 
-/* Check routine control right? */
-static uint8 IsCheckRoutineControlRight(const tCheckRoutineCtlInfo i_eCheckRoutineCtlId,
-                                        const tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    uint8 Index = 0u;
-    uint8 FindCnt = 0u;
-    uint8 *pDestRoutineCltId = NULL_PTR;
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-
-    switch (i_eCheckRoutineCtlId)
-    {
-        case ERASE_MEMORY_ROUTINE_CONTROL :
-            pDestRoutineCltId = (uint8 *)&gs_aEraseMemoryRoutineControlId[0u];
-            FindCnt = sizeof(gs_aEraseMemoryRoutineControlId);
-            break;
-
-        case CHECK_SUM_ROUTINE_CONTROL :
-            pDestRoutineCltId = (uint8 *)&gs_aCheckSumRoutineControlId[0u];
-            FindCnt = sizeof(gs_aCheckSumRoutineControlId);
-            break;
-
-        case CHECK_DEPENDENCY_ROUTINE_CONTROL :
-            pDestRoutineCltId = (uint8 *)&gs_aCheckProgrammingDependencyId[0u];
-            FindCnt = sizeof(gs_aCheckProgrammingDependencyId);
-            break;
-
-        default :
-            return FALSE;
-            /* This is not have break */
-    }
-
-    if ((NULL_PTR == pDestRoutineCltId) || (m_pstPDUMsg->xDataLen < FindCnt))
-    {
-        return FALSE;
-    }
-
-    while (Index < FindCnt)
-    {
-        if (m_pstPDUMsg->aDataBuf[Index] != pDestRoutineCltId[Index])
-        {
-            return FALSE;
-        }
-
-        Index++;
-    }
-
-    return TRUE;
-}
-
-/* Is erase memory routine control? */
-static uint8 IsEraseMemoryRoutineControl(const tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-    return IsCheckRoutineControlRight(ERASE_MEMORY_ROUTINE_CONTROL, m_pstPDUMsg);
-}
-
-/* Is check sum routine control? */
-static uint8 IsCheckSumRoutineControl(const tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-    return IsCheckRoutineControlRight(CHECK_SUM_ROUTINE_CONTROL, m_pstPDUMsg);
-}
-
-/* Is check programming dependency? */
-static uint8 IsCheckProgrammingDependency(const tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-    return IsCheckRoutineControlRight(CHECK_DEPENDENCY_ROUTINE_CONTROL, m_pstPDUMsg);
-}
-
-/* Is write finger print right? */
-#pragma GCC diagnostic ignored "-Wunused-function"
-static uint8 IsWriteFingerprintRight(const tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    uint8 Index = 0u;
-    uint8 WriteFingerprintIdLen = 0u;
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-    WriteFingerprintIdLen = sizeof(gs_aWriteFingerprintId);
-
-    if (m_pstPDUMsg->xDataLen < WriteFingerprintIdLen)
-    {
-        return FALSE;
-    }
-
-    while (Index < WriteFingerprintIdLen)
-    {
-        if (m_pstPDUMsg->aDataBuf[Index] != gs_aWriteFingerprintId[Index])
-        {
-            return FALSE;
-        }
-
-        Index++;
-    }
-
-    return TRUE;
-}
-
 /* Is download data address valid? */
 static uint8 IsDownloadDataAddrValid(const uint32 i_DataAddr)
 {
@@ -1164,113 +2799,80 @@ static uint8 IsDownloadDataLenValid(const uint32 i_DataLen)
     return TRUE;
 }
 
-typedef void (*tpfFlashOperateMoreTimecallback)(uint8);
-
-/* For erasing or programming flash were timeout callback */
-static tpfFlashOperateMoreTimecallback gs_pfFlashOperateMoreTimecallback = NULL_PTR;
-
-static void RequestMoreTimeCallback(uint8 i_TxStatus)
+/* Flash job request more time before a blocking job slice. If the time is not enough before next NRC 0x78, TX it now */
+static boolean RequestMoreTime(const uint8 UDSServiceID, const uint32 i_TimeMs, void (*pcallback)(uint8))
 {
-    if (TX_MSG_SUCCESSFUL == i_TxStatus)
-    {
-        RestartS3Server();
-    }
+    tUdsTime xTime = 0u;
+    (void)UDSServiceID;
 
-    if (NULL_PTR != gs_pfFlashOperateMoreTimecallback)
+    /* No long running service, tester is not waiting response */
+    if (RESPONSE_PENDING_IDLE == gs_stUdsResponsePendingInfo.eStatus)
     {
-        gs_pfFlashOperateMoreTimecallback(i_TxStatus);
-        gs_pfFlashOperateMoreTimecallback = NULL_PTR;
+        return TRUE;
     }
-}
-
-static void RequestMoreTime(const uint8 UDSServiceID, void (*pcallback)(uint8))
-{
-    tUdsAppMsgInfo stMsgBuf = {0};
-    ASSERT(NULL_PTR == pcallback);
-    stMsgBuf.xUdsId = TP_GetConfigTxMsgID();
-    SetNegativeErroCode(UDSServiceID, NRC_SERVICE_BUSY, &stMsgBuf);
-    stMsgBuf.pfUDSTxMsgServiceCallBack = &RequestMoreTimeCallback;
-    gs_pfFlashOperateMoreTimecallback = pcallback;
-    (void)TP_WriteAFrameDataInTP(stMsgBuf.xUdsId, stMsgBuf.pfUDSTxMsgServiceCallBack, \
-                                 stMsgBuf.xDataLen, stMsgBuf.aDataBuf);
-}
 
-/* Do check sum. If check sum right return TRUE, else return FALSE. */
-static void DoCheckSum(uint8 TxStatus)
-{
-    if (TX_MSG_SUCCESSFUL == TxStatus)
+    /* Job is longer than P2*, do it after a NRC 0x78 */
+    if (i_TimeMs > UDS_GetUDSP2ExtWatermarkTimerMs())
     {
-        /* Need request client delay time for flash checking flash data */
-        Flash_SetOperateFlashActiveJob(FLASH_CHECKING, &DoResponseChecksum, 0x31u, &RequestMoreTime);
+        xTime = UdsAppTimeToCount(UDS_GetUDSP2ExtWatermarkTimerMs());
     }
-}
-
-/* Do response checksum */
-static void DoResponseChecksum(uint8 i_Status)
-{
-    uint8 Index = 0u;
-    uint8 aResponseBuf[8u] = {0u};
-    uint8 TxDataLen = 0u;
-    tUdsId UdsTxId = 0u;
-    TxDataLen = sizeof(gs_aCheckSumRoutineControlId) / sizeof(gs_aCheckSumRoutineControlId[0u]);
-    aResponseBuf[0u] = gs_aCheckSumRoutineControlId[0u] + 0x40u;
-
-    for (Index = 0u; Index < TxDataLen - 1u; Index++)
+    else
     {
-        aResponseBuf[Index + 1u] = gs_aCheckSumRoutineControlId[Index + 1u];
+        xTime = UdsAppTimeToCount(i_TimeMs);
     }
 
-    if (TRUE == i_Status)
+    if ((RESPONSE_PENDING_TIMING == gs_stUdsResponsePendingInfo.eStatus) &&
+            (gs_stUdsResponsePendingInfo.xPendingTime >= xTime))
     {
-        aResponseBuf[TxDataLen] = 0u;
+        /* Timer is stopped when job disabled interrupts, so sub job time */
+        gs_stUdsResponsePendingInfo.xPendingTime -= xTime;
+        return TRUE;
     }
-    else
+
+    /* TX NRC 0x78 now, job waits it */
+    if (RESPONSE_PENDING_TIMING == gs_stUdsResponsePendingInfo.eStatus)
     {
-        aResponseBuf[TxDataLen] = 1u;
+        gs_stUdsResponsePendingInfo.xPendingTime = 0u;
     }
 
-    TxDataLen++;
-    UdsTxId = TP_GetConfigTxMsgID();
-    (void)TP_WriteAFrameDataInTP(UdsTxId, NULL_PTR, TxDataLen, aResponseBuf);
+    gs_stUdsResponsePendingInfo.pfTxCallBack = pcallback;
+    return FALSE;
+}
+
+/* Do response checksum */
+static void DoResponseChecksum(uint8 i_Status)
+{
+    DoRoutineControlResponse(CHECK_SUM_ROUTINE_ID, i_Status);
 }
 
 /* Do erase flash response */
 static void DoEraseFlashResponse(uint8 i_Status)
 {
-    uint8 Index = 0u;
+    DoRoutineControlResponse(ERASE_MEMORY_ROUTINE_ID, i_Status);
+}
+
+/* Do routine control start routine response, routine status 0 is successful */
+static void DoRoutineControlResponse(const uint16 i_RoutineId, const uint8 i_Status)
+{
     uint8 aResponseBuf[8u] = {0u};
-    uint8 TxDataLen = 0u;
     tUdsId UdsTxId = 0u;
-    TxDataLen = sizeof(gs_aEraseMemoryRoutineControlId) / sizeof(gs_aEraseMemoryRoutineControlId[0u]);
-    aResponseBuf[0u] = gs_aEraseMemoryRoutineControlId[0u] + 0x40u;
-
-    for (Index = 0u; Index < TxDataLen - 1u; Index++)
-    {
-        aResponseBuf[Index + 1u] = gs_aEraseMemoryRoutineControlId[Index + 1u];
-    }
+    UDS_StopResponsePending();
+    aResponseBuf[0u] = 0x31u + 0x40u;
+    aResponseBuf[1u] = 0x01u;
+    aResponseBuf[2u] = (uint8)(i_RoutineId >> 8u);
+    aResponseBuf[3u] = (uint8)i_RoutineId;
 
     if (TRUE == i_Status)
     {
-        aResponseBuf[TxDataLen] = 0u;
+        aResponseBuf[4u] = 0u;
     }
     else
     {
-        aResponseBuf[TxDataLen] = 1u;
+        aResponseBuf[4u] = 1u;
     }
 
-    TxDataLen++;
     UdsTxId = TP_GetConfigTxMsgID();
-    (void)TP_WriteAFrameDataInTP(UdsTxId, NULL_PTR, TxDataLen, aResponseBuf);
-}
-
-/* Do erase flash */
-static void DoEraseFlash(uint8 TxStatus)
-{
-    if (TX_MSG_SUCCESSFUL == TxStatus)
-    {
-        /* Do erase flash need request client delay timeout */
-        Flash_SetOperateFlashActiveJob(FLASH_ERASING, &DoEraseFlashResponse, 0x31, &RequestMoreTime);
-    }
+    (void)TP_WriteAFrameDataInTP(UdsTxId, NULL_PTR, 5u, aResponseBuf);
 }
 
 /* Do check programming dependency */
@@ -1314,38 +2916,147 @@ static void TXConfrimMsgCallback(uint8 i_status)
 /* Write message to host based on UDS for request enter bootloader mode */
 boolean UDS_TxMsgToHost(void)
 {
-    tUdsAppMsgInfo stUdsAppMsg = {0u, 0u, {0u}, NULL_PTR};
+    uint8 aMsgBuf[2u] = {0u};
+    tpfUDSTxMsgCallBack pfTxMsgCallBack = NULL_PTR;
     boolean ret = FALSE;
-    stUdsAppMsg.xUdsId = TP_GetConfigTxMsgID();
-    stUdsAppMsg.xDataLen = 2;
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
-    stUdsAppMsg.aDataBuf[0u] = 0x50u;
-    stUdsAppMsg.aDataBuf[1u] = 0x02u;
-    stUdsAppMsg.pfUDSTxMsgServiceCallBack = TXConfrimMsgCallback;
+    aMsgBuf[0u] = 0x50u;
+    aMsgBuf[1u] = 0x02u;
+    pfTxMsgCallBack = TXConfrimMsgCallback;
 #endif
 #ifdef UDS_PROJECT_FOR_APP
-    stUdsAppMsg.aDataBuf[0u] = 0x51u;
-    stUdsAppMsg.aDataBuf[1u] = 0x01u;
-    stUdsAppMsg.pfUDSTxMsgServiceCallBack = NULL_PTR;
+    aMsgBuf[0u] = 0x51u;
+    aMsgBuf[1u] = 0x01u;
+    pfTxMsgCallBack = NULL_PTR;
 #endif
-    ret = TP_WriteAFrameDataInTP(stUdsAppMsg.xUdsId, stUdsAppMsg.pfUDSTxMsgServiceCallBack,
-                                 stUdsAppMsg.xDataLen, stUdsAppMsg.aDataBuf);
+    ret = TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), pfTxMsgCallBack, sizeof(aMsgBuf), aMsgBuf);
     return ret;
 }
 
+/* Long running service start, NRC 0x78 is TX at P2 water mark and then P2* water mark until stop */
+void UDS_StartResponsePending(const uint8 i_SerNum)
+{
+    gs_stUdsResponsePendingInfo.SerNum = i_SerNum;
+    gs_stUdsResponsePendingInfo.eStatus = RESPONSE_PENDING_TIMING;
+    gs_stUdsResponsePendingInfo.xPendingTime =
+        UdsAppTimeToCount((gs_stUdsAppCfg.xP2Server * P2_TIMER_WATERMARK_PERCENT) / 100u);
+    gs_stUdsResponsePendingInfo.pfTxCallBack = NULL_PTR;
+    gs_stUdsResponsePendingInfo.eChannel = TP_GetCurChannel();
+}
+
+/* Long running service stop, call it before TX the final response */
+void UDS_StopResponsePending(void)
+{
+    /* Other channels may received requests while service running, TX final response on the channel of the service */
+    if (RESPONSE_PENDING_IDLE != gs_stUdsResponsePendingInfo.eStatus)
+    {
+        TP_SetCurChannel(gs_stUdsResponsePendingInfo.eChannel);
+    }
+
+    gs_stUdsResponsePendingInfo.eStatus = RESPONSE_PENDING_IDLE;
+    gs_stUdsResponsePendingInfo.xPendingTime = 0u;
+    gs_stUdsResponsePendingInfo.pfTxCallBack = NULL_PTR;
+}
+
+/* Is long running service pending? */
+boolean UDS_IsResponsePending(void)
+{
+    return (RESPONSE_PENDING_IDLE != gs_stUdsResponsePendingInfo.eStatus) ? TRUE : FALSE;
+}
+
+/* NRC 0x78 TX callback, restart P2* timer */
+static void ResponsePendingTxCallBack(uint8 i_TxStatus)
+{
+    void (*pfTxCallBack)(uint8) = gs_stUdsResponsePendingInfo.pfTxCallBack;
+
+    /* Service stopped when NRC 0x78 is TX */
+    if (RESPONSE_PENDING_TX != gs_stUdsResponsePendingInfo.eStatus)
+    {
+        return;
+    }
+
+    gs_stUdsResponsePendingInfo.eStatus = RESPONSE_PENDING_TIMING;
+
+    if (TX_MSG_SUCCESSFUL == i_TxStatus)
+    {
+        RestartS3Server();
+        gs_stUdsResponsePendingInfo.xPendingTime = UdsAppTimeToCount(UDS_GetUDSP2ExtWatermarkTimerMs());
+        gs_stUdsResponsePendingInfo.pfTxCallBack = NULL_PTR;
+
+        if (NULL_PTR != pfTxCallBack)
+        {
+            pfTxCallBack(i_TxStatus);
+        }
+    }
+    else
+    {
+        /* TX NRC 0x78 again, job waits it. If it always failed, S3 timeout stops the service. */
+        gs_stUdsResponsePendingInfo.xPendingTime = 0u;
+    }
+}
+
+/* TX NRC 0x78 of long running service at P2/P2* water mark */
+void UDS_ResponsePendingMainFun(void)
+{
+    uint8 aMsgBuf[3u] = {NEGTIVE_RESPONSE_ID, 0u, NRC_SERVICE_BUSY};
+    tTPChannel eCurChannel = TP_GetCurChannel();
+
+    if ((RESPONSE_PENDING_TIMING != gs_stUdsResponsePendingInfo.eStatus) ||
+            (0u != gs_stUdsResponsePendingInfo.xPendingTime))
+    {
+        return;
+    }
+
+    aMsgBuf[1u] = gs_stUdsResponsePendingInfo.SerNum;
+    gs_stUdsResponsePendingInfo.eStatus = RESPONSE_PENDING_TX;
+    /* TX NRC 0x78 on the channel of the service, current channel may be changed by requests of other channels */
+    TP_SetCurChannel(gs_stUdsResponsePendingInfo.eChannel);
+
+    if (TRUE != TP_WriteAFrameDataInTP(TP_GetConfigTxMsgID(), &ResponsePendingTxCallBack,
+                                       sizeof(aMsgBuf), aMsgBuf))
+    {
+        /* TP is busy, TX it next time */
+        gs_stUdsResponsePendingInfo.eStatus = RESPONSE_PENDING_TIMING;
+    }
+
+    TP_SetCurChannel(eCurChannel);
+}
+
 /* UDS time control */
 void UDS_SystemTickCtl(void)
 {
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+    uint8 Index = 0u;
+#endif
+
     if (GetUdsS3ServerTime())
     {
         SubUdsS3ServerTime(1u);
     }
 
+    if ((RESPONSE_PENDING_TIMING == gs_stUdsResponsePendingInfo.eStatus) &&
+            (0u != gs_stUdsResponsePendingInfo.xPendingTime))
+    {
+        gs_stUdsResponsePendingInfo.xPendingTime--;
+    }
+
     if (GetUdsSecurityReqLockTime())
     {
         SubUdsSecurityReqLockTime(1u);
     }
 
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+
+    for (Index = 0u; Index < PERIODIC_DID_MAX_NUM; Index++)
+    {
+        if (0u != gs_astPeriodicDidInfo[Index].xTimer)
+        {
+            gs_astPeriodicDidInfo[Index].xTimer--;
+        }
+    }
+
+#endif
+
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 #ifdef EN_DELAY_TIME
 
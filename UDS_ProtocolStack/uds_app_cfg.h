@@ -14,26 +14,31 @@
 
 #include "includes.h"
 #include "TP.h"
+#include "flash_hal_Cfg.h"
 
 typedef uint16 tUdsTime;
 
+/* Max UDS message len, a whole request reassembled by TP is in it */
+#define UDS_MAX_MSG_LEN (TP_MAX_MSG_LEN)
+
 typedef struct
 {
     tUdsId xUdsId;
     tUdsLen xDataLen;
-    uint8 aDataBuf[150u];
+    uint8 aDataBuf[UDS_MAX_MSG_LEN];
     void (*pfUDSTxMsgServiceCallBack)(uint8); /* TX message callback */
 } tUdsAppMsgInfo;
 
 typedef struct UDSServiceInfo
 {
-    uint8 SerNum;      /* Service ID eg 0x3E/0x87... */
-    uint8 SessionMode; /* Default session / program session / extend session */
-    uint8 SupReqMode;  /* Support physical / function addr */
-    uint8 ReqLevel;    /* Request level. Lock / unlock */
+    uint8 SerNum;         /* Service ID eg 0x3E/0x87... */
+    uint8 PermissionMask; /* Session / request addr / request level mask, see UDS_PermissionMask */
     void (*pfSerNameFun)(struct UDSServiceInfo *, tUdsAppMsgInfo *);
 } tUDSService;
 
+/* UDS service table is indexed by SID */
+#define UDS_SID_NUM (256u)
+
 /* S3 timer water mark time percent */
 #ifndef S3_TIMER_WATERMARK_PERCENT
 #define S3_TIMER_WATERMARK_PERCENT (90u)
@@ -43,6 +48,15 @@ typedef struct UDSServiceInfo
 #error "S3_TIMER_WATERMARK_PERCENT should config (0, 100]"
 #endif
 
+/* P2/P2* timer water mark time percent, NRC 0x78 is TX at the water mark */
+#ifndef P2_TIMER_WATERMARK_PERCENT
+#define P2_TIMER_WATERMARK_PERCENT (90u)
+#endif
+
+#if (P2_TIMER_WATERMARK_PERCENT <= 0) || (P2_TIMER_WATERMARK_PERCENT >= 100)
+#error "P2_TIMER_WATERMARK_PERCENT should config (0, 100]"
+#endif
+
 /* UDS negative response code */
 enum __UDS_NRC__
 {
@@ -50,6 +64,7 @@ enum __UDS_NRC__
     NRC_SERVICE_NOT_SUPPORTED                    = 0x11,
     NRC_SUBFUNCTION_NOT_SUPPORTED                = 0x12,
     NRC_INVALID_MESSAGE_LENGTH_OR_FORMAT         = 0x13,
+    NRC_RESPONSE_TOO_LONG                        = 0x14,
     NRC_BUSY_REPEAT_REQUEST                      = 0x21,
     NRC_CONDITIONS_NOT_CORRECT                   = 0x22,
     NRC_REQUEST_SEQUENCE_ERROR                   = 0x24,
@@ -75,6 +90,19 @@ enum __UDS_NRC__
 #define SECURITY_LEVEL_1 ((1 << 1u) | NONE_SECURITY)      /* Security level 1 request */
 #define SECURITY_LEVEL_2 ((1u << 2u) | SECURITY_LEVEL_1)  /* Security level 2 request */
 
+/* Security mask of memory ranges and DIDs: NONE_SECURITY is public, other bits are unlocked levels.
+** SECURITY_LEVEL_x includes NONE_SECURITY, so it is not denied while locked here. */
+#define UNLOCKED_SECURITY_LEVEL_1 (1u << 1u)            /* Security level 1 or 2 unlocked */
+
+/* Service permission mask: session (bit 0 ~ 2) | request addr (bit 3 ~ 4) | security level (bit 5 ~ 7).
+** Service can request if (service mask & current mask) == current mask, same as check them one by one. */
+#define UDS_PermissionMask(xSession, xReqAddr, xLevel) \
+    ((uint8)((uint32)(xSession) | ((uint32)(xReqAddr) << 3u) | ((uint32)(xLevel) << 5u)))
+
+#if (EXTEND_SESSION > 0x07u) || (SECURITY_LEVEL_2 > 0x07u)
+#error "Session and security level should be in 3 bits of UDS_PermissionMask"
+#endif
+
 typedef struct
 {
     uint8 CalledPeriod;         /* called UDS period */
@@ -82,6 +110,8 @@ typedef struct
     uint8 SecurityRequestCnt;
     tUdsTime xLockTime;         /* Lock time */
     tUdsTime xS3Server;         /* S3 Server time */
+    tUdsTime xP2Server;         /* P2 Server time, max time of response after request */
+    tUdsTime xP2ExtServer;      /* P2* Server time, max time of response after NRC 0x78 */
 } tUdsTimeInfo;
 
 extern const tUdsTimeInfo gs_stUdsAppCfg;
@@ -117,7 +147,11 @@ void SetSecurityLevel(const uint8 i_SerSecurityLevel);
 
 uint8 IsCurSecurityLevelRequet(uint8 i_SerSecurityLevel);
 
-tUDSService *GetUDSServiceInfo(uint8 *m_pSupServItem);
+uint8 IsCurSecurityLevelInMask(const uint8 i_SecurityMask);
+
+uint8 IsCurPermissionCanRequest(const uint8 i_SerPermissionMask);
+
+const tUDSService *GetUDSServiceInfo(const uint8 i_SerNum);
 
 #ifdef UDS_PROJECT_FOR_BOOTLOADER
 void SetIsRxUdsMsg(const boolean i_SetValue);
@@ -133,8 +167,24 @@ void UDS_SystemTickCtl(void);
 
 uint32 UDS_GetUDSS3WatermarkTimerMs(void);
 
+uint32 UDS_GetUDSP2ExtWatermarkTimerMs(void);
+
+void UDS_StartResponsePending(const uint8 i_SerNum);
+
+void UDS_StopResponsePending(void);
+
+boolean UDS_IsResponsePending(void);
+
+void UDS_ResponsePendingMainFun(void);
+
 boolean UDS_TxMsgToHost(void);
 
+#if (defined UDS_PROJECT_FOR_BOOTLOADER) && (defined EN_PERIODIC_DID)
+void UDS_StopPeriodicDid(void);
+
+void UDS_PeriodicDidMainFun(void);
+#endif
+
 #endif /* UDS_APP_CFG_H_ */
 
 /* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,597 @@
+/*
+ * @ : xcp.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "xcp.h"
+
+#ifdef EN_XCP_ON_CAN
+
+#include "fls_app.h"
+#include "uds_app_cfg.h"
+#include "watchdog_hal.h"
+#include "boot_Cfg.h"
+
+/*********************************************************
+**  XCP packet: PID | data...
+**  CMD - master to slave, PID = command code
+**  RES - positive response, PID = 0xFF
+**  ERR - negative response, PID = 0xFE, error code
+**  EV  - event, PID = 0xFD, event code
+*********************************************************/
+#define XCP_PID_RES (0xFFu)
+#define XCP_PID_ERR (0xFEu)
+#define XCP_PID_EV (0xFDu)
+
+/* Supported commands */
+#define XCP_CMD_CONNECT (0xFFu)
+#define XCP_CMD_DISCONNECT (0xFEu)
+#define XCP_CMD_GET_STATUS (0xFDu)
+#define XCP_CMD_SYNCH (0xFCu)
+#define XCP_CMD_SET_MTA (0xF6u)
+#define XCP_CMD_BUILD_CHECKSUM (0xF3u)
+#define XCP_CMD_PROGRAM_START (0xD2u)
+#define XCP_CMD_PROGRAM_CLEAR (0xD1u)
+#define XCP_CMD_PROGRAM (0xD0u)
+#define XCP_CMD_PROGRAM_RESET (0xCFu)
+#define XCP_CMD_PROGRAM_NEXT (0xCAu)
+
+/* Error codes */
+#define XCP_ERR_CMD_SYNCH (0x00u)
+#define XCP_ERR_CMD_UNKNOWN (0x20u)
+#define XCP_ERR_CMD_SYNTAX (0x21u)
+#define XCP_ERR_OUT_OF_RANGE (0x22u)
+#define XCP_ERR_SEQUENCE (0x29u)
+#define XCP_ERR_GENERIC (0x31u)
+
+/* Event codes */
+#define XCP_EV_CMD_PENDING (0x05u)
+
+#define XCP_RESOURCE_PGM (0x10u)      /* CONNECT resource: PGM only */
+#define XCP_COMM_MODE_BASIC (0x00u)   /* CONNECT comm mode: Intel byte order, byte granularity */
+#define XCP_COMM_MODE_PGM (0x01u)     /* PROGRAM_START comm mode: master block mode */
+#define XCP_PROTOCOL_VERSION (0x01u)  /* XCP protocol layer version */
+#define XCP_TRANSPORT_VERSION (0x01u) /* XCP on CAN transport layer version */
+
+#define XCP_CHECKSUM_MAX_SIZE (APP_A_END_ADDR - APP_A_START_ADDR)
+
+/* Command handler, i_pCmd[0] is command code */
+typedef void (*tpfXCPCmd)(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+typedef struct
+{
+    uint8 ucCmd;        /* Command code */
+    uint8 ucMinLen;     /* Command min len */
+    uint8 isNeedPgm;    /* Need PROGRAM_START first */
+    tpfXCPCmd pfCmd;    /* Command handler */
+} tXCPCmdInfo;
+
+typedef struct
+{
+    uint8 isConnected;                      /* Master connected */
+    uint8 isPgmStarted;                     /* PROGRAM_START done */
+    uint8 isWaitFlashJob;                   /* Response is TX after fls_app job finished */
+    uint8 ucBlockLen;                       /* Current PROGRAM block len, 0 = no block */
+    uint8 ucBlockRxLen;                     /* Current PROGRAM block len already RX */
+    uint32 mta;                             /* Memory transfer address */
+    uint8 aBlockBuf[XCP_MAX_BLOCK_LEN];     /* PROGRAM block buffer */
+    void (*pfPendingCallBack)(uint8);       /* fls_app request more time callback */
+    uint8 isPendingTimeValid;               /* A fls_app job slice can be done, master restarted its timeout */
+} tXCPInfo;
+
+static tXCPInfo gs_stXCPInfo;
+
+static void XCP_DoConnect(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoDisconnect(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoGetStatus(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoSynch(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoSetMTA(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoBuildChecksum(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoProgramStart(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoProgramClear(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoProgram(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoProgramReset(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+static void XCP_DoProgramNext(const uint8 *i_pCmd, const uint8 i_cmdLen);
+
+/* Supported commands, CONNECT is the only command accepted before connected */
+static const tXCPCmdInfo gs_astXCPCmd[] =
+{
+    {XCP_CMD_CONNECT, 2u, FALSE, XCP_DoConnect},
+    {XCP_CMD_DISCONNECT, 1u, FALSE, XCP_DoDisconnect},
+    {XCP_CMD_GET_STATUS, 1u, FALSE, XCP_DoGetStatus},
+    {XCP_CMD_SYNCH, 1u, FALSE, XCP_DoSynch},
+    {XCP_CMD_SET_MTA, 8u, FALSE, XCP_DoSetMTA},
+    {XCP_CMD_BUILD_CHECKSUM, 8u, TRUE, XCP_DoBuildChecksum},
+    {XCP_CMD_PROGRAM_START, 1u, FALSE, XCP_DoProgramStart},
+    {XCP_CMD_PROGRAM_CLEAR, 8u, TRUE, XCP_DoProgramClear},
+    {XCP_CMD_PROGRAM, 2u, TRUE, XCP_DoProgram},
+    {XCP_CMD_PROGRAM_RESET, 1u, TRUE, XCP_DoProgramReset},
+    {XCP_CMD_PROGRAM_NEXT, 2u, TRUE, XCP_DoProgramNext},
+};
+
+/* TX a response frame */
+static void XCP_TxResp(const uint8 *i_pRespBuf, const uint8 i_respLen, const tpfUDSTxMsgCallBack i_pfCallBack)
+{
+    /* If TX failed, master will timeout and SYNCH */
+    (void)g_stXCPCfgInfo.pfNetTx(i_pRespBuf, i_respLen, i_pfCallBack);
+}
+
+/* TX a positive response without data */
+static void XCP_TxPosResp(void)
+{
+    const uint8 aResp[1u] = {XCP_PID_RES};
+
+    XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+}
+
+/* TX a negative response */
+static void XCP_TxErrResp(const uint8 i_errCode)
+{
+    const uint8 aResp[2u] = {XCP_PID_ERR, i_errCode};
+
+    XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+}
+
+/* Abort current PROGRAM block */
+static void XCP_AbortBlock(void)
+{
+    gs_stXCPInfo.ucBlockLen = 0u;
+    gs_stXCPInfo.ucBlockRxLen = 0u;
+}
+
+/* Get little endian uint32 */
+static uint32 XCP_GetU32(const uint8 *i_pBuf)
+{
+    return ((uint32)i_pBuf[3u] << 24u) | ((uint32)i_pBuf[2u] << 16u) | ((uint32)i_pBuf[1u] << 8u) | i_pBuf[0u];
+}
+
+/* fls_app erase/program job finished */
+static void XCP_DoFlashJobResponse(uint8 i_status)
+{
+    gs_stXCPInfo.isWaitFlashJob = FALSE;
+
+    if (TRUE == i_status)
+    {
+        XCP_TxPosResp();
+    }
+    else
+    {
+        XCP_TxErrResp(XCP_ERR_GENERIC);
+    }
+}
+
+/* fls_app check sum job finished, master compares the checksum */
+static void XCP_DoChecksumResponse(uint8 i_status)
+{
+    const uint32 checksum = Flash_GetCountedCheckSumCrc();
+    uint8 aResp[8u] = {XCP_PID_RES, XCP_CHECKSUM_TYPE, 0u, 0u, 0u, 0u, 0u, 0u};
+
+    gs_stXCPInfo.isWaitFlashJob = FALSE;
+
+    if (TRUE != i_status)
+    {
+        XCP_TxErrResp(XCP_ERR_GENERIC);
+        return;
+    }
+
+    aResp[4u] = (uint8)checksum;
+    aResp[5u] = (uint8)(checksum >> 8u);
+    aResp[6u] = (uint8)(checksum >> 16u);
+    aResp[7u] = (uint8)(checksum >> 24u);
+    XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+}
+
+/* EV_CMD_PENDING TX callback, fls_app continue erasing */
+static void XCP_TxPendingCallBack(uint8 i_status)
+{
+    void (*pfPendingCallBack)(uint8) = gs_stXCPInfo.pfPendingCallBack;
+
+    gs_stXCPInfo.pfPendingCallBack = NULL_PTR;
+
+    if (TX_MSG_SUCCESSFUL == i_status)
+    {
+        gs_stXCPInfo.isPendingTimeValid = TRUE;
+    }
+
+    if (NULL_PTR != pfPendingCallBack)
+    {
+        pfPendingCallBack(i_status);
+    }
+}
+
+/* fls_app request more time: a job slice is done after EV_CMD_PENDING, master restarts its timeout */
+static boolean XCP_RequestMoreTime(uint8 i_cmd, uint32 i_timeMs, void (*i_pfRequestMoreTimeCallback)(uint8))
+{
+    const uint8 aEvent[2u] = {XCP_PID_EV, XCP_EV_CMD_PENDING};
+    (void)i_cmd;
+    (void)i_timeMs;
+
+    if (TRUE == gs_stXCPInfo.isPendingTimeValid)
+    {
+        gs_stXCPInfo.isPendingTimeValid = FALSE;
+        return TRUE;
+    }
+
+    gs_stXCPInfo.pfPendingCallBack = i_pfRequestMoreTimeCallback;
+
+    if (TRUE != g_stXCPCfgInfo.pfNetTx(aEvent, sizeof(aEvent), XCP_TxPendingCallBack))
+    {
+        XCP_TxPendingCallBack(TX_MSG_FAILD);
+    }
+
+    return FALSE;
+}
+
+/* CONNECT: only normal mode */
+static void XCP_DoConnect(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint8 aResp[8u] =
+    {
+        XCP_PID_RES,
+        XCP_RESOURCE_PGM,
+        XCP_COMM_MODE_BASIC,
+        XCP_MAX_CTO,
+        (uint8)XCP_MAX_DTO,
+        (uint8)(XCP_MAX_DTO >> 8u),
+        XCP_PROTOCOL_VERSION,
+        XCP_TRANSPORT_VERSION
+    };
+    (void)i_cmdLen;
+
+    if (0u != i_pCmd[1u])
+    {
+        XCP_TxErrResp(XCP_ERR_OUT_OF_RANGE);
+        return;
+    }
+
+    gs_stXCPInfo.isConnected = TRUE;
+#ifdef UDS_PROJECT_FOR_BOOTLOADER
+    /* Stay in bootloader */
+    SetIsRxUdsMsg(TRUE);
+#endif
+    XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+}
+
+/* DISCONNECT */
+static void XCP_DoDisconnect(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    (void)i_pCmd;
+    (void)i_cmdLen;
+
+    XCP_AbortBlock();
+    gs_stXCPInfo.isPgmStarted = FALSE;
+    gs_stXCPInfo.isConnected = FALSE;
+    XCP_TxPosResp();
+}
+
+/* GET_STATUS: no session status and no resource protection */
+static void XCP_DoGetStatus(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint8 aResp[6u] = {XCP_PID_RES, 0u, 0u, 0u, 0u, 0u};
+    (void)i_pCmd;
+    (void)i_cmdLen;
+
+    XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+}
+
+/* SYNCH: abort current block */
+static void XCP_DoSynch(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    (void)i_pCmd;
+    (void)i_cmdLen;
+
+    XCP_AbortBlock();
+    XCP_TxErrResp(XCP_ERR_CMD_SYNCH);
+}
+
+/* SET_MTA: address extension is not used */
+static void XCP_DoSetMTA(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    (void)i_cmdLen;
+
+    XCP_AbortBlock();
+    gs_stXCPInfo.mta = XCP_GetU32(&i_pCmd[4u]);
+    XCP_TxPosResp();
+}
+
+/* BUILD_CHECKSUM: fls_app check sum from MTA, master compares the checksum */
+static void XCP_DoBuildChecksum(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint32 blockSize = XCP_GetU32(&i_pCmd[4u]);
+    (void)i_cmdLen;
+
+    if ((0u == blockSize) || (blockSize > XCP_CHECKSUM_MAX_SIZE))
+    {
+        XCP_TxErrResp(XCP_ERR_OUT_OF_RANGE);
+        return;
+    }
+
+    Flash_SaveDownloadDataInfo(gs_stXCPInfo.mta, blockSize);
+    Flash_SetCheckSumVerifiedByHost();
+    Flash_SetOperateFlashActiveJob(FLASH_CHECKING, XCP_DoChecksumResponse, XCP_CMD_BUILD_CHECKSUM, NULL_PTR);
+    gs_stXCPInfo.mta += blockSize;
+    gs_stXCPInfo.isWaitFlashJob = TRUE;
+}
+
+/* PROGRAM_START */
+static void XCP_DoProgramStart(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint8 aResp[7u] =
+    {
+        XCP_PID_RES,
+        0u,
+        XCP_COMM_MODE_PGM,
+        XCP_MAX_CTO,
+        g_stXCPCfgInfo.ucMaxBsPgm,
+        g_stXCPCfgInfo.ucMinStPgm,
+        0u
+    };
+    (void)i_pCmd;
+    (void)i_cmdLen;
+
+    XCP_AbortBlock();
+    gs_stXCPInfo.isPgmStarted = TRUE;
+    XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+}
+
+/* PROGRAM_CLEAR: erase whole APP flash like UDS erase memory routine, clear range is not used */
+static void XCP_DoProgramClear(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    (void)i_cmdLen;
+
+    XCP_AbortBlock();
+
+    /* Only absolute access mode */
+    if (0u != i_pCmd[1u])
+    {
+        XCP_TxErrResp(XCP_ERR_OUT_OF_RANGE);
+        return;
+    }
+
+    /* Flash driver should be programmed and checked first */
+    if (TRUE != Flash_IsFlashDriverDownloaded())
+    {
+        XCP_TxErrResp(XCP_ERR_SEQUENCE);
+        return;
+    }
+
+    Flash_SetOperateFlashActiveJob(FLASH_ERASING, XCP_DoFlashJobResponse, XCP_CMD_PROGRAM_CLEAR, XCP_RequestMoreTime);
+    gs_stXCPInfo.isWaitFlashJob = TRUE;
+    /* First erase slice is in the PROGRAM_CLEAR timeout */
+    gs_stXCPInfo.isPendingTimeValid = TRUE;
+}
+
+/* Program a whole block at MTA */
+static void XCP_ProgramBlock(void)
+{
+    const uint32 blockLen = gs_stXCPInfo.ucBlockLen;
+
+    XCP_AbortBlock();
+    Flash_SetNextDownloadStep(FL_TRANSFER_STEP);
+    Flash_SaveDownloadDataInfo(gs_stXCPInfo.mta, blockLen);
+
+    if (TRUE != Flash_ProgramRegion(gs_stXCPInfo.mta, gs_stXCPInfo.aBlockBuf, blockLen))
+    {
+        XCP_TxErrResp(XCP_ERR_GENERIC);
+        return;
+    }
+
+    gs_stXCPInfo.mta += blockLen;
+
+    /* Flash driver is copied to RAM already, APP data is programmed by fls_app job */
+    if (FLASH_PROGRAMMING == Flash_GetOperateFlashActiveJob())
+    {
+        Flash_RegisterJobCallback(XCP_DoFlashJobResponse);
+        gs_stXCPInfo.isWaitFlashJob = TRUE;
+    }
+    else
+    {
+        XCP_TxPosResp();
+    }
+}
+
+/* Save PROGRAM/PROGRAM_NEXT data in block buffer, program the block if it is complete */
+static void XCP_SaveBlockData(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    uint8 ucDataLen = gs_stXCPInfo.ucBlockLen - gs_stXCPInfo.ucBlockRxLen;
+
+    if (ucDataLen > (XCP_MAX_CTO - 2u))
+    {
+        ucDataLen = XCP_MAX_CTO - 2u;
+    }
+
+    if (i_cmdLen < (2u + ucDataLen))
+    {
+        XCP_AbortBlock();
+        XCP_TxErrResp(XCP_ERR_CMD_SYNTAX);
+        return;
+    }
+
+    fsl_memcpy(&gs_stXCPInfo.aBlockBuf[gs_stXCPInfo.ucBlockRxLen], &i_pCmd[2u], ucDataLen);
+    gs_stXCPInfo.ucBlockRxLen += ucDataLen;
+
+    if (gs_stXCPInfo.ucBlockRxLen >= gs_stXCPInfo.ucBlockLen)
+    {
+        XCP_ProgramBlock();
+    }
+}
+
+/* PROGRAM: first frame of a block, size 0 is end of memory segment */
+static void XCP_DoProgram(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint8 ucSize = i_pCmd[1u];
+
+    XCP_AbortBlock();
+
+    if (0u == ucSize)
+    {
+        XCP_TxPosResp();
+        return;
+    }
+
+    /* A block is programmed in flash phrases, only the last block of a segment may be not aligned */
+    if ((ucSize > XCP_MAX_BLOCK_LEN) || (0u != (gs_stXCPInfo.mta & (XCP_PGM_ALIGN - 1u))))
+    {
+        XCP_TxErrResp(XCP_ERR_OUT_OF_RANGE);
+        return;
+    }
+
+    gs_stXCPInfo.ucBlockLen = ucSize;
+    XCP_SaveBlockData(i_pCmd, i_cmdLen);
+}
+
+/* PROGRAM_NEXT: next frame of a block, size is remaining block len */
+static void XCP_DoProgramNext(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint8 ucRemainLen = gs_stXCPInfo.ucBlockLen - gs_stXCPInfo.ucBlockRxLen;
+    uint8 aResp[3u] = {XCP_PID_ERR, XCP_ERR_SEQUENCE, 0u};
+
+    if ((0u == gs_stXCPInfo.ucBlockLen) || (i_pCmd[1u] != ucRemainLen))
+    {
+        /* Tell master the expected remaining len */
+        aResp[2u] = ucRemainLen;
+        XCP_AbortBlock();
+        XCP_TxResp(aResp, sizeof(aResp), NULL_PTR);
+        return;
+    }
+
+    XCP_SaveBlockData(i_pCmd, i_cmdLen);
+}
+
+/* PROGRAM_RESET TX callback */
+static void XCP_DoResetMCU(uint8 i_status)
+{
+    if (TX_MSG_SUCCESSFUL == i_status)
+    {
+        /* Reset ECU */
+        WATCHDOG_HAL_SystemReset();
+
+        while (1)
+        {
+            /* Wait watch dog reset MCU */
+        }
+    }
+}
+
+/* PROGRAM_RESET: write APP info if APP is programmed, then reset like UDS ECU reset */
+static void XCP_DoProgramReset(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    const uint8 aResp[1u] = {XCP_PID_RES};
+    (void)i_pCmd;
+    (void)i_cmdLen;
+
+    XCP_AbortBlock();
+
+    if (TRUE == Flash_IsAppInFlashValid())
+    {
+        (void)Flash_WriteFlashAppInfo();
+    }
+
+#ifdef UDS_PROJECT_FOR_BOOTLOADER
+    Flash_EraseFlashDriverInRAM();
+    SetDownloadAppSuccessful();
+#endif
+    XCP_TxResp(aResp, sizeof(aResp), XCP_DoResetMCU);
+}
+
+/* Do a command */
+static void XCP_DoCommand(const uint8 *i_pCmd, const uint8 i_cmdLen)
+{
+    uint8 index = 0u;
+    const tXCPCmdInfo *pstCmdInfo = NULL_PTR;
+
+    for (index = 0u; index < (sizeof(gs_astXCPCmd) / sizeof(gs_astXCPCmd[0u])); index++)
+    {
+        if (i_pCmd[0u] == gs_astXCPCmd[index].ucCmd)
+        {
+            pstCmdInfo = &gs_astXCPCmd[index];
+            break;
+        }
+    }
+
+    /* Not connected, slave is silent except CONNECT */
+    if ((TRUE != gs_stXCPInfo.isConnected) && (XCP_CMD_CONNECT != i_pCmd[0u]))
+    {
+        return;
+    }
+
+    if (NULL_PTR == pstCmdInfo)
+    {
+        XCP_AbortBlock();
+        XCP_TxErrResp(XCP_ERR_CMD_UNKNOWN);
+        return;
+    }
+
+    if (i_cmdLen < pstCmdInfo->ucMinLen)
+    {
+        XCP_AbortBlock();
+        XCP_TxErrResp(XCP_ERR_CMD_SYNTAX);
+        return;
+    }
+
+    if ((TRUE == pstCmdInfo->isNeedPgm) && (TRUE != gs_stXCPInfo.isPgmStarted))
+    {
+        XCP_AbortBlock();
+        XCP_TxErrResp(XCP_ERR_SEQUENCE);
+        return;
+    }
+
+    /* Keep fls_app download info, UDS S3 timeout would init it */
+    RestartS3Server();
+    pstCmdInfo->pfCmd(i_pCmd, i_cmdLen);
+}
+
+/* XCP init */
+void XCP_Init(void)
+{
+    fsl_memset(&gs_stXCPInfo, 0u, sizeof(gs_stXCPInfo));
+    XCP_ClearFifo();
+}
+
+/* XCP main function, do received commands. A command is not done until response of last command is ready. */
+void XCP_MainFun(void)
+{
+    uint8 aCmd[XCP_MAX_CTO] = {0u};
+    uint8 ucCmdLen = 0u;
+
+    while (TRUE != gs_stXCPInfo.isWaitFlashJob)
+    {
+        ucCmdLen = g_stXCPCfgInfo.pfNetRx(aCmd, sizeof(aCmd));
+
+        if (0u == ucCmdLen)
+        {
+            break;
+        }
+
+        XCP_DoCommand(aCmd, ucCmdLen);
+    }
+
+    if (TRUE == gs_stXCPInfo.isWaitFlashJob)
+    {
+        /* fls_app job is running, keep download info */
+        RestartS3Server();
+
+        /* fls_app job is stopped by others, e.g. UDS session changed */
+        if (FLASH_IDLE == Flash_GetOperateFlashActiveJob())
+        {
+            gs_stXCPInfo.isWaitFlashJob = FALSE;
+            XCP_TxErrResp(XCP_ERR_GENERIC);
+        }
+    }
+}
+#endif /* EN_XCP_ON_CAN */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,24 @@
+/*
+ * @ : xcp.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef XCP_H_
+#define XCP_H_
+
+#include "xcp_cfg.h"
+
+#ifdef EN_XCP_ON_CAN
+
+void XCP_Init(void);
+
+void XCP_MainFun(void);
+
+#endif /* EN_XCP_ON_CAN */
+
+#endif /* XCP_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
@@ -0,0 +1,214 @@
+/*
+ * @ : xcp_cfg.c
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#include "xcp_cfg.h"
+
+#ifdef EN_XCP_ON_CAN
+
+#include "multi_cyc_fifo.h"
+
+static tpfStartTxMsg gs_pfXCPStartTxMsg = NULL_PTR;
+static tpfUDSTxMsgCallBack gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+static uint8 XCP_TxFrame(const uint8 *i_pFrameBuf, const uint8 i_frameLen, const tpfUDSTxMsgCallBack i_pfCallBack);
+
+static uint8 XCP_RxFrame(uint8 *o_pFrameBuf, const uint8 i_bufLen);
+
+
+/* Define XCP FIFOs at compile time */
+FIFO_DEFINE(gs_stXCPRxFifo, XCP_RX_FIFO, XCP_RX_FIFO_LEN);
+FIFO_DEFINE(gs_stXCPTxFifo, XCP_TX_FIFO, XCP_TX_FIFO_LEN);
+
+static const tFifoHandle gs_xRxFifo = &gs_stXCPRxFifo;  /* RX FIFO, a message is frame len + frame */
+static const tFifoHandle gs_xTxFifo = &gs_stXCPTxFifo;  /* TX FIFO, a message is tTPTxMsgHeader + frame */
+
+/* XCP config info */
+const tXCPCfg g_stXCPCfgInfo =
+{
+    XCP_RX_ID,          /* XCP CMD ID */
+    XCP_TX_ID,          /* XCP RES/ERR/EV ID */
+    XCP_MAX_BS_PGM,     /* Max frames of a PROGRAM block */
+    XCP_MIN_ST_PGM,     /* Min separation time between block frames */
+    XCP_TxFrame,        /* XCP TX */
+    XCP_RxFrame,        /* XCP RX */
+};
+
+
+/* XCP TX a frame: write frame in TX FIFO and start CAN driver TX */
+static uint8 XCP_TxFrame(const uint8 *i_pFrameBuf, const uint8 i_frameLen, const tpfUDSTxMsgCallBack i_pfCallBack)
+{
+    tErroCode eStatus;
+    tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const tLen xMsgLen = (tLen)(sizeof(tTPTxMsgHeader) + i_frameLen);
+    ASSERT(NULL_PTR == i_pFrameBuf);
+
+    if ((0u == i_frameLen) || (i_frameLen > XCP_MAX_DTO))
+    {
+        return FALSE;
+    }
+
+    /* Build TX message in TX FIFO, if TX FIFO is full nothing is written */
+    pstTxMsgInfo = (tTPTxMsgHeader *)ReserveMsgInFifo(gs_xTxFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    pstTxMsgInfo->TxMsgID = XCP_GetConfigTxMsgID();
+    pstTxMsgInfo->TxMsgLength = i_frameLen;
+    pstTxMsgInfo->TxMsgCallBack = (uint32)i_pfCallBack;
+    fsl_memcpy((uint8 *)(pstTxMsgInfo + 1u), i_pFrameBuf, i_frameLen);
+    CommitMsgInFifo(gs_xTxFifo, xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    if (NULL_PTR != gs_pfXCPStartTxMsg)
+    {
+        (gs_pfXCPStartTxMsg)();
+    }
+
+    return TRUE;
+}
+
+/* XCP RX a frame: read a frame from RX FIFO, return frame len */
+static uint8 XCP_RxFrame(uint8 *o_pFrameBuf, const uint8 i_bufLen)
+{
+    tErroCode eStatus;
+    uint8 ucFrameLen = 0u;
+    tLen xReadLen = 0u;
+    ASSERT(NULL_PTR == o_pFrameBuf);
+
+    PopMsgFromFifo(gs_xRxFifo, &ucFrameLen, 1u, o_pFrameBuf, (tLen)i_bufLen, &xReadLen, &eStatus);
+
+    if ((ERRO_NONE != eStatus) || (xReadLen != ucFrameLen))
+    {
+        return 0u;
+    }
+
+    return ucFrameLen;
+}
+
+/* Clear XCP FIFOs */
+void XCP_ClearFifo(void)
+{
+    tErroCode eStatus;
+
+    DisableAllInterrupts();
+    ClearFIFO(gs_xRxFifo, &eStatus);
+    ClearFIFO(gs_xTxFifo, &eStatus);
+    gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+    EnableAllInterrupts();
+}
+
+/* Driver write a received frame in XCP. If RX FIFO is full the frame is lost, master will timeout and SYNCH. */
+boolean XCP_DriverWriteDataInXCP(const uint32 i_dataLen, const uint8 *i_pDataBuf)
+{
+    tErroCode eStatus;
+    const uint8 ucFrameLen = (uint8)i_dataLen;
+    ASSERT(NULL_PTR == i_pDataBuf);
+
+    if ((0u == i_dataLen) || (i_dataLen > XCP_MAX_CTO))
+    {
+        return FALSE;
+    }
+
+    PushMsgInFifo(gs_xRxFifo, &ucFrameLen, 1u, i_pDataBuf, (tLen)i_dataLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Driver peek a frame from XCP TX FIFO, it is kept in FIFO until driver release it after TX started */
+boolean XCP_DriverPeekDataFromXCP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
+{
+    tLen xMsgLen = 0u;
+    tErroCode eStatus;
+    uint32 index = 0u;
+    const tTPTxMsgHeader *pstTxMsgInfo = NULL_PTR;
+    const uint8 *pucData = NULL_PTR;
+    ASSERT(NULL_PTR == o_pReadDataBuf);
+    ASSERT(NULL_PTR == o_pstTxMsgHeader);
+    pstTxMsgInfo = (const tTPTxMsgHeader *)PeekMsgFromFifo(gs_xTxFifo, &xMsgLen, &eStatus);
+
+    if (ERRO_NONE != eStatus)
+    {
+        return FALSE;
+    }
+
+    /* Not a frame, drop it */
+    if ((xMsgLen < sizeof(tTPTxMsgHeader)) ||
+            ((xMsgLen - sizeof(tTPTxMsgHeader)) < pstTxMsgInfo->TxMsgLength) ||
+            (pstTxMsgInfo->TxMsgLength > i_readDataLen))
+    {
+        ReleaseMsgFromFifo(gs_xTxFifo, &eStatus);
+        return FALSE;
+    }
+
+    pucData = (const uint8 *)pstTxMsgInfo + sizeof(tTPTxMsgHeader);
+
+    for (index = 0u; index < pstTxMsgInfo->TxMsgLength; index++)
+    {
+        o_pReadDataBuf[index] = pucData[index];
+    }
+
+    *o_pstTxMsgHeader = *pstTxMsgInfo;
+
+    /* Storage callback, driver call XCP_DoTxMsgSuccessfulCallBack after the frame is transmitted */
+    gs_pfTxMsgSuccessfulCallBack = (tpfUDSTxMsgCallBack)pstTxMsgInfo->TxMsgCallBack;
+
+    return TRUE;
+}
+
+/* Driver release the peeked frame after TX started */
+void XCP_DriverReleaseDataFromXCP(void)
+{
+    tErroCode eStatus;
+    ReleaseMsgFromFifo(gs_xTxFifo, &eStatus);
+}
+
+/* Get config XCP RX ID */
+tUdsId XCP_GetConfigRxMsgID(void)
+{
+    return g_stXCPCfgInfo.xRxId;
+}
+
+/* Get config XCP TX ID */
+tUdsId XCP_GetConfigTxMsgID(void)
+{
+    return g_stXCPCfgInfo.xTxId;
+}
+
+/* Register start TX message, CAN driver starts TX if it is idle */
+void XCP_RegisterStartTxMsg(const tpfStartTxMsg i_pfStartTxMsg)
+{
+    gs_pfXCPStartTxMsg = i_pfStartTxMsg;
+}
+
+/* Do TX message successful callback */
+void XCP_DoTxMsgSuccessfulCallBack(void)
+{
+    tpfUDSTxMsgCallBack pfTxMsgCallBack = gs_pfTxMsgSuccessfulCallBack;
+
+    gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+    if (NULL_PTR != pfTxMsgCallBack)
+    {
+        (pfTxMsgCallBack)(TX_MSG_SUCCESSFUL);
+    }
+}
+#endif /* EN_XCP_ON_CAN */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */
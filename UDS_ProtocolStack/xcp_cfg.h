@@ -0,0 +1,90 @@
+/*
+ * @ : xcp_cfg.h
+ * @ :
+ * @ 汾: V1.0
+ *
+ * MIT License. Copyright (c) 2021 SummerFalls.
+ */
+
+#ifndef XCP_CFG_H_
+#define XCP_CFG_H_
+
+#include "includes.h"
+
+#ifdef EN_XCP_ON_CAN
+#include "TP_cfg.h"
+
+/*******************************************************
+**  Description : XCP on CAN slave configuration file
+**
+**  Only flash programming commands are supported:
+**  CONNECT, DISCONNECT, GET_STATUS, SYNCH, SET_MTA,
+**  PROGRAM_START, PROGRAM_CLEAR, PROGRAM, PROGRAM_NEXT,
+**  BUILD_CHECKSUM and PROGRAM_RESET.
+**  PROGRAM uses master block mode: a block is PROGRAM + PROGRAM_NEXT frames
+**  without response, slave responses once after the block is programmed.
+*******************************************************/
+
+#define XCP_MAX_CTO             (8u)        /* Max CTO len, a classic CAN frame */
+#define XCP_MAX_DTO             (8u)        /* Max DTO len */
+#define XCP_MAX_BS_PGM          (22u)       /* Max frames of a PROGRAM block */
+#define XCP_MIN_ST_PGM          (0u)        /* Min separation time between block frames, 100us */
+#define XCP_MAX_BLOCK_LEN       (128u)      /* Max data len of a PROGRAM block, not more than MAX_FLASH_DATA_LEN */
+#define XCP_CHECKSUM_TYPE       (0x07u)     /* XCP_CRC_16_CITT, same as CRC_HAL */
+#define XCP_PGM_ALIGN           (8u)        /* PROGRAM MTA align, flash phrase */
+
+#if (XCP_MAX_BLOCK_LEN > ((XCP_MAX_CTO - 2u) * XCP_MAX_BS_PGM))
+#error "XCP_MAX_BLOCK_LEN should be transferred in XCP_MAX_BS_PGM frames"
+#endif
+
+/* A RX frame slot is FIFO message head + frame len + frame, one slot may be skipped at FIFO end */
+#if (!IsFifoLenValid(XCP_RX_FIFO_LEN)) || \
+    (XCP_RX_FIFO_LEN < ((XCP_MAX_BS_PGM + 1u) * (4u + 4u + XCP_MAX_CTO)))
+#error "XCP RX FIFO len should be power of 2 and hold a whole PROGRAM block"
+#endif
+
+#if (!IsFifoLenValid(XCP_TX_FIFO_LEN)) || (FifoMaxMsgLen(XCP_TX_FIFO_LEN) < (12u + XCP_MAX_DTO))
+#error "XCP TX FIFO len should be power of 2 and not too small for a frame (tTPTxMsgHeader + frame)"
+#endif
+
+/* TX a frame, callback is called after the frame is transmitted */
+typedef uint8 (*tXCPNetTx)(const uint8 *, const uint8, const tpfUDSTxMsgCallBack);
+
+/* RX a frame, return frame len, 0 is no frame */
+typedef uint8 (*tXCPNetRx)(uint8 *, const uint8);
+
+typedef struct
+{
+    tUdsId xRxId;                   /* XCP CMD ID */
+    tUdsId xTxId;                   /* XCP RES/ERR/EV ID */
+    uint8 ucMaxBsPgm;               /* Max frames of a PROGRAM block */
+    uint8 ucMinStPgm;               /* Min separation time between block frames */
+    tXCPNetTx pfNetTx;              /* Net TX a frame with non blocking */
+    tXCPNetRx pfNetRx;              /* Net RX a frame */
+} tXCPCfg;
+
+/* XCP config info */
+extern const tXCPCfg g_stXCPCfgInfo;
+
+
+tUdsId XCP_GetConfigRxMsgID(void);
+
+tUdsId XCP_GetConfigTxMsgID(void);
+
+void XCP_ClearFifo(void);
+
+boolean XCP_DriverWriteDataInXCP(const uint32 i_dataLen, const uint8 *i_pDataBuf);
+
+boolean XCP_DriverPeekDataFromXCP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader);
+
+void XCP_DriverReleaseDataFromXCP(void);
+
+void XCP_RegisterStartTxMsg(const tpfStartTxMsg i_pfStartTxMsg);
+
+void XCP_DoTxMsgSuccessfulCallBack(void);
+
+#endif /* EN_XCP_ON_CAN */
+
+#endif /* XCP_CFG_H_ */
+
+/* -------------------------------------------- END OF FILE -------------------------------------------- */